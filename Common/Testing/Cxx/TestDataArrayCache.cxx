@@ -0,0 +1,144 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataArrayCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the LRU eviction, the memory budget and owner invalidation of
+// vtkDataArrayCache.
+
+#include "vtkDataArrayCache.h"
+#include "vtkFloatArray.h"
+
+static vtkDataArrayCacheKey MakeKey(const void *owner, int step)
+{
+  vtkDataArrayCacheKey key(owner);
+  key.Append("pressure").Append(step);
+  return key;
+}
+
+static int IsCached(vtkDataArrayCache *cache, const vtkDataArrayCacheKey &key)
+{
+  vtkDataArray *array = cache->Find(key);
+  if (!array)
+    {
+    return 0;
+    }
+  array->Delete();
+  return 1;
+}
+
+int TestDataArrayCache(int, char *[])
+{
+  int owner1 = 0;
+  int owner2 = 0;
+  int i;
+
+  vtkDataArrayCache *cache = vtkDataArrayCache::New();
+  // Caching is off until a capacity is set.
+  vtkFloatArray *unused = vtkFloatArray::New();
+  unused->SetNumberOfTuples(16);
+  cache->Insert(MakeKey(&owner1, 0), unused);
+  unused->Delete();
+  if (cache->GetCapacity() != 0.0 || cache->GetNumberOfEntries() != 0)
+    {
+    cerr << "The default cache keeps arrays" << endl;
+    cache->Delete();
+    return 1;
+    }
+
+  // Each array takes 256 KiB, so four of them fit.
+  cache->SetCapacity(1.0);
+  for (i = 0; i < 4; i++)
+    {
+    vtkFloatArray *array = vtkFloatArray::New();
+    array->SetNumberOfTuples(65536);
+    array->FillComponent(0, i);
+    cache->Insert(MakeKey(&owner1, i), array);
+    array->Delete();
+    }
+  if (cache->GetNumberOfEntries() != 4 || cache->GetSize() != 1.0)
+    {
+    cerr << "Expected 4 entries and 1 MiB, got "
+         << cache->GetNumberOfEntries() << " entries and "
+         << cache->GetSize() << " MiB" << endl;
+    cache->Delete();
+    return 1;
+    }
+
+  // Touch step 0 so that step 1 becomes the least recently used.
+  vtkDataArray *found = cache->Find(MakeKey(&owner1, 0));
+  if (!found || found->GetTuple1(0) != 0.0)
+    {
+    cerr << "Step 0 not found" << endl;
+    cache->Delete();
+    return 1;
+    }
+  found->Delete();
+
+  vtkFloatArray *array = vtkFloatArray::New();
+  array->SetNumberOfTuples(65536);
+  cache->Insert(MakeKey(&owner2, 0), array);
+  array->Delete();
+  if (IsCached(cache, MakeKey(&owner1, 1)) ||
+      !IsCached(cache, MakeKey(&owner1, 0)) ||
+      !IsCached(cache, MakeKey(&owner2, 0)))
+    {
+    cerr << "Wrong entry evicted" << endl;
+    cache->Delete();
+    return 1;
+    }
+
+  // Keys built from different fields must not collide.
+  vtkDataArrayCacheKey key1(&owner1);
+  vtkDataArrayCacheKey key2(&owner1);
+  key1.Append("ab").Append("c");
+  key2.Append("a").Append("bc");
+  if (!(key1 < key2) && !(key2 < key1))
+    {
+    cerr << "Keys with different fields compare equal" << endl;
+    cache->Delete();
+    return 1;
+    }
+
+  if (cache->InvalidateOwner(&owner1) != 3 ||
+      cache->GetNumberOfEntries() != 1 ||
+      !IsCached(cache, MakeKey(&owner2, 0)))
+    {
+    cerr << "InvalidateOwner failed" << endl;
+    cache->Delete();
+    return 1;
+    }
+
+  // Arrays larger than the capacity are not kept.
+  cache->SetCapacity(0.1);
+  array = vtkFloatArray::New();
+  array->SetNumberOfTuples(65536);
+  cache->Insert(MakeKey(&owner1, 0), array);
+  array->Delete();
+  if (cache->GetNumberOfEntries() != 0 || cache->GetSize() != 0.0)
+    {
+    cerr << "Cache exceeds its capacity" << endl;
+    cache->Delete();
+    return 1;
+    }
+
+  cache->Delete();
+
+  // The process-wide cache is created on demand.
+  if (!vtkDataArrayCache::GetGlobalCache() ||
+      vtkDataArrayCache::GetGlobalCache() != vtkDataArrayCache::GetGlobalCache())
+    {
+    cerr << "No global cache" << endl;
+    return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,113 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPriorityQueue.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Inserts, deletes and pops entries with dense and sparse ids and several
+// branching factors, and checks the order and the id lookups against a
+// plain array.
+
+#include "vtkMath.h"
+#include "vtkPriorityQueue.h"
+
+#include <vtkstd/map>
+
+static int TestQueue(int factor, vtkIdType stride)
+{
+  vtkPriorityQueue *queue = vtkPriorityQueue::New();
+  queue->SetBranchingFactor(factor);
+  vtkstd::map<vtkIdType, double> expected;
+  int status = 0;
+  int i;
+
+  vtkMath::RandomSeed(factor);
+  for (i = 0; i < 20000; i++)
+    {
+    vtkIdType id = static_cast<vtkIdType>(vtkMath::Random(0.0, 5000.0)) *
+      stride;
+    double priority = vtkMath::Random();
+    if (expected.find(id) == expected.end())
+      {
+      queue->Insert(priority, id);
+      expected[id] = priority;
+      }
+    else if (i % 3 == 0)
+      {
+      if (queue->DeleteId(id) != expected[id])
+        {
+        status = 1;
+        }
+      expected.erase(id);
+      }
+    else if (queue->GetPriority(id) != expected[id])
+      {
+      status = 1;
+      }
+    }
+  if (status)
+    {
+    cerr << "Wrong priorities with branching factor " << factor
+         << " and stride " << stride << endl;
+    }
+  if (queue->GetUseHashedLocations() != (stride > 1))
+    {
+    cerr << "Wrong location map for stride " << stride << endl;
+    status = 1;
+    }
+
+  double priority, previous = -1.0;
+  while (queue->GetNumberOfItems() > 0)
+    {
+    vtkIdType id = queue->Pop(0, priority);
+    if (priority < previous || expected.find(id) == expected.end() ||
+        expected[id] != priority)
+      {
+      cerr << "Wrong pop order with branching factor " << factor
+           << " and stride " << stride << endl;
+      status = 1;
+      break;
+      }
+    expected.erase(id);
+    previous = priority;
+    }
+  if (!expected.empty() || queue->Pop(0) != -1)
+    {
+    cerr << "Entries lost with branching factor " << factor
+         << " and stride " << stride << endl;
+    status = 1;
+    }
+
+  // Dense ids after a reset go back to an array.
+  queue->Reset();
+  for (i = 0; i < 100000; i++)
+    {
+    queue->Insert(-i, i);
+    }
+  if (queue->GetUseHashedLocations() || queue->Pop(0) != 99999 ||
+      queue->GetPriority(500) != -500)
+    {
+    cerr << "Dense ids not handled after reset" << endl;
+    status = 1;
+    }
+  queue->Delete();
+  return status;
+}
+
+int TestPriorityQueue(int, char *[])
+{
+  int status = 0;
+  status |= TestQueue(2, 1);
+  status |= TestQueue(2, 100003);
+  status |= TestQueue(4, 1);
+  status |= TestQueue(4, 100003);
+  return status;
+}
@@ -24,6 +24,8 @@
 // -*- c++ -*- *******************************************************
 
 #include "vtkSortDataArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
 #include "vtkIntArray.h"
 #include "vtkMath.h"
 #include "vtkTimerLog.h"
@@ -151,11 +153,62 @@ int TestSortDataArray(int, char *[])
     }
   cout << "Array consistency check finished\n" << endl;
 
+  // Floating point keys of both signs, sorted along with their ids.
+  cout << "Building float key/id arrays\n" << endl;
+  int errors = 0;
+  vtkFloatArray *floatKeys = vtkFloatArray::New();
+  floatKeys->SetNumberOfTuples(ARRAY_SIZE);
+  vtkIdList *ids = vtkIdList::New();
+  ids->SetNumberOfIds(ARRAY_SIZE);
+  for (i = 0; i < ARRAY_SIZE; i++)
+    {
+    floatKeys->SetValue(i, static_cast<float>(vtkMath::Random(-1.0e6, 1.0e6)));
+    ids->SetId(i, i);
+    }
+  floatKeys->SetValue(0, VTK_FLOAT_MAX);
+  floatKeys->SetValue(1, -VTK_FLOAT_MAX);
+  floatKeys->SetValue(2, 0.0f);
+  vtkFloatArray *saveFloatKeys = vtkFloatArray::New();
+  saveFloatKeys->DeepCopy(floatKeys);
+
+  cout << "Sorting arrays" << endl;
+  timer->StartTimer();
+  vtkSortDataArray::Sort(floatKeys, ids);
+  timer->StopTimer();
+
+  cout << "Time to sort array: " << timer->GetElapsedTime() << " sec" << endl;
+
+  for (i = 0; i < ARRAY_SIZE-1; i++)
+    {
+    if (floatKeys->GetValue(i) > floatKeys->GetValue(i+1))
+      {
+      cout << "Array not properly sorted!" << endl;
+      errors++;
+      break;
+      }
+    if (floatKeys->GetValue(i) != saveFloatKeys->GetValue(ids->GetId(i)))
+      {
+      cout << "Values array not consistent with keys array!" << endl;
+      errors++;
+      break;
+      }
+    }
+  if (floatKeys->GetValue(0) != -VTK_FLOAT_MAX ||
+      floatKeys->GetValue(ARRAY_SIZE-1) != VTK_FLOAT_MAX)
+    {
+    cout << "Extreme keys not at the ends of the array!" << endl;
+    errors++;
+    }
+  cout << "Array consistency check finished\n" << endl;
+
   timer->Delete();
   keys->Delete();
   values->Delete();
   saveKeys->Delete();
   saveValues->Delete();
+  floatKeys->Delete();
+  saveFloatKeys->Delete();
+  ids->Delete();
 
-  return 0;
+  return errors;
 }
@@ -0,0 +1,375 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArrayCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDataArrayCache.h"
+
+#include "vtkCriticalSection.h"
+#include "vtkDataArray.h"
+#include "vtkObjectFactory.h"
+
+#include <vtkstd/list>
+#include <vtkstd/map>
+
+#include <stdio.h>
+
+vtkCxxRevisionMacro(vtkDataArrayCache, "$Revision: 1.1 $");
+vtkStandardNewMacro(vtkDataArrayCache);
+
+//----------------------------------------------------------------------------
+// The entries are kept in a map for lookup and their map iterators in a
+// list ordered from least to most recently used, as in vtkExodusIICache.
+struct vtkDataArrayCacheEntry;
+typedef vtkstd::map<vtkDataArrayCacheKey, vtkDataArrayCacheEntry>
+  vtkDataArrayCacheMap;
+typedef vtkstd::list<vtkDataArrayCacheMap::iterator> vtkDataArrayCacheLRU;
+
+struct vtkDataArrayCacheEntry
+{
+  vtkDataArray *Array;
+  double Size;
+  vtkDataArrayCacheLRU::iterator LRURef;
+};
+
+class vtkDataArrayCacheInternals
+{
+public:
+  vtkDataArrayCacheMap Map;
+  vtkDataArrayCacheLRU LRU;
+};
+
+//----------------------------------------------------------------------------
+vtkDataArrayCacheKey &vtkDataArrayCacheKey::Append(const char *field)
+{
+  if (field)
+    {
+    this->Fields += field;
+    }
+  this->Fields += '\0';
+  return *this;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCacheKey &vtkDataArrayCacheKey::Append(int field)
+{
+  char buf[32];
+  sprintf(buf, "%d", field);
+  return this->Append(buf);
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCacheKey &vtkDataArrayCacheKey::Append(double field)
+{
+  char buf[64];
+  sprintf(buf, "%.17g", field);
+  return this->Append(buf);
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCacheKey &vtkDataArrayCacheKey::AppendId(vtkIdType field)
+{
+  char buf[64];
+#if defined(VTK_USE_64BIT_IDS)
+  sprintf(buf, "%lld", static_cast<long long>(field));
+#else
+  sprintf(buf, "%d", static_cast<int>(field));
+#endif
+  return this->Append(buf);
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCache::vtkDataArrayCache()
+{
+  this->Capacity = 0.0;
+  this->Size = 0.0;
+  this->Internals = new vtkDataArrayCacheInternals;
+  this->Lock = new vtkSimpleCriticalSection;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCache::~vtkDataArrayCache()
+{
+  this->ReduceToSizeInternal(-1.0);
+  delete this->Internals;
+  delete this->Lock;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCache *vtkDataArrayCache::GetGlobalCache()
+{
+  vtkDataArrayCache::GlobalLock->Lock();
+  if (!vtkDataArrayCache::GlobalInstance)
+    {
+    vtkDataArrayCache::GlobalInstance = vtkDataArrayCache::New();
+    }
+  vtkDataArrayCache *cache = vtkDataArrayCache::GlobalInstance;
+  vtkDataArrayCache::GlobalLock->Unlock();
+  return cache;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::SetGlobalCache(vtkDataArrayCache *cache)
+{
+  vtkDataArrayCache::GlobalLock->Lock();
+  if (vtkDataArrayCache::GlobalInstance != cache)
+    {
+    if (vtkDataArrayCache::GlobalInstance)
+      {
+      vtkDataArrayCache::GlobalInstance->Delete();
+      }
+    vtkDataArrayCache::GlobalInstance = cache;
+    if (cache)
+      {
+      cache->Register(NULL);
+      }
+    }
+  vtkDataArrayCache::GlobalLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::SetCapacity(double sizeInMiB)
+{
+  if (sizeInMiB < 0.0)
+    {
+    sizeInMiB = 0.0;
+    }
+  this->Lock->Lock();
+  if (this->Capacity == sizeInMiB)
+    {
+    this->Lock->Unlock();
+    return;
+    }
+  this->Capacity = sizeInMiB;
+  this->ReduceToSizeInternal(sizeInMiB);
+  this->Lock->Unlock();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+double vtkDataArrayCache::GetCapacity()
+{
+  this->Lock->Lock();
+  double capacity = this->Capacity;
+  this->Lock->Unlock();
+  return capacity;
+}
+
+//----------------------------------------------------------------------------
+double vtkDataArrayCache::GetSize()
+{
+  this->Lock->Lock();
+  double size = this->Size;
+  this->Lock->Unlock();
+  return size;
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArrayCache::GetNumberOfEntries()
+{
+  this->Lock->Lock();
+  int n = static_cast<int>(this->Internals->Map.size());
+  this->Lock->Unlock();
+  return n;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::Clear()
+{
+  this->Lock->Lock();
+  this->ReduceToSizeInternal(-1.0);
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArrayCache::ReduceToSize(double sizeInMiB)
+{
+  this->Lock->Lock();
+  int reduced = this->ReduceToSizeInternal(sizeInMiB);
+  this->Lock->Unlock();
+  return reduced;
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArrayCache::ReduceToSizeInternal(double sizeInMiB)
+{
+  int reduced = 0;
+  vtkDataArrayCacheInternals *internals = this->Internals;
+  while (!internals->LRU.empty() && this->Size > sizeInMiB)
+    {
+    vtkDataArrayCacheMap::iterator it = internals->LRU.front();
+    internals->LRU.pop_front();
+    this->Size -= it->second.Size;
+    it->second.Array->UnRegister(this);
+    internals->Map.erase(it);
+    reduced = 1;
+    }
+  if (internals->Map.empty())
+    {
+    // Avoid drift from accumulated rounding.
+    this->Size = 0.0;
+    }
+  return reduced;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::Insert(const vtkDataArrayCacheKey &key,
+                               vtkDataArray *array)
+{
+  if (!array)
+    {
+    return;
+    }
+  double size = array->GetActualMemorySize() / 1024.0;
+
+  this->Lock->Lock();
+  vtkDataArrayCacheInternals *internals = this->Internals;
+  vtkDataArrayCacheMap::iterator it = internals->Map.find(key);
+  if (it != internals->Map.end())
+    {
+    internals->LRU.erase(it->second.LRURef);
+    this->Size -= it->second.Size;
+    it->second.Array->UnRegister(this);
+    internals->Map.erase(it);
+    }
+  if (size > this->Capacity)
+    {
+    this->Lock->Unlock();
+    return;
+    }
+  this->ReduceToSizeInternal(this->Capacity - size);
+
+  vtkDataArrayCacheEntry entry;
+  entry.Array = array;
+  entry.Size = size;
+  array->Register(this);
+  it = internals->Map.insert(vtkDataArrayCacheMap::value_type(key, entry)).first;
+  it->second.LRURef = internals->LRU.insert(internals->LRU.end(), it);
+  this->Size += size;
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray *vtkDataArrayCache::Find(const vtkDataArrayCacheKey &key)
+{
+  this->Lock->Lock();
+  vtkDataArrayCacheInternals *internals = this->Internals;
+  vtkDataArrayCacheMap::iterator it = internals->Map.find(key);
+  if (it == internals->Map.end())
+    {
+    this->Lock->Unlock();
+    return 0;
+    }
+  internals->LRU.splice(internals->LRU.end(), internals->LRU,
+    it->second.LRURef);
+  vtkDataArray *array = it->second.Array;
+  array->Register(NULL);
+  this->Lock->Unlock();
+  return array;
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArrayCache::Invalidate(const vtkDataArrayCacheKey &key)
+{
+  this->Lock->Lock();
+  vtkDataArrayCacheInternals *internals = this->Internals;
+  vtkDataArrayCacheMap::iterator it = internals->Map.find(key);
+  if (it == internals->Map.end())
+    {
+    this->Lock->Unlock();
+    return 0;
+    }
+  internals->LRU.erase(it->second.LRURef);
+  this->Size -= it->second.Size;
+  it->second.Array->UnRegister(this);
+  internals->Map.erase(it);
+  if (internals->Map.empty())
+    {
+    this->Size = 0.0;
+    }
+  this->Lock->Unlock();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArrayCache::InvalidateOwner(const void *owner)
+{
+  this->Lock->Lock();
+  vtkDataArrayCacheInternals *internals = this->Internals;
+  // Keys sort by owner first, and the empty field string sorts before
+  // any other, so the owner's entries form one contiguous range.
+  vtkDataArrayCacheMap::iterator it =
+    internals->Map.lower_bound(vtkDataArrayCacheKey(owner));
+  int count = 0;
+  while (it != internals->Map.end() && it->first.Owner == owner)
+    {
+    internals->LRU.erase(it->second.LRURef);
+    this->Size -= it->second.Size;
+    it->second.Array->UnRegister(this);
+    internals->Map.erase(it++);
+    ++count;
+    }
+  if (internals->Map.empty())
+    {
+    this->Size = 0.0;
+    }
+  this->Lock->Unlock();
+  return count;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Capacity: " << this->Capacity << " MiB\n";
+  os << indent << "Size: " << this->Size << " MiB\n";
+  os << indent << "NumberOfEntries: " << this->Internals->Map.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::ClassInitialize()
+{
+  vtkDataArrayCache::GlobalInstance = 0;
+  vtkDataArrayCache::GlobalLock = new vtkSimpleCriticalSection;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayCache::ClassFinalize()
+{
+  if (vtkDataArrayCache::GlobalInstance)
+    {
+    vtkDataArrayCache::GlobalInstance->Delete();
+    vtkDataArrayCache::GlobalInstance = 0;
+    }
+  delete vtkDataArrayCache::GlobalLock;
+  vtkDataArrayCache::GlobalLock = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCacheInitialize::vtkDataArrayCacheInitialize()
+{
+  if(++vtkDataArrayCacheInitialize::Count == 1)
+    { vtkDataArrayCache::ClassInitialize(); }
+}
+
+//----------------------------------------------------------------------------
+vtkDataArrayCacheInitialize::~vtkDataArrayCacheInitialize()
+{
+  if(--vtkDataArrayCacheInitialize::Count == 0)
+    { vtkDataArrayCache::ClassFinalize(); }
+}
+
+//----------------------------------------------------------------------------
+// Purposely not initialized.  ClassInitialize will handle them.
+unsigned int vtkDataArrayCacheInitialize::Count;
+vtkDataArrayCache *vtkDataArrayCache::GlobalInstance;
+vtkSimpleCriticalSection *vtkDataArrayCache::GlobalLock;
@@ -0,0 +1,201 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArrayCache.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkDataArrayCache - size-bounded LRU cache of data arrays
+// .SECTION Description
+// vtkDataArrayCache keeps data arrays that a reader has already loaded so
+// that revisiting a time step (or any other request that maps onto the same
+// bytes on disk) does not touch the file again. Entries are looked up with a
+// vtkDataArrayCacheKey, which pairs the object that owns the entry with a
+// string the owner builds from whatever identifies the array (file name,
+// variable, time step, extent, ...). The total size of the cached arrays is
+// bounded by Capacity (in MiB); the least recently used entries are dropped
+// when a new array does not fit.
+//
+// A single process-wide instance, returned by GetGlobalCache(), is shared by
+// the readers so that they draw from one memory budget. The cache may be
+// accessed from several threads at once.
+//
+// Arrays handed to Insert() are referenced, not copied, so the caller must
+// not modify them afterwards. Likewise, arrays returned by Find() are shared
+// with the cache and must be treated as read-only.
+// .SECTION See Also
+// vtkExodusIICache
+
+#ifndef __vtkDataArrayCache_h
+#define __vtkDataArrayCache_h
+
+#include "vtkObject.h"
+#include "vtkStdString.h" // for vtkDataArrayCacheKey
+
+// The vtkDebugLeaks singleton must be initialized before and
+// destroyed after the global vtkDataArrayCache.
+#include "vtkDebugLeaksManager.h" // Needed for proper singleton initialization
+
+class vtkDataArray;
+class vtkDataArrayCacheInitialize;
+class vtkDataArrayCacheInternals;
+class vtkSimpleCriticalSection;
+
+//BTX
+class VTK_COMMON_EXPORT vtkDataArrayCacheKey
+{
+public:
+  vtkDataArrayCacheKey() : Owner(0) {}
+  vtkDataArrayCacheKey(const void *owner) : Owner(owner) {}
+
+  // Description:
+  // Append a field to the key. Fields are separated so that
+  // ("ab", "c") and ("a", "bc") give different keys.
+  vtkDataArrayCacheKey &Append(const char *field);
+  vtkDataArrayCacheKey &Append(int field);
+  vtkDataArrayCacheKey &Append(double field);
+  vtkDataArrayCacheKey &AppendId(vtkIdType field);
+
+  bool operator<(const vtkDataArrayCacheKey &other) const
+    {
+    if (this->Owner != other.Owner)
+      {
+      return this->Owner < other.Owner;
+      }
+    return this->Fields < other.Fields;
+    }
+
+  // Description:
+  // The object the entry belongs to. Usually the reader that loaded the
+  // array, so that it can drop its entries with
+  // vtkDataArrayCache::InvalidateOwner().
+  const void *Owner;
+
+  // Description:
+  // The fields appended to the key.
+  vtkStdString Fields;
+};
+//ETX
+
+class VTK_COMMON_EXPORT vtkDataArrayCache : public vtkObject
+{
+public:
+  static vtkDataArrayCache *New();
+  vtkTypeRevisionMacro(vtkDataArrayCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Return the cache shared by all readers of the process, creating it on
+  // first use. The instance is not reference counted for the caller.
+  static vtkDataArrayCache *GetGlobalCache();
+
+  // Description:
+  // Replace the process-wide cache. Passing NULL releases the current one;
+  // a new default cache is created on the next GetGlobalCache().
+  static void SetGlobalCache(vtkDataArrayCache *cache);
+
+  // Description:
+  // The maximum total size of the cached arrays in MiB. Reducing the
+  // capacity drops entries until the cache fits. A capacity of 0 disables
+  // caching. The default is 0, so nothing is cached until an application
+  // sets a budget, e.g. on GetGlobalCache().
+  void SetCapacity(double sizeInMiB);
+  double GetCapacity();
+
+  // Description:
+  // The total size of the cached arrays in MiB.
+  double GetSize();
+
+  // Description:
+  // The number of cached arrays.
+  int GetNumberOfEntries();
+
+  // Description:
+  // Drop all entries.
+  void Clear();
+
+  // Description:
+  // Drop least recently used entries until the size is at or below
+  // sizeInMiB. Returns 1 if entries were dropped.
+  int ReduceToSize(double sizeInMiB);
+
+  //BTX
+  // Description:
+  // Add an array, replacing any entry with the same key and dropping least
+  // recently used entries to make room. Arrays larger than the capacity are
+  // not cached.
+  void Insert(const vtkDataArrayCacheKey &key, vtkDataArray *array);
+
+  // Description:
+  // Return the array cached for key, or NULL. The entry becomes the most
+  // recently used one. The returned array has been registered for the
+  // caller, who must call Delete() on it when done; this keeps it alive even
+  // if another thread evicts the entry meanwhile.
+  vtkDataArray *Find(const vtkDataArrayCacheKey &key);
+
+  // Description:
+  // Drop the entry for key. Returns 1 if it existed.
+  int Invalidate(const vtkDataArrayCacheKey &key);
+
+  // Description:
+  // Drop every entry belonging to owner. Returns the number of entries
+  // dropped. Readers call this when their file changes and on destruction.
+  int InvalidateOwner(const void *owner);
+  //ETX
+
+protected:
+  vtkDataArrayCache();
+  ~vtkDataArrayCache();
+
+  // Description:
+  // Drop LRU entries down to sizeInMiB. The lock must be held.
+  int ReduceToSizeInternal(double sizeInMiB);
+
+  double Capacity;
+  double Size;
+
+  vtkDataArrayCacheInternals *Internals;
+  vtkSimpleCriticalSection *Lock;
+
+  // The process-wide cache and the lock guarding it.
+  static vtkDataArrayCache *GlobalInstance;
+  static vtkSimpleCriticalSection *GlobalLock;
+
+  static void ClassInitialize();
+  static void ClassFinalize();
+
+  //BTX
+  friend class vtkDataArrayCacheInitialize;
+  //ETX
+
+private:
+  vtkDataArrayCache(const vtkDataArrayCache&);  // Not implemented.
+  void operator=(const vtkDataArrayCache&);  // Not implemented.
+};
+
+//BTX
+// Utility class to make sure the global vtkDataArrayCache is set up
+// before it is used and released before vtkDebugLeaks goes away.
+class VTK_COMMON_EXPORT vtkDataArrayCacheInitialize
+{
+public:
+  vtkDataArrayCacheInitialize();
+  ~vtkDataArrayCacheInitialize();
+private:
+  static unsigned int Count;
+};
+
+// This instance will show up in any translation unit that uses
+// vtkDataArrayCache.  It will make sure the global cache is released
+// after its last user is destroyed.
+static vtkDataArrayCacheInitialize vtkDataArrayCacheInitializer;
+//ETX
+
+#endif
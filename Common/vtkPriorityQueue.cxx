@@ -17,6 +17,27 @@
 
 vtkStandardNewMacro(vtkPriorityQueue);
 
+// The locations are kept in an array indexed by id unless that array would
+// get more than VTK_PRIORITY_QUEUE_SPARSITY times larger than the number
+// of entries (and larger than VTK_PRIORITY_QUEUE_MIN_DENSE_SIZE).
+#define VTK_PRIORITY_QUEUE_SPARSITY 8
+#define VTK_PRIORITY_QUEUE_MIN_DENSE_SIZE 1024
+#define VTK_PRIORITY_QUEUE_MIN_HASH_SIZE 64
+
+// Scatter the ids over the hash table; consecutive and strided ids both
+// spread evenly.
+static inline vtkIdType vtkPriorityQueueHash(vtkIdType id)
+{
+#if defined(VTK_USE_64BIT_IDS)
+  unsigned long long h =
+    static_cast<unsigned long long>(id) * 0x9E3779B97F4A7C15ULL;
+  return static_cast<vtkIdType>(h >> 33);
+#else
+  unsigned int h = static_cast<unsigned int>(id) * 2654435761U;
+  return static_cast<vtkIdType>((h ^ (h >> 16)) & 0x7fffffff);
+#endif
+}
+
 // Instantiate priority queue with default size and extension size of 1000.
 vtkPriorityQueue::vtkPriorityQueue()
 {
@@ -25,12 +46,27 @@ vtkPriorityQueue::vtkPriorityQueue()
   this->Array = NULL;
   this->MaxId = -1;
   this->ItemLocation = vtkIdTypeArray::New();
+  this->BranchingFactor = 2;
+  this->HashedLocations = 0;
+  this->Hash = NULL;
+  this->HashSize = 0;
+  this->HashCount = 0;
+  this->HashMaxId = -1;
 }
 
 // Allocate priority queue with specified size and amount to extend
 // queue (if reallocation required).
 void vtkPriorityQueue::Allocate(const vtkIdType sz, const vtkIdType ext)
 {
+  // an explicit size asks for an array of locations
+  if ( this->HashedLocations )
+    {
+    delete [] this->Hash;
+    this->Hash = NULL;
+    this->HashSize = this->HashCount = 0;
+    this->HashMaxId = -1;
+    this->HashedLocations = 0;
+    }
   this->ItemLocation->Allocate(sz,ext);
   for (vtkIdType i=0; i < sz; i++)
     {
@@ -55,54 +91,43 @@ vtkPriorityQueue::~vtkPriorityQueue()
     {
     delete [] this->Array;
     }
+  if ( this->Hash )
+    {
+    delete [] this->Hash;
+    }
 }
 
 // Insert id with priority specified.
 void vtkPriorityQueue::Insert(double priority, vtkIdType id)
 {
   vtkIdType i, idx;
-  vtkPriorityQueue::Item temp;
+  int d = this->BranchingFactor;
 
   // check and make sure item hasn't been inserted before
-  if ( id <= this->ItemLocation->GetMaxId() && 
-       this->ItemLocation->GetValue(id) != -1 )
+  if ( this->GetLocation(id) != -1 )
     {
     return;
     }
+  this->ReserveLocation(id);
 
   // start by placing new entry at bottom of tree
   if ( ++this->MaxId >= this->Size )
     {
     this->Resize(this->MaxId + 1);
     }
-  this->Array[this->MaxId].priority = priority;
-  this->Array[this->MaxId].id = id;
-  if ( id >= this->ItemLocation->GetSize() ) //might have to resize and initialize
-    {
-    vtkIdType oldSize = this->ItemLocation->GetSize();
-    this->ItemLocation->InsertValue(id,this->MaxId); 
-    for (i=oldSize; i < this->ItemLocation->GetSize(); i++) 
-      {
-      this->ItemLocation->SetValue(i, -1);
-      }
-    this->ItemLocation->SetValue(id,this->MaxId);
-    }
-
-  this->ItemLocation->InsertValue(id,this->MaxId);
 
-  // now begin percolating towards top of tree
+  // now begin percolating towards top of tree, moving the parents down
+  // until the place of the new entry is found
   for ( i=this->MaxId; 
-  i > 0 && this->Array[i].priority < this->Array[(idx=(i-1)/2)].priority; 
+  i > 0 && priority < this->Array[(idx=(i-1)/d)].priority; 
   i=idx)
     {
-    temp = this->Array[i];
-
-    this->ItemLocation->SetValue(temp.id,idx);
     this->Array[i] = this->Array[idx];
-
-    this->ItemLocation->SetValue(this->Array[idx].id,i);
-    this->Array[idx] = temp;
+    this->SetLocation(this->Array[i].id,i);
     }
+  this->Array[i].priority = priority;
+  this->Array[i].id = id;
+  this->InsertLocation(id,i);
 }
 
 // Simplified call for easier wrapping for Tcl.
@@ -116,7 +141,8 @@ vtkIdType vtkPriorityQueue::Pop(vtkIdType location)
 // balances tree. The location == 0 is the root of the tree.
 vtkIdType vtkPriorityQueue::Pop(vtkIdType location, double &priority)
 {
-  vtkIdType id, i, j, idx;
+  vtkIdType id, i, j, idx, last;
+  int d = this->BranchingFactor;
   vtkPriorityQueue::Item temp;
 
   if ( this->MaxId < 0 )
@@ -126,44 +152,36 @@ vtkIdType vtkPriorityQueue::Pop(vtkIdType location, double &priority)
  
   id = this->Array[location].id;
   priority = this->Array[location].priority;
+  this->RemoveLocation(id);
 
   // move the last item to the location specified and push into the tree
-  this->Array[location].id = this->Array[this->MaxId].id;
-  this->Array[location].priority = this->Array[this->MaxId].priority;
-
-  this->ItemLocation->SetValue(this->Array[location].id,location);
-  this->ItemLocation->SetValue(id,-1);
-
-  if ( --this->MaxId <= 0 )
+  temp = this->Array[this->MaxId];
+  if ( location == this->MaxId-- )
     {
     return id;
     }
 
-  // percolate down the tree from the specified location
-  int lastNodeToCheck = (this->MaxId-1)/2;
-  for ( j=0, i=location; i <= lastNodeToCheck; i=j )
+  // percolate down the tree from the specified location; of equal
+  // children the last one is taken
+  for ( i=location; (idx=d*i+1) <= this->MaxId; i=j )
     {
-    idx = 2*i + 1;
-
-    if ( this->Array[idx].priority < this->Array[idx+1].priority || 
-         idx == this->MaxId )
+    last = idx + d - 1;
+    if ( last > this->MaxId )
       {
-      j = idx;
+      last = this->MaxId;
       }
-    else
+    for ( j=idx++; idx <= last; idx++ )
       {
-      j = idx + 1;
+      if ( !(this->Array[j].priority < this->Array[idx].priority) )
+        {
+        j = idx;
+        }
       }
 
-    if ( this->Array[i].priority > this->Array[j].priority )
+    if ( temp.priority > this->Array[j].priority )
       {
-      temp = this->Array[i];
-
-      this->ItemLocation->SetValue(temp.id,j);
       this->Array[i] = this->Array[j];
-
-      this->ItemLocation->SetValue(this->Array[j].id,i);
-      this->Array[j] = temp;
+      this->SetLocation(this->Array[i].id,i);
       }
     else
       {
@@ -172,27 +190,201 @@ vtkIdType vtkPriorityQueue::Pop(vtkIdType location, double &priority)
     }
  
   // percolate up the tree from the specified location
-  for ( idx=0, i=location; i > 0; i=idx )
+  if ( i == location )
     {
-    idx = (i-1)/2;
+    for ( ; i > 0 && temp.priority < this->Array[(idx=(i-1)/d)].priority;
+          i=idx )
+      {
+      this->Array[i] = this->Array[idx];
+      this->SetLocation(this->Array[i].id,i);
+      }
+    }
 
-    if ( this->Array[i].priority < this->Array[idx].priority )
+  this->Array[i] = temp;
+  this->SetLocation(temp.id,i);
+
+  return id;
+}
+
+// Make room in the location map for a new id.
+void vtkPriorityQueue::ReserveLocation(vtkIdType id)
+{
+  vtkIdType i, limit;
+
+  // ids are too sparse for an array if it would get much larger than the
+  // number of entries
+  limit = VTK_PRIORITY_QUEUE_SPARSITY * (this->MaxId + 2);
+  if ( limit < VTK_PRIORITY_QUEUE_MIN_DENSE_SIZE )
+    {
+    limit = VTK_PRIORITY_QUEUE_MIN_DENSE_SIZE;
+    }
+
+  if ( !this->HashedLocations )
+    {
+    if ( id < this->ItemLocation->GetSize() )
       {
-      temp = this->Array[i];
+      return;
+      }
+    if ( id < limit )
+      {
+      // resize and initialize the new locations
+      vtkIdType oldSize = this->ItemLocation->GetSize();
+      this->ItemLocation->InsertValue(id,-1); 
+      for (i=oldSize; i < this->ItemLocation->GetSize(); i++) 
+        {
+        this->ItemLocation->SetValue(i, -1);
+        }
+      return;
+      }
 
-      this->ItemLocation->SetValue(temp.id,idx);
-      this->Array[i] = this->Array[idx];
+    // switch to a hash table holding the current entries
+    this->HashedLocations = 1;
+    this->HashMaxId = -1;
+    this->ResizeHash(4 * (this->MaxId + 2));
+    for (i=0; i <= this->MaxId; i++)
+      {
+      this->InsertLocation(this->Array[i].id, i);
+      }
+    this->ItemLocation->Initialize();
+    return;
+    }
 
-      this->ItemLocation->SetValue(this->Array[idx].id,i);
-      this->Array[idx] = temp;
+  // keep the load of the hash table at or below one half
+  if ( 2 * (this->HashCount + 1) <= this->HashSize )
+    {
+    return;
+    }
+  vtkIdType maxId = ( id > this->HashMaxId ? id : this->HashMaxId );
+  if ( maxId < limit )
+    {
+    this->UseDenseLocations(maxId + 1);
+    }
+  else
+    {
+    this->ResizeHash(2 * this->HashSize);
+    }
+}
+
+// Add a new id to the location map; room has been made by
+// ReserveLocation().
+void vtkPriorityQueue::InsertLocation(vtkIdType id, vtkIdType location)
+{
+  if ( !this->HashedLocations )
+    {
+    this->ItemLocation->InsertValue(id,location);
+    return;
+    }
+  vtkIdType slot = this->FindHashSlot(id);
+  this->Hash[2*slot] = id;
+  this->Hash[2*slot+1] = location;
+  this->HashCount++;
+  if ( id > this->HashMaxId )
+    {
+    this->HashMaxId = id;
+    }
+}
+
+// Remove an id from the location map.
+void vtkPriorityQueue::RemoveLocation(vtkIdType id)
+{
+  if ( !this->HashedLocations )
+    {
+    this->ItemLocation->SetValue(id,-1);
+    return;
+    }
+
+  vtkIdType mask = this->HashSize - 1;
+  vtkIdType hole = this->FindHashSlot(id);
+  vtkIdType slot, home, slotId;
+  if ( this->Hash[2*hole] == -1 )
+    {
+    return;
+    }
+  this->HashCount--;
+
+  // move later entries of the probe sequence into the hole when their
+  // home slot allows it, so that no lookup stops early
+  for ( slot=(hole+1) & mask; (slotId=this->Hash[2*slot]) != -1; 
+        slot=(slot+1) & mask )
+    {
+    home = vtkPriorityQueueHash(slotId) & mask;
+    if ( slot > hole ? (home <= hole || home > slot) :
+         (home <= hole && home > slot) )
+      {
+      this->Hash[2*hole] = slotId;
+      this->Hash[2*hole+1] = this->Hash[2*slot+1];
+      hole = slot;
       }
-    else
+    }
+  this->Hash[2*hole] = -1;
+}
+
+// Return the slot holding id, or the empty slot where it would go.
+vtkIdType vtkPriorityQueue::FindHashSlot(vtkIdType id)
+{
+  vtkIdType mask = this->HashSize - 1;
+  vtkIdType slot = vtkPriorityQueueHash(id) & mask;
+  vtkIdType slotId;
+  while ( (slotId=this->Hash[2*slot]) != -1 && slotId != id )
+    {
+    slot = (slot + 1) & mask;
+    }
+  return slot;
+}
+
+// Rebuild the hash table with at least size slots.
+void vtkPriorityQueue::ResizeHash(vtkIdType size)
+{
+  vtkIdType *oldHash = this->Hash;
+  vtkIdType oldSize = this->HashSize;
+  vtkIdType i, newSize = VTK_PRIORITY_QUEUE_MIN_HASH_SIZE;
+
+  while ( newSize < size )
+    {
+    newSize *= 2;
+    }
+  this->Hash = new vtkIdType[2*newSize];
+  this->HashSize = newSize;
+  this->HashCount = 0;
+  for (i=0; i < newSize; i++)
+    {
+    this->Hash[2*i] = -1;
+    }
+
+  for (i=0; i < oldSize; i++)
+    {
+    if ( oldHash[2*i] != -1 )
       {
-      break;
+      this->InsertLocation(oldHash[2*i], oldHash[2*i+1]);
       }
     }
+  if ( oldHash )
+    {
+    delete [] oldHash;
+    }
+}
 
-  return id;
+// Go back to an array of locations with room for ids below size.
+void vtkPriorityQueue::UseDenseLocations(vtkIdType size)
+{
+  vtkIdType i;
+
+  delete [] this->Hash;
+  this->Hash = NULL;
+  this->HashSize = this->HashCount = 0;
+  this->HashMaxId = -1;
+  this->HashedLocations = 0;
+
+  this->ItemLocation->Initialize();
+  this->ItemLocation->Allocate(size);
+  for (i=0; i < size; i++)
+    {
+    this->ItemLocation->SetValue(i, -1);
+    }
+  for (i=0; i <= this->MaxId; i++)
+    {
+    this->ItemLocation->InsertValue(this->Array[i].id, i);
+    }
 }
 
 // Protected method reallocates queue.
@@ -235,11 +427,29 @@ void vtkPriorityQueue::Reset()
 {
   this->MaxId = -1;
  
-  for (int i=0; i <= this->ItemLocation->GetMaxId(); i++)
+  for (vtkIdType i=0; i <= this->ItemLocation->GetMaxId(); i++)
     {
     this->ItemLocation->SetValue(i,-1);
     }
   this->ItemLocation->Reset();
+
+  for (vtkIdType j=0; j < this->HashSize; j++)
+    {
+    this->Hash[2*j] = -1;
+    }
+  this->HashCount = 0;
+  this->HashMaxId = -1;
+}
+
+void vtkPriorityQueue::SetBranchingFactor(int factor)
+{
+  factor = ( factor < 2 ? 2 : ( factor > 16 ? 16 : factor ) );
+  if ( this->BranchingFactor != factor )
+    {
+    this->BranchingFactor = factor;
+    this->Reset();
+    this->Modified();
+    }
 }
 
 void vtkPriorityQueue::PrintSelf(ostream& os, vtkIndent indent)
@@ -249,5 +459,8 @@ void vtkPriorityQueue::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Entries: " << this->MaxId + 1 << "\n";
   os << indent << "Size: " << this->Size << "\n";
   os << indent << "Extend size: " << this->Extend << "\n";
+  os << indent << "Branching Factor: " << this->BranchingFactor << "\n";
+  os << indent << "Locations: " 
+     << (this->HashedLocations ? "Hashed\n" : "Array\n");
 }
 
@@ -25,12 +25,20 @@
 // entries in the queue which can useful for reinserting an item into the
 // queue. 
 //
+// The location of every id in the tree is kept in a map. While the ids are
+// dense (the largest id is not much larger than the number of entries) this
+// is an array indexed by id; when a few ids are spread over a large range,
+// the queue switches to an open-addressed hash table so that memory stays
+// proportional to the number of entries. The switch is automatic and does
+// not change the order in which entries are popped.
+//
 // .SECTION Caveats
 // This implementation is a variation of the priority queue described in
 // "Data Structures & Algorithms" by Aho, Hopcroft, Ullman. It creates 
-// a balanced, partially ordered binary tree implemented as an ordered
-// array. This avoids the overhead associated with parent/child pointers,
-// and frequent memory allocation and deallocation.
+// a balanced, partially ordered tree implemented as an ordered array. 
+// This avoids the overhead associated with parent/child pointers,
+// and frequent memory allocation and deallocation. The tree is binary by
+// default; see SetBranchingFactor().
 
 #ifndef __vtkPriorityQueue_h
 #define __vtkPriorityQueue_h
@@ -112,29 +120,94 @@ public:
   // overhead of memory allocation/deletion.
   void Reset();
 
+  // Description:
+  // Set/Get the number of children of every node of the tree. Wider trees
+  // are shallower, so inserting is cheaper and popping compares more
+  // entries per level; 4 is often faster than 2 for large queues. Entries
+  // with equal priorities may be popped in a different order for
+  // different values. Changing the branching factor empties the queue.
+  // The default is 2.
+  void SetBranchingFactor(int factor);
+  vtkGetMacro(BranchingFactor, int);
+
+  // Description:
+  // Return 1 if the locations of the ids are kept in a hash table rather
+  // than in an array indexed by id.
+  int GetUseHashedLocations() {return this->HashedLocations;};
+
 protected:
   vtkPriorityQueue();
   ~vtkPriorityQueue();
   
   Item *Resize(const vtkIdType sz);
 
+  // Description:
+  // Id to location map. GetLocation() returns -1 for ids not in the
+  // queue. ReserveLocation() makes room for a new id, switching between
+  // the array and the hash table if the density of the ids calls for it;
+  // InsertLocation() then adds it. SetLocation() changes the location of
+  // an id already in the queue.
+  vtkIdType GetLocation(vtkIdType id);
+  void SetLocation(vtkIdType id, vtkIdType location);
+  void ReserveLocation(vtkIdType id);
+  void InsertLocation(vtkIdType id, vtkIdType location);
+  void RemoveLocation(vtkIdType id);
+  vtkIdType FindHashSlot(vtkIdType id);
+  void ResizeHash(vtkIdType size);
+  void UseDenseLocations(vtkIdType size);
+
   vtkIdTypeArray *ItemLocation;
   Item *Array;
   vtkIdType Size;
   vtkIdType MaxId;
   vtkIdType Extend;
+  int BranchingFactor;
+
+  // Open-addressed hash table with linear probing, used instead of
+  // ItemLocation for sparse ids. Hash holds (id, location) pairs, with
+  // id == -1 marking an empty slot; HashSize is a power of two.
+  int HashedLocations;
+  vtkIdType *Hash;
+  vtkIdType HashSize;
+  vtkIdType HashCount;
+  vtkIdType HashMaxId;
 private:
   vtkPriorityQueue(const vtkPriorityQueue&);  // Not implemented.
   void operator=(const vtkPriorityQueue&);  // Not implemented.
 };
 
+inline vtkIdType vtkPriorityQueue::GetLocation(vtkIdType id)
+{
+  if ( this->HashedLocations )
+    {
+    vtkIdType slot = this->FindHashSlot(id);
+    return ( this->Hash[2*slot] == -1 ? -1 : this->Hash[2*slot+1] );
+    }
+  if ( id >= 0 && id <= this->ItemLocation->GetMaxId() )
+    {
+    return this->ItemLocation->GetValue(id);
+    }
+  return -1;
+}
+
+inline void vtkPriorityQueue::SetLocation(vtkIdType id, vtkIdType location)
+{
+  if ( this->HashedLocations )
+    {
+    this->Hash[2*this->FindHashSlot(id)+1] = location;
+    }
+  else
+    {
+    this->ItemLocation->SetValue(id, location);
+    }
+}
+
 inline double vtkPriorityQueue::DeleteId(vtkIdType id)
 {
   double priority=VTK_DOUBLE_MAX;
-  int loc;
+  vtkIdType loc;
 
-  if ( id <= this->ItemLocation->GetMaxId() &&  
-  (loc=this->ItemLocation->GetValue(id)) != -1 )
+  if ( (loc=this->GetLocation(id)) != -1 )
     {
     this->Pop(loc,priority);
     }
@@ -143,10 +216,9 @@ inline double vtkPriorityQueue::DeleteId(vtkIdType id)
 
 inline double vtkPriorityQueue::GetPriority(vtkIdType id)
 {
-  int loc;
+  vtkIdType loc;
 
-  if ( id <= this->ItemLocation->GetMaxId() &&  
-  (loc=this->ItemLocation->GetValue(id)) != -1 )
+  if ( (loc=this->GetLocation(id)) != -1 )
     {
     return this->Array[loc].priority;
     }
@@ -26,6 +26,7 @@
 
 #include "vtkAbstractArray.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkIdList.h"
 #include "vtkStdString.h"
@@ -35,6 +36,8 @@
 
 #include <vtkstd/algorithm>
 
+#include <string.h>
+
 // -------------------------------------------------------------------------
 
 vtkStandardNewMacro(vtkSortDataArray);
@@ -183,6 +186,318 @@ void vtkSortDataArrayQuickSort(TKey *keys, TValue *values,
     }
 }
 
+// ---------------------------------------------------------------------------
+// LSD radix sort for numeric keys
+//
+// Keys are mapped to unsigned integers of the same size whose order is the
+// order of the keys, and sorted along with their original position, one
+// byte at a time starting with the least significant one. Each pass is
+// stable, so the last one leaves the keys sorted. Every pass is split into
+// contiguous ranges of items, one per thread: the threads first count the
+// bytes of their range, then move their items to the slots given by the
+// counts of all threads. Once sorted, the keys are decoded in place and
+// the value tuples are gathered from their original positions.
+
+// Below this many keys the quicksort above is faster.
+static const vtkIdType vtkSortDataArrayRadixThreshold = 1024;
+
+// Below this many keys per thread, starting threads does not pay off.
+static const vtkIdType vtkSortDataArrayMinimumKeysPerThread = 65536;
+
+template<int Size> struct vtkSortDataArrayUnsigned;
+template<> struct vtkSortDataArrayUnsigned<1> { typedef vtkTypeUInt8 Type; };
+template<> struct vtkSortDataArrayUnsigned<2> { typedef vtkTypeUInt16 Type; };
+template<> struct vtkSortDataArrayUnsigned<4> { typedef vtkTypeUInt32 Type; };
+template<> struct vtkSortDataArrayUnsigned<8> { typedef vtkTypeUInt64 Type; };
+
+// Integers: flipping the sign bit orders negative values first.
+template<class TKey>
+struct vtkSortDataArrayRadixTraits
+{
+  typedef typename vtkSortDataArrayUnsigned<sizeof(TKey)>::Type Bits;
+  static Bits SignFlip()
+    {
+    if (static_cast<TKey>(-1) < static_cast<TKey>(0))
+      {
+      return static_cast<Bits>(static_cast<Bits>(1) << (8*sizeof(TKey) - 1));
+      }
+    return 0;
+    }
+  static Bits Encode(TKey key)
+    {
+    return static_cast<Bits>(static_cast<Bits>(key) ^ SignFlip());
+    }
+  static TKey Decode(Bits bits)
+    {
+    return static_cast<TKey>(static_cast<Bits>(bits ^ SignFlip()));
+    }
+};
+
+// IEEE floating point: negative values have all their bits flipped so
+// that larger magnitudes come first, positive values get their sign bit
+// set so that they come after the negative ones.
+template<>
+struct vtkSortDataArrayRadixTraits<float>
+{
+  typedef vtkTypeUInt32 Bits;
+  static Bits Encode(float key)
+    {
+    Bits bits;
+    memcpy(&bits, &key, sizeof(Bits));
+    Bits sign = static_cast<Bits>(1) << 31;
+    return (bits & sign) ? ~bits : (bits | sign);
+    }
+  static float Decode(Bits bits)
+    {
+    Bits sign = static_cast<Bits>(1) << 31;
+    bits = (bits & sign) ? (bits & ~sign) : ~bits;
+    float key;
+    memcpy(&key, &bits, sizeof(Bits));
+    return key;
+    }
+};
+
+template<>
+struct vtkSortDataArrayRadixTraits<double>
+{
+  typedef vtkTypeUInt64 Bits;
+  static Bits Encode(double key)
+    {
+    Bits bits;
+    memcpy(&bits, &key, sizeof(Bits));
+    Bits sign = static_cast<Bits>(1) << 63;
+    return (bits & sign) ? ~bits : (bits | sign);
+    }
+  static double Decode(Bits bits)
+    {
+    Bits sign = static_cast<Bits>(1) << 63;
+    bits = (bits & sign) ? (bits & ~sign) : ~bits;
+    double key;
+    memcpy(&key, &bits, sizeof(Bits));
+    return key;
+    }
+};
+
+// TIndex holds the original position of the keys, a 32 bit type is used
+// when possible to reduce the memory traffic of the passes.
+template<class TKey, class TValue, class TIndex>
+class vtkSortDataArrayRadixSorter
+{
+public:
+  typedef typename vtkSortDataArrayRadixTraits<TKey>::Bits Bits;
+
+  struct Item
+  {
+    Bits Key;
+    TIndex Index;
+  };
+
+  enum
+  {
+    ENCODE,
+    COUNT,
+    SCATTER,
+    GATHER
+  };
+
+  TKey *Keys;
+  TValue *Values;
+  int TupleSize;
+  vtkIdType Size;
+  TValue *ValueCopy;
+  Item *Source;
+  Item *Target;
+  int Shift;
+  int Phase;
+  vtkIdType Counts[VTK_MAX_THREADS][256];
+
+  void Sort(vtkMultiThreader *threader)
+    {
+    int numThreads = threader->GetNumberOfThreads();
+    Item *items = new Item[this->Size];
+    Item *buffer = new Item[this->Size];
+    this->Source = items;
+    this->Target = buffer;
+    this->Phase = ENCODE;
+    threader->SingleMethodExecute();
+
+    for (this->Shift = 0; this->Shift < static_cast<int>(8*sizeof(Bits));
+         this->Shift += 8)
+      {
+      this->Phase = COUNT;
+      threader->SingleMethodExecute();
+
+      // Turn the counts into the first slot of each thread and byte.
+      // A byte shared by all keys leaves their order unchanged.
+      vtkIdType slot = 0;
+      bool skip = false;
+      for (int byte = 0; byte < 256 && !skip; byte++)
+        {
+        vtkIdType first = slot;
+        for (int t = 0; t < numThreads; t++)
+          {
+          vtkIdType count = this->Counts[t][byte];
+          this->Counts[t][byte] = slot;
+          slot += count;
+          }
+        skip = (slot - first == this->Size);
+        }
+      if (skip)
+        {
+        continue;
+        }
+
+      this->Phase = SCATTER;
+      threader->SingleMethodExecute();
+      Item *tmp = this->Source;
+      this->Source = this->Target;
+      this->Target = tmp;
+      }
+
+    this->ValueCopy = 0;
+    if (this->Values && this->TupleSize > 0)
+      {
+      this->ValueCopy = new TValue[this->Size*this->TupleSize];
+      vtkstd::copy(this->Values, this->Values + this->Size*this->TupleSize,
+                   this->ValueCopy);
+      }
+    this->Phase = GATHER;
+    threader->SingleMethodExecute();
+    delete [] this->ValueCopy;
+    delete [] items;
+    delete [] buffer;
+    }
+
+  static VTK_THREAD_RETURN_TYPE Execute(void *arg)
+    {
+    vtkMultiThreader::ThreadInfo *info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkSortDataArrayRadixSorter *self =
+      static_cast<vtkSortDataArrayRadixSorter*>(info->UserData);
+    int tid = info->ThreadID;
+    int numThreads = info->NumberOfThreads;
+    vtkIdType begin = self->Size * tid / numThreads;
+    vtkIdType end = self->Size * (tid + 1) / numThreads;
+    vtkIdType i;
+
+    switch (self->Phase)
+      {
+      case ENCODE:
+        for (i = begin; i < end; i++)
+          {
+          self->Source[i].Key =
+            vtkSortDataArrayRadixTraits<TKey>::Encode(self->Keys[i]);
+          self->Source[i].Index = static_cast<TIndex>(i);
+          }
+        break;
+      case COUNT:
+        {
+        vtkIdType *counts = self->Counts[tid];
+        for (i = 0; i < 256; i++)
+          {
+          counts[i] = 0;
+          }
+        for (i = begin; i < end; i++)
+          {
+          counts[(self->Source[i].Key >> self->Shift) & 0xff]++;
+          }
+        }
+        break;
+      case SCATTER:
+        {
+        vtkIdType *slots = self->Counts[tid];
+        for (i = begin; i < end; i++)
+          {
+          const Item &item = self->Source[i];
+          self->Target[slots[(item.Key >> self->Shift) & 0xff]++] = item;
+          }
+        }
+        break;
+      case GATHER:
+        {
+        int tupleSize = self->TupleSize;
+        for (i = begin; i < end; i++)
+          {
+          self->Keys[i] =
+            vtkSortDataArrayRadixTraits<TKey>::Decode(self->Source[i].Key);
+          if (self->ValueCopy)
+            {
+            vtkIdType index = self->Source[i].Index;
+            for (int j = 0; j < tupleSize; j++)
+              {
+              self->Values[i*tupleSize + j] = self->ValueCopy[index*tupleSize + j];
+              }
+            }
+          }
+        }
+        break;
+      }
+
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
+template<class TKey, class TValue, class TIndex>
+void vtkSortDataArrayRadixSort(TKey *keys, TValue *values,
+                               vtkIdType size, int tupleSize, TIndex *)
+{
+  vtkIdType numThreads = size / vtkSortDataArrayMinimumKeysPerThread;
+  if (numThreads > vtkMultiThreader::GetGlobalDefaultNumberOfThreads())
+    {
+    numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  if (numThreads < 1)
+    {
+    numThreads = 1;
+    }
+
+  vtkSortDataArrayRadixSorter<TKey, TValue, TIndex> *sorter =
+    new vtkSortDataArrayRadixSorter<TKey, TValue, TIndex>;
+  sorter->Keys = keys;
+  sorter->Values = values;
+  sorter->TupleSize = tupleSize;
+  sorter->Size = size;
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(static_cast<int>(numThreads));
+  threader->SetSingleMethod(
+    vtkSortDataArrayRadixSorter<TKey, TValue, TIndex>::Execute, sorter);
+  sorter->Sort(threader);
+  threader->Delete();
+  delete sorter;
+}
+
+// Sorts keys (and values, when not NULL) with the radix sort above, or
+// with the quicksort when there are only a few keys.
+template<class TKey, class TValue>
+void vtkSortDataArrayRadixSort(TKey *keys, TValue *values,
+                               vtkIdType size, int tupleSize)
+{
+  if (size < vtkSortDataArrayRadixThreshold)
+    {
+    if (values)
+      {
+      vtkSortDataArrayQuickSort(keys, values, size, tupleSize);
+      }
+    else
+      {
+      vtkstd::sort(keys, keys + size);
+      }
+    }
+#if VTK_SIZEOF_ID_TYPE > 4
+  else if (size > static_cast<vtkIdType>(VTK_UNSIGNED_INT_MAX))
+    {
+    vtkSortDataArrayRadixSort(keys, values, size, tupleSize,
+                              static_cast<vtkIdType*>(0));
+    }
+#endif
+  else
+    {
+    vtkSortDataArrayRadixSort(keys, values, size, tupleSize,
+                              static_cast<unsigned int*>(0));
+    }
+}
+
 // ---------------------------------------------------------------------------
 // Data array to raw array template helper functions
 
@@ -200,6 +515,41 @@ inline void vtkSortDataArraySort00(TKey *keys, TValue *values,
   vtkSortDataArrayQuickSort(keys, values, array_size, tuple_size);
 }
 
+template<class TKey>
+inline void vtkSortDataArraySort0(TKey *keys, vtkIdType array_size)
+{
+  vtkstd::sort(keys, keys + array_size);
+}
+
+// Numeric keys use the radix sort.
+#define vtkSortDataArrayRadixKeyMacro(TKey)                             \
+  template<class TValue>                                                \
+  inline void vtkSortDataArraySort00(TKey *keys, TValue *values,        \
+                                     vtkIdType array_size, int tuple_size) \
+  {                                                                     \
+    vtkSortDataArrayRadixSort(keys, values, array_size, tuple_size);    \
+  }                                                                     \
+  inline void vtkSortDataArraySort0(TKey *keys, vtkIdType array_size)   \
+  {                                                                     \
+    vtkSortDataArrayRadixSort(keys, static_cast<TKey*>(0), array_size, 0); \
+  }
+
+vtkSortDataArrayRadixKeyMacro(double)
+vtkSortDataArrayRadixKeyMacro(float)
+#ifdef VTK_TYPE_USE_LONG_LONG
+vtkSortDataArrayRadixKeyMacro(long long)
+vtkSortDataArrayRadixKeyMacro(unsigned long long)
+#endif // VTK_TYPE_USE_LONG_LONG
+vtkSortDataArrayRadixKeyMacro(long)
+vtkSortDataArrayRadixKeyMacro(unsigned long)
+vtkSortDataArrayRadixKeyMacro(int)
+vtkSortDataArrayRadixKeyMacro(unsigned int)
+vtkSortDataArrayRadixKeyMacro(short)
+vtkSortDataArrayRadixKeyMacro(unsigned short)
+vtkSortDataArrayRadixKeyMacro(char)
+vtkSortDataArrayRadixKeyMacro(signed char)
+vtkSortDataArrayRadixKeyMacro(unsigned char)
+
 template<class TKey, class TComp>
 void vtkSortDataArraySort01(TKey *keys, vtkAbstractArray *values, vtkIdType array_size,
                             TComp comp)
@@ -396,9 +746,7 @@ int vtkSortDataArrayComponentCompare_VTK_VARIANT( const void* a, const void* b )
 
 void vtkSortDataArray::Sort(vtkIdList *keys)
 {
-  vtkIdType *data = keys->GetPointer(0);
-  vtkIdType numKeys = keys->GetNumberOfIds();
-  vtkstd::sort(data, data + numKeys);
+  vtkSortDataArraySort0(keys->GetPointer(0), keys->GetNumberOfIds());
 }
 
 void vtkSortDataArray::Sort(vtkAbstractArray *keys)
@@ -414,7 +762,7 @@ void vtkSortDataArray::Sort(vtkAbstractArray *keys)
 
   switch (keys->GetDataType())
     {
-    vtkExtendedTemplateMacro(vtkstd::sort(static_cast<VTK_TT *>(data), static_cast<VTK_TT *>(data) + numKeys));
+    vtkExtendedTemplateMacro(vtkSortDataArraySort0(static_cast<VTK_TT *>(data), numKeys));
     }
 }
 
@@ -23,6 +23,10 @@
  */
 
 // .NAME vtkSortDataArray - Provides several methods for sorting vtk arrays.
+// .SECTION Description
+// Large arrays of integer or floating point keys are sorted with a radix
+// sort whose passes are shared among the global default number of threads
+// of vtkMultiThreader. Other keys are sorted with a quicksort.
 
 #ifndef __vtkSortDataArray_h
 #define __vtkSortDataArray_h
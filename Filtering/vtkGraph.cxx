@@ -235,6 +235,15 @@ unsigned long int vtkGraph::GetMTime()
 //----------------------------------------------------------------------------
 void vtkGraph::Initialize()
 {
+  // A frozen structure is about to be cleared, so there is no point in
+  // converting it back to adjacency lists.
+  if (this->Internals->Frozen)
+    {
+    vtkGraphInternals *internals = vtkGraphInternals::New();
+    internals->UsingPedigreeIds = this->Internals->UsingPedigreeIds;
+    this->SetInternals(internals);
+    internals->Delete();
+    }
   this->ForceOwnership();
   Superclass::Initialize();
   this->EdgeData->Initialize();
@@ -287,7 +296,7 @@ vtkOutEdgeType vtkGraph::GetOutEdge(vtkIdType v, vtkIdType i)
 
   if (i < this->GetOutDegree(v))
     {
-    return this->Internals->Adjacency[index].OutEdges[i];
+    return this->Internals->GetOutEdges(index)[i];
     }
   vtkErrorMacro("Out edge index out of bounds");
   return vtkOutEdgeType();
@@ -320,15 +329,8 @@ void vtkGraph::GetOutEdges(vtkIdType v, const vtkOutEdgeType *& edges, vtkIdType
     index = helper->GetVertexIndex(v);
     }
 
-  nedges = this->Internals->Adjacency[index].OutEdges.size();
-  if (nedges > 0)
-    {
-    edges = &(this->Internals->Adjacency[index].OutEdges[0]);
-    }
-  else
-    {
-    edges = 0;
-    }
+  nedges = this->Internals->GetOutDegree(index);
+  edges = this->Internals->GetOutEdges(index);
 }
 
 //----------------------------------------------------------------------------
@@ -346,7 +348,7 @@ vtkIdType vtkGraph::GetOutDegree(vtkIdType v)
 
     index = helper->GetVertexIndex(v);
     }
-  return this->Internals->Adjacency[index].OutEdges.size();
+  return this->Internals->GetOutDegree(index);
 }
 
 //----------------------------------------------------------------------------
@@ -366,8 +368,8 @@ vtkIdType vtkGraph::GetDegree(vtkIdType v)
     index = helper->GetVertexIndex(v);
     }
 
-  return this->Internals->Adjacency[index].InEdges.size() +
-         this->Internals->Adjacency[index].OutEdges.size();
+  return this->Internals->GetInDegree(index) +
+         this->Internals->GetOutDegree(index);
 }
 
 //----------------------------------------------------------------------------
@@ -406,7 +408,7 @@ vtkInEdgeType vtkGraph::GetInEdge(vtkIdType v, vtkIdType i)
 
   if (i < this->GetInDegree(v))
     {
-    return this->Internals->Adjacency[index].InEdges[i];
+    return this->Internals->GetInEdges(index)[i];
     }
   vtkErrorMacro("In edge index out of bounds");
   return vtkInEdgeType();
@@ -438,15 +440,8 @@ void vtkGraph::GetInEdges(vtkIdType v, const vtkInEdgeType *& edges, vtkIdType &
     index = helper->GetVertexIndex(v);
     }
 
-  nedges = this->Internals->Adjacency[index].InEdges.size();
-  if (nedges > 0)
-    {
-    edges = &(this->Internals->Adjacency[index].InEdges[0]);
-    }
-  else
-    {
-    edges = 0;
-    }
+  nedges = this->Internals->GetInDegree(index);
+  edges = this->Internals->GetInEdges(index);
 }
 
 //----------------------------------------------------------------------------
@@ -466,7 +461,7 @@ vtkIdType vtkGraph::GetInDegree(vtkIdType v)
     index = helper->GetVertexIndex(v);
     }
 
-  return this->Internals->Adjacency[index].InEdges.size();
+  return this->Internals->GetInDegree(index);
 }
 
 //----------------------------------------------------------------------------
@@ -515,7 +510,7 @@ void vtkGraph::GetVertices(vtkVertexListIterator *it)
 //----------------------------------------------------------------------------
 vtkIdType vtkGraph::GetNumberOfVertices()
 {
-  return this->Internals->Adjacency.size();
+  return this->Internals->GetNumberOfVertices();
 }
 
 //----------------------------------------------------------------------------
@@ -1635,6 +1630,8 @@ void vtkGraph::RemoveVerticesInternal(vtkIdTypeArray* arr, bool directed)
     return;
     }
 
+  this->ForceOwnership();
+
   // Sort
   vtkIdType* p = arr->GetPointer(0);
   vtkIdType numVert = arr->GetNumberOfTuples();
@@ -1740,6 +1737,18 @@ void vtkGraph::ReorderOutVertices(vtkIdType v, vtkIdTypeArray *vertices)
   this->Internals->Adjacency[index].OutEdges = outEdges;
 }
 
+//----------------------------------------------------------------------------
+void vtkGraph::Freeze()
+{
+  this->Internals->Freeze();
+}
+
+//----------------------------------------------------------------------------
+bool vtkGraph::IsFrozen()
+{
+  return this->Internals->Frozen;
+}
+
 //----------------------------------------------------------------------------
 bool vtkGraph::IsSameStructure(vtkGraph *other)
 {
@@ -1766,10 +1775,17 @@ void vtkGraph::ForceOwnership()
     {
     vtkGraphInternals *internals = vtkGraphInternals::New();
     internals->Adjacency = this->Internals->Adjacency;
+    internals->OutOffsets = this->Internals->OutOffsets;
+    internals->OutEdges = this->Internals->OutEdges;
+    internals->InOffsets = this->Internals->InOffsets;
+    internals->InEdges = this->Internals->InEdges;
+    internals->Frozen = this->Internals->Frozen;
     internals->NumberOfEdges = this->Internals->NumberOfEdges;
     this->SetInternals(internals);
     internals->Delete();
     }
+  // A frozen structure cannot be modified in place.
+  this->Internals->Thaw();
   if (this->EdgePoints && this->EdgePoints->GetReferenceCount() > 1)
     {
     vtkGraphEdgePoints *oldEdgePoints = this->EdgePoints;
@@ -1814,19 +1830,24 @@ vtkIdType vtkGraph::GetNumberOfElements(int type)
 void vtkGraph::Dump()
 {
   cout << "vertex adjacency:" << endl;
-  for (size_t v = 0; v < this->Internals->Adjacency.size(); ++v)
+  vtkIdType numVerts = this->Internals->GetNumberOfVertices();
+  for (vtkIdType v = 0; v < numVerts; ++v)
     {
     cout << v << " (out): ";
-    for (size_t eind = 0; eind < this->Internals->Adjacency[v].OutEdges.size(); ++eind)
+    const vtkOutEdgeType *outEdges = this->Internals->GetOutEdges(v);
+    vtkIdType outDegree = this->Internals->GetOutDegree(v);
+    for (vtkIdType eind = 0; eind < outDegree; ++eind)
       {
-      cout << "[" << this->Internals->Adjacency[v].OutEdges[eind].Id
-           << "," << this->Internals->Adjacency[v].OutEdges[eind].Target << "]";
+      cout << "[" << outEdges[eind].Id
+           << "," << outEdges[eind].Target << "]";
       }
     cout << " (in): ";
-    for (size_t eind = 0; eind < this->Internals->Adjacency[v].InEdges.size(); ++eind)
+    const vtkInEdgeType *inEdges = this->Internals->GetInEdges(v);
+    vtkIdType inDegree = this->Internals->GetInDegree(v);
+    for (vtkIdType eind = 0; eind < inDegree; ++eind)
       {
-      cout << "[" << this->Internals->Adjacency[v].InEdges[eind].Id
-           << "," << this->Internals->Adjacency[v].InEdges[eind].Source << "]";
+      cout << "[" << inEdges[eind].Id
+           << "," << inEdges[eind].Source << "]";
       }
     cout << endl;
     }
@@ -89,6 +89,13 @@
 // which point from the parent to the child, then use CheckedShallowCopy
 // to set the structure to a vtkTree.
 //
+// Once a graph is complete, Freeze() stores its adjacency in a compact
+// compressed sparse row layout: the edges of all vertices are kept in one
+// contiguous array instead of two small arrays per vertex. This uses much
+// less memory for large graphs and makes traversal faster. Frozen graphs
+// remain fully readable; modifying one converts it back to the regular
+// layout first.
+//
 // .SECTION Caveats
 // All copy operations implement copy-on-write. The structures are initially
 // shared, but if one of the graphs is modified, the structure is copied
@@ -477,6 +484,17 @@ public:
   // In a distributed graph, the vertex v must be local.
   void ReorderOutVertices(vtkIdType v, vtkIdTypeArray *vertices);
 
+  // Description:
+  // Store the adjacency structure in compressed sparse row form, which is
+  // smaller and faster to traverse but cannot be modified in place. Any
+  // later modification converts the structure back first. Graphs sharing
+  // the structure are frozen as well.
+  void Freeze();
+
+  // Description:
+  // Returns true if the adjacency structure is frozen.
+  bool IsFrozen();
+
   // Description:
   // Returns true if both graphs point to the same adjacency structure.
   // Can be used to test the copy-on-write feature of the graph.
@@ -537,7 +555,7 @@ public:
   // Description:
   // Returns the internal representation of the graph. If modifying is
   // true, then the returned vtkGraphInternals object will be unique to
-  // this vtkGraph object.
+  // this vtkGraph object and will not be frozen.
   vtkGraphInternals *GetGraphInternals(bool modifying);
 
   // Description:
@@ -646,7 +664,8 @@ protected:
 
   // Description:
   // If this instance does not own its internals, it makes a copy of the
-  // internals.  This is called before any write operation.
+  // internals. Frozen internals are converted back to adjacency lists.
+  // This is called before any write operation.
   void ForceOwnership();
 
   // Description:
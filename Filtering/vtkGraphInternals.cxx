@@ -29,6 +29,7 @@ vtkGraphInternals::vtkGraphInternals()
   this->NumberOfEdges = 0; 
   this->LastRemoteEdgeId = -1;
   this->UsingPedigreeIds = false;
+  this->Frozen = false;
 }
 
 //----------------------------------------------------------------------------
@@ -36,6 +37,72 @@ vtkGraphInternals::~vtkGraphInternals()
 {
 }
 
+//----------------------------------------------------------------------------
+void vtkGraphInternals::Freeze()
+{
+  if (this->Frozen)
+    {
+    return;
+    }
+
+  size_t numVerts = this->Adjacency.size();
+  size_t numOut = 0;
+  size_t numIn = 0;
+  size_t v;
+  for (v = 0; v < numVerts; ++v)
+    {
+    numOut += this->Adjacency[v].OutEdges.size();
+    numIn += this->Adjacency[v].InEdges.size();
+    }
+
+  this->OutOffsets.resize(numVerts + 1);
+  this->InOffsets.resize(numVerts + 1);
+  this->OutEdges.reserve(numOut);
+  this->InEdges.reserve(numIn);
+  for (v = 0; v < numVerts; ++v)
+    {
+    vtkVertexAdjacencyList &adj = this->Adjacency[v];
+    this->OutOffsets[v] = static_cast<vtkIdType>(this->OutEdges.size());
+    this->InOffsets[v] = static_cast<vtkIdType>(this->InEdges.size());
+    this->OutEdges.insert(this->OutEdges.end(),
+      adj.OutEdges.begin(), adj.OutEdges.end());
+    this->InEdges.insert(this->InEdges.end(),
+      adj.InEdges.begin(), adj.InEdges.end());
+    // Release the list now to keep the peak memory use down.
+    vtksys_stl::vector<vtkOutEdgeType>().swap(adj.OutEdges);
+    vtksys_stl::vector<vtkInEdgeType>().swap(adj.InEdges);
+    }
+  this->OutOffsets[numVerts] = static_cast<vtkIdType>(numOut);
+  this->InOffsets[numVerts] = static_cast<vtkIdType>(numIn);
+  vtksys_stl::vector<vtkVertexAdjacencyList>().swap(this->Adjacency);
+  this->Frozen = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkGraphInternals::Thaw()
+{
+  if (!this->Frozen)
+    {
+    return;
+    }
+
+  vtkIdType numVerts = this->GetNumberOfVertices();
+  this->Adjacency.resize(numVerts);
+  for (vtkIdType v = 0; v < numVerts; ++v)
+    {
+    vtkVertexAdjacencyList &adj = this->Adjacency[v];
+    adj.OutEdges.assign(this->OutEdges.begin() + this->OutOffsets[v],
+      this->OutEdges.begin() + this->OutOffsets[v+1]);
+    adj.InEdges.assign(this->InEdges.begin() + this->InOffsets[v],
+      this->InEdges.begin() + this->InOffsets[v+1]);
+    }
+  vtksys_stl::vector<vtkIdType>().swap(this->OutOffsets);
+  vtksys_stl::vector<vtkOutEdgeType>().swap(this->OutEdges);
+  vtksys_stl::vector<vtkIdType>().swap(this->InOffsets);
+  vtksys_stl::vector<vtkInEdgeType>().swap(this->InEdges);
+  this->Frozen = false;
+}
+
 //----------------------------------------------------------------------------
 void vtkGraphInternals::RemoveEdgeFromOutList(vtkIdType e, vtksys_stl::vector<vtkOutEdgeType>& outEdges)
 {
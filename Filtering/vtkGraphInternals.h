@@ -21,6 +21,13 @@
 // .SECTION Description
 // This is the internal representation of vtkGraph, used only in rare cases 
 // where one must modify that representation.
+//
+// The adjacency is normally kept as one vtkVertexAdjacencyList per vertex in
+// Adjacency. Once frozen, it is kept instead in compressed sparse row form:
+// the out (resp. in) edges of vertex v are
+// OutEdges[OutOffsets[v]] to OutEdges[OutOffsets[v+1]-1], and Adjacency is
+// empty. Use the GetNumberOfVertices(), GetOutDegree(), GetOutEdges(), ...
+// accessors to read the adjacency in either form.
 
 #ifndef __vtkGraphInternals_h
 #define __vtkGraphInternals_h
@@ -52,9 +59,19 @@ public:
   //BTX
   vtkTypeMacro(vtkGraphInternals, vtkObject);
   vtksys_stl::vector<vtkVertexAdjacencyList> Adjacency;
+
+  // Description:
+  // The compressed adjacency, only used when Frozen is true.
+  vtksys_stl::vector<vtkIdType> OutOffsets;
+  vtksys_stl::vector<vtkOutEdgeType> OutEdges;
+  vtksys_stl::vector<vtkIdType> InOffsets;
+  vtksys_stl::vector<vtkInEdgeType> InEdges;
   //ETX
   vtkIdType NumberOfEdges;
 
+  // Whether the adjacency is stored in compressed sparse row form.
+  bool Frozen;
+
   vtkIdType LastRemoteEdgeId;
   vtkIdType LastRemoteEdgeSource;
   vtkIdType LastRemoteEdgeTarget;
@@ -66,7 +83,69 @@ public:
   // vtkMutableDirectedGraph.
   bool UsingPedigreeIds;
 
+  // Description:
+  // Move the adjacency lists to the compressed sparse row arrays, releasing
+  // the per-vertex lists as they are copied.
+  void Freeze();
+
+  // Description:
+  // Move the compressed adjacency back to per-vertex lists so that it can
+  // be modified.
+  void Thaw();
+
   //BTX
+  // Description:
+  // Accessors for the adjacency that work in both forms. The edge pointers
+  // are NULL when the degree is zero.
+  vtkIdType GetNumberOfVertices()
+    {
+    if (this->Frozen)
+      {
+      return static_cast<vtkIdType>(this->OutOffsets.size()) - 1;
+      }
+    return static_cast<vtkIdType>(this->Adjacency.size());
+    }
+  vtkIdType GetOutDegree(vtkIdType v)
+    {
+    if (this->Frozen)
+      {
+      return this->OutOffsets[v+1] - this->OutOffsets[v];
+      }
+    return static_cast<vtkIdType>(this->Adjacency[v].OutEdges.size());
+    }
+  vtkIdType GetInDegree(vtkIdType v)
+    {
+    if (this->Frozen)
+      {
+      return this->InOffsets[v+1] - this->InOffsets[v];
+      }
+    return static_cast<vtkIdType>(this->Adjacency[v].InEdges.size());
+    }
+  const vtkOutEdgeType *GetOutEdges(vtkIdType v)
+    {
+    if (this->GetOutDegree(v) == 0)
+      {
+      return 0;
+      }
+    if (this->Frozen)
+      {
+      return &this->OutEdges[this->OutOffsets[v]];
+      }
+    return &this->Adjacency[v].OutEdges[0];
+    }
+  const vtkInEdgeType *GetInEdges(vtkIdType v)
+    {
+    if (this->GetInDegree(v) == 0)
+      {
+      return 0;
+      }
+    if (this->Frozen)
+      {
+      return &this->InEdges[this->InOffsets[v]];
+      }
+    return &this->Adjacency[v].InEdges[0];
+    }
+
   // Description:
   // Convenience method for removing an edge from an out edge list.
   void RemoveEdgeFromOutList(vtkIdType e, vtksys_stl::vector<vtkOutEdgeType>& outEdges);
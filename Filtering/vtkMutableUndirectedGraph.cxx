@@ -53,6 +53,7 @@ vtkIdType vtkMutableUndirectedGraph::SetNumberOfVertices( vtkIdType numVerts )
     return retval;
     }
 
+  this->ForceOwnership();
   retval = static_cast<vtkIdType>( this->Internals->Adjacency.size() );
   this->Internals->Adjacency.resize( numVerts );
   return retval;
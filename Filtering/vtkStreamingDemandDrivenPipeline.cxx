@@ -48,6 +48,7 @@ vtkInformationKeyMacro(vtkStreamingDemandDrivenPipeline, UPDATE_NUMBER_OF_GHOST_
 vtkInformationKeyMacro(vtkStreamingDemandDrivenPipeline, UPDATE_EXTENT_TRANSLATED, Integer);
 vtkInformationKeyRestrictedMacro(vtkStreamingDemandDrivenPipeline, WHOLE_EXTENT, IntegerVector, 6);
 vtkInformationKeyRestrictedMacro(vtkStreamingDemandDrivenPipeline, UPDATE_EXTENT, IntegerVector, 6);
+vtkInformationKeyRestrictedMacro(vtkStreamingDemandDrivenPipeline, PREFETCH_UPDATE_EXTENT, IntegerVector, 6);
 vtkInformationKeyRestrictedMacro(vtkStreamingDemandDrivenPipeline,
                                  EXTENT_TRANSLATOR, ObjectBase,
                                  "vtkExtentTranslator");
@@ -492,6 +493,9 @@ vtkStreamingDemandDrivenPipeline
           //Copy requested resolution back
           inInfo->CopyEntry(outInfo, UPDATE_RESOLUTION());
 
+          // Copy the hint about the extent that will be requested next
+          inInfo->CopyEntry(outInfo, PREFETCH_UPDATE_EXTENT());
+
           // Consider all combinations of extent types.
           if(inData->GetExtentType() == VTK_PIECES_EXTENT)
             {
@@ -676,6 +680,9 @@ vtkStreamingDemandDrivenPipeline
           //Copy requested resolution back
           inInfo->CopyEntry(outInfo, UPDATE_RESOLUTION());
 
+          // Copy the hint about the extent that will be requested next
+          inInfo->CopyEntry(outInfo, PREFETCH_UPDATE_EXTENT());
+
           vtkDataObject *inData = inInfo->Get(vtkDataObject::DATA_OBJECT());
           if (inData)
             {
@@ -197,6 +197,13 @@ public:
   static vtkInformationIntegerKey* UPDATE_NUMBER_OF_PIECES();
   static vtkInformationIntegerKey* UPDATE_NUMBER_OF_GHOST_LEVELS();
 
+  // Description:
+  // Key to store the extent that will be requested after the current
+  // update extent, e.g. the next piece of a streamed update.  Sources
+  // may use it to start reading that extent ahead of time.  It is
+  // passed upstream along with the update extent.
+  static vtkInformationIntegerVectorKey* PREFETCH_UPDATE_EXTENT();
+
   // Description:
   // This is set if the extent was set through extent translation.
   // GenerateGhostLevelArray() is called only when this is set.
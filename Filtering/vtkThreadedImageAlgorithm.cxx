@@ -56,6 +56,7 @@ struct vtkImageThreadStruct
   vtkInformationVector *OutputsInfo;
   vtkImageData   ***Inputs;
   vtkImageData   **Outputs;
+  int SplitInput;
 };
 
 //----------------------------------------------------------------------------
@@ -138,8 +139,8 @@ VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
   str = static_cast<vtkImageThreadStruct *>
     (static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
 
-  // if we have an output
-  if (str->Filter->GetNumberOfOutputPorts())
+  // if we have an output, unless the input is to be split
+  if (str->Filter->GetNumberOfOutputPorts() && !str->SplitInput)
     {
     // which output port did the request come from
     int outputPort = 
@@ -212,6 +213,65 @@ VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
 }
 
 
+//----------------------------------------------------------------------------
+// Fill in the input data objects of the thread structure.
+static void vtkThreadedImageAlgorithmSetInputs(
+  vtkThreadedImageAlgorithm *self,
+  vtkInformationVector** inputVector,
+  vtkImageThreadStruct *str)
+{
+  int i;
+
+  str->Inputs = 0;
+  if (self->GetNumberOfInputPorts())
+    {
+    str->Inputs = new vtkImageData ** [self->GetNumberOfInputPorts()];
+    for (i = 0; i < self->GetNumberOfInputPorts(); ++i)
+      {
+      str->Inputs[i] = 0;
+      vtkInformationVector* portInfo = inputVector[i];
+      
+      if (portInfo->GetNumberOfInformationObjects())
+        {
+        int j;
+        str->Inputs[i] = 
+          new vtkImageData *[portInfo->GetNumberOfInformationObjects()];
+        for (j = 0; j < portInfo->GetNumberOfInformationObjects(); ++j)
+          {
+          vtkInformation* info = portInfo->GetInformationObject(j);
+          str->Inputs[i][j] =
+            static_cast<vtkImageData*>(info->Get(vtkDataObject::DATA_OBJECT()));
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Free the arrays of the thread structure.
+static void vtkThreadedImageAlgorithmFreeArrays(
+  vtkThreadedImageAlgorithm *self,
+  vtkImageThreadStruct *str)
+{
+  // free up the arrays
+  for (int i = 0; i < self->GetNumberOfInputPorts(); ++i)
+    {
+    if (str->Inputs[i])
+      {
+      delete [] str->Inputs[i];
+      }
+    }
+  // note the check isn't required by C++ standard but due to bad compilers
+  if (str->Inputs)
+    {
+    delete [] str->Inputs;
+    }
+  if (str->Outputs)
+    {
+    delete [] str->Outputs;  
+    }
+}
+
 //----------------------------------------------------------------------------
 // This is the superclasses style of Execute method.  Convert it into
 // an imaging style Execute method.
@@ -228,6 +288,7 @@ int vtkThreadedImageAlgorithm::RequestData(
   str.Request = request;
   str.InputsInfo = inputVector;
   str.OutputsInfo = outputVector;
+  str.SplitInput = 0;
 
   // now we must create the output array
   str.Outputs = 0;
@@ -251,30 +312,7 @@ int vtkThreadedImageAlgorithm::RequestData(
       }
     }
   
-  // now create the inputs array
-  str.Inputs = 0;
-  if (this->GetNumberOfInputPorts())
-    {
-    str.Inputs = new vtkImageData ** [this->GetNumberOfInputPorts()];
-    for (i = 0; i < this->GetNumberOfInputPorts(); ++i)
-      {
-      str.Inputs[i] = 0;
-      vtkInformationVector* portInfo = inputVector[i];
-      
-      if (portInfo->GetNumberOfInformationObjects())
-        {
-        int j;
-        str.Inputs[i] = 
-          new vtkImageData *[portInfo->GetNumberOfInformationObjects()];
-        for (j = 0; j < portInfo->GetNumberOfInformationObjects(); ++j)
-          {
-          vtkInformation* info = portInfo->GetInformationObject(j);
-          str.Inputs[i][j] =
-            static_cast<vtkImageData*>(info->Get(vtkDataObject::DATA_OBJECT()));
-          }
-        }
-      }
-    }
+  vtkThreadedImageAlgorithmSetInputs(this, inputVector, &str);
   
   // copy other arrays
   if (str.Inputs && str.Inputs[0] && str.Outputs)
@@ -291,25 +329,51 @@ int vtkThreadedImageAlgorithm::RequestData(
   this->Threader->SingleMethodExecute();
   this->Debug = debug;
 
-  // free up the arrays
-  for (i = 0; i < this->GetNumberOfInputPorts(); ++i)
+  vtkThreadedImageAlgorithmFreeArrays(this, &str);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkThreadedImageAlgorithm::SplitInputAndExecute(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  vtkImageThreadStruct str;
+  str.Filter = this;
+  str.Request = request;
+  str.InputsInfo = inputVector;
+  str.OutputsInfo = outputVector;
+  str.SplitInput = 1;
+
+  // the outputs are passed along, but not allocated
+  str.Outputs = 0;
+  if (this->GetNumberOfOutputPorts())
     {
-    if (str.Inputs[i])
+    str.Outputs = new vtkImageData * [this->GetNumberOfOutputPorts()];
+    for (int i = 0; i < this->GetNumberOfOutputPorts(); ++i)
       {
-      delete [] str.Inputs[i];
+      vtkInformation* info = outputVector->GetInformationObject(i);
+      str.Outputs[i] = static_cast<vtkImageData *>(
+        info->Get(vtkDataObject::DATA_OBJECT()));
       }
     }
-  // note the check isn't required by C++ standard but due to bad compilers
-  if (str.Inputs)
-    {
-    delete [] str.Inputs;
-    }
-  if (str.Outputs)
-    {
-    delete [] str.Outputs;  
-    }
 
-  return 1;
+  vtkThreadedImageAlgorithmSetInputs(this, inputVector, &str);
+
+  this->Threader->SetNumberOfThreads(this->NumberOfThreads);
+  this->Threader->SetSingleMethod(vtkThreadedImageAlgorithmThreadedExecute, &str);  
+
+  // always shut off debugging to avoid threading problems with GetMacros
+  int debug = this->Debug;
+  this->Debug = 0;
+  this->Threader->SingleMethodExecute();
+  this->Debug = debug;
+
+  vtkThreadedImageAlgorithmFreeArrays(this, &str);
+
+  return this->Threader->GetNumberOfThreads();
 }
 
 //----------------------------------------------------------------------------
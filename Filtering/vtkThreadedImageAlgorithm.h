@@ -77,6 +77,20 @@ protected:
                           vtkInformationVector** inputVector,
                           vtkInformationVector* outputVector);
 
+  // Description:
+  // Call ThreadedRequestData() on pieces of the update extent of the
+  // first input, rather than of the output, without allocating the
+  // output.  This is meant for filters that reduce their input to a
+  // result whose size does not depend on the input extent, such as a
+  // histogram or statistics: each thread accumulates into a partial
+  // result kept for its threadId, and the filter combines the partial
+  // results once this method returns.  Returns the number of threads
+  // that were used, i.e. an upper bound on the number of partial
+  // results.
+  int SplitInputAndExecute(vtkInformation* request,
+                           vtkInformationVector** inputVector,
+                           vtkInformationVector* outputVector);
+
 private:
   vtkThreadedImageAlgorithm(const vtkThreadedImageAlgorithm&);  // Not implemented.
   void operator=(const vtkThreadedImageAlgorithm&);  // Not implemented.
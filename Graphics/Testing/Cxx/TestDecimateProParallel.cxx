@@ -0,0 +1,184 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDecimateProParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Decimates a bumpy plane with and without ParallelDecimation and checks
+// that both reach the target reduction with a valid mesh and a similar
+// error, that the progress never decreases and reaches 1, and that an abort
+// requested from a progress observer stops the parallel decimation.
+
+#include "vtkCellArray.h"
+#include "vtkCommand.h"
+#include "vtkDecimatePro.h"
+#include "vtkPlaneSource.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkTriangleFilter.h"
+
+#include <math.h>
+
+class vtkDecimateProParallelProgress : public vtkCommand
+{
+public:
+  static vtkDecimateProParallelProgress *New()
+    { return new vtkDecimateProParallelProgress; }
+  virtual void Execute(vtkObject *caller, unsigned long, void *callData)
+    {
+    double progress = *static_cast<double *>(callData);
+    if (progress < this->Progress)
+      {
+      this->Decreased = 1;
+      }
+    this->Progress = progress;
+    if (progress >= this->AbortProgress)
+      {
+      static_cast<vtkAlgorithm *>(caller)->SetAbortExecute(1);
+      }
+    }
+  double Progress;
+  double AbortProgress;
+  int Decreased;
+protected:
+  vtkDecimateProParallelProgress()
+    {
+    this->Progress = 0.0;
+    this->AbortProgress = 2.0;
+    this->Decreased = 0;
+    }
+};
+
+static double Height(double x, double y)
+{
+  return 0.1*sin(6.0*x)*cos(5.0*y) + 0.3*exp(-40.0*(x*x + y*y));
+}
+
+// Returns the largest distance of a triangle centroid to the surface, or
+// -1 if the mesh refers to missing points.
+static double MaximumError(vtkPolyData *mesh)
+{
+  vtkCellArray *polys = mesh->GetPolys();
+  vtkIdType npts, *pts;
+  double maxError = 0.0;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); )
+    {
+    double c[3] = {0.0, 0.0, 0.0};
+    for (int j = 0; j < npts; j++)
+      {
+      if (pts[j] < 0 || pts[j] >= mesh->GetNumberOfPoints())
+        {
+        return -1.0;
+        }
+      double *x = mesh->GetPoint(pts[j]);
+      c[0] += x[0] / 3.0; c[1] += x[1] / 3.0; c[2] += x[2] / 3.0;
+      }
+    double error = fabs(c[2] - Height(c[0], c[1]));
+    maxError = (error > maxError ? error : maxError);
+    }
+  return maxError;
+}
+
+int TestDecimateProParallel(int, char *[])
+{
+  vtkPlaneSource *plane = vtkPlaneSource::New();
+  plane->SetOrigin(-1.0, -1.0, 0.0);
+  plane->SetPoint1(1.0, -1.0, 0.0);
+  plane->SetPoint2(-1.0, 1.0, 0.0);
+  plane->SetResolution(300, 300);
+  vtkTriangleFilter *triangles = vtkTriangleFilter::New();
+  triangles->SetInputConnection(plane->GetOutputPort());
+  triangles->Update();
+
+  vtkPolyData *input = vtkPolyData::New();
+  input->DeepCopy(triangles->GetOutput());
+  vtkPoints *points = input->GetPoints();
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); i++)
+    {
+    double x[3];
+    points->GetPoint(i, x);
+    x[2] = Height(x[0], x[1]);
+    points->SetPoint(i, x);
+    }
+  triangles->Delete();
+  plane->Delete();
+
+  vtkIdType numTris = input->GetNumberOfPolys();
+  double error[2];
+  int status = 0;
+  for (int parallel = 0; parallel < 2; parallel++)
+    {
+    vtkDecimateProParallelProgress *progress =
+      vtkDecimateProParallelProgress::New();
+    vtkDecimatePro *decimate = vtkDecimatePro::New();
+    decimate->SetInput(input);
+    decimate->SetTargetReduction(0.9);
+    decimate->SetParallelDecimation(parallel);
+    decimate->SetNumberOfThreads(4);
+    decimate->AddObserver(vtkCommand::ProgressEvent, progress);
+    decimate->Update();
+    if (progress->Decreased || progress->Progress != 1.0)
+      {
+      cerr << "The progress decreased or stopped at " << progress->Progress
+           << endl;
+      status = 1;
+      }
+
+    vtkPolyData *output = decimate->GetOutput();
+    vtkIdType outTris = output->GetNumberOfPolys();
+    error[parallel] = MaximumError(output);
+    cout << (parallel ? "Parallel" : "Serial") << ": " << outTris
+         << " triangles, maximum error " << error[parallel] << endl;
+    if (outTris > numTris / 10 + 1 || outTris < numTris / 20)
+      {
+      cerr << "Target reduction not met" << endl;
+      status = 1;
+      }
+    if (error[parallel] < 0.0)
+      {
+      cerr << "Invalid point ids in the output" << endl;
+      status = 1;
+      }
+    decimate->Delete();
+    progress->Delete();
+    }
+
+  // abort while the regions are decimated; the other threads finish their
+  // region, but the serial pass is skipped
+  vtkDecimateProParallelProgress *progress =
+    vtkDecimateProParallelProgress::New();
+  progress->AbortProgress = 0.1;
+  vtkDecimatePro *decimate = vtkDecimatePro::New();
+  decimate->SetInput(input);
+  decimate->SetTargetReduction(0.9);
+  decimate->ParallelDecimationOn();
+  decimate->SetNumberOfThreads(4);
+  decimate->AddObserver(vtkCommand::ProgressEvent, progress);
+  decimate->Update();
+  if (progress->Progress >= 0.5 || progress->Decreased ||
+      decimate->GetOutput()->GetNumberOfPolys() <= 2 * (numTris / 10))
+    {
+    cerr << "The parallel decimation was not aborted: progress "
+         << progress->Progress << ", "
+         << decimate->GetOutput()->GetNumberOfPolys() << " triangles" << endl;
+    status = 1;
+    }
+  decimate->Delete();
+  progress->Delete();
+  input->Delete();
+
+  if (error[1] > 2.0 * error[0])
+    {
+    cerr << "Parallel decimation error is too large" << endl;
+    status = 1;
+    }
+  return status;
+}
@@ -0,0 +1,175 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricDecimationThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Decimates a sphere carrying point scalars and normals with the
+// AttributeErrorMetric, with one and four threads, with and without
+// BatchedCollapse. The output points, triangles and attributes must not
+// depend on the number of threads, and the batched collapse must reach the
+// target with a similar geometric and scalar error.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricDecimation.h"
+#include "vtkSphereSource.h"
+
+#include <math.h>
+
+static double Scalar(double *x)
+{
+  return x[0]*x[1] + 0.5*x[2];
+}
+
+// Returns the largest distance of a point to the unit sphere in error[0]
+// and the largest difference of its scalar to Scalar() in error[1].
+static void MaximumError(vtkPolyData *mesh, double error[2])
+{
+  vtkDataArray *scalars = mesh->GetPointData()->GetScalars();
+  error[0] = error[1] = 0.0;
+  for (vtkIdType i = 0; i < mesh->GetNumberOfPoints(); i++)
+    {
+    double *x = mesh->GetPoint(i);
+    double e = fabs(sqrt(x[0]*x[0] + x[1]*x[1] + x[2]*x[2]) - 1.0);
+    error[0] = (e > error[0] ? e : error[0]);
+    e = (scalars ? fabs(scalars->GetComponent(i, 0) - Scalar(x)) : 1.0);
+    error[1] = (e > error[1] ? e : error[1]);
+    }
+}
+
+static int SameArray(vtkDataArray *a, vtkDataArray *b)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    return 0;
+    }
+  int numComp = a->GetNumberOfComponents();
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); i++)
+    {
+    for (int j = 0; j < numComp; j++)
+      {
+      if (a->GetComponent(i, j) != b->GetComponent(i, j))
+        {
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+static int SameMesh(vtkPolyData *a, vtkPolyData *b)
+{
+  if (!SameArray(a->GetPoints()->GetData(), b->GetPoints()->GetData()) ||
+      !SameArray(a->GetPointData()->GetScalars(),
+                 b->GetPointData()->GetScalars()) ||
+      !SameArray(a->GetPointData()->GetNormals(),
+                 b->GetPointData()->GetNormals()) ||
+      a->GetPolys()->GetNumberOfConnectivityEntries() !=
+      b->GetPolys()->GetNumberOfConnectivityEntries())
+    {
+    return 0;
+    }
+  vtkIdType *ca = a->GetPolys()->GetPointer();
+  vtkIdType *cb = b->GetPolys()->GetPointer();
+  for (vtkIdType i = 0; i < a->GetPolys()->GetNumberOfConnectivityEntries();
+       i++)
+    {
+    if (ca[i] != cb[i])
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+int TestQuadricDecimationThreads(int, char *[])
+{
+  vtkSphereSource *sphere = vtkSphereSource::New();
+  sphere->SetRadius(1.0);
+  sphere->SetThetaResolution(200);
+  sphere->SetPhiResolution(200);
+  sphere->Update();
+
+  vtkPolyData *input = vtkPolyData::New();
+  input->ShallowCopy(sphere->GetOutput());
+  sphere->Delete();
+  vtkDoubleArray *scalars = vtkDoubleArray::New();
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(input->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); i++)
+    {
+    scalars->SetValue(i, Scalar(input->GetPoint(i)));
+    }
+  input->GetPointData()->SetScalars(scalars);
+  scalars->Delete();
+
+  vtkIdType numTris = input->GetNumberOfPolys();
+  vtkPolyData *outputs[4];
+  double error[2][2];
+  int status = 0;
+  int batched, threads;
+  for (batched = 0; batched < 2; batched++)
+    {
+    for (threads = 0; threads < 2; threads++)
+      {
+      vtkQuadricDecimation *decimate = vtkQuadricDecimation::New();
+      decimate->SetInput(input);
+      decimate->SetTargetReduction(0.9);
+      decimate->AttributeErrorMetricOn();
+      decimate->SetBatchedCollapse(batched);
+      decimate->SetNumberOfThreads(threads ? 4 : 1);
+      decimate->Update();
+
+      vtkPolyData *output = vtkPolyData::New();
+      output->ShallowCopy(decimate->GetOutput());
+      outputs[2*batched + threads] = output;
+      decimate->Delete();
+      }
+
+    vtkIdType outTris = outputs[2*batched]->GetNumberOfPolys();
+    MaximumError(outputs[2*batched], error[batched]);
+    cout << (batched ? "Batched" : "Serial") << ": " << outTris
+         << " triangles, maximum error " << error[batched][0]
+         << ", maximum scalar error " << error[batched][1] << endl;
+    if (outTris > numTris / 10 + 1 || outTris < numTris / 20)
+      {
+      cerr << "Target reduction not met" << endl;
+      status = 1;
+      }
+    if (!SameMesh(outputs[2*batched], outputs[2*batched + 1]))
+      {
+      cerr << "Output depends on the number of threads" << endl;
+      status = 1;
+      }
+    }
+  input->Delete();
+  for (int i = 0; i < 4; i++)
+    {
+    outputs[i]->Delete();
+    }
+
+  if (error[0][1] > 0.01)
+    {
+    cerr << "Scalar error is too large" << endl;
+    status = 1;
+    }
+  if (error[1][0] > 2.0 * error[0][0] || error[1][1] > 2.0 * error[0][1])
+    {
+    cerr << "Batched collapse error is too large" << endl;
+    status = 1;
+    }
+  return status;
+}
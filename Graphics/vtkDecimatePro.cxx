@@ -14,11 +14,14 @@
 =========================================================================*/
 #include "vtkDecimatePro.h"
 
+#include "vtkCallbackCommand.h"
 #include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkLine.h"
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPolyData.h"
@@ -28,6 +31,9 @@
 #include "vtkPointData.h"
 #include "vtkCellData.h"
 
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
 vtkStandardNewMacro(vtkDecimatePro);
 
 #define VTK_TOLERANCE 1.0e-05
@@ -48,6 +54,11 @@ vtkStandardNewMacro(vtkDecimatePro);
 #define VTK_STATE_SPLIT 1
 #define VTK_STATE_SPLIT_ALL 2
 
+// Parallel decimation gives every region at least this many triangles, and
+// lets the regions perform this fraction of the reduction.
+#define VTK_MIN_TRIS_PER_REGION 20000
+#define VTK_REGION_REDUCTION_FRACTION 0.9
+
 // Helper functions
 static double ComputeSimpleError(double x[3], double normal[3], double point[3]);
 static double ComputeEdgeError(double x[3], double x1[3], double x2[3]);
@@ -84,11 +95,14 @@ vtkDecimatePro::vtkDecimatePro()
   this->Degree = 25;
   this->BoundaryVertexDeletion = 1;
   this->InflectionPointRatio = 10.0;
+  this->ParallelDecimation = 0;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
 
   this->Queue = NULL;
   this->VertexError = NULL;
 
   this->Mesh = NULL;
+  this->NumberOfFrozenPoints = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -103,6 +117,10 @@ vtkDecimatePro::~vtkDecimatePro()
     {
     this->VertexError->Delete();
     }
+  if ( this->Mesh )
+    {
+    this->Mesh->Delete();
+    }
   this->Neighbors->Delete();
   this->EdgeLengths->Delete();
   delete this->V;
@@ -128,18 +146,17 @@ int vtkDecimatePro::RequestData(
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType i, ptId, numPts, numTris, collapseId;
+  vtkIdType i, ptId, numPts, numTris, meshTris;
   vtkPoints *inPts;
   vtkPoints *newPts;
   vtkCellArray *inPolys;
   vtkCellArray *newPolys;
-  double error, previousError=0.0, reduction;
-  int type;
-  vtkIdType *pts, npts, totalEliminated, numRecycles, numPops;
+  double reduction;
+  int numRegions;
+  vtkIdType *pts, npts;
   unsigned short int ncells;
-  vtkIdType pt1, pt2, cellId, fedges[2];
+  vtkIdType cellId;
   vtkIdType *cells;
-  vtkIdList *CollapseTris;
   double max, *bounds;
   if (!input)
     {
@@ -151,7 +168,6 @@ int vtkDecimatePro::RequestData(
   vtkPointData *meshPD=0;
   vtkIdType *map, numNewPts, totalPts;
   vtkIdType newCellPts[3];
-  int abortExecute=0;
 
   vtkDebugMacro(<<"Executing progressive decimation...");
 
@@ -204,15 +220,45 @@ int vtkDecimatePro::RequestData(
     pPolys += 4;
     }
 
-  // Build cell data structure. Need to copy triangle connectivity data
-  // so we can modify it.
-  if ( this->TargetReduction > 0.0 )
+  if ( this->TargetReduction <= 0.0 )
     {
+    output->CopyStructure(input);
+    output->GetPointData()->PassData(input->GetPointData());
+    output->GetCellData()->PassData(input->GetCellData());
+    //vtkWarningMacro(<<"Reduction == 0: passing data through unchanged");
+    return 1;
+    }
+
+  // this static should be eliminated
+  if (this->Mesh != NULL) {this->Mesh->Delete(); this->Mesh = NULL;}
+  if (this->VertexError != NULL)
+    {
+    this->VertexError->Delete();
+    this->VertexError = NULL;
+    }
+
+  // Parallel decimation leaves the last part of the reduction, along
+  // with the region seams, to the serial pass below.
+  numRegions = 1;
+  if ( this->ParallelDecimation )
+    {
+    numRegions = static_cast<int>(numTris / VTK_MIN_TRIS_PER_REGION);
+    numRegions = (numRegions < this->NumberOfThreads ?
+                  numRegions : this->NumberOfThreads);
+    }
+  if ( numRegions > 1 )
+    {
+    this->DecimateRegions(input, numRegions);
+    meshTris = this->Mesh->GetNumberOfCells();
+    reduction = 1.0 - (1.0 - this->TargetReduction)*numTris/meshTris;
+    }
+  else
+    {
+    // Build cell data structure. Need to copy triangle connectivity data
+    // so we can modify it.
     inPts = input->GetPoints();
     inPolys = input->GetPolys();
 
-    // this static should be eliminated
-    if (this->Mesh != NULL) {this->Mesh->Delete(); this->Mesh = NULL;}
     this->Mesh = vtkPolyData::New();
     
     newPts = vtkPoints::New(); newPts->SetNumberOfPoints(numPts);
@@ -230,26 +276,116 @@ int vtkDecimatePro::RequestData(
     meshPD->CopyAllocate(meshPD, input->GetNumberOfPoints());
     
     this->Mesh->BuildLinks();
+    meshTris = numTris;
+    reduction = this->TargetReduction;
     }
-  else
+  newPts = this->Mesh->GetPoints();
+  meshPD = this->Mesh->GetPointData();
+  this->NumberOfRemainingTris = meshTris;
+  if ( reduction > 0.0 && !this->GetAbortExecute() )
     {
-    output->CopyStructure(input);
-    output->GetPointData()->PassData(input->GetPointData());
-    output->GetCellData()->PassData(input->GetCellData());
-    //vtkWarningMacro(<<"Reduction == 0: passing data through unchanged");
-    return 1;
+    this->DecimateMesh(meshTris, reduction, (numRegions > 1 ? 0.5 : 0.0));
+    }
+  totalPts = this->Mesh->GetNumberOfPoints();
+
+  //
+  // Create output and release memory
+  //
+  vtkDebugMacro (<<"Creating output...");
+
+  // Grab the points that are left; copy point data. Remember that splitting 
+  // data may have added new points.
+  map = new vtkIdType[totalPts];
+  for (i=0; i < totalPts; i++)
+    {
+    map[i] = -1;
+    }
+  numNewPts = 0;
+  for (ptId=0; ptId < totalPts; ptId++)
+    {
+    this->Mesh->GetPointCells(ptId,ncells,cells);
+    if ( ncells > 0 )
+      {
+      map[ptId] = numNewPts++;
+      }
     }
   
-  // Initialize data structures: priority queue and errors.
+  outputPD->CopyAllocate(meshPD,numNewPts);
+
+  // Copy points in place
+  for (ptId=0; ptId < totalPts; ptId++)
+    {
+    if ( map[ptId] > -1 )
+      {
+      newPts->SetPoint(map[ptId],newPts->GetPoint(ptId));
+      outputPD->CopyData(meshPD,ptId,map[ptId]);
+      }
+    }
+
+  newPts->SetNumberOfPoints(numNewPts);
+  newPts->Squeeze();
+
+  // Now renumber connectivity
+  newPolys = vtkCellArray::New();
+  newPolys->Allocate(newPolys->EstimateSize(3,this->NumberOfRemainingTris));
+
+  for (cellId=0; cellId < meshTris; cellId++)
+    {
+    if ( this->Mesh->GetCellType(cellId) == VTK_TRIANGLE ) // non-null element
+      {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      for (i=0; i < 3; i++)
+        {
+        newCellPts[i] = map[pts[i]];
+        }
+      newPolys->InsertNextCell(npts,newCellPts);
+      }
+    }
+
+  delete [] map;
+  output->SetPoints(newPts);
+  output->SetPolys(newPolys);
+  if (this->Mesh != NULL) {this->Mesh->Delete(); this->Mesh = NULL;}
+  newPolys->Delete();
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Decimate this->Mesh, which holds numTris triangles, until targetReduction
+// of them have been eliminated or no vertex can be deleted anymore. Returns
+// the number of triangles eliminated. Progress is reported from
+// progressStart to 1.
+//
+vtkIdType vtkDecimatePro::DecimateMesh(vtkIdType numTris,
+                                       double targetReduction,
+                                       double progressStart)
+{
+  vtkIdType ptId, npts, numPts, totalPts, collapseId;
+  double error, previousError=0.0, reduction;
+  int type;
+  vtkIdType totalEliminated, numRecycles, numPops;
+  unsigned short int ncells;
+  vtkIdType pt1, pt2, fedges[2];
+  vtkIdType *cells;
+  vtkIdList *CollapseTris;
+  int abortExecute=0;
+
+  numPts = this->Mesh->GetNumberOfPoints();
+  this->NumberOfRemainingTris = numTris;
+  this->SplitState = VTK_STATE_UNSPLIT;
+
+  // Initialize data structures: priority queue and errors. The errors may
+  // have been carried over from the decimation of the regions.
   this->InitializeQueue(numPts);
   
-  if ( this->AccumulateError )
+  if ( this->AccumulateError && this->VertexError == NULL )
     {
     this->VertexError = vtkDoubleArray::New();
     this->VertexError->Allocate(numPts,static_cast<vtkIdType>(0.25*numPts));
-    for (i=0; i<numPts; i++)
+    for (ptId=0; ptId<numPts; ptId++)
       {
-      this->VertexError->SetValue(i, 0.0);
+      this->VertexError->SetValue(ptId, 0.0);
       }
     }
   
@@ -274,12 +410,14 @@ int vtkDecimatePro::RequestData(
     if ( ! (ptId % 10000) ) 
       {
       vtkDebugMacro(<<"Inserting vertex #" << ptId);
-      this->UpdateProgress (0.25*ptId/npts);//25% spent inserting
+      //25% spent inserting
+      this->UpdateProgress (progressStart +
+                            (1.0-progressStart)*0.25*ptId/npts);
       abortExecute = this->GetAbortExecute();
       }
     this->Insert(ptId);
     }
-  this->UpdateProgress (0.25);//25% spent inserting
+  this->UpdateProgress (progressStart + (1.0-progressStart)*0.25);
   
   CollapseTris = vtkIdList::New();
   CollapseTris->Allocate(100,100);
@@ -291,13 +429,14 @@ int vtkDecimatePro::RequestData(
   // (While this is happening we keep track of operations on the data - 
   // this forms the core of the progressive mesh representation.)
   for ( totalEliminated=0, reduction=0.0, numRecycles=0, numPops=0;
-        reduction < this->TargetReduction && (ptId = this->Pop(error)) >= 0 && !abortExecute; 
+        reduction < targetReduction && (ptId = this->Pop(error)) >= 0 && !abortExecute; 
         numPops++)
     {
     if ( numPops && !(numPops % 5000) )
       {
       vtkDebugMacro(<<"Deleting vertex #" << numPops);
-      this->UpdateProgress (0.25 + 0.75*(reduction/this->TargetReduction));
+      this->UpdateProgress (progressStart + (1.0-progressStart)*
+                            (0.25 + 0.75*(reduction/targetReduction)));
       abortExecute = this->GetAbortExecute();
       }
     
@@ -345,6 +484,7 @@ int vtkDecimatePro::RequestData(
     }//while queue not empty and reduction not satisfied
   
   CollapseTris->Delete();
+  this->DeleteQueue();
   
   totalPts = this->Mesh->GetNumberOfPoints();
   vtkDebugMacro(<<"\n\tReduction " << reduction << " (" << numTris << " to " 
@@ -359,68 +499,391 @@ int vtkDecimatePro::RequestData(
                 <<"\n\tAdded " << totalPts - numPts << " points (" 
                 << numPts << " to " << totalPts << " points)");
 
-  //
-  // Create output and release memory
-  //
-  vtkDebugMacro (<<"Creating output...");
-  this->DeleteQueue();
+  return totalEliminated;
+}
 
-  // Grab the points that are left; copy point data. Remember that splitting 
-  // data may have added new points.
-  map = new vtkIdType[totalPts];
-  for (i=0; i < totalPts; i++)
+//----------------------------------------------------------------------------
+// Helpers for the parallel decimation. The triangles are sorted into
+// regions by recursively splitting their centroids at the median of the
+// longest axis. Every region then keeps a contiguous range of the order
+// array.
+//
+class vtkDecimateProCenterLess
+{
+public:
+  vtkDecimateProCenterLess(const double *centers, int axis)
+    : Centers(centers), Axis(axis) {}
+  bool operator()(vtkIdType a, vtkIdType b) const
     {
-    map[i] = -1;
+    return this->Centers[3*a+this->Axis] < this->Centers[3*b+this->Axis];
     }
-  numNewPts = 0;
-  for (ptId=0; ptId < totalPts; ptId++)
+  const double *Centers;
+  int Axis;
+};
+
+static void vtkDecimateProSplitRegions(const double *centers,
+                                       vtkIdType *begin, vtkIdType *end,
+                                       int numRegions, vtkIdType *offsets)
+{
+  if ( numRegions == 1 )
     {
-    this->Mesh->GetPointCells(ptId,ncells,cells);
-    if ( ncells > 0 )
+    offsets[1] = offsets[0] + (end - begin);
+    return;
+    }
+
+  double bounds[6];
+  int i, axis;
+  vtkIdType *tri;
+  for (i=0; i < 3; i++)
+    {
+    bounds[2*i] = VTK_DOUBLE_MAX;
+    bounds[2*i+1] = -VTK_DOUBLE_MAX;
+    }
+  for (tri=begin; tri != end; ++tri)
+    {
+    for (i=0; i < 3; i++)
       {
-      map[ptId] = numNewPts++;
+      double c = centers[3*(*tri)+i];
+      bounds[2*i] = (c < bounds[2*i] ? c : bounds[2*i]);
+      bounds[2*i+1] = (c > bounds[2*i+1] ? c : bounds[2*i+1]);
+      }
+    }
+  for (axis=0, i=1; i < 3; i++)
+    {
+    if ( bounds[2*i+1]-bounds[2*i] > bounds[2*axis+1]-bounds[2*axis] )
+      {
+      axis = i;
       }
     }
-  
-  outputPD->CopyAllocate(meshPD,numNewPts);
 
-  // Copy points in place
-  for (ptId=0; ptId < totalPts; ptId++)
+  int numLeft = numRegions / 2;
+  vtkIdType *middle = begin + (end - begin)*numLeft/numRegions;
+  vtkstd::nth_element(begin, middle, end,
+                      vtkDecimateProCenterLess(centers, axis));
+  vtkDecimateProSplitRegions(centers, begin, middle, numLeft, offsets);
+  vtkDecimateProSplitRegions(centers, middle, end, numRegions - numLeft,
+                             offsets + numLeft);
+}
+
+struct vtkDecimateProRegions
+{
+  vtkDecimatePro *Self;
+  vtkDecimatePro **Regions;
+  vtkIdType *NumberOfTriangles;
+  int NumberOfRegions;
+  double Reduction;
+  vtkCallbackCommand *ProgressCallback;
+  int NumberOfRegionsDone; // by the first thread
+  int NumberOfRegionsToDo; // by the first thread
+};
+
+//----------------------------------------------------------------------------
+// Progress observer of the regions decimated by the first thread. Reports
+// the progress of the first thread as the first half of the progress of
+// the filter, and passes an abort request on to the region.
+//
+static void vtkDecimateProRegionProgress(vtkObject *caller, unsigned long,
+                                         void *clientdata, void *calldata)
+{
+  vtkDecimateProRegions *regions =
+    static_cast<vtkDecimateProRegions *>(clientdata);
+  double progress = *static_cast<double *>(calldata);
+  regions->Self->UpdateProgress(0.5*(regions->NumberOfRegionsDone + progress)/
+                                regions->NumberOfRegionsToDo);
+  if ( regions->Self->GetAbortExecute() )
     {
-    if ( map[ptId] > -1 )
+    static_cast<vtkDecimatePro *>(caller)->SetAbortExecute(1);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Decimate the regions assigned to one thread. Every region is an
+// independent vtkDecimatePro, so they share no state. Only the first thread
+// reports progress; every thread stops taking regions when the filter is
+// aborted.
+//
+VTK_THREAD_RETURN_TYPE vtkDecimatePro::DecimateRegionsThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkDecimateProRegions *regions =
+    static_cast<vtkDecimateProRegions *>(info->UserData);
+
+  if ( info->ThreadID == 0 )
+    {
+    regions->NumberOfRegionsDone = 0;
+    regions->NumberOfRegionsToDo = (regions->NumberOfRegions +
+      info->NumberOfThreads - 1) / info->NumberOfThreads;
+    }
+  for (int r=info->ThreadID; r < regions->NumberOfRegions &&
+         !regions->Self->GetAbortExecute(); r += info->NumberOfThreads)
+    {
+    vtkDecimatePro *region = regions->Regions[r];
+    if ( info->ThreadID == 0 )
       {
-      newPts->SetPoint(map[ptId],newPts->GetPoint(ptId));
-      outputPD->CopyData(meshPD,ptId,map[ptId]);
+      region->AddObserver(vtkCommand::ProgressEvent,
+                          regions->ProgressCallback);
+      }
+    region->Mesh->BuildLinks();
+    region->DecimateMesh(regions->NumberOfTriangles[r], regions->Reduction,
+                         0.0);
+    if ( info->ThreadID == 0 )
+      {
+      regions->NumberOfRegionsDone++;
       }
     }
 
-  newPts->SetNumberOfPoints(numNewPts);
-  newPts->Squeeze();
+  return VTK_THREAD_RETURN_VALUE;
+}
 
-  // Now renumber connectivity
-  newPolys = vtkCellArray::New();
-  newPolys->Allocate(newPolys->EstimateSize(3,numTris-totalEliminated));
+//----------------------------------------------------------------------------
+// Split the input into numRegions regions, decimate them concurrently and
+// stitch the results into this->Mesh. The vertices used by more than one
+// region are numbered first in every region and frozen, so the regions
+// still fit together afterwards. Every region carries the input ids of its
+// points in its point data; this follows the points created by splitting.
+//
+void vtkDecimatePro::DecimateRegions(vtkPolyData *input, int numRegions)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numTris = input->GetNumberOfPolys();
+  vtkIdType *polys = input->GetPolys()->GetPointer();
+  vtkPoints *inPts = input->GetPoints();
+  vtkIdType i, ptId, triId, *tri;
+  int r, j;
+  double x[3];
+
+  vtkDebugMacro(<<"Decimating " << numRegions << " regions in parallel");
+
+  // Sort the triangles into regions.
+  vtkstd::vector<double> centers(3*numTris);
+  vtkstd::vector<vtkIdType> order(numTris);
+  for (triId=0; triId < numTris; triId++)
+    {
+    double *c = &centers[3*triId];
+    c[0] = c[1] = c[2] = 0.0;
+    for (j=0; j < 3; j++)
+      {
+      inPts->GetPoint(polys[4*triId+1+j], x);
+      c[0] += x[0]; c[1] += x[1]; c[2] += x[2];
+      }
+    order[triId] = triId;
+    }
+  vtkstd::vector<vtkIdType> offsets(numRegions+1);
+  offsets[0] = 0;
+  vtkDecimateProSplitRegions(&centers[0], &order[0], &order[0] + numTris,
+                             numRegions, &offsets[0]);
+  vtkstd::vector<double>().swap(centers);
+
+  // Find the points shared by several regions.
+  const int seam = -2;
+  vtkstd::vector<int> pointRegion(numPts, -1);
+  for (r=0; r < numRegions; r++)
+    {
+    for (i=offsets[r]; i < offsets[r+1]; i++)
+      {
+      tri = polys + 4*order[i] + 1;
+      for (j=0; j < 3; j++)
+        {
+        int &owner = pointRegion[tri[j]];
+        owner = (owner == -1 || owner == r ? r : seam);
+        }
+      }
+    }
 
-  for (cellId=0; cellId < numTris; cellId++)
+  // Build one decimator per region. The seam points come first.
+  vtkstd::vector<vtkDecimatePro *> regions(numRegions);
+  vtkstd::vector<vtkIdType> numRegionTris(numRegions);
+  vtkstd::vector<vtkIdType> numRegionPts(numRegions);
+  vtkstd::vector<int> stamp(numPts, -1);
+  vtkstd::vector<vtkIdType> localId(numPts);
+  for (r=0; r < numRegions; r++)
     {
-    if ( this->Mesh->GetCellType(cellId) == VTK_TRIANGLE ) // non-null element
+    vtkIdType numLocal = 0, numFrozen = 0;
+    int pass;
+    vtkIdTypeArray *ids = vtkIdTypeArray::New();
+    for (pass=0; pass < 2; pass++)
       {
-      this->Mesh->GetCellPoints(cellId, npts, pts);
-      for (i=0; i < 3; i++)
+      for (i=offsets[r]; i < offsets[r+1]; i++)
         {
-        newCellPts[i] = map[pts[i]];
+        tri = polys + 4*order[i] + 1;
+        for (j=0; j < 3; j++)
+          {
+          ptId = tri[j];
+          if ( stamp[ptId] != r && (pointRegion[ptId] == seam) == (pass == 0) )
+            {
+            stamp[ptId] = r;
+            localId[ptId] = numLocal++;
+            ids->InsertNextValue(ptId);
+            }
+          }
+        }
+      if ( pass == 0 )
+        {
+        numFrozen = numLocal;
+        }
+      }
+
+    vtkPoints *pts = vtkPoints::New();
+    pts->SetDataType(inPts->GetDataType());
+    pts->SetNumberOfPoints(numLocal);
+    for (i=0; i < numLocal; i++)
+      {
+      pts->SetPoint(i, inPts->GetPoint(ids->GetValue(i)));
+      }
+    vtkCellArray *cells = vtkCellArray::New();
+    cells->Allocate(cells->EstimateSize(offsets[r+1]-offsets[r], 3));
+    for (i=offsets[r]; i < offsets[r+1]; i++)
+      {
+      tri = polys + 4*order[i] + 1;
+      cells->InsertNextCell(3);
+      for (j=0; j < 3; j++)
+        {
+        cells->InsertCellPoint(localId[tri[j]]);
         }
-      newPolys->InsertNextCell(npts,newCellPts);
       }
+
+    vtkDecimatePro *region = vtkDecimatePro::New();
+    region->Mesh = vtkPolyData::New();
+    region->Mesh->SetPoints(pts);
+    region->Mesh->SetPolys(cells);
+    region->Mesh->GetPointData()->AddArray(ids);
+    region->Mesh->GetPointData()->CopyAllocate(region->Mesh->GetPointData(),
+                                               numLocal);
+    pts->Delete();
+    cells->Delete();
+    ids->Delete();
+
+    region->FeatureAngle = this->FeatureAngle;
+    region->SplitAngle = this->SplitAngle;
+    region->PreSplitMesh = this->PreSplitMesh;
+    region->AccumulateError = this->AccumulateError;
+    region->BoundaryVertexDeletion = this->BoundaryVertexDeletion;
+    region->InflectionPointRatio = this->InflectionPointRatio;
+    region->Error = this->Error;
+    region->Tolerance = this->Tolerance;
+    region->CosAngle = this->CosAngle;
+    region->Split = this->Split;
+    region->VertexDegree = this->VertexDegree;
+    region->TheSplitAngle = this->TheSplitAngle;
+    region->NumberOfFrozenPoints = numFrozen;
+
+    regions[r] = region;
+    numRegionTris[r] = offsets[r+1] - offsets[r];
+    numRegionPts[r] = numLocal;
+    }
+  vtkstd::vector<vtkIdType>().swap(order);
+  vtkstd::vector<int>().swap(stamp);
+  vtkstd::vector<vtkIdType>().swap(localId);
+
+  // The regions stop short of the target so that the last part of the
+  // reduction is chosen from the whole mesh.
+  vtkDecimateProRegions info;
+  info.Self = this;
+  info.Regions = &regions[0];
+  info.NumberOfTriangles = &numRegionTris[0];
+  info.NumberOfRegions = numRegions;
+  info.Reduction = VTK_REGION_REDUCTION_FRACTION * this->TargetReduction;
+  info.ProgressCallback = vtkCallbackCommand::New();
+  info.ProgressCallback->SetCallback(vtkDecimateProRegionProgress);
+  info.ProgressCallback->SetClientData(&info);
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numRegions);
+  threader->SetSingleMethod(vtkDecimatePro::DecimateRegionsThread, &info);
+  threader->SingleMethodExecute();
+  threader->Delete();
+  info.ProgressCallback->Delete();
+  if ( !this->GetAbortExecute() )
+    {
+    this->UpdateProgress(0.5);
     }
 
-  delete [] map;
-  output->SetPoints(newPts);
-  output->SetPolys(newPolys);
-  if (this->Mesh != NULL) {this->Mesh->Delete(); this->Mesh = NULL;}
-  newPolys->Delete();
+  // Stitch the regions. Points that were in the input keep their id, those
+  // created by splitting are appended.
+  vtkIdType numRemaining = 0;
+  for (r=0; r < numRegions; r++)
+    {
+    numRemaining += regions[r]->NumberOfRemainingTris;
+    }
 
-  return 1;
+  vtkPoints *newPts = vtkPoints::New();
+  newPts->DeepCopy(inPts);
+  vtkCellArray *newPolys = vtkCellArray::New();
+  newPolys->Allocate(newPolys->EstimateSize(numRemaining, 3));
+  this->Mesh = vtkPolyData::New();
+  vtkPointData *meshPD = this->Mesh->GetPointData();
+  meshPD->DeepCopy(input->GetPointData());
+  meshPD->CopyAllocate(meshPD, numPts);
+  if ( this->AccumulateError )
+    {
+    this->VertexError = vtkDoubleArray::New();
+    this->VertexError->SetNumberOfValues(numPts);
+    for (ptId=0; ptId < numPts; ptId++)
+      {
+      this->VertexError->SetValue(ptId, 0.0);
+      }
+    }
+
+  vtkstd::vector<vtkIdType> globalId;
+  for (r=0; r < numRegions; r++)
+    {
+    vtkPolyData *mesh = regions[r]->Mesh;
+    vtkIdTypeArray *ids =
+      vtkIdTypeArray::SafeDownCast(mesh->GetPointData()->GetArray(0));
+    vtkIdType numLocal = mesh->GetNumberOfPoints();
+    vtkIdType *cells, npts, *pts;
+    unsigned short ncells;
+
+    globalId.resize(numLocal);
+    for (i=0; i < numLocal; i++)
+      {
+      mesh->GetPointCells(i, ncells, cells);
+      if ( ncells == 0 )
+        {
+        globalId[i] = -1;
+        continue;
+        }
+      ptId = ids->GetValue(i);
+      if ( i < numRegionPts[r] )
+        {
+        globalId[i] = ptId;
+        }
+      else
+        {
+        globalId[i] = newPts->InsertNextPoint(mesh->GetPoint(i));
+        meshPD->CopyData(meshPD, ptId, globalId[i]);
+        }
+      if ( this->AccumulateError )
+        {
+        // Seam points collect the error distributed from every side.
+        double previous = (globalId[i] < numPts ?
+                           this->VertexError->GetValue(globalId[i]) : 0.0);
+        this->VertexError->InsertValue(globalId[i],
+          previous + regions[r]->VertexError->GetValue(i));
+        }
+      }
+
+    for (triId=0; triId < numRegionTris[r]; triId++)
+      {
+      if ( mesh->GetCellType(triId) == VTK_TRIANGLE )
+        {
+        mesh->GetCellPoints(triId, npts, pts);
+        newPolys->InsertNextCell(3);
+        for (j=0; j < 3; j++)
+          {
+          newPolys->InsertCellPoint(globalId[pts[j]]);
+          }
+        }
+      }
+    regions[r]->Delete();
+    }
+
+  this->Mesh->SetPoints(newPts);
+  this->Mesh->SetPolys(newPolys);
+  newPts->Delete();
+  newPolys->Delete();
+  this->Mesh->BuildLinks();
 }
 
 //----------------------------------------------------------------------------
@@ -463,7 +926,8 @@ void vtkDecimatePro::SplitMesh()
   unsigned short int ncells;
 
   this->CosAngle = cos( vtkMath::RadiansFromDegrees(  this->SplitAngle) );
-  for ( ptId=0; ptId < this->Mesh->GetNumberOfPoints(); ptId++ )
+  for ( ptId=this->NumberOfFrozenPoints;
+        ptId < this->Mesh->GetNumberOfPoints(); ptId++ )
     {
     this->Mesh->GetPoint(ptId,this->X);
     this->Mesh->GetPointCells(ptId,ncells,cells);
@@ -1580,6 +2044,12 @@ void vtkDecimatePro::Insert(vtkIdType ptId, double error)
   vtkIdType fedges[2];
   unsigned short int ncells;
 
+  // Points shared with other regions of a parallel decimation stay put
+  if ( ptId < this->NumberOfFrozenPoints )
+    {
+    return;
+    }
+
   // on value of error, we need to compute it or just insert the point
   if ( error < -this->Tolerance )
     {
@@ -1730,4 +2200,7 @@ void vtkDecimatePro::PrintSelf(ostream& os, vtkIndent indent)
      << this->InflectionPointRatio << "\n";
   os << indent << "Number Of Inflection Points: "
      << this->GetNumberOfInflectionPoints() << "\n";
+  os << indent << "Parallel Decimation: "
+     << (this->ParallelDecimation ? "On\n" : "Off\n");
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 }
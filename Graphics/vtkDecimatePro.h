@@ -58,6 +58,14 @@
 // to surrounding vertices as each vertex is deleted. The accumulated error
 // is a conservative global error bounds and decimation error, but requires
 // additional memory and time to compute.
+//
+// Large meshes can be decimated in parallel by turning ParallelDecimation
+// on. The triangles are then divided into NumberOfThreads regions of about
+// the same size with a kd split of their centroids. Every region is
+// decimated in its own thread while the vertices it shares with other
+// regions are left untouched. The regions are then stitched back together
+// and a final pass over the whole mesh decimates across the seams and
+// completes the reduction. The result is not identical to the serial one.
 
 // .SECTION Caveats
 // To guarantee a given level of reduction, the ivar PreserveTopology must
@@ -68,6 +76,9 @@
 // be modified by closing holes.
 //
 // Once mesh splitting begins, the feature angle is set to the split angle.
+//
+// With ParallelDecimation on, the inflection points are only those of the
+// final pass.
 
 // .SECTION See Also
 // vtkDecimate vtkQuadricClustering vtkQuadricDecimation
@@ -204,6 +215,22 @@ public:
   vtkSetClampMacro(InflectionPointRatio,double,1.001,VTK_DOUBLE_MAX);
   vtkGetMacro(InflectionPointRatio,double);
 
+  // Description:
+  // Turn on/off parallel decimation. If on, the mesh is divided into
+  // NumberOfThreads regions whose interiors are decimated concurrently,
+  // followed by a serial pass across the region boundaries. Meshes too
+  // small to give every region enough triangles are decimated serially.
+  // By default ParallelDecimation is off.
+  vtkSetMacro(ParallelDecimation,int);
+  vtkGetMacro(ParallelDecimation,int);
+  vtkBooleanMacro(ParallelDecimation,int);
+
+  // Description:
+  // Set/Get the number of regions, and so of threads, used by parallel
+  // decimation. The default is the global default number of threads of
+  // vtkMultiThreader.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
 
   // Description:
   // Get the number of inflection points. Only returns a valid value after
@@ -248,6 +275,8 @@ protected:
   int Degree;
   double InflectionPointRatio;
   vtkDoubleArray *InflectionPoints;
+  int ParallelDecimation;
+  int NumberOfThreads;
 
   // to replace a static object
   vtkIdList *Neighbors;
@@ -266,6 +295,10 @@ protected:
   int CollapseEdge(int type, vtkIdType ptId, vtkIdType collapseId,
                    vtkIdType pt1, vtkIdType pt2, vtkIdList *CollapseTris);
   void DistributeError(double error);
+  vtkIdType DecimateMesh(vtkIdType numTris, double targetReduction,
+                         double progressStart);
+  void DecimateRegions(vtkPolyData *input, int numRegions);
+  static VTK_THREAD_RETURN_TYPE DecimateRegionsThread(void *arg);
 
   //
   // Special classes for manipulating data
@@ -370,6 +403,7 @@ private:
   double TheSplitAngle; //Split angle
   int SplitState;   //State of the splitting process
   double Error;      //Maximum allowable surface error
+  vtkIdType NumberOfFrozenPoints; //Points [0,n) are never deleted or split
 
 private:
   vtkDecimatePro(const vtkDecimatePro&);  // Not implemented.
@@ -49,14 +49,167 @@
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkPointData.h"
 #include "vtkPriorityQueue.h"
 #include "vtkTriangle.h"
 
+#include <vtkstd/vector>
+
 vtkStandardNewMacro(vtkQuadricDecimation);
 
+// Work is only split among threads when every thread gets at least this
+// many items (triangles, edges or batched collapses).
+#define VTK_QUADRIC_MIN_ITEMS_PER_THREAD 8192
+#define VTK_QUADRIC_MIN_COLLAPSES_PER_THREAD 256
+
+// The triangle quadrics are computed this many triangles at a time.
+#define VTK_QUADRIC_BLOCK_SIZE 262144
+
+// Number of candidate edges popped from the queue per batched round.
+#define VTK_QUADRIC_BATCH_SIZE 4096
+
+//----------------------------------------------------------------------------
+// Temporary storage of one thread.
+class vtkQuadricDecimationScratch
+{
+public:
+  vtkstd::vector<double> Quad;
+  vtkstd::vector<double> X;
+  vtkstd::vector<double> B;
+  vtkstd::vector<double> Data;
+  vtkstd::vector<double *> A;
+  vtkIdList *CellIds;
+  int Failures;
+};
+
+//----------------------------------------------------------------------------
+// One phase of work split among threads, see
+// vtkQuadricDecimation::ThreadedExecute().
+class vtkQuadricDecimationThreads
+{
+public:
+  enum
+  {
+    FACE_QUADRICS,
+    ADD_QUADRICS,
+    BOUNDARY,
+    COSTS,
+    COLLAPSE
+  };
+
+  vtkQuadricDecimationThreads(vtkQuadricDecimation *filter, int numThreads,
+                              int numComponents);
+  ~vtkQuadricDecimationThreads();
+
+  // Run a phase over numItems items, with as many threads as give every
+  // one at least minItems items.
+  void Execute(int phase, vtkIdType numItems, vtkIdType minItems);
+
+  int GetNumberOfFailures();
+
+  vtkQuadricDecimation *Filter;
+  int NumberOfThreads;
+  int Phase;
+  vtkIdType NumberOfItems;
+  vtkIdType First;          // first cell of the block of face quadrics
+  vtkIdType NumberOfPoints;
+  int QuadricSize;
+  double *Values;           // face quadrics or edge costs
+  unsigned char *Flags;     // boundary edges of every cell
+  const vtkIdType *Items;   // edge ids
+  vtkIdType *Counts;        // triangles deleted by every collapse
+  vtkIdList **Lists;        // edges affected by every collapse
+  vtkstd::vector<vtkQuadricDecimationScratch> Scratch;
+};
+
+//----------------------------------------------------------------------------
+vtkQuadricDecimationThreads::vtkQuadricDecimationThreads(
+  vtkQuadricDecimation *filter, int numThreads, int numComponents)
+{
+  int i, j;
+  int n = 3 + numComponents;
+
+  this->Filter = filter;
+  this->NumberOfThreads = numThreads;
+  this->Phase = FACE_QUADRICS;
+  this->NumberOfItems = 0;
+  this->First = 0;
+  this->NumberOfPoints = 0;
+  this->QuadricSize = 11 + 4 * numComponents;
+  this->Values = NULL;
+  this->Flags = NULL;
+  this->Items = NULL;
+  this->Counts = NULL;
+  this->Lists = NULL;
+  this->Scratch.resize(numThreads);
+  for (i = 0; i < numThreads; i++)
+    {
+    vtkQuadricDecimationScratch &scratch = this->Scratch[i];
+    scratch.Quad.resize(this->QuadricSize);
+    scratch.X.resize(n);
+    scratch.B.resize(n);
+    scratch.Data.resize(n * n);
+    scratch.A.resize(n);
+    for (j = 0; j < n; j++)
+      {
+      scratch.A[j] = &scratch.Data[j * n];
+      }
+    scratch.CellIds = vtkIdList::New();
+    scratch.Failures = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkQuadricDecimationThreads::~vtkQuadricDecimationThreads()
+{
+  for (int i = 0; i < this->NumberOfThreads; i++)
+    {
+    this->Scratch[i].CellIds->Delete();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkQuadricDecimationThreads::Execute(int phase, vtkIdType numItems,
+                                          vtkIdType minItems)
+{
+  vtkIdType numThreads = numItems / minItems;
+  numThreads = (numThreads < this->NumberOfThreads ?
+                numThreads : this->NumberOfThreads);
+
+  this->Phase = phase;
+  this->NumberOfItems = numItems;
+  if (numThreads <= 1)
+    {
+    vtkMultiThreader::ThreadInfo info;
+    info.ThreadID = 0;
+    info.NumberOfThreads = 1;
+    info.UserData = this;
+    vtkQuadricDecimation::ThreadedExecute(&info);
+    return;
+    }
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(static_cast<int>(numThreads));
+  threader->SetSingleMethod(vtkQuadricDecimation::ThreadedExecute, this);
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
+
+//----------------------------------------------------------------------------
+int vtkQuadricDecimationThreads::GetNumberOfFailures()
+{
+  int failures = 0;
+  for (int i = 0; i < this->NumberOfThreads; i++)
+    {
+    failures += this->Scratch[i].Failures;
+    this->Scratch[i].Failures = 0;
+    }
+  return failures;
+}
+
 
 //----------------------------------------------------------------------------
 vtkQuadricDecimation::vtkQuadricDecimation()
@@ -86,6 +239,9 @@ vtkQuadricDecimation::vtkQuadricDecimation()
   this->TensorsWeight = 0.1;
 
   this->ActualReduction = 0.0;
+
+  this->BatchedCollapse = 0;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
 }
 
 //----------------------------------------------------------------------------
@@ -288,26 +444,36 @@ int vtkQuadricDecimation::RequestData(
   this->UpdateProgress(0.15);
   
   vtkDebugMacro(<<"Computing Costs");
-  // Compute the cost of and target point for collapsing each edge.
-  for (i = 0; i < this->Edges->GetNumberOfEdges(); i++)
+  // Compute the cost of and target point for collapsing each edge. The
+  // edges are queued in order afterwards, as with a single thread.
+  vtkIdType numEdges = this->Edges->GetNumberOfEdges();
+  double *costs = new double[numEdges];
+  this->TargetPoints->SetNumberOfTuples(numEdges);
+  vtkQuadricDecimationThreads threads(this, this->NumberOfThreads,
+                                      this->NumberOfComponents);
+  threads.Values = costs;
+  threads.Execute(vtkQuadricDecimationThreads::COSTS, numEdges,
+                  VTK_QUADRIC_MIN_ITEMS_PER_THREAD);
+  for (i = 0; i < numEdges; i++)
     {
-    if (this->AttributeErrorMetric) 
-      {
-      cost = this->ComputeCost2(i, x);
-      }
-    else
-      {
-      cost = this->ComputeCost(i, x);
-      }
-    this->EdgeCosts->Insert(cost, i);
-    this->TargetPoints->InsertTuple(i, x);
+    this->EdgeCosts->Insert(costs[i], i);
     }
+  delete [] costs;
   this->UpdateProgress(0.20);
 
   // Okay collapse edges until desired reduction is reached
   this->ActualReduction = 0.0;
   this->NumberOfEdgeCollapses = 0;
-  edgeId = this->EdgeCosts->Pop(0,cost);
+  if (this->BatchedCollapse)
+    {
+    numDeletedTris = this->CollapseBatches(numTris);
+    edgeId = -1;
+    cost = 0.0;
+    }
+  else
+    {
+    edgeId = this->EdgeCosts->Pop(0,cost);
+    }
 
   int abort = 0;
   while ( !abort && edgeId >= 0 && cost < VTK_DOUBLE_MAX &&
@@ -407,12 +573,57 @@ int vtkQuadricDecimation::RequestData(
 
 //----------------------------------------------------------------------------
 void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
+{
+  vtkIdType ptId, first, numFaces;
+  vtkIdType numCells = this->Mesh->GetNumberOfCells();
+  int i;
+  int quadricSize = 11 + 4 * this->NumberOfComponents;
+
+  // clear and allocate global QEM array
+  for (ptId = 0; ptId < numPts; ptId++) 
+    {
+    this->ErrorQuadrics[ptId].Quadric = new double[quadricSize];
+    for (i = 0; i < quadricSize; i++)
+      {
+      this->ErrorQuadrics[ptId].Quadric[i] = 0.0;
+      }
+    }
+
+  // Compute the QEM of a block of faces at a time, then add them to the
+  // points. The points are split among the threads, so every point sums
+  // the QEM of its faces in cell order, as with a single thread.
+  numFaces = (numCells < VTK_QUADRIC_BLOCK_SIZE ?
+              numCells : VTK_QUADRIC_BLOCK_SIZE);
+  double *faceQuadrics = new double[numFaces * quadricSize];
+  vtkQuadricDecimationThreads threads(this, this->NumberOfThreads,
+                                      this->NumberOfComponents);
+  threads.Values = faceQuadrics;
+  threads.NumberOfPoints = numPts;
+  for (first = 0; first < numCells; first += numFaces)
+    {
+    vtkIdType numItems = (numCells - first < numFaces ?
+                          numCells - first : numFaces);
+    threads.First = first;
+    threads.Execute(vtkQuadricDecimationThreads::FACE_QUADRICS, numItems,
+                    VTK_QUADRIC_MIN_ITEMS_PER_THREAD);
+    threads.Execute(vtkQuadricDecimationThreads::ADD_QUADRICS, numItems,
+                    VTK_QUADRIC_MIN_ITEMS_PER_THREAD);
+    }
+  delete [] faceQuadrics;
+
+  int failures = threads.GetNumberOfFailures();
+  if (failures > 0)
+    {
+    vtkErrorMacro(<<"Unable to factor attribute matrix of " << failures
+                  << " triangles!");
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkQuadricDecimation::ComputeFaceQuadric(vtkIdType cellId, double *QEM)
 {
   vtkPolyData *input = this->Mesh;
-  double *QEM;
-  vtkIdType ptId;
-  int i, j;
-  vtkCellArray *polys;
+  int i, ok = 1;
   vtkIdType npts, *pts=NULL;
   double point0[3], point1[3], point2[3];
   double n[3];
@@ -425,144 +636,127 @@ void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
   A[2] = data+8;
   A[3] = data+12;
 
-  // allocate local QEM sparce matrix
-  QEM = new double[11 + 4 * this->NumberOfComponents];
-
-  // clear and allocate global QEM array
-  for (ptId = 0; ptId < numPts; ptId++) 
+  input->GetCellPoints(cellId, npts, pts);
+  input->GetPoint(pts[0], point0);
+  input->GetPoint(pts[1], point1);
+  input->GetPoint(pts[2], point2);
+  for (i = 0; i < 3; i++)
     {
-    this->ErrorQuadrics[ptId].Quadric =
-      new double[11 + 4 * this->NumberOfComponents];
-    for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
-      {
-      this->ErrorQuadrics[ptId].Quadric[i] = 0.0;
-      }
+    tempP1[i] = point1[i] - point0[i];
+    tempP2[i] = point2[i] - point0[i];
     }
+  vtkMath::Cross(tempP1, tempP2, n);
+  triArea2 = vtkMath::Normalize(n);
+  //triArea2 = (triArea2 * triArea2 * 0.25);
+  triArea2 = triArea2 * 0.5;
+  // I am unsure whether this should be squared or not??
+  d = -vtkMath::Dot(n, point0);
+  // could possible add in angle weights??
+
+  // set the geometric part of the QEM
+  QEM[0] = n[0] * n[0];
+  QEM[1] = n[0] * n[1];
+  QEM[2] = n[0] * n[2];
+  QEM[3] = d * n[0];
+
+  QEM[4] = n[1] * n[1];
+  QEM[5] = n[1] * n[2];
+  QEM[6] = d * n[1];
+
+  QEM[7] = n[2] * n[2];
+  QEM[8] = d * n[2];
+
+  QEM[9] = d * d;
+  QEM[10] = 1;
   
-  polys = input->GetPolys();
-  // compute the QEM for each face
-  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ) 
+  if (this->AttributeErrorMetric) 
     {
-    input->GetPoint(pts[0], point0);
-    input->GetPoint(pts[1], point1);
-    input->GetPoint(pts[2], point2);
-    for (i = 0; i < 3; i++)
+    for (i = 0; i < 3; i++) 
       {
-      tempP1[i] = point1[i] - point0[i];
-      tempP2[i] = point2[i] - point0[i];
-      }
-    vtkMath::Cross(tempP1, tempP2, n);
-    triArea2 = vtkMath::Normalize(n);
-    //triArea2 = (triArea2 * triArea2 * 0.25);
-    triArea2 = triArea2 * 0.5;
-    // I am unsure whether this should be squared or not??
-    d = -vtkMath::Dot(n, point0);
-    // could possible add in angle weights??
-
-    // set the geometric part of the QEM
-    QEM[0] = n[0] * n[0];
-    QEM[1] = n[0] * n[1];
-    QEM[2] = n[0] * n[2];
-    QEM[3] = d * n[0];
-
-    QEM[4] = n[1] * n[1];
-    QEM[5] = n[1] * n[2];
-    QEM[6] = d * n[1];
-
-    QEM[7] = n[2] * n[2];
-    QEM[8] = d * n[2];
-
-    QEM[9] = d * d;
-    QEM[10] = 1;
-    
-    if (this->AttributeErrorMetric) 
+      A[0][i] = point0[i];
+      A[1][i] = point1[i];
+      A[2][i] = point2[i];
+      A[3][i] = n[i];
+      }       
+    A[0][3] =  A[1][3] = A[2][3] = 1;
+    A[3][3] = 0;
+
+    // should handle poorly condition matrix better
+    if (vtkMath::LUFactorLinearSystem(A, index, 4))
       {
-      for (i = 0; i < 3; i++) 
+      for (i = 0; i < this->NumberOfComponents; i++) 
         {
-        A[0][i] = point0[i];
-        A[1][i] = point1[i];
-        A[2][i] = point2[i];
-        A[3][i] = n[i];
-        }       
-      A[0][3] =  A[1][3] = A[2][3] = 1;
-      A[3][3] = 0;
-
-      // should handle poorly condition matrix better
-      if (vtkMath::LUFactorLinearSystem(A, index, 4))
-        {
-        for (i = 0; i < this->NumberOfComponents; i++) 
+        x[3] = 0;
+        if (i < this->AttributeComponents[0]) 
           {
-          x[3] = 0;
-          if (i < this->AttributeComponents[0]) 
-            {
-            x[0] = input->GetPointData()->GetScalars()->GetComponent(pts[0], i) *  this->AttributeScale[0];
-            x[1] = input->GetPointData()->GetScalars()->GetComponent(pts[1], i) *  this->AttributeScale[0];
-            x[2] = input->GetPointData()->GetScalars()->GetComponent(pts[2], i) *  this->AttributeScale[0];
-            } 
-          else if (i < this->AttributeComponents[1]) 
-            {
-            x[0] = input->GetPointData()->GetVectors()->GetComponent(pts[0], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
-            x[1] = input->GetPointData()->GetVectors()->GetComponent(pts[1], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
-            x[2] = input->GetPointData()->GetVectors()->GetComponent(pts[2], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
-            } 
-          else if (i < this->AttributeComponents[2]) 
-            {
-            x[0] = input->GetPointData()->GetNormals()->GetComponent(pts[0], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
-            x[1] = input->GetPointData()->GetNormals()->GetComponent(pts[1], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
-            x[2] = input->GetPointData()->GetNormals()->GetComponent(pts[2], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
-            } 
-          else if (i < this->AttributeComponents[3]) 
-            {
-            x[0] = input->GetPointData()->GetTCoords()->GetComponent(pts[0], i - this->AttributeComponents[2]) *  this->AttributeScale[3];
-            x[1] = input->GetPointData()->GetTCoords()->GetComponent(pts[1], i - this->AttributeComponents[2])*  this->AttributeScale[3];
-            x[2] = input->GetPointData()->GetTCoords()->GetComponent(pts[2], i - this->AttributeComponents[2])*  this->AttributeScale[3];
-            } 
-          else if (i < this->AttributeComponents[4]) 
-            {
-            x[0] = input->GetPointData()->GetTensors()->GetComponent(pts[0], i - this->AttributeComponents[3])*  this->AttributeScale[4];
-            x[1] = input->GetPointData()->GetTensors()->GetComponent(pts[1], i - this->AttributeComponents[3])*  this->AttributeScale[4];
-            x[2] = input->GetPointData()->GetTensors()->GetComponent(pts[2], i - this->AttributeComponents[3])*  this->AttributeScale[4];
-            }
-          vtkMath::LUSolveLinearSystem(A, index, x, 4);
-
-          // add in the contribution of this element into the QEM
-          QEM[0] += x[0] * x[0];
-          QEM[1] += x[0] * x[1];
-          QEM[2] += x[0] * x[2];
-          QEM[3] += x[3] * x[0];
-          
-          QEM[4] += x[1] * x[1];
-          QEM[5] += x[1] * x[2];
-          QEM[6] += x[3] * x[1];
-          
-          QEM[7] += x[2] * x[2];
-          QEM[8] += x[3] * x[2];
-          
-          QEM[9] += x[3] * x[3];
-          
-          QEM[11+i*4] = -x[0];
-          QEM[12+i*4] = -x[1];
-          QEM[13+i*4] = -x[2];
-          QEM[14+i*4] = -x[3];
+          x[0] = input->GetPointData()->GetScalars()->GetComponent(pts[0], i) *  this->AttributeScale[0];
+          x[1] = input->GetPointData()->GetScalars()->GetComponent(pts[1], i) *  this->AttributeScale[0];
+          x[2] = input->GetPointData()->GetScalars()->GetComponent(pts[2], i) *  this->AttributeScale[0];
+          } 
+        else if (i < this->AttributeComponents[1]) 
+          {
+          x[0] = input->GetPointData()->GetVectors()->GetComponent(pts[0], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
+          x[1] = input->GetPointData()->GetVectors()->GetComponent(pts[1], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
+          x[2] = input->GetPointData()->GetVectors()->GetComponent(pts[2], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
+          } 
+        else if (i < this->AttributeComponents[2]) 
+          {
+          x[0] = input->GetPointData()->GetNormals()->GetComponent(pts[0], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
+          x[1] = input->GetPointData()->GetNormals()->GetComponent(pts[1], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
+          x[2] = input->GetPointData()->GetNormals()->GetComponent(pts[2], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
+          } 
+        else if (i < this->AttributeComponents[3]) 
+          {
+          x[0] = input->GetPointData()->GetTCoords()->GetComponent(pts[0], i - this->AttributeComponents[2]) *  this->AttributeScale[3];
+          x[1] = input->GetPointData()->GetTCoords()->GetComponent(pts[1], i - this->AttributeComponents[2])*  this->AttributeScale[3];
+          x[2] = input->GetPointData()->GetTCoords()->GetComponent(pts[2], i - this->AttributeComponents[2])*  this->AttributeScale[3];
+          } 
+        else if (i < this->AttributeComponents[4]) 
+          {
+          x[0] = input->GetPointData()->GetTensors()->GetComponent(pts[0], i - this->AttributeComponents[3])*  this->AttributeScale[4];
+          x[1] = input->GetPointData()->GetTensors()->GetComponent(pts[1], i - this->AttributeComponents[3])*  this->AttributeScale[4];
+          x[2] = input->GetPointData()->GetTensors()->GetComponent(pts[2], i - this->AttributeComponents[3])*  this->AttributeScale[4];
           }
-        }
-      else 
-        {
-        vtkErrorMacro(<<"Unable to factor attribute matrix!");
+        vtkMath::LUSolveLinearSystem(A, index, x, 4);
+
+        // add in the contribution of this element into the QEM
+        QEM[0] += x[0] * x[0];
+        QEM[1] += x[0] * x[1];
+        QEM[2] += x[0] * x[2];
+        QEM[3] += x[3] * x[0];
+        
+        QEM[4] += x[1] * x[1];
+        QEM[5] += x[1] * x[2];
+        QEM[6] += x[3] * x[1];
+        
+        QEM[7] += x[2] * x[2];
+        QEM[8] += x[3] * x[2];
+        
+        QEM[9] += x[3] * x[3];
+        
+        QEM[11+i*4] = -x[0];
+        QEM[12+i*4] = -x[1];
+        QEM[13+i*4] = -x[2];
+        QEM[14+i*4] = -x[3];
         }
       }
-    
-      // add the QEM to all point of the face
-    for (i = 0; i < 3; i++) 
+    else 
       {
-      for (j = 0; j < 11 + 4 * this->NumberOfComponents; j++) 
+      ok = 0;
+      for (i = 11; i < 11 + 4 * this->NumberOfComponents; i++)
         {
-        this->ErrorQuadrics[pts[i]].Quadric[j] += QEM[j] * triArea2;
+        QEM[i] = 0.0;
         }
       }
-    }//for all triangles
+    }
+  
+  // weight the QEM by the area of the face
+  for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
+    {
+    QEM[i] *= triArea2;
+    }
 
-  delete [] QEM;
+  return ok;
 }
 
 
@@ -575,19 +769,31 @@ void vtkQuadricDecimation::AddBoundaryConstraints(void)
   vtkIdType npts, *pts;
   double t0[3], t1[3], t2[3];
   double e0[3], e1[3], n[3], c, d, w;
-  vtkIdList *cellIds = vtkIdList::New();
+  vtkIdType numCells = input->GetNumberOfCells();
+
+  // Find the boundary edges of every cell in parallel. Bit i of the flags
+  // of a cell is set if edge (i, i+1) is on the boundary.
+  unsigned char *boundary = new unsigned char[numCells];
+  vtkQuadricDecimationThreads threads(this, this->NumberOfThreads,
+                                      this->NumberOfComponents);
+  threads.Flags = boundary;
+  threads.Execute(vtkQuadricDecimationThreads::BOUNDARY, numCells,
+                  VTK_QUADRIC_MIN_ITEMS_PER_THREAD);
   
   // allocate local QEM space matrix
   QEM = new double[11 + 4 * this->NumberOfComponents];
   
-  for (cellId = 0; cellId < input->GetNumberOfCells(); cellId++) 
+  for (cellId = 0; cellId < numCells; cellId++) 
     {
+    if (!boundary[cellId])
+      {
+      continue;
+      }
     input->GetCellPoints(cellId, npts, pts);
 
     for (i = 0; i < 3; i++) 
       {
-      input->GetCellEdgeNeighbors(cellId, pts[i], pts[(i+1)%3], cellIds);
-      if (cellIds->GetNumberOfIds() == 0) 
+      if (boundary[cellId] & (1 << i)) 
         {
         // this is a boundary
         input->GetPoint(pts[(i+2)%3], t0);
@@ -646,7 +852,7 @@ void vtkQuadricDecimation::AddBoundaryConstraints(void)
         }
       }
     }
-  cellIds->Delete();
+  delete [] boundary;
   delete [] QEM;
 }
 
@@ -706,11 +912,23 @@ void vtkQuadricDecimation::FindAffectedEdges(vtkIdType p1Id, vtkIdType p2Id,
 void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
 {
   vtkIdList *changedEdges = vtkIdList::New();
-  vtkIdType i, edgeId, edge[2];
-  double cost;
 
   // Find all edges with exactly either of these 2 endpoints.
   this->FindAffectedEdges(pt0Id, pt1Id, changedEdges);
+  this->RenameAffectedEdges(pt0Id, pt1Id, changedEdges, NULL);
+
+  changedEdges->Delete();
+  return; 
+}
+
+//----------------------------------------------------------------------------
+void vtkQuadricDecimation::RenameAffectedEdges(vtkIdType pt0Id,
+                                               vtkIdType pt1Id,
+                                               vtkIdList *changedEdges,
+                                               vtkIdList *updatedEdges)
+{
+  vtkIdType i, edgeId, edge[2];
+  double cost;
 
   // Reset the endpoints for these edges to reflect the new point from the
   // collapsed edge.
@@ -726,6 +944,7 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
     this->EdgeCosts->DeleteId(changedEdges->GetId(i));
 
     // Determine the new set of edges
+    edgeId = -1;
     if (edge[0] == pt1Id)
       {
       if (this->Edges->IsEdge(edge[1], pt0Id) == -1)
@@ -734,17 +953,6 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
         this->Edges->InsertEdge(edge[1], pt0Id, edgeId);
         this->EndPoint1List->InsertId(edgeId, edge[1]);
         this->EndPoint2List->InsertId(edgeId, pt0Id);
-        // Compute cost (target point/data) and add to priority cue.
-        if (this->AttributeErrorMetric) 
-          {
-          cost = this->ComputeCost2(edgeId, this->TempX);
-          }
-        else
-          {
-          cost = this->ComputeCost(edgeId, this->TempX);
-          }
-        this->EdgeCosts->Insert(cost, edgeId);
-        this->TargetPoints->InsertTuple(edgeId, this->TempX);
         }
       }
     else if (edge[1] == pt1Id)
@@ -755,40 +963,47 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
         this->Edges->InsertEdge(edge[0], pt0Id, edgeId);
         this->EndPoint1List->InsertId(edgeId, edge[0]);
         this->EndPoint2List->InsertId(edgeId, pt0Id);
-        // Compute cost (target point/data) and add to priority cue.
-        if (this->AttributeErrorMetric) 
-          {
-          cost = this->ComputeCost2(edgeId, this->TempX);
-          }
-        else
-          {
-          cost = this->ComputeCost(edgeId, this->TempX);
-          }
-        this->EdgeCosts->Insert(cost, edgeId);
-        this->TargetPoints->InsertTuple(edgeId, this->TempX);
         }
       }
     else
       { // This edge already has one point as the merged point.
-      if (this->AttributeErrorMetric) 
-        {
-        cost = this->ComputeCost2(changedEdges->GetId(i), this->TempX);
-        }
-      else
-        {
-        cost = this->ComputeCost(changedEdges->GetId(i), this->TempX);
-        }
-      this->EdgeCosts->Insert(cost, changedEdges->GetId(i));
-      this->TargetPoints->InsertTuple(changedEdges->GetId(i), this->TempX);
+      edgeId = changedEdges->GetId(i);
+      }
+    if (edgeId < 0)
+      {
+      continue;
       }
-    }
 
-  changedEdges->Delete();
-  return; 
+    // The caller computes the costs of the collected edges itself.
+    if (updatedEdges)
+      {
+      updatedEdges->InsertNextId(edgeId);
+      continue;
+      }
+
+    // Compute cost (target point/data) and add to priority cue.
+    if (this->AttributeErrorMetric) 
+      {
+      cost = this->ComputeCost2(edgeId, this->TempX);
+      }
+    else
+      {
+      cost = this->ComputeCost(edgeId, this->TempX);
+      }
+    this->EdgeCosts->Insert(cost, edgeId);
+    this->TargetPoints->InsertTuple(edgeId, this->TempX);
+    }
 }
 
 //----------------------------------------------------------------------------
 double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
+{
+  return this->ComputeCost(edgeId, x, this->TempQuad);
+}
+
+//----------------------------------------------------------------------------
+double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x,
+                                         double *quad)
 {
   static const double errorNumber = 1e-10;
   double temp[3], A[3][3], b[3];
@@ -805,20 +1020,20 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
   
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
     {
-    this->TempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
+    quad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
       this->ErrorQuadrics[pointIds[1]].Quadric[i];
     }
 
-  A[0][0] = this->TempQuad[0];
-  A[0][1] = A[1][0] = this->TempQuad[1];
-  A[0][2] = A[2][0] = this->TempQuad[2];
-  A[1][1] = this->TempQuad[4];
-  A[1][2] = A[2][1] = this->TempQuad[5];
-  A[2][2] = this->TempQuad[7];
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
 
-  b[0] = -this->TempQuad[3];
-  b[1] = -this->TempQuad[6];
-  b[2] = -this->TempQuad[8];
+  b[0] = -quad[3];
+  b[1] = -quad[6];
+  b[2] = -quad[8];
    
   norm = vtkMath::Norm(A[0]);
   normTemp = vtkMath::Norm(A[1]);
@@ -872,7 +1087,7 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
   
   // Compute the cost
   // x'*quad*x
-  index = this->TempQuad;
+  index = quad;
   for (i = 0; i < 4; i++) 
     {
     cost += (*index++)*newPoint[i]*newPoint[i];
@@ -888,6 +1103,15 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
 
 //----------------------------------------------------------------------------
 double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
+{
+  return this->ComputeCost2(edgeId, x, this->TempQuad, this->TempA,
+                            this->TempB);
+}
+
+//----------------------------------------------------------------------------
+double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x,
+                                          double *quad, double **A,
+                                          double *b)
 {
   // this function is so ugly because the functionality of converting an QEM
   // into a dence matrix was not extracted into a separate function and
@@ -903,29 +1127,29 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
 
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)  
     {
-    this->TempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
+    quad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
       this->ErrorQuadrics[pointIds[1]].Quadric[i];
     }
   
   // copy the temp quad into TempA
   // converting from the sparce matrix format into a dence
-  this->TempA[0][0] = this->TempQuad[0];
-  this->TempA[0][1] = this->TempA[1][0] = this->TempQuad[1];
-  this->TempA[0][2] = this->TempA[2][0] = this->TempQuad[2];
-  this->TempA[1][1] = this->TempQuad[4];
-  this->TempA[1][2] = this->TempA[2][1] = this->TempQuad[5];
-  this->TempA[2][2] = this->TempQuad[7];
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
   
-  this->TempB[0] = -this->TempQuad[3];
-  this->TempB[1] = -this->TempQuad[6];
-  this->TempB[2] = -this->TempQuad[8];
+  b[0] = -quad[3];
+  b[1] = -quad[6];
+  b[2] = -quad[8];
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++) 
     {
-    this->TempA[0][i] = this->TempA[i][0] = this->TempQuad[11+4*(i-3)];
-    this->TempA[1][i] = this->TempA[i][1] = this->TempQuad[11+4*(i-3)+1];
-    this->TempA[2][i] = this->TempA[i][2] = this->TempQuad[11+4*(i-3)+2];
-    this->TempB[i] = -this->TempQuad[11+4*(i-3)+3];
+    A[0][i] = A[i][0] = quad[11+4*(i-3)];
+    A[1][i] = A[i][1] = quad[11+4*(i-3)+1];
+    A[2][i] = A[i][2] = quad[11+4*(i-3)+2];
+    b[i] = -quad[11+4*(i-3)+3];
     }
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++) 
@@ -934,38 +1158,38 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
       {
       if (i == j)
         {
-        this->TempA[i][j] = this->TempQuad[10];
+        A[i][j] = quad[10];
         }
       else 
         {
-        this->TempA[i][j] = 0;
+        A[i][j] = 0;
         }
       }
     }
   
   for (i = 0; i < 3 + this->NumberOfComponents; i++) 
     {
-    x[i] = this->TempB[i];
+    x[i] = b[i];
     }
   
   // solve A*x = b
   // this clobers A
   // need to develop a quality of the solution test??
-  solveOk = vtkMath::SolveLinearSystem(this->TempA, x, 3 +  this->NumberOfComponents);
+  solveOk = vtkMath::SolveLinearSystem(A, x, 3 +  this->NumberOfComponents);
   
   // need to copy back into A
-  this->TempA[0][0] = this->TempQuad[0];
-  this->TempA[0][1] = this->TempA[1][0] = this->TempQuad[1];
-  this->TempA[0][2] = this->TempA[2][0] = this->TempQuad[2];
-  this->TempA[1][1] = this->TempQuad[4];
-  this->TempA[1][2] = this->TempA[2][1] = this->TempQuad[5];
-  this->TempA[2][2] = this->TempQuad[7];
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
  
   for (i = 3; i < 3 +  this->NumberOfComponents; i++) 
     {
-    this->TempA[0][i] = this->TempA[i][0] = this->TempQuad[11+4*(i-3)];
-    this->TempA[1][i] = this->TempA[i][1] = this->TempQuad[11+4*(i-3)+1];
-    this->TempA[2][i] = this->TempA[i][2] = this->TempQuad[11+4*(i-3)+2];
+    A[0][i] = A[i][0] = quad[11+4*(i-3)];
+    A[1][i] = A[i][1] = quad[11+4*(i-3)+1];
+    A[2][i] = A[i][2] = quad[11+4*(i-3)+2];
     }
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++) 
@@ -974,11 +1198,11 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
       {
       if (i == j)
         {
-        this->TempA[i][j] = this->TempQuad[10]; 
+        A[i][j] = quad[10]; 
         }
       else 
         {
-        this->TempA[i][j] = 0;
+        A[i][j] = 0;
         }
       }
     }
@@ -1011,7 +1235,7 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
       temp2[i] = 0;
       for (j = 0; j < 3 + this->NumberOfComponents; ++j) 
         {
-        temp2[i] += this->TempA[i][j]*v[j];
+        temp2[i] += A[i][j]*v[j];
         }
       }
       
@@ -1029,13 +1253,13 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
         temp[i] = 0;
         for (j = 0; j < 3 + this->NumberOfComponents; ++j) 
           {
-          temp[i] += this->TempA[i][j]*pt1[j];
+          temp[i] += A[i][j]*pt1[j];
           }
         }
           
       for (i = 0; i < 3 + this->NumberOfComponents; i++)
         {
-        temp[i] = this->TempB[i] - temp[i];
+        temp[i] = b[i] - temp[i];
         }
           
       for (i = 0; i < 3 + this->NumberOfComponents; i++)
@@ -1069,32 +1293,39 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
   // x'*A*x - 2*b*x + d
   for (i = 0; i < 3+this->NumberOfComponents; i++) 
     {
-    cost += this->TempA[i][i]*x[i]*x[i];
+    cost += A[i][i]*x[i]*x[i];
     for (j = i+1; j < 3+this->NumberOfComponents; j++) 
       {
-      cost += 2.0*this->TempA[i][j]*x[i]*x[j];
+      cost += 2.0*A[i][j]*x[i]*x[j];
       }
     }
   for (i = 0; i < 3+this->NumberOfComponents; i++) 
     {
-    cost -=  2.0 * this->TempB[i]*x[i];
+    cost -=  2.0 * b[i]*x[i];
     }
       
-  cost += this->TempQuad[9];
+  cost += quad[9];
 
   return cost;
 }
 
 
 int vtkQuadricDecimation::CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id) 
+{
+  return this->CollapseEdge(pt0Id, pt1Id, this->CollapseCellIds);
+}
+
+//----------------------------------------------------------------------------
+int vtkQuadricDecimation::CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id,
+                                       vtkIdList *cellIds)
 {
   int j, numDeleted=0;
   vtkIdType i, npts, *pts, cellId;
 
-  this->Mesh->GetPointCells(pt0Id, this->CollapseCellIds);
-  for (i = 0; i < this->CollapseCellIds->GetNumberOfIds(); i++) 
+  this->Mesh->GetPointCells(pt0Id, cellIds);
+  for (i = 0; i < cellIds->GetNumberOfIds(); i++) 
     {
-    cellId = this->CollapseCellIds->GetId(i);
+    cellId = cellIds->GetId(i);
     this->Mesh->GetCellPoints(cellId, npts, pts);
     for (j = 0; j < 3; j++) 
       {
@@ -1107,11 +1338,11 @@ int vtkQuadricDecimation::CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id)
       }
     }
 
-  this->Mesh->GetPointCells(pt1Id, this->CollapseCellIds);
-  this->Mesh->ResizeCellList(pt0Id, this->CollapseCellIds->GetNumberOfIds());
-  for (i=0; i < this->CollapseCellIds->GetNumberOfIds(); i++)
+  this->Mesh->GetPointCells(pt1Id, cellIds);
+  this->Mesh->ResizeCellList(pt0Id, cellIds->GetNumberOfIds());
+  for (i=0; i < cellIds->GetNumberOfIds(); i++)
     {
-    cellId = this->CollapseCellIds->GetId(i);
+    cellId = cellIds->GetId(i);
     this->Mesh->GetCellPoints(cellId, npts, pts);
     // making sure we don't already have the triangle we're about to
     // change this one to
@@ -1347,6 +1578,305 @@ void vtkQuadricDecimation::ComputeNumberOfComponents(void)
   vtkDebugMacro("Number of components: " << this->NumberOfComponents);
 }
 
+//----------------------------------------------------------------------------
+// Collapse edges in rounds until TargetReduction of the numTris input
+// triangles are deleted. Every round pops the cheapest edges from the queue
+// and accepts those whose neighborhoods (the triangles around both end
+// points) do not touch the neighborhood of an edge accepted before. The
+// accepted edges can then be collapsed concurrently, and the queue is
+// updated afterwards in the order they were popped.
+vtkIdType vtkQuadricDecimation::CollapseBatches(vtkIdType numTris)
+{
+  vtkIdType numPts = this->Mesh->GetNumberOfPoints();
+  vtkIdType numDeletedTris = 0, expectedTris, edgeId, maxEdgeId;
+  vtkIdType npts, *pts, *cells, i, k, numUpdated;
+  vtkIdType endPtIds[2];
+  unsigned short ncells, c;
+  int e, j, isFree, abort = 0, done = 0, round = 0;
+  double cost;
+  double target = this->TargetReduction * numTris;
+
+  // The points around the edges accepted in a round are stamped with the
+  // round number.
+  vtkstd::vector<int> stamp(numPts, 0);
+  vtkstd::vector<vtkIdType> batch;
+  vtkstd::vector<vtkIdType> deferred;
+  vtkstd::vector<double> deferredCosts;
+  vtkstd::vector<vtkIdType> deleted(VTK_QUADRIC_BATCH_SIZE);
+  vtkstd::vector<vtkIdList *> changed(VTK_QUADRIC_BATCH_SIZE);
+  vtkstd::vector<double> costs;
+  vtkIdList *updated = vtkIdList::New();
+  for (k = 0; k < VTK_QUADRIC_BATCH_SIZE; k++)
+    {
+    changed[k] = vtkIdList::New();
+    }
+
+  vtkQuadricDecimationThreads threads(this, this->NumberOfThreads,
+                                      this->NumberOfComponents);
+  threads.Counts = &deleted[0];
+  threads.Lists = &changed[0];
+
+  while ( !done && !abort && numDeletedTris < target )
+    {
+    // Select the edges of this round. Stop once collapsing them is
+    // expected to reach the target, so as not to overshoot it.
+    round++;
+    batch.clear();
+    deferred.clear();
+    deferredCosts.clear();
+    expectedTris = numDeletedTris;
+    for (k = 0; k < VTK_QUADRIC_BATCH_SIZE && expectedTris < target; k++)
+      {
+      edgeId = this->EdgeCosts->Pop(0, cost);
+      if (edgeId < 0)
+        {
+        done = 1;
+        break;
+        }
+      if (cost >= VTK_DOUBLE_MAX)
+        {
+        this->EdgeCosts->Insert(cost, edgeId);
+        done = batch.empty();
+        break;
+        }
+
+      endPtIds[0] = this->EndPoint1List->GetId(edgeId);
+      endPtIds[1] = this->EndPoint2List->GetId(edgeId);
+      isFree = (stamp[endPtIds[0]] != round && stamp[endPtIds[1]] != round);
+      for (e = 0; e < 2 && isFree; e++)
+        {
+        this->Mesh->GetPointCells(endPtIds[e], ncells, cells);
+        for (c = 0; c < ncells && isFree; c++)
+          {
+          this->Mesh->GetCellPoints(cells[c], npts, pts);
+          for (j = 0; j < npts; j++)
+            {
+            if (stamp[pts[j]] == round)
+              {
+              isFree = 0;
+              break;
+              }
+            }
+          }
+        }
+      if (!isFree)
+        {
+        deferred.push_back(edgeId);
+        deferredCosts.push_back(cost);
+        continue;
+        }
+
+      stamp[endPtIds[0]] = stamp[endPtIds[1]] = round;
+      for (e = 0; e < 2; e++)
+        {
+        this->Mesh->GetPointCells(endPtIds[e], ncells, cells);
+        for (c = 0; c < ncells; c++)
+          {
+          this->Mesh->GetCellPoints(cells[c], npts, pts);
+          for (j = 0; j < npts; j++)
+            {
+            stamp[pts[j]] = round;
+            if (e == 0 && pts[j] == endPtIds[1])
+              {
+              expectedTris++;
+              }
+            }
+          }
+        }
+      batch.push_back(edgeId);
+      }
+
+    // Deferred edges go back to the queue before the collapses update it.
+    for (k = 0; k < static_cast<vtkIdType>(deferred.size()); k++)
+      {
+      this->EdgeCosts->Insert(deferredCosts[k], deferred[k]);
+      }
+    if (batch.empty())
+      {
+      break;
+      }
+
+    // Collapse the accepted edges concurrently.
+    threads.Items = &batch[0];
+    threads.Execute(vtkQuadricDecimationThreads::COLLAPSE,
+                    static_cast<vtkIdType>(batch.size()),
+                    VTK_QUADRIC_MIN_COLLAPSES_PER_THREAD);
+
+    // Update the edge table and the queue in the order of the edges.
+    updated->Reset();
+    for (k = 0; k < static_cast<vtkIdType>(batch.size()); k++)
+      {
+      edgeId = batch[k];
+      if (deleted[k] < 0)
+        {
+        // return the edge to the queue but with the max cost so that
+        // when it is recomputed it will be reconsidered
+        this->EdgeCosts->Insert(VTK_DOUBLE_MAX, edgeId);
+        continue;
+        }
+      this->NumberOfEdgeCollapses++;
+      numDeletedTris += deleted[k];
+      this->RenameAffectedEdges(this->EndPoint1List->GetId(edgeId),
+                                this->EndPoint2List->GetId(edgeId),
+                                changed[k], updated);
+      }
+
+    // Compute the costs of the new and changed edges concurrently, then
+    // queue them in order.
+    numUpdated = updated->GetNumberOfIds();
+    if (numUpdated > 0)
+      {
+      maxEdgeId = this->Edges->GetNumberOfEdges() - 1;
+      if (maxEdgeId >= this->TargetPoints->GetNumberOfTuples())
+        {
+        this->TargetPoints->InsertTuple(maxEdgeId, this->TempX);
+        }
+      costs.resize(numUpdated);
+      threads.Items = updated->GetPointer(0);
+      threads.Values = &costs[0];
+      threads.Execute(vtkQuadricDecimationThreads::COSTS, numUpdated,
+                      VTK_QUADRIC_MIN_ITEMS_PER_THREAD);
+      for (i = 0; i < numUpdated; i++)
+        {
+        this->EdgeCosts->Insert(costs[i], updated->GetId(i));
+        }
+      }
+
+    this->ActualReduction = (double) numDeletedTris / numTris;
+    vtkDebugMacro(<<"Collapsed " << this->NumberOfEdgeCollapses
+                  << " edges in " << round << " rounds");
+    this->UpdateProgress (0.20 + 0.80*this->NumberOfEdgeCollapses/numPts);
+    abort = this->GetAbortExecute();
+    }
+
+  for (k = 0; k < VTK_QUADRIC_BATCH_SIZE; k++)
+    {
+    changed[k]->Delete();
+    }
+  updated->Delete();
+
+  return numDeletedTris;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkQuadricDecimation::ThreadedExecute(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkQuadricDecimationThreads *threads =
+    static_cast<vtkQuadricDecimationThreads *>(info->UserData);
+  vtkQuadricDecimation *self = threads->Filter;
+  vtkQuadricDecimationScratch &scratch = threads->Scratch[info->ThreadID];
+  int quadricSize = threads->QuadricSize;
+  vtkIdType numItems = threads->NumberOfItems;
+  vtkIdType begin, end, i, j, npts, *pts, edgeId, pt0Id, pt1Id;
+  double *quadric, *faceQuadric, cost;
+  int k;
+
+  // Every thread handles a contiguous range of the items.
+  begin = numItems * info->ThreadID / info->NumberOfThreads;
+  end = numItems * (info->ThreadID + 1) / info->NumberOfThreads;
+
+  switch (threads->Phase)
+    {
+    case vtkQuadricDecimationThreads::FACE_QUADRICS:
+      for (i = begin; i < end; i++)
+        {
+        if (!self->ComputeFaceQuadric(threads->First + i,
+                                      threads->Values + i * quadricSize))
+          {
+          scratch.Failures++;
+          }
+        }
+      break;
+
+    case vtkQuadricDecimationThreads::ADD_QUADRICS:
+      // Every thread owns a range of points and adds the quadrics of all
+      // the faces in the block to its own points.
+      begin = threads->NumberOfPoints * info->ThreadID /
+        info->NumberOfThreads;
+      end = threads->NumberOfPoints * (info->ThreadID + 1) /
+        info->NumberOfThreads;
+      for (i = 0; i < numItems; i++)
+        {
+        self->Mesh->GetCellPoints(threads->First + i, npts, pts);
+        faceQuadric = threads->Values + i * quadricSize;
+        for (j = 0; j < 3; j++)
+          {
+          if (pts[j] < begin || pts[j] >= end)
+            {
+            continue;
+            }
+          quadric = self->ErrorQuadrics[pts[j]].Quadric;
+          for (k = 0; k < quadricSize; k++)
+            {
+            quadric[k] += faceQuadric[k];
+            }
+          }
+        }
+      break;
+
+    case vtkQuadricDecimationThreads::BOUNDARY:
+      for (i = begin; i < end; i++)
+        {
+        self->Mesh->GetCellPoints(i, npts, pts);
+        threads->Flags[i] = 0;
+        for (k = 0; k < 3; k++)
+          {
+          self->Mesh->GetCellEdgeNeighbors(i, pts[k], pts[(k+1)%3],
+                                           scratch.CellIds);
+          if (scratch.CellIds->GetNumberOfIds() == 0)
+            {
+            threads->Flags[i] |= static_cast<unsigned char>(1 << k);
+            }
+          }
+        }
+      break;
+
+    case vtkQuadricDecimationThreads::COSTS:
+      for (i = begin; i < end; i++)
+        {
+        edgeId = (threads->Items ? threads->Items[i] : i);
+        if (self->AttributeErrorMetric)
+          {
+          cost = self->ComputeCost2(edgeId, &scratch.X[0], &scratch.Quad[0],
+                                    &scratch.A[0], &scratch.B[0]);
+          }
+        else
+          {
+          cost = self->ComputeCost(edgeId, &scratch.X[0], &scratch.Quad[0]);
+          }
+        threads->Values[i] = cost;
+        self->TargetPoints->SetTuple(edgeId, &scratch.X[0]);
+        }
+      break;
+
+    case vtkQuadricDecimationThreads::COLLAPSE:
+      for (i = begin; i < end; i++)
+        {
+        edgeId = threads->Items[i];
+        pt0Id = self->EndPoint1List->GetId(edgeId);
+        pt1Id = self->EndPoint2List->GetId(edgeId);
+        self->TargetPoints->GetTuple(edgeId, &scratch.X[0]);
+        threads->Lists[i]->Reset();
+        // check for a poorly placed point
+        if (!self->IsGoodPlacement(pt0Id, pt1Id, &scratch.X[0]))
+          {
+          threads->Counts[i] = -1;
+          continue;
+          }
+        self->SetPointAttributeArray(pt0Id, &scratch.X[0]);
+        self->AddQuadric(pt1Id, pt0Id);
+        self->FindAffectedEdges(pt0Id, pt1Id, threads->Lists[i]);
+        threads->Counts[i] = self->CollapseEdge(pt0Id, pt1Id,
+                                                scratch.CellIds);
+        }
+      break;
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 //----------------------------------------------------------------------------
 void vtkQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -1373,4 +1903,8 @@ void vtkQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Normals Weight: " << this->NormalsWeight << "\n";
   os << indent << "TCoords Weight: " << this->TCoordsWeight << "\n";
   os << indent << "Tensors Weight: " << this->TensorsWeight << "\n";
+
+  os << indent << "Batched Collapse: " 
+     << (this->BatchedCollapse ? "On\n" : "Off\n");
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 }
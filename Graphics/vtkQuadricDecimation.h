@@ -46,6 +46,11 @@
 // Attributes" is also a good take on the subject especially as it pertains
 // to the error metric applied to attributes.
 //
+// The quadrics, the boundary constraints and the initial edge costs are
+// computed by NumberOfThreads threads; this gives the same result as a
+// single thread. With BatchedCollapse on, the edges are also collapsed
+// concurrently, in rounds of edges whose neighborhoods do not overlap.
+//
 // .SECTION Thanks
 // Thanks to Bradley Lowekamp of the National Library of Medicine/NIH for
 // contributing this class.
@@ -119,6 +124,24 @@ public:
   vtkGetMacro(TCoordsWeight, double);
   vtkGetMacro(TensorsWeight, double);
   
+  // Description:
+  // Turn on/off batched edge collapses. If on, every round takes the
+  // cheapest edges from the priority queue, keeps those whose
+  // neighborhoods do not overlap the neighborhood of a cheaper one, and
+  // collapses them concurrently. The collapses then no longer follow the
+  // cost order strictly, so the result differs slightly from the one
+  // obtained with the option off. By default BatchedCollapse is off.
+  vtkSetMacro(BatchedCollapse, int);
+  vtkGetMacro(BatchedCollapse, int);
+  vtkBooleanMacro(BatchedCollapse, int);
+
+  // Description:
+  // Set/Get the number of threads used to compute the quadrics and edge
+  // costs, and to collapse batches of edges. The default is the global
+  // default number of threads of vtkMultiThreader.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
   // Description:
   // Get the actual reduction. This value is only valid after the
   // filter has executed.
@@ -134,6 +157,13 @@ protected:
   // Do the dirty work of eliminating the edge; return the number of
   // triangles deleted.
   int CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id);
+  int CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id, vtkIdList *cellIds);
+
+  // Description:
+  // Collapse edges in rounds of edges with disjoint neighborhoods until
+  // TargetReduction of the numTris input triangles have been deleted.
+  // Returns the number of triangles deleted.
+  vtkIdType CollapseBatches(vtkIdType numTris);
 
   // Description:
   // Compute quadric for all vertices
@@ -143,6 +173,11 @@ protected:
   // Free boundary edges are weighted
   void AddBoundaryConstraints(void);
 
+  // Description:
+  // Compute the quadric of a triangle, weighted by its area. Returns 0 if
+  // the attribute part could not be computed.
+  int ComputeFaceQuadric(vtkIdType cellId, double *QEM);
+
   // Description:
   // Compute quadric for this vertex.
   void ComputeQuadric(vtkIdType pointId);
@@ -158,6 +193,13 @@ protected:
   double ComputeCost(vtkIdType edgeId, double *x);
   double ComputeCost2(vtkIdType edgeId, double *x);
 
+  // Description:
+  // Same as above, with caller provided temporary storage so that
+  // several threads can compute costs at once.
+  double ComputeCost(vtkIdType edgeId, double *x, double *quad);
+  double ComputeCost2(vtkIdType edgeId, double *x, double *quad,
+                      double **A, double *b);
+
   // Description:
   // Find all edges that will have an endpoint change ids because of an edge
   // collapse.  p1Id and p2Id are the endpoints of the edge.  p2Id is the
@@ -173,6 +215,23 @@ protected:
                          const double t2[3],  const double *x);
   void ComputeNumberOfComponents(void);
   void UpdateEdgeData(vtkIdType ptoId, vtkIdType pt1Id);
+
+  // Description:
+  // Update the edge table for the edges in changedEdges, which are
+  // affected by collapsing pt1Id into pt0Id, and remove them from the
+  // priority queue. If updatedEdges is NULL, the costs of the new and
+  // changed edges are computed and queued right away; otherwise their ids
+  // are appended to updatedEdges.
+  void RenameAffectedEdges(vtkIdType pt0Id, vtkIdType pt1Id,
+                           vtkIdList *changedEdges, vtkIdList *updatedEdges);
+
+  // Description:
+  // Run one phase of the multithreaded work, see
+  // vtkQuadricDecimationThreads in the implementation.
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute(void *arg);
+  //BTX
+  friend class vtkQuadricDecimationThreads;
+  //ETX
   
   // Description:
   // Helper function to set and get the point and it's attributes as an array
@@ -200,6 +259,9 @@ protected:
   double TCoordsWeight;
   double TensorsWeight;
 
+  int BatchedCollapse;
+  int NumberOfThreads;
+
   int               NumberOfEdgeCollapses;
   vtkEdgeTable     *Edges;
   vtkIdList        *EndPoint1List;
@@ -0,0 +1,396 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLSDynaReaderThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the threaded state conversion of vtkLSDynaReader
+// .SECTION Description
+// Writes a d3plot database of hexahedra on a grid of nodes and of shells
+// on its bottom face, in the byte order of the machine and swapped, with
+// state values given by formulas.  The nodal and solid sections are larger
+// than a piece of the threaded conversion.  Both time steps of both files
+// are read with one and with four threads converting the state sections,
+// and the point and cell counts, the points and a few arrays of the solids
+// and shells must match the values written, which are those the reader
+// gave before the conversion was threaded.
+
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkLSDynaReader.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#include <stdio.h>
+
+static const int NX = 48;
+static const int NY = 40;
+static const int NZ = 38;
+static const int NumberOfNodes = NX*NY*NZ;
+static const int NumberOfSolids = (NX - 1)*(NY - 1)*(NZ - 1);
+static const int NumberOfShells = (NX - 1)*(NY - 1);
+static const int NumberOfSteps = 2;
+// stress and effective plastic strain
+static const int WordsPerSolid = 7;
+// three surfaces of stress and strain, the resultants, the thickness, two
+// element values and the internal energy
+static const int WordsPerShell = 33;
+
+//----------------------------------------------------------------------------
+// The values written to the database, all exact in single precision.
+static double NodeCoordinate(int i, int c)
+{
+  int ijk[3] = { i % NX, (i / NX) % NY, i / (NX*NY) };
+  return ijk[c];
+}
+
+static double NodePosition(int step, int i, int c)
+{
+  return NodeCoordinate(i, c) + 0.125*(step + 1)*(c + 1);
+}
+
+static double NodeVelocity(int step, int i, int c)
+{
+  return step + 0.5*c + (i % 1000);
+}
+
+static double ElementWord(int step, int e, int w)
+{
+  return 10.0*step + 0.0625*w + (e % 1000);
+}
+
+//----------------------------------------------------------------------------
+static void WriteWords(FILE *fp, const void *words, size_t numWords,
+                       int swap)
+{
+  if (!swap)
+    {
+    fwrite(words, 4, numWords, fp);
+    return;
+    }
+  const unsigned char *bytes = static_cast<const unsigned char *>(words);
+  for (size_t i = 0; i < numWords; i++, bytes += 4)
+    {
+    unsigned char swapped[4] = { bytes[3], bytes[2], bytes[1], bytes[0] };
+    fwrite(swapped, 1, 4, fp);
+    }
+}
+
+//----------------------------------------------------------------------------
+static int WriteDatabase(const char *fileName, int swap)
+{
+  FILE *fp = fopen(fileName, "wb");
+  if (!fp)
+    {
+    return 0;
+    }
+
+  // the control words, 64 of them
+  union { int i; float f; } header[64];
+  int i, c, w;
+  for (i = 0; i < 64; i++)
+    {
+    header[i].i = 0;
+    }
+  header[14].f = 960.0f; // version
+  header[15].i = 4;      // NDIM, unpacked connectivity
+  header[16].i = NumberOfNodes;
+  header[17].i = 6;      // ICODE
+  header[20].i = 1;      // IU, positions
+  header[21].i = 1;      // IV, velocities
+  header[23].i = NumberOfSolids;
+  header[24].i = 1;      // NUMMAT8
+  header[27].i = WordsPerSolid;
+  header[31].i = NumberOfShells;
+  header[32].i = 1;      // NUMMAT4
+  header[33].i = WordsPerShell;
+  header[36].i = 3;      // MAXINT, no deletion words
+  for (i = 43; i < 47; i++)
+    {
+    header[i].i = 1000; // IOSHL
+    }
+  WriteWords(fp, header, 64, swap);
+
+  // the geometry
+  vtkstd::vector<float> coordinates(3*NumberOfNodes);
+  for (i = 0; i < NumberOfNodes; i++)
+    {
+    for (c = 0; c < 3; c++)
+      {
+      coordinates[3*i + c] = static_cast<float>(NodeCoordinate(i, c));
+      }
+    }
+  WriteWords(fp, &coordinates[0], coordinates.size(), swap);
+  vtkstd::vector<int> solids;
+  vtkstd::vector<int> shells;
+  for (int k = 0; k < NZ - 1; k++)
+    {
+    for (int j = 0; j < NY - 1; j++)
+      {
+      for (i = 0; i < NX - 1; i++)
+        {
+        int n = i + NX*(j + NY*k) + 1;
+        int quad[4] = { n, n + 1, n + NX + 1, n + NX };
+        for (c = 0; c < 8; c++)
+          {
+          solids.push_back(quad[c % 4] + (c < 4 ? 0 : NX*NY));
+          }
+        solids.push_back(1);
+        if (k == 0)
+          {
+          shells.insert(shells.end(), quad, quad + 4);
+          shells.push_back(1);
+          }
+        }
+      }
+    }
+  WriteWords(fp, &solids[0], solids.size(), swap);
+  WriteWords(fp, &shells[0], shells.size(), swap);
+
+  // the states
+  for (int step = 0; step < NumberOfSteps; step++)
+    {
+    vtkstd::vector<float> state;
+    state.push_back(static_cast<float>(step));
+    for (i = 0; i < NumberOfNodes; i++)
+      {
+      for (c = 0; c < 3; c++)
+        {
+        state.push_back(static_cast<float>(NodePosition(step, i, c)));
+        }
+      }
+    for (i = 0; i < NumberOfNodes; i++)
+      {
+      for (c = 0; c < 3; c++)
+        {
+        state.push_back(static_cast<float>(NodeVelocity(step, i, c)));
+        }
+      }
+    for (i = 0; i < NumberOfSolids; i++)
+      {
+      for (w = 0; w < WordsPerSolid; w++)
+        {
+        state.push_back(static_cast<float>(ElementWord(step, i, w)));
+        }
+      }
+    for (i = 0; i < NumberOfShells; i++)
+      {
+      for (w = 0; w < WordsPerShell; w++)
+        {
+        state.push_back(static_cast<float>(ElementWord(step, i, w)));
+        }
+      }
+    WriteWords(fp, &state[0], state.size(), swap);
+    }
+
+  fclose(fp);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Collect the leaf data sets of a multiblock data set in order.
+static void GetLeaves(vtkMultiBlockDataSet *mb,
+                      vtkstd::vector<vtkDataSet *> &leaves)
+{
+  for (unsigned int i = 0; i < mb->GetNumberOfBlocks(); i++)
+    {
+    vtkDataObject *block = mb->GetBlock(i);
+    if (vtkMultiBlockDataSet::SafeDownCast(block))
+      {
+      GetLeaves(vtkMultiBlockDataSet::SafeDownCast(block), leaves);
+      }
+    else if (vtkDataSet::SafeDownCast(block))
+      {
+      leaves.push_back(vtkDataSet::SafeDownCast(block));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Check the components of an array of element values against the words
+// starting at firstWord.
+static int CheckElementArray(vtkDataSet *data, const char *name, int step,
+                             int firstWord, int numComp)
+{
+  vtkDataArray *array = data->GetCellData()->GetArray(name);
+  if (!array || array->GetNumberOfComponents() != numComp ||
+      array->GetNumberOfTuples() != data->GetNumberOfCells())
+    {
+    cerr << "Array " << name << " is missing.\n";
+    return 0;
+    }
+  for (vtkIdType e = 0; e < array->GetNumberOfTuples(); e++)
+    {
+    for (int c = 0; c < numComp; c++)
+      {
+      double expected = ElementWord(step, static_cast<int>(e), firstWord + c);
+      if (array->GetComponent(e, c) != expected)
+        {
+        cerr << "Array " << name << " has " << array->GetComponent(e, c)
+             << " instead of " << expected << " at element " << e
+             << ", component " << c << ".\n";
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+static int CheckNodes(vtkDataSet *data, int step)
+{
+  vtkPointSet *pointSet = vtkPointSet::SafeDownCast(data);
+  vtkDataArray *velocity = data->GetPointData()->GetArray("Velocity");
+  if (!pointSet || !pointSet->GetPoints() || !velocity ||
+      pointSet->GetNumberOfPoints() != NumberOfNodes ||
+      velocity->GetNumberOfTuples() != NumberOfNodes)
+    {
+    cerr << "The nodes are missing.\n";
+    return 0;
+    }
+  vtkPoints *points = pointSet->GetPoints();
+  for (int i = 0; i < NumberOfNodes; i++)
+    {
+    double *x = points->GetPoint(i);
+    for (int c = 0; c < 3; c++)
+      {
+      if (x[c] != NodePosition(step, i, c) ||
+          velocity->GetComponent(i, c) != NodeVelocity(step, i, c))
+        {
+        cerr << "Node " << i << " has another position or velocity.\n";
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+static int CheckOutput(vtkMultiBlockDataSet *output, int step)
+{
+  vtkstd::vector<vtkDataSet *> leaves;
+  GetLeaves(output, leaves);
+  vtkDataSet *solids = 0;
+  vtkDataSet *shells = 0;
+  for (size_t i = 0; i < leaves.size(); i++)
+    {
+    if (leaves[i]->GetCellData()->GetArray("InternalEnergy"))
+      {
+      shells = leaves[i];
+      }
+    else if (leaves[i]->GetNumberOfCells() > 0)
+      {
+      solids = leaves[i];
+      }
+    }
+  if (!solids || solids->GetNumberOfCells() != NumberOfSolids ||
+      !shells || shells->GetNumberOfCells() != NumberOfShells)
+    {
+    cerr << "The solids or shells are missing.\n";
+    return 0;
+    }
+  return CheckNodes(solids, step) && CheckNodes(shells, step) &&
+    CheckElementArray(solids, "Stress", step, 0, 6) &&
+    CheckElementArray(solids, "EffPlastStrn", step, 6, 1) &&
+    CheckElementArray(shells, "Stress", step, 0, 6) &&
+    CheckElementArray(shells, "StressOuterSurf", step, 14, 6) &&
+    CheckElementArray(shells, "BendingResultant", step, 21, 3) &&
+    CheckElementArray(shells, "Thickness", step, 29, 1) &&
+    CheckElementArray(shells, "InternalEnergy", step, 32, 1);
+}
+
+//----------------------------------------------------------------------------
+static vtkSmartPointer<vtkLSDynaReader> NewReader(const char *fileName,
+                                                  int numThreads)
+{
+  vtkSmartPointer<vtkLSDynaReader> reader =
+    vtkSmartPointer<vtkLSDynaReader>::New();
+  reader->SetFileName(fileName);
+  reader->SetNumberOfThreads(numThreads);
+  // the database has no deletion words to remove cells by
+  reader->RemoveDeletedCellsOff();
+  reader->UpdateInformation();
+  int i;
+  for (i = 0; i < reader->GetNumberOfPointArrays(); i++)
+    {
+    reader->SetPointArrayStatus(i, 1);
+    }
+  for (int cellType = 0; cellType < vtkLSDynaReader::NUM_CELL_TYPES;
+       cellType++)
+    {
+    for (i = 0; i < reader->GetNumberOfCellArrays(cellType); i++)
+      {
+      reader->SetCellArrayStatus(cellType, i, 1);
+      }
+    }
+  return reader;
+}
+
+//----------------------------------------------------------------------------
+int TestLSDynaReaderThreads(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string directory = tempDir;
+  delete [] tempDir;
+
+  int rval = 0;
+  for (int swap = 0; swap < 2; swap++)
+    {
+    // the reader looks for the file name with its family suffixes
+    vtkstd::string fileName = directory + (swap ?
+      "/TestLSDynaReaderThreadsSwapped.d3plot" :
+      "/TestLSDynaReaderThreads.d3plot");
+    if (!WriteDatabase(fileName.c_str(), swap))
+      {
+      cerr << "Could not write " << fileName.c_str() << ".\n";
+      return 1;
+      }
+    for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+      {
+      vtkSmartPointer<vtkLSDynaReader> reader =
+        NewReader(fileName.c_str(), numThreads);
+      if (reader->GetNumberOfTimeSteps() != NumberOfSteps ||
+          reader->GetNumberOfNodes() != NumberOfNodes)
+        {
+        cerr << "The database has " << reader->GetNumberOfTimeSteps()
+             << " time steps and " << reader->GetNumberOfNodes()
+             << " nodes.\n";
+        rval = 1;
+        continue;
+        }
+      for (int step = 0; step < NumberOfSteps; step++)
+        {
+        reader->SetTimeStep(step);
+        reader->Update();
+        if (!CheckOutput(reader->GetOutput(), step))
+          {
+          cerr << "Time step " << step << " of the "
+               << (swap ? "swapped" : "native") << " file read with "
+               << numThreads << " threads differs.\n";
+          rval = 1;
+          }
+        }
+      }
+    vtksys::SystemTools::RemoveFile(fileName.c_str());
+    }
+
+  return rval;
+}
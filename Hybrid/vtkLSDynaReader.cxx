@@ -94,6 +94,7 @@ typedef FILE* vtkLSDynaFile_t;
 #include <vtkInformationDoubleVectorKey.h>
 #include <vtkInformationVector.h>
 #include <vtkMultiBlockDataSet.h>
+#include <vtkMultiThreader.h>
 #include <vtkMultiThreshold.h>
 #include <vtkObjectFactory.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
@@ -407,6 +408,10 @@ public:
   int MarkTimeStep();
   int SkipWords( vtkIdType numWords );
   int BufferChunk( WordType wType, vtkIdType chunkSizeInWords );
+  /// Read words into a caller-supplied buffer without swapping them.
+  int ReadWords( unsigned char* buf, vtkIdType numWords );
+  /// Reverse the byte order of words in place.
+  static void SwapWords( unsigned char* buf, vtkIdType numWords, int wordSize );
 
   inline char* GetNextWordAsChars();
   inline double GetNextWordAsFloat();
@@ -433,6 +438,7 @@ public:
   vtkIdType GetCurrentFWord() const { return this->FWord; }
 
   int GetWordSize() const;
+  int GetSwapEndian() const { return this->SwapEndian; }
   // Reset erases all information about the current database.
   // It does not free memory allocated for the current chunk.
   void Reset();
@@ -746,20 +752,37 @@ int vtkLSDynaFamily::BufferChunk( WordType wType, vtkIdType chunkSizeInWords )
     this->Chunk = new unsigned char[ this->ChunkAlloc*this->WordSize ];
     }
 
+  this->ChunkValid = 0;
+  this->ChunkWord = 0;
+  int err = this->ReadWords( this->Chunk, chunkSizeInWords );
+  if ( err )
+    {
+    return err;
+    }
+  this->ChunkValid = chunkSizeInWords*this->WordSize;
+
+  // Currently, wType is unused, but if I ever have to support cray
+  // floating point types, this will need to be different
+  if ( this->SwapEndian && wType != vtkLSDynaFamily::Char )
+    {
+    vtkLSDynaFamily::SwapWords( this->Chunk, chunkSizeInWords, this->WordSize );
+    }
+
+  return 0;
+  }
+
+int vtkLSDynaFamily::ReadWords( unsigned char* buf, vtkIdType numWords )
+  {
   this->FWord = VTK_LSDYNA_TELL(this->FD);
 
   // Eventually, we must check the return value and see if the read
   // came up short (EOF). If it did, then we must advance to the next
   // file.
-  vtkIdType bytesLeft = chunkSizeInWords*this->WordSize;
+  vtkIdType bytesLeft = numWords*this->WordSize;
   vtkIdType bytesRead;
-  unsigned char* buf = this->Chunk;
-  this->ChunkValid = 0;
-  this->ChunkWord = 0;
   while ( bytesLeft )
     {
     bytesRead = VTK_LSDYNA_READ(this->FD,(void*) buf,bytesLeft);
-    this->ChunkValid += bytesRead;
     if ( bytesRead < bytesLeft )
       {
       if ( bytesRead <= 0 )
@@ -793,51 +816,49 @@ int vtkLSDynaFamily::BufferChunk( WordType wType, vtkIdType chunkSizeInWords )
     buf += bytesRead;
     }
 
-  if ( this->SwapEndian && wType != vtkLSDynaFamily::Char )
-    {
-    unsigned char tmp[4];
-    vtkIdType i;
-    unsigned char* cur = this->Chunk;
+  return 0;
+  }
+
+void vtkLSDynaFamily::SwapWords( unsigned char* buf, vtkIdType numWords, int wordSize )
+  {
+  unsigned char tmp[4];
+  vtkIdType i;
+  unsigned char* cur = buf;
 
-    // Currently, wType is unused, but if I ever have to support cray
-    // floating point types, this will need to be different
-    switch (this->WordSize)
+  switch (wordSize)
+    {
+  case 4:
+    for (i=0; i<numWords; ++i)
       {
-    case 4:
-      for (i=0; i<chunkSizeInWords; ++i)
-        {
-        tmp[0] = cur[0];
-        tmp[1] = cur[1];
-        cur[0] = cur[3];
-        cur[1] = cur[2];
-        cur[2] = tmp[1];
-        cur[3] = tmp[0];
-        cur += this->WordSize;
-        }
-      break;
-    case 8:
-    default:
-      for (i=0; i<chunkSizeInWords; ++i)
-        {
-        tmp[0] = cur[0];
-        tmp[1] = cur[1];
-        tmp[2] = cur[2];
-        tmp[3] = cur[3];
-        cur[0] = cur[7];
-        cur[1] = cur[6];
-        cur[2] = cur[5];
-        cur[3] = cur[4];
-        cur[4] = tmp[3];
-        cur[5] = tmp[2];
-        cur[6] = tmp[1];
-        cur[7] = tmp[0];
-        cur += this->WordSize;
-        }
-      break;
+      tmp[0] = cur[0];
+      tmp[1] = cur[1];
+      cur[0] = cur[3];
+      cur[1] = cur[2];
+      cur[2] = tmp[1];
+      cur[3] = tmp[0];
+      cur += 4;
       }
+    break;
+  case 8:
+  default:
+    for (i=0; i<numWords; ++i)
+      {
+      tmp[0] = cur[0];
+      tmp[1] = cur[1];
+      tmp[2] = cur[2];
+      tmp[3] = cur[3];
+      cur[0] = cur[7];
+      cur[1] = cur[6];
+      cur[2] = cur[5];
+      cur[3] = cur[4];
+      cur[4] = tmp[3];
+      cur[5] = tmp[2];
+      cur[6] = tmp[1];
+      cur[7] = tmp[0];
+      cur += 8;
+      }
+    break;
     }
-
-  return 0;
   }
 
 inline char* vtkLSDynaFamily::GetNextWordAsChars()
@@ -1498,6 +1519,7 @@ vtkLSDynaReader::vtkLSDynaReader()
   this->RemoveDeletedCells = 1;
   this->SplitByMaterialId = 0;
   this->InputDeck = 0;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
 
   this->OutputParticles = 0;
   this->OutputBeams = 0;
@@ -1524,6 +1546,7 @@ void vtkLSDynaReader::PrintSelf( ostream &os, vtkIndent indent )
   os << indent << "DeformedMesh: " << (this->DeformedMesh ? "On" : "Off") << endl;
   os << indent << "RemoveDeletedCells: " << (this->RemoveDeletedCells ? "On" : "Off") << endl;
   os << indent << "SplitByMaterialId: " << (this->SplitByMaterialId ? "On" : "Off") << endl;
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
   os << indent << "TimeStepRange: " << this->TimeStepRange[0] << ", " << this->TimeStepRange[1] << endl;
 
   if (this->P)
@@ -3970,21 +3993,183 @@ int vtkLSDynaReader::ReadDeletion()
 
 int vtkLSDynaReader::ReadDeletionArray( vtkDataArray* array, int& anyZeros )
 {
-  double val;
   anyZeros = 0;
   vtkIdType n = array->GetNumberOfTuples();
   vtkLSDynaReaderPrivate* p = this->P;
-  p->Fam.BufferChunk( vtkLSDynaFamily::Float, n );
-  for ( vtkIdType i=0; i<n; ++i )
+  // The array has the type of the words on disk, so read straight into it.
+  unsigned char* words = static_cast<unsigned char*>( array->GetVoidPointer( 0 ) );
+  if ( p->Fam.ReadWords( words, n ) )
+    {
+    return 1;
+    }
+  if ( p->Fam.GetSwapEndian() )
+    {
+    vtkLSDynaFamily::SwapWords( words, n, p->Fam.GetWordSize() );
+    }
+  for ( vtkIdType i=0; i<n && ! anyZeros; ++i )
     {
-    val = p->Fam.GetNextWordAsFloat();
-    if ( val == 0. )
+    if ( array->GetComponent( i, 0 ) == 0. )
       anyZeros = 1;
-    array->SetTuple1( i, val );
     }
   return 0;
 }
 
+// The state data of a time step is read one section at a time (a nodal
+// array, or the interleaved cell data of one cell type) with a single read
+// per section. The raw words are then byte-swapped and scattered into the
+// output arrays by several threads. Every tuple of a section spans
+// WordsPerTuple words; array a takes Components[a] of them starting at
+// Offsets[a] and pads any remaining components with zeros. When a section
+// maps one-to-one onto its only array, the words are read straight into
+// the array and only need swapping.
+struct vtkLSDynaStateSection
+{
+  unsigned char* Words;
+  int InPlace;
+  vtkIdType NumberOfTuples;
+  int WordsPerTuple;
+  vtkstd::vector<vtkDataArray*> Arrays;
+  vtkstd::vector<int> Offsets;
+  vtkstd::vector<int> Components;
+};
+
+struct vtkLSDynaStatePiece
+{
+  vtkLSDynaStateSection* Section;
+  vtkIdType Begin;
+  vtkIdType End;
+};
+
+struct vtkLSDynaStateThreadStruct
+{
+  vtkstd::vector<vtkLSDynaStatePiece> Pieces;
+  int WordSize;
+  int SwapEndian;
+};
+
+template <class T>
+static void vtkLSDynaScatterWords( const vtkLSDynaStatePiece& piece )
+{
+  const vtkLSDynaStateSection* sec = piece.Section;
+  for ( size_t a=0; a<sec->Arrays.size(); ++a )
+    {
+    int nc = sec->Arrays[a]->GetNumberOfComponents();
+    int nw = sec->Components[a];
+    // Some arrays claim more words than the element stores (e.g., beams
+    // with NV1D == 6); never read past the end of the tuple.
+    if ( nw > sec->WordsPerTuple - sec->Offsets[a] )
+      {
+      nw = sec->WordsPerTuple - sec->Offsets[a];
+      }
+    if ( nw < 0 )
+      {
+      nw = 0;
+      }
+    T* out = static_cast<T*>( sec->Arrays[a]->GetVoidPointer( 0 ) ) + piece.Begin*nc;
+    const T* in = reinterpret_cast<const T*>( sec->Words ) +
+      piece.Begin*sec->WordsPerTuple + sec->Offsets[a];
+    for ( vtkIdType e=piece.Begin; e<piece.End; ++e )
+      {
+      int c;
+      for ( c=0; c<nw; ++c )
+        {
+        out[c] = in[c];
+        }
+      for ( ; c<nc; ++c )
+        {
+        out[c] = 0;
+        }
+      out += nc;
+      in += sec->WordsPerTuple;
+      }
+    }
+}
+
+static VTK_THREAD_RETURN_TYPE vtkLSDynaConvertStateThread( void* arg )
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+  vtkLSDynaStateThreadStruct* str = static_cast<vtkLSDynaStateThreadStruct*>( info->UserData );
+  for ( size_t i=info->ThreadID; i<str->Pieces.size(); i+=info->NumberOfThreads )
+    {
+    const vtkLSDynaStatePiece& piece = str->Pieces[i];
+    const vtkLSDynaStateSection* sec = piece.Section;
+    if ( str->SwapEndian )
+      {
+      vtkLSDynaFamily::SwapWords(
+        sec->Words + piece.Begin*sec->WordsPerTuple*str->WordSize,
+        (piece.End - piece.Begin)*sec->WordsPerTuple, str->WordSize );
+      }
+    if ( sec->InPlace )
+      {
+      continue;
+      }
+    if ( str->WordSize == 4 )
+      {
+      vtkLSDynaScatterWords<float>( piece );
+      }
+    else
+      {
+      vtkLSDynaScatterWords<double>( piece );
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+static void vtkLSDynaFreeStateSections( vtkstd::vector<vtkLSDynaStateSection>& sections )
+{
+  for ( size_t i=0; i<sections.size(); ++i )
+    {
+    if ( ! sections[i].InPlace )
+      {
+      delete [] sections[i].Words;
+      }
+    }
+  sections.clear();
+}
+
+static void vtkLSDynaConvertStateSections(
+  vtkstd::vector<vtkLSDynaStateSection>& sections, vtkLSDynaFamily& fam, int numThreads )
+{
+  vtkLSDynaStateThreadStruct str;
+  str.WordSize = fam.GetWordSize();
+  str.SwapEndian = fam.GetSwapEndian();
+
+  // Split the sections into pieces small enough to balance the threads.
+  const vtkIdType pieceSize = 65536;
+  for ( size_t i=0; i<sections.size(); ++i )
+    {
+    vtkLSDynaStatePiece piece;
+    piece.Section = &sections[i];
+    if ( sections[i].InPlace && ! str.SwapEndian )
+      {
+      continue;
+      }
+    for ( piece.Begin=0; piece.Begin<sections[i].NumberOfTuples; piece.Begin=piece.End )
+      {
+      piece.End = piece.Begin + pieceSize;
+      if ( piece.End > sections[i].NumberOfTuples )
+        {
+        piece.End = sections[i].NumberOfTuples;
+        }
+      str.Pieces.push_back( piece );
+      }
+    }
+  if ( str.Pieces.empty() )
+    {
+    return;
+    }
+
+  if ( numThreads > static_cast<int>( str.Pieces.size() ) )
+    {
+    numThreads = static_cast<int>( str.Pieces.size() );
+    }
+  vtkMultiThreader* threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads( numThreads );
+  threader->SetSingleMethod( vtkLSDynaConvertStateThread, &str );
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
+
 int vtkLSDynaReader::ReadState( vtkIdType step )
 {
   vtkLSDynaReaderPrivate* p = this->P;
@@ -3995,6 +4180,7 @@ int vtkLSDynaReader::ReadState( vtkIdType step )
   vtkDataArray* var;
   vtkstd::vector<vtkDataArray*> vars;
   vtkstd::vector<int> cmps;
+  vtkstd::vector<vtkLSDynaStateSection> sections;
   // Important: push_back in the order these are interleaved on disk
   // Note that temperature and deflection are swapped relative to the order they
   // are specified in the header section.
@@ -4102,16 +4288,21 @@ int vtkLSDynaReader::ReadState( vtkIdType step )
         this->OutputThickShell->GetPointData()->AddArray( *arr );
         this->OutputSolid->GetPointData()->AddArray( *arr );
         (*arr)->FastDelete();
-        p->Fam.BufferChunk( vtkLSDynaFamily::Float, p->NumberOfNodes*(*arc) );
-        vtkIdType pt;
-        double tuple[3] = { 0., 0., 0. };
-        for ( pt=0; pt<p->NumberOfNodes; ++pt )
+        vtkLSDynaStateSection section;
+        section.NumberOfTuples = p->NumberOfNodes;
+        section.WordsPerTuple = *arc;
+        section.Arrays.push_back( *arr );
+        section.Offsets.push_back( 0 );
+        section.Components.push_back( *arc );
+        section.InPlace = ( (*arr)->GetNumberOfComponents() == *arc );
+        section.Words = section.InPlace ?
+          static_cast<unsigned char*>( (*arr)->GetVoidPointer( 0 ) ) :
+          new unsigned char[ p->NumberOfNodes*(*arc)*p->Fam.GetWordSize() ];
+        sections.push_back( section );
+        if ( p->Fam.ReadWords( section.Words, p->NumberOfNodes*(*arc) ) )
           {
-          for ( int c=0; c<*arc; ++c )
-            {
-            tuple[c] = p->Fam.GetNextWordAsFloat();
-            }
-          (*arr)->SetTuple( pt, tuple );
+          vtkLSDynaFreeStateSections( sections );
+          return 1;
           }
         if ( this->DeformedMesh && ! strcmp( (*arr)->GetName(), LS_ARRAYNAME_DEFLECTION) )
           {
@@ -4153,23 +4344,23 @@ int vtkLSDynaReader::ReadState( vtkIdType step )
   ts = numtuples; \
   if ( vars.size() != 0 ) \
     { \
-    double* tuple = new double[ ts ]; \
-    memset( tuple, 0, ts*sizeof(double*) ); \
-    \
-    for ( vtkIdType e=0; e<p->NumberOfCells[ celltype ]; ++e ) \
+    vtkLSDynaStateSection section; \
+    section.NumberOfTuples = p->NumberOfCells[ celltype ]; \
+    section.WordsPerTuple = ts; \
+    section.Arrays = vars; \
+    section.Offsets = cmps; \
+    for ( vtkstd::vector<vtkDataArray*>::iterator arr=vars.begin(); arr != vars.end(); ++arr ) \
       { \
-      p->Fam.BufferChunk( vtkLSDynaFamily::Float, ts ); \
-      for ( int i=0; i<ts; ++i ) \
-        { \
-        tuple[i] = p->Fam.GetNextWordAsFloat(); \
-        } \
-      vtkstd::vector<int>::iterator arc = cmps.begin(); \
-      for ( vtkstd::vector<vtkDataArray*>::iterator arr=vars.begin(); arr != vars.end(); ++arr, ++arc ) \
-        { \
-        (*arr)->SetTuple( e, tuple + *arc ); \
-        } \
+      section.Components.push_back( (*arr)->GetNumberOfComponents() ); \
+      } \
+    section.InPlace = 0; \
+    section.Words = new unsigned char[ section.NumberOfTuples*ts*p->Fam.GetWordSize() ]; \
+    sections.push_back( section ); \
+    if ( p->Fam.ReadWords( section.Words, section.NumberOfTuples*ts ) ) \
+      { \
+      vtkLSDynaFreeStateSections( sections ); \
+      return 1; \
       } \
-    delete [] tuple; \
     } \
   else \
     { \
@@ -4306,6 +4497,9 @@ int vtkLSDynaReader::ReadState( vtkIdType step )
 #undef VTK_LS_CELLARRAY
 #undef VTK_LS_READCELLS
 
+  vtkLSDynaConvertStateSections( sections, p->Fam, this->NumberOfThreads );
+  vtkLSDynaFreeStateSections( sections );
+
   return 0;
 }
 
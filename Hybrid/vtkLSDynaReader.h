@@ -444,6 +444,15 @@ public:
   vtkGetMacro(SplitByMaterialId,int);
   vtkBooleanMacro(SplitByMaterialId,int);
 
+  // Description:
+  // The number of threads used to byte-swap and convert the nodal and
+  // element state arrays of a time step once their words have been read.
+  // Each section of the state data is still read from disk in one
+  // sequential pass. By default, this is the global default number of
+  // threads of vtkMultiThreader.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
   // Description:
   // The name of the input deck corresponding to the current database.
   // This is used to determine the part names associated with each material ID.
@@ -497,6 +506,10 @@ protected:
   // Split each mesh into submeshes based on the material ID of each cell.
   int SplitByMaterialId;
 
+  // Description:
+  // Number of threads converting state data.
+  int NumberOfThreads;
+
   // Description:
   // The range of time steps available within a database.
   // Only valid after UpdateInformation() is called on the reader.
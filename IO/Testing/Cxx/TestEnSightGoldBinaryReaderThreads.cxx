@@ -0,0 +1,462 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestEnSightGoldBinaryReaderThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the threaded reading of vtkEnSightGoldBinaryReader
+// .SECTION Description
+// Writes binary EnSight Gold cases of three parts with a scalar and a
+// vector per node and a scalar per element, as C binary and as Fortran
+// records, in little and big endian byte order.  The third part mixes
+// quadrangles and triangles, so that the values per element are scattered
+// by element type.  Each case is read with one and with four threads, and
+// the points and variables of every part must match the values written.
+
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkEnSightGoldBinaryReader.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#include <stdio.h>
+#include <string.h>
+
+static const int NumberOfParts = 3;
+static const char *VariableFiles[3] = { ".temp", ".vel", ".pres" };
+
+//----------------------------------------------------------------------------
+// The parts are grids of NX by NY by NZ points: part 1 is triangulated,
+// part 2 is made of hexahedra and part 3 has quadrangles in its first rows
+// and triangles in the others.
+static const int PartDimensions[NumberOfParts][3] =
+  { { 40, 30, 1 }, { 6, 5, 4 }, { 25, 20, 1 } };
+static const int QuadRows = 7;
+
+struct Section
+{
+  const char *Type;
+  int NodesPerElement;
+  vtkstd::vector<int> Connectivity;
+};
+
+static int NumberOfPoints(int part)
+{
+  const int *dims = PartDimensions[part];
+  return dims[0]*dims[1]*dims[2];
+}
+
+static void GetSections(int part, vtkstd::vector<Section> &sections)
+{
+  const int *dims = PartDimensions[part];
+  int nx = dims[0];
+  sections.clear();
+  if (part == 1)
+    {
+    Section hexa;
+    hexa.Type = "hexa8";
+    hexa.NodesPerElement = 8;
+    for (int k = 0; k < dims[2] - 1; k++)
+      {
+      for (int j = 0; j < dims[1] - 1; j++)
+        {
+        for (int i = 0; i < nx - 1; i++)
+          {
+          int n = i + nx*(j + dims[1]*k) + 1;
+          int quad[4] = { n, n + 1, n + nx + 1, n + nx };
+          for (int c = 0; c < 8; c++)
+            {
+            hexa.Connectivity.push_back(
+              quad[c % 4] + (c < 4 ? 0 : nx*dims[1]));
+            }
+          }
+        }
+      }
+    sections.push_back(hexa);
+    return;
+    }
+  Section quads;
+  quads.Type = "quad4";
+  quads.NodesPerElement = 4;
+  Section triangles;
+  triangles.Type = "tria3";
+  triangles.NodesPerElement = 3;
+  for (int j = 0; j < dims[1] - 1; j++)
+    {
+    for (int i = 0; i < nx - 1; i++)
+      {
+      int n = i + nx*j + 1;
+      int quad[4] = { n, n + 1, n + nx + 1, n + nx };
+      if (part == 2 && j < QuadRows)
+        {
+        quads.Connectivity.insert(quads.Connectivity.end(), quad, quad + 4);
+        }
+      else
+        {
+        int tria[6] = { quad[0], quad[1], quad[2], quad[0], quad[2], quad[3] };
+        triangles.Connectivity.insert(triangles.Connectivity.end(),
+                                      tria, tria + 6);
+        }
+      }
+    }
+  if (!quads.Connectivity.empty())
+    {
+    sections.push_back(quads);
+    }
+  sections.push_back(triangles);
+}
+
+//----------------------------------------------------------------------------
+// The values written, all exact in single precision.  The elements of a
+// part are numbered in the order of the file, which is the order of the
+// cells of the output.
+static double Coordinate(int part, int i, int c)
+{
+  const int *dims = PartDimensions[part];
+  int ijk[3] = { i % dims[0], (i / dims[0]) % dims[1],
+                 i / (dims[0]*dims[1]) };
+  return 0.5*ijk[c] + 100.0*part;
+}
+
+static double NodeValue(int part, int i, int c)
+{
+  return 1000.0*part + 0.25*i + 0.125*c;
+}
+
+static double ElementValue(int part, int i)
+{
+  return -1000.0*part - 0.5*i;
+}
+
+//----------------------------------------------------------------------------
+// Writes the records of a binary EnSight file.
+class Writer
+{
+public:
+  Writer(const vtkstd::string &fileName, int fortran, int bigEndian)
+    {
+    this->File = fopen(fileName.c_str(), "wb");
+    this->Fortran = fortran;
+    this->BigEndian = bigEndian;
+    }
+  ~Writer()
+    {
+    if (this->File)
+      {
+      fclose(this->File);
+      }
+    }
+  void WriteString(const char *text)
+    {
+    char line[80];
+    memset(line, 0, 80);
+    strncpy(line, text, 79);
+    this->WriteRecord(line, 80, 0);
+    }
+  void WriteInts(const int *values, int n)
+    {
+    this->WriteRecord(values, n, 1);
+    }
+  void WriteFloats(const vtkstd::vector<float> &values)
+    {
+    this->WriteRecord(&values[0], static_cast<int>(values.size()), 1);
+    }
+
+  FILE *File;
+
+private:
+  void WriteWord(const void *word)
+    {
+    const unsigned char *bytes = static_cast<const unsigned char *>(word);
+    unsigned char swapped[4];
+    int native = 1;
+    int littleEndian = *reinterpret_cast<char *>(&native) == 1;
+    for (int b = 0; b < 4; b++)
+      {
+      swapped[b] = bytes[littleEndian == !this->BigEndian ? b : 3 - b];
+      }
+    fwrite(swapped, 1, 4, this->File);
+    }
+  void WriteLength(int length)
+    {
+    if (this->Fortran)
+      {
+      this->WriteWord(&length);
+      }
+    }
+  // Write n words, or n bytes if words is 0, as one record.
+  void WriteRecord(const void *data, int n, int words)
+    {
+    this->WriteLength(words ? 4*n : n);
+    if (words)
+      {
+      const char *bytes = static_cast<const char *>(data);
+      for (int i = 0; i < n; i++)
+        {
+        this->WriteWord(bytes + 4*i);
+        }
+      }
+    else
+      {
+      fwrite(data, 1, n, this->File);
+      }
+    this->WriteLength(words ? 4*n : n);
+    }
+
+  int Fortran;
+  int BigEndian;
+};
+
+//----------------------------------------------------------------------------
+static int WriteCase(const vtkstd::string &prefix, const char *name,
+                     int fortran, int bigEndian)
+{
+  FILE *fp = fopen((prefix + ".case").c_str(), "w");
+  if (!fp)
+    {
+    return 0;
+    }
+  fprintf(fp, "FORMAT\ntype: ensight gold\n\nGEOMETRY\nmodel: %s.geo\n\n"
+          "VARIABLE\nscalar per node: temperature %s%s\n"
+          "vector per node: velocity %s%s\n"
+          "scalar per element: pressure %s%s\n", name,
+          name, VariableFiles[0], name, VariableFiles[1], name,
+          VariableFiles[2]);
+  fclose(fp);
+
+  Writer geometry(prefix + ".geo", fortran, bigEndian);
+  Writer temperature(prefix + VariableFiles[0], fortran, bigEndian);
+  Writer velocity(prefix + VariableFiles[1], fortran, bigEndian);
+  Writer pressure(prefix + VariableFiles[2], fortran, bigEndian);
+  if (!geometry.File || !temperature.File || !velocity.File ||
+      !pressure.File)
+    {
+    return 0;
+    }
+  geometry.WriteString(fortran ? "Fortran Binary" : "C Binary");
+  geometry.WriteString("TestEnSightGoldBinaryReaderThreads");
+  geometry.WriteString("geometry");
+  geometry.WriteString("node id off");
+  geometry.WriteString("element id off");
+  temperature.WriteString("temperature");
+  velocity.WriteString("velocity");
+  pressure.WriteString("pressure");
+
+  vtkstd::vector<float> values;
+  for (int part = 0; part < NumberOfParts; part++)
+    {
+    int partId = part + 1;
+    int numPts = NumberOfPoints(part);
+    geometry.WriteString("part");
+    geometry.WriteInts(&partId, 1);
+    geometry.WriteString("grid");
+    geometry.WriteString("coordinates");
+    geometry.WriteInts(&numPts, 1);
+    temperature.WriteString("part");
+    temperature.WriteInts(&partId, 1);
+    temperature.WriteString("coordinates");
+    velocity.WriteString("part");
+    velocity.WriteInts(&partId, 1);
+    velocity.WriteString("coordinates");
+    for (int c = 0; c < 3; c++)
+      {
+      values.resize(numPts);
+      int i;
+      for (i = 0; i < numPts; i++)
+        {
+        values[i] = static_cast<float>(Coordinate(part, i, c));
+        }
+      geometry.WriteFloats(values);
+      for (i = 0; i < numPts; i++)
+        {
+        values[i] = static_cast<float>(NodeValue(part, i, c));
+        }
+      velocity.WriteFloats(values);
+      if (c == 0)
+        {
+        temperature.WriteFloats(values);
+        }
+      }
+
+    vtkstd::vector<Section> sections;
+    GetSections(part, sections);
+    pressure.WriteString("part");
+    pressure.WriteInts(&partId, 1);
+    int numCells = 0;
+    for (size_t s = 0; s < sections.size(); s++)
+      {
+      const Section &section = sections[s];
+      int numElements = static_cast<int>(section.Connectivity.size()) /
+        section.NodesPerElement;
+      geometry.WriteString(section.Type);
+      geometry.WriteInts(&numElements, 1);
+      geometry.WriteInts(&section.Connectivity[0],
+                         static_cast<int>(section.Connectivity.size()));
+      pressure.WriteString(section.Type);
+      values.resize(numElements);
+      for (int i = 0; i < numElements; i++)
+        {
+        values[i] = static_cast<float>(ElementValue(part, numCells + i));
+        }
+      pressure.WriteFloats(values);
+      numCells += numElements;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+static int CheckArray(vtkDataArray *array, int numTuples, int numComp,
+                      const char *name, int part)
+{
+  if (!array || array->GetNumberOfTuples() != numTuples ||
+      array->GetNumberOfComponents() != numComp)
+    {
+    cerr << "Part " << part + 1 << " has no " << name << ".\n";
+    return 0;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+static int CheckOutput(vtkMultiBlockDataSet *output)
+{
+  if (output->GetNumberOfBlocks() != NumberOfParts)
+    {
+    cerr << "Read " << output->GetNumberOfBlocks() << " parts.\n";
+    return 0;
+    }
+  for (int part = 0; part < NumberOfParts; part++)
+    {
+    vtkUnstructuredGrid *grid =
+      vtkUnstructuredGrid::SafeDownCast(output->GetBlock(part));
+    int numPts = NumberOfPoints(part);
+    vtkstd::vector<Section> sections;
+    GetSections(part, sections);
+    int numCells = 0;
+    size_t s;
+    for (s = 0; s < sections.size(); s++)
+      {
+      numCells += static_cast<int>(sections[s].Connectivity.size()) /
+        sections[s].NodesPerElement;
+      }
+    if (!grid || grid->GetNumberOfPoints() != numPts ||
+        grid->GetNumberOfCells() != numCells)
+      {
+      cerr << "Part " << part + 1 << " has the wrong geometry.\n";
+      return 0;
+      }
+    vtkDataArray *temperature = grid->GetPointData()->GetArray("temperature");
+    vtkDataArray *velocity = grid->GetPointData()->GetArray("velocity");
+    vtkDataArray *pressure = grid->GetCellData()->GetArray("pressure");
+    if (!CheckArray(temperature, numPts, 1, "temperature", part) ||
+        !CheckArray(velocity, numPts, 3, "velocity", part) ||
+        !CheckArray(pressure, numCells, 1, "pressure", part))
+      {
+      return 0;
+      }
+    int i;
+    for (i = 0; i < numPts; i++)
+      {
+      double *x = grid->GetPoint(i);
+      for (int c = 0; c < 3; c++)
+        {
+        if (x[c] != Coordinate(part, i, c) ||
+            velocity->GetComponent(i, c) != NodeValue(part, i, c) ||
+            (c == 0 && temperature->GetComponent(i, 0) !=
+             NodeValue(part, i, 0)))
+          {
+          cerr << "Point " << i << " of part " << part + 1
+               << " has other values.\n";
+          return 0;
+          }
+        }
+      }
+    for (i = 0; i < numCells; i++)
+      {
+      if (pressure->GetComponent(i, 0) != ElementValue(part, i))
+        {
+        cerr << "Cell " << i << " of part " << part + 1 << " has pressure "
+             << pressure->GetComponent(i, 0) << " instead of "
+             << ElementValue(part, i) << ".\n";
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int TestEnSightGoldBinaryReaderThreads(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string directory = tempDir;
+  delete [] tempDir;
+  const char *name = "TestEnSightGoldBinaryReaderThreads";
+  vtkstd::string prefix = directory + "/" + name;
+
+  int rval = 0;
+  vtkSmartPointer<vtkEnSightGoldBinaryReader> reader =
+    vtkSmartPointer<vtkEnSightGoldBinaryReader>::New();
+  if (reader->GetNumberOfThreads() !=
+      vtkMultiThreader::GetGlobalDefaultNumberOfThreads())
+    {
+    cerr << "The default number of threads is "
+         << reader->GetNumberOfThreads() << ".\n";
+    rval = 1;
+    }
+
+  for (int fortran = 0; fortran < 2; fortran++)
+    {
+    for (int bigEndian = 0; bigEndian < 2; bigEndian++)
+      {
+      if (!WriteCase(prefix, name, fortran, bigEndian))
+        {
+        cerr << "Could not write the case.\n";
+        return 1;
+        }
+      for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+        {
+        reader = vtkSmartPointer<vtkEnSightGoldBinaryReader>::New();
+        reader->SetFilePath(directory.c_str());
+        reader->SetCaseFileName((vtkstd::string(name) + ".case").c_str());
+        reader->SetNumberOfThreads(numThreads);
+        reader->Update();
+        if (!CheckOutput(reader->GetOutput()))
+          {
+          cerr << "The " << (fortran ? "Fortran" : "C") << " binary, "
+               << (bigEndian ? "big" : "little") << " endian case read with "
+               << numThreads << " threads differs.\n";
+          rval = 1;
+          }
+        }
+      }
+    }
+
+  vtksys::SystemTools::RemoveFile((prefix + ".case").c_str());
+  vtksys::SystemTools::RemoveFile((prefix + ".geo").c_str());
+  for (int v = 0; v < 3; v++)
+    {
+    vtksys::SystemTools::RemoveFile((prefix + VariableFiles[v]).c_str());
+    }
+
+  return rval;
+}
@@ -0,0 +1,362 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestEnSightReaderCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the vtkDataArrayCache in vtkEnSightReader
+// .SECTION Description
+// Writes an ASCII EnSight Gold case of two parts, a triangle mesh and a
+// hexahedron, with a scalar and a vector per node and a scalar per
+// element.  With the global array cache enabled the case is read, which
+// must give the written values, then the variable files are rewritten with
+// the values of each part reversed and given back their modification
+// times.  The next update must restore the arrays of both parts from the
+// cached manifests, with their attribute roles, in arrays independent of
+// the earlier outputs and of the cache.  With the cache disabled the
+// reversed values must be read.
+
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataArrayCache.h"
+#include "vtkDataSet.h"
+#include "vtkEnSightGoldReader.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#if defined(_WIN32)
+# include <sys/utime.h>
+#else
+# include <utime.h>
+#endif
+
+typedef vtkstd::vector<vtkSmartPointer<vtkDataArray> > ArrayList;
+
+// the triangles of part 1 fill a grid of 4 x 3 points, part 2 is a cube
+static const int NumberOfPoints[2] = { 12, 8 };
+static const int NumberOfCells[2] = { 12, 1 };
+static const char *VariableFiles[3] = { ".temp", ".vel", ".pres" };
+
+//----------------------------------------------------------------------------
+// The values of the variables; the rewritten files reverse the order of
+// the values of each part.
+static double NodeValue(int version, int part, int i, int component)
+{
+  int j = version ? NumberOfPoints[part] - 1 - i : i;
+  return 1.0 + component + 0.25*j + 10.0*part;
+}
+
+static double ElementValue(int version, int part, int i)
+{
+  int j = version ? NumberOfCells[part] - 1 - i : i;
+  return 3.0 + 0.75*j + 10.0*part;
+}
+
+//----------------------------------------------------------------------------
+static void WriteGeometry(const vtkstd::string &prefix)
+{
+  FILE *fp = fopen((prefix + ".geo").c_str(), "w");
+  if (!fp)
+    {
+    return;
+    }
+  fprintf(fp, "TestEnSightReaderCache geometry\nASCII\n"
+          "node id off\nelement id off\n");
+
+  fprintf(fp, "part\n%10d\ntriangles\ncoordinates\n%10d\n", 1,
+          NumberOfPoints[0]);
+  int i, j, c;
+  for (c = 0; c < 3; c++)
+    {
+    for (i = 0; i < NumberOfPoints[0]; i++)
+      {
+      double x[3] = { i % 4, i / 4, 0.0 };
+      fprintf(fp, "%12.5e\n", x[c]);
+      }
+    }
+  fprintf(fp, "tria3\n%10d\n", NumberOfCells[0]);
+  for (j = 0; j < 2; j++)
+    {
+    for (i = 0; i < 3; i++)
+      {
+      int id = 4*j + i + 1;
+      fprintf(fp, "%10d%10d%10d\n", id, id + 1, id + 5);
+      fprintf(fp, "%10d%10d%10d\n", id, id + 5, id + 4);
+      }
+    }
+
+  fprintf(fp, "part\n%10d\ncube\ncoordinates\n%10d\n", 2,
+          NumberOfPoints[1]);
+  static const int cube[8][3] = { {0, 0, 0}, {1, 0, 0}, {1, 1, 0},
+    {0, 1, 0}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1} };
+  for (c = 0; c < 3; c++)
+    {
+    for (i = 0; i < 8; i++)
+      {
+      fprintf(fp, "%12.5e\n", cube[i][c] + (c == 0 ? 5.0 : 0.0));
+      }
+    }
+  fprintf(fp, "hexa8\n%10d\n", NumberOfCells[1]);
+  fprintf(fp, "%10d%10d%10d%10d%10d%10d%10d%10d\n", 1, 2, 3, 4, 5, 6, 7, 8);
+  fclose(fp);
+}
+
+//----------------------------------------------------------------------------
+// Write the variable files, all with the same length for both versions.
+static void WriteVariables(const vtkstd::string &prefix, int version)
+{
+  static const char *elementTypes[2] = { "tria3", "hexa8" };
+  for (int v = 0; v < 3; v++)
+    {
+    FILE *fp = fopen((prefix + VariableFiles[v]).c_str(), "w");
+    if (!fp)
+      {
+      return;
+      }
+    fprintf(fp, "TestEnSightReaderCache variable\n");
+    for (int part = 0; part < 2; part++)
+      {
+      fprintf(fp, "part\n%10d\n", part + 1);
+      if (v < 2)
+        {
+        fprintf(fp, "coordinates\n");
+        for (int c = 0; c < (v == 0 ? 1 : 3); c++)
+          {
+          for (int i = 0; i < NumberOfPoints[part]; i++)
+            {
+            fprintf(fp, "%12.5e\n", NodeValue(version, part, i, c));
+            }
+          }
+        }
+      else
+        {
+        fprintf(fp, "%s\n", elementTypes[part]);
+        for (int i = 0; i < NumberOfCells[part]; i++)
+          {
+          fprintf(fp, "%12.5e\n", ElementValue(version, part, i));
+          }
+        }
+      }
+    fclose(fp);
+    }
+}
+
+//----------------------------------------------------------------------------
+static void WriteCase(const vtkstd::string &prefix, const char *name)
+{
+  FILE *fp = fopen((prefix + ".case").c_str(), "w");
+  if (!fp)
+    {
+    return;
+    }
+  fprintf(fp, "FORMAT\ntype: ensight gold\n\nGEOMETRY\nmodel: %s.geo\n\n"
+          "VARIABLE\nscalar per node: temperature %s%s\n"
+          "vector per node: velocity %s%s\n"
+          "scalar per element: pressure %s%s\n", name,
+          name, VariableFiles[0], name, VariableFiles[1], name,
+          VariableFiles[2]);
+  fclose(fp);
+  WriteGeometry(prefix);
+}
+
+//----------------------------------------------------------------------------
+// Check the arrays of both parts against the values of a version of the
+// files.  Keep them in the list of arrays handed out, none of which may be
+// handed out again.
+static int CheckOutput(vtkEnSightReader *reader, int version,
+                       ArrayList &handedOut)
+{
+  vtkMultiBlockDataSet *output = reader->GetOutput();
+  if (output->GetNumberOfBlocks() != 2)
+    {
+    cerr << "Read " << output->GetNumberOfBlocks() << " parts.\n";
+    return 0;
+    }
+  for (int part = 0; part < 2; part++)
+    {
+    vtkDataSet *block = vtkDataSet::SafeDownCast(output->GetBlock(part));
+    if (!block || block->GetNumberOfPoints() != NumberOfPoints[part] ||
+        block->GetNumberOfCells() != NumberOfCells[part])
+      {
+      cerr << "Part " << part + 1 << " has the wrong geometry.\n";
+      return 0;
+      }
+    vtkPointData *pd = block->GetPointData();
+    vtkCellData *cd = block->GetCellData();
+    vtkDataArray *arrays[3] = { pd->GetArray("temperature"),
+      pd->GetArray("velocity"), cd->GetArray("pressure") };
+    if (!arrays[0] || !arrays[1] || !arrays[2] ||
+        arrays[0]->GetNumberOfTuples() != NumberOfPoints[part] ||
+        arrays[1]->GetNumberOfTuples() != NumberOfPoints[part] ||
+        arrays[1]->GetNumberOfComponents() != 3 ||
+        arrays[2]->GetNumberOfTuples() != NumberOfCells[part])
+      {
+      cerr << "The arrays of part " << part + 1 << " are missing.\n";
+      return 0;
+      }
+    if (pd->GetScalars() != arrays[0] || pd->GetVectors() != arrays[1] ||
+        cd->GetScalars() != arrays[2])
+      {
+      cerr << "The attributes of part " << part + 1 << " are not set.\n";
+      return 0;
+      }
+    for (int i = 0; i < NumberOfPoints[part]; i++)
+      {
+      for (int c = 0; c < 3; c++)
+        {
+        if ((c == 0 && arrays[0]->GetComponent(i, 0) !=
+             static_cast<float>(NodeValue(version, part, i, 0))) ||
+            arrays[1]->GetComponent(i, c) !=
+            static_cast<float>(NodeValue(version, part, i, c)))
+          {
+          cerr << "The point values of part " << part + 1
+               << " differ at point " << i << ".\n";
+          return 0;
+          }
+        }
+      }
+    for (int i = 0; i < NumberOfCells[part]; i++)
+      {
+      if (arrays[2]->GetComponent(i, 0) !=
+          static_cast<float>(ElementValue(version, part, i)))
+        {
+        cerr << "The cell values of part " << part + 1
+             << " differ at cell " << i << ".\n";
+        return 0;
+        }
+      }
+    for (int k = 0; k < 3; k++)
+      {
+      for (size_t p = 0; p < handedOut.size(); p++)
+        {
+        if (handedOut[p] == arrays[k])
+          {
+          cerr << "Array " << arrays[k]->GetName() << " of part " << part + 1
+               << " was handed out twice.\n";
+          return 0;
+          }
+        }
+      handedOut.push_back(arrays[k]);
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int TestEnSightReaderCache(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string directory = tempDir;
+  delete [] tempDir;
+  const char *name = "TestEnSightReaderCache";
+  vtkstd::string prefix = directory + "/" + name;
+  WriteCase(prefix, name);
+  WriteVariables(prefix, 0);
+
+  vtkDataArrayCache *cache = vtkDataArrayCache::GetGlobalCache();
+  double capacity = cache->GetCapacity();
+  cache->SetCapacity(16.0);
+
+  vtkSmartPointer<vtkEnSightGoldReader> reader =
+    vtkSmartPointer<vtkEnSightGoldReader>::New();
+  reader->SetFilePath(directory.c_str());
+  reader->SetCaseFileName((vtkstd::string(name) + ".case").c_str());
+  reader->Update();
+
+  int rval = 0;
+  ArrayList handedOut;
+  if (!CheckOutput(reader, 0, handedOut))
+    {
+    cerr << "The first read gave other values.\n";
+    rval = 1;
+    }
+  // each variable has an array per part and a manifest
+  if (cache->GetNumberOfEntries() != 9)
+    {
+    cerr << "The cache has " << cache->GetNumberOfEntries()
+         << " entries instead of 9.\n";
+    rval = 1;
+    }
+
+  // the same lines in another order, with the times of the first files
+  vtkstd::vector<long int> modifiedTimes;
+  vtkstd::vector<unsigned long> lengths;
+  int v;
+  for (v = 0; v < 3; v++)
+    {
+    vtkstd::string fileName = prefix + VariableFiles[v];
+    modifiedTimes.push_back(
+      vtksys::SystemTools::ModifiedTime(fileName.c_str()));
+    lengths.push_back(vtksys::SystemTools::FileLength(fileName.c_str()));
+    }
+  WriteVariables(prefix, 1);
+  for (v = 0; v < 3; v++)
+    {
+    vtkstd::string fileName = prefix + VariableFiles[v];
+    struct utimbuf times;
+    times.actime = modifiedTimes[v];
+    times.modtime = modifiedTimes[v];
+    utime(fileName.c_str(), &times);
+    if (vtksys::SystemTools::FileLength(fileName.c_str()) != lengths[v])
+      {
+      cerr << "The rewritten " << fileName.c_str()
+           << " has another length.\n";
+      rval = 1;
+      }
+    }
+
+  // twice, modifying the output in between, which must not modify the
+  // cache
+  for (int i = 0; i < 2; i++)
+    {
+    vtkDataSet *block =
+      vtkDataSet::SafeDownCast(reader->GetOutput()->GetBlock(0));
+    block->GetPointData()->GetArray("temperature")->FillComponent(0, -1.0);
+    block->GetCellData()->GetArray("pressure")->FillComponent(0, -1.0);
+    reader->Modified();
+    reader->Update();
+    if (!CheckOutput(reader, 0, handedOut))
+      {
+      cerr << "Update " << i + 2 << " did not restore the cached arrays.\n";
+      rval = 1;
+      }
+    }
+
+  // without the cache the reversed values are read
+  cache->SetCapacity(0.0);
+  reader->Modified();
+  reader->Update();
+  if (!CheckOutput(reader, 1, handedOut))
+    {
+    cerr << "The rewritten files were not read without the cache.\n";
+    rval = 1;
+    }
+
+  cache->SetCapacity(capacity);
+  vtksys::SystemTools::RemoveFile((prefix + ".case").c_str());
+  vtksys::SystemTools::RemoveFile((prefix + ".geo").c_str());
+  for (v = 0; v < 3; v++)
+    {
+    vtksys::SystemTools::RemoveFile((prefix + VariableFiles[v]).c_str());
+    }
+
+  return rval;
+}
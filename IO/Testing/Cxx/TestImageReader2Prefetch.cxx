@@ -0,0 +1,121 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageReader2Prefetch.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkImageReader2 read-ahead while streaming
+// .SECTION Description
+// Writes a raw volume, then streams it back through a smoothing filter
+// with read-ahead enabled, checks that the pieces were read from the data
+// read ahead and compares against an unstreamed read.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageDataStreamer.h"
+#include "vtkImageGaussianSmooth.h"
+#include "vtkImageReader2.h"
+#include "vtkImageSinusoidSource.h"
+#include "vtkImageWriter.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <vtkstd/string>
+
+int TestImageReader2Prefetch(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string fileName = tempDir;
+  fileName += "/TestImageReader2Prefetch.raw";
+  delete [] tempDir;
+
+  vtkSmartPointer<vtkImageSinusoidSource> source =
+    vtkSmartPointer<vtkImageSinusoidSource>::New();
+  source->SetWholeExtent(0, 63, 0, 47, 0, 39);
+  source->SetPeriod(16.0);
+
+  vtkSmartPointer<vtkImageWriter> writer =
+    vtkSmartPointer<vtkImageWriter>::New();
+  writer->SetInputConnection(source->GetOutputPort());
+  writer->SetFileName(fileName.c_str());
+  writer->SetFileDimensionality(3);
+  writer->Write();
+
+  vtkSmartPointer<vtkImageData> images[2];
+  for (int prefetch = 0; prefetch < 2; prefetch++)
+    {
+    vtkSmartPointer<vtkImageReader2> reader =
+      vtkSmartPointer<vtkImageReader2>::New();
+    reader->SetFileName(fileName.c_str());
+    reader->SetFileDimensionality(3);
+    reader->SetFileLowerLeft(1);
+    reader->SetDataScalarTypeToDouble();
+    reader->SetDataExtent(0, 63, 0, 47, 0, 39);
+
+    vtkSmartPointer<vtkImageGaussianSmooth> smooth =
+      vtkSmartPointer<vtkImageGaussianSmooth>::New();
+    smooth->SetInputConnection(reader->GetOutputPort());
+    smooth->SetRadiusFactors(2.0, 2.0, 2.0);
+
+    vtkSmartPointer<vtkImageDataStreamer> streamer =
+      vtkSmartPointer<vtkImageDataStreamer>::New();
+    streamer->SetInputConnection(smooth->GetOutputPort());
+    if (prefetch)
+      {
+      reader->SetPrefetchMemoryLimit(64);
+      streamer->SetNumberOfStreamDivisions(8);
+      }
+    else
+      {
+      streamer->SetNumberOfStreamDivisions(1);
+      }
+    streamer->Update();
+
+    // Every piece but the first one should come from memory.
+    if (prefetch && reader->GetPrefetchHitCount() == 0)
+      {
+      cerr << "No row was taken from the data read ahead" << endl;
+      return 1;
+      }
+    if (!prefetch && reader->GetPrefetchHitCount() != 0)
+      {
+      cerr << "Rows taken from data read ahead while reading ahead is off"
+           << endl;
+      return 1;
+      }
+
+    images[prefetch] = streamer->GetOutput();
+    }
+
+  vtkDataArray *expected = images[0]->GetPointData()->GetScalars();
+  vtkDataArray *result = images[1]->GetPointData()->GetScalars();
+  if (!expected || !result ||
+      expected->GetNumberOfTuples() != 64*48*40 ||
+      result->GetNumberOfTuples() != expected->GetNumberOfTuples())
+    {
+    cerr << "Wrong number of points read" << endl;
+    return 1;
+    }
+  for (vtkIdType i = 0; i < expected->GetNumberOfTuples(); i++)
+    {
+    if (expected->GetComponent(i, 0) != result->GetComponent(i, 0))
+      {
+      cerr << "Streamed result differs at point " << i << ": "
+           << result->GetComponent(i, 0) << " != "
+           << expected->GetComponent(i, 0) << endl;
+      return 1;
+      }
+    }
+
+  return 0;
+}
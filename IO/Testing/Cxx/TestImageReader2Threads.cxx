@@ -0,0 +1,214 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageReader2Threads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the concurrent decoding of an image file series
+// .SECTION Description
+// Writes PNG, JPEG and TIFF file series, reads each with one and with
+// four decoding threads, with and without files read ahead, and checks
+// that the images are identical and that the progress reaches 1 in the
+// calling thread.  The lossless formats must also match the written
+// image, TIFF with its rows in the reverse order since vtkTIFFWriter
+// writes them top to bottom.  The readers must default to the global
+// number of threads.
+
+#include "vtkCommand.h"
+#include "vtkImageCast.h"
+#include "vtkImageData.h"
+#include "vtkImageSinusoidSource.h"
+#include "vtkJPEGReader.h"
+#include "vtkJPEGWriter.h"
+#include "vtkMultiThreader.h"
+#include "vtkPNGReader.h"
+#include "vtkPNGWriter.h"
+#include "vtkSmartPointer.h"
+#include "vtkTIFFReader.h"
+#include "vtkTIFFWriter.h"
+#include "vtkTestUtilities.h"
+
+#include <vtkstd/string>
+
+#include <stdio.h>
+#include <string.h>
+
+class vtkImageReader2ThreadsProgress : public vtkCommand
+{
+public:
+  static vtkImageReader2ThreadsProgress *New()
+    { return new vtkImageReader2ThreadsProgress; }
+  virtual void Execute(vtkObject *, unsigned long, void *callData)
+    {
+    double progress = *static_cast<double *>(callData);
+    this->MaximumProgress =
+      (progress > this->MaximumProgress) ? progress : this->MaximumProgress;
+    }
+  double MaximumProgress;
+protected:
+  vtkImageReader2ThreadsProgress() { this->MaximumProgress = 0.0; }
+};
+
+static const int NumberOfSlices = 12;
+
+// Compare the slices of the images, with the rows of the second one in
+// the reverse order if flipped is set.
+static int CompareSlices(vtkImageData *a, vtkImageData *b, int flipped)
+{
+  unsigned char *ptrA = static_cast<unsigned char *>(a->GetScalarPointer());
+  unsigned char *ptrB = static_cast<unsigned char *>(b->GetScalarPointer());
+  for (int k = 0; k < NumberOfSlices; k++)
+    {
+    for (int j = 0; j < 48; j++)
+      {
+      int rowB = flipped ? 47 - j : j;
+      if (memcmp(ptrA + (k*48 + j)*64, ptrB + (k*48 + rowB)*64, 64) != 0)
+        {
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+// Write the image as a file series with the writer, then read it back
+// with the reader in all the configurations.  The first image read must
+// match the written one if lossless is set.
+static int TestFileSeries(vtkImageData *image, vtkImageWriter *writer,
+                          vtkImageReader2 *reader, const char *filePrefix,
+                          const char *filePattern, int lossless, int flipped)
+{
+  writer->SetInput(image);
+  writer->SetFilePrefix(filePrefix);
+  writer->SetFilePattern(filePattern);
+  writer->Write();
+
+  vtkSmartPointer<vtkImageData> reference;
+  int rval = 0;
+  for (int prefetch = 0; prefetch <= 3; prefetch += 3)
+    {
+    for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+      {
+      vtkSmartPointer<vtkImageReader2ThreadsProgress> progress =
+        vtkSmartPointer<vtkImageReader2ThreadsProgress>::New();
+      reader->SetFilePrefix(filePrefix);
+      reader->SetFilePattern(filePattern);
+      reader->SetDataExtent(0, 63, 0, 47, 0, NumberOfSlices - 1);
+      reader->SetNumberOfThreads(numThreads);
+      reader->SetNumberOfPrefetchFiles(prefetch);
+      reader->RemoveAllObservers();
+      reader->AddObserver(vtkCommand::ProgressEvent, progress);
+      reader->Modified();
+      reader->Update();
+
+      vtkImageData *output = reader->GetOutput();
+      int *dims = output->GetDimensions();
+      if (dims[0] != 64 || dims[1] != 48 || dims[2] != NumberOfSlices ||
+          output->GetScalarType() != VTK_UNSIGNED_CHAR ||
+          output->GetNumberOfScalarComponents() != 1)
+        {
+        cerr << "Read " << filePattern << " as an image of " << dims[0]
+             << "x" << dims[1] << "x" << dims[2] << " with " << numThreads
+             << " threads.\n";
+        rval = 1;
+        continue;
+        }
+      if (progress->MaximumProgress != 1.0)
+        {
+        cerr << "The progress of " << filePattern << " stopped at "
+             << progress->MaximumProgress << " with " << numThreads
+             << " threads.\n";
+        rval = 1;
+        }
+
+      if (!reference)
+        {
+        reference = vtkSmartPointer<vtkImageData>::New();
+        reference->DeepCopy(output);
+        if (lossless && !CompareSlices(image, reference, flipped))
+          {
+          cerr << "The " << filePattern
+               << " series differs from the written image.\n";
+          rval = 1;
+          }
+        continue;
+        }
+      if (!CompareSlices(reference, output, 0))
+        {
+        cerr << "The " << filePattern << " series read with " << numThreads
+             << " threads and " << prefetch << " files read ahead differs.\n";
+        rval = 1;
+        }
+      }
+    }
+
+  for (int i = 0; i < NumberOfSlices; i++)
+    {
+    char fileName[1024];
+    sprintf(fileName, filePattern, filePrefix, i);
+    remove(fileName);
+    }
+
+  return rval;
+}
+
+int TestImageReader2Threads(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string filePrefix = tempDir;
+  filePrefix += "/TestImageReader2Threads";
+  delete [] tempDir;
+
+  vtkSmartPointer<vtkImageSinusoidSource> source =
+    vtkSmartPointer<vtkImageSinusoidSource>::New();
+  source->SetWholeExtent(0, 63, 0, 47, 0, NumberOfSlices - 1);
+  source->SetDirection(1.0, 0.5, 0.25);
+  source->SetPeriod(17.0);
+  source->SetAmplitude(120.0);
+  vtkSmartPointer<vtkImageCast> cast = vtkSmartPointer<vtkImageCast>::New();
+  cast->SetInputConnection(source->GetOutputPort());
+  cast->SetOutputScalarTypeToUnsignedChar();
+  cast->ClampOverflowOn();
+  cast->Update();
+  vtkImageData *image = cast->GetOutput();
+
+  int rval = 0;
+  vtkSmartPointer<vtkPNGWriter> pngWriter =
+    vtkSmartPointer<vtkPNGWriter>::New();
+  vtkSmartPointer<vtkPNGReader> pngReader =
+    vtkSmartPointer<vtkPNGReader>::New();
+  if (pngReader->GetNumberOfThreads() !=
+      vtkMultiThreader::GetGlobalDefaultNumberOfThreads())
+    {
+    cerr << "The reader defaults to " << pngReader->GetNumberOfThreads()
+         << " threads instead of the global default.\n";
+    rval = 1;
+    }
+  rval |= TestFileSeries(image, pngWriter, pngReader, filePrefix.c_str(),
+                         "%s%d.png", 1, 0);
+
+  vtkSmartPointer<vtkJPEGWriter> jpegWriter =
+    vtkSmartPointer<vtkJPEGWriter>::New();
+  vtkSmartPointer<vtkJPEGReader> jpegReader =
+    vtkSmartPointer<vtkJPEGReader>::New();
+  rval |= TestFileSeries(image, jpegWriter, jpegReader, filePrefix.c_str(),
+                         "%s%d.jpg", 0, 0);
+
+  vtkSmartPointer<vtkTIFFWriter> tiffWriter =
+    vtkSmartPointer<vtkTIFFWriter>::New();
+  vtkSmartPointer<vtkTIFFReader> tiffReader =
+    vtkSmartPointer<vtkTIFFReader>::New();
+  rval |= TestFileSeries(image, tiffWriter, tiffReader, filePrefix.c_str(),
+                         "%s%d.tif", 1, 1);
+
+  return rval;
+}
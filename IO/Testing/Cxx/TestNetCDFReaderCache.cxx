@@ -0,0 +1,262 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestNetCDFReaderCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the vtkDataArrayCache in vtkNetCDFReader
+// .SECTION Description
+// Writes a netCDF file with three time steps of a float variable and a
+// scaled short variable.  With the global array cache enabled, time steps
+// 0 and 1 are read and checked against the written values.  The values
+// of the file are then overwritten in place, which keeps its length, and
+// the file is given back its modification time.  Stepping back to time 0
+// and forward to time 1 must give the first values from the cache, in
+// arrays independent of the earlier outputs and of the cache.  With the
+// cache disabled the new values must be read.
+
+#include "vtkDataArray.h"
+#include "vtkDataArrayCache.h"
+#include "vtkImageData.h"
+#include "vtkNetCDFReader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#include <netcdf.h>
+
+#include <sys/types.h>
+#if defined(_WIN32)
+# include <sys/utime.h>
+#else
+# include <utime.h>
+#endif
+
+typedef vtkstd::vector<vtkSmartPointer<vtkDataArray> > ArrayList;
+
+static const int NumberOfTimes = 3;
+static const int NX = 12;
+static const int NY = 9;
+static const int NZ = 5;
+
+//----------------------------------------------------------------------------
+// The value of a variable at a time step and point; the values of the
+// rewritten file are shifted by a version.
+static float TemperatureValue(int version, int time, int i)
+{
+  return 273.0f + 10.0f*time + 0.25f*i + 100.0f*version;
+}
+
+static short PressureValue(int version, int time, int i)
+{
+  return static_cast<short>(1000 + 7*time - i + 500*version);
+}
+
+//----------------------------------------------------------------------------
+// Write the values of a version of the file.  Version 0 creates it.
+static int WriteNetCDF(const char *fileName, int version)
+{
+  int ncFD;
+  int tempId, presId;
+  if (version == 0)
+    {
+    if (nc_create(fileName, NC_CLOBBER, &ncFD) != NC_NOERR)
+      {
+      return 0;
+      }
+    int dimIds[4];
+    nc_def_dim(ncFD, "time", NC_UNLIMITED, &dimIds[0]);
+    nc_def_dim(ncFD, "z", NZ, &dimIds[1]);
+    nc_def_dim(ncFD, "y", NY, &dimIds[2]);
+    nc_def_dim(ncFD, "x", NX, &dimIds[3]);
+    nc_def_var(ncFD, "temperature", NC_FLOAT, 4, dimIds, &tempId);
+    nc_def_var(ncFD, "pressure", NC_SHORT, 4, dimIds, &presId);
+    double scale = 0.5;
+    nc_put_att_double(ncFD, presId, "scale_factor", NC_DOUBLE, 1, &scale);
+    nc_enddef(ncFD);
+    }
+  else
+    {
+    if (nc_open(fileName, NC_WRITE, &ncFD) != NC_NOERR)
+      {
+      return 0;
+      }
+    nc_inq_varid(ncFD, "temperature", &tempId);
+    nc_inq_varid(ncFD, "pressure", &presId);
+    }
+
+  int numPts = NX*NY*NZ;
+  vtkstd::vector<float> temperature(numPts);
+  vtkstd::vector<short> pressure(numPts);
+  int status = NC_NOERR;
+  for (int time = 0; time < NumberOfTimes && status == NC_NOERR; time++)
+    {
+    for (int i = 0; i < numPts; i++)
+      {
+      temperature[i] = TemperatureValue(version, time, i);
+      pressure[i] = PressureValue(version, time, i);
+      }
+    size_t start[4] = { static_cast<size_t>(time), 0, 0, 0 };
+    size_t count[4] = { 1, NZ, NY, NX };
+    status = nc_put_vara_float(ncFD, tempId, start, count, &temperature[0]);
+    if (status == NC_NOERR)
+      {
+      status = nc_put_vara_short(ncFD, presId, start, count, &pressure[0]);
+      }
+    }
+  return nc_close(ncFD) == NC_NOERR && status == NC_NOERR;
+}
+
+//----------------------------------------------------------------------------
+static void UpdateTime(vtkNetCDFReader *reader, double time)
+{
+  reader->UpdateInformation();
+  vtkStreamingDemandDrivenPipeline::SafeDownCast(
+    reader->GetExecutive())->SetUpdateTimeStep(0, time);
+  reader->Modified();
+  reader->Update();
+}
+
+//----------------------------------------------------------------------------
+// Check the arrays of the output against the values of a version of the
+// file.  Keep them in the list of arrays handed out, none of which may be
+// handed out again.
+static int CheckOutput(vtkNetCDFReader *reader, int version, int time,
+                       ArrayList &handedOut)
+{
+  vtkPointData *pd = vtkImageData::SafeDownCast(
+    reader->GetOutputDataObject(0))->GetPointData();
+  vtkDataArray *temperature = pd->GetArray("temperature");
+  vtkDataArray *pressure = pd->GetArray("pressure");
+  int numPts = NX*NY*NZ;
+  if (!temperature || !pressure ||
+      temperature->GetNumberOfTuples() != numPts ||
+      pressure->GetNumberOfTuples() != numPts)
+    {
+    cerr << "The arrays of time " << time << " are missing.\n";
+    return 0;
+    }
+  for (int i = 0; i < numPts; i++)
+    {
+    if (temperature->GetComponent(i, 0) !=
+        TemperatureValue(version, time, i) ||
+        pressure->GetComponent(i, 0) != 0.5*PressureValue(version, time, i))
+      {
+      cerr << "The values of time " << time << " differ at point " << i
+           << ".\n";
+      return 0;
+      }
+    }
+  for (size_t p = 0; p < handedOut.size(); p++)
+    {
+    if (handedOut[p] == temperature || handedOut[p] == pressure)
+      {
+      cerr << "An array of time " << time << " was handed out twice.\n";
+      return 0;
+      }
+    }
+  handedOut.push_back(temperature);
+  handedOut.push_back(pressure);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int TestNetCDFReaderCache(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string fileName = tempDir;
+  fileName += "/TestNetCDFReaderCache.nc";
+  delete [] tempDir;
+
+  if (!WriteNetCDF(fileName.c_str(), 0))
+    {
+    cerr << "Could not write " << fileName.c_str() << ".\n";
+    return 1;
+    }
+
+  vtkDataArrayCache *cache = vtkDataArrayCache::GetGlobalCache();
+  double capacity = cache->GetCapacity();
+  cache->SetCapacity(16.0);
+
+  vtkSmartPointer<vtkNetCDFReader> reader =
+    vtkSmartPointer<vtkNetCDFReader>::New();
+  reader->SetFileName(fileName.c_str());
+  reader->UpdateMetaData();
+  reader->SetVariableArrayStatus("temperature", 1);
+  reader->SetVariableArrayStatus("pressure", 1);
+
+  int rval = 0;
+  ArrayList handedOut;
+  UpdateTime(reader, 0.0);
+  rval |= !CheckOutput(reader, 0, 0, handedOut);
+  UpdateTime(reader, 1.0);
+  rval |= !CheckOutput(reader, 0, 1, handedOut);
+  if (cache->GetNumberOfEntries() != 4)
+    {
+    cerr << "The cache has " << cache->GetNumberOfEntries()
+         << " entries instead of 4.\n";
+    rval = 1;
+    }
+
+  // new values in place, with the time of the first file
+  long int modifiedTime =
+    vtksys::SystemTools::ModifiedTime(fileName.c_str());
+  unsigned long length = vtksys::SystemTools::FileLength(fileName.c_str());
+  WriteNetCDF(fileName.c_str(), 1);
+  struct utimbuf times;
+  times.actime = modifiedTime;
+  times.modtime = modifiedTime;
+  utime(fileName.c_str(), &times);
+  if (vtksys::SystemTools::FileLength(fileName.c_str()) != length)
+    {
+    cerr << "The rewritten file has another length.\n";
+    rval = 1;
+    }
+
+  // step back and forth; modifying the outputs must not modify the cache
+  for (int time = 0; time <= 1; time++)
+    {
+    vtkDataArray *previous =
+      vtkImageData::SafeDownCast(reader->GetOutputDataObject(0))
+      ->GetPointData()->GetArray("temperature");
+    previous->FillComponent(0, -1.0);
+    UpdateTime(reader, time);
+    if (!CheckOutput(reader, 0, time, handedOut))
+      {
+      cerr << "Time " << time << " did not come from the cache.\n";
+      rval = 1;
+      }
+    }
+
+  // the time steps that were not read before come from the file
+  UpdateTime(reader, 2.0);
+  rval |= !CheckOutput(reader, 1, 2, handedOut);
+
+  // without the cache the new values are read
+  cache->SetCapacity(0.0);
+  UpdateTime(reader, 0.0);
+  if (!CheckOutput(reader, 1, 0, handedOut))
+    {
+    cerr << "The rewritten file was not read without the cache.\n";
+    rval = 1;
+    }
+
+  cache->SetCapacity(capacity);
+  vtksys::SystemTools::RemoveFile(fileName.c_str());
+
+  return rval;
+}
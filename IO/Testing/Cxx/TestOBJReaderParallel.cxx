@@ -0,0 +1,189 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestOBJReaderParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the chunked parsing mode of vtkOBJReader
+// .SECTION Description
+// Writes OBJ files with numbers in exponent notation and with long
+// mantissas, reads them with and without ParallelParsing on several
+// threads and compares the outputs.  A file with a missing coordinate
+// must be rejected by both parsers.
+
+#include "vtkCellArray.h"
+#include "vtkMultiThreader.h"
+#include "vtkOBJReader.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <vtkstd/string>
+
+#include <stdio.h>
+
+static vtkSmartPointer<vtkPolyData> ReadOBJ(const char *fileName,
+                                            int parallel)
+{
+  vtkSmartPointer<vtkOBJReader> reader = vtkSmartPointer<vtkOBJReader>::New();
+  reader->SetFileName(fileName);
+  reader->SetParallelParsing(parallel);
+  reader->Update();
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->ShallowCopy(reader->GetOutput());
+  return output;
+}
+
+static int ComparePolyData(vtkPolyData *serial, vtkPolyData *parallel)
+{
+  vtkIdType numPts = serial->GetNumberOfPoints();
+  if (numPts == 0 || parallel->GetNumberOfPoints() != numPts)
+    {
+    cerr << "Read " << numPts << " points serially and "
+         << parallel->GetNumberOfPoints() << " in parallel.\n";
+    return 1;
+    }
+  for (vtkIdType i = 0; i < numPts; i++)
+    {
+    double x[3], y[3];
+    serial->GetPoint(i, x);
+    parallel->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+      {
+      cerr << "Point " << i << " is (" << x[0] << ", " << x[1] << ", "
+           << x[2] << ") serially and (" << y[0] << ", " << y[1] << ", "
+           << y[2] << ") in parallel.\n";
+      return 1;
+      }
+    }
+
+  vtkCellArray *serialPolys = serial->GetPolys();
+  vtkCellArray *parallelPolys = parallel->GetPolys();
+  if (serialPolys->GetNumberOfCells() != parallelPolys->GetNumberOfCells())
+    {
+    cerr << "Read " << serialPolys->GetNumberOfCells()
+         << " polygons serially and " << parallelPolys->GetNumberOfCells()
+         << " in parallel.\n";
+    return 1;
+    }
+  vtkIdType npts, *pts, parallelNpts, *parallelPts;
+  serialPolys->InitTraversal();
+  parallelPolys->InitTraversal();
+  while (serialPolys->GetNextCell(npts, pts))
+    {
+    parallelPolys->GetNextCell(parallelNpts, parallelPts);
+    if (npts != parallelNpts)
+      {
+      cerr << "Polygon sizes differ.\n";
+      return 1;
+      }
+    for (vtkIdType j = 0; j < npts; j++)
+      {
+      if (pts[j] != parallelPts[j])
+        {
+        cerr << "Polygon point ids differ.\n";
+        return 1;
+        }
+      }
+    }
+  return 0;
+}
+
+int TestOBJReaderParallel(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string fileName = tempDir;
+  fileName += "/TestOBJReaderParallel.obj";
+  vtkstd::string badFileName = tempDir;
+  badFileName += "/TestOBJReaderParallelBad.obj";
+  delete [] tempDir;
+
+  // numbers that the fast path converts and numbers that it hands to
+  // sscanf: exponents, long mantissas and large integers
+  static const char *formats[] = {
+    "v %d.25 %d.5 -%d.125\n",
+    "v %de-3 %dE+2 -%de1\n",
+    "v %d.123456789012345678 0.%d9876543210987654321 %d12345678901\n",
+    "v %d.5e-07 %d000000000000000000000000000000.0 %d.\n" };
+  int numFormats = sizeof(formats)/sizeof(formats[0]);
+  int numVerts = 400;
+  FILE *fp = fopen(fileName.c_str(), "w");
+  if (!fp)
+    {
+    cerr << "Cannot write " << fileName << "\n";
+    return 1;
+    }
+  int i;
+  for (i = 0; i < numVerts; i++)
+    {
+    fprintf(fp, formats[i%numFormats], i, i + 1, i + 2);
+    }
+  for (i = 1; i + 2 <= numVerts; i += 3)
+    {
+    fprintf(fp, "f %d %d %d\n", i, i + 1, i + 2);
+    }
+  fclose(fp);
+
+  // the second line lacks its z coordinate, which must not be taken
+  // from the next line
+  fp = fopen(badFileName.c_str(), "w");
+  if (!fp)
+    {
+    cerr << "Cannot write " << badFileName << "\n";
+    return 1;
+    }
+  fprintf(fp, "v 1.5e0 2.5e0 3.5e0\nv 1.5e0 2.5e0\n7.5e0\n");
+  for (i = 0; i < 50; i++)
+    {
+    fprintf(fp, "v %de-1 %de-1 %de-1\n", i, i + 1, i + 2);
+    }
+  fclose(fp);
+
+  // parse in several chunks even on a single processor
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  int rval = 0;
+  vtkSmartPointer<vtkPolyData> serial = ReadOBJ(fileName.c_str(), 0);
+  vtkSmartPointer<vtkPolyData> parallel = ReadOBJ(fileName.c_str(), 1);
+  if (serial->GetNumberOfPoints() != numVerts)
+    {
+    cerr << "Expected " << numVerts << " points, read "
+         << serial->GetNumberOfPoints() << ".\n";
+    rval = 1;
+    }
+  if (ComparePolyData(serial, parallel))
+    {
+    rval = 1;
+    }
+
+  // both parsers report the error and produce no points
+  int warningDisplay = vtkObject::GetGlobalWarningDisplay();
+  vtkObject::GlobalWarningDisplayOff();
+  serial = ReadOBJ(badFileName.c_str(), 0);
+  parallel = ReadOBJ(badFileName.c_str(), 1);
+  vtkObject::SetGlobalWarningDisplay(warningDisplay);
+  if (serial->GetNumberOfPoints() != 0 || parallel->GetNumberOfPoints() != 0)
+    {
+    cerr << "The missing coordinate was not detected: read "
+         << serial->GetNumberOfPoints() << " points serially and "
+         << parallel->GetNumberOfPoints() << " in parallel.\n";
+    rval = 1;
+    }
+
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+  remove(fileName.c_str());
+  remove(badFileName.c_str());
+
+  return rval;
+}
@@ -0,0 +1,424 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestOpenFOAMReaderCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the field cache and the field threads of vtkOpenFOAMReader
+// .SECTION Description
+// Writes a small OpenFOAM case with three time steps, reads two time
+// steps and steps back to the first one.  The arrays taken from the field
+// cache must equal those of a fresh reader, and must not be the arrays
+// that were handed out by the first read.  The last time step is also
+// read with one and with four threads parsing the field files, which must
+// give identical outputs.  Finally the time steps are read forward and
+// back with the adjacent time steps prefetched; each read must equal a
+// fresh read, and each revisited time step must come from the cache.
+
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkOpenFOAMReader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#include <stdio.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------
+static void WriteFoamFile(const vtkstd::string &fileName,
+                          const char *className, const char *object,
+                          const char *contents)
+{
+  FILE *fp = fopen(fileName.c_str(), "w");
+  if (!fp)
+    {
+    return;
+    }
+  fprintf(fp, "FoamFile\n{\n    version 2.0;\n    format ascii;\n"
+          "    class %s;\n    object %s;\n}\n\n%s", className, object,
+          contents);
+  fclose(fp);
+}
+
+//----------------------------------------------------------------------------
+// Two hexahedra side by side along x.  The faces are ordered as OpenFOAM
+// wants them: the internal face, then the "walls" patch (the y and z
+// faces) and the "ends" patch (the x faces).
+static vtkstd::string WriteCase(const char *tempDir)
+{
+  vtkstd::string casePath = tempDir;
+  casePath += "/TestOpenFOAMReaderCache";
+  vtksys::SystemTools::MakeDirectory((casePath + "/system").c_str());
+  vtksys::SystemTools::MakeDirectory((casePath + "/constant/polyMesh").c_str());
+
+  WriteFoamFile(casePath + "/system/controlDict", "dictionary", "controlDict",
+    "startTime 0;\nendTime 2;\ndeltaT 1;\nwriteControl timeStep;\n"
+    "writeInterval 1;\ntimeFormat general;\n");
+
+  vtkstd::string meshPath = casePath + "/constant/polyMesh/";
+  WriteFoamFile(meshPath + "points", "vectorField", "points",
+    "12\n(\n(0 0 0)\n(1 0 0)\n(2 0 0)\n(0 1 0)\n(1 1 0)\n(2 1 0)\n"
+    "(0 0 1)\n(1 0 1)\n(2 0 1)\n(0 1 1)\n(1 1 1)\n(2 1 1)\n)\n");
+  WriteFoamFile(meshPath + "faces", "faceList", "faces",
+    "11\n(\n4(1 4 10 7)\n"
+    "4(0 1 7 6)\n4(3 9 10 4)\n4(0 3 4 1)\n4(6 7 10 9)\n"
+    "4(1 2 8 7)\n4(4 10 11 5)\n4(1 4 5 2)\n4(7 8 11 10)\n"
+    "4(0 6 9 3)\n4(2 5 11 8)\n)\n");
+  WriteFoamFile(meshPath + "owner", "labelList", "owner",
+    "11\n(\n0\n0\n0\n0\n0\n1\n1\n1\n1\n0\n1\n)\n");
+  WriteFoamFile(meshPath + "neighbour", "labelList", "neighbour",
+    "1\n(\n1\n)\n");
+  WriteFoamFile(meshPath + "boundary", "polyBoundaryMesh", "boundary",
+    "2\n(\nwalls\n{\n    type wall;\n    nFaces 8;\n    startFace 1;\n}\n"
+    "ends\n{\n    type patch;\n    nFaces 2;\n    startFace 9;\n}\n)\n");
+
+  for (int timeI = 0; timeI <= 2; timeI++)
+    {
+    char timeName[16];
+    sprintf(timeName, "/%d", timeI);
+    vtkstd::string timePath = casePath + timeName;
+    vtksys::SystemTools::MakeDirectory(timePath.c_str());
+
+    char contents[1024];
+    sprintf(contents,
+      "dimensions [0 2 -2 0 0 0 0];\n"
+      "internalField nonuniform List<scalar>\n2\n(\n%d\n%d\n)\n;\n"
+      "boundaryField\n{\n"
+      "    walls\n    {\n        type zeroGradient;\n    }\n"
+      "    ends\n    {\n        type fixedValue;\n"
+      "        value uniform %d;\n    }\n}\n",
+      10*timeI + 1, 10*timeI + 2, 10*timeI + 5);
+    WriteFoamFile(timePath + "/p", "volScalarField", "p", contents);
+
+    // more scalar fields, so that several threads have files to parse
+    static const char *scalarNames[] = { "T", "k", "epsilon", "nut" };
+    for (int nameI = 0; nameI < 4; nameI++)
+      {
+      sprintf(contents,
+        "dimensions [0 0 0 0 0 0 0];\n"
+        "internalField nonuniform List<scalar>\n2\n(\n%d.5\n%d.25\n)\n;\n"
+        "boundaryField\n{\n"
+        "    walls\n    {\n        type fixedValue;\n"
+        "        value uniform %d;\n    }\n"
+        "    ends\n    {\n        type zeroGradient;\n    }\n}\n",
+        100*nameI + timeI, 100*nameI + 2*timeI, nameI - timeI);
+      WriteFoamFile(timePath + "/" + scalarNames[nameI], "volScalarField",
+        scalarNames[nameI], contents);
+      }
+
+    sprintf(contents,
+      "dimensions [0 1 -1 0 0 0 0];\n"
+      "internalField nonuniform List<vector>\n2\n(\n(%d 0 0)\n(0 %d 0)\n)\n;\n"
+      "boundaryField\n{\n"
+      "    walls\n    {\n        type fixedValue;\n"
+      "        value uniform (0 0 0);\n    }\n"
+      "    ends\n    {\n        type zeroGradient;\n    }\n}\n",
+      timeI + 1, timeI + 2);
+    WriteFoamFile(timePath + "/U", "volVectorField", "U", contents);
+    }
+
+  return casePath;
+}
+
+//----------------------------------------------------------------------------
+// Collect the leaf data sets of a multiblock data set in order.
+static void GetLeaves(vtkMultiBlockDataSet *mb,
+                      vtkstd::vector<vtkDataSet *> &leaves)
+{
+  for (unsigned int i = 0; i < mb->GetNumberOfBlocks(); i++)
+    {
+    vtkDataObject *block = mb->GetBlock(i);
+    if (vtkMultiBlockDataSet::SafeDownCast(block))
+      {
+      GetLeaves(vtkMultiBlockDataSet::SafeDownCast(block), leaves);
+      }
+    else if (vtkDataSet::SafeDownCast(block))
+      {
+      leaves.push_back(vtkDataSet::SafeDownCast(block));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+typedef vtkstd::vector<vtkSmartPointer<vtkDataArray> > ArrayList;
+
+// Keep references to the point and cell arrays of the leaves.
+static void GetArrays(vtkMultiBlockDataSet *mb, ArrayList &arrays)
+{
+  vtkstd::vector<vtkDataSet *> leaves;
+  GetLeaves(mb, leaves);
+  for (size_t i = 0; i < leaves.size(); i++)
+    {
+    vtkDataSetAttributes *attributes[2] =
+      { leaves[i]->GetCellData(), leaves[i]->GetPointData() };
+    for (int j = 0; j < 2; j++)
+      {
+      for (int k = 0; k < attributes[j]->GetNumberOfArrays(); k++)
+        {
+        arrays.push_back(attributes[j]->GetArray(k));
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Compare the arrays of a and b by name and value.  Returns the number of
+// arrays compared, or -1 if they differ.  No array of a may be one of the
+// previous arrays.
+static int CompareArrays(vtkDataSetAttributes *a, vtkDataSetAttributes *b,
+                         const ArrayList &previous)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+    {
+    cerr << "Got " << a->GetNumberOfArrays() << " arrays instead of "
+         << b->GetNumberOfArrays() << ".\n";
+    return -1;
+    }
+  for (int i = 0; i < a->GetNumberOfArrays(); i++)
+    {
+    vtkDataArray *arrayA = a->GetArray(i);
+    vtkDataArray *arrayB = b->GetArray(arrayA->GetName());
+    if (!arrayB ||
+        arrayA->GetNumberOfTuples() != arrayB->GetNumberOfTuples() ||
+        arrayA->GetNumberOfComponents() != arrayB->GetNumberOfComponents())
+      {
+      cerr << "Array " << arrayA->GetName() << " does not match.\n";
+      return -1;
+      }
+    int numComp = arrayA->GetNumberOfComponents();
+    for (vtkIdType j = 0; j < arrayA->GetNumberOfTuples(); j++)
+      {
+      for (int k = 0; k < numComp; k++)
+        {
+        if (arrayA->GetComponent(j, k) != arrayB->GetComponent(j, k))
+          {
+          cerr << "Array " << arrayA->GetName() << " differs at tuple "
+               << j << ".\n";
+          return -1;
+          }
+        }
+      }
+    for (size_t p = 0; p < previous.size(); p++)
+      {
+      if (previous[p] == arrayA)
+        {
+        cerr << "Array " << arrayA->GetName() << " was handed out twice.\n";
+        return -1;
+        }
+      }
+    }
+  return a->GetNumberOfArrays();
+}
+
+//----------------------------------------------------------------------------
+static int CompareOutputs(vtkMultiBlockDataSet *a, vtkMultiBlockDataSet *b,
+                          const ArrayList &previous)
+{
+  vtkstd::vector<vtkDataSet *> leavesA, leavesB;
+  GetLeaves(a, leavesA);
+  GetLeaves(b, leavesB);
+  if (leavesA.empty() || leavesA.size() != leavesB.size())
+    {
+    cerr << "The outputs have different blocks.\n";
+    return 0;
+    }
+  int numArrays = 0;
+  for (size_t i = 0; i < leavesA.size(); i++)
+    {
+    int numCellArrays = CompareArrays(leavesA[i]->GetCellData(),
+      leavesB[i]->GetCellData(), previous);
+    int numPointArrays = CompareArrays(leavesA[i]->GetPointData(),
+      leavesB[i]->GetPointData(), previous);
+    if (numCellArrays < 0 || numPointArrays < 0)
+      {
+      return 0;
+      }
+    numArrays += numCellArrays + numPointArrays;
+    }
+  if (numArrays == 0)
+    {
+    cerr << "No arrays were read.\n";
+    return 0;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+static void UpdateTime(vtkOpenFOAMReader *reader, double time)
+{
+  reader->UpdateInformation();
+  vtkStreamingDemandDrivenPipeline::SafeDownCast(
+    reader->GetExecutive())->SetUpdateTimeStep(0, time);
+  reader->Update();
+}
+
+//----------------------------------------------------------------------------
+static vtkSmartPointer<vtkOpenFOAMReader> NewReader(
+  const vtkstd::string &casePath)
+{
+  vtkSmartPointer<vtkOpenFOAMReader> reader =
+    vtkSmartPointer<vtkOpenFOAMReader>::New();
+  reader->SetFileName((casePath + "/system/controlDict").c_str());
+  reader->UpdateInformation();
+  reader->EnableAllCellArrays();
+  reader->EnableAllPointArrays();
+  reader->EnableAllPatchArrays();
+  return reader;
+}
+
+//----------------------------------------------------------------------------
+int TestOpenFOAMReaderCache(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string casePath = WriteCase(tempDir);
+  delete [] tempDir;
+
+  int rval = 0;
+
+  // read time 0 and keep the arrays that were handed out; the reader
+  // may reuse the mesh blocks, so keep the arrays themselves
+  vtkSmartPointer<vtkOpenFOAMReader> reader = NewReader(casePath);
+  reader->SetFieldCacheSize(16.0);
+  UpdateTime(reader, 0.0);
+  ArrayList first;
+  GetArrays(reader->GetOutput(), first);
+
+  // read time 1, then step back to time 0, which comes from the cache
+  UpdateTime(reader, 1.0);
+  UpdateTime(reader, 0.0);
+
+  vtkSmartPointer<vtkOpenFOAMReader> fresh = NewReader(casePath);
+  fresh->SetFieldCacheSize(0.0);
+  UpdateTime(fresh, 0.0);
+
+  if (!CompareOutputs(reader->GetOutput(), fresh->GetOutput(), first))
+    {
+    cerr << "Stepping back to time 0 does not give a fresh read.\n";
+    rval = 1;
+    }
+
+  // the arrays handed out first must not have been renamed or refilled
+  ArrayList freshArrays;
+  GetArrays(fresh->GetOutput(), freshArrays);
+  if (first.size() != freshArrays.size())
+    {
+    cerr << "The first read gave " << first.size() << " arrays instead of "
+         << freshArrays.size() << ".\n";
+    rval = 1;
+    }
+  for (size_t i = 0; i < first.size() && i < freshArrays.size(); i++)
+    {
+    vtkDataArray *array = first[i];
+    vtkDataArray *freshArray = freshArrays[i];
+    int equal = !strcmp(array->GetName(), freshArray->GetName()) &&
+      array->GetNumberOfTuples() == freshArray->GetNumberOfTuples() &&
+      array->GetNumberOfComponents() == freshArray->GetNumberOfComponents();
+    vtkIdType numValues =
+      array->GetNumberOfTuples()*array->GetNumberOfComponents();
+    for (vtkIdType j = 0; equal && j < numValues; j++)
+      {
+      int numComp = array->GetNumberOfComponents();
+      equal = array->GetComponent(j/numComp, j%numComp) ==
+        freshArray->GetComponent(j/numComp, j%numComp);
+      }
+    if (!equal)
+      {
+      cerr << "Array " << array->GetName() << " of the first read was "
+           << "modified.\n";
+      rval = 1;
+      }
+    }
+
+  // parse the field files of the last time step with one and four threads
+  vtkSmartPointer<vtkOpenFOAMReader> serial = NewReader(casePath);
+  serial->SetFieldCacheSize(0.0);
+  serial->SetNumberOfThreads(1);
+  UpdateTime(serial, 2.0);
+  vtkSmartPointer<vtkOpenFOAMReader> threaded = NewReader(casePath);
+  threaded->SetFieldCacheSize(0.0);
+  threaded->SetNumberOfThreads(4);
+  UpdateTime(threaded, 2.0);
+  ArrayList none;
+  if (!CompareOutputs(threaded->GetOutput(), serial->GetOutput(), none))
+    {
+    cerr << "Reading the fields with four threads differs from one thread.\n";
+    rval = 1;
+    }
+  ArrayList serialArrays;
+  GetArrays(serial->GetOutput(), serialArrays);
+  if (serialArrays.size() != freshArrays.size())
+    {
+    cerr << "Read " << serialArrays.size() << " arrays at time 2 instead of "
+         << freshArrays.size() << ".\n";
+    rval = 1;
+    }
+
+  // the field cache is off by default
+  if (fresh->GetFieldCacheSize() != 0.0 || fresh->GetFieldCacheHitCount() ||
+      serial->GetFieldCacheHitCount() || threaded->GetFieldCacheHitCount())
+    {
+    cerr << "The field cache is used by default.\n";
+    rval = 1;
+    }
+
+  // the number of fields read at a time step, all of which come from the
+  // cache when the reader steps back to time 0
+  unsigned long numFields = reader->GetFieldCacheHitCount();
+  if (numFields == 0)
+    {
+    cerr << "Stepping back to time 0 did not use the field cache.\n";
+    rval = 1;
+    }
+
+  // step forward and back with the adjacent time steps prefetched
+  vtkSmartPointer<vtkOpenFOAMReader> prefetch = NewReader(casePath);
+  prefetch->SetFieldCacheSize(16.0);
+  prefetch->SetNumberOfPrefetchTimeSteps(1);
+  static const int times[] = { 0, 1, 2, 1, 0 };
+  ArrayList handedOut;
+  for (int i = 0; i < 5; i++)
+    {
+    unsigned long hits = prefetch->GetFieldCacheHitCount();
+    UpdateTime(prefetch, times[i]);
+    vtkSmartPointer<vtkOpenFOAMReader> expected = NewReader(casePath);
+    UpdateTime(expected, times[i]);
+    if (!CompareOutputs(prefetch->GetOutput(), expected->GetOutput(),
+                        handedOut))
+      {
+      cerr << "Reading time " << times[i] << " with prefetching does not "
+           << "give a fresh read.\n";
+      rval = 1;
+      }
+    GetArrays(prefetch->GetOutput(), handedOut);
+
+    // the first visits may or may not find the prefetched fields
+    hits = prefetch->GetFieldCacheHitCount() - hits;
+    if (hits > numFields || (i >= 3 && hits != numFields))
+      {
+      cerr << "Visit " << i << " to time " << times[i] << " took " << hits
+           << " fields from the cache instead of " << numFields << ".\n";
+      rval = 1;
+      }
+    }
+
+  vtksys::SystemTools::RemoveADirectory(casePath.c_str());
+
+  return rval;
+}
@@ -0,0 +1,222 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPLYReaderThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the threaded binary path of vtkPLYReader
+// .SECTION Description
+// Writes a colored triangle mesh with vtkPLYWriter as binary and as ASCII.
+// Reads the binary file with one and with four threads and checks that
+// the outputs are identical.  They must also match the ASCII file, which
+// is read element by element, up to the precision of the ASCII points.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkMultiThreader.h"
+#include "vtkPLYReader.h"
+#include "vtkPLYWriter.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <vtkstd/string>
+
+#include <math.h>
+#include <stdio.h>
+
+static vtkSmartPointer<vtkPolyData> ReadPLY(const char *fileName,
+                                            int numThreads)
+{
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(numThreads);
+  vtkSmartPointer<vtkPLYReader> reader = vtkSmartPointer<vtkPLYReader>::New();
+  reader->SetFileName(fileName);
+  reader->Update();
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->ShallowCopy(reader->GetOutput());
+  return output;
+}
+
+static int CompareAttributes(vtkDataSetAttributes *a, vtkDataSetAttributes *b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+    {
+    return 0;
+    }
+  for (int i = 0; i < a->GetNumberOfArrays(); i++)
+    {
+    vtkDataArray *arrayA = a->GetArray(i);
+    vtkDataArray *arrayB = b->GetArray(arrayA->GetName());
+    if (!arrayB ||
+        arrayA->GetNumberOfTuples() != arrayB->GetNumberOfTuples() ||
+        arrayA->GetNumberOfComponents() != arrayB->GetNumberOfComponents())
+      {
+      return 0;
+      }
+    vtkIdType numValues =
+      arrayA->GetNumberOfTuples()*arrayA->GetNumberOfComponents();
+    for (vtkIdType j = 0; j < numValues; j++)
+      {
+      int numComp = arrayA->GetNumberOfComponents();
+      if (arrayA->GetComponent(j/numComp, j%numComp) !=
+          arrayB->GetComponent(j/numComp, j%numComp))
+        {
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+static int ComparePolyData(vtkPolyData *a, vtkPolyData *b, double tol)
+{
+  vtkIdType numPts = a->GetNumberOfPoints();
+  if (numPts == 0 || b->GetNumberOfPoints() != numPts)
+    {
+    return 0;
+    }
+  for (vtkIdType i = 0; i < numPts; i++)
+    {
+    double x[3], y[3];
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    if (fabs(x[0] - y[0]) > tol || fabs(x[1] - y[1]) > tol ||
+        fabs(x[2] - y[2]) > tol)
+      {
+      return 0;
+      }
+    }
+
+  vtkCellArray *polysA = a->GetPolys();
+  vtkCellArray *polysB = b->GetPolys();
+  if (polysA->GetNumberOfCells() != polysB->GetNumberOfCells())
+    {
+    return 0;
+    }
+  vtkIdType nptsA, *ptsA, nptsB, *ptsB;
+  polysA->InitTraversal();
+  polysB->InitTraversal();
+  while (polysA->GetNextCell(nptsA, ptsA))
+    {
+    polysB->GetNextCell(nptsB, ptsB);
+    if (nptsA != nptsB)
+      {
+      return 0;
+      }
+    for (vtkIdType j = 0; j < nptsA; j++)
+      {
+      if (ptsA[j] != ptsB[j])
+        {
+        return 0;
+        }
+      }
+    }
+
+  return CompareAttributes(a->GetPointData(), b->GetPointData()) &&
+    CompareAttributes(a->GetCellData(), b->GetCellData());
+}
+
+int TestPLYReaderThreads(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string binaryFileName = tempDir;
+  binaryFileName += "/TestPLYReaderThreadsBinary.ply";
+  vtkstd::string asciiFileName = tempDir;
+  asciiFileName += "/TestPLYReaderThreadsASCII.ply";
+  delete [] tempDir;
+
+  // a wavy grid of triangles with point and cell colors
+  const int resolution = 80;
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkUnsignedCharArray> pointColors =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  pointColors->SetName("Colors");
+  pointColors->SetNumberOfComponents(3);
+  int i, j;
+  for (j = 0; j < resolution; j++)
+    {
+    for (i = 0; i < resolution; i++)
+      {
+      points->InsertNextPoint(i*0.1, j*0.1, sin(i*0.3)*cos(j*0.2));
+      pointColors->InsertNextTuple3(i*3 % 256, j*3 % 256, (i + j) % 256);
+      }
+    }
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkUnsignedCharArray> cellColors =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  cellColors->SetName("Colors");
+  cellColors->SetNumberOfComponents(3);
+  for (j = 0; j + 1 < resolution; j++)
+    {
+    for (i = 0; i + 1 < resolution; i++)
+      {
+      vtkIdType id = j*resolution + i;
+      vtkIdType tri1[3] = { id, id + 1, id + resolution + 1 };
+      vtkIdType tri2[3] = { id, id + resolution + 1, id + resolution };
+      polys->InsertNextCell(3, tri1);
+      polys->InsertNextCell(3, tri2);
+      cellColors->InsertNextTuple3(i % 256, 255 - j % 256, 128);
+      cellColors->InsertNextTuple3(j % 256, 128, 255 - i % 256);
+      }
+    }
+  vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
+  mesh->SetPoints(points);
+  mesh->SetPolys(polys);
+  mesh->GetPointData()->AddArray(pointColors);
+  mesh->GetCellData()->AddArray(cellColors);
+
+  vtkSmartPointer<vtkPLYWriter> writer = vtkSmartPointer<vtkPLYWriter>::New();
+  writer->SetInput(mesh);
+  writer->SetArrayName("Colors");
+  writer->SetFileName(binaryFileName.c_str());
+  writer->SetFileTypeToBinary();
+  writer->Write();
+  writer->SetFileName(asciiFileName.c_str());
+  writer->SetFileTypeToASCII();
+  writer->Write();
+
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkSmartPointer<vtkPolyData> ascii = ReadPLY(asciiFileName.c_str(), 1);
+  vtkSmartPointer<vtkPolyData> serial = ReadPLY(binaryFileName.c_str(), 1);
+  vtkSmartPointer<vtkPolyData> threaded =
+    ReadPLY(binaryFileName.c_str(), 4);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  int rval = 0;
+  if (ascii->GetNumberOfPoints() != mesh->GetNumberOfPoints() ||
+      ascii->GetNumberOfCells() != mesh->GetNumberOfCells())
+    {
+    cerr << "The ASCII file was read with " << ascii->GetNumberOfPoints()
+         << " points and " << ascii->GetNumberOfCells() << " cells.\n";
+    rval = 1;
+    }
+  if (!ComparePolyData(ascii, serial, 1e-5))
+    {
+    cerr << "The binary file read with one thread differs from the ASCII "
+         << "file.\n";
+    rval = 1;
+    }
+  if (!ComparePolyData(serial, threaded, 0.0))
+    {
+    cerr << "The binary file read with four threads differs from the one "
+         << "read with one thread.\n";
+    rval = 1;
+    }
+
+  remove(binaryFileName.c_str());
+  remove(asciiFileName.c_str());
+
+  return rval;
+}
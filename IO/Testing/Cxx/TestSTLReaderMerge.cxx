@@ -0,0 +1,333 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSTLReaderMerge.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the binary read and the point merging of vtkSTLReader
+// .SECTION Description
+// Writes a binary STL grid of triangles, larger than one block of facets,
+// where every facet repeats its vertices and a few facets are degenerate.
+// Reads it with merging off, with the sorted merge and with a
+// vtkMergePoints locator, with one and with four threads, and checks the
+// point and cell counts and the connectivity.  A second file adds facets
+// with NaN coordinates, which must never be merged.  The locator cannot
+// bin NaN points, so that file is checked against the first one only.
+
+#include "vtkCellArray.h"
+#include "vtkMath.h"
+#include "vtkMergePoints.h"
+#include "vtkMultiThreader.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSTLReader.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#include <string.h>
+#include <stdio.h>
+
+// more facets than vtkSTLReader reads at once
+static const int Resolution = 190;
+static const int NumberOfDegenerateFacets = 5;
+static const int NumberOfNanFacets = 4;
+
+static void AppendFloat(vtkstd::vector<char> &buffer, float x)
+{
+  unsigned char bytes[4];
+  unsigned int bits;
+  memcpy(&bits, &x, 4);
+  // STL files are little endian
+  for (int i = 0; i < 4; i++)
+    {
+    bytes[i] = static_cast<unsigned char>((bits >> (8*i)) & 0xff);
+    }
+  buffer.insert(buffer.end(), bytes, bytes + 4);
+}
+
+static void AppendFacet(vtkstd::vector<char> &buffer, const float x[9])
+{
+  int i;
+  for (i = 0; i < 3; i++)
+    {
+    AppendFloat(buffer, 0.0f);
+    }
+  for (i = 0; i < 9; i++)
+    {
+    AppendFloat(buffer, x[i]);
+    }
+  buffer.push_back(0);
+  buffer.push_back(0);
+}
+
+// The grid point (i, j).  The zero heights alternate between +0 and -0,
+// which must be merged like vtkMergePoints does.
+static void GridPoint(int i, int j, int facet, float *x)
+{
+  x[0] = i*0.5f - 10.0f;
+  x[1] = j*0.25f;
+  x[2] = ((i + 2*j) % 7 - 3)*0.125f;
+  if (x[2] == 0.0f && facet % 2)
+    {
+    x[2] = -0.0f;
+    }
+}
+
+static int WriteSTL(const char *fileName, int withNans)
+{
+  vtkstd::vector<char> facets;
+  int numFacets = 0;
+  float x[9];
+  int i, j;
+  for (j = 0; j < Resolution; j++)
+    {
+    for (i = 0; i < Resolution; i++)
+      {
+      GridPoint(i, j, numFacets, x);
+      GridPoint(i + 1, j, numFacets, x + 3);
+      GridPoint(i + 1, j + 1, numFacets, x + 6);
+      AppendFacet(facets, x);
+      numFacets++;
+      GridPoint(i, j, numFacets, x);
+      GridPoint(i + 1, j + 1, numFacets, x + 3);
+      GridPoint(i, j + 1, numFacets, x + 6);
+      AppendFacet(facets, x);
+      numFacets++;
+      }
+    }
+
+  // facets with two identical vertices, dropped after merging
+  for (i = 0; i < NumberOfDegenerateFacets; i++)
+    {
+    GridPoint(i, i, numFacets, x);
+    GridPoint(i, i, numFacets, x + 3);
+    GridPoint(i + 1, i, numFacets, x + 6);
+    AppendFacet(facets, x);
+    numFacets++;
+    }
+
+  // facets with one NaN vertex, all with the same bit pattern
+  for (i = 0; withNans && i < NumberOfNanFacets; i++)
+    {
+    GridPoint(i, 0, numFacets, x);
+    GridPoint(i + 1, 0, numFacets, x + 3);
+    x[6] = x[7] = 1.0f;
+    x[8] = static_cast<float>(vtkMath::Nan());
+    AppendFacet(facets, x);
+    numFacets++;
+    }
+
+  FILE *fp = fopen(fileName, "wb");
+  if (!fp)
+    {
+    return 0;
+    }
+  char header[80];
+  memset(header, 0, 80);
+  strcpy(header, "TestSTLReaderMerge");
+  unsigned char count[4];
+  for (i = 0; i < 4; i++)
+    {
+    count[i] = static_cast<unsigned char>((numFacets >> (8*i)) & 0xff);
+    }
+  int ok = fwrite(header, 1, 80, fp) == 80 &&
+    fwrite(count, 1, 4, fp) == 4 &&
+    fwrite(&facets[0], 1, facets.size(), fp) == facets.size();
+  fclose(fp);
+  return ok;
+}
+
+static vtkSmartPointer<vtkPolyData> ReadSTL(const char *fileName,
+                                            int merging, int locator,
+                                            int numThreads)
+{
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(numThreads);
+  vtkSmartPointer<vtkSTLReader> reader = vtkSmartPointer<vtkSTLReader>::New();
+  reader->SetFileName(fileName);
+  reader->SetMerging(merging);
+  if (locator)
+    {
+    vtkSmartPointer<vtkMergePoints> mergePoints =
+      vtkSmartPointer<vtkMergePoints>::New();
+    reader->SetLocator(mergePoints);
+    }
+  reader->Update();
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->ShallowCopy(reader->GetOutput());
+  return output;
+}
+
+// Compare the bits of the points, so that NaNs and the signs of the
+// zeros are compared too, and the connectivity of the first numCells
+// triangles.
+static int ComparePolyData(vtkPolyData *a, vtkPolyData *b,
+                           vtkIdType numPts, vtkIdType numCells)
+{
+  if (a->GetNumberOfPoints() < numPts || b->GetNumberOfPoints() < numPts ||
+      a->GetPolys()->GetNumberOfCells() < numCells ||
+      b->GetPolys()->GetNumberOfCells() < numCells ||
+      a->GetPoints()->GetDataType() != VTK_FLOAT ||
+      b->GetPoints()->GetDataType() != VTK_FLOAT)
+    {
+    return 0;
+    }
+  if (memcmp(a->GetPoints()->GetVoidPointer(0),
+             b->GetPoints()->GetVoidPointer(0), 3*numPts*sizeof(float)))
+    {
+    return 0;
+    }
+  return memcmp(a->GetPolys()->GetPointer(), b->GetPolys()->GetPointer(),
+                4*numCells*sizeof(vtkIdType)) == 0;
+}
+
+// Check that each triangle of the merged output has the vertices of the
+// corresponding facet of the unmerged output, skipping the degenerate
+// facets that merging drops.
+static int CheckConnectivity(vtkPolyData *merged, vtkPolyData *unmerged)
+{
+  vtkCellArray *mergedPolys = merged->GetPolys();
+  vtkCellArray *unmergedPolys = unmerged->GetPolys();
+  vtkIdType nptsA, *ptsA, nptsB, *ptsB;
+  mergedPolys->InitTraversal();
+  unmergedPolys->InitTraversal();
+  while (unmergedPolys->GetNextCell(nptsB, ptsB))
+    {
+    double y[3][3];
+    for (int k = 0; k < 3; k++)
+      {
+      unmerged->GetPoint(ptsB[k], y[k]);
+      }
+    if (y[0][0] == y[1][0] && y[0][1] == y[1][1] && y[0][2] == y[1][2])
+      {
+      continue;
+      }
+    if (!mergedPolys->GetNextCell(nptsA, ptsA) || nptsA != 3)
+      {
+      return 0;
+      }
+    for (int k = 0; k < 3; k++)
+      {
+      double x[3];
+      merged->GetPoint(ptsA[k], x);
+      for (int c = 0; c < 3; c++)
+        {
+        // NaN is the only value unequal to itself
+        if (x[c] != y[k][c] && (x[c] == x[c] || y[k][c] == y[k][c]))
+          {
+          return 0;
+          }
+        }
+      }
+    }
+  return !mergedPolys->GetNextCell(nptsA, ptsA);
+}
+
+int TestSTLReaderMerge(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string fileName = tempDir;
+  fileName += "/TestSTLReaderMerge.stl";
+  vtkstd::string nanFileName = tempDir;
+  nanFileName += "/TestSTLReaderMergeNaN.stl";
+  delete [] tempDir;
+
+  if (!WriteSTL(fileName.c_str(), 0) || !WriteSTL(nanFileName.c_str(), 1))
+    {
+    cerr << "Could not write the STL files.\n";
+    return 1;
+    }
+
+  const vtkIdType numGridFacets = 2*Resolution*Resolution;
+  const vtkIdType numFacets = numGridFacets + NumberOfDegenerateFacets;
+  const vtkIdType numGridPts = (Resolution + 1)*(Resolution + 1);
+
+  int rval = 0;
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  int threads[2] = { 1, 4 };
+  for (int t = 0; t < 2; t++)
+    {
+    vtkSmartPointer<vtkPolyData> unmerged =
+      ReadSTL(fileName.c_str(), 0, 0, threads[t]);
+    vtkSmartPointer<vtkPolyData> sorted =
+      ReadSTL(fileName.c_str(), 1, 0, threads[t]);
+    vtkSmartPointer<vtkPolyData> located =
+      ReadSTL(fileName.c_str(), 1, 1, threads[t]);
+
+    if (unmerged->GetNumberOfPoints() != 3*numFacets ||
+        unmerged->GetNumberOfCells() != numFacets)
+      {
+      cerr << "Without merging, " << threads[t] << " threads read "
+           << unmerged->GetNumberOfPoints() << " points and "
+           << unmerged->GetNumberOfCells() << " cells instead of "
+           << 3*numFacets << " and " << numFacets << ".\n";
+      rval = 1;
+      }
+    if (located->GetNumberOfPoints() != numGridPts ||
+        located->GetNumberOfCells() != numGridFacets)
+      {
+      cerr << "The locator merged to " << located->GetNumberOfPoints()
+           << " points and " << located->GetNumberOfCells()
+           << " cells instead of " << numGridPts << " and "
+           << numGridFacets << ".\n";
+      rval = 1;
+      }
+    if (sorted->GetNumberOfPoints() != located->GetNumberOfPoints() ||
+        sorted->GetNumberOfCells() != located->GetNumberOfCells() ||
+        !ComparePolyData(sorted, located, numGridPts, numGridFacets))
+      {
+      cerr << "With " << threads[t] << " threads, the sorted merge gives "
+           << sorted->GetNumberOfPoints() << " points and "
+           << sorted->GetNumberOfCells()
+           << " cells that differ from the locator.\n";
+      rval = 1;
+      }
+    if (!CheckConnectivity(sorted, unmerged) ||
+        !CheckConnectivity(located, unmerged))
+      {
+      cerr << "With " << threads[t]
+           << " threads, the merged triangles do not match the facets.\n";
+      rval = 1;
+      }
+
+    // each NaN facet adds one point that is never merged, and its other
+    // vertices are merged with the grid
+    vtkSmartPointer<vtkPolyData> nanUnmerged =
+      ReadSTL(nanFileName.c_str(), 0, 0, threads[t]);
+    vtkSmartPointer<vtkPolyData> nanSorted =
+      ReadSTL(nanFileName.c_str(), 1, 0, threads[t]);
+    if (nanUnmerged->GetNumberOfPoints() !=
+        3*(numFacets + NumberOfNanFacets) ||
+        nanSorted->GetNumberOfPoints() != numGridPts + NumberOfNanFacets ||
+        nanSorted->GetNumberOfCells() != numGridFacets + NumberOfNanFacets)
+      {
+      cerr << "With NaNs and " << threads[t] << " threads, merged to "
+           << nanSorted->GetNumberOfPoints() << " points and "
+           << nanSorted->GetNumberOfCells() << " cells instead of "
+           << numGridPts + NumberOfNanFacets << " and "
+           << numGridFacets + NumberOfNanFacets << ".\n";
+      rval = 1;
+      }
+    else if (!ComparePolyData(nanSorted, located, numGridPts, numGridFacets) ||
+             !CheckConnectivity(nanSorted, nanUnmerged))
+      {
+      cerr << "With NaNs and " << threads[t]
+           << " threads, the merged points or triangles are wrong.\n";
+      rval = 1;
+      }
+    }
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return rval;
+}
@@ -0,0 +1,269 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLReaderCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the vtkDataArrayCache in the XML readers
+// .SECTION Description
+// Writes an image with two pieces and several arrays of the same type and
+// size into the raw appended data of a .vti file, so that the arrays are
+// told apart only by their offsets.  With the global array cache enabled,
+// the file is read, which must give the written values, then rewritten
+// with the values of each array reversed and given back its modification
+// time.  The next update must come from the
+// cache and give the first values, in arrays independent of both the
+// first output and the cache.  With the cache disabled the reversed
+// values must be read.
+
+#include "vtkCellData.h"
+#include "vtkDataArrayCache.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#include <math.h>
+#include <sys/types.h>
+#if defined(_WIN32)
+# include <sys/utime.h>
+#else
+# include <utime.h>
+#endif
+
+typedef vtkstd::vector<vtkSmartPointer<vtkDataArray> > ArrayList;
+
+static const char *PointArrayNames[] = { "a", "b", "c" };
+
+//----------------------------------------------------------------------------
+static vtkSmartPointer<vtkImageData> MakeImage(int reversed)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(20, 15, 8);
+  vtkIdType numPts = image->GetNumberOfPoints();
+  vtkIdType numCells = image->GetNumberOfCells();
+  for (int k = 0; k < 3; k++)
+    {
+    vtkSmartPointer<vtkFloatArray> array =
+      vtkSmartPointer<vtkFloatArray>::New();
+    array->SetName(PointArrayNames[k]);
+    array->SetNumberOfTuples(numPts);
+    for (vtkIdType i = 0; i < numPts; i++)
+      {
+      vtkIdType j = reversed ? numPts - 1 - i : i;
+      array->SetValue(i, static_cast<float>(k*1000.0 + sin(0.01*j)*j));
+      }
+    image->GetPointData()->AddArray(array);
+    }
+  vtkSmartPointer<vtkIntArray> ids = vtkSmartPointer<vtkIntArray>::New();
+  ids->SetName("ids");
+  ids->SetNumberOfTuples(numCells);
+  for (vtkIdType i = 0; i < numCells; i++)
+    {
+    ids->SetValue(i, static_cast<int>(reversed ? numCells - 1 - i : i));
+    }
+  image->GetCellData()->AddArray(ids);
+  return image;
+}
+
+//----------------------------------------------------------------------------
+static void WriteImage(const char *fileName, vtkImageData *image)
+{
+  vtkSmartPointer<vtkXMLImageDataWriter> writer =
+    vtkSmartPointer<vtkXMLImageDataWriter>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetNumberOfPieces(2);
+  writer->SetDataModeToAppended();
+  writer->EncodeAppendedDataOff();
+  writer->SetCompressorTypeToNone();
+  writer->Write();
+}
+
+//----------------------------------------------------------------------------
+static void GetArrays(vtkDataSet *data, ArrayList &arrays)
+{
+  vtkDataSetAttributes *attributes[2] =
+    { data->GetPointData(), data->GetCellData() };
+  for (int j = 0; j < 2; j++)
+    {
+    for (int k = 0; k < attributes[j]->GetNumberOfArrays(); k++)
+      {
+      arrays.push_back(attributes[j]->GetArray(k));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Compare the values of the arrays of the output with the expected ones.
+// No array of the output may be one of the previous arrays.
+static int CompareArrays(vtkDataSet *output, const ArrayList &expected,
+                         const ArrayList &previous)
+{
+  ArrayList arrays;
+  GetArrays(output, arrays);
+  if (arrays.size() != expected.size())
+    {
+    cerr << "Read " << arrays.size() << " arrays instead of "
+         << expected.size() << ".\n";
+    return 0;
+    }
+  for (size_t i = 0; i < arrays.size(); i++)
+    {
+    vtkDataArray *array = arrays[i];
+    vtkDataArray *expectedArray = expected[i];
+    if (strcmp(array->GetName(), expectedArray->GetName()) ||
+        array->GetNumberOfTuples() != expectedArray->GetNumberOfTuples())
+      {
+      cerr << "Array " << array->GetName() << " does not match.\n";
+      return 0;
+      }
+    for (vtkIdType j = 0; j < array->GetNumberOfTuples(); j++)
+      {
+      if (array->GetComponent(j, 0) != expectedArray->GetComponent(j, 0))
+        {
+        cerr << "Array " << array->GetName() << " differs at tuple " << j
+             << ".\n";
+        return 0;
+        }
+      }
+    for (size_t p = 0; p < previous.size(); p++)
+      {
+      if (previous[p] == array)
+        {
+        cerr << "Array " << array->GetName() << " was handed out twice.\n";
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int TestXMLReaderCache(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string fileName = tempDir;
+  fileName += "/TestXMLReaderCache.vti";
+  delete [] tempDir;
+
+  vtkDataArrayCache *cache = vtkDataArrayCache::GetGlobalCache();
+  double capacity = cache->GetCapacity();
+  cache->SetCapacity(16.0);
+
+  vtkSmartPointer<vtkImageData> image = MakeImage(0);
+  ArrayList expected;
+  GetArrays(image, expected);
+  WriteImage(fileName.c_str(), image);
+  vtkSmartPointer<vtkXMLImageDataReader> reader =
+    vtkSmartPointer<vtkXMLImageDataReader>::New();
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  ArrayList first;
+  GetArrays(reader->GetOutput(), first);
+
+  int rval = 0;
+  ArrayList none;
+  if (!CompareArrays(reader->GetOutput(), expected, none) ||
+      cache->GetNumberOfEntries() == 0)
+    {
+    cerr << "The first read gave other values or cached nothing.\n";
+    rval = 1;
+    }
+
+  // the same bytes in the reverse order, with the time of the first file
+  long int modifiedTime =
+    vtksys::SystemTools::ModifiedTime(fileName.c_str());
+  unsigned long length = vtksys::SystemTools::FileLength(fileName.c_str());
+  vtkSmartPointer<vtkImageData> reversed = MakeImage(1);
+  WriteImage(fileName.c_str(), reversed);
+  struct utimbuf times;
+  times.actime = modifiedTime;
+  times.modtime = modifiedTime;
+  utime(fileName.c_str(), &times);
+  if (vtksys::SystemTools::FileLength(fileName.c_str()) != length)
+    {
+    cerr << "The rewritten file has another length.\n";
+    rval = 1;
+    }
+
+  reader->Modified();
+  reader->Update();
+  if (!CompareArrays(reader->GetOutput(), expected, first))
+    {
+    cerr << "The second read did not come from the cache.\n";
+    rval = 1;
+    }
+
+  // modifying the output must not modify the cache
+  ArrayList second;
+  GetArrays(reader->GetOutput(), second);
+  for (size_t i = 0; i < second.size(); i++)
+    {
+    second[i]->FillComponent(0, -1.0);
+    }
+  reader->Modified();
+  reader->Update();
+  ArrayList previous = first;
+  previous.insert(previous.end(), second.begin(), second.end());
+  if (!CompareArrays(reader->GetOutput(), expected, previous))
+    {
+    cerr << "The cached values were modified through the output.\n";
+    rval = 1;
+    }
+
+  // the arrays handed out first must not have been refilled
+  vtkSmartPointer<vtkImageData> firstOutput =
+    vtkSmartPointer<vtkImageData>::New();
+  firstOutput->CopyStructure(reader->GetOutput());
+  for (size_t i = 0; i < first.size(); i++)
+    {
+    if (i < 3)
+      {
+      firstOutput->GetPointData()->AddArray(first[i]);
+      }
+    else
+      {
+      firstOutput->GetCellData()->AddArray(first[i]);
+      }
+    }
+  if (!CompareArrays(firstOutput, expected, none))
+    {
+    cerr << "The arrays of the first read were modified.\n";
+    rval = 1;
+    }
+
+  // without the cache the reversed values are read
+  cache->SetCapacity(0.0);
+  reader->Modified();
+  reader->Update();
+  ArrayList reversedArrays;
+  GetArrays(reversed, reversedArrays);
+  if (!CompareArrays(reader->GetOutput(), reversedArrays, none))
+    {
+    cerr << "The rewritten file was not read without the cache.\n";
+    rval = 1;
+    }
+
+  cache->SetCapacity(capacity);
+  vtksys::SystemTools::RemoveFile(fileName.c_str());
+
+  return rval;
+}
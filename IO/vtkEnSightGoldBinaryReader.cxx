@@ -21,6 +21,7 @@
 #include "vtkMultiBlockDataSet.h"
 #include "vtkIdList.h"
 #include "vtkImageData.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
@@ -31,12 +32,120 @@
 #include <sys/stat.h>
 #include <ctype.h>
 #include <vtkstd/string>
+#include <vtkstd/vector>
 
 vtkStandardNewMacro(vtkEnSightGoldBinaryReader);
 
 // This is half the precision of an int.
 #define MAXIMUM_PART_ID 65536
 
+// The position of numComponents float arrays of NumberOfFloats values
+// each, stored one after the other in the file, and where their values go.
+struct vtkEnSightGoldBinaryReaderFloatBlock
+{
+  vtkTypeInt64 Offset;
+  int NumberOfFloats;
+  int NumberOfComponents;
+  vtkFloatArray *Array;
+  int Component;
+  vtkIdList *Ids;
+};
+
+class vtkEnSightGoldBinaryReaderFloatBlocks
+{
+public:
+  vtkstd::string FileName;
+  vtkstd::vector<vtkEnSightGoldBinaryReaderFloatBlock> Blocks;
+};
+
+struct vtkEnSightGoldBinaryReaderThreadStruct
+{
+  const char *FileName;
+  int Fortran;
+  int BigEndian;
+  const vtkstd::vector<vtkEnSightGoldBinaryReaderFloatBlock> *Blocks;
+  int Failed[VTK_MAX_THREADS];
+};
+
+//----------------------------------------------------------------------------
+// Each thread opens the file on its own and handles every NumberOfThreads-th
+// block: it reads the block in one piece, swaps the bytes of all its values
+// at once and scatters them into the array.
+static VTK_THREAD_RETURN_TYPE vtkEnSightGoldBinaryReaderReadFloats(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkEnSightGoldBinaryReaderThreadStruct *str =
+    static_cast<vtkEnSightGoldBinaryReaderThreadStruct*>(info->UserData);
+  const vtkstd::vector<vtkEnSightGoldBinaryReaderFloatBlock> &blocks =
+    *str->Blocks;
+
+#ifdef _WIN32
+  ifstream file(str->FileName, ios::in | ios::binary);
+#else
+  ifstream file(str->FileName, ios::in);
+#endif
+  if (file.fail())
+    {
+    str->Failed[info->ThreadID] = 1;
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  // With Fortran records, each array is framed by two 4 byte lengths,
+  // which take one float each in the buffer.
+  int frame = str->Fortran ? 1 : 0;
+  vtkstd::vector<float> buffer;
+  for (size_t b = info->ThreadID; b < blocks.size(); b += info->NumberOfThreads)
+    {
+    const vtkEnSightGoldBinaryReaderFloatBlock &block = blocks[b];
+    int stride = block.NumberOfFloats + 2*frame;
+    buffer.resize(static_cast<size_t>(stride)*block.NumberOfComponents);
+    file.seekg(block.Offset, ios::beg);
+    if (!file.read(reinterpret_cast<char*>(&buffer[0]),
+                   sizeof(float)*buffer.size()))
+      {
+      str->Failed[info->ThreadID] = 1;
+      return VTK_THREAD_RETURN_VALUE;
+      }
+    if (str->BigEndian)
+      {
+      vtkByteSwap::Swap4BERange(&buffer[0], static_cast<int>(buffer.size()));
+      }
+    else
+      {
+      vtkByteSwap::Swap4LERange(&buffer[0], static_cast<int>(buffer.size()));
+      }
+
+    int numComp = block.Array->GetNumberOfComponents();
+    vtkIdType numTuples = block.Array->GetNumberOfTuples();
+    float *data = block.Array->GetPointer(0);
+    for (int c = 0; c < block.NumberOfComponents; c++)
+      {
+      const float *values = &buffer[0] + c*stride + frame;
+      float *out = data + block.Component + c;
+      if (block.Ids)
+        {
+        const vtkIdType *ids = block.Ids->GetPointer(0);
+        for (int i = 0; i < block.NumberOfFloats; i++)
+          {
+          if (ids[i] >= 0 && ids[i] < numTuples)
+            {
+            out[ids[i]*numComp] = values[i];
+            }
+          }
+        }
+      else
+        {
+        for (int i = 0; i < block.NumberOfFloats && i < numTuples; i++)
+          {
+          out[i*numComp] = values[i];
+          }
+        }
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 //----------------------------------------------------------------------------
 vtkEnSightGoldBinaryReader::vtkEnSightGoldBinaryReader()
 {
@@ -45,6 +154,8 @@ vtkEnSightGoldBinaryReader::vtkEnSightGoldBinaryReader()
   this->Fortran = 0;
   this->NodeIdsListed = 0;
   this->ElementIdsListed = 0;
+  this->FloatBlocks = new vtkEnSightGoldBinaryReaderFloatBlocks;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
 }
 
 //----------------------------------------------------------------------------
@@ -56,6 +167,7 @@ vtkEnSightGoldBinaryReader::~vtkEnSightGoldBinaryReader()
     delete this->IFile;
     this->IFile = NULL;
     }
+  delete this->FloatBlocks;
 }
 
 //----------------------------------------------------------------------------
@@ -67,6 +179,9 @@ int vtkEnSightGoldBinaryReader::OpenFile(const char* filename)
     return 0;
     }
 
+  this->FloatBlocks->FileName = filename;
+  this->FloatBlocks->Blocks.clear();
+
   // Close file from any previous image
   if (this->IFile)
     {
@@ -319,6 +434,7 @@ int vtkEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int timeS
     if (partId < 0 || partId >= MAXIMUM_PART_ID)
       {
       vtkErrorMacro("Invalid part id; check that ByteOrder is set correctly.");
+      this->FloatBlocks->Blocks.clear();
       return 0;
       }
     realId = this->InsertNewPartId(partId);
@@ -383,6 +499,7 @@ int vtkEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int timeS
           delete this->IFile;
           this->IFile = NULL;
           }
+        this->FloatBlocks->Blocks.clear();
         return 0;
         }
       }
@@ -397,10 +514,11 @@ int vtkEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int timeS
     }
   if (lineRead < 0)
     {
+    this->FloatBlocks->Blocks.clear();
     return 0;
     }
 
-  return 1;
+  return this->ReadRecordedFloatArrays();
 }
 
 
@@ -1422,13 +1540,7 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerNode(
           GetArray(description));
         }
 
-      scalarsRead = new float[numPts];
-      this->ReadFloatArray(scalarsRead, numPts);
-
-      for (i = 0; i < numPts; i++)
-        {
-        scalars->SetComponent(i, component, scalarsRead[i]);
-        }
+      this->RecordFloatArrays(scalars, component, numPts, 1);
       if (component == 0)
         {
         scalars->SetName(description);
@@ -1443,7 +1555,6 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerNode(
         {
         output->GetPointData()->AddArray(scalars);
         }
-      delete [] scalarsRead;
       }
 
     this->IFile->peek();
@@ -1461,7 +1572,7 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerNode(
     delete this->IFile;
     this->IFile = NULL;
     }
-  return 1;
+  return this->ReadRecordedFloatArrays();
 }
 
 //----------------------------------------------------------------------------
@@ -1472,8 +1583,6 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerNode(
   char line[80];
   int partId, realId, numPts, i, lineRead;
   vtkFloatArray *vectors;
-  float tuple[3];
-  float *comp1, *comp2, *comp3;
   float *vectorsRead;
   vtkDataSet *output;
 
@@ -1602,30 +1711,15 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerNode(
       this->ReadLine(line); // "coordinates" or "block"
       vectors->SetNumberOfComponents(3);
       vectors->SetNumberOfTuples(numPts);
-      comp1 = new float[numPts];
-      comp2 = new float[numPts];
-      comp3 = new float[numPts];
-      this->ReadFloatArray(comp1, numPts);
-      this->ReadFloatArray(comp2, numPts);
-      this->ReadFloatArray(comp3, numPts);
-      for (i = 0; i < numPts; i++)
-        {
-        tuple[0] = comp1[i];
-        tuple[1] = comp2[i];
-        tuple[2] = comp3[i];
-        vectors->SetTuple(i, tuple);
-        }
+      this->RecordFloatArrays(vectors, 0, numPts, 3);
       vectors->SetName(description);
       output->GetPointData()->AddArray(vectors);
       if (!output->GetPointData()->GetVectors())
         {
         output->GetPointData()->SetVectors(vectors);
         }
-      vectors->Delete();
-      delete [] comp1;
-      delete [] comp2;
-      delete [] comp3;
       }
+    vectors->Delete();
 
     this->IFile->peek();
     if (this->IFile->eof())
@@ -1643,7 +1737,7 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerNode(
     this->IFile = NULL;
     }
 
-  return 1;
+  return this->ReadRecordedFloatArrays();
 }
 
 //----------------------------------------------------------------------------
@@ -1654,8 +1748,6 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerNode(
   char line[80];
   int partId, realId, numPts, i, lineRead;
   vtkFloatArray *tensors;
-  float *comp1, *comp2, *comp3, *comp4, *comp5, *comp6;
-  float tuple[6];
   vtkDataSet *output;
 
   // Initialize
@@ -1737,37 +1829,10 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerNode(
       this->ReadLine(line); // "coordinates" or "block"
       tensors->SetNumberOfComponents(6);
       tensors->SetNumberOfTuples(numPts);
-      comp1 = new float[numPts];
-      comp2 = new float[numPts];
-      comp3 = new float[numPts];
-      comp4 = new float[numPts];
-      comp5 = new float[numPts];
-      comp6 = new float[numPts];
-      this->ReadFloatArray(comp1, numPts);
-      this->ReadFloatArray(comp2, numPts);
-      this->ReadFloatArray(comp3, numPts);
-      this->ReadFloatArray(comp4, numPts);
-      this->ReadFloatArray(comp5, numPts);
-      this->ReadFloatArray(comp6, numPts);
-      for (i = 0; i < numPts; i++)
-        {
-        tuple[0] = comp1[i];
-        tuple[1] = comp2[i];
-        tuple[2] = comp3[i];
-        tuple[3] = comp4[i];
-        tuple[4] = comp5[i];
-        tuple[5] = comp6[i];
-        tensors->InsertTuple(i, tuple);
-        }
+      this->RecordFloatArrays(tensors, 0, numPts, 6);
       tensors->SetName(description);
       output->GetPointData()->AddArray(tensors);
       tensors->Delete();
-      delete [] comp1;
-      delete [] comp2;
-      delete [] comp3;
-      delete [] comp4;
-      delete [] comp5;
-      delete [] comp6;
       }
 
     this->IFile->peek();
@@ -1786,7 +1851,7 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerNode(
     this->IFile = NULL;
     }
 
-  return 1;
+  return this->ReadRecordedFloatArrays();
 }
 
 //----------------------------------------------------------------------------
@@ -1798,7 +1863,6 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerElement(
   char line[80];
   int partId, realId, numCells, numCellsPerElement, i, idx;
   vtkFloatArray *scalars;
-  float *scalarsRead;
   int lineRead, elementType;
   vtkDataSet *output;
 
@@ -1879,6 +1943,7 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerElement(
                   delete this->IFile;
                   this->IFile = NULL;
                   }
+                this->FloatBlocks->Blocks.clear();
                 return 0;
                 }
               idx = this->UnstructuredPartIds->IsId(realId);
@@ -1930,12 +1995,7 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerElement(
       // type (and what their ids are) -- IF THIS IS NOT A BLOCK SECTION
       if (strncmp(line, "block", 5) == 0)
         {
-        scalarsRead = new float[numCells];
-        this->ReadFloatArray(scalarsRead, numCells);
-        for (i = 0; i < numCells; i++)
-          {
-          scalars->SetComponent(i, component, scalarsRead[i]);
-          }
+        this->RecordFloatArrays(scalars, component, numCells, 1);
         if (this->IFile->eof())
           {
           lineRead = 0;
@@ -1944,7 +2004,6 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerElement(
           {
           lineRead = this->ReadLine(line);
           }
-        delete [] scalarsRead;
         }
       else
         {
@@ -1965,18 +2024,14 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerElement(
               {
               scalars->Delete();
               }
+            this->FloatBlocks->Blocks.clear();
             return 0;
             }
           idx = this->UnstructuredPartIds->IsId(realId);
           numCellsPerElement =
             this->GetCellIds(idx, elementType)->GetNumberOfIds();
-          scalarsRead = new float[numCellsPerElement];
-          this->ReadFloatArray(scalarsRead, numCellsPerElement);
-          for (i = 0; i < numCellsPerElement; i++)
-            {
-            scalars->SetComponent(this->GetCellIds(idx, elementType)->GetId(i),
-              component, scalarsRead[i]);
-            }
+          this->RecordFloatArrays(scalars, component, numCellsPerElement, 1,
+            this->GetCellIds(idx, elementType));
           this->IFile->peek();
           if (this->IFile->eof())
             {
@@ -1986,7 +2041,6 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerElement(
             {
             lineRead = this->ReadLine(line);
             }
-          delete [] scalarsRead;
           } // end while
         } // end else
       if (component == 0)
@@ -2024,7 +2078,7 @@ int vtkEnSightGoldBinaryReader::ReadScalarsPerElement(
     delete this->IFile;
     this->IFile = NULL;
     }
-  return 1;
+  return this->ReadRecordedFloatArrays();
 }
 
 //----------------------------------------------------------------------------
@@ -2035,9 +2089,7 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerElement(
   char line[80];
   int partId, realId, numCells, numCellsPerElement, i, idx;
   vtkFloatArray *vectors;
-  float *comp1, *comp2, *comp3;
   int lineRead, elementType;
-  float tuple[3];
   vtkDataSet *output;
 
   // Initialize
@@ -2113,6 +2165,7 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerElement(
                 vtkErrorMacro("Unknown element type \"" << line << "\"");
                 delete this->IS;
                 this->IS = NULL;
+                this->FloatBlocks->Blocks.clear();
                 return 0;
                 }
               idx = this->UnstructuredPartIds->IsId(realId);
@@ -2157,19 +2210,7 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerElement(
       // type (and what their ids are) -- IF THIS IS NOT A BLOCK SECTION
       if (strncmp(line, "block", 5) == 0)
         {
-        comp1 = new float[numCells];
-        comp2 = new float[numCells];
-        comp3 = new float[numCells];
-        this->ReadFloatArray(comp1, numCells);
-        this->ReadFloatArray(comp2, numCells);
-        this->ReadFloatArray(comp3, numCells);
-        for (i = 0; i < numCells; i++)
-          {
-          tuple[0] = comp1[i];
-          tuple[1] = comp2[i];
-          tuple[2] = comp3[i];
-          vectors->SetTuple(i, tuple);
-          }
+        this->RecordFloatArrays(vectors, 0, numCells, 3);
         this->IFile->peek();
         if (this->IFile->eof())
           {
@@ -2179,9 +2220,6 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerElement(
           {
           lineRead = this->ReadLine(line);
           }
-        delete [] comp1;
-        delete [] comp2;
-        delete [] comp3;
         }
       else
         {
@@ -2195,25 +2233,14 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerElement(
             delete this->IS;
             this->IS = NULL;
             vectors->Delete();
+            this->FloatBlocks->Blocks.clear();
             return 0;
             }
           idx = this->UnstructuredPartIds->IsId(realId);
           numCellsPerElement =
             this->GetCellIds(idx, elementType)->GetNumberOfIds();
-          comp1 = new float[numCellsPerElement];
-          comp2 = new float[numCellsPerElement];
-          comp3 = new float[numCellsPerElement];
-          this->ReadFloatArray(comp1, numCellsPerElement);
-          this->ReadFloatArray(comp2, numCellsPerElement);
-          this->ReadFloatArray(comp3, numCellsPerElement);
-          for (i = 0; i < numCellsPerElement; i++)
-            {
-            tuple[0] = comp1[i];
-            tuple[1] = comp2[i];
-            tuple[2] = comp3[i];
-            vectors->SetTuple(this->GetCellIds(idx, elementType)->GetId(i),
-              tuple);
-            }
+          this->RecordFloatArrays(vectors, 0, numCellsPerElement, 3,
+            this->GetCellIds(idx, elementType));
           this->IFile->peek();
           if (this->IFile->eof())
             {
@@ -2223,9 +2250,6 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerElement(
             {
             lineRead = this->ReadLine(line);
             }
-          delete [] comp1;
-          delete [] comp2;
-          delete [] comp3;
           } // end while
         } // end else
       vectors->SetName(description);
@@ -2256,7 +2280,7 @@ int vtkEnSightGoldBinaryReader::ReadVectorsPerElement(
     delete this->IFile;
     this->IFile = NULL;
     }
-  return 1;
+  return this->ReadRecordedFloatArrays();
 }
 
 //----------------------------------------------------------------------------
@@ -2268,8 +2292,6 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerElement(
   int partId, realId, numCells, numCellsPerElement, i, idx;
   vtkFloatArray *tensors;
   int lineRead, elementType;
-  float *comp1, *comp2, *comp3, *comp4, *comp5, *comp6;
-  float tuple[6];
   vtkDataSet *output;
 
   // Initialize
@@ -2345,6 +2367,7 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerElement(
                 vtkErrorMacro("Unknown element type \"" << line << "\"");
                 delete this->IS;
                 this->IS = NULL;
+                this->FloatBlocks->Blocks.clear();
                 return 0;
                 }
               idx = this->UnstructuredPartIds->IsId(realId);
@@ -2390,28 +2413,7 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerElement(
       // type (and what their ids are) -- IF THIS IS NOT A BLOCK SECTION
       if (strncmp(line, "block", 5) == 0)
         {
-        comp1 = new float[numCells];
-        comp2 = new float[numCells];
-        comp3 = new float[numCells];
-        comp4 = new float[numCells];
-        comp5 = new float[numCells];
-        comp6 = new float[numCells];
-        this->ReadFloatArray(comp1, numCells);
-        this->ReadFloatArray(comp2, numCells);
-        this->ReadFloatArray(comp3, numCells);
-        this->ReadFloatArray(comp4, numCells);
-        this->ReadFloatArray(comp5, numCells);
-        this->ReadFloatArray(comp6, numCells);
-        for (i = 0; i < numCells; i++)
-          {
-          tuple[0] = comp1[i];
-          tuple[1] = comp2[i];
-          tuple[2] = comp3[i];
-          tuple[3] = comp4[i];
-          tuple[4] = comp5[i];
-          tuple[5] = comp6[i];
-          tensors->InsertTuple(i, tuple);
-          }
+        this->RecordFloatArrays(tensors, 0, numCells, 6);
         this->IFile->peek();
         if (this->IFile->eof())
           {
@@ -2421,12 +2423,6 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerElement(
           {
           lineRead = this->ReadLine(line);
           }
-        delete [] comp1;
-        delete [] comp2;
-        delete [] comp3;
-        delete [] comp4;
-        delete [] comp5;
-        delete [] comp6;
         }
       else
         {
@@ -2440,34 +2436,14 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerElement(
             delete this->IS;
             this->IS = NULL;
             tensors->Delete();
+            this->FloatBlocks->Blocks.clear();
             return 0;
             }
           idx = this->UnstructuredPartIds->IsId(realId);
           numCellsPerElement =
             this->GetCellIds(idx, elementType)->GetNumberOfIds();
-          comp1 = new float[numCellsPerElement];
-          comp2 = new float[numCellsPerElement];
-          comp3 = new float[numCellsPerElement];
-          comp4 = new float[numCellsPerElement];
-          comp5 = new float[numCellsPerElement];
-          comp6 = new float[numCellsPerElement];
-          this->ReadFloatArray(comp1, numCellsPerElement);
-          this->ReadFloatArray(comp2, numCellsPerElement);
-          this->ReadFloatArray(comp3, numCellsPerElement);
-          this->ReadFloatArray(comp4, numCellsPerElement);
-          this->ReadFloatArray(comp5, numCellsPerElement);
-          this->ReadFloatArray(comp6, numCellsPerElement);
-          for (i = 0; i < numCellsPerElement; i++)
-            {
-            tuple[0] = comp1[i];
-            tuple[1] = comp2[i];
-            tuple[2] = comp3[i];
-            tuple[3] = comp4[i];
-            tuple[4] = comp5[i];
-            tuple[5] = comp6[i];
-            tensors->InsertTuple(this->GetCellIds(idx, elementType)->GetId(i),
-              tuple);
-            }
+          this->RecordFloatArrays(tensors, 0, numCellsPerElement, 6,
+            this->GetCellIds(idx, elementType));
           this->IFile->peek();
           if (this->IFile->eof())
             {
@@ -2477,12 +2453,6 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerElement(
             {
             lineRead = this->ReadLine(line);
             }
-          delete [] comp1;
-          delete [] comp2;
-          delete [] comp3;
-          delete [] comp4;
-          delete [] comp5;
-          delete [] comp6;
           } // end while
         } // end else
       tensors->SetName(description);
@@ -2509,7 +2479,7 @@ int vtkEnSightGoldBinaryReader::ReadTensorsPerElement(
     delete this->IFile;
     this->IFile = NULL;
     }
-  return 1;
+  return this->ReadRecordedFloatArrays();
 }
 
 //----------------------------------------------------------------------------
@@ -2523,7 +2493,6 @@ int vtkEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
   int *nodeIdList;
   int numElements;
   int idx, cellId, cellType;
-  float *xCoords, *yCoords, *zCoords;
 
   this->NumberOfNewOutputs++;
 
@@ -2568,30 +2537,18 @@ int vtkEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       vtkPoints *points = vtkPoints::New();
       vtkDebugMacro("num. points: " << numPts);
 
-      points->Allocate(numPts);
+      points->SetNumberOfPoints(numPts);
 
       if (this->NodeIdsListed)
         {
         this->IFile->seekg(sizeof(int)*numPts, ios::cur);
         }
 
-      xCoords = new float[numPts];
-      yCoords = new float[numPts];
-      zCoords = new float[numPts];
-      this->ReadFloatArray(xCoords, numPts);
-      this->ReadFloatArray(yCoords, numPts);
-      this->ReadFloatArray(zCoords, numPts);
-
-      for (i = 0; i < numPts; i++)
-        {
-        points->InsertNextPoint(xCoords[i], yCoords[i], zCoords[i]);
-        }
+      this->RecordFloatArrays(
+        vtkFloatArray::SafeDownCast(points->GetData()), 0, numPts, 3);
 
       output->SetPoints(points);
       points->Delete();
-      delete [] xCoords;
-      delete [] yCoords;
-      delete [] zCoords;
       }
     else if (strncmp(line, "point", 5) == 0)
       {
@@ -3631,7 +3588,6 @@ int vtkEnSightGoldBinaryReader::CreateStructuredGridOutput(
   int i;
   vtkPoints *points = vtkPoints::New();
   int numPts;
-  float *xCoords, *yCoords, *zCoords;
 
   this->NumberOfNewOutputs++;
 
@@ -3675,19 +3631,9 @@ int vtkEnSightGoldBinaryReader::CreateStructuredGridOutput(
   output->SetDimensions(dimensions);
   output->SetWholeExtent(
     0, dimensions[0]-1, 0, dimensions[1]-1, 0, dimensions[2]-1);
-  points->Allocate(numPts);
-
-  xCoords = new float[numPts];
-  yCoords = new float[numPts];
-  zCoords = new float[numPts];
-  this->ReadFloatArray(xCoords, numPts);
-  this->ReadFloatArray(yCoords, numPts);
-  this->ReadFloatArray(zCoords, numPts);
-
-  for (i = 0; i < numPts; i++)
-    {
-    points->InsertNextPoint(xCoords[i], yCoords[i], zCoords[i]);
-    }
+  points->SetNumberOfPoints(numPts);
+  this->RecordFloatArrays(
+    vtkFloatArray::SafeDownCast(points->GetData()), 0, numPts, 3);
   output->SetPoints(points);
   if (iblanked)
     {
@@ -3705,9 +3651,6 @@ int vtkEnSightGoldBinaryReader::CreateStructuredGridOutput(
     }
 
   points->Delete();
-  delete [] xCoords;
-  delete [] yCoords;
-  delete [] zCoords;
 
   this->IFile->peek();
   if (this->IFile->eof())
@@ -4124,8 +4067,94 @@ int vtkEnSightGoldBinaryReader::ReadFloatArray(float *result,
   return 1;
 }
 
+// Internal function to skip float arrays and record their position.
+// Returns zero if there was an error.
+int vtkEnSightGoldBinaryReader::RecordFloatArrays(vtkFloatArray *array,
+  int component, int numFloats, int numComponents, vtkIdList *ids)
+{
+  if (numFloats <= 0)
+    {
+    return 1;
+    }
+
+  vtkEnSightGoldBinaryReaderFloatBlock block;
+  block.Offset = static_cast<vtkTypeInt64>(this->IFile->tellg());
+  block.NumberOfFloats = numFloats;
+  block.NumberOfComponents = numComponents;
+  block.Array = array;
+  block.Component = component;
+  block.Ids = ids;
+
+  vtkTypeInt64 size = static_cast<vtkTypeInt64>(sizeof(float))*numFloats;
+  if (this->Fortran)
+    {
+    size += 8;
+    }
+  this->IFile->seekg(size*numComponents, ios::cur);
+  if (block.Offset < 0 || this->IFile->fail())
+    {
+    vtkErrorMacro("Seek failed.");
+    return 0;
+    }
+  this->FloatBlocks->Blocks.push_back(block);
+  return 1;
+}
+
+// Internal function to read the recorded float arrays with several threads.
+// Returns zero if there was an error.
+int vtkEnSightGoldBinaryReader::ReadRecordedFloatArrays()
+{
+  vtkstd::vector<vtkEnSightGoldBinaryReaderFloatBlock> &blocks =
+    this->FloatBlocks->Blocks;
+  if (blocks.empty())
+    {
+    return 1;
+    }
+
+  vtkEnSightGoldBinaryReaderThreadStruct str;
+  str.FileName = this->FloatBlocks->FileName.c_str();
+  str.Fortran = this->Fortran;
+  str.BigEndian = (this->ByteOrder != FILE_LITTLE_ENDIAN);
+  str.Blocks = &blocks;
+  int numThreads = this->NumberOfThreads;
+  if (numThreads > static_cast<int>(blocks.size()))
+    {
+    numThreads = static_cast<int>(blocks.size());
+    }
+  int i;
+  for (i = 0; i < numThreads; i++)
+    {
+    str.Failed[i] = 0;
+    }
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numThreads);
+  threader->SetSingleMethod(vtkEnSightGoldBinaryReaderReadFloats, &str);
+  threader->SingleMethodExecute();
+  threader->Delete();
+
+  // The values were written through raw pointers.
+  size_t b;
+  for (b = 0; b < blocks.size(); b++)
+    {
+    blocks[b].Array->Modified();
+    }
+  blocks.clear();
+
+  for (i = 0; i < numThreads; i++)
+    {
+    if (str.Failed[i])
+      {
+      vtkErrorMacro("Read failed.");
+      return 0;
+      }
+    }
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkEnSightGoldBinaryReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
 }
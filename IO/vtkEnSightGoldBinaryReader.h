@@ -31,6 +31,12 @@
 // what types they will be.
 // This reader can only handle static EnSight datasets (both static geometry
 // and variables).
+//
+// Binary files are read in two passes. The first pass walks the file,
+// builds the outputs and records where the coordinates and variable values
+// of each part are stored. The second pass reads and byte-swaps the
+// recorded values with several threads, each using its own file stream,
+// and stores them directly into their arrays.
 // .SECTION Thanks
 // Thanks to Yvan Fournier for providing the code to support nfaced elements.
 
@@ -39,6 +45,9 @@
 
 #include "vtkEnSightReader.h"
 
+class vtkEnSightGoldBinaryReaderFloatBlocks;
+class vtkFloatArray;
+class vtkIdList;
 class vtkMultiBlockDataSet;
 
 class VTK_IO_EXPORT vtkEnSightGoldBinaryReader : public vtkEnSightReader
@@ -48,6 +57,14 @@ public:
   vtkTypeMacro(vtkEnSightGoldBinaryReader, vtkEnSightReader);
   virtual void PrintSelf(ostream& os, vtkIndent indent);
 
+  // Description:
+  // Set/Get the number of threads that read the recorded coordinates and
+  // variable values of a file in the second pass. Defaults to the global
+  // default number of threads of vtkMultiThreader; 1 reads them in the
+  // calling thread.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   vtkEnSightGoldBinaryReader();
   ~vtkEnSightGoldBinaryReader();
@@ -164,6 +181,22 @@ protected:
   // Returns zero if there was an error.
   int ReadFloatArray(float *result, int numFloats);
 
+  // Description:
+  // Internal function to skip numComponents float arrays of numFloats
+  // values each, as ReadFloatArray() would read them, and to record their
+  // position. The values are stored by ReadRecordedFloatArrays() into
+  // consecutive components of array, starting at component, for the tuples
+  // listed in ids, or for tuples 0 to numFloats-1 if ids is NULL.
+  // Returns zero if there was an error.
+  int RecordFloatArrays(vtkFloatArray *array, int component, int numFloats,
+                        int numComponents, vtkIdList *ids = 0);
+
+  // Description:
+  // Internal function to read the float arrays recorded since the current
+  // file was opened. The arrays are read concurrently.
+  // Returns zero if there was an error.
+  int ReadRecordedFloatArrays();
+
   // Description:
   // Counts the number of timesteps in the geometry file
   // This function assumes the file is already open and returns the
@@ -187,6 +220,10 @@ protected:
   // The size of the file could be used to choose byte order.
   int FileSize;
 
+  // The float arrays recorded in the current file.
+  vtkEnSightGoldBinaryReaderFloatBlocks *FloatBlocks;
+  int NumberOfThreads;
+
 private:
   vtkEnSightGoldBinaryReader(const vtkEnSightGoldBinaryReader&);  // Not implemented.
   void operator=(const vtkEnSightGoldBinaryReader&);  // Not implemented.
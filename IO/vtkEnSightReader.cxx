@@ -14,6 +14,8 @@
 =========================================================================*/
 #include "vtkEnSightReader.h"
 
+#include "vtkCellData.h"
+#include "vtkDataArrayCache.h"
 #include "vtkDataArrayCollection.h"
 #include "vtkFloatArray.h"
 #include "vtkMultiBlockDataSet.h"
@@ -21,7 +23,9 @@
 #include "vtkIdListCollection.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntArray.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -32,6 +36,7 @@
 #include <vtkstd/algorithm>
 #include <vtkstd/string>
 #include <vtkstd/vector>
+#include <vtksys/SystemTools.hxx>
 
 
 //----------------------------------------------------------------------------
@@ -97,6 +102,8 @@ vtkEnSightReader::~vtkEnSightReader()
 {
   int i;
 
+  vtkDataArrayCache::GetGlobalCache()->InvalidateOwner(this);
+
   if (this->CellIds)
     {
     delete this->CellIds;
@@ -1597,43 +1604,57 @@ int vtkEnSightReader::ReadVariableFiles(vtkMultiBlockDataSet *output)
         }
       }
 
-    if (validTime)
+    if (validTime &&
+        !this->RestoreCachedVariable(fileName, timeStepInFile, i, output))
       {
+      int result = 0;
       switch (this->VariableTypes[i])
         {
         case vtkEnSightReader::SCALAR_PER_NODE:
-          this->ReadScalarsPerNode(fileName, this->VariableDescriptions[i],
-                                   timeStepInFile, output);
+          result = this->ReadScalarsPerNode(fileName,
+                                            this->VariableDescriptions[i],
+                                            timeStepInFile, output);
           break;
         case vtkEnSightReader::SCALAR_PER_MEASURED_NODE:
-          this->ReadScalarsPerNode(fileName, this->VariableDescriptions[i],
-                                   timeStepInFile, output, 1);
+          result = this->ReadScalarsPerNode(fileName,
+                                            this->VariableDescriptions[i],
+                                            timeStepInFile, output, 1);
           break;
         case vtkEnSightReader::VECTOR_PER_NODE:
-          this->ReadVectorsPerNode(fileName, this->VariableDescriptions[i],
-                                   timeStepInFile, output);
+          result = this->ReadVectorsPerNode(fileName,
+                                            this->VariableDescriptions[i],
+                                            timeStepInFile, output);
           break;
         case vtkEnSightReader::VECTOR_PER_MEASURED_NODE:
-          this->ReadVectorsPerNode(fileName, this->VariableDescriptions[i],
-                                   timeStepInFile, output, 1);
+          result = this->ReadVectorsPerNode(fileName,
+                                            this->VariableDescriptions[i],
+                                            timeStepInFile, output, 1);
           break;
         case vtkEnSightReader::TENSOR_SYMM_PER_NODE:
-          this->ReadTensorsPerNode(fileName, this->VariableDescriptions[i],
-                                   timeStepInFile, output);
+          result = this->ReadTensorsPerNode(fileName,
+                                            this->VariableDescriptions[i],
+                                            timeStepInFile, output);
           break;
         case vtkEnSightReader::SCALAR_PER_ELEMENT:
-          this->ReadScalarsPerElement(fileName, this->VariableDescriptions[i],
-                                      timeStepInFile, output);
+          result = this->ReadScalarsPerElement(fileName,
+                                               this->VariableDescriptions[i],
+                                               timeStepInFile, output);
           break;
         case vtkEnSightReader::VECTOR_PER_ELEMENT:
-          this->ReadVectorsPerElement(fileName, this->VariableDescriptions[i],
-                                      timeStepInFile, output);
+          result = this->ReadVectorsPerElement(fileName,
+                                               this->VariableDescriptions[i],
+                                               timeStepInFile, output);
           break;
         case vtkEnSightReader::TENSOR_SYMM_PER_ELEMENT:
-          this->ReadTensorsPerElement(fileName, this->VariableDescriptions[i],
-                                      timeStepInFile, output);
+          result = this->ReadTensorsPerElement(fileName,
+                                               this->VariableDescriptions[i],
+                                               timeStepInFile, output);
           break;
         }
+      if (result)
+        {
+        this->CacheVariable(fileName, timeStepInFile, i, output);
+        }
       }
     delete [] fileName;
     }
@@ -1791,6 +1812,207 @@ int vtkEnSightReader::ReadVariableFiles(vtkMultiBlockDataSet *output)
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// The arrays of a variable are cached under one key per distinct array (the
+// per node arrays of EnSight6 unstructured parts are shared by all parts),
+// plus a manifest listing (block, array) pairs.  The key holds the time of
+// the geometry the variable was read against, since per element values are
+// laid out according to the element types of the geometry, and the size of
+// the file, since its modification time has a resolution of one second.
+// The cache and the output never share arrays: copies go both ways, so
+// that downstream filters may modify the output.
+static vtkDataArrayCacheKey vtkEnSightReaderVariableKey(
+  vtkEnSightReader* self, const char* filePath, const char* fileName,
+  int timeStep, const char* description, float geometryTime)
+{
+  vtkstd::string fullName;
+  if (filePath)
+    {
+    fullName = filePath;
+    if (!fullName.empty() && fullName[fullName.length()-1] != '/')
+      {
+      fullName += "/";
+      }
+    }
+  fullName += fileName;
+
+  vtkDataArrayCacheKey key(self);
+  key.Append(fullName.c_str())
+    .Append(static_cast<double>(
+              vtksys::SystemTools::ModifiedTime(fullName.c_str())))
+    .Append(static_cast<double>(
+              vtksys::SystemTools::FileLength(fullName.c_str())))
+    .Append(timeStep).Append(description).Append(geometryTime);
+  return key;
+}
+
+//----------------------------------------------------------------------------
+static int vtkEnSightReaderIsCellVariable(int type)
+{
+  return (type == vtkEnSightReader::SCALAR_PER_ELEMENT ||
+          type == vtkEnSightReader::VECTOR_PER_ELEMENT ||
+          type == vtkEnSightReader::TENSOR_SYMM_PER_ELEMENT);
+}
+
+//----------------------------------------------------------------------------
+int vtkEnSightReader::RestoreCachedVariable(const char* fileName,
+                                            int timeStep, int variable,
+                                            vtkMultiBlockDataSet *output)
+{
+  vtkDataArrayCache* cache = vtkDataArrayCache::GetGlobalCache();
+  if (cache->GetCapacity() <= 0.0)
+    {
+    return 0;
+    }
+  int type = this->VariableTypes[variable];
+  int measured = (type == SCALAR_PER_MEASURED_NODE ||
+                  type == VECTOR_PER_MEASURED_NODE);
+  int cellData = vtkEnSightReaderIsCellVariable(type);
+  vtkDataArrayCacheKey key = vtkEnSightReaderVariableKey(
+    this, this->FilePath, fileName, timeStep,
+    this->VariableDescriptions[variable],
+    measured ? this->MeasuredTimeValue : this->GeometryTimeValue);
+
+  vtkDataArrayCacheKey manifestKey = key;
+  manifestKey.Append("parts");
+  vtkSmartPointer<vtkDataArray> manifest;
+  manifest.TakeReference(cache->Find(manifestKey));
+  if (!manifest)
+    {
+    return 0;
+    }
+
+  // Fetch and check everything before touching the output.
+  vtkIdType numBlocks = manifest->GetNumberOfTuples();
+  vtkstd::vector<vtkSmartPointer<vtkDataArray> > arrays;
+  vtkstd::vector<vtkDataSet*> blocks(numBlocks);
+  vtkIdType i;
+  for (i = 0; i < numBlocks; i++)
+    {
+    unsigned int blockNo =
+      static_cast<unsigned int>(manifest->GetComponent(i, 0));
+    size_t slot = static_cast<size_t>(manifest->GetComponent(i, 1));
+    blocks[i] = blockNo < output->GetNumberOfBlocks() ?
+      this->GetDataSetFromBlock(output, blockNo) : 0;
+    if (!blocks[i])
+      {
+      return 0;
+      }
+    if (slot >= arrays.size())
+      {
+      vtkDataArrayCacheKey arrayKey = key;
+      arrayKey.Append(static_cast<int>(slot));
+      vtkDataArray* cached = cache->Find(arrayKey);
+      if (!cached)
+        {
+        return 0;
+        }
+      vtkSmartPointer<vtkDataArray> array;
+      array.TakeReference(cached->NewInstance());
+      array->DeepCopy(cached);
+      array->SetName(this->VariableDescriptions[variable]);
+      cached->Delete();
+      arrays.push_back(array);
+      }
+    vtkIdType numTuples = cellData ?
+      blocks[i]->GetNumberOfCells() : blocks[i]->GetNumberOfPoints();
+    if (arrays[slot]->GetNumberOfTuples() != numTuples)
+      {
+      return 0;
+      }
+    }
+
+  // Attach the arrays the way the Read* methods do.
+  for (i = 0; i < numBlocks; i++)
+    {
+    vtkDataArray* array =
+      arrays[static_cast<size_t>(manifest->GetComponent(i, 1))];
+    vtkDataSetAttributes* attributes = cellData ?
+      static_cast<vtkDataSetAttributes*>(blocks[i]->GetCellData()) :
+      static_cast<vtkDataSetAttributes*>(blocks[i]->GetPointData());
+    attributes->AddArray(array);
+    switch (type)
+      {
+      case SCALAR_PER_NODE:
+      case SCALAR_PER_MEASURED_NODE:
+      case SCALAR_PER_ELEMENT:
+        if (!attributes->GetScalars())
+          {
+          attributes->SetScalars(array);
+          }
+        break;
+      case VECTOR_PER_NODE:
+      case VECTOR_PER_MEASURED_NODE:
+      case VECTOR_PER_ELEMENT:
+        if (!attributes->GetVectors())
+          {
+          attributes->SetVectors(array);
+          }
+        break;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkEnSightReader::CacheVariable(const char* fileName, int timeStep,
+                                     int variable,
+                                     vtkMultiBlockDataSet *output)
+{
+  vtkDataArrayCache* cache = vtkDataArrayCache::GetGlobalCache();
+  if (cache->GetCapacity() <= 0.0)
+    {
+    return;
+    }
+  int type = this->VariableTypes[variable];
+  int measured = (type == SCALAR_PER_MEASURED_NODE ||
+                  type == VECTOR_PER_MEASURED_NODE);
+  int cellData = vtkEnSightReaderIsCellVariable(type);
+  const char* description = this->VariableDescriptions[variable];
+  vtkDataArrayCacheKey key = vtkEnSightReaderVariableKey(
+    this, this->FilePath, fileName, timeStep, description,
+    measured ? this->MeasuredTimeValue : this->GeometryTimeValue);
+
+  vtkIntArray* manifest = vtkIntArray::New();
+  manifest->SetNumberOfComponents(2);
+  vtkstd::vector<vtkDataArray*> arrays;
+  for (unsigned int blockNo = 0; blockNo < output->GetNumberOfBlocks();
+       blockNo++)
+    {
+    vtkDataSet* ds = this->GetDataSetFromBlock(output, blockNo);
+    if (!ds)
+      {
+      continue;
+      }
+    vtkDataArray* array = cellData ?
+      ds->GetCellData()->GetArray(description) :
+      ds->GetPointData()->GetArray(description);
+    if (!array)
+      {
+      continue;
+      }
+    int entry[2];
+    entry[0] = static_cast<int>(blockNo);
+    entry[1] = static_cast<int>(
+      vtkstd::find(arrays.begin(), arrays.end(), array) - arrays.begin());
+    if (entry[1] == static_cast<int>(arrays.size()))
+      {
+      vtkDataArrayCacheKey arrayKey = key;
+      arrayKey.Append(entry[1]);
+      vtkDataArray* copy = array->NewInstance();
+      copy->DeepCopy(array);
+      cache->Insert(arrayKey, copy);
+      copy->Delete();
+      arrays.push_back(array);
+      }
+    manifest->InsertNextTupleValue(entry);
+    }
+
+  key.Append("parts");
+  cache->Insert(key, manifest);
+  manifest->Delete();
+}
+
 //----------------------------------------------------------------------------
 void vtkEnSightReader::AddVariableFileName(const char* fileName1,
                                            const char* fileName2)
@@ -149,6 +149,20 @@ protected:
   // Read the variable files. If an error occurred, 0 is returned; otherwise 1.
   int ReadVariableFiles(vtkMultiBlockDataSet *output);
 
+  // Description:
+  // Add the arrays of variable number "variable" kept in the array cache by
+  // an earlier read of the same file and time step to the output as copies.
+  // Returns 0 (and leaves the output untouched) unless all of them are still
+  // cached and match the parts of the output.
+  int RestoreCachedVariable(const char* fileName, int timeStep, int variable,
+                            vtkMultiBlockDataSet *output);
+
+  // Description:
+  // Put copies of the arrays just read for variable number "variable" into
+  // the array cache.
+  void CacheVariable(const char* fileName, int timeStep, int variable,
+                     vtkMultiBlockDataSet *output);
+
   // Description:
   // Read scalars per node for this dataset.  If an error occurred, 0 is
   // returned; otherwise 1.
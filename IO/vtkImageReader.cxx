@@ -149,6 +149,33 @@ int vtkImageReader::OpenAndSeekFile(int dataExtent[6], int idx)
     {
     return 0;
     }
+  streamStart =
+    this->ComputeStreamStart(dataExtent, this->GetHeaderSize(idx));
+  
+  // error checking
+  this->File->seekg(static_cast<long>(streamStart), ios::beg);
+  if (this->File->fail())
+    {
+    vtkErrorMacro(<< "File operation failed: " << streamStart << ", ext: "
+                  << dataExtent[0] << ", " << dataExtent[1] << ", "
+                  << dataExtent[2] << ", " << dataExtent[3] << ", "
+                  << dataExtent[4] << ", " << dataExtent[5]);
+    vtkErrorMacro(<< "Header size: " << this->GetHeaderSize(idx) << ", file ext: "
+                  << this->DataExtent[0] << ", " << this->DataExtent[1] << ", "
+                  << this->DataExtent[2] << ", " << this->DataExtent[3] << ", "
+                  << this->DataExtent[4] << ", " << this->DataExtent[5]);
+    return 0;
+    }
+  return 1;        
+}
+
+//----------------------------------------------------------------------------
+// Compute the position in the file of the first row of the given extent.
+unsigned long vtkImageReader::ComputeStreamStart(int dataExtent[6],
+                                                 unsigned long headerSize)
+{
+  unsigned long streamStart;
+
   // convert data extent into constants that can be used to seek.
   streamStart = 
     (dataExtent[0] - this->DataExtent[0]) * this->DataIncrements[0];
@@ -172,23 +199,9 @@ int vtkImageReader::OpenAndSeekFile(int dataExtent[6], int idx)
       (dataExtent[4] - this->DataExtent[4]) * this->DataIncrements[2];
     }
   
-  streamStart += this->GetHeaderSize(idx);
-  
-  // error checking
-  this->File->seekg(static_cast<long>(streamStart), ios::beg);
-  if (this->File->fail())
-    {
-    vtkErrorMacro(<< "File operation failed: " << streamStart << ", ext: "
-                  << dataExtent[0] << ", " << dataExtent[1] << ", "
-                  << dataExtent[2] << ", " << dataExtent[3] << ", "
-                  << dataExtent[4] << ", " << dataExtent[5]);
-    vtkErrorMacro(<< "Header size: " << this->GetHeaderSize(idx) << ", file ext: "
-                  << this->DataExtent[0] << ", " << this->DataExtent[1] << ", "
-                  << this->DataExtent[2] << ", " << this->DataExtent[3] << ", "
-                  << this->DataExtent[4] << ", " << this->DataExtent[5]);
-    return 0;
-    }
-  return 1;        
+  streamStart += headerSize;
+
+  return streamStart;
 }
 
 //----------------------------------------------------------------------------
@@ -275,9 +288,19 @@ void vtkImageReaderUpdate2(vtkImageReader *self, vtkImageData *data,
     }
   for (idx2 = dataExtent[4]; idx2 <= dataExtent[5]; ++idx2)
     {
+    // use the file of the slice if it was read ahead into memory
+    const char *slice = NULL;
+    unsigned long sliceLength = 0;
+    long slicePos = 0;
     if (self->GetFileDimensionality() == 2)
       {
-      if ( !self->OpenAndSeekFile(dataExtent,idx2) )
+      slice = self->GetQueuedFile(idx2, &sliceLength);
+      if (slice)
+        {
+        slicePos = static_cast<long>(self->ComputeStreamStart(
+          dataExtent, self->ComputeHeaderSize(sliceLength)));
+        }
+      else if ( !self->OpenAndSeekFile(dataExtent,idx2) )
         {
         delete [] buf;
         return;
@@ -295,13 +318,37 @@ void vtkImageReaderUpdate2(vtkImageReader *self, vtkImageData *data,
       outPtr0 = outPtr1;
 
       // read the row.
-      self->GetFile()->read((char *)buf, streamRead);
+      int prefetched = 0;
+      if (slice)
+        {
+        if (slicePos < 0 ||
+            static_cast<unsigned long>(slicePos) + streamRead > sliceLength)
+          {
+          vtkGenericWarningMacro("File operation failed. row = " << idx1
+                                 << ", Tried to Read = " << streamRead
+                                 << ", FilePos = " << slicePos
+                                 << ", File Length = " << sliceLength);
+          delete [] buf;
+          return;
+          }
+        memcpy(buf, slice + slicePos, streamRead);
+        }
+      else if (self->ReadPrefetchedData((char *)buf, streamRead))
+        {
+        prefetched = 1;
+        }
+      else
+        {
+        self->GetFile()->read((char *)buf, streamRead);
+        }
 #ifdef __APPLE_CC__
-      if (static_cast<unsigned long>(self->GetFile()->gcount()) != streamRead)
+      if (!slice && !prefetched &&
+          static_cast<unsigned long>(self->GetFile()->gcount()) != streamRead)
       // Apple's gcc3 returns fail when reading _to_ eof
 #else
-      if ( static_cast<unsigned long>(self->GetFile()->gcount()) != 
-           streamRead || self->GetFile()->fail())
+      if (!slice && !prefetched &&
+          (static_cast<unsigned long>(self->GetFile()->gcount()) != 
+           streamRead || self->GetFile()->fail()))
 #endif
         {
         vtkGenericWarningMacro("File operation failed. row = " << idx1
@@ -345,6 +392,12 @@ void vtkImageReaderUpdate2(vtkImageReader *self, vtkImageData *data,
         }
 
       // move to the next row in the file and data
+      if (slice)
+        {
+        slicePos += static_cast<long>(streamRead) + streamSkip0;
+        outPtr1 += outIncr[1];
+        continue;
+        }
       filePos = self->GetFile()->tellg();
 
 /* Unfortunately this doesn't work as a fix, but I'll leave it here for a bit
@@ -384,8 +437,15 @@ void vtkImageReaderUpdate2(vtkImageReader *self, vtkImageData *data,
       outPtr1 += outIncr[1];
       }
     // move to the next image in the file and data
-    self->GetFile()->seekg(static_cast<long>(self->GetFile()->tellg()) + streamSkip1 + correction, 
-                      ios::beg);
+    if (slice)
+      {
+      self->ReleaseQueuedFile(idx2);
+      }
+    else
+      {
+      self->GetFile()->seekg(static_cast<long>(self->GetFile()->tellg()) + streamSkip1 + correction, 
+                        ios::beg);
+      }
     outPtr2 += outIncr[2];
     }
 
@@ -440,6 +500,14 @@ void vtkImageReader::ExecuteData(vtkDataObject *output)
   
   this->ComputeDataIncrements();
   
+  // read the files of the next slices while decoding this one
+  if (this->GetFileDimensionality() == 2)
+    {
+    int dataExtent[6];
+    this->ComputeInverseTransformedExtent(ext, dataExtent);
+    this->StartFileQueue(dataExtent[4], dataExtent[5]);
+    }
+
   // Call the correct templated function for the output
   switch (this->GetDataScalarType())
     {
@@ -447,12 +515,24 @@ void vtkImageReader::ExecuteData(vtkDataObject *output)
     default:
       vtkErrorMacro(<< "UpdateFromFile: Unknown data type");
     }   
+
+  this->StopFileQueue();
 }
 
 
 
 
 
+//----------------------------------------------------------------------------
+// The output extent is relative to the data extent and may be transformed.
+void vtkImageReader::ComputePrefetchFileExtent(const int updateExtent[6],
+                                               int fileExtent[6])
+{
+  int extent[6];
+  memcpy (extent, updateExtent, 6 * sizeof (int));
+  this->ComputeInverseTransformedExtent(extent, fileExtent);
+}
+
 void vtkImageReader::ComputeTransformedSpacing (double Spacing[3])
 {
   if (!this->Transform)
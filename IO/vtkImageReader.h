@@ -68,6 +68,7 @@ public:
                                            vtkIdType outIncr[3]);
 
   int OpenAndSeekFile(int extent[6], int slice);
+  unsigned long ComputeStreamStart(int extent[6], unsigned long headerSize);
   
   // Description:
   // Set/get the scalar array name for this data set.
@@ -98,6 +99,9 @@ protected:
                                  vtkInformationVector* outputVector);
 
   void ExecuteData(vtkDataObject *data);
+
+  virtual void ComputePrefetchFileExtent(const int updateExtent[6],
+                                         int fileExtent[6]);
 private:
   vtkImageReader(const vtkImageReader&);  // Not implemented.
   void operator=(const vtkImageReader&);  // Not implemented.
@@ -15,15 +15,21 @@
 #include "vtkImageReader2.h"
 
 #include "vtkByteSwap.h"
+#include "vtkConditionVariable.h"
 #include "vtkDataArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
 
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
 #include <sys/stat.h>
 
 vtkStandardNewMacro(vtkImageReader2);
@@ -36,6 +42,229 @@ vtkStandardNewMacro(vtkImageReader2);
 #undef close
 #endif
 
+//----------------------------------------------------------------------------
+// The regions of the file(s) to read ahead, the data read from them and
+// a flag to stop early.
+class vtkImageReader2PrefetchInfo
+{
+public:
+  vtkImageReader2PrefetchInfo()
+    {
+    this->Lock = vtkMutexLock::New();
+    this->Abort = 0;
+    }
+  ~vtkImageReader2PrefetchInfo()
+    {
+    this->Lock->Delete();
+    }
+
+  int GetAbort()
+    {
+    this->Lock->Lock();
+    int abort = this->Abort;
+    this->Lock->Unlock();
+    return abort;
+    }
+  void SetAbort(int abort)
+    {
+    this->Lock->Lock();
+    this->Abort = abort;
+    this->Lock->Unlock();
+    }
+
+  vtkstd::vector<vtkstd::string> FileNames;
+  vtkstd::vector<unsigned long> Offsets;
+  vtkstd::vector<unsigned long> Lengths;
+
+  // Filled by the thread: the bytes of each region and how many of them
+  // could be read.
+  vtkstd::vector<vtkstd::vector<char> > Data;
+  vtkstd::vector<unsigned long> ReadLengths;
+
+private:
+  vtkMutexLock *Lock;
+  int Abort;
+};
+
+//----------------------------------------------------------------------------
+// The files of a file series read ahead by background threads.  The
+// threads take the files in order and read each one whole, keeping at
+// most Capacity files in memory ahead of the ones the reader released.
+class vtkImageReader2FileQueue
+{
+public:
+  enum { Waiting, Reading, Ready, Failed, Released };
+
+  vtkImageReader2FileQueue()
+    {
+    this->Lock = vtkMutexLock::New();
+    this->Condition = vtkConditionVariable::New();
+    this->Threader = vtkMultiThreader::New();
+    this->FirstSlice = 0;
+    this->Capacity = 1;
+    this->NextFile = 0;
+    this->NumberOfReleasedFiles = 0;
+    this->Abort = 0;
+    }
+  ~vtkImageReader2FileQueue()
+    {
+    this->Lock->Lock();
+    this->Abort = 1;
+    this->Condition->Broadcast();
+    this->Lock->Unlock();
+    for (size_t i = 0; i < this->ThreadIDs.size(); ++i)
+      {
+      this->Threader->TerminateThread(this->ThreadIDs[i]);
+      }
+    this->Threader->Delete();
+    this->Condition->Delete();
+    this->Lock->Delete();
+    }
+
+  vtkstd::vector<vtkstd::string> FileNames;
+  vtkstd::vector<vtkstd::vector<char> > Buffers;
+  vtkstd::vector<int> States;
+  vtkstd::vector<int> ThreadIDs;
+  int FirstSlice;
+  int Capacity;
+  int NextFile;
+  int NumberOfReleasedFiles;
+  int Abort;
+
+  vtkMutexLock *Lock;
+  vtkConditionVariable *Condition;
+  vtkMultiThreader *Threader;
+};
+
+//----------------------------------------------------------------------------
+// Read a whole file into a buffer.
+static int vtkImageReader2ReadWholeFile(const char *fileName,
+                                        vtkstd::vector<char> &buffer)
+{
+  FILE *fp = fopen(fileName, "rb");
+  if (!fp)
+    {
+    return 0;
+    }
+  int success = 0;
+  if (fseek(fp, 0, SEEK_END) == 0)
+    {
+    long length = ftell(fp);
+    if (length >= 0 && fseek(fp, 0, SEEK_SET) == 0)
+      {
+      buffer.resize(length);
+      success = (length == 0 ||
+                 fread(&buffer[0], 1, length, fp) == static_cast<size_t>(length));
+      }
+    }
+  fclose(fp);
+  return success;
+}
+
+//----------------------------------------------------------------------------
+// This function runs in each background thread of the file queue.  It
+// takes the next file to read as long as the queue is not full.
+static VTK_THREAD_RETURN_TYPE vtkImageReader2FileQueueThread(void *arg)
+{
+  vtkImageReader2FileQueue *queue = static_cast<vtkImageReader2FileQueue *>(
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+  int numFiles = static_cast<int>(queue->FileNames.size());
+
+  queue->Lock->Lock();
+  while (!queue->Abort && queue->NextFile < numFiles)
+    {
+    if (queue->NextFile >= queue->NumberOfReleasedFiles + queue->Capacity)
+      {
+      queue->Condition->Wait(queue->Lock);
+      continue;
+      }
+    int i = queue->NextFile++;
+    queue->States[i] = vtkImageReader2FileQueue::Reading;
+    queue->Lock->Unlock();
+
+    vtkstd::vector<char> buffer;
+    int success =
+      vtkImageReader2ReadWholeFile(queue->FileNames[i].c_str(), buffer);
+
+    queue->Lock->Lock();
+    if (queue->States[i] == vtkImageReader2FileQueue::Reading)
+      {
+      queue->Buffers[i].swap(buffer);
+      queue->States[i] = success ?
+        vtkImageReader2FileQueue::Ready : vtkImageReader2FileQueue::Failed;
+      }
+    queue->Condition->Broadcast();
+    }
+  queue->Lock->Unlock();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// The slices decoded by the threads of vtkImageReader2::DecodeSlices.
+// The threads take the next slice to decode in turn, and signal the
+// calling thread, which reports progress, each time a slice is done.
+struct vtkImageReader2DecodeInfo
+{
+  vtkImageReader2 *Reader;
+  vtkImageReader2::DecodeSliceFunction Decode;
+  void *UserData;
+  vtkstd::vector<vtkstd::string> FileNames;
+  int FirstSlice;
+  int NextSlice;
+  int NextThreadIndex;
+  int NumberOfDecodedSlices;
+  int NumberOfFinishedThreads;
+  vtkMutexLock *Lock;
+  vtkConditionVariable *Condition;
+};
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkImageReader2::DecodeSlicesThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *ti =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkImageReader2DecodeInfo *info =
+    static_cast<vtkImageReader2DecodeInfo *>(ti->UserData);
+  vtkImageReader2 *self = info->Reader;
+  int numSlices = static_cast<int>(info->FileNames.size());
+
+  // the spawned thread ids are not necessarily 0 to n-1
+  info->Lock->Lock();
+  int threadIndex = info->NextThreadIndex++;
+  info->Lock->Unlock();
+
+  for (;;)
+    {
+    info->Lock->Lock();
+    int i = info->NextSlice++;
+    info->Lock->Unlock();
+    if (i >= numSlices || self->GetAbortExecute())
+      {
+      break;
+      }
+
+    int slice = info->FirstSlice + i;
+    unsigned long length = 0;
+    const char *buffer = self->GetQueuedFile(slice, &length);
+    (*info->Decode)(self, threadIndex, slice, info->FileNames[i].c_str(),
+                    buffer, length, info->UserData);
+    self->ReleaseQueuedFile(slice);
+
+    info->Lock->Lock();
+    ++info->NumberOfDecodedSlices;
+    info->Condition->Signal();
+    info->Lock->Unlock();
+    }
+
+  info->Lock->Lock();
+  ++info->NumberOfFinishedThreads;
+  info->Condition->Signal();
+  info->Lock->Unlock();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 //----------------------------------------------------------------------------
 vtkImageReader2::vtkImageReader2()
 {
@@ -72,12 +301,40 @@ vtkImageReader2::vtkImageReader2()
   this->SwapBytes = 0;
   this->FileLowerLeft = 0;
   this->FileDimensionality = 2;
+
+  this->PrefetchMemoryLimit = 0;
+  this->PrefetchThreader = NULL;
+  this->PrefetchThreadID = -1;
+  this->PrefetchInfo = NULL;
+  this->PrefetchHitCount = 0;
+  this->LastPrefetchExtent[0] = this->LastPrefetchExtent[2] =
+    this->LastPrefetchExtent[4] = 0;
+  this->LastPrefetchExtent[1] = this->LastPrefetchExtent[3] =
+    this->LastPrefetchExtent[5] = -1;
+
+  this->NumberOfPrefetchFiles = 0;
+  this->NumberOfPrefetchThreads = 2;
+  this->FileQueue = NULL;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
   this->SetNumberOfInputPorts(0);
 }
 
 //----------------------------------------------------------------------------
 vtkImageReader2::~vtkImageReader2()
 {
+  if (this->PrefetchInfo)
+    {
+    this->PrefetchInfo->SetAbort(1);
+    }
+  this->FinishPrefetch();
+  if (this->PrefetchThreader)
+    {
+    this->PrefetchThreader->Delete();
+    this->PrefetchThreader = NULL;
+    }
+  this->StopFileQueue();
+
   if (this->File)
     {
     this->File->close();
@@ -481,6 +738,14 @@ void vtkImageReader2::PrintSelf(ostream& os, vtkIndent indent)
   os << ")\n";
   
   os << indent << "HeaderSize: " << this->HeaderSize << "\n";
+  os << indent << "PrefetchMemoryLimit: " << this->PrefetchMemoryLimit
+     << "\n";
+  os << indent << "PrefetchHitCount: " << this->PrefetchHitCount << "\n";
+  os << indent << "NumberOfPrefetchFiles: " << this->NumberOfPrefetchFiles
+     << "\n";
+  os << indent << "NumberOfPrefetchThreads: "
+     << this->NumberOfPrefetchThreads << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
 
   if ( this->InternalFileName )
     {
@@ -667,6 +932,108 @@ unsigned long vtkImageReader2::GetHeaderSize(unsigned long idx)
   return this->HeaderSize;
 }
 
+//----------------------------------------------------------------------------
+void vtkImageReader2::DecodeSlices(int firstSlice, int lastSlice,
+                                   DecodeSliceFunction decode, void *userData)
+{
+  if (lastSlice < firstSlice)
+    {
+    return;
+    }
+
+  // the file names are computed here, since computing them changes the
+  // internal file name
+  vtkImageReader2DecodeInfo info;
+  for (int slice = firstSlice; slice <= lastSlice; ++slice)
+    {
+    this->ComputeInternalFileName(slice);
+    if (!this->InternalFileName)
+      {
+      return;
+      }
+    info.FileNames.push_back(this->InternalFileName);
+    }
+  info.Reader = this;
+  info.Decode = decode;
+  info.UserData = userData;
+  info.FirstSlice = firstSlice;
+  info.NextSlice = 0;
+  info.NextThreadIndex = 0;
+  info.NumberOfDecodedSlices = 0;
+  info.NumberOfFinishedThreads = 0;
+  info.Lock = vtkMutexLock::New();
+  info.Condition = vtkConditionVariable::New();
+
+  // read the files of the next slices while decoding these ones
+  this->StartFileQueue(firstSlice, lastSlice);
+
+  int numSlices = lastSlice - firstSlice + 1;
+  int numThreads = this->NumberOfThreads;
+  if (numThreads > numSlices)
+    {
+    numThreads = numSlices;
+    }
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  vtkstd::vector<int> threadIDs;
+  for (int i = 0; i < numThreads; ++i)
+    {
+    int id = threader->SpawnThread(vtkImageReader2::DecodeSlicesThread,
+                                   &info);
+    if (id >= 0)
+      {
+      threadIDs.push_back(id);
+      }
+    }
+  if (threadIDs.empty())
+    {
+    // decode in this thread if no thread could be spawned
+    vtkMultiThreader::ThreadInfo ti;
+    ti.ThreadID = 0;
+    ti.NumberOfThreads = 1;
+    ti.UserData = &info;
+    vtkImageReader2::DecodeSlicesThread(&ti);
+    }
+
+  // report the progress of all the threads from this thread
+  int numReported = 0;
+  info.Lock->Lock();
+  while (info.NumberOfFinishedThreads < static_cast<int>(threadIDs.size()))
+    {
+    if (info.NumberOfDecodedSlices == numReported)
+      {
+      info.Condition->Wait(info.Lock);
+      continue;
+      }
+    numReported = info.NumberOfDecodedSlices;
+    info.Lock->Unlock();
+    this->UpdateProgress(static_cast<double>(numReported)/numSlices);
+    info.Lock->Lock();
+    }
+  info.Lock->Unlock();
+
+  for (size_t j = 0; j < threadIDs.size(); ++j)
+    {
+    threader->TerminateThread(threadIDs[j]);
+    }
+  threader->Delete();
+
+  this->StopFileQueue();
+  info.Condition->Delete();
+  info.Lock->Delete();
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkImageReader2::ComputeHeaderSize(unsigned long fileLength)
+{
+  if ( ! this->ManualHeaderSize)
+    {
+    this->ComputeDataIncrements();
+    return fileLength - this->DataIncrements[this->GetFileDimensionality()];
+    }
+
+  return this->HeaderSize;
+}
+
 //----------------------------------------------------------------------------
 void vtkImageReader2::SeekFile(int i, int j, int k)
 {
@@ -772,8 +1139,9 @@ void vtkImageReader2Update(vtkImageReader2 *self, vtkImageData *data, OT *outPtr
       
       // seek to the correct row
       self->SeekFile(outExtent[0],idx1,idx2);
-      // read the row.
-      if ( !self->GetFile()->read((char *)outPtr1, streamRead))
+      // read the row, unless it was read ahead.
+      if ( !self->ReadPrefetchedData((char *)outPtr1, streamRead) &&
+           !self->GetFile()->read((char *)outPtr1, streamRead))
         {
         vtkGenericWarningMacro("File operation failed. row = " << idx1
                                << ", Read = " << streamRead
@@ -828,6 +1196,398 @@ void vtkImageReader2::ExecuteData(vtkDataObject *output)
 }
 
 
+//----------------------------------------------------------------------------
+int vtkImageReader2::RequestData(vtkInformation* request,
+                                 vtkInformationVector** inputVector,
+                                 vtkInformationVector* outputVector)
+{
+  // Wait for the read ahead of the previous request, so that the rows it
+  // read are copied from memory and the rest does not compete with this
+  // request for the disk.
+  this->WaitForPrefetch();
+
+  int retval =
+    this->Superclass::RequestData(request, inputVector, outputVector);
+
+  this->FinishPrefetch();
+
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  if (this->PrefetchMemoryLimit == 0 || this->AbortExecute ||
+      !outInfo->Has(vtkStreamingDemandDrivenPipeline::PREFETCH_UPDATE_EXTENT()))
+    {
+    this->LastPrefetchExtent[1] = this->LastPrefetchExtent[0] - 1;
+    return retval;
+    }
+
+  int updateExt[6], nextExt[6], wholeExt[6];
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), updateExt);
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExt);
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::PREFETCH_UPDATE_EXTENT(),
+               nextExt);
+
+  // Filters between the streamer and this reader may have enlarged
+  // the request, e.g. for a kernel.  If the previous hint was enlarged
+  // to give this update extent, enlarge the next one the same way.
+  int idx;
+  int grown = (this->LastPrefetchExtent[0] <= this->LastPrefetchExtent[1]);
+  for (idx = 0; grown && idx < 3; ++idx)
+    {
+    grown = (updateExt[2*idx] <= this->LastPrefetchExtent[2*idx] &&
+             updateExt[2*idx+1] >= this->LastPrefetchExtent[2*idx+1]);
+    }
+  int prefetchExt[6];
+  for (idx = 0; idx < 3; ++idx)
+    {
+    prefetchExt[2*idx] = nextExt[2*idx];
+    prefetchExt[2*idx+1] = nextExt[2*idx+1];
+    if (grown)
+      {
+      prefetchExt[2*idx] -= this->LastPrefetchExtent[2*idx] - updateExt[2*idx];
+      prefetchExt[2*idx+1] +=
+        updateExt[2*idx+1] - this->LastPrefetchExtent[2*idx+1];
+      }
+    if (prefetchExt[2*idx] < wholeExt[2*idx])
+      {
+      prefetchExt[2*idx] = wholeExt[2*idx];
+      }
+    if (prefetchExt[2*idx+1] > wholeExt[2*idx+1])
+      {
+      prefetchExt[2*idx+1] = wholeExt[2*idx+1];
+      }
+    this->LastPrefetchExtent[2*idx] = nextExt[2*idx];
+    this->LastPrefetchExtent[2*idx+1] = nextExt[2*idx+1];
+    }
+
+  int fileExt[6];
+  this->ComputePrefetchFileExtent(prefetchExt, fileExt);
+  this->StartPrefetch(fileExt);
+
+  return retval;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageReader2::ComputePrefetchFileExtent(const int updateExtent[6],
+                                                int fileExtent[6])
+{
+  for (int idx = 0; idx < 6; ++idx)
+    {
+    fileExtent[idx] = updateExtent[idx];
+    }
+}
+
+//----------------------------------------------------------------------------
+// This function runs in a separate thread, reading the regions of the
+// file(s) listed in the prefetch info into memory, where the next request
+// finds them.
+static VTK_THREAD_RETURN_TYPE vtkImageReader2PrefetchThread(void *arg)
+{
+  vtkImageReader2PrefetchInfo *info = static_cast<vtkImageReader2PrefetchInfo *>(
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+
+  const unsigned long bufferSize = 1048576;
+
+  for (size_t r = 0; r < info->FileNames.size() && !info->GetAbort(); ++r)
+    {
+#ifdef _WIN32
+    ifstream file(info->FileNames[r].c_str(), ios::in | ios::binary);
+#else
+    ifstream file(info->FileNames[r].c_str(), ios::in);
+#endif
+    if (file.fail())
+      {
+      continue;
+      }
+    file.seekg(static_cast<long>(info->Offsets[r]), ios::beg);
+
+    vtkstd::vector<char> &data = info->Data[r];
+    data.resize(info->Lengths[r]);
+    unsigned long done = 0;
+    while (done < info->Lengths[r] && !file.fail() && !info->GetAbort())
+      {
+      unsigned long length = info->Lengths[r] - done;
+      length = (length < bufferSize ? length : bufferSize);
+      file.read(&data[done], length);
+      done += static_cast<unsigned long>(file.gcount());
+      }
+    info->ReadLengths[r] = done;
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageReader2::StartPrefetch(const int fileExtent[6])
+{
+  this->FinishPrefetch();
+
+  if (!this->FileName && !this->FilePattern)
+    {
+    return;
+    }
+
+  this->ComputeDataIncrements();
+
+  vtkImageReader2PrefetchInfo *info = new vtkImageReader2PrefetchInfo;
+
+  unsigned long limit = this->PrefetchMemoryLimit * 1024;
+  unsigned long total = 0;
+  unsigned long rowLength = 
+    (fileExtent[1] - fileExtent[0] + 1) * this->DataIncrements[0];
+
+  // Compute the span of the file(s) holding the rows of each slice,
+  // the same way SeekFile does.
+  for (int k = fileExtent[4]; k <= fileExtent[5] && total < limit; ++k)
+    {
+    unsigned long header = this->GetHeaderSize(k);
+    this->ComputeInternalFileName(
+      (this->GetFileDimensionality() == 2) ? k : 0);
+    if (!this->InternalFileName)
+      {
+      break;
+      }
+
+    unsigned long sliceStart = header + 
+      (fileExtent[0] - this->DataExtent[0]) * this->DataIncrements[0];
+    if (this->GetFileDimensionality() >= 3)
+      {
+      sliceStart += (k - this->DataExtent[4]) * this->DataIncrements[2];
+      }
+
+    unsigned long start;
+    if (this->FileLowerLeft)
+      {
+      start = sliceStart + 
+        (fileExtent[2] - this->DataExtent[2]) * this->DataIncrements[1];
+      }
+    else
+      {
+      start = sliceStart + 
+        (this->DataExtent[3] - this->DataExtent[2] - fileExtent[3]) * 
+        this->DataIncrements[1];
+      }
+    unsigned long length = rowLength + 
+      (fileExtent[3] - fileExtent[2]) * this->DataIncrements[1];
+    if (total + length > limit)
+      {
+      length = limit - total;
+      }
+    total += length;
+
+    // merge with the previous region if it ends where this one starts
+    size_t last = info->FileNames.size();
+    if (last > 0 && info->FileNames[last-1] == this->InternalFileName &&
+        info->Offsets[last-1] + info->Lengths[last-1] == start)
+      {
+      info->Lengths[last-1] += length;
+      }
+    else
+      {
+      info->FileNames.push_back(this->InternalFileName);
+      info->Offsets.push_back(start);
+      info->Lengths.push_back(length);
+      }
+    }
+
+  if (info->FileNames.empty())
+    {
+    delete info;
+    return;
+    }
+  info->Data.resize(info->FileNames.size());
+  info->ReadLengths.resize(info->FileNames.size(), 0);
+
+  if (!this->PrefetchThreader)
+    {
+    this->PrefetchThreader = vtkMultiThreader::New();
+    }
+  this->PrefetchInfo = info;
+  this->PrefetchThreadID = this->PrefetchThreader->SpawnThread(
+    vtkImageReader2PrefetchThread, info);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageReader2::WaitForPrefetch()
+{
+  if (this->PrefetchThreadID >= 0)
+    {
+    this->PrefetchThreader->TerminateThread(this->PrefetchThreadID);
+    this->PrefetchThreadID = -1;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkImageReader2::ReadPrefetchedData(char *buffer, unsigned long length)
+{
+  vtkImageReader2PrefetchInfo *info = this->PrefetchInfo;
+  if (!info || this->PrefetchThreadID >= 0 || !this->File ||
+      !this->InternalFileName)
+    {
+    return 0;
+    }
+  long pos = static_cast<long>(this->File->tellg());
+  if (pos < 0)
+    {
+    return 0;
+    }
+  unsigned long start = static_cast<unsigned long>(pos);
+  for (size_t r = 0; r < info->FileNames.size(); ++r)
+    {
+    if (start >= info->Offsets[r] &&
+        start + length <= info->Offsets[r] + info->ReadLengths[r] &&
+        info->FileNames[r] == this->InternalFileName)
+      {
+      memcpy(buffer, &info->Data[r][start - info->Offsets[r]], length);
+      this->File->seekg(static_cast<long>(start + length), ios::beg);
+      this->PrefetchHitCount++;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageReader2::FinishPrefetch()
+{
+  this->WaitForPrefetch();
+  if (this->PrefetchInfo)
+    {
+    delete this->PrefetchInfo;
+    this->PrefetchInfo = NULL;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageReader2::StartFileQueue(int firstSlice, int lastSlice)
+{
+  this->StopFileQueue();
+
+  // a single file holds all the slices
+  if (this->NumberOfPrefetchFiles <= 0 || lastSlice <= firstSlice ||
+      (!this->FileNames && (this->FileName || !this->FilePattern)))
+    {
+    return;
+    }
+
+  vtkImageReader2FileQueue *queue = new vtkImageReader2FileQueue;
+  vtkstd::string internalFileName;
+  if (this->InternalFileName)
+    {
+    internalFileName = this->InternalFileName;
+    }
+  for (int slice = firstSlice; slice <= lastSlice; ++slice)
+    {
+    this->ComputeInternalFileName(slice);
+    if (!this->InternalFileName)
+      {
+      delete queue;
+      return;
+      }
+    queue->FileNames.push_back(this->InternalFileName);
+    }
+  if (!internalFileName.empty())
+    {
+    delete [] this->InternalFileName;
+    this->InternalFileName = new char [internalFileName.size() + 10];
+    strcpy(this->InternalFileName, internalFileName.c_str());
+    }
+  int numFiles = lastSlice - firstSlice + 1;
+  queue->Buffers.resize(numFiles);
+  queue->States.resize(numFiles, vtkImageReader2FileQueue::Waiting);
+  queue->FirstSlice = firstSlice;
+  queue->Capacity = this->NumberOfPrefetchFiles;
+
+  int numThreads = this->NumberOfPrefetchThreads;
+  if (numThreads > queue->Capacity)
+    {
+    numThreads = queue->Capacity;
+    }
+  for (int i = 0; i < numThreads; ++i)
+    {
+    int id = queue->Threader->SpawnThread(vtkImageReader2FileQueueThread, queue);
+    if (id >= 0)
+      {
+      queue->ThreadIDs.push_back(id);
+      }
+    }
+  this->FileQueue = queue;
+}
+
+//----------------------------------------------------------------------------
+const char *vtkImageReader2::GetQueuedFile(int slice, unsigned long *length)
+{
+  vtkImageReader2FileQueue *queue = this->FileQueue;
+  if (!queue || queue->ThreadIDs.empty())
+    {
+    return NULL;
+    }
+  int i = slice - queue->FirstSlice;
+  if (i < 0 || i >= static_cast<int>(queue->States.size()))
+    {
+    return NULL;
+    }
+
+  // a file beyond the capacity would never be read while the files
+  // before it are kept
+  queue->Lock->Lock();
+  if (i >= queue->NumberOfReleasedFiles + queue->Capacity)
+    {
+    queue->Lock->Unlock();
+    return NULL;
+    }
+  while (queue->States[i] == vtkImageReader2FileQueue::Waiting ||
+         queue->States[i] == vtkImageReader2FileQueue::Reading)
+    {
+    queue->Condition->Wait(queue->Lock);
+    }
+  const char *buffer = NULL;
+  if (queue->States[i] == vtkImageReader2FileQueue::Ready &&
+      !queue->Buffers[i].empty())
+    {
+    buffer = &queue->Buffers[i][0];
+    *length = static_cast<unsigned long>(queue->Buffers[i].size());
+    }
+  queue->Lock->Unlock();
+
+  return buffer;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageReader2::ReleaseQueuedFile(int slice)
+{
+  vtkImageReader2FileQueue *queue = this->FileQueue;
+  if (!queue)
+    {
+    return;
+    }
+  int i = slice - queue->FirstSlice;
+  if (i < 0 || i >= static_cast<int>(queue->States.size()))
+    {
+    return;
+    }
+
+  queue->Lock->Lock();
+  vtkstd::vector<char>().swap(queue->Buffers[i]);
+  queue->States[i] = vtkImageReader2FileQueue::Released;
+  while (queue->NumberOfReleasedFiles < static_cast<int>(queue->States.size()) &&
+         queue->States[queue->NumberOfReleasedFiles] ==
+         vtkImageReader2FileQueue::Released)
+    {
+    queue->NumberOfReleasedFiles++;
+    }
+  queue->Condition->Broadcast();
+  queue->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageReader2::StopFileQueue()
+{
+  if (this->FileQueue)
+    {
+    delete this->FileQueue;
+    this->FileQueue = NULL;
+    }
+}
+
 //----------------------------------------------------------------------------
 // Set the data type of pixels in the file.  
 // If you want the output scalar type to have a different value, set it
@@ -28,7 +28,11 @@
 
 #include "vtkImageAlgorithm.h"
 
+class vtkMultiThreader;
 class vtkStringArray;
+class vtkImageReader2PrefetchInfo;
+class vtkImageReader2FileQueue;
+class vtkImageReader;
 
 #define VTK_FILE_BYTE_ORDER_BIG_ENDIAN 0
 #define VTK_FILE_BYTE_ORDER_LITTLE_ENDIAN 1
@@ -166,9 +170,55 @@ public:
   virtual int GetSwapBytes() {return this->SwapBytes;}
   vtkBooleanMacro(SwapBytes,int);
 
+  // Description:
+  // Set/Get the maximum amount of data, in kilobytes, that the reader
+  // reads ahead on a background thread.  When the pipeline passes the
+  // extent of the next piece of a streamed update (see
+  // vtkImageDataStreamer), the reader starts reading that region of
+  // its file(s) into memory as soon as the current piece has been read,
+  // so that disk access for the next piece overlaps with the processing
+  // of the current one.  The next piece copies the rows it finds there
+  // instead of reading them from the file.  The default of 0 disables
+  // reading ahead.
+  vtkSetMacro(PrefetchMemoryLimit, unsigned long);
+  vtkGetMacro(PrefetchMemoryLimit, unsigned long);
+
+  // Description:
+  // Get the number of rows that were copied from data read ahead (see
+  // PrefetchMemoryLimit) instead of being read from the file, since the
+  // reader was created.
+  vtkGetMacro(PrefetchHitCount, unsigned long);
+
+  // Description:
+  // Set/Get the number of files of a file series (one file per slice)
+  // that are read ahead into memory by background threads while the
+  // current slice is decoded.  This hides the latency of opening and
+  // reading each file, e.g. on a network file system.  The default of
+  // 0 reads each file when its slice is decoded.
+  vtkSetClampMacro(NumberOfPrefetchFiles, int, 0, VTK_LARGE_INTEGER);
+  vtkGetMacro(NumberOfPrefetchFiles, int);
+
+  // Description:
+  // Set/Get the number of background threads that read the files of a
+  // file series ahead (see NumberOfPrefetchFiles).  Several threads
+  // keep several requests in flight.  The default is 2.
+  vtkSetClampMacro(NumberOfPrefetchThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfPrefetchThreads, int);
+
+  // Description:
+  // Set/Get the number of threads that decode the slices of a file
+  // series concurrently, each slice being an independent file.  Readers
+  // of compressed formats (PNG, JPEG, TIFF) use it.  The default is the
+  // global default number of threads of vtkMultiThreader, and 1 decodes
+  // the slices one after the other; the progress is reported from the
+  // calling thread either way.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
 //BTX
   ifstream *GetFile() {return this->File;}
   vtkGetVectorMacro(DataIncrements,unsigned long,4);
+
 //ETX
 
   virtual int OpenFile();
@@ -243,12 +293,104 @@ protected:
   int FileNameSliceOffset;
   int FileNameSliceSpacing;
   
+  unsigned long PrefetchMemoryLimit;
+  vtkMultiThreader *PrefetchThreader;
+  int PrefetchThreadID;
+  vtkImageReader2PrefetchInfo *PrefetchInfo;
+  unsigned long PrefetchHitCount;
+  int LastPrefetchExtent[6];
+
+  int NumberOfPrefetchFiles;
+  int NumberOfPrefetchThreads;
+  vtkImageReader2FileQueue *FileQueue;
+  int NumberOfThreads;
+
   virtual int RequestInformation(vtkInformation* request,
                                  vtkInformationVector** inputVector,
                                  vtkInformationVector* outputVector);
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
   virtual void ExecuteInformation();
   virtual void ExecuteData(vtkDataObject *data);
   virtual void ComputeDataIncrements();
+
+  // Description:
+  // Convert an update extent into the extent of the data in the file,
+  // used to decide which part of the file to read ahead.
+  virtual void ComputePrefetchFileExtent(const int updateExtent[6],
+                                         int fileExtent[6]);
+
+  // Description:
+  // Start reading the given file extent on a background thread, wait
+  // for the read that is in progress to finish, or also release the data
+  // it read.
+  void StartPrefetch(const int fileExtent[6]);
+  void WaitForPrefetch();
+  void FinishPrefetch();
+
+//BTX
+  // Description:
+  // Start reading the files of the slices firstSlice to lastSlice into
+  // memory on background threads, in order.  Nothing is started unless
+  // NumberOfPrefetchFiles is set and there is more than one slice file.
+  void StartFileQueue(int firstSlice, int lastSlice);
+
+  // Description:
+  // Wait until the file of the given slice has been read and return its
+  // contents, which stay valid until the slice is released.  Returns
+  // NULL if the file is not queued or could not be read, in which case
+  // the file should be read directly.
+  const char *GetQueuedFile(int slice, unsigned long *length);
+
+  // Description:
+  // Release the contents of a slice file so that the memory can be
+  // reused to read ahead.  Slices should be released in order.
+  void ReleaseQueuedFile(int slice);
+
+  // Description:
+  // Stop reading ahead and release all the queued files.
+  void StopFileQueue();
+
+  // Description:
+  // Get the header size of a file of the given length, without looking
+  // at the file itself.
+  unsigned long ComputeHeaderSize(unsigned long fileLength);
+
+  // Description:
+  // Decode the slices firstSlice to lastSlice, each from its own file,
+  // by calling the given function for each slice on up to
+  // NumberOfThreads threads.  The function gets the id of the thread,
+  // the slice, the name of its file and, if the file was read ahead
+  // (see NumberOfPrefetchFiles), its contents.  The slices are taken in
+  // order and progress is updated as they are decoded.
+  typedef void (*DecodeSliceFunction)(vtkImageReader2 *self, int threadId,
+                                      int slice, const char *fileName,
+                                      const char *buffer,
+                                      unsigned long length,
+                                      void *userData);
+  void DecodeSlices(int firstSlice, int lastSlice,
+                    DecodeSliceFunction decode, void *userData);
+
+  // Description:
+  // If the length bytes at the current position of the file were read
+  // ahead (see PrefetchMemoryLimit), copy them into buffer, move the
+  // file position past them and return 1.  Otherwise return 0 and leave
+  // the file untouched.
+  int ReadPrefetchedData(char *buffer, unsigned long length);
+
+  // Description:
+  // Thread function of DecodeSlices().
+  static VTK_THREAD_RETURN_TYPE DecodeSlicesThread(void *arg);
+
+  // The templated readers of the file data use the prefetch and queue
+  // helpers above.
+  template <class OT> friend void vtkImageReader2Update(
+    vtkImageReader2 *self, vtkImageData *data, OT *outPtr);
+  template <class IT, class OT> friend void vtkImageReaderUpdate2(
+    vtkImageReader *self, vtkImageData *data, IT *inPtr, OT *outPtr);
+  friend struct vtkImageReader2DecodeInfo;
+//ETX
 private:
   vtkImageReader2(const vtkImageReader2&);  // Not implemented.
   void operator=(const vtkImageReader2&);  // Not implemented.
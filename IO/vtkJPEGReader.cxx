@@ -144,16 +144,58 @@ void vtkJPEGReader::ExecuteInformation()
   fclose(fp);
 }
 
+// a jpeg source for a file that was read into memory ahead of time
+extern "C" void vtk_jpeg_memory_init_source (j_decompress_ptr)
+{
+}
+
+extern "C" boolean vtk_jpeg_memory_fill_input_buffer (j_decompress_ptr cinfo)
+{
+  // the whole file is in the buffer, so insert a fake EOI marker as the
+  // stdio source does at the end of a truncated file
+  static const JOCTET eoi[2] = { 0xFF, JPEG_EOI };
+  cinfo->src->next_input_byte = eoi;
+  cinfo->src->bytes_in_buffer = 2;
+  return TRUE;
+}
+
+extern "C" void vtk_jpeg_memory_skip_input_data (j_decompress_ptr cinfo,
+                                                 long num_bytes)
+{
+  if (num_bytes <= 0)
+    {
+    return;
+    }
+  if (static_cast<size_t>(num_bytes) > cinfo->src->bytes_in_buffer)
+    {
+    vtk_jpeg_memory_fill_input_buffer(cinfo);
+    return;
+    }
+  cinfo->src->next_input_byte += num_bytes;
+  cinfo->src->bytes_in_buffer -= num_bytes;
+}
+
+extern "C" void vtk_jpeg_memory_term_source (j_decompress_ptr)
+{
+}
+
+// Read one JPEG file, from the given buffer if the file was read into
+// memory ahead of time.
 template <class OT>
-int vtkJPEGReaderUpdate2(vtkJPEGReader *self, OT *outPtr,
-                          int *outExt, vtkIdType *outInc, long)
+int vtkJPEGReaderUpdate2(vtkJPEGReader *self, const char *fileName,
+                         OT *outPtr, int *outExt, vtkIdType *outInc, long,
+                         const char *buffer, unsigned long length)
 {
   unsigned int ui;
   int i;
-  FILE *fp = fopen(self->GetInternalFileName(), "rb");
-  if (!fp)
+  FILE *fp = NULL;
+  if (!buffer)
     {
-    return 1;
+    fp = fopen(fileName, "rb");
+    if (!fp)
+      {
+      return 1;
+      }
     }
 
   // create jpeg decompression object and error handler
@@ -171,7 +213,10 @@ int vtkJPEGReaderUpdate2(vtkJPEGReader *self, OT *outPtr,
     // clean up
     jpeg_destroy_decompress(&cinfo);
     // close the file
-    fclose(fp);
+    if (fp)
+      {
+      fclose(fp);
+      }
 
     // this is not a valid jpeg file
     return 2;
@@ -179,7 +224,22 @@ int vtkJPEGReaderUpdate2(vtkJPEGReader *self, OT *outPtr,
   jpeg_create_decompress(&cinfo);
 
   // set the source file
-  jpeg_stdio_src(&cinfo, fp);
+  struct jpeg_source_mgr src;
+  if (fp)
+    {
+    jpeg_stdio_src(&cinfo, fp);
+    }
+  else
+    {
+    src.init_source = vtk_jpeg_memory_init_source;
+    src.fill_input_buffer = vtk_jpeg_memory_fill_input_buffer;
+    src.skip_input_data = vtk_jpeg_memory_skip_input_data;
+    src.resync_to_restart = jpeg_resync_to_restart;
+    src.term_source = vtk_jpeg_memory_term_source;
+    src.next_input_byte = reinterpret_cast<const JOCTET *>(buffer);
+    src.bytes_in_buffer = length;
+    cinfo.src = &src;
+    }
 
   // read the header
   jpeg_read_header(&cinfo, TRUE);
@@ -227,44 +287,42 @@ int vtkJPEGReaderUpdate2(vtkJPEGReader *self, OT *outPtr,
   delete [] row_pointers;
 
   // close the file
-  fclose(fp);
+  if (fp)
+    {
+    fclose(fp);
+    }
   return 0;
 }
 
 //----------------------------------------------------------------------------
-// This function reads in one data of data.
-// templated to handle different data types.
-template <class OT>
-void vtkJPEGReaderUpdate(vtkJPEGReader *self, vtkImageData *data, OT *outPtr)
+// The output of the slices decoded by vtkJPEGReaderDecodeSlice.
+struct vtkJPEGReaderSlices
 {
-  vtkIdType outIncr[3];
-  int outExtent[6];
-  OT *outPtr2;
-
-  data->GetExtent(outExtent);
-  data->GetIncrements(outIncr);
+  void *OutPtr;
+  int *OutExt;
+  vtkIdType *OutInc;
+  long PixSize;
+};
 
-  long pixSize = data->GetNumberOfScalarComponents()*sizeof(OT);  
-  
-  outPtr2 = outPtr;
-  int idx2;
-  for (idx2 = outExtent[4]; idx2 <= outExtent[5]; ++idx2)
+//----------------------------------------------------------------------------
+// Decode the file of one slice into its place in the output.  The slices
+// are independent, so this runs on several threads at once.
+template <class OT>
+void vtkJPEGReaderDecodeSlice(vtkImageReader2 *self, int, int slice,
+                              const char *fileName, const char *buffer,
+                              unsigned long length, void *userData)
+{
+  vtkJPEGReaderSlices *slices = static_cast<vtkJPEGReaderSlices *>(userData);
+  OT *outPtr = static_cast<OT *>(slices->OutPtr) +
+    (slice - slices->OutExt[4])*slices->OutInc[2];
+  if ( vtkJPEGReaderUpdate2(static_cast<vtkJPEGReader *>(self), fileName,
+                            outPtr, slices->OutExt, slices->OutInc,
+                            slices->PixSize, buffer, length) == 2 )
     {
-    self->ComputeInternalFileName(idx2);
-    // read in a JPEG file
-    if ( vtkJPEGReaderUpdate2(self, outPtr2, outExtent, outIncr, pixSize) == 2 )
-      {
-      const char* fn = self->GetInternalFileName();
-      vtkErrorWithObjectMacro(self, "libjpeg could not read file: " << fn);
-      }
-    
-    self->UpdateProgress((idx2 - outExtent[4])/
-                         (outExtent[5] - outExtent[4] + 1.0));
-    outPtr2 += outIncr[2];
+    vtkErrorWithObjectMacro(self, "libjpeg could not read file: " << fileName);
     }
 }
 
-
 //----------------------------------------------------------------------------
 // This function reads a data from a file.  The datas extent/axes
 // are assumed to be the same as the file extent/order.
@@ -282,17 +340,27 @@ void vtkJPEGReader::ExecuteData(vtkDataObject *output)
   
   data->GetPointData()->GetScalars()->SetName("JPEGImage");
 
-  // Call the correct templated function for the output
-  void *outPtr;
-
-  // Call the correct templated function for the input
-  outPtr = data->GetScalarPointer();
+  // Select the decoder of the output type
+  DecodeSliceFunction decode = NULL;
   switch (data->GetScalarType())
     {
-    vtkTemplateMacro(vtkJPEGReaderUpdate(this, data, (VTK_TT *)(outPtr)));
+    vtkTemplateMacro(decode = vtkJPEGReaderDecodeSlice<VTK_TT>);
     default:
       vtkErrorMacro(<< "UpdateFromFile: Unknown data type");
-    }   
+      return;
+    }
+
+  int outExtent[6];
+  data->GetExtent(outExtent);
+  vtkJPEGReaderSlices slices;
+  slices.OutPtr = data->GetScalarPointer();
+  slices.OutExt = outExtent;
+  slices.OutInc = data->GetIncrements();
+  slices.PixSize =
+    data->GetNumberOfScalarComponents()*data->GetScalarSize();
+
+  // read in the JPEG files
+  this->DecodeSlices(outExtent[4], outExtent[5], decode, &slices);
 }
 
 
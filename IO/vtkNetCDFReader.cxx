@@ -24,6 +24,7 @@
 
 #include "vtkCallbackCommand.h"
 #include "vtkCellData.h"
+#include "vtkDataArrayCache.h"
 #include "vtkDataArraySelection.h"
 #include "vtkDoubleArray.h"
 #include "vtkImageData.h"
@@ -103,6 +104,7 @@ vtkNetCDFReader::vtkNetCDFReader()
 vtkNetCDFReader::~vtkNetCDFReader()
 {
   this->SetFileName(NULL);
+  vtkDataArrayCache::GetGlobalCache()->InvalidateOwner(this);
   this->VariableDimensions->Delete();
   this->AllDimensions->Delete();
 }
@@ -658,6 +660,47 @@ int vtkNetCDFReader::LoadVariable(int ncFD, const char *varName, double time,
     arraySize *= count[i+timeIndexOffset];
     }
 
+  // Reuse the values if this slab was loaded before, e.g. when the pipeline
+  // steps back to an earlier time.  The modification time has a resolution
+  // of one second, so the file size is part of the key.  The output gets a
+  // copy, since downstream filters may modify its arrays.
+  vtkDataArrayCache *cache = vtkDataArrayCache::GetGlobalCache();
+  int cacheValues = (cache->GetCapacity() > 0.0);
+  vtkDataArrayCacheKey key(this);
+  if (cacheValues)
+    {
+    key.Append(this->FileName)
+      .Append(static_cast<double>(
+                vtksys::SystemTools::ModifiedTime(this->FileName)))
+      .Append(static_cast<double>(
+                vtksys::SystemTools::FileLength(this->FileName)))
+      .Append(varName)
+      .Append(this->ReplaceFillValueWithNan).Append(loadingPointData ? 1 : 0);
+    for (int i = 0; i < numDims+timeIndexOffset; i++)
+      {
+      key.AppendId(static_cast<vtkIdType>(start[i]))
+        .AppendId(static_cast<vtkIdType>(count[i]));
+      }
+    vtkDataArray *cachedArray = cache->Find(key);
+    if (cachedArray)
+      {
+      vtkSmartPointer<vtkDataArray> copy;
+      copy.TakeReference(cachedArray->NewInstance());
+      copy->DeepCopy(cachedArray);
+      copy->SetName(varName);
+      cachedArray->Delete();
+      if (loadingPointData)
+        {
+        output->GetPointData()->AddArray(copy);
+        }
+      else
+        {
+        output->GetCellData()->AddArray(copy);
+        }
+      return 1;
+      }
+    }
+
   // Allocate an array of the right type.
   nc_type ncType;
   CALL_NETCDF(nc_inq_vartype(ncFD, varId, &ncType));
@@ -742,6 +785,13 @@ int vtkNetCDFReader::LoadVariable(int ncFD, const char *varName, double time,
     {
     output->GetCellData()->AddArray(dataArray);
     }
+  if (cacheValues)
+    {
+    vtkSmartPointer<vtkDataArray> copy;
+    copy.TakeReference(dataArray->NewInstance());
+    copy->DeepCopy(dataArray);
+    cache->Insert(key, copy);
+    }
 
   return 1;
 }
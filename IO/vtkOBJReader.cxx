@@ -16,12 +16,17 @@
 
 #include "vtkCellArray.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include <ctype.h>
+#include <vtksys/SystemTools.hxx>
+#include <vtkstd/string>
+#include <vtkstd/vector>
 
 vtkStandardNewMacro(vtkOBJReader);
 
@@ -30,6 +35,7 @@ vtkStandardNewMacro(vtkOBJReader);
 vtkOBJReader::vtkOBJReader()
 {
   this->FileName = NULL;
+  this->ParallelParsing = 0;
 
   this->SetNumberOfInputPorts(0);
 }
@@ -101,6 +107,600 @@ p <v_a> <v_b> ...
 \*---------------------------------------------------------------------------*/
 
 
+/*---------------------------------------------------------------------------*\
+
+Parallel parsing: the file is loaded in memory and split at line
+boundaries in one chunk per thread.  Each chunk is parsed into its own
+arrays, with the same rules as the line by line parser below, and the
+arrays of the chunks are then concatenated at offsets given by the
+prefix sums of their sizes.  The indices of the faces are absolute in
+the file, so they need no renumbering.
+
+\*---------------------------------------------------------------------------*/
+
+// The contents of one chunk of the file.
+class vtkOBJReaderChunk
+{
+public:
+  vtkOBJReaderChunk()
+    {
+    this->Begin = this->End = 0;
+    this->NumberOfLines = 0;
+    this->ErrorLine = 0;
+    this->ErrorMessage = 0;
+    this->ErrorSuffix = "";
+    this->NumberOfVerts = this->NumberOfLineElems = this->NumberOfPolys = 0;
+    this->HasTCoords = this->HasNormals = false;
+    this->TCoordsSameAsVerts = this->NormalsSameAsVerts = true;
+    }
+
+  void Parse();
+
+  const char *Begin;
+  const char *End;
+  int NumberOfLines;
+
+  // the first error, at a line number local to the chunk
+  int ErrorLine;
+  const char *ErrorMessage;
+  const char *ErrorSuffix;
+
+  vtkstd::vector<float> Points;
+  vtkstd::vector<float> TCoords;
+  vtkstd::vector<float> Normals;
+  vtkstd::vector<vtkIdType> Verts;
+  vtkstd::vector<vtkIdType> LineElems;
+  vtkstd::vector<vtkIdType> Polys;
+  vtkstd::vector<vtkIdType> TCoordPolys;
+  vtkstd::vector<vtkIdType> NormalPolys;
+  vtkIdType NumberOfVerts;
+  vtkIdType NumberOfLineElems;
+  vtkIdType NumberOfPolys;
+  bool HasTCoords;
+  bool HasNormals;
+  bool TCoordsSameAsVerts;
+  bool NormalsSameAsVerts;
+
+protected:
+  bool ReadFloat(const char *&p, const char *end, float &value);
+  bool ReadInt(const char *&p, const char *end, int &value);
+  void SetError(const char *message, const char *suffix = "")
+    {
+    if (!this->ErrorMessage)
+      {
+      this->ErrorMessage = message;
+      this->ErrorSuffix = suffix;
+      this->ErrorLine = this->NumberOfLines;
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Read a float as sscanf's "%f" would.  Plain decimal numbers that fit
+// a float mantissa are converted with one correctly rounded operation,
+// anything else goes through sscanf.
+bool vtkOBJReaderChunk::ReadFloat(const char *&p, const char *end,
+                                  float &value)
+{
+  static const float powersOfTen[11] = 
+    { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+  while (p < end && isspace(*p))
+    {
+    p++;
+    }
+  const char *q = p;
+  bool negative = false;
+  if (q < end && (*q == '-' || *q == '+'))
+    {
+    negative = (*q == '-');
+    q++;
+    }
+  unsigned long mantissa = 0;
+  int exponent = 0;
+  int numDigits = 0;
+  bool exact = true;
+  for (; q < end && isdigit(*q); q++, numDigits++)
+    {
+    if (mantissa > 16777216)
+      {
+      exact = false;
+      }
+    else
+      {
+      mantissa = 10*mantissa + (*q - '0');
+      }
+    }
+  if (q < end && *q == '.')
+    {
+    for (q++; q < end && isdigit(*q); q++, numDigits++)
+      {
+      if (mantissa > 16777216)
+        {
+        exact = false;
+        }
+      else
+        {
+        mantissa = 10*mantissa + (*q - '0');
+        exponent--;
+        }
+      }
+    }
+  if (numDigits > 0 && q < end && (*q == 'e' || *q == 'E'))
+    {
+    const char *r = q + 1;
+    bool negativeExponent = false;
+    if (r < end && (*r == '-' || *r == '+'))
+      {
+      negativeExponent = (*r == '-');
+      r++;
+      }
+    if (r < end && isdigit(*r))
+      {
+      int e = 0;
+      for (; r < end && isdigit(*r); r++)
+        {
+        e = (e < 10000) ? 10*e + (*r - '0') : e;
+        }
+      exponent += negativeExponent ? -e : e;
+      q = r;
+      }
+    }
+
+  if (numDigits > 0 && exact && mantissa <= 16777216 &&
+      exponent >= -10 && exponent <= 10 &&
+      (q >= end || !isalnum(*q)))
+    {
+    float x = static_cast<float>(mantissa);
+    x = (exponent < 0) ? x/powersOfTen[-exponent] : x*powersOfTen[exponent];
+    value = negative ? -x : x;
+    p = q;
+    return true;
+    }
+
+  // copy the token, which ends at whitespace or at the end of the line,
+  // so that sscanf neither scans the rest of the file nor reads a value
+  // from the next line
+  q = p;
+  while (q < end && !isspace(*q))
+    {
+    q++;
+    }
+  size_t tokenLength = q - p;
+  if (tokenLength == 0)
+    {
+    return false;
+    }
+  char shortToken[64];
+  vtkstd::string longToken;
+  const char *token = shortToken;
+  if (tokenLength < sizeof(shortToken))
+    {
+    memcpy(shortToken, p, tokenLength);
+    shortToken[tokenLength] = '\0';
+    }
+  else
+    {
+    longToken.assign(p, tokenLength);
+    token = longToken.c_str();
+    }
+  int length = 0;
+  if (sscanf(token, "%f%n", &value, &length) == 1)
+    {
+    p += length;
+    return true;
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+// Read an int as sscanf's "%d" would.
+bool vtkOBJReaderChunk::ReadInt(const char *&p, const char *end, int &value)
+{
+  while (p < end && isspace(*p))
+    {
+    p++;
+    }
+  const char *q = p;
+  bool negative = false;
+  if (q < end && (*q == '-' || *q == '+'))
+    {
+    negative = (*q == '-');
+    q++;
+    }
+  if (q >= end || !isdigit(*q))
+    {
+    return false;
+    }
+  int x = 0;
+  for (; q < end && isdigit(*q); q++)
+    {
+    x = 10*x + (*q - '0');
+    }
+  value = negative ? -x : x;
+  p = q;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Parse the lines of the chunk, following the line by line parser.
+void vtkOBJReaderChunk::Parse()
+{
+  const char *lineBegin = this->Begin;
+  while (!this->ErrorMessage && lineBegin < this->End)
+    {
+    const char *pEnd = lineBegin;
+    while (pEnd < this->End && *pEnd != '\n')
+      {
+      pEnd++;
+      }
+    const char *nextLine = (pEnd < this->End) ? pEnd + 1 : pEnd;
+    this->NumberOfLines++;
+    const char *pLine = lineBegin;
+
+    // find the first non-whitespace character, the command
+    while (pLine < pEnd && isspace(*pLine)) { pLine++; }
+    const char *cmd = pLine;
+    while (pLine < pEnd && !isspace(*pLine)) { pLine++; }
+    size_t cmdLength = pLine - cmd;
+    if (pLine < pEnd)
+      {
+      pLine++;
+      }
+
+    // the kind of element, and where its cells go
+    vtkstd::vector<vtkIdType> *cells = 0;
+    int elemType = 0;
+    float xyz[3];
+
+    if (cmdLength == 1 && cmd[0] == 'v')
+      {
+      if (this->ReadFloat(pLine, pEnd, xyz[0]) &&
+          this->ReadFloat(pLine, pEnd, xyz[1]) &&
+          this->ReadFloat(pLine, pEnd, xyz[2]))
+        {
+        this->Points.insert(this->Points.end(), xyz, xyz + 3);
+        }
+      else
+        {
+        this->SetError("Error reading 'v' at line ");
+        }
+      }
+    else if (cmdLength == 2 && cmd[0] == 'v' && cmd[1] == 't')
+      {
+      if (this->ReadFloat(pLine, pEnd, xyz[0]) &&
+          this->ReadFloat(pLine, pEnd, xyz[1]))
+        {
+        this->TCoords.insert(this->TCoords.end(), xyz, xyz + 2);
+        }
+      else
+        {
+        this->SetError("Error reading 'vt' at line ");
+        }
+      }
+    else if (cmdLength == 2 && cmd[0] == 'v' && cmd[1] == 'n')
+      {
+      if (this->ReadFloat(pLine, pEnd, xyz[0]) &&
+          this->ReadFloat(pLine, pEnd, xyz[1]) &&
+          this->ReadFloat(pLine, pEnd, xyz[2]))
+        {
+        this->Normals.insert(this->Normals.end(), xyz, xyz + 3);
+        this->HasNormals = true;
+        }
+      else
+        {
+        this->SetError("Error reading 'vn' at line ");
+        }
+      }
+    else if (cmdLength == 1 && cmd[0] == 'p')
+      {
+      cells = &this->Verts;
+      elemType = 'p';
+      }
+    else if (cmdLength == 1 && cmd[0] == 'l')
+      {
+      cells = &this->LineElems;
+      elemType = 'l';
+      }
+    else if (cmdLength == 1 && cmd[0] == 'f')
+      {
+      cells = &this->Polys;
+      elemType = 'f';
+      }
+
+    if (cells)
+      {
+      // the counts are filled once the cell is read
+      size_t cellStart = cells->size();
+      size_t tcoordStart = this->TCoordPolys.size();
+      size_t normalStart = this->NormalPolys.size();
+      cells->push_back(0);
+      if (elemType == 'f')
+        {
+        this->TCoordPolys.push_back(0);
+        this->NormalPolys.push_back(0);
+        }
+      int nVerts = 0, nTCoords = 0, nNormals = 0;
+
+      while (!this->ErrorMessage && pLine < pEnd)
+        {
+        while (pLine < pEnd && isspace(*pLine)) { pLine++; }
+        if (pLine >= pEnd)
+          {
+          break;
+          }
+
+        const char *p = pLine;
+        int iVert, iTCoord, iNormal;
+        if (this->ReadInt(p, pEnd, iVert))
+          {
+          cells->push_back(iVert - 1);
+          nVerts++;
+          if (elemType != 'p' && p < pEnd && *p == '/')
+            {
+            p++;
+            if (p < pEnd && *p == '/')
+              {
+              p++;
+              if (elemType == 'f' && this->ReadInt(p, pEnd, iNormal))
+                {
+                this->NormalPolys.push_back(iNormal - 1);
+                nNormals++;
+                this->NormalsSameAsVerts = 
+                  this->NormalsSameAsVerts && (iNormal == iVert);
+                }
+              }
+            else if (this->ReadInt(p, pEnd, iTCoord) && elemType == 'f')
+              {
+              this->TCoordPolys.push_back(iTCoord - 1);
+              nTCoords++;
+              this->TCoordsSameAsVerts = 
+                this->TCoordsSameAsVerts && (iTCoord == iVert);
+              if (p < pEnd && *p == '/')
+                {
+                p++;
+                if (this->ReadInt(p, pEnd, iNormal))
+                  {
+                  this->NormalPolys.push_back(iNormal - 1);
+                  nNormals++;
+                  this->NormalsSameAsVerts = 
+                    this->NormalsSameAsVerts && (iNormal == iVert);
+                  }
+                }
+              }
+            }
+          }
+        else if (pLine[0] == '\\' && pLine + 1 == pEnd && pEnd < this->End &&
+                 nextLine < this->End)
+          {
+          // handle backslash-newline continuation
+          pLine = nextLine;
+          pEnd = pLine;
+          while (pEnd < this->End && *pEnd != '\n')
+            {
+            pEnd++;
+            }
+          nextLine = (pEnd < this->End) ? pEnd + 1 : pEnd;
+          this->NumberOfLines++;
+          continue;
+          }
+        else if (pLine[0] == '\\' && pLine + 1 == pEnd && pEnd < this->End)
+          {
+          this->SetError("Error reading continuation line at line ");
+          }
+        else
+          {
+          this->SetError(elemType == 'p' ? "Error reading 'p' at line " :
+                         (elemType == 'l' ? "Error reading 'l' at line " :
+                          "Error reading 'f' at line "));
+          }
+        // skip over what we just read
+        while (pLine < pEnd && !isspace(*pLine)) { pLine++; }
+        }
+
+      if ((elemType == 'p' && nVerts < 1) ||
+          (elemType == 'l' && nVerts < 2) ||
+          (elemType == 'f' && (nVerts < 3 ||
+                               (nTCoords > 0 && nTCoords != nVerts) ||
+                               (nNormals > 0 && nNormals != nVerts))))
+        {
+        this->SetError("Error reading file near line ",
+                       elemType == 'p' ? " while processing the 'p' command" :
+                       (elemType == 'l' ? 
+                        " while processing the 'l' command" :
+                        " while processing the 'f' command"));
+        }
+
+      (*cells)[cellStart] = nVerts;
+      if (elemType == 'f')
+        {
+        this->TCoordPolys[tcoordStart] = nTCoords;
+        this->NormalPolys[normalStart] = nNormals;
+        this->HasTCoords = this->HasTCoords || (nTCoords > 0);
+        this->HasNormals = this->HasNormals || (nNormals > 0);
+        this->NumberOfPolys++;
+        }
+      else if (elemType == 'l')
+        {
+        this->NumberOfLineElems++;
+        }
+      else
+        {
+        this->NumberOfVerts++;
+        }
+      }
+
+    lineBegin = nextLine;
+    }
+}
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkOBJReaderParseChunk(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info = 
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkOBJReaderChunk *chunks = 
+    static_cast<vtkOBJReaderChunk *>(info->UserData);
+  chunks[info->ThreadID].Parse();
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Append the cells of all the chunks to a cell array.
+static void vtkOBJReaderConcatenateCells(
+  vtkstd::vector<vtkOBJReaderChunk> &chunks,
+  vtkstd::vector<vtkIdType> vtkOBJReaderChunk::*chunkCells,
+  vtkIdType vtkOBJReaderChunk::*chunkNumberOfCells,
+  vtkCellArray *cells)
+{
+  size_t c;
+  vtkIdType size = 0;
+  vtkIdType numCells = 0;
+  for (c = 0; c < chunks.size(); c++)
+    {
+    size += static_cast<vtkIdType>((chunks[c].*chunkCells).size());
+    numCells += chunks[c].*chunkNumberOfCells;
+    }
+  vtkIdTypeArray *ids = vtkIdTypeArray::New();
+  ids->SetNumberOfValues(size);
+  vtkIdType offset = 0;
+  for (c = 0; c < chunks.size(); c++)
+    {
+    vtkstd::vector<vtkIdType> &chunk = chunks[c].*chunkCells;
+    if (!chunk.empty())
+      {
+      memcpy(ids->GetPointer(offset), &chunk[0], 
+             chunk.size()*sizeof(vtkIdType));
+      offset += static_cast<vtkIdType>(chunk.size());
+      }
+    vtkstd::vector<vtkIdType>().swap(chunk);
+    }
+  cells->SetCells(numCells, ids);
+  ids->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Append the tuples of all the chunks to an array.
+static void vtkOBJReaderConcatenateFloats(
+  vtkstd::vector<vtkOBJReaderChunk> &chunks,
+  vtkstd::vector<float> vtkOBJReaderChunk::*chunkValues,
+  vtkFloatArray *values)
+{
+  size_t c;
+  vtkIdType size = 0;
+  for (c = 0; c < chunks.size(); c++)
+    {
+    size += static_cast<vtkIdType>((chunks[c].*chunkValues).size());
+    }
+  values->SetNumberOfTuples(size/values->GetNumberOfComponents());
+  vtkIdType offset = 0;
+  for (c = 0; c < chunks.size(); c++)
+    {
+    vtkstd::vector<float> &chunk = chunks[c].*chunkValues;
+    if (!chunk.empty())
+      {
+      memcpy(values->GetPointer(offset), &chunk[0], 
+             chunk.size()*sizeof(float));
+      offset += static_cast<vtkIdType>(chunk.size());
+      }
+    vtkstd::vector<float>().swap(chunk);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Parse the whole file with one thread per chunk, and fill the same
+// structures as the line by line parser.
+static bool vtkOBJReaderParseInParallel(
+  vtkOBJReader *self, FILE *in, vtkPoints *points, vtkFloatArray *tcoords,
+  vtkFloatArray *normals, vtkCellArray *polys, vtkCellArray *tcoord_polys,
+  vtkCellArray *normal_polys, vtkCellArray *pointElems,
+  vtkCellArray *lineElems, bool &hasTCoords, bool &hasNormals,
+  bool &tcoords_same_as_verts, bool &normals_same_as_verts)
+{
+  // load the file, null terminated
+  unsigned long length = 
+    vtksys::SystemTools::FileLength(self->GetFileName());
+  vtkstd::vector<char> buffer(length + 1);
+  length = static_cast<unsigned long>(fread(&buffer[0], 1, length, in));
+  buffer[length] = '\0';
+  const char *begin = &buffer[0];
+  const char *end = begin + length;
+
+  // split it at line boundaries, keeping continued lines together
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  int numChunks = threader->GetNumberOfThreads();
+  vtkstd::vector<vtkOBJReaderChunk> chunks(numChunks);
+  const char *chunkBegin = begin;
+  int c;
+  for (c = 0; c < numChunks; c++)
+    {
+    const char *chunkEnd = begin + 
+      static_cast<size_t>(static_cast<double>(length)*(c + 1)/numChunks);
+    chunkEnd = (chunkEnd > chunkBegin) ? chunkEnd : chunkBegin;
+    while (chunkEnd < end && 
+           (chunkEnd == chunkBegin || chunkEnd[-1] != '\n' ||
+            (chunkEnd - 1 > begin && chunkEnd[-2] == '\\')))
+      {
+      chunkEnd++;
+      }
+    chunks[c].Begin = chunkBegin;
+    chunks[c].End = (c == numChunks - 1) ? end : chunkEnd;
+    chunkBegin = chunks[c].End;
+    }
+
+  threader->SetSingleMethod(vtkOBJReaderParseChunk, &chunks[0]);
+  threader->SingleMethodExecute();
+  threader->Delete();
+
+  // report the first error of the file
+  int lineNr = 0;
+  for (c = 0; c < numChunks; c++)
+    {
+    if (chunks[c].ErrorMessage)
+      {
+      vtkErrorWithObjectMacro(self, << chunks[c].ErrorMessage 
+                              << lineNr + chunks[c].ErrorLine
+                              << chunks[c].ErrorSuffix);
+      return false;
+      }
+    lineNr += chunks[c].NumberOfLines;
+    hasTCoords = hasTCoords || chunks[c].HasTCoords;
+    hasNormals = hasNormals || chunks[c].HasNormals;
+    tcoords_same_as_verts = 
+      tcoords_same_as_verts && chunks[c].TCoordsSameAsVerts;
+    normals_same_as_verts = 
+      normals_same_as_verts && chunks[c].NormalsSameAsVerts;
+    }
+  vtkstd::vector<char>().swap(buffer);
+
+  points->SetDataTypeToFloat();
+  vtkFloatArray *pointArray = vtkFloatArray::New();
+  pointArray->SetNumberOfComponents(3);
+  vtkOBJReaderConcatenateFloats(chunks, &vtkOBJReaderChunk::Points,
+                                pointArray);
+  points->SetData(pointArray);
+  pointArray->Delete();
+  vtkOBJReaderConcatenateFloats(chunks, &vtkOBJReaderChunk::TCoords, tcoords);
+  vtkOBJReaderConcatenateFloats(chunks, &vtkOBJReaderChunk::Normals, normals);
+
+  vtkOBJReaderConcatenateCells(chunks, &vtkOBJReaderChunk::Verts,
+                               &vtkOBJReaderChunk::NumberOfVerts, pointElems);
+  vtkOBJReaderConcatenateCells(chunks, &vtkOBJReaderChunk::LineElems,
+                               &vtkOBJReaderChunk::NumberOfLineElems,
+                               lineElems);
+  vtkOBJReaderConcatenateCells(chunks, &vtkOBJReaderChunk::Polys,
+                               &vtkOBJReaderChunk::NumberOfPolys, polys);
+  vtkOBJReaderConcatenateCells(chunks, &vtkOBJReaderChunk::TCoordPolys,
+                               &vtkOBJReaderChunk::NumberOfPolys,
+                               tcoord_polys);
+  vtkOBJReaderConcatenateCells(chunks, &vtkOBJReaderChunk::NormalPolys,
+                               &vtkOBJReaderChunk::NumberOfPolys,
+                               normal_polys);
+
+  return true;
+}
+
+
 int vtkOBJReader::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **vtkNotUsed(inputVector),
@@ -150,6 +750,14 @@ int vtkOBJReader::RequestData(
 
   // -- work through the file line by line, assigning into the above 7 structures as appropriate --
 
+  if (this->ParallelParsing)
+    {
+    everything_ok = vtkOBJReaderParseInParallel(
+      this, in, points, tcoords, normals, polys, tcoord_polys, normal_polys,
+      pointElems, lineElems, hasTCoords, hasNormals, tcoords_same_as_verts,
+      normals_same_as_verts);
+    }
+  else
   { // (make a local scope section to emphasise that the variables below are only used here)
 
   const int MAX_LINE = 1024;
@@ -612,6 +1220,8 @@ void vtkOBJReader::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "File Name: "
      << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "Parallel Parsing: "
+     << (this->ParallelParsing ? "On\n" : "Off\n");
 
 }
 
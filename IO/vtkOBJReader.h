@@ -16,6 +16,11 @@
 // .SECTION Description
 // vtkOBJReader is a source object that reads Wavefront .obj
 // files. The output of this source object is polygonal data.
+//
+// With ParallelParsing on, the whole file is loaded into memory and split
+// at line boundaries into chunks that are parsed by several threads, and
+// the chunks are then concatenated.  The output is identical to the one
+// of the line by line parser, but large files load much faster.
 // .SECTION See Also
 // vtkOBJImporter
 
@@ -36,6 +41,13 @@ public:
   vtkSetStringMacro(FileName);
   vtkGetStringMacro(FileName);
 
+  // Description:
+  // Turn on/off parsing the file in chunks with several threads.  This
+  // needs as much memory as the size of the file.  Off by default.
+  vtkSetMacro(ParallelParsing,int);
+  vtkGetMacro(ParallelParsing,int);
+  vtkBooleanMacro(ParallelParsing,int);
+
 protected:
   vtkOBJReader();
   ~vtkOBJReader();
@@ -43,6 +55,7 @@ protected:
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
 
   char *FileName;
+  int ParallelParsing;
 private:
   vtkOBJReader(const vtkOBJReader&);  // Not implemented.
   void operator=(const vtkOBJReader&);  // Not implemented.
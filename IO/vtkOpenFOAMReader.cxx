@@ -54,6 +54,9 @@
 
 #include "vtkOpenFOAMReader.h"
 
+#include <vtkstd/algorithm>
+#include <vtkstd/list>
+#include <vtkstd/map>
 #include <vtkstd/vector>
 #include "vtksys/DateStamp.h"
 #include "vtksys/SystemTools.hxx"
@@ -74,6 +77,8 @@
 #include "vtkInformationVector.h"
 #include "vtkIntArray.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
@@ -143,6 +148,8 @@ template <typename T> struct vtkFoamReadValue;
 struct vtkFoamEntryValue;
 struct vtkFoamEntry;
 struct vtkFoamDict;
+struct vtkFoamField;
+struct vtkFoamFieldJob;
 
 //-----------------------------------------------------------------------------
 // class vtkOpenFOAMReaderPrivate
@@ -170,6 +177,8 @@ public:
       vtkStringArray *, const bool);
   void SetupInformation(const vtkStdString &, const vtkStdString &,
       const vtkStdString &, vtkOpenFOAMReaderPrivate *);
+  // read a field of another timestep into the field cache
+  bool PrefetchField(const vtkStdString &, const bool);
 
 private:
   struct vtkFoamBoundaryEntry
@@ -316,14 +325,16 @@ private:
 
   // read and create cell/point fields
   void ConstructDimensions(vtkStdString *, vtkFoamDict *);
-  bool ReadFieldFile(vtkFoamIOobject *, vtkFoamDict *, const vtkStdString &,
-      vtkDataArraySelection *);
+  bool ReadFieldFile(vtkFoamIOobject *, const bool, vtkFoamField *);
+  void ParseFieldJob(vtkFoamFieldJob *);
+  static VTK_THREAD_RETURN_TYPE ReadFieldsThread(void *);
+  void ReadFieldsAtTimeStep(vtkstd::vector<vtkFoamFieldJob> *);
   vtkFloatArray *FillField(vtkFoamEntry *, int, vtkFoamIOobject *,
       const vtkStdString &);
   void GetVolFieldAtTimeStep(vtkUnstructuredGrid *, vtkMultiBlockDataSet *,
-      const vtkStdString &);
+      const vtkFoamField &);
   void GetPointFieldAtTimeStep(vtkUnstructuredGrid *, vtkMultiBlockDataSet *,
-      const vtkStdString &);
+      const vtkFoamField &);
   void AddArrayToFieldData(vtkDataSetAttributes *, vtkDataArray *,
       const vtkStdString &);
 
@@ -3595,6 +3606,342 @@ void vtkFoamEntry::Read(vtkFoamIOobject& io)
     }
 }
 
+//-----------------------------------------------------------------------------
+// struct vtkFoamField
+// arrays read from a field file, which are kept in vtkFoamFieldCache
+// across timesteps. The arrays are reference counted so that a copy
+// stays valid even after the cache entry is discarded.
+struct vtkFoamField
+{
+  vtkStdString ObjectName;
+  vtkStdString DimString;
+  vtkFloatArray *InternalField;
+  // values of each boundary of a volField in the order of the boundary
+  // dictionary. NULL for boundaries that take patch-internal values.
+  vtkstd::vector<vtkFloatArray *> BoundaryFields;
+
+  vtkFoamField() :
+    InternalField(NULL)
+  {
+  }
+  vtkFoamField(const vtkFoamField &field) :
+    InternalField(NULL)
+  {
+    this->operator=(field);
+  }
+  ~vtkFoamField()
+  {
+    this->Clear();
+  }
+
+  vtkFoamField &operator=(const vtkFoamField &field)
+  {
+    if (this == &field)
+      {
+      return *this;
+      }
+    this->Clear();
+    this->ObjectName = field.ObjectName;
+    this->DimString = field.DimString;
+    this->InternalField = field.InternalField;
+    if (this->InternalField != NULL)
+      {
+      this->InternalField->Register(NULL);
+      }
+    this->BoundaryFields = field.BoundaryFields;
+    for (size_t boundaryI = 0; boundaryI < this->BoundaryFields.size();
+      boundaryI++)
+      {
+      if (this->BoundaryFields[boundaryI] != NULL)
+        {
+        this->BoundaryFields[boundaryI]->Register(NULL);
+        }
+      }
+    return *this;
+  }
+
+  void Clear()
+  {
+    if (this->InternalField != NULL)
+      {
+      this->InternalField->Delete();
+      this->InternalField = NULL;
+      }
+    for (size_t boundaryI = 0; boundaryI < this->BoundaryFields.size();
+      boundaryI++)
+      {
+      if (this->BoundaryFields[boundaryI] != NULL)
+        {
+        this->BoundaryFields[boundaryI]->Delete();
+        }
+      }
+    this->BoundaryFields.clear();
+    this->ObjectName.erase();
+    this->DimString.erase();
+  }
+
+  // in MiB
+  double GetActualMemorySize() const
+  {
+    unsigned long size = 0; // in kiB
+    if (this->InternalField != NULL)
+      {
+      size += this->InternalField->GetActualMemorySize();
+      }
+    for (size_t boundaryI = 0; boundaryI < this->BoundaryFields.size();
+      boundaryI++)
+      {
+      if (this->BoundaryFields[boundaryI] != NULL)
+        {
+        size += this->BoundaryFields[boundaryI]->GetActualMemorySize();
+        }
+      }
+    return static_cast<double>(size) / 1024.0;
+  }
+};
+
+//-----------------------------------------------------------------------------
+// struct vtkFoamFieldJob
+// a field file to be read at the current timestep
+struct vtkFoamFieldJob
+{
+  vtkStdString VarName;
+  bool IsVolField;
+  vtkDataArraySelection *Selection;
+  vtkFoamField Field;
+  bool IsRead; // Field is valid and selected
+  bool IsCached; // Field has been taken from the field cache
+  vtkFoamError Error;
+
+  vtkFoamFieldJob(const vtkStdString &varName, const bool isVolField,
+      vtkDataArraySelection *selection) :
+    VarName(varName), IsVolField(isVolField), Selection(selection),
+    IsRead(false), IsCached(false)
+  {
+  }
+};
+
+//-----------------------------------------------------------------------------
+// struct vtkFoamFieldThreadStruct
+// the list of field files shared by the parsing threads
+struct vtkFoamFieldThreadStruct
+{
+  vtkOpenFOAMReaderPrivate *Reader;
+  vtkstd::vector<vtkFoamFieldJob *> Jobs;
+  size_t NextJob;
+  size_t NumberOfFinishedJobs;
+  vtkMutexLock *Lock;
+};
+
+//-----------------------------------------------------------------------------
+// class vtkFoamFieldCache
+// an LRU cache of fields keyed by the path to the field file, i.e. by
+// (timestep, region, field). Also runs the thread that reads the fields
+// of adjacent timesteps in advance. The cache is accessed only by the
+// prefetch thread while it runs; the reader stops the thread before
+// updating its output. The output always gets copies of the cached
+// arrays, so the arrays in the cache are never seen outside the reader.
+// The prefetch thread parses the files with the same code as the main
+// thread, which creates vtkFloatArray and vtkIntArray objects with
+// New(). This is safe because creating an object only reads the list of
+// registered object factories, which has been set up by the time the
+// reader exists, and vtkDebugLeaks locks its own tables. Object
+// factories must not be registered or unregistered while the reader
+// updates.
+class vtkFoamFieldCache
+{
+private:
+  struct vtkFoamFieldCacheEntry
+    {
+    vtkFoamField Field;
+    double Size;
+    vtkstd::list<vtkStdString>::iterator LRURef;
+    };
+  typedef vtkstd::map<vtkStdString, vtkFoamFieldCacheEntry> entryMap;
+
+  struct vtkFoamPrefetchJob
+    {
+    vtkOpenFOAMReaderPrivate *Reader;
+    vtkStdString VarPath;
+    bool IsVolField;
+    int Offset; // from the current timestep
+    bool operator<(const vtkFoamPrefetchJob &job) const
+      {
+      // nearer timesteps first, forward before backward
+      const int distance = this->Offset < 0 ? -this->Offset : this->Offset;
+      const int jobDistance = job.Offset < 0 ? -job.Offset : job.Offset;
+      return distance < jobDistance
+          || (distance == jobDistance && this->Offset > job.Offset);
+      }
+    };
+
+  entryMap Entries;
+  // least recently used first
+  vtkstd::list<vtkStdString> LRU;
+  double Capacity; // in MiB
+  double Size; // in MiB
+
+  vtkstd::vector<vtkFoamPrefetchJob> PrefetchJobs;
+  vtkMultiThreader *Threader;
+  int PrefetchThreadId;
+
+  void Erase(entryMap::iterator it)
+  {
+    this->Size -= it->second.Size;
+    this->LRU.erase(it->second.LRURef);
+    this->Entries.erase(it);
+    if (this->Entries.empty())
+      {
+      // avoid accumulating floating-point errors
+      this->Size = 0.0;
+      }
+  }
+
+  static VTK_THREAD_RETURN_TYPE PrefetchThread(void *arg)
+  {
+    vtkMultiThreader::ThreadInfo *info =
+        static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+    vtkFoamFieldCache *cache = static_cast<vtkFoamFieldCache *>(info->UserData);
+    for (size_t jobI = 0; jobI < cache->PrefetchJobs.size(); jobI++)
+      {
+      info->ActiveFlagLock->Lock();
+      const int active = *info->ActiveFlag;
+      info->ActiveFlagLock->Unlock();
+      const vtkFoamPrefetchJob &job = cache->PrefetchJobs[jobI];
+      if (!active || !job.Reader->PrefetchField(job.VarPath, job.IsVolField))
+        {
+        break;
+        }
+      }
+    return VTK_THREAD_RETURN_VALUE;
+  }
+
+public:
+  vtkFoamFieldCache() :
+    Capacity(0.0), Size(0.0), Threader(vtkMultiThreader::New()),
+    PrefetchThreadId(-1)
+  {
+  }
+  ~vtkFoamFieldCache()
+  {
+    this->Clear();
+    this->Threader->Delete();
+  }
+
+  // set the capacity in MiB, discarding entries that don't fit
+  void SetCapacity(const double capacity)
+  {
+    this->Capacity = capacity;
+    while (this->Size > this->Capacity && !this->LRU.empty())
+      {
+      this->Erase(this->Entries.find(this->LRU.front()));
+      }
+  }
+
+  // copy the field to the argument if it is in the cache
+  bool Find(const vtkStdString &key, vtkFoamField *field)
+  {
+    entryMap::iterator it = this->Entries.find(key);
+    if (it == this->Entries.end())
+      {
+      return false;
+      }
+    // mark as the most recently used
+    this->LRU.splice(this->LRU.end(), this->LRU, it->second.LRURef);
+    *field = it->second.Field;
+    return true;
+  }
+
+  bool Contains(const vtkStdString &key) const
+  {
+    return this->Entries.find(key) != this->Entries.end();
+  }
+
+  // put a field into the cache, discarding least recently used
+  // entries if evict is true. Returns false if the field doesn't fit.
+  bool Insert(const vtkStdString &key, const vtkFoamField &field,
+      const bool evict)
+  {
+    const double size = field.GetActualMemorySize();
+    if (size > this->Capacity)
+      {
+      return false;
+      }
+    entryMap::iterator it = this->Entries.find(key);
+    if (it != this->Entries.end())
+      {
+      this->Erase(it);
+      }
+    if (this->Size + size > this->Capacity && !evict)
+      {
+      return false;
+      }
+    while (this->Size + size > this->Capacity && !this->LRU.empty())
+      {
+      this->Erase(this->Entries.find(this->LRU.front()));
+      }
+    vtkFoamFieldCacheEntry &entry = this->Entries[key];
+    entry.Field = field;
+    entry.Size = size;
+    entry.LRURef = this->LRU.insert(this->LRU.end(), key);
+    this->Size += size;
+    return true;
+  }
+
+  void Clear()
+  {
+    this->StopPrefetch();
+    this->Entries.clear();
+    this->LRU.clear();
+    this->Size = 0.0;
+  }
+
+  void AddPrefetchJob(vtkOpenFOAMReaderPrivate *reader,
+      const vtkStdString &varPath, const bool isVolField, const int offset)
+  {
+    // the reader may be replaced while the job is waiting
+    reader->Register(NULL);
+    vtkFoamPrefetchJob job;
+    job.Reader = reader;
+    job.VarPath = varPath;
+    job.IsVolField = isVolField;
+    job.Offset = offset;
+    this->PrefetchJobs.push_back(job);
+  }
+
+  // read the queued fields into the cache in a background thread
+  void StartPrefetch()
+  {
+    if (this->PrefetchThreadId >= 0 || this->PrefetchJobs.empty())
+      {
+      return;
+      }
+    vtkstd::stable_sort(this->PrefetchJobs.begin(), this->PrefetchJobs.end());
+    this->PrefetchThreadId = this->Threader->SpawnThread(
+        &vtkFoamFieldCache::PrefetchThread, this);
+    if (this->PrefetchThreadId < 0)
+      {
+      this->StopPrefetch();
+      }
+  }
+
+  // wait for the thread to finish the field it is reading and drop
+  // the remaining jobs
+  void StopPrefetch()
+  {
+    if (this->PrefetchThreadId >= 0)
+      {
+      this->Threader->TerminateThread(this->PrefetchThreadId);
+      this->PrefetchThreadId = -1;
+      }
+    for (size_t jobI = 0; jobI < this->PrefetchJobs.size(); jobI++)
+      {
+      this->PrefetchJobs[jobI].Reader->UnRegister(NULL);
+      }
+    this->PrefetchJobs.clear();
+  }
+};
+
 //-----------------------------------------------------------------------------
 // vtkOpenFOAMReaderPrivate constructor and destructor
 vtkOpenFOAMReaderPrivate::vtkOpenFOAMReaderPrivate()
@@ -6383,45 +6730,311 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
 }
 
 //-----------------------------------------------------------------------------
+// read an opened field file into arrays that can be kept in the field
+// cache. Errors are stored in the IOobject so that the function can be
+// called from the prefetch thread as well.
 bool vtkOpenFOAMReaderPrivate::ReadFieldFile(vtkFoamIOobject *ioPtr,
-    vtkFoamDict *dictPtr, const vtkStdString &varName,
-    vtkDataArraySelection *selection)
+    const bool isVolField, vtkFoamField *field)
 {
-  const vtkStdString varPath(this->CurrentTimeRegionPath() + "/" + varName);
-
-  // open the file
   vtkFoamIOobject &io = *ioPtr;
-  if (!io.Open(varPath))
+
+  // read the field file into dictionary
+  vtkFoamDict dict;
+  if (!dict.Read(io))
     {
-    vtkErrorMacro(<<"Error opening " << io.GetFileName().c_str() << ": "
+    io.SetError(vtkFoamError() << "Error reading line " << io.GetLineNumber()
+        << " of " << io.GetFileName().c_str() << ": "
         << io.GetError().c_str());
     return false;
     }
 
-  // if the variable is disabled on selection panel then skip it
-  if (selection->ArrayExists(io.GetObjectName().c_str()) && !selection->ArrayIsEnabled(io.GetObjectName().c_str()))
+  if (dict.GetType() != vtkFoamToken::DICTIONARY)
     {
+    io.SetError(vtkFoamError() << "File " << io.GetFileName().c_str()
+        << "is not valid as a field file");
     return false;
     }
 
-  // read the field file into dictionary
-  vtkFoamDict &dict = *dictPtr;
-  if (!dict.Read(io))
+  const vtkStdString prefix(isVolField ? "vol" : "point");
+  if (io.GetClassName().substr(0, prefix.length()) != prefix)
     {
-    vtkErrorMacro(<<"Error reading line " << io.GetLineNumber()
-        << " of " << io.GetFileName().c_str() << ": " << io.GetError().c_str());
+    io.SetError(vtkFoamError() << io.GetFileName().c_str() << " is not a "
+        << prefix.c_str() << "Field");
     return false;
     }
 
-  if (dict.GetType() != vtkFoamToken::DICTIONARY)
+  vtkFoamEntry *iEntry = dict.Lookup("internalField");
+  if (iEntry == NULL)
     {
-    vtkErrorMacro(<<"File " << io.GetFileName().c_str()
-        << "is not valid as a field file");
+    io.SetError(vtkFoamError() << "internalField not found in "
+        << io.GetFileName().c_str());
+    return false;
+    }
+
+  const int nElements = isVolField ? this->NumCells : this->NumPoints;
+  if (iEntry->FirstValue().GetType() == vtkFoamToken::EMPTYLIST)
+    {
+    // if there's no cell there shouldn't be any boundary faces either
+    if (nElements > 0)
+      {
+      io.SetError(vtkFoamError() << "internalField of "
+          << io.GetFileName().c_str() << " is empty");
+      }
+    return false;
+    }
+
+  vtkStdString fieldType = io.GetClassName().substr(prefix.length(),
+      vtkStdString::npos);
+  vtkFloatArray *iData = this->FillField(iEntry, nElements, &io, fieldType);
+  if (iData == NULL)
+    {
+    return false;
+    }
+  if (iData->GetSize() == 0)
+    {
+    // determine as there's no cells / points
+    iData->Delete();
     return false;
     }
+
+  field->Clear();
+  field->ObjectName = io.GetObjectName();
+  this->ConstructDimensions(&field->DimString, &dict);
+  field->InternalField = iData;
+  if (!isVolField)
+    {
+    return true;
+    }
+
+  // read boundary values
+  const vtkFoamEntry *bEntry = dict.Lookup("boundaryField");
+  if (bEntry == NULL)
+    {
+    io.SetError(vtkFoamError() << "boundaryField not found in "
+        << io.GetFileName().c_str());
+    field->Clear();
+    return false;
+    }
+
+  for (size_t boundaryI = 0; boundaryI < this->BoundaryDict.size();
+    boundaryI++)
+    {
+    const vtkFoamBoundaryEntry &beI = this->BoundaryDict[boundaryI];
+    const vtkStdString &boundaryNameI = beI.BoundaryName;
+
+    const vtkFoamEntry *bEntryI = bEntry->Dictionary().Lookup(boundaryNameI);
+    if (bEntryI == NULL)
+      {
+      io.SetError(vtkFoamError() << "boundaryField " << boundaryNameI.c_str()
+          << " not found in " << io.GetFileName().c_str());
+      field->Clear();
+      return false;
+      }
+
+    if (bEntryI->FirstValue().GetType() != vtkFoamToken::DICTIONARY)
+      {
+      io.SetError(vtkFoamError() << "Type of boundaryField "
+          << boundaryNameI.c_str() << " is not a subdictionary in "
+          << io.GetFileName().c_str());
+      field->Clear();
+      return false;
+      }
+
+    vtkFoamEntry *vEntry = bEntryI->Dictionary().Lookup("value");
+    if (vEntry == NULL)
+      {
+      // uniformFixedValue B.C.
+      const vtkFoamEntry *ufvEntry = bEntryI->Dictionary().Lookup("type");
+      if (ufvEntry != NULL && ufvEntry->ToString() == "uniformFixedValue")
+        {
+        // the boundary is of uniformFixedValue type
+        vEntry = bEntryI->Dictionary().Lookup("uniformValue");
+        }
+      }
+
+    // a NULL array tells that the boundary has neither a value nor a
+    // uniformValue entry and takes the patch-internal values
+    vtkFloatArray *vData = NULL;
+    if (vEntry != NULL)
+      {
+      vData = this->FillField(vEntry, beI.NFaces, &io, fieldType);
+      if (vData == NULL)
+        {
+        field->Clear();
+        return false;
+        }
+      }
+    field->BoundaryFields.push_back(vData);
+    }
   return true;
 }
 
+//-----------------------------------------------------------------------------
+// read a field file of the current timestep in a parsing thread.
+// Errors are stored in the job to be reported by the main thread.
+void vtkOpenFOAMReaderPrivate::ParseFieldJob(vtkFoamFieldJob *job)
+{
+  const vtkStdString varPath(this->CurrentTimeRegionPath() + "/"
+      + job->VarName);
+
+  // open the file
+  vtkFoamIOobject io(this->CasePath);
+  if (!io.Open(varPath))
+    {
+    job->Error = vtkFoamError() << "Error opening "
+        << io.GetFileName().c_str() << ": " << io.GetError().c_str();
+    return;
+    }
+
+  // if the variable is disabled on selection panel then skip it
+  if (job->Selection->ArrayExists(io.GetObjectName().c_str())
+      && !job->Selection->ArrayIsEnabled(io.GetObjectName().c_str()))
+    {
+    return;
+    }
+
+  if (!this->ReadFieldFile(&io, job->IsVolField, &job->Field))
+    {
+    job->Error = io.GetError();
+    return;
+    }
+  job->IsRead = true;
+}
+
+//-----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkOpenFOAMReaderPrivate::ReadFieldsThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+      static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkFoamFieldThreadStruct *str =
+      static_cast<vtkFoamFieldThreadStruct *>(info->UserData);
+
+  // take the next file in the list until all the files are read
+  str->Lock->Lock();
+  while (str->NextJob < str->Jobs.size())
+    {
+    vtkFoamFieldJob *job = str->Jobs[str->NextJob++];
+    str->Lock->Unlock();
+    str->Reader->ParseFieldJob(job);
+    str->Lock->Lock();
+    str->NumberOfFinishedJobs++;
+    if (info->ThreadID == 0)
+      {
+      // only the main thread may invoke progress events
+      str->Reader->Parent->UpdateProgress(0.5 + 0.25
+          * static_cast<double>(str->NumberOfFinishedJobs)
+          / static_cast<double>(str->Jobs.size()));
+      }
+    }
+  str->Lock->Unlock();
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+// get the fields at the current timestep from the field cache, or read
+// the field files concurrently and put the fields into the cache
+void vtkOpenFOAMReaderPrivate::ReadFieldsAtTimeStep(
+    vtkstd::vector<vtkFoamFieldJob> *jobsPtr)
+{
+  vtkstd::vector<vtkFoamFieldJob> &jobs = *jobsPtr;
+  vtkFoamFieldCache *cache = this->Parent->FieldCache;
+
+  vtkFoamFieldThreadStruct str;
+  str.Reader = this;
+  str.NextJob = 0;
+  str.NumberOfFinishedJobs = 0;
+  for (size_t jobI = 0; jobI < jobs.size(); jobI++)
+    {
+    vtkFoamFieldJob &job = jobs[jobI];
+    if (cache->Find(this->CurrentTimeRegionPath() + "/" + job.VarName,
+        &job.Field))
+      {
+      // the selection status may have changed since the field was cached
+      job.IsRead = !job.Selection->ArrayExists(job.Field.ObjectName.c_str())
+          || job.Selection->ArrayIsEnabled(job.Field.ObjectName.c_str());
+      job.IsCached = true;
+      this->Parent->FieldCacheHitCount++;
+      }
+    else
+      {
+      str.Jobs.push_back(&job);
+      }
+    }
+
+  const int nThreads = vtkstd::min(this->Parent->GetNumberOfThreads(),
+      static_cast<int>(str.Jobs.size()));
+  if (nThreads > 0)
+    {
+    str.Lock = vtkMutexLock::New();
+    vtkMultiThreader *threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(nThreads);
+    threader->SetSingleMethod(&vtkOpenFOAMReaderPrivate::ReadFieldsThread,
+        &str);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    str.Lock->Delete();
+    }
+
+  const int nPrefetchSteps = this->Parent->GetNumberOfPrefetchTimeSteps();
+  const int nTimes = this->TimeNames->GetNumberOfValues();
+  for (size_t jobI = 0; jobI < jobs.size(); jobI++)
+    {
+    vtkFoamFieldJob &job = jobs[jobI];
+    if (job.Error != "")
+      {
+      vtkErrorMacro(<< job.Error.c_str());
+      }
+    if (!job.IsRead)
+      {
+      continue;
+      }
+    if (!job.IsCached)
+      {
+      cache->Insert(this->CurrentTimeRegionPath() + "/" + job.VarName,
+          job.Field, true);
+      }
+
+    // queue the same field of the adjacent timesteps for prefetching as
+    // long as the mesh topology doesn't change
+    for (int stepI = 1; stepI <= nPrefetchSteps; stepI++)
+      {
+      for (int direction = 1; direction >= -1; direction -= 2)
+        {
+        const int timeI = this->TimeStep + direction * stepI;
+        if (timeI >= 0 && timeI < nTimes
+            && this->PolyMeshFacesDir->GetValue(timeI)
+                == this->PolyMeshFacesDir->GetValue(this->TimeStep))
+          {
+          cache->AddPrefetchJob(this, this->TimeRegionPath(timeI) + "/"
+              + job.VarName, job.IsVolField, direction * stepI);
+          }
+        }
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// read a field into the field cache in the prefetch thread. Returns
+// false if the cache is full.
+bool vtkOpenFOAMReaderPrivate::PrefetchField(const vtkStdString &varPath,
+    const bool isVolField)
+{
+  vtkFoamFieldCache *cache = this->Parent->FieldCache;
+  if (cache->Contains(varPath))
+    {
+    return true;
+    }
+
+  // errors are left to be reported when the timestep is actually read
+  vtkFoamIOobject io(this->CasePath);
+  vtkFoamField field;
+  if (!io.Open(varPath) || !this->ReadFieldFile(&io, isVolField, &field))
+    {
+    return true;
+    }
+  return cache->Insert(varPath, field, false);
+}
+
 //-----------------------------------------------------------------------------
 vtkFloatArray *vtkOpenFOAMReaderPrivate::FillField(vtkFoamEntry *entryPtr,
     int nElements, vtkFoamIOobject *ioPtr, const vtkStdString &fieldType)
@@ -6466,7 +7079,7 @@ vtkFloatArray *vtkOpenFOAMReaderPrivate::FillField(vtkFoamEntry *entryPtr,
         }
       else
         {
-        vtkErrorMacro(<<"Wrong list type for uniform field");
+        ioPtr->SetError(vtkFoamError() << "Wrong list type for uniform field");
         return NULL;
         }
 
@@ -6499,9 +7112,10 @@ vtkFloatArray *vtkOpenFOAMReaderPrivate::FillField(vtkFoamEntry *entryPtr,
         }
       else
         {
-        vtkErrorMacro(<< "Number of components and field class doesn't match "
-                      << "for " << ioPtr->GetFileName().c_str() << ". class = " << className.c_str()
-                      << ", nComponents = " << nComponents);
+        ioPtr->SetError(vtkFoamError()
+            << "Number of components and field class doesn't match "
+            << "for " << ioPtr->GetFileName().c_str() << ". class = "
+            << className.c_str() << ", nComponents = " << nComponents);
         return NULL;
         }
       }
@@ -6516,7 +7130,8 @@ vtkFloatArray *vtkOpenFOAMReaderPrivate::FillField(vtkFoamEntry *entryPtr,
       const int nTuples = entry.ScalarList().GetNumberOfTuples();
       if (nTuples != nElements)
         {
-        vtkErrorMacro(<<"Number of cells/points in mesh and field don't match: "
+        ioPtr->SetError(vtkFoamError()
+            << "Number of cells/points in mesh and field don't match: "
             << "mesh = " << nElements << ", field = " << nTuples);
         return NULL;
         }
@@ -6564,8 +7179,8 @@ vtkFloatArray *vtkOpenFOAMReaderPrivate::FillField(vtkFoamEntry *entryPtr,
       }
     else
       {
-      vtkErrorMacro(<< ioPtr->GetFileName().c_str() << " is not a valid "
-          << ioPtr->GetClassName().c_str());
+      ioPtr->SetError(vtkFoamError() << ioPtr->GetFileName().c_str()
+          << " is not a valid " << ioPtr->GetClassName().c_str());
       return NULL;
       }
     }
@@ -6660,50 +7275,13 @@ void vtkOpenFOAMReaderPrivate::ConstructDimensions(vtkStdString *dimString,
 //-----------------------------------------------------------------------------
 void vtkOpenFOAMReaderPrivate::GetVolFieldAtTimeStep(
     vtkUnstructuredGrid *internalMesh, vtkMultiBlockDataSet *boundaryMesh,
-    const vtkStdString &varName)
+    const vtkFoamField &field)
 {
-  vtkFoamIOobject io(this->CasePath);
-  vtkFoamDict dict;
-  if (!this->ReadFieldFile(&io, &dict, varName,
-      this->Parent->CellDataArraySelection))
-    {
-    return;
-    }
-
-  if (io.GetClassName().substr(0, 3) != "vol")
-    {
-    vtkErrorMacro(<< io.GetFileName().c_str() << " is not a volField");
-    return;
-    }
-
-  vtkFoamEntry *iEntry = dict.Lookup("internalField");
-  if (iEntry == NULL)
-    {
-    vtkErrorMacro(<<"internalField not found in " << io.GetFileName().c_str());
-    return;
-    }
-
-  if (iEntry->FirstValue().GetType() == vtkFoamToken::EMPTYLIST)
-    {
-    // if there's no cell there shouldn't be any boundary faces either
-    if (this->NumCells > 0)
-      {
-      vtkErrorMacro(<<"internalField of " << io.GetFileName().c_str()
-          << " is empty");
-      }
-    return;
-    }
-
-  vtkStdString fieldType = io.GetClassName().substr(3, vtkStdString::npos);
-  vtkFloatArray *iData =
-      this->FillField(iEntry, this->NumCells, &io, fieldType);
-  if (iData == NULL)
-    {
-    return;
-    }
-
-  vtkStdString dimString;
-  this->ConstructDimensions(&dimString, &dict);
+  // the arrays of the field are shared with the field cache, so the
+  // output gets copies that it may rename and extend
+  vtkFloatArray *iData = vtkFloatArray::New();
+  iData->DeepCopy(field.InternalField);
+  const vtkStdString &dimString = field.DimString;
 
   vtkFloatArray *acData = NULL, *ctpData = NULL;
 
@@ -6714,191 +7292,76 @@ void vtkOpenFOAMReaderPrivate::GetVolFieldAtTimeStep(
     acData->SetNumberOfTuples(this->AllBoundaries->GetNumberOfCells());
     }
 
-  if (iData->GetSize() > 0)
+  // Add field only if internal Mesh exists (skip if not selected).
+  // Note we still need to read internalField even if internal mesh is
+  // not selected, since boundaries without value entries may refer to
+  // the internalField.
+  if (internalMesh != NULL)
     {
-    // Add field only if internal Mesh exists (skip if not selected).
-    // Note we still need to read internalField even if internal mesh is
-    // not selected, since boundaries without value entries may refer to
-    // the internalField.
-    if (internalMesh != NULL)
+    if (this->Parent->GetDecomposePolyhedra())
       {
-      if (this->Parent->GetDecomposePolyhedra())
+      // add values for decomposed cells
+      this->ExtendArray<vtkFloatArray, float>(iData, this->NumCells
+          + this->NumTotalAdditionalCells);
+      const int nTuples = this->AdditionalCellIds->GetNumberOfTuples();
+      int additionalCellI = this->NumCells;
+      for (int tupleI = 0; tupleI < nTuples; tupleI++)
         {
-        // add values for decomposed cells
-        this->ExtendArray<vtkFloatArray, float>(iData, this->NumCells
-            + this->NumTotalAdditionalCells);
-        const int nTuples = this->AdditionalCellIds->GetNumberOfTuples();
-        int additionalCellI = this->NumCells;
-        for (int tupleI = 0; tupleI < nTuples; tupleI++)
+        const int nCells = this->NumAdditionalCells->GetValue(tupleI);
+        const vtkIdType cellId = this->AdditionalCellIds->GetValue(tupleI);
+        for (int cellI = 0; cellI < nCells; cellI++)
           {
-          const int nCells = this->NumAdditionalCells->GetValue(tupleI);
-          const vtkIdType cellId = this->AdditionalCellIds->GetValue(tupleI);
-          for (int cellI = 0; cellI < nCells; cellI++)
-            {
-            iData->InsertTuple(additionalCellI++, cellId, iData);
-            }
+          iData->InsertTuple(additionalCellI++, cellId, iData);
           }
         }
+      }
 
-      // set data to internal mesh
-      this->AddArrayToFieldData(internalMesh->GetCellData(), iData,
-          io.GetObjectName() + dimString);
+    // set data to internal mesh
+    this->AddArrayToFieldData(internalMesh->GetCellData(), iData,
+        field.ObjectName + dimString);
 
-      if (this->Parent->GetCreateCellToPoint())
+    if (this->Parent->GetCreateCellToPoint())
+      {
+      // Create cell-to-point interpolated data
+      ctpData = vtkFloatArray::New();
+      ctpData->SetNumberOfComponents(iData->GetNumberOfComponents());
+      ctpData->SetNumberOfTuples(internalMesh->GetPoints()->GetNumberOfPoints());
+      if (this->InternalPoints != NULL)
         {
-        // Create cell-to-point interpolated data
-        ctpData = vtkFloatArray::New();
-        ctpData->SetNumberOfComponents(iData->GetNumberOfComponents());
-        ctpData->SetNumberOfTuples(internalMesh->GetPoints()->GetNumberOfPoints());
-        if (this->InternalPoints != NULL)
-          {
-          this->InterpolateCellToPoint(ctpData, iData, internalMesh,
-              this->InternalPoints, this->InternalPoints->GetNumberOfTuples());
-          }
+        this->InterpolateCellToPoint(ctpData, iData, internalMesh,
+            this->InternalPoints, this->InternalPoints->GetNumberOfTuples());
+        }
 
-        if (this->Parent->GetDecomposePolyhedra())
+      if (this->Parent->GetDecomposePolyhedra())
+        {
+        // assign cell values to additional points
+        const int nPoints = this->AdditionalCellIds->GetNumberOfTuples();
+        for (int pointI = 0; pointI < nPoints; pointI++)
           {
-          // assign cell values to additional points
-          const int nPoints = this->AdditionalCellIds->GetNumberOfTuples();
-          for (int pointI = 0; pointI < nPoints; pointI++)
-            {
-            ctpData->SetTuple(this->NumPoints + pointI,
-                this->AdditionalCellIds->GetValue(pointI), iData);
-            }
+          ctpData->SetTuple(this->NumPoints + pointI,
+              this->AdditionalCellIds->GetValue(pointI), iData);
           }
         }
       }
     }
-  else
-    {
-    // determine as there's no cells
-    iData->Delete();
-    if (acData != NULL)
-      {
-      acData->Delete();
-      }
-    return;
-    }
 
   // set boundary values
-  const vtkFoamEntry *bEntry = dict.Lookup("boundaryField");
-  if (bEntry == NULL)
-    {
-    vtkErrorMacro(<< "boundaryField not found in object " << varName.c_str()
-        << " at time = " << this->TimeNames->GetValue(this->TimeStep).c_str());
-    iData->Delete();
-    if (acData != NULL)
-      {
-      acData->Delete();
-      }
-    if (ctpData != NULL)
-      {
-      ctpData->Delete();
-      }
-    return;
-    }
-
-  vtkstd::vector<vtkFloatArray *> vDataVector;
   for (int boundaryI = 0, activeBoundaryI = 0; boundaryI
     < static_cast<int>(this->BoundaryDict.size()); boundaryI++)
     {
     const vtkFoamBoundaryEntry &beI = this->BoundaryDict[boundaryI];
-    const vtkStdString &boundaryNameI = beI.BoundaryName;
-
-    const vtkFoamEntry *bEntryI = bEntry->Dictionary().Lookup(boundaryNameI);
-    if (bEntryI == NULL)
-      {
-      vtkErrorMacro(<< "boundaryField " << boundaryNameI.c_str()
-          << " not found in object " << varName.c_str() << " at time = "
-          << this->TimeNames->GetValue(this->TimeStep).c_str());
-      iData->Delete();
-      if (acData != NULL)
-        {
-        acData->Delete();
-        }
-      if (ctpData != NULL)
-        {
-        ctpData->Delete();
-        }
-      return;
-      }
-
-    if (bEntryI->FirstValue().GetType() != vtkFoamToken::DICTIONARY)
-      {
-      vtkErrorMacro(<< "Type of boundaryField " << boundaryNameI.c_str()
-          << " is not a subdictionary in object " << varName.c_str()
-          << " at time = " << this->TimeNames->GetValue(this->TimeStep).c_str());
-      iData->Delete();
-      if (acData != NULL)
-        {
-        acData->Delete();
-        }
-      if (ctpData != NULL)
-        {
-        ctpData->Delete();
-        }
-      return;
-      }
-
     const int nFaces = beI.NFaces;
 
-    vtkFloatArray* vData = NULL;
-    bool valueFound = false;
-    vtkFoamEntry *vEntry = bEntryI->Dictionary().Lookup("value");
-    if (vEntry != NULL) // the boundary has a value entry
-      {
-      vData = this->FillField(vEntry, nFaces, &io, fieldType);
-      if (vData == NULL)
-        {
-        iData->Delete();
-        if (acData != NULL)
-          {
-          acData->Delete();
-          }
-        if (ctpData != NULL)
-          {
-          ctpData->Delete();
-          }
-        return;
-        }
-      valueFound = true;
-      }
-    else
-      {
-      // uniformFixedValue B.C.
-      const vtkFoamEntry *ufvEntry = bEntryI->Dictionary().Lookup("type");
-      if (ufvEntry != NULL)
-        {
-        if (ufvEntry->ToString() == "uniformFixedValue")
-          {
-          // the boundary is of uniformFixedValue type
-          vtkFoamEntry *uvEntry = bEntryI->Dictionary().Lookup("uniformValue");
-          if (uvEntry != NULL) // and has a uniformValue entry
-            {
-            vData = this->FillField(uvEntry, nFaces, &io, fieldType);
-            if (vData == NULL)
-              {
-              iData->Delete();
-              if (acData != NULL)
-                {
-                acData->Delete();
-                }
-              if (ctpData != NULL)
-                {
-                ctpData->Delete();
-                }
-              return;
-              }
-            valueFound = true;
-            }
-          }
-        }
-      }
-
     const int boundaryStartFace = beI.StartFace
         - this->BoundaryDict[0].StartFace;
 
-    if (!valueFound) // doesn't have a value nor uniformValue entry
+    vtkFloatArray *vData;
+    if (field.BoundaryFields[boundaryI] != NULL)
+      {
+      vData = vtkFloatArray::New();
+      vData->DeepCopy(field.BoundaryFields[boundaryI]);
+      }
+    else // doesn't have a value nor uniformValue entry
       {
       // use patch-internal values as boundary values
       vData = vtkFloatArray::New();
@@ -6954,7 +7417,7 @@ void vtkOpenFOAMReaderPrivate::GetVolFieldAtTimeStep(
       {
       vtkPolyData *bm =
           vtkPolyData::SafeDownCast(boundaryMesh->GetBlock(activeBoundaryI));
-      this->AddArrayToFieldData(bm->GetCellData(), vData, io.GetObjectName()
+      this->AddArrayToFieldData(bm->GetCellData(), vData, field.ObjectName
           + dimString);
 
       if (this->Parent->GetCreateCellToPoint())
@@ -6969,8 +7432,8 @@ void vtkOpenFOAMReaderPrivate::GetVolFieldAtTimeStep(
         const int nPoints = bm->GetPoints()->GetNumberOfPoints();
         pData->SetNumberOfTuples(nPoints);
         this->InterpolateCellToPoint(pData, vData, bm, NULL, nPoints);
-        this->AddArrayToFieldData(bm->GetPointData(), pData, io.GetObjectName()
-            + dimString);
+        this->AddArrayToFieldData(bm->GetPointData(), pData,
+            field.ObjectName + dimString);
         pData->Delete();
         }
 
@@ -7001,7 +7464,7 @@ void vtkOpenFOAMReaderPrivate::GetVolFieldAtTimeStep(
             pointI, bpData);
         }
       this->AddArrayToFieldData(internalMesh->GetPointData(), ctpData,
-          io.GetObjectName() + dimString);
+          field.ObjectName + dimString);
       ctpData->Delete();
       }
 
@@ -7013,50 +7476,13 @@ void vtkOpenFOAMReaderPrivate::GetVolFieldAtTimeStep(
 // read point field at a timestep
 void vtkOpenFOAMReaderPrivate::GetPointFieldAtTimeStep(
     vtkUnstructuredGrid *internalMesh, vtkMultiBlockDataSet *boundaryMesh,
-    const vtkStdString &varName)
+    const vtkFoamField &field)
 {
-  vtkFoamIOobject io(this->CasePath);
-  vtkFoamDict dict;
-  if (!this->ReadFieldFile(&io, &dict, varName,
-      this->Parent->PointDataArraySelection))
-    {
-    return;
-    }
-
-  if (io.GetClassName().substr(0, 5) != "point")
-    {
-    vtkErrorMacro(<< io.GetFileName().c_str() << " is not a pointField");
-    return;
-    }
-
-  vtkFoamEntry *iEntry = dict.Lookup("internalField");
-  if (iEntry == NULL)
-    {
-    vtkErrorMacro(<<"internalField not found in " << io.GetFileName().c_str());
-    return;
-    }
-
-  if (iEntry->FirstValue().GetType() == vtkFoamToken::EMPTYLIST)
-    {
-    // if there's no cell there shouldn't be any boundary faces either
-    if (this->NumPoints > 0)
-      {
-      vtkErrorMacro(<<"internalField of " << io.GetFileName().c_str()
-          << " is empty");
-      }
-    return;
-    }
-
-  vtkStdString fieldType = io.GetClassName().substr(5, vtkStdString::npos);
-  vtkFloatArray *iData = this->FillField(iEntry, this->NumPoints, &io,
-      fieldType);
-  if (iData == NULL)
-    {
-    return;
-    }
-
-  vtkStdString dimString;
-  this->ConstructDimensions(&dimString, &dict);
+  // the array of the field is shared with the field cache, so the
+  // output gets a copy that it may rename and extend
+  vtkFloatArray *iData = vtkFloatArray::New();
+  iData->DeepCopy(field.InternalField);
+  const vtkStdString &dimString = field.DimString;
 
   // AdditionalCellPoints is NULL if creation of InternalMesh had been skipped
   if (this->AdditionalCellPoints != NULL)
@@ -7094,24 +7520,15 @@ void vtkOpenFOAMReaderPrivate::GetPointFieldAtTimeStep(
       }
     }
 
-  if (iData->GetSize() > 0)
+  // Add field only if internal Mesh exists (skip if not selected).
+  // Note we still need to read internalField even if internal mesh is
+  // not selected, since boundaries without value entries may refer to
+  // the internalField.
+  if (internalMesh != NULL)
     {
-    // Add field only if internal Mesh exists (skip if not selected).
-    // Note we still need to read internalField even if internal mesh is
-    // not selected, since boundaries without value entries may refer to
-    // the internalField.
-    if (internalMesh != NULL)
-      {
-      // set data to internal mesh
-      this->AddArrayToFieldData(internalMesh->GetPointData(), iData,
-          io.GetObjectName() + dimString);
-      }
-    }
-  else
-    {
-    // determine as there's no points
-    iData->Delete();
-    return;
+    // set data to internal mesh
+    this->AddArrayToFieldData(internalMesh->GetPointData(), iData,
+        field.ObjectName + dimString);
     }
 
   // use patch-internal values as boundary values
@@ -7130,8 +7547,8 @@ void vtkOpenFOAMReaderPrivate::GetPointFieldAtTimeStep(
         vData->SetTuple(j, bpMap.GetValue(j), iData);
         }
       this->AddArrayToFieldData(vtkPolyData::SafeDownCast(
-          boundaryMesh->GetBlock(activeBoundaryI))->GetPointData(), vData, io.GetObjectName()
-          + dimString);
+          boundaryMesh->GetBlock(activeBoundaryI))->GetPointData(), vData,
+          field.ObjectName + dimString);
       vData->Delete();
       activeBoundaryI++;
       }
@@ -7927,20 +8344,39 @@ int vtkOpenFOAMReaderPrivate::RequestData(vtkMultiBlockDataSet *output,
           bm->GetPointData()->Initialize();
           }
         }
-      // read field data variables into Internal/Boundary meshes
+      // read field files concurrently
+      vtkstd::vector<vtkFoamFieldJob> fieldJobs;
       for (int i = 0; i < (int)this->VolFieldFiles->GetNumberOfValues(); i++)
         {
-        this->GetVolFieldAtTimeStep(this->InternalMesh, this->BoundaryMesh,
-            this->VolFieldFiles->GetValue(i));
-        this->Parent->UpdateProgress(0.5 + 0.25 * ((float)(i + 1)
-            / ((float)this->VolFieldFiles->GetNumberOfValues() + 0.0001)));
+        fieldJobs.push_back(vtkFoamFieldJob(this->VolFieldFiles->GetValue(i),
+            true, this->Parent->CellDataArraySelection));
         }
       for (int i = 0; i < (int)this->PointFieldFiles->GetNumberOfValues(); i++)
         {
-        this->GetPointFieldAtTimeStep(this->InternalMesh, this->BoundaryMesh,
-            this->PointFieldFiles->GetValue(i));
+        fieldJobs.push_back(vtkFoamFieldJob(this->PointFieldFiles->GetValue(i),
+            false, this->Parent->PointDataArraySelection));
+        }
+      this->ReadFieldsAtTimeStep(&fieldJobs);
+      this->Parent->UpdateProgress(0.75);
+
+      // set field data variables to Internal/Boundary meshes
+      for (size_t i = 0; i < fieldJobs.size(); i++)
+        {
+        if (fieldJobs[i].IsRead)
+          {
+          if (fieldJobs[i].IsVolField)
+            {
+            this->GetVolFieldAtTimeStep(this->InternalMesh,
+                this->BoundaryMesh, fieldJobs[i].Field);
+            }
+          else
+            {
+            this->GetPointFieldAtTimeStep(this->InternalMesh,
+                this->BoundaryMesh, fieldJobs[i].Field);
+            }
+          }
         this->Parent->UpdateProgress(0.75 + 0.125 * ((float)(i + 1)
-            / ((float)this->PointFieldFiles->GetNumberOfValues() + 0.0001)));
+            / ((float)fieldJobs.size() + 0.0001)));
         }
       }
     // read lagrangian mesh and fields
@@ -8068,6 +8504,15 @@ vtkOpenFOAMReader::vtkOpenFOAMReader()
   // for caching mesh
   this->CacheMesh = 1;
 
+  // for caching fields
+  this->FieldCacheSize = 0.0;
+  this->NumberOfPrefetchTimeSteps = 0;
+  this->FieldCache = new vtkFoamFieldCache;
+  this->FieldCacheHitCount = 0;
+
+  // for parsing fields
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
   // for decomposing polyhedra
   this->DecomposePolyhedra = 0;
   this->DecomposePolyhedraOld = 0;
@@ -8099,6 +8544,9 @@ vtkOpenFOAMReader::vtkOpenFOAMReader()
 // destructor
 vtkOpenFOAMReader::~vtkOpenFOAMReader()
 {
+  // stop the prefetch thread first since it refers to the readers
+  delete this->FieldCache;
+
   this->LagrangianPaths->Delete();
 
   this->PatchDataArraySelection->Delete();
@@ -8130,6 +8578,11 @@ void vtkOpenFOAMReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Refresh: " << this->Refresh << endl;
   os << indent << "CreateCellToPoint: " << this->CreateCellToPoint << endl;
   os << indent << "CacheMesh: " << this->CacheMesh << endl;
+  os << indent << "FieldCacheSize: " << this->FieldCacheSize << endl;
+  os << indent << "NumberOfPrefetchTimeSteps: "
+      << this->NumberOfPrefetchTimeSteps << endl;
+  os << indent << "FieldCacheHitCount: " << this->FieldCacheHitCount << endl;
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
   os << indent << "DecomposePolyhedra: " << this->DecomposePolyhedra << endl;
   os << indent << "PositionsIsIn13Format: " << this->PositionsIsIn13Format
       << endl;
@@ -8273,6 +8726,7 @@ int vtkOpenFOAMReader::RequestData(vtkInformation *vtkNotUsed(request), vtkInfor
 
   if (this->Parent == this)
     {
+    this->UpdateFieldCache();
     output->GetFieldData()->AddArray(this->CasePath);
     if (!this->MakeMetaDataAtTimeStep(false))
       {
@@ -8347,6 +8801,7 @@ int vtkOpenFOAMReader::RequestData(vtkInformation *vtkNotUsed(request), vtkInfor
 
   if (this->Parent == this) // update only if this is the top-level reader
     {
+    this->StartFieldPrefetch();
     this->UpdateStatus();
     }
 
@@ -8383,6 +8838,7 @@ int vtkOpenFOAMReader::MakeInformationVector(
   *this->FileNameOld = vtkStdString(this->FileName);
 
   // clear prior case information
+  this->Parent->FieldCache->Clear();
   this->Readers->RemoveAllItems();
 
   // recreate case information
@@ -8603,3 +9059,30 @@ void vtkOpenFOAMReader::UpdateProgress(double amount)
   this->vtkAlgorithm::UpdateProgress((static_cast<double>(this->Parent->CurrentReaderIndex)
       + amount) / static_cast<double>(this->Parent->NumberOfReaders));
 }
+
+//-----------------------------------------------------------------------------
+// stop prefetching and bring the field cache up to date with the
+// current settings before reading the fields
+void vtkOpenFOAMReader::UpdateFieldCache()
+{
+  this->FieldCache->StopPrefetch();
+  if (this->AddDimensionsToArrayNames != this->AddDimensionsToArrayNamesOld)
+    {
+    // the array names in the cache are no longer valid
+    this->FieldCache->Clear();
+    }
+  this->FieldCache->SetCapacity(this->FieldCacheSize);
+}
+
+//-----------------------------------------------------------------------------
+void vtkOpenFOAMReader::StartFieldPrefetch()
+{
+  if (this->NumberOfPrefetchTimeSteps > 0 && this->FieldCacheSize > 0.0)
+    {
+    this->FieldCache->StartPrefetch();
+    }
+  else
+    {
+    this->FieldCache->StopPrefetch();
+    }
+}
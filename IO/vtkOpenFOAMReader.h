@@ -47,6 +47,7 @@ class vtkDoubleArray;
 class vtkStdString;
 class vtkStringArray;
 
+class vtkFoamFieldCache;
 class vtkOpenFOAMReaderPrivate;
 
 class VTK_IO_EXPORT vtkOpenFOAMReader : public vtkMultiBlockDataSetAlgorithm
@@ -187,6 +188,34 @@ public:
   vtkGetMacro(CacheMesh, int);
   vtkBooleanMacro(CacheMesh, int);
 
+  // Description:
+  // Set/Get the size in MiB of the cache that keeps the field arrays
+  // read at earlier timesteps, so that revisiting a timestep doesn't
+  // parse the field files again. The least recently used arrays are
+  // discarded first. Defaults to 0, which disables caching.
+  vtkSetClampMacro(FieldCacheSize, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(FieldCacheSize, double);
+
+  // Description:
+  // Set/Get the number of timesteps before and after the current one
+  // whose fields are read into the field cache by a background thread
+  // after each update. Has no effect unless FieldCacheSize is set.
+  // Defaults to 0 (no prefetching).
+  vtkSetClampMacro(NumberOfPrefetchTimeSteps, int, 0, VTK_LARGE_INTEGER);
+  vtkGetMacro(NumberOfPrefetchTimeSteps, int);
+
+  // Description:
+  // Get the number of fields that were taken from the field cache
+  // instead of being read from their files, since the reader was created.
+  vtkGetMacro(FieldCacheHitCount, unsigned long);
+
+  // Description:
+  // Set/Get the number of threads that parse the field files of a
+  // mesh region concurrently. Defaults to the global default number of
+  // threads of vtkMultiThreader.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
   // Description:
   // Set/Get whether polyhedra are to be decomposed.
   vtkSetMacro(DecomposePolyhedra, int);
@@ -240,6 +269,15 @@ protected:
   // for caching mesh
   int CacheMesh;
 
+  // for caching fields across timesteps
+  double FieldCacheSize;
+  int NumberOfPrefetchTimeSteps;
+  vtkFoamFieldCache *FieldCache;
+  unsigned long FieldCacheHitCount;
+
+  // for parsing field files concurrently
+  int NumberOfThreads;
+
   // for decomposing polyhedra on-the-fly
   int DecomposePolyhedra;
 
@@ -300,6 +338,8 @@ protected:
   void CreateCharArrayFromString(vtkCharArray *, const char *, vtkStdString &);
   void UpdateStatus();
   void UpdateProgress(double);
+  void UpdateFieldCache();
+  void StartFieldPrefetch();
 
 private:
   vtkOpenFOAMReader *Parent;
@@ -14,18 +14,23 @@
 =========================================================================*/
 #include "vtkPLYReader.h"
 
+#include "vtkByteSwap.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkPointData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPLY.h"
 #include "vtkPolyData.h"
+#include "vtkUnsignedCharArray.h"
 
 #include <ctype.h>
 #include <stddef.h>
+#include <vtkstd/vector>
 
 vtkStandardNewMacro(vtkPLYReader);
 
@@ -62,6 +67,462 @@ typedef struct _plyFace {
   int *verts;             // vertex index list
 } plyFace;
 
+// Number of vertices decoded at once, and number of bytes of faces read
+// from the file at once, by the bulk binary path.
+#define VTK_PLY_VERTICES_PER_BLOCK 65536
+#define VTK_PLY_FACE_BYTES_PER_BLOCK 4194304
+
+// Size in bytes of the PLY property types, indexed by type.
+static const int vtkPLYReaderTypeSize[] = {
+  0, 1, 2, 4, 4, 1, 2, 4, 1, 4, 4, 8
+};
+
+// Layout of the binary vertex and face records decoded by the bulk path.
+// The face records are made of fixed size scalars before the index list
+// (FaceBefore bytes), a one byte count, the 4 byte indices and the fixed
+// size scalars after the list (FaceAfter bytes).  The scalar offsets of
+// the face are taken in the scalars only, as if the list was not there.
+struct vtkPLYReaderLayout
+{
+  int BigEndian;
+  int VertexSize;
+  int VertexOffset[6];   // x, y, z, red, green, blue
+  int FaceBefore;
+  int FaceAfter;
+  int FaceOffset[4];     // intensity, red, green, blue
+};
+
+// The work shared by the threads that decode a block of vertices or
+// faces.  Each thread decodes a contiguous range of the records.
+struct vtkPLYReaderThreadStruct
+{
+  const vtkPLYReaderLayout *Layout;
+  const char *Buffer;
+  vtkIdType NumberOfRecords;
+  vtkIdType FirstRecord;
+
+  // vertices
+  float *Points;
+  unsigned char *RGBPoints;
+
+  // faces, with the offsets of the records in the buffer and of the
+  // cells in the connectivity
+  const size_t *RecordOffsets;
+  const vtkIdType *CellOffsets;
+  vtkIdType *Cells;
+  unsigned char *Intensity;
+  unsigned char *RGBCells;
+};
+
+//----------------------------------------------------------------------------
+static inline void vtkPLYReaderSwap4(void *p, int bigEndian)
+{
+  if (bigEndian)
+    {
+    vtkByteSwap::Swap4BE(p);
+    }
+  else
+    {
+    vtkByteSwap::Swap4LE(p);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Find the byte offset of a fixed size property of an element.  Returns
+// -1 if the property is missing, or when one of the given types is
+// required and the property has another one.
+static int vtkPLYReaderFindOffset(PlyElement *elem, const char *name,
+                                  int type1, int type2)
+{
+  int offset = 0;
+  for (int i = 0; i < elem->nprops; i++)
+    {
+    PlyProperty *prop = elem->props[i];
+    if (prop->is_list)
+      {
+      continue;
+      }
+    if (!strcmp(prop->name, name))
+      {
+      if (type1 && prop->external_type != type1 &&
+          prop->external_type != type2)
+        {
+        return -1;
+        }
+      return offset;
+      }
+    offset += vtkPLYReaderTypeSize[prop->external_type];
+    }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+// Check whether the file has the common binary layout that the bulk path
+// decodes: the vertices come first, with float coordinates and unsigned
+// char colors, followed by the faces, with a single list of int indices
+// counted by an unsigned char and unsigned char attributes.  Any other
+// fixed size property is skipped, as the generic path does.
+static int vtkPLYReaderGetLayout(PlyFile *ply, int RGBPoints, int intensity,
+                                 int RGBCells, vtkPLYReaderLayout *layout)
+{
+  if ((ply->file_type != PLY_BINARY_LE && ply->file_type != PLY_BINARY_BE) ||
+      ply->nelems < 2 ||
+      strcmp(ply->elems[0]->name, "vertex") ||
+      strcmp(ply->elems[1]->name, "face"))
+    {
+    return 0;
+    }
+  layout->BigEndian = (ply->file_type == PLY_BINARY_BE);
+
+  int i;
+  PlyElement *elem = ply->elems[0];
+  layout->VertexSize = 0;
+  for (i = 0; i < elem->nprops; i++)
+    {
+    PlyProperty *prop = elem->props[i];
+    if (prop->is_list || prop->external_type <= PLY_START_TYPE ||
+        prop->external_type >= PLY_END_TYPE)
+      {
+      return 0;
+      }
+    layout->VertexSize += vtkPLYReaderTypeSize[prop->external_type];
+    }
+  const char *vertexNames[] = {"x", "y", "z", "red", "green", "blue"};
+  for (i = 0; i < 6; i++)
+    {
+    if (i >= 3 && !RGBPoints)
+      {
+      layout->VertexOffset[i] = -1;
+      continue;
+      }
+    layout->VertexOffset[i] = (i < 3) ?
+      vtkPLYReaderFindOffset(elem, vertexNames[i], PLY_FLOAT, PLY_FLOAT32) :
+      vtkPLYReaderFindOffset(elem, vertexNames[i], PLY_UCHAR, PLY_UINT8);
+    if (layout->VertexOffset[i] < 0)
+      {
+      return 0;
+      }
+    }
+
+  elem = ply->elems[1];
+  int numLists = 0;
+  layout->FaceBefore = layout->FaceAfter = 0;
+  for (i = 0; i < elem->nprops; i++)
+    {
+    PlyProperty *prop = elem->props[i];
+    if (prop->external_type <= PLY_START_TYPE ||
+        prop->external_type >= PLY_END_TYPE)
+      {
+      return 0;
+      }
+    if (prop->is_list)
+      {
+      if (numLists++ || strcmp(prop->name, "vertex_indices") ||
+          (prop->count_external != PLY_UCHAR &&
+           prop->count_external != PLY_UINT8) ||
+          vtkPLYReaderTypeSize[prop->external_type] != 4 ||
+          prop->external_type == PLY_FLOAT ||
+          prop->external_type == PLY_FLOAT32)
+        {
+        return 0;
+        }
+      }
+    else if (numLists)
+      {
+      layout->FaceAfter += vtkPLYReaderTypeSize[prop->external_type];
+      }
+    else
+      {
+      layout->FaceBefore += vtkPLYReaderTypeSize[prop->external_type];
+      }
+    }
+  if (!numLists)
+    {
+    return 0;
+    }
+  const char *faceNames[] = {"intensity", "red", "green", "blue"};
+  for (i = 0; i < 4; i++)
+    {
+    if ((i == 0 && !intensity) || (i > 0 && !RGBCells))
+      {
+      layout->FaceOffset[i] = -1;
+      continue;
+      }
+    layout->FaceOffset[i] =
+      vtkPLYReaderFindOffset(elem, faceNames[i], PLY_UCHAR, PLY_UINT8);
+    if (layout->FaceOffset[i] < 0)
+      {
+      return 0;
+      }
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Decode a range of the vertices of a block into points and colors.
+static VTK_THREAD_RETURN_TYPE vtkPLYReaderDecodeVertices(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info = 
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkPLYReaderThreadStruct *str = 
+    static_cast<vtkPLYReaderThreadStruct *>(info->UserData);
+  const vtkPLYReaderLayout *layout = str->Layout;
+
+  vtkIdType begin = str->NumberOfRecords*info->ThreadID/info->NumberOfThreads;
+  vtkIdType end = 
+    str->NumberOfRecords*(info->ThreadID + 1)/info->NumberOfThreads;
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    const char *record = str->Buffer + i*layout->VertexSize;
+    vtkIdType id = str->FirstRecord + i;
+    float *x = str->Points + 3*id;
+    for (int j = 0; j < 3; j++)
+      {
+      // the records are not aligned, so copy them before swapping
+      memcpy(x + j, record + layout->VertexOffset[j], sizeof(float));
+      vtkPLYReaderSwap4(x + j, layout->BigEndian);
+      }
+    if (str->RGBPoints)
+      {
+      unsigned char *rgb = str->RGBPoints + 3*id;
+      rgb[0] = static_cast<unsigned char>(record[layout->VertexOffset[3]]);
+      rgb[1] = static_cast<unsigned char>(record[layout->VertexOffset[4]]);
+      rgb[2] = static_cast<unsigned char>(record[layout->VertexOffset[5]]);
+      }
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Decode a range of the faces of a block into cells and cell attributes.
+static VTK_THREAD_RETURN_TYPE vtkPLYReaderDecodeFaces(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info = 
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkPLYReaderThreadStruct *str = 
+    static_cast<vtkPLYReaderThreadStruct *>(info->UserData);
+  const vtkPLYReaderLayout *layout = str->Layout;
+
+  vtkIdType begin = str->NumberOfRecords*info->ThreadID/info->NumberOfThreads;
+  vtkIdType end = 
+    str->NumberOfRecords*(info->ThreadID + 1)/info->NumberOfThreads;
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    const char *record = str->Buffer + str->RecordOffsets[i];
+    const char *list = record + layout->FaceBefore;
+    int npts = static_cast<unsigned char>(list[0]);
+    vtkIdType *cell = str->Cells + str->CellOffsets[i];
+    cell[0] = npts;
+    for (int j = 0; j < npts; j++)
+      {
+      int ptId;
+      memcpy(&ptId, list + 1 + 4*j, sizeof(int));
+      vtkPLYReaderSwap4(&ptId, layout->BigEndian);
+      cell[j + 1] = ptId;
+      }
+
+    // attributes after the list are shifted by the list
+    unsigned char attr[4];
+    for (int j = 0; j < 4; j++)
+      {
+      int offset = layout->FaceOffset[j];
+      if (offset >= layout->FaceBefore)
+        {
+        offset += 1 + 4*npts;
+        }
+      attr[j] = (offset < 0) ? 0 : static_cast<unsigned char>(record[offset]);
+      }
+    vtkIdType id = str->FirstRecord + i;
+    if (str->Intensity)
+      {
+      str->Intensity[id] = attr[0];
+      }
+    if (str->RGBCells)
+      {
+      str->RGBCells[3*id] = attr[1];
+      str->RGBCells[3*id + 1] = attr[2];
+      str->RGBCells[3*id + 2] = attr[3];
+      }
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Read the vertices and the faces of a binary file with the common layout
+// in blocks, decoding each block with several threads straight into the
+// output arrays.  Returns 0 without reading anything when the layout is
+// not supported, in which case the generic path is used.
+static int vtkPLYReaderReadBulk(vtkPLYReader *self, PlyFile *ply,
+                                vtkPolyData *output,
+                                vtkUnsignedCharArray *intensity,
+                                vtkUnsignedCharArray *RGBCells,
+                                vtkUnsignedCharArray *RGBPoints)
+{
+  vtkPLYReaderLayout layout;
+  if (!vtkPLYReaderGetLayout(ply, RGBPoints != NULL, intensity != NULL,
+                             RGBCells != NULL, &layout))
+    {
+    return 0;
+    }
+
+  FILE *fp = ply->fp;
+  vtkIdType numPts = ply->elems[0]->num;
+  vtkIdType numPolys = ply->elems[1]->num;
+  double total = static_cast<double>(numPts) + numPolys;
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  vtkPLYReaderThreadStruct str;
+  str.Layout = &layout;
+
+  // The vertices have a fixed size
+  vtkPoints *pts = vtkPoints::New();
+  pts->SetDataTypeToFloat();
+  pts->SetNumberOfPoints(numPts);
+  str.Points = static_cast<float *>(pts->GetVoidPointer(0));
+  str.RGBPoints = NULL;
+  if (RGBPoints)
+    {
+    RGBPoints->SetNumberOfComponents(3);
+    RGBPoints->SetNumberOfTuples(numPts);
+    str.RGBPoints = RGBPoints->GetPointer(0);
+    }
+
+  vtkstd::vector<char> buffer(
+    static_cast<size_t>(VTK_PLY_VERTICES_PER_BLOCK)*layout.VertexSize);
+  vtkIdType numRead = 0;
+  while (numRead < numPts)
+    {
+    vtkIdType numBlock = numPts - numRead;
+    numBlock = (numBlock < VTK_PLY_VERTICES_PER_BLOCK) ? 
+      numBlock : VTK_PLY_VERTICES_PER_BLOCK;
+    size_t size = fread(&buffer[0], 1, numBlock*layout.VertexSize, fp);
+    numBlock = static_cast<vtkIdType>(size/layout.VertexSize);
+    if (numBlock <= 0)
+      {
+      break;
+      }
+
+    str.Buffer = &buffer[0];
+    str.NumberOfRecords = numBlock;
+    str.FirstRecord = numRead;
+    threader->SetSingleMethod(vtkPLYReaderDecodeVertices, &str);
+    threader->SingleMethodExecute();
+    numRead += numBlock;
+    self->UpdateProgress(numRead/total);
+    }
+  if (numRead < numPts)
+    {
+    vtkWarningWithObjectMacro(self, << "Read only " << numRead << " of "
+                              << numPts << " vertices");
+    pts->SetNumberOfPoints(numRead);
+    if (RGBPoints)
+      {
+      RGBPoints->SetNumberOfTuples(numRead);
+      }
+    numPts = numRead;
+    numPolys = 0;
+    }
+  output->SetPoints(pts);
+  pts->Delete();
+
+  // The faces have a variable size: find where each face of a block
+  // starts, then decode the faces of the block in parallel.  A face that
+  // does not fit at the end of the buffer is moved to the next block.
+  vtkIdTypeArray *cells = vtkIdTypeArray::New();
+  cells->Allocate(4*numPolys);
+  str.Intensity = NULL;
+  str.RGBCells = NULL;
+  if (intensity)
+    {
+    intensity->SetNumberOfComponents(1);
+    intensity->SetNumberOfTuples(numPolys);
+    str.Intensity = intensity->GetPointer(0);
+    }
+  if (RGBCells)
+    {
+    RGBCells->SetNumberOfComponents(3);
+    RGBCells->SetNumberOfTuples(numPolys);
+    str.RGBCells = RGBCells->GetPointer(0);
+    }
+
+  buffer.resize(VTK_PLY_FACE_BYTES_PER_BLOCK);
+  vtkstd::vector<size_t> recordOffsets;
+  vtkstd::vector<vtkIdType> cellOffsets;
+  size_t fixedSize = layout.FaceBefore + 1 + layout.FaceAfter;
+  size_t used = 0;
+  vtkIdType connSize = 0;
+  numRead = 0;
+  while (numRead < numPolys)
+    {
+    size_t size = used + fread(&buffer[used], 1, buffer.size() - used, fp);
+
+    recordOffsets.clear();
+    cellOffsets.clear();
+    size_t pos = 0;
+    vtkIdType blockConnSize = 0;
+    while (numRead + static_cast<vtkIdType>(recordOffsets.size()) < numPolys &&
+           pos + fixedSize <= size)
+      {
+      int npts = static_cast<unsigned char>(buffer[pos + layout.FaceBefore]);
+      size_t recordSize = fixedSize + 4*npts;
+      if (pos + recordSize > size)
+        {
+        break;
+        }
+      recordOffsets.push_back(pos);
+      cellOffsets.push_back(connSize + blockConnSize);
+      blockConnSize += npts + 1;
+      pos += recordSize;
+      }
+    vtkIdType numBlock = static_cast<vtkIdType>(recordOffsets.size());
+    if (numBlock <= 0)
+      {
+      break;
+      }
+
+    str.Buffer = &buffer[0];
+    str.NumberOfRecords = numBlock;
+    str.FirstRecord = numRead;
+    str.RecordOffsets = &recordOffsets[0];
+    str.CellOffsets = &cellOffsets[0];
+    str.Cells = cells->WritePointer(0, connSize + blockConnSize);
+    threader->SetSingleMethod(vtkPLYReaderDecodeFaces, &str);
+    threader->SingleMethodExecute();
+    numRead += numBlock;
+    connSize += blockConnSize;
+    self->UpdateProgress((numPts + numRead)/total);
+
+    used = size - pos;
+    memmove(&buffer[0], &buffer[pos], used);
+    }
+  threader->Delete();
+
+  if (numRead < numPolys)
+    {
+    vtkWarningWithObjectMacro(self, << "Read only " << numRead << " of "
+                              << numPolys << " faces");
+    if (intensity)
+      {
+      intensity->SetNumberOfTuples(numRead);
+      }
+    if (RGBCells)
+      {
+      RGBCells->SetNumberOfTuples(numRead);
+      }
+    }
+  vtkCellArray *polys = vtkCellArray::New();
+  cells->SetNumberOfValues(connSize);
+  polys->SetCells(numRead, cells);
+  cells->Delete();
+  output->SetPolys(polys);
+  polys->Delete();
+
+  return 1;
+}
+
 int vtkPLYReader::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **vtkNotUsed(inputVector),
@@ -130,6 +591,7 @@ int vtkPLYReader::RequestData(
     {
     vtkErrorMacro(<<"Cannot read geometry");
     vtkPLY::ply_close (ply);
+    return 0;
     }
 
   // Check for optional attribute data. We can handle intensity; and the
@@ -174,6 +636,16 @@ int vtkPLYReader::RequestData(
     RGBPoints->Delete();
     }
 
+  // Binary files with the common layout are decoded in bulk; any other
+  // file is read one element at a time
+  int bulk = vtkPLYReaderReadBulk(this, ply, output, intensity, RGBCells,
+                                  RGBPoints);
+  if ( bulk )
+    {
+    numPts = output->GetNumberOfPoints();
+    numPolys = output->GetNumberOfPolys();
+    }
+
   // Okay, now we can grab the data
   for (i = 0; i < nelems; i++) 
     {
@@ -182,7 +654,7 @@ int vtkPLYReader::RequestData(
     vtkPLY::ply_get_element_description (ply, elemName, &numElems, &nprops);
 
     // if we're on vertex elements, read them in
-    if ( elemName && !strcmp ("vertex", elemName) ) 
+    if ( !bulk && elemName && !strcmp ("vertex", elemName) ) 
       {
       // Create a list of points
       numPts = numElems;
@@ -217,7 +689,7 @@ int vtkPLYReader::RequestData(
       pts->Delete();
       }//if vertex
 
-    else if ( elemName && !strcmp ("face", elemName) ) 
+    else if ( !bulk && elemName && !strcmp ("face", elemName) ) 
       {
       // Create a polygonal array
       numPolys = numElems;
@@ -232,8 +704,8 @@ int vtkPLYReader::RequestData(
       if ( intensityAvailable )
         {
         vtkPLY::ply_get_property (ply, elemName, &faceProps[1]);
-        RGBCells->SetNumberOfComponents(1);
-        RGBCells->SetNumberOfTuples(numPolys);
+        intensity->SetNumberOfComponents(1);
+        intensity->SetNumberOfTuples(numPolys);
         }
       if ( RGBCellsAvailable )
         {
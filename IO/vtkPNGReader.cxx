@@ -151,23 +151,69 @@ void vtkPNGReader::ExecuteInformation()
 
 
 //----------------------------------------------------------------------------
+// A PNG file that was read into memory ahead of time.
+struct vtkPNGReaderMemoryFile
+{
+  const char *Buffer;
+  unsigned long Length;
+  unsigned long Position;
+};
+
+extern "C" {
+static void vtkPNGReaderReadMemoryFile(png_structp png_ptr, png_bytep data,
+                                       png_size_t length)
+{
+  vtkPNGReaderMemoryFile *file =
+    static_cast<vtkPNGReaderMemoryFile *>(png_get_io_ptr(png_ptr));
+  if (length > file->Length - file->Position)
+    {
+    png_error(png_ptr, "Read past the end of the file");
+    }
+  memcpy(data, file->Buffer + file->Position, length);
+  file->Position += static_cast<unsigned long>(length);
+}
+}
+
+//----------------------------------------------------------------------------
+// Read one PNG file, from the given buffer if the file was read into
+// memory ahead of time.
 template <class OT>
-void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
-                         int *outExt, vtkIdType *outInc, long pixSize)
+void vtkPNGReaderUpdate2(const char *fileName, OT *outPtr,
+                         int *outExt, vtkIdType *outInc, long pixSize,
+                         const char *buffer, unsigned long length)
 {
   unsigned int ui;
   int i;
-  FILE *fp = fopen(self->GetInternalFileName(), "rb");
-  if (!fp)
+  FILE *fp = NULL;
+  vtkPNGReaderMemoryFile file;
+  unsigned char header[8];
+  if (buffer)
     {
-    return;
+    if (length < 8)
+      {
+      return;
+      }
+    memcpy(header, buffer, 8);
+    file.Buffer = buffer;
+    file.Length = length;
+    file.Position = 8;
+    }
+  else
+    {
+    fp = fopen(fileName, "rb");
+    if (!fp)
+      {
+      return;
+      }
+    fread(header, 1, 8, fp);
     }
-  unsigned char header[8];
-  fread(header, 1, 8, fp);
   int is_png = !png_sig_cmp(header, 0, 8);
   if (!is_png)
     {
-    fclose(fp);
+    if (fp)
+      {
+      fclose(fp);
+      }
     return;
     }
 
@@ -201,7 +247,14 @@ void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
     return;
   }
 
-  png_init_io(png_ptr, fp);
+  if (fp)
+    {
+    png_init_io(png_ptr, fp);
+    }
+  else
+    {
+    png_set_read_fn(png_ptr, &file, vtkPNGReaderReadMemoryFile);
+    }
   png_set_sig_bytes(png_ptr, 8);
   png_read_info(png_ptr, info_ptr);
 
@@ -269,38 +322,37 @@ void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
   // close the file
   png_read_end(png_ptr, NULL);
   png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
-  fclose(fp);
+  if (fp)
+    {
+    fclose(fp);
+    }
 }
 
 //----------------------------------------------------------------------------
-// This function reads in one data of data.
-// templated to handle different data types.
-template <class OT>
-void vtkPNGReaderUpdate(vtkPNGReader *self, vtkImageData *data, OT *outPtr)
+// The output of the slices decoded by vtkPNGReaderDecodeSlice.
+struct vtkPNGReaderSlices
 {
-  vtkIdType outIncr[3];
-  int outExtent[6];
-  OT *outPtr2;
-
-  data->GetExtent(outExtent);
-  data->GetIncrements(outIncr);
+  void *OutPtr;
+  int *OutExt;
+  vtkIdType *OutInc;
+  long PixSize;
+};
 
-  long pixSize = data->GetNumberOfScalarComponents()*sizeof(OT);  
-  
-  outPtr2 = outPtr;
-  int idx2;
-  for (idx2 = outExtent[4]; idx2 <= outExtent[5]; ++idx2)
-    {
-    self->ComputeInternalFileName(idx2);
-    // read in a PNG file
-    vtkPNGReaderUpdate2(self, outPtr2, outExtent, outIncr, pixSize);
-    self->UpdateProgress((idx2 - outExtent[4])/
-                         (outExtent[5] - outExtent[4] + 1.0));
-    outPtr2 += outIncr[2];
-    }
+//----------------------------------------------------------------------------
+// Decode the file of one slice into its place in the output.  The slices
+// are independent, so this runs on several threads at once.
+template <class OT>
+void vtkPNGReaderDecodeSlice(vtkImageReader2 *, int, int slice,
+                             const char *fileName, const char *buffer,
+                             unsigned long length, void *userData)
+{
+  vtkPNGReaderSlices *slices = static_cast<vtkPNGReaderSlices *>(userData);
+  OT *outPtr = static_cast<OT *>(slices->OutPtr) +
+    (slice - slices->OutExt[4])*slices->OutInc[2];
+  vtkPNGReaderUpdate2(fileName, outPtr, slices->OutExt, slices->OutInc,
+                      slices->PixSize, buffer, length);
 }
 
-
 //----------------------------------------------------------------------------
 // This function reads a data from a file.  The datas extent/axes
 // are assumed to be the same as the file extent/order.
@@ -318,17 +370,27 @@ void vtkPNGReader::ExecuteData(vtkDataObject *output)
 
   this->ComputeDataIncrements();
   
-  // Call the correct templated function for the output
-  void *outPtr;
-
-  // Call the correct templated function for the input
-  outPtr = data->GetScalarPointer();
+  // Select the decoder of the output type
+  DecodeSliceFunction decode = NULL;
   switch (data->GetScalarType())
     {
-    vtkTemplateMacro(vtkPNGReaderUpdate(this, data, (VTK_TT *)(outPtr)));
+    vtkTemplateMacro(decode = vtkPNGReaderDecodeSlice<VTK_TT>);
     default:
       vtkErrorMacro(<< "UpdateFromFile: Unknown data type");
-    }   
+      return;
+    }
+
+  int outExtent[6];
+  data->GetExtent(outExtent);
+  vtkPNGReaderSlices slices;
+  slices.OutPtr = data->GetScalarPointer();
+  slices.OutExt = outExtent;
+  slices.OutInc = data->GetIncrements();
+  slices.PixSize =
+    data->GetNumberOfScalarComponents()*data->GetScalarSize();
+
+  // read in the PNG files
+  this->DecodeSlices(outExtent[4], outExtent[5], decode, &slices);
 }
 
 
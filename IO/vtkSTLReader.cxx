@@ -19,7 +19,9 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMergePoints.h"
+#include "vtkMultiThreader.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkPolyData.h"
@@ -29,12 +31,152 @@
 
 #include <ctype.h>
 #include <vtksys/SystemTools.hxx>
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
 
 vtkStandardNewMacro(vtkSTLReader);
 
 #define VTK_ASCII 0
 #define VTK_BINARY 1
 
+// Size of a binary facet: normal, three vertices and attribute count.
+#define VTK_STL_FACET_SIZE 50
+
+// Number of binary facets read from the file at once.
+#define VTK_STL_FACETS_PER_BLOCK 65536
+
+// Number of buckets of each pass of the radix sort of the points.
+#define VTK_STL_RADIX_BITS 16
+#define VTK_STL_RADIX_SIZE 65536
+
+// A point and its id, sorted to find the identical points.  The
+// coordinates are stored as unsigned keys that sort like the floats.
+struct vtkSTLReaderSortPoint
+{
+  unsigned int Key[3];
+  vtkIdType Id;
+};
+
+// The work shared by the threads that decode binary facets or sort
+// points.  Each thread works on a contiguous range of the items.
+struct vtkSTLReaderThreadStruct
+{
+  // decoding
+  const char *Buffer;
+  vtkIdType NumberOfFacets;
+  vtkIdType FirstFacet;
+  float *Points;
+  vtkIdType *Cells;
+
+  // sorting, one digit of one key at a time
+  vtkSTLReaderSortPoint *Source;
+  vtkSTLReaderSortPoint *Target;
+  vtkIdType NumberOfPoints;
+  vtkIdType *Counts;
+  int Key;
+  int Shift;
+};
+
+//----------------------------------------------------------------------------
+// Decode a range of the facets of a block into points and triangles.
+static VTK_THREAD_RETURN_TYPE vtkSTLReaderDecodeFacets(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info = 
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkSTLReaderThreadStruct *str = 
+    static_cast<vtkSTLReaderThreadStruct *>(info->UserData);
+
+  vtkIdType begin = str->NumberOfFacets*info->ThreadID/info->NumberOfThreads;
+  vtkIdType end = 
+    str->NumberOfFacets*(info->ThreadID + 1)/info->NumberOfThreads;
+  float facet[12];
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    // the facets are not aligned, so copy them before swapping
+    memcpy(facet, str->Buffer + i*VTK_STL_FACET_SIZE, 48);
+    vtkByteSwap::Swap4LERange(facet, 12);
+
+    // skip the normal
+    vtkIdType facetId = str->FirstFacet + i;
+    memcpy(str->Points + 9*facetId, facet + 3, 9*sizeof(float));
+
+    vtkIdType *cell = str->Cells + 4*facetId;
+    cell[0] = 3;
+    cell[1] = 3*facetId;
+    cell[2] = 3*facetId + 1;
+    cell[3] = 3*facetId + 2;
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Count the digits of the points of one thread.
+static VTK_THREAD_RETURN_TYPE vtkSTLReaderCountDigits(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info = 
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkSTLReaderThreadStruct *str = 
+    static_cast<vtkSTLReaderThreadStruct *>(info->UserData);
+
+  vtkIdType begin = str->NumberOfPoints*info->ThreadID/info->NumberOfThreads;
+  vtkIdType end = 
+    str->NumberOfPoints*(info->ThreadID + 1)/info->NumberOfThreads;
+  vtkIdType *counts = str->Counts + info->ThreadID*VTK_STL_RADIX_SIZE;
+  memset(counts, 0, VTK_STL_RADIX_SIZE*sizeof(vtkIdType));
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    counts[(str->Source[i].Key[str->Key] >> str->Shift) & 
+           (VTK_STL_RADIX_SIZE - 1)]++;
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Move the points of one thread to their bucket, given the position of
+// the first point of each bucket for this thread.
+static VTK_THREAD_RETURN_TYPE vtkSTLReaderScatterDigits(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info = 
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkSTLReaderThreadStruct *str = 
+    static_cast<vtkSTLReaderThreadStruct *>(info->UserData);
+
+  vtkIdType begin = str->NumberOfPoints*info->ThreadID/info->NumberOfThreads;
+  vtkIdType end = 
+    str->NumberOfPoints*(info->ThreadID + 1)/info->NumberOfThreads;
+  vtkIdType *offsets = str->Counts + info->ThreadID*VTK_STL_RADIX_SIZE;
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    int digit = (str->Source[i].Key[str->Key] >> str->Shift) & 
+      (VTK_STL_RADIX_SIZE - 1);
+    str->Target[offsets[digit]++] = str->Source[i];
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Return an unsigned key that sorts like the float, with both zeros equal.
+static inline unsigned int vtkSTLReaderFloatKey(float x)
+{
+  unsigned int key;
+  x = (x == 0.0f) ? 0.0f : x;
+  memcpy(&key, &x, sizeof(key));
+  return (key & 0x80000000u) ? ~key : (key | 0x80000000u);
+}
+
+//----------------------------------------------------------------------------
+// Test the bits of the float for NaN, which unlike a comparison does not
+// raise a floating-point exception.
+static inline int vtkSTLReaderIsNan(float x)
+{
+  unsigned int bits;
+  memcpy(&bits, &x, sizeof(bits));
+  return (bits & 0x7fffffffu) > 0x7f800000u;
+}
+
 vtkCxxSetObjectMacro(vtkSTLReader,Locator,vtkIncrementalPointLocator);
 
 // Construct object with merging set to true.
@@ -148,13 +290,6 @@ int vtkSTLReader::RequestData(
   //
   if ( this->Merging )
     {
-    int i;
-    vtkIdType *pts = 0;
-    vtkIdType nodes[3];
-    vtkIdType npts;
-    double x[3];
-    int nextCell=0;
-
     mergedPts = vtkPoints::New();
     mergedPts->Allocate(newPts->GetNumberOfPoints()/2);
     mergedPolys = vtkCellArray::New();
@@ -167,29 +302,40 @@ int vtkSTLReader::RequestData(
 
     if ( this->Locator == NULL )
       {
-      this->CreateDefaultLocator();
+      this->MergeSortedPoints(newPts, newPolys, newScalars,
+                              mergedPts, mergedPolys, mergedScalars);
       }
-    this->Locator->InitPointInsertion (mergedPts, newPts->GetBounds());
-
-    for (newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); )
+    else
       {
-      for (i=0; i < 3; i++)
-        {
-        newPts->GetPoint(pts[i],x);
-        this->Locator->InsertUniquePoint(x, nodes[i]);
-        }
+      int i;
+      vtkIdType *pts = 0;
+      vtkIdType nodes[3];
+      vtkIdType npts;
+      double x[3];
+      int nextCell=0;
+
+      this->Locator->InitPointInsertion (mergedPts, newPts->GetBounds());
 
-      if ( nodes[0] != nodes[1] &&
-           nodes[0] != nodes[2] &&
-           nodes[1] != nodes[2] )
+      for (newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); )
         {
-        mergedPolys->InsertNextCell(3,nodes);
-        if (newScalars)
+        for (i=0; i < 3; i++)
+          {
+          newPts->GetPoint(pts[i],x);
+          this->Locator->InsertUniquePoint(x, nodes[i]);
+          }
+
+        if ( nodes[0] != nodes[1] &&
+             nodes[0] != nodes[2] &&
+             nodes[1] != nodes[2] )
           {
-          mergedScalars->InsertNextValue(newScalars->GetValue(nextCell));
+          mergedPolys->InsertNextCell(3,nodes);
+          if (newScalars)
+            {
+            mergedScalars->InsertNextValue(newScalars->GetValue(nextCell));
+            }
           }
+        nextCell++;
         }
-      nextCell++;
       }
 
     newPts->Delete();
@@ -238,13 +384,9 @@ int vtkSTLReader::RequestData(
 int vtkSTLReader::ReadBinarySTL(FILE *fp, vtkPoints *newPts,
                                 vtkCellArray *newPolys)
 {
-  int i, numTris;
-  vtkIdType pts[3];
-  unsigned long   ulint;
-  unsigned short  ibuff2;
+  int numTris;
+  unsigned long   ulint = 0;
   char    header[81];
-  typedef struct  {float  n[3], v1[3], v2[3], v3[3];} facet_t;
-  facet_t facet;
 
   vtkDebugMacro(<< " Reading BINARY STL file");
 
@@ -254,8 +396,8 @@ int vtkSTLReader::ReadBinarySTL(FILE *fp, vtkPoints *newPts,
   fread (&ulint, 1, 4, fp);
   vtkByteSwap::Swap4LE(&ulint);
 
-  // Many .stl files contain bogus count.  Hence we will ignore and read 
-  //   until end of file.
+  // Many .stl files contain bogus count.  Hence we will ignore it and
+  //   read until end of file.
   //
   if ( (numTris = (int) ulint) <= 0 )
     {
@@ -263,39 +405,206 @@ int vtkSTLReader::ReadBinarySTL(FILE *fp, vtkPoints *newPts,
     << numTris << ")");
     }
 
-  for ( i=0; fread(&facet,48,1,fp) > 0; i++ )
+  // The last facet may lack its attribute count
+  unsigned long length = vtksys::SystemTools::FileLength(this->FileName);
+  vtkIdType numFacets = 0;
+  if (length >= 84 + 48)
+    {
+    numFacets = static_cast<vtkIdType>(
+      (length - 84 + VTK_STL_FACET_SIZE - 48)/VTK_STL_FACET_SIZE);
+    }
+
+  // Decode the facets straight into the points and the cells
+  newPts->SetDataTypeToFloat();
+  newPts->SetNumberOfPoints(3*numFacets);
+  vtkIdTypeArray *cells = vtkIdTypeArray::New();
+  cells->SetNumberOfValues(4*numFacets);
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  vtkSTLReaderThreadStruct str;
+  str.Points = static_cast<float *>(newPts->GetVoidPointer(0));
+  str.Cells = cells->GetPointer(0);
+
+  vtkstd::vector<char> buffer(VTK_STL_FACETS_PER_BLOCK*VTK_STL_FACET_SIZE);
+  vtkIdType numRead = 0;
+  while (numRead < numFacets)
     {
-    fread(&ibuff2,2,1,fp); //read extra junk
+    vtkIdType numBlock = numFacets - numRead;
+    numBlock = (numBlock < VTK_STL_FACETS_PER_BLOCK) ? 
+      numBlock : VTK_STL_FACETS_PER_BLOCK;
+    size_t size = fread(&buffer[0], 1, numBlock*VTK_STL_FACET_SIZE, fp);
+    if (size < static_cast<size_t>(numBlock*VTK_STL_FACET_SIZE))
+      {
+      numBlock = static_cast<vtkIdType>(
+        (size + VTK_STL_FACET_SIZE - 48)/VTK_STL_FACET_SIZE);
+      }
+    if (numBlock <= 0)
+      {
+      break;
+      }
 
-    vtkByteSwap::Swap4LE (facet.n);
-    vtkByteSwap::Swap4LE (facet.n+1);
-    vtkByteSwap::Swap4LE (facet.n+2);
+    str.Buffer = &buffer[0];
+    str.NumberOfFacets = numBlock;
+    str.FirstFacet = numRead;
+    threader->SetSingleMethod(vtkSTLReaderDecodeFacets, &str);
+    threader->SingleMethodExecute();
+    numRead += numBlock;
 
-    vtkByteSwap::Swap4LE (facet.v1);
-    vtkByteSwap::Swap4LE (facet.v1+1);
-    vtkByteSwap::Swap4LE (facet.v1+2);
-    pts[0] = newPts->InsertNextPoint(facet.v1);
+    vtkDebugMacro(<< "triangle# " << numRead);
+    this->UpdateProgress(static_cast<double>(numRead)/numFacets);
+    }
+  threader->Delete();
 
-    vtkByteSwap::Swap4LE (facet.v2);
-    vtkByteSwap::Swap4LE (facet.v2+1);
-    vtkByteSwap::Swap4LE (facet.v2+2);
-    pts[1] = newPts->InsertNextPoint(facet.v2);
+  if (numRead < numFacets)
+    {
+    newPts->SetNumberOfPoints(3*numRead);
+    cells->Resize(4*numRead);
+    cells->SetNumberOfValues(4*numRead);
+    }
+  newPolys->SetCells(numRead, cells);
+  cells->Delete();
 
-    vtkByteSwap::Swap4LE (facet.v3);
-    vtkByteSwap::Swap4LE (facet.v3+1);
-    vtkByteSwap::Swap4LE (facet.v3+2);
-    pts[2] = newPts->InsertNextPoint(facet.v3);
+  return 0;
+}
 
-    newPolys->InsertNextCell(3,pts);
+//----------------------------------------------------------------------------
+// Merge the points with identical coordinates by sorting them, and
+// remove the triangles that become degenerate.  The merged points keep
+// the order of their first occurrence, as vtkMergePoints would give.
+void vtkSTLReader::MergeSortedPoints(vtkPoints *newPts,
+                                     vtkCellArray *newPolys,
+                                     vtkFloatArray *newScalars,
+                                     vtkPoints *mergedPts,
+                                     vtkCellArray *mergedPolys,
+                                     vtkFloatArray *mergedScalars)
+{
+  // the points were read as floats
+  vtkIdType numPts = newPts->GetNumberOfPoints();
+  float *x = static_cast<float *>(newPts->GetVoidPointer(0));
+  vtkIdType i;
+
+  vtkstd::vector<vtkSTLReaderSortPoint> sortPoints(numPts);
+  for (i = 0; i < numPts; i++)
+    {
+    sortPoints[i].Key[0] = vtkSTLReaderFloatKey(x[3*i]);
+    sortPoints[i].Key[1] = vtkSTLReaderFloatKey(x[3*i+1]);
+    sortPoints[i].Key[2] = vtkSTLReaderFloatKey(x[3*i+2]);
+    sortPoints[i].Id = i;
+    }
+
+  // Sort the points by x, y then z with a least significant digit radix
+  // sort.  Each pass is stable, so the identical points stay sorted by
+  // id.  The threads count and move contiguous ranges of the points.
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  int numThreads = threader->GetNumberOfThreads();
+  vtkstd::vector<vtkSTLReaderSortPoint> buffer(numPts);
+  vtkstd::vector<vtkIdType> counts(numThreads*VTK_STL_RADIX_SIZE);
+  vtkSTLReaderThreadStruct str;
+  str.Source = numPts ? &sortPoints[0] : 0;
+  str.Target = numPts ? &buffer[0] : 0;
+  str.NumberOfPoints = numPts;
+  str.Counts = &counts[0];
+  for (int pass = 0; numPts > 0 && pass < 6; pass++)
+    {
+    str.Key = 2 - pass/2;
+    str.Shift = (pass%2)*VTK_STL_RADIX_BITS;
+    threader->SetSingleMethod(vtkSTLReaderCountDigits, &str);
+    threader->SingleMethodExecute();
+
+    // Turn the counts into the first position of each bucket and thread,
+    // skipping the passes where all the points share the digit
+    vtkIdType position = 0;
+    int trivial = 0;
+    for (int digit = 0; digit < VTK_STL_RADIX_SIZE; digit++)
+      {
+      vtkIdType digitStart = position;
+      for (int t = 0; t < numThreads; t++)
+        {
+        vtkIdType count = counts[t*VTK_STL_RADIX_SIZE + digit];
+        counts[t*VTK_STL_RADIX_SIZE + digit] = position;
+        position += count;
+        }
+      trivial = trivial || (position - digitStart == numPts);
+      }
+    if (trivial)
+      {
+      continue;
+      }
 
-    if ( (i % 5000) == 0 && i != 0 )
+    threader->SetSingleMethod(vtkSTLReaderScatterDigits, &str);
+    threader->SingleMethodExecute();
+    vtkstd::swap(str.Source, str.Target);
+    }
+  threader->Delete();
+  vtkSTLReaderSortPoint *sorted = str.Source;
+  this->UpdateProgress(0.5);
+
+  // Each point maps to the first occurrence of its coordinates, which
+  // comes first among the identical points since ties sort by id.  A
+  // point with a NaN coordinate is never merged, because NaN compares
+  // unequal to itself in vtkMergePoints too, even though the sort puts
+  // NaNs with the same bit pattern next to each other.
+  vtkstd::vector<vtkIdType> pointMap(numPts);
+  i = 0;
+  while (i < numPts)
+    {
+    vtkIdType first = sorted[i].Id;
+    const unsigned int *keyFirst = sorted[i].Key;
+    pointMap[first] = first;
+    i++;
+    if (vtkSTLReaderIsNan(x[3*first]) || vtkSTLReaderIsNan(x[3*first+1]) ||
+        vtkSTLReaderIsNan(x[3*first+2]))
       {
-      vtkDebugMacro(<< "triangle# " << i);
-      this->UpdateProgress((i%50000)/50000.0);
+      continue;
+      }
+    while (i < numPts && sorted[i].Key[0] == keyFirst[0] &&
+           sorted[i].Key[1] == keyFirst[1] && sorted[i].Key[2] == keyFirst[2])
+      {
+      pointMap[sorted[i].Id] = first;
+      i++;
       }
     }
+  sortPoints.clear();
+  buffer.clear();
 
-  return 0;
+  // Number the merged points in order of first occurrence
+  vtkIdType numMerged = 0;
+  for (i = 0; i < numPts; i++)
+    {
+    pointMap[i] = (pointMap[i] == i) ? numMerged++ : pointMap[pointMap[i]];
+    }
+  mergedPts->SetDataTypeToFloat();
+  mergedPts->SetNumberOfPoints(numMerged);
+  float *mergedX = static_cast<float *>(mergedPts->GetVoidPointer(0));
+  for (i = 0, numMerged = 0; i < numPts; i++)
+    {
+    if (pointMap[i] == numMerged)
+      {
+      memcpy(mergedX + 3*numMerged++, x + 3*i, 3*sizeof(float));
+      }
+    }
+
+  vtkIdType *pts = 0;
+  vtkIdType nodes[3];
+  vtkIdType npts;
+  int nextCell=0;
+  for (newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); )
+    {
+    nodes[0] = pointMap[pts[0]];
+    nodes[1] = pointMap[pts[1]];
+    nodes[2] = pointMap[pts[2]];
+    if ( nodes[0] != nodes[1] &&
+         nodes[0] != nodes[2] &&
+         nodes[1] != nodes[2] )
+      {
+      mergedPolys->InsertNextCell(3,nodes);
+      if (newScalars)
+        {
+        mergedScalars->InsertNextValue(newScalars->GetValue(nextCell));
+        }
+      }
+    nextCell++;
+    }
 }
 
 int vtkSTLReader::ReadASCIISTL(FILE *fp, vtkPoints *newPts,
@@ -21,9 +21,10 @@
 //
 // .stl files are quite inefficient since they duplicate vertex 
 // definitions. By setting the Merging boolean you can control whether the 
-// point data is merged after reading. Merging is performed by default, 
-// however, merging requires a large amount of temporary storage since a 
-// 3D hash table must be constructed.
+// point data is merged after reading. Merging is performed by default.
+// Unless a locator is specified, points are merged by sorting them, which
+// takes temporary storage proportional to the number of points. Binary
+// files are read in large blocks, which are decoded by several threads.
 
 // .SECTION Caveats
 // Binary files written on one system may not be readable on other systems.
@@ -72,8 +73,9 @@ public:
   vtkBooleanMacro(ScalarTags,int);
 
   // Description:
-  // Specify a spatial locator for merging points. By
-  // default an instance of vtkMergePoints is used.
+  // Specify a spatial locator for merging points. By default no locator
+  // is used, and points with identical coordinates are merged by sorting
+  // them, which gives the same result as vtkMergePoints.
   void SetLocator(vtkIncrementalPointLocator *locator);
   vtkGetObjectMacro(Locator,vtkIncrementalPointLocator);
 
@@ -95,6 +97,10 @@ protected:
   int ReadASCIISTL(FILE *fp, vtkPoints*, vtkCellArray*, 
                    vtkFloatArray* scalars=0);
   int GetSTLFileType(const char *filename);
+  void MergeSortedPoints(vtkPoints *newPts, vtkCellArray *newPolys,
+                         vtkFloatArray *newScalars, vtkPoints *mergedPts,
+                         vtkCellArray *mergedPolys,
+                         vtkFloatArray *mergedScalars);
 private:
   vtkSTLReader(const vtkSTLReader&);  // Not implemented.
   void operator=(const vtkSTLReader&);  // Not implemented.
@@ -23,6 +23,7 @@
 #include <sys/stat.h>
 
 #include <vtkstd/string>
+#include <vtkstd/vector>
 
 
 extern "C" {
@@ -40,6 +41,7 @@ public:
   void Clean();
   int CanRead();
   int Open( const char *filename );
+  int Open( const char *filename, const char *buffer, unsigned long length );
   TIFF *Image;
   bool IsOpen;
   unsigned int Width;
@@ -64,6 +66,10 @@ public:
   float XResolution;
   float YResolution;
   short SampleFormat;
+  // the file read into memory ahead of time, if any
+  const char *Buffer;
+  unsigned long Length;
+  unsigned long Position;
   static void ErrorHandler(const char* module, const char* fmt, va_list ap);
 };
 
@@ -103,6 +109,110 @@ int vtkTIFFReaderInternal::Open( const char *filename )
   return 1;
 }
 
+//-------------------------------------------------------------------------
+// libtiff client procedures to read a file from memory.
+extern "C" {
+static tsize_t vtkTIFFReaderInternalRead(thandle_t handle, tdata_t data,
+                                         tsize_t size)
+{
+  vtkTIFFReaderInternal *reader = static_cast<vtkTIFFReaderInternal *>(handle);
+  if (size < 0)
+    {
+    return 0;
+    }
+  unsigned long remaining = reader->Length - reader->Position;
+  if (static_cast<unsigned long>(size) > remaining)
+    {
+    size = static_cast<tsize_t>(remaining);
+    }
+  memcpy(data, reader->Buffer + reader->Position, size);
+  reader->Position += size;
+  return size;
+}
+
+static tsize_t vtkTIFFReaderInternalWrite(thandle_t, tdata_t, tsize_t)
+{
+  return 0;
+}
+
+static toff_t vtkTIFFReaderInternalSeek(thandle_t handle, toff_t offset,
+                                        int whence)
+{
+  vtkTIFFReaderInternal *reader = static_cast<vtkTIFFReaderInternal *>(handle);
+  unsigned long position = static_cast<unsigned long>(offset);
+  if (whence == SEEK_CUR)
+    {
+    position += reader->Position;
+    }
+  else if (whence == SEEK_END)
+    {
+    position += reader->Length;
+    }
+  reader->Position = (position < reader->Length) ? position : reader->Length;
+  return static_cast<toff_t>(reader->Position);
+}
+
+static int vtkTIFFReaderInternalClose(thandle_t)
+{
+  return 0;
+}
+
+static toff_t vtkTIFFReaderInternalSize(thandle_t handle)
+{
+  return static_cast<toff_t>(
+    static_cast<vtkTIFFReaderInternal *>(handle)->Length);
+}
+
+static int vtkTIFFReaderInternalMap(thandle_t handle, tdata_t *data,
+                                    toff_t *size)
+{
+  // the file is only read, so libtiff can use the buffer in place
+  vtkTIFFReaderInternal *reader = static_cast<vtkTIFFReaderInternal *>(handle);
+  *data = const_cast<char *>(reader->Buffer);
+  *size = static_cast<toff_t>(reader->Length);
+  return 1;
+}
+
+static void vtkTIFFReaderInternalUnmap(thandle_t, tdata_t, toff_t)
+{
+}
+}
+
+//-------------------------------------------------------------------------
+int vtkTIFFReaderInternal::Open( const char *filename, const char *buffer,
+                                 unsigned long length )
+{
+  if ( !buffer )
+    {
+    return this->Open(filename);
+    }
+  this->Clean();
+  this->Buffer = buffer;
+  this->Length = length;
+  this->Position = 0;
+  this->Image = TIFFClientOpen(filename, "r", this,
+                               vtkTIFFReaderInternalRead,
+                               vtkTIFFReaderInternalWrite,
+                               vtkTIFFReaderInternalSeek,
+                               vtkTIFFReaderInternalClose,
+                               vtkTIFFReaderInternalSize,
+                               vtkTIFFReaderInternalMap,
+                               vtkTIFFReaderInternalUnmap);
+  if ( !this->Image)
+    {
+    this->Clean();
+    return 0;
+    }
+  if ( !this->Initialize() )
+    {
+    this->Clean();
+    return 0;
+    }
+
+  this->IsOpen = true;
+  return 1;
+}
+
 //-------------------------------------------------------------------------
 void vtkTIFFReaderInternal::Clean()
 {
@@ -132,6 +242,9 @@ void vtkTIFFReaderInternal::Clean()
   this->SubFiles = 0;
   this->SampleFormat = 1;
   this->ResolutionUnit = 1; // none
+  this->Buffer = NULL;
+  this->Length = 0;
+  this->Position = 0;
   this->IsOpen = false;
 }
 
@@ -526,54 +639,98 @@ void vtkTIFFReader::SetOrientationType( unsigned int orientationType )
 }
 
 //-------------------------------------------------------------------------
-template <class OT>
-void vtkTIFFReaderUpdate2(vtkTIFFReader *self, vtkTIFFReaderInternal *reader,
-                          OT *outPtr, int *outExt)
+void vtkTIFFReader::ReadSliceInternal( const char *fileName,
+                                       const char *buffer,
+                                       unsigned long length,
+                                       void *outPtr, int *outExt )
 {
-  if ( !reader->Open(self->GetInternalFileName()) )
+  vtkTIFFReaderInternal *reader = this->InternalImage;
+  if ( !reader->Open(fileName, buffer, length) )
     {
     return;
     }
   // if orientation information is provided, overwrite the value
   // read from the tiff image
-  if( self->GetOrientationTypeSpecifiedFlag())
+  if( this->OrientationTypeSpecifiedFlag )
     {
-    reader->Orientation = self->GetOrientationType();
+    reader->Orientation = this->OrientationType;
     }
 
 
-  self->InitializeColors();
-  self->ReadImageInternal(reader->Image, outPtr, outExt, sizeof(OT) );
+  this->InitializeColors();
+  this->ReadImageInternal(reader->Image, outPtr, outExt, 0 );
 
   // close the file
   reader->Clean();
 }
 
+//-------------------------------------------------------------------------
+void vtkTIFFReader::InitializeSliceReader( vtkTIFFReader *reader )
+{
+  reader->SetDataScalarType(this->DataScalarType);
+  reader->SetNumberOfScalarComponents(this->NumberOfScalarComponents);
+  reader->OutputIncrements = this->OutputIncrements;
+  reader->OrientationType = this->OrientationType;
+  reader->OrientationTypeSpecifiedFlag = this->OrientationTypeSpecifiedFlag;
+}
+
+//-------------------------------------------------------------------------
+// The output of the slices decoded by vtkTIFFReaderDecodeSlice, and a
+// reader for each thread.
+struct vtkTIFFReaderSlices
+{
+  char *OutPtr;
+  int *OutExt;
+  vtkIdType OutInc;
+  vtkstd::vector<vtkTIFFReader *> Readers;
+};
+
+//-------------------------------------------------------------------------
+// Decode the file of one slice into its place in the output.  The slices
+// are independent, so this runs on several threads at once.
+static void vtkTIFFReaderDecodeSlice(vtkImageReader2 *, int threadId,
+                                     int slice, const char *fileName,
+                                     const char *buffer, unsigned long length,
+                                     void *userData)
+{
+  vtkTIFFReaderSlices *slices = static_cast<vtkTIFFReaderSlices *>(userData);
+  char *outPtr = slices->OutPtr + (slice - slices->OutExt[4])*slices->OutInc;
+  slices->Readers[threadId]->ReadSliceInternal(fileName, buffer, length,
+                                               outPtr, slices->OutExt);
+}
+
 //----------------------------------------------------------------------------
-// This function reads in one data of data.
-// templated to handle different data types.
-template <class OT>
-void vtkTIFFReaderUpdate(vtkTIFFReader *self, vtkTIFFReaderInternal *reader,
-                         vtkImageData *data, OT *outPtr)
+// This function reads a data from a file.  The datas extent/axes
+// are assumed to be the same as the file extent/order.
+void vtkTIFFReader::ExecuteData(vtkDataObject *output)
 {
-  vtkIdType outIncr[3];
-  int outExtent[6];
-  OT *outPtr2;
+  vtkImageData *data = this->AllocateOutputData(output);
+  vtkTIFFReaderInternal *reader = this->GetInternalImage();
 
-  data->GetExtent(outExtent);
-  data->GetIncrements(outIncr);
+  if (this->InternalFileName == NULL)
+    {
+    vtkErrorMacro("Either a FileName or FilePrefix must be specified.");
+    return;
+    }
+
+  this->ComputeDataIncrements();
+
+  void *outPtr = data->GetScalarPointer();
+  // Needed deep in reading for finding the correct starting location.
+  this->OutputIncrements = data->GetIncrements();
+  data->GetPointData()->GetScalars()->SetName("Tiff Scalars");
 
   // multiple number of pages
   if(reader->NumberOfPages>1 )
     {
-    self->ReadVolume( outPtr );
+    this->ReadVolume( outPtr );
     return;
     }
 
   // tiled image
   if(reader->NumberOfTiles>0 )
     {
-    self->ReadTiles( outPtr );
+    this->ReadTiles( outPtr );
     return;
     }
 
@@ -582,52 +739,34 @@ void vtkTIFFReaderUpdate(vtkTIFFReader *self, vtkTIFFReaderInternal *reader,
   //file
   reader->Clean();
 
-  outPtr2 = outPtr;
-  int idx2;
-  for (idx2 = outExtent[4]; idx2 <= outExtent[5]; ++idx2)
+  // the first thread uses this reader, the other ones their own
+  int outExtent[6];
+  data->GetExtent(outExtent);
+  vtkTIFFReaderSlices slices;
+  slices.OutPtr = static_cast<char *>(outPtr);
+  slices.OutExt = outExtent;
+  slices.OutInc = this->OutputIncrements[2]*data->GetScalarSize();
+  int numThreads = this->NumberOfThreads;
+  if (numThreads > outExtent[5] - outExtent[4] + 1)
     {
-    self->ComputeInternalFileName(idx2);
-    // read in a TIFF file
-    vtkTIFFReaderUpdate2(self, reader, outPtr2, outExtent);
-    self->UpdateProgress((idx2 - outExtent[4])/
-                         (outExtent[5] - outExtent[4] + 1.0));
-    outPtr2 += outIncr[2];
+    numThreads = outExtent[5] - outExtent[4] + 1;
     }
-}
-
-
-//----------------------------------------------------------------------------
-// This function reads a data from a file.  The datas extent/axes
-// are assumed to be the same as the file extent/order.
-void vtkTIFFReader::ExecuteData(vtkDataObject *output)
-{
-  vtkImageData *data = this->AllocateOutputData(output);
-  vtkTIFFReaderInternal *reader = this->GetInternalImage();
-
-  if (this->InternalFileName == NULL)
+  slices.Readers.push_back(this);
+  for (int i = 1; i < numThreads; ++i)
     {
-    vtkErrorMacro("Either a FileName or FilePrefix must be specified.");
-    return;
+    vtkTIFFReader *threadReader = vtkTIFFReader::New();
+    this->InitializeSliceReader(threadReader);
+    slices.Readers.push_back(threadReader);
     }
 
-  this->ComputeDataIncrements();
+  // read in the TIFF files
+  this->DecodeSlices(outExtent[4], outExtent[5],
+                     vtkTIFFReaderDecodeSlice, &slices);
 
-  // Call the correct templated function for the output
-  void *outPtr;
-
-  // Call the correct templated function for the input
-  outPtr = data->GetScalarPointer();
-  // Needed deep in reading for finding the correct starting location.
-  this->OutputIncrements = data->GetIncrements();
-
-  switch (data->GetScalarType())
+  for (size_t i = 1; i < slices.Readers.size(); ++i)
     {
-    vtkTemplateMacro(vtkTIFFReaderUpdate(this, reader, data,
-                                         (VTK_TT *)(outPtr)));
-    default:
-      vtkErrorMacro("UpdateFromFile: Unknown data type");
+    slices.Readers[i]->Delete();
     }
-  data->GetPointData()->GetScalars()->SetName("Tiff Scalars");
 }
 
 //----------------------------------------------------------------------------
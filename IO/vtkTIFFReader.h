@@ -105,6 +105,18 @@ public:
   void ReadImageInternal( void *, void *outPtr,
                           int *outExt, unsigned int size );
 
+  // Description:
+  // Internal method, do not use.  Read the image of one file of a file
+  // series, from the given buffer if the file was read ahead.
+  void ReadSliceInternal( const char *fileName, const char *buffer,
+                          unsigned long length, void *outPtr, int *outExt );
+
+  // Description:
+  // Internal method, do not use.  Set up another reader to decode files
+  // of the series read by this one, so that slices can be decoded by
+  // several threads, each with its own reader.
+  void InitializeSliceReader( vtkTIFFReader *reader );
+
 protected:
   vtkTIFFReader();
   ~vtkTIFFReader();
@@ -18,6 +18,7 @@
 #include "vtkCallbackCommand.h"
 #include "vtkCellData.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayCache.h"
 #include "vtkDataArraySelection.h"
 #include "vtkDataSet.h"
 #include "vtkPointData.h"
@@ -27,6 +28,8 @@
 #include "vtkInformation.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <vtksys/SystemTools.hxx>
+
 #include "assert.h"
 
 
@@ -65,6 +68,7 @@ vtkXMLDataReader::~vtkXMLDataReader()
     this->DestroyPieces();
     }
   this->DataProgressObserver->Delete();
+  vtkDataArrayCache::GetGlobalCache()->InvalidateOwner(this);
   if( this->NumberOfPointArrays )
     {
     delete[] this->PointDataTimeStep;
@@ -756,6 +760,38 @@ int vtkXMLDataReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayInde
     {
     return 0;
     }
+  // Values read before from the same place of the same file version are
+  // taken from the array cache.  Strings and bits are not cached, nor is
+  // input that does not come from the named file.  The modification time
+  // has a resolution of one second, so the file size is part of the key.
+  vtkDataArrayCache* cache = vtkDataArrayCache::GetGlobalCache();
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+  int cacheValues = (dataArray && dataArray->GetDataType() != VTK_BIT &&
+                     this->FileName && this->IsReadingFromFile() &&
+                     numValues > 0 && cache->GetCapacity() > 0.0);
+  vtkDataArrayCacheKey key(this);
+  if(cacheValues)
+    {
+    const char* offset = da->GetAttribute("offset");
+    key.Append(this->FileName)
+      .Append(static_cast<double>(
+                vtksys::SystemTools::ModifiedTime(this->FileName)))
+      .Append(static_cast<double>(
+                vtksys::SystemTools::FileLength(this->FileName)))
+      .Append(offset? offset : "")
+      .Append(static_cast<double>(da->GetXMLByteIndex()))
+      .AppendId(startIndex).AppendId(numValues)
+      .Append(dataArray->GetDataType());
+    vtkDataArray* cached = cache->Find(key);
+    if(cached)
+      {
+      memcpy(dataArray->GetVoidPointer(arrayIndex), cached->GetVoidPointer(0),
+             numValues*dataArray->GetDataTypeSize());
+      cached->Delete();
+      return 1;
+      }
+    }
+
   this->InReadData = 1;
   int result;
   // All arrays types except vtkBitArray.
@@ -773,6 +809,17 @@ int vtkXMLDataReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayInde
     iter->Delete();
     }
   this->InReadData = 0;
+
+  if(result && cacheValues)
+    {
+    vtkDataArray* values =
+      vtkDataArray::CreateDataArray(dataArray->GetDataType());
+    values->SetNumberOfTuples(numValues);
+    memcpy(values->GetVoidPointer(0), dataArray->GetVoidPointer(arrayIndex),
+           numValues*dataArray->GetDataTypeSize());
+    cache->Insert(key, values);
+    values->Delete();
+    }
   return result;
 }
 
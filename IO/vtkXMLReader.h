@@ -269,6 +269,10 @@ protected:
 
   vtkDataObject* GetCurrentOutput();
   vtkInformation* GetCurrentOutputInformation();
+
+  // Whether the open input is the file named by FileName, as opposed to a
+  // stream provided by a subclass.
+  int IsReadingFromFile() { return this->Stream && this->Stream == this->FileStream; }
   
 private:
   // The stream used to read the input if it is in a file.
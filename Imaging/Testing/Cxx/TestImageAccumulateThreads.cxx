@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageAccumulateThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the threaded vtkImageAccumulate
+// .SECTION Description
+// Accumulates a two-component image with one and with four threads, with
+// and without a stencil and IgnoreZero, and checks that the bins, the
+// voxel count, the minimum and maximum are identical and that the mean and
+// the standard deviation agree up to round-off.
+
+#include "vtkImageAccumulate.h"
+#include "vtkImageData.h"
+#include "vtkImplicitFunctionToImageStencil.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphere.h"
+
+#include <math.h>
+#include <string.h>
+
+static int CompareValues(const double *a, const double *b, double tol)
+{
+  for (int j = 0; j < 3; j++)
+    {
+    if (fabs(a[j] - b[j]) > tol*(fabs(a[j]) > 1.0 ? fabs(a[j]) : 1.0))
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+int TestImageAccumulateThreads(int, char *[])
+{
+  int dims[3] = { 64, 48, 40 };
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(dims);
+  image->SetScalarTypeToShort();
+  image->SetNumberOfScalarComponents(2);
+  image->AllocateScalars();
+
+  // small values, with many zeros
+  short *ptr = static_cast<short *>(image->GetScalarPointer());
+  vtkIdType numValues = 2*image->GetNumberOfPoints();
+  unsigned int seed = 4321;
+  for (vtkIdType i = 0; i < numValues; i++)
+    {
+    seed = seed*1103515245 + 12345;
+    int value = static_cast<int>((seed >> 16) % 40) - 8;
+    ptr[i] = static_cast<short>(value < 0 ? 0 : value);
+    }
+
+  vtkSmartPointer<vtkSphere> sphere = vtkSmartPointer<vtkSphere>::New();
+  sphere->SetCenter(30.0, 20.0, 22.0);
+  sphere->SetRadius(18.0);
+  vtkSmartPointer<vtkImplicitFunctionToImageStencil> stencil =
+    vtkSmartPointer<vtkImplicitFunctionToImageStencil>::New();
+  stencil->SetInput(sphere);
+  stencil->SetInformationInput(image);
+  stencil->Update();
+
+  int rval = 0;
+  for (int useStencil = 0; useStencil < 2; useStencil++)
+    {
+    for (int ignoreZero = 0; ignoreZero < 2; ignoreZero++)
+      {
+      vtkSmartPointer<vtkImageAccumulate> accumulate[2];
+      for (int i = 0; i < 2; i++)
+        {
+        accumulate[i] = vtkSmartPointer<vtkImageAccumulate>::New();
+        accumulate[i]->SetInput(image);
+        accumulate[i]->SetComponentExtent(0, 31, 0, 31, 0, 0);
+        accumulate[i]->SetComponentOrigin(0.0, 0.0, 0.0);
+        accumulate[i]->SetComponentSpacing(1.0, 1.0, 1.0);
+        if (useStencil)
+          {
+          accumulate[i]->SetStencil(stencil->GetOutput());
+          }
+        accumulate[i]->SetIgnoreZero(ignoreZero);
+        accumulate[i]->SetNumberOfThreads(i == 0 ? 1 : 4);
+        accumulate[i]->Update();
+        }
+
+      vtkImageData *bins[2] = { accumulate[0]->GetOutput(),
+                                accumulate[1]->GetOutput() };
+      int numBins = 32*32;
+      if (accumulate[0]->GetVoxelCount() == 0 ||
+          accumulate[0]->GetVoxelCount() != accumulate[1]->GetVoxelCount() ||
+          bins[1]->GetNumberOfPoints() != numBins ||
+          memcmp(bins[0]->GetScalarPointer(), bins[1]->GetScalarPointer(),
+                 numBins*bins[0]->GetScalarSize()) != 0 ||
+          !CompareValues(accumulate[0]->GetMin(), accumulate[1]->GetMin(),
+                         0.0) ||
+          !CompareValues(accumulate[0]->GetMax(), accumulate[1]->GetMax(),
+                         0.0) ||
+          !CompareValues(accumulate[0]->GetMean(), accumulate[1]->GetMean(),
+                         1e-12) ||
+          !CompareValues(accumulate[0]->GetStandardDeviation(),
+                         accumulate[1]->GetStandardDeviation(), 1e-9))
+        {
+        cerr << "The histogram of four threads differs from one thread"
+             << (useStencil ? " with a stencil" : "")
+             << (ignoreZero ? " ignoring zero" : "") << ".\n";
+        rval = 1;
+        }
+      }
+    }
+
+  return rval;
+}
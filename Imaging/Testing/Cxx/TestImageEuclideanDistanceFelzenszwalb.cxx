@@ -0,0 +1,123 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageEuclideanDistanceFelzenszwalb.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the Felzenszwalb pass of vtkImageEuclideanDistance
+// .SECTION Description
+// Computes the distance map of a small anisotropic volume with scattered
+// features using the algorithms of Saito and of Felzenszwalb, checks that
+// both give the same distances and that the nearest feature of each voxel
+// is at the reported distance.
+
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkImageEuclideanDistance.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <math.h>
+
+int TestImageEuclideanDistanceFelzenszwalb(int, char *[])
+{
+  int dims[3] = { 17, 13, 9 };
+  double spacing[3] = { 1.0, 1.5, 2.0 };
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(dims);
+  image->SetSpacing(spacing);
+  image->SetScalarTypeToUnsignedChar();
+  image->SetNumberOfScalarComponents(1);
+  image->AllocateScalars();
+
+  // zero voxels are the features
+  unsigned char *inPtr =
+    static_cast<unsigned char *>(image->GetScalarPointer());
+  vtkIdType numPoints = image->GetNumberOfPoints();
+  unsigned int seed = 4321;
+  for (vtkIdType i = 0; i < numPoints; i++)
+    {
+    seed = seed*1103515245 + 12345;
+    inPtr[i] = (((seed >> 16) % 53) == 0) ? 0 : 1;
+    }
+
+  vtkSmartPointer<vtkImageEuclideanDistance> saito =
+    vtkSmartPointer<vtkImageEuclideanDistance>::New();
+  saito->SetInput(image);
+  saito->SetAlgorithmToSaito();
+  saito->Update();
+
+  vtkSmartPointer<vtkImageEuclideanDistance> felzenszwalb =
+    vtkSmartPointer<vtkImageEuclideanDistance>::New();
+  felzenszwalb->SetInput(image);
+  felzenszwalb->SetAlgorithmToFelzenszwalb();
+  felzenszwalb->ComputeNearestFeatureOn();
+  felzenszwalb->Update();
+
+  double *saitoPtr = static_cast<double *>(
+    saito->GetOutput()->GetScalarPointer());
+  double *felzenszwalbPtr = static_cast<double *>(
+    felzenszwalb->GetOutput()->GetScalarPointer());
+  vtkIdTypeArray *nearest = vtkIdTypeArray::SafeDownCast(
+    felzenszwalb->GetOutput()->GetPointData()->GetArray("NearestFeature"));
+  if (!nearest || nearest->GetNumberOfTuples() != numPoints)
+    {
+    cerr << "The NearestFeature array is missing.\n";
+    return 1;
+    }
+
+  int rval = 0;
+  vtkIdType numBad = 0;
+  vtkIdType numBadFeatures = 0;
+  for (vtkIdType i = 0; i < numPoints; i++)
+    {
+    if (fabs(saitoPtr[i] - felzenszwalbPtr[i]) > 1e-6*(1.0 + saitoPtr[i]))
+      {
+      numBad++;
+      }
+
+    vtkIdType feature = nearest->GetValue(i);
+    if (feature < 0 || feature >= numPoints || inPtr[feature] != 0)
+      {
+      numBadFeatures++;
+      continue;
+      }
+    double d2 = 0.0;
+    vtkIdType a = i;
+    vtkIdType b = feature;
+    for (int axis = 0; axis < 3; axis++)
+      {
+      double d = ((a % dims[axis]) - (b % dims[axis]))*spacing[axis];
+      d2 += d*d;
+      a /= dims[axis];
+      b /= dims[axis];
+      }
+    if (fabs(d2 - felzenszwalbPtr[i]) > 1e-6*(1.0 + d2))
+      {
+      numBadFeatures++;
+      }
+    }
+
+  if (numBad)
+    {
+    cerr << numBad << " of " << numPoints
+         << " distances differ between the Saito and Felzenszwalb passes.\n";
+    rval = 1;
+    }
+  if (numBadFeatures)
+    {
+    cerr << numBadFeatures << " of " << numPoints
+         << " nearest features are not at the computed distance.\n";
+    rval = 1;
+    }
+
+  return rval;
+}
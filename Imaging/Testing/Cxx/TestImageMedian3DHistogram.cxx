@@ -0,0 +1,104 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageMedian3DHistogram.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the histogram path of vtkImageMedian3D
+// .SECTION Description
+// Filters the same integer values stored as short, which uses the sliding
+// histograms, and as float, which sorts the neighborhoods, and checks that
+// both give the same result for odd and even kernels, at the boundaries
+// and for other percentiles than the median.
+
+#include "vtkImageData.h"
+#include "vtkImageMedian3D.h"
+#include "vtkSmartPointer.h"
+
+int TestImageMedian3DHistogram(int, char *[])
+{
+  int dims[3] = { 23, 19, 7 };
+  vtkSmartPointer<vtkImageData> shortImage =
+    vtkSmartPointer<vtkImageData>::New();
+  shortImage->SetDimensions(dims);
+  shortImage->SetScalarTypeToShort();
+  shortImage->SetNumberOfScalarComponents(1);
+  shortImage->AllocateScalars();
+  vtkSmartPointer<vtkImageData> floatImage =
+    vtkSmartPointer<vtkImageData>::New();
+  floatImage->SetDimensions(dims);
+  floatImage->SetScalarTypeToFloat();
+  floatImage->SetNumberOfScalarComponents(1);
+  floatImage->AllocateScalars();
+
+  // small values so that the neighborhoods have many ties
+  short *shortPtr = static_cast<short *>(shortImage->GetScalarPointer());
+  float *floatPtr = static_cast<float *>(floatImage->GetScalarPointer());
+  vtkIdType numPoints = shortImage->GetNumberOfPoints();
+  unsigned int seed = 12345;
+  for (vtkIdType i = 0; i < numPoints; i++)
+    {
+    seed = seed*1103515245 + 12345;
+    shortPtr[i] = static_cast<short>((seed >> 16) % 41) - 20;
+    floatPtr[i] = shortPtr[i];
+    }
+
+  static const int kernels[][3] = {
+    { 3, 3, 3 }, { 5, 5, 1 }, { 4, 4, 1 }, { 4, 3, 2 }, { 2, 6, 3 },
+    { 7, 2, 4 } };
+  static const double percentiles[] = { 0.5, 0.0, 0.25, 1.0 };
+  int numKernels = sizeof(kernels)/sizeof(kernels[0]);
+  int numPercentiles = sizeof(percentiles)/sizeof(percentiles[0]);
+
+  int rval = 0;
+  for (int k = 0; k < numKernels; k++)
+    {
+    for (int p = 0; p < numPercentiles; p++)
+      {
+      vtkSmartPointer<vtkImageMedian3D> shortMedian =
+        vtkSmartPointer<vtkImageMedian3D>::New();
+      shortMedian->SetInput(shortImage);
+      shortMedian->SetKernelSize(kernels[k][0], kernels[k][1], kernels[k][2]);
+      shortMedian->SetPercentile(percentiles[p]);
+      shortMedian->Update();
+
+      vtkSmartPointer<vtkImageMedian3D> floatMedian =
+        vtkSmartPointer<vtkImageMedian3D>::New();
+      floatMedian->SetInput(floatImage);
+      floatMedian->SetKernelSize(kernels[k][0], kernels[k][1], kernels[k][2]);
+      floatMedian->SetPercentile(percentiles[p]);
+      floatMedian->Update();
+
+      short *shortOut = static_cast<short *>(
+        shortMedian->GetOutput()->GetScalarPointer());
+      float *floatOut = static_cast<float *>(
+        floatMedian->GetOutput()->GetScalarPointer());
+      vtkIdType numBad = 0;
+      for (vtkIdType i = 0; i < numPoints; i++)
+        {
+        if (shortOut[i] != floatOut[i])
+          {
+          numBad++;
+          }
+        }
+      if (numBad)
+        {
+        cerr << "Kernel " << kernels[k][0] << "x" << kernels[k][1] << "x"
+             << kernels[k][2] << " percentile " << percentiles[p]
+             << ": " << numBad << " of " << numPoints
+             << " values differ between the histogram and sort paths.\n";
+        rval = 1;
+        }
+      }
+    }
+
+  return rval;
+}
@@ -21,6 +21,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <vtkstd/vector>
+
 #include <math.h>
 
 vtkStandardNewMacro(vtkImageAccumulate);
@@ -48,6 +50,8 @@ vtkImageAccumulate::vtkImageAccumulate()
   this->VoxelCount = 0;
   this->IgnoreZero = 0;
 
+  this->ThreadData = NULL;
+
   // we have the image input and the optional stencil input
   this->SetNumberOfInputPorts(2);
 }
@@ -121,17 +125,71 @@ vtkImageStencilData *vtkImageAccumulate::GetStencil()
 }
 
 
+//----------------------------------------------------------------------------
+// The bins and statistics accumulated by each thread.
+class vtkImageAccumulateThreadData
+{
+public:
+  vtkImageAccumulateThreadData(int numThreads, vtkIdType numBins) :
+    Bins(numThreads), Min(numThreads), Max(numThreads), Sum(numThreads),
+    SumSqr(numThreads), VoxelCount(numThreads, 0)
+    {
+    this->NumberOfBins = numBins;
+    this->OutPtr = 0;
+    for (int i = 0; i < numThreads; i++)
+      {
+      for (int idx = 0; idx < 3; idx++)
+        {
+        this->Min[i].Value[idx] = VTK_DOUBLE_MAX;
+        this->Max[i].Value[idx] = VTK_DOUBLE_MIN;
+        this->Sum[i].Value[idx] = 0.0;
+        this->SumSqr[i].Value[idx] = 0.0;
+        }
+      }
+    }
+
+  // thread 0 accumulates directly into the output
+  int *GetBins(int threadId)
+    {
+    if (threadId == 0)
+      {
+      return this->OutPtr;
+      }
+    if (this->Bins[threadId].empty())
+      {
+      this->Bins[threadId].resize(this->NumberOfBins, 0);
+      }
+    return &this->Bins[threadId][0];
+    }
+
+  struct Triple
+  {
+    double Value[3];
+  };
+
+  vtkIdType NumberOfBins;
+  vtkDataArray *InArray;
+  int *OutPtr;
+  vtkstd::vector<vtkstd::vector<int> > Bins;
+  vtkstd::vector<Triple> Min;
+  vtkstd::vector<Triple> Max;
+  vtkstd::vector<Triple> Sum;
+  vtkstd::vector<Triple> SumSqr;
+  vtkstd::vector<long int> VoxelCount;
+};
+
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
+// It accumulates the given extent into the bins and statistics of
+// one thread.
 template <class T>
 void vtkImageAccumulateExecute(vtkImageAccumulate *self,
                                vtkImageData *inData, T *inPtr,
                                vtkImageData *outData, int *outPtr,
                                double min[3], double max[3],
-                               double mean[3],
-                               double standardDeviation[3],
+                               double sum[3], double sumSqr[3],
                                long int *voxelCount,
-                               int* updateExtent)
+                               int* updateExtent, int threadId)
 {
   int idX, idY, idZ, idxC;
   int iter, pmin0, pmax0, min0, max0, min1, max1, min2, max2;
@@ -143,24 +201,9 @@ void vtkImageAccumulateExecute(vtkImageAccumulate *self,
   double *origin, *spacing;
   unsigned long count = 0;
   unsigned long target;
-  double sumSqr[3], variance;
-
-  // variables used to compute statistics (filter handles max 3 components)
-  double sum[3];
-  sum[0] = sum[1] = sum[2] = 0.0;
-  min[0] = min[1] = min[2] = VTK_DOUBLE_MAX;
-  max[0] = max[1] = max[2] = VTK_DOUBLE_MIN;
-  sumSqr[0] = sumSqr[1] = sumSqr[2] = 0.0;
-  standardDeviation[0] = standardDeviation[1] = standardDeviation[2] = 0.0;
-  *voxelCount = 0;
 
   vtkImageStencilData *stencil = self->GetStencil();
 
-  // Zero count in every bin
-  outData->GetExtent(min0, max0, min1, max1, min2, max2);
-  memset(static_cast<void *>(outPtr), 0,
-         (max0-min0+1)*(max1-min1+1)*(max2-min2+1)*sizeof(int));
-
   // Get information to march through data
   numC = inData->GetNumberOfScalarComponents();
   min0 = updateExtent[0];
@@ -184,13 +227,16 @@ void vtkImageAccumulateExecute(vtkImageAccumulate *self,
   // Loop through input pixels
   for (idZ = min2; idZ <= max2; idZ++)
     {
-    for (idY = min1; idY <= max1; idY++)
+    for (idY = min1; !self->AbortExecute && idY <= max1; idY++)
       {
-      if (!(count%target))
+      if (!threadId)
         {
-        self->UpdateProgress(count/(50.0*target));
+        if (!(count%target))
+          {
+          self->UpdateProgress(count/(50.0*target));
+          }
+        count++;
         }
-      count++;
 
       // loop over stencil sub-extents, -1 flags
       // that we want the complementary extents
@@ -247,57 +293,25 @@ void vtkImageAccumulateExecute(vtkImageAccumulate *self,
         }
       }
     }
-
-  if (*voxelCount) // avoid the div0
-    {
-    mean[0] = sum[0] / static_cast<double>(*voxelCount);
-    mean[1] = sum[1] / static_cast<double>(*voxelCount);
-    mean[2] = sum[2] / static_cast<double>(*voxelCount);
-
-    if (*voxelCount - 1) // avoid the div0
-      {
-      variance = sumSqr[0] / static_cast<double>(*voxelCount-1) -
-        (static_cast<double>(*voxelCount) * mean[0] * mean[0] / static_cast<double>(*voxelCount - 1));
-      standardDeviation[0] = sqrt(variance);
-      variance = sumSqr[1] / static_cast<double>(*voxelCount-1) -
-        (static_cast<double>(*voxelCount) * mean[1] * mean[1] / static_cast<double>(*voxelCount - 1));
-      standardDeviation[1] = sqrt(variance);
-      variance = sumSqr[2] / static_cast<double>(*voxelCount-1) -
-        (static_cast<double>(*voxelCount) * mean[2] * mean[2] / static_cast<double>(*voxelCount - 1));
-      standardDeviation[2] = sqrt(variance);
-      }
-    else
-      {
-      standardDeviation[0] = standardDeviation[1] = standardDeviation[2] = 0.0;
-      }
-    }
-  else
-    {
-    mean[0] = mean[1] = mean[2] = 0.0;
-    standardDeviation[0] = standardDeviation[1] = standardDeviation[2] = 0.0;
-    }
-
 }
 
 
 //----------------------------------------------------------------------------
 // This method is passed a input and output Data, and executes the filter
 // algorithm to fill the output from the input.
-// It just executes a switch statement to call the correct function for
-// the Datas data types.
+// The input is split among the threads, and then the bins and statistics
+// of the threads are combined.
 int vtkImageAccumulate::RequestData(
-  vtkInformation* vtkNotUsed( request ),
+  vtkInformation* request,
   vtkInformationVector** inputVector,
   vtkInformationVector* outputVector)
 {
-  void *inPtr;
-  void *outPtr;
+  int idx;
 
   // get the input
   vtkInformation* in1Info = inputVector[0]->GetInformationObject(0);
   vtkImageData *inData = vtkImageData::SafeDownCast(
     in1Info->Get(vtkDataObject::DATA_OBJECT()));
-  int *uExt = in1Info->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT());
 
   // get the output
   vtkInformation *outInfo = outputVector->GetInformationObject(0);
@@ -311,10 +325,6 @@ int vtkImageAccumulate::RequestData(
   outData->SetExtent(outData->GetWholeExtent());
   outData->AllocateScalars();
 
-  vtkDataArray *inArray = this->GetInputArrayToProcess(0,inputVector);
-  inPtr = inData->GetArrayPointerForExtent(inArray, uExt);
-  outPtr = outData->GetScalarPointer();
-
   // Components turned into x, y and z
   if (inData->GetNumberOfScalarComponents() > 3)
     {
@@ -330,24 +340,120 @@ int vtkImageAccumulate::RequestData(
     return 1;
     }
 
-  switch (inData->GetScalarType())
+  // Zero count in every bin
+  int min0, max0, min1, max1, min2, max2;
+  outData->GetExtent(min0, max0, min1, max1, min2, max2);
+  vtkIdType numBins = 
+    static_cast<vtkIdType>(max0-min0+1)*(max1-min1+1)*(max2-min2+1);
+  int *outPtr = static_cast<int *>(outData->GetScalarPointer());
+  memset(static_cast<void *>(outPtr), 0, numBins*sizeof(int));
+
+  vtkImageAccumulateThreadData threadData(this->NumberOfThreads, numBins);
+  threadData.InArray = this->GetInputArrayToProcess(0,inputVector);
+  threadData.OutPtr = outPtr;
+
+  this->ThreadData = &threadData;
+  int numThreads = this->SplitInputAndExecute(request, inputVector,
+                                              outputVector);
+  this->ThreadData = NULL;
+
+  // Combine the results of the threads
+  double sum[3], sumSqr[3];
+  for (idx = 0; idx < 3; idx++)
+    {
+    this->Min[idx] = VTK_DOUBLE_MAX;
+    this->Max[idx] = VTK_DOUBLE_MIN;
+    sum[idx] = sumSqr[idx] = 0.0;
+    }
+  this->VoxelCount = 0;
+
+  for (int threadId = 0; threadId < numThreads; threadId++)
+    {
+    if (threadId > 0 && !threadData.Bins[threadId].empty())
+      {
+      int *binPtr = &threadData.Bins[threadId][0];
+      for (vtkIdType bin = 0; bin < numBins; bin++)
+        {
+        outPtr[bin] += binPtr[bin];
+        }
+      }
+    for (idx = 0; idx < 3; idx++)
+      {
+      if (threadData.Min[threadId].Value[idx] < this->Min[idx])
+        {
+        this->Min[idx] = threadData.Min[threadId].Value[idx];
+        }
+      if (threadData.Max[threadId].Value[idx] > this->Max[idx])
+        {
+        this->Max[idx] = threadData.Max[threadId].Value[idx];
+        }
+      sum[idx] += threadData.Sum[threadId].Value[idx];
+      sumSqr[idx] += threadData.SumSqr[threadId].Value[idx];
+      }
+    this->VoxelCount += threadData.VoxelCount[threadId];
+    }
+
+  long int voxelCount = this->VoxelCount;
+  if (voxelCount) // avoid the div0
+    {
+    for (idx = 0; idx < 3; idx++)
+      {
+      this->Mean[idx] = sum[idx] / static_cast<double>(voxelCount);
+      if (voxelCount - 1) // avoid the div0
+        {
+        double variance = sumSqr[idx] / static_cast<double>(voxelCount-1) -
+          (static_cast<double>(voxelCount) * this->Mean[idx] * this->Mean[idx] /
+           static_cast<double>(voxelCount - 1));
+        this->StandardDeviation[idx] = sqrt(variance);
+        }
+      else
+        {
+        this->StandardDeviation[idx] = 0.0;
+        }
+      }
+    }
+  else
+    {
+    this->Mean[0] = this->Mean[1] = this->Mean[2] = 0.0;
+    this->StandardDeviation[0] = this->StandardDeviation[1] =
+      this->StandardDeviation[2] = 0.0;
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Accumulate one piece of the input into the bins of this thread.
+void vtkImageAccumulate::ThreadedRequestData(
+  vtkInformation* vtkNotUsed( request ),
+  vtkInformationVector** vtkNotUsed( inputVector ),
+  vtkInformationVector* vtkNotUsed( outputVector ),
+  vtkImageData ***inData,
+  vtkImageData **outData,
+  int extent[6], int threadId)
+{
+  vtkImageAccumulateThreadData *data = this->ThreadData;
+  void *inPtr = inData[0][0]->GetArrayPointerForExtent(data->InArray, extent);
+
+  switch (inData[0][0]->GetScalarType())
     {
     vtkTemplateMacro(vtkImageAccumulateExecute( this,
-                                                inData,
+                                                inData[0][0],
                                                 static_cast<VTK_TT *>(inPtr),
-                                                outData,
-                                                static_cast<int *>(outPtr),
-                                                this->Min, this->Max,
-                                                this->Mean,
-                                                this->StandardDeviation,
-                                                &this->VoxelCount,
-                                                uExt ));
+                                                outData[0],
+                                                data->GetBins(threadId),
+                                                data->Min[threadId].Value,
+                                                data->Max[threadId].Value,
+                                                data->Sum[threadId].Value,
+                                                data->SumSqr[threadId].Value,
+                                                &data->VoxelCount[threadId],
+                                                extent, threadId ));
     default:
-      vtkErrorMacro(<< "Execute: Unknown ScalarType");
-      return 1;
+      if (threadId == 0)
+        {
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+        }
     }
-
-  return 1;
 }
 
 
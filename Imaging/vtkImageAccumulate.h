@@ -31,20 +31,24 @@
 // option with vtkImageMask may result in results being slightly off since 0
 // could be a valid value from your input.
 //
+// The input is split among threads, each of which accumulates its own
+// bins and statistics, and the partial results are summed at the end.
+//
 // .SECTION see also vtkImageMask
 
 #ifndef __vtkImageAccumulate_h
 #define __vtkImageAccumulate_h
 
-#include "vtkImageAlgorithm.h"
+#include "vtkThreadedImageAlgorithm.h"
 
 class vtkImageStencilData;
+class vtkImageAccumulateThreadData;
 
-class VTK_IMAGING_EXPORT vtkImageAccumulate : public vtkImageAlgorithm
+class VTK_IMAGING_EXPORT vtkImageAccumulate : public vtkThreadedImageAlgorithm
 {
 public:
   static vtkImageAccumulate *New();
-  vtkTypeMacro(vtkImageAccumulate,vtkImageAlgorithm);
+  vtkTypeMacro(vtkImageAccumulate,vtkThreadedImageAlgorithm);
   void PrintSelf(ostream& os, vtkIndent indent);
 
   // Description:
@@ -130,6 +134,12 @@ protected:
   virtual int RequestData(vtkInformation* request,
                           vtkInformationVector** inputVector,
                           vtkInformationVector* outputVector);
+  virtual void ThreadedRequestData(vtkInformation *request,
+                                   vtkInformationVector **inputVector,
+                                   vtkInformationVector *outputVector,
+                                   vtkImageData ***inData,
+                                   vtkImageData **outData,
+                                   int extent[6], int threadId);
 
   int    IgnoreZero;
   double Min[3];
@@ -140,6 +150,9 @@ protected:
 
   int ReverseStencil;
 
+  // the partial results of each thread
+  vtkImageAccumulateThreadData *ThreadData;
+
   virtual int FillInputPortInformation(int port, vtkInformation* info);
 
 private:
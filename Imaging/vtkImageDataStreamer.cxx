@@ -90,8 +90,30 @@ int vtkImageDataStreamer::ProcessRequest(vtkInformation* request,
       translator->GetExtent(inExt);
       }
     
-    inputVector[0]->GetInformationObject(0)
-      ->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), inExt, 6);
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), inExt, 6);
+
+    // let the sources know which piece comes next so that they
+    // can read it ahead while this piece is being processed
+    int nextExt[6] = {0, -1, 0, -1, 0, -1};
+    if (this->CurrentDivision + 1 < this->NumberOfStreamDivisions)
+      {
+      translator->SetPiece(this->CurrentDivision + 1);
+      if (translator->PieceToExtentByPoints())
+        {
+        translator->GetExtent(nextExt);
+        }
+      }
+    if (nextExt[0] <= nextExt[1] && nextExt[2] <= nextExt[3] &&
+        nextExt[4] <= nextExt[5])
+      {
+      inInfo->Set(vtkStreamingDemandDrivenPipeline::PREFETCH_UPDATE_EXTENT(),
+                  nextExt, 6);
+      }
+    else
+      {
+      inInfo->Remove(vtkStreamingDemandDrivenPipeline::PREFETCH_UPDATE_EXTENT());
+      }
     
     return 1;
     }
@@ -16,7 +16,9 @@
 // .SECTION Description
 // To satisfy a request, this filter calls update on its input
 // many times with smaller update extents.  All processing up stream
-// streams smaller pieces.
+// streams smaller pieces.  Along with each piece, the extent of the
+// following piece is passed upstream, so that readers which support
+// it (see vtkImageReader2::SetPrefetchMemoryLimit) can read ahead.
 
 #ifndef __vtkImageDataStreamer_h
 #define __vtkImageDataStreamer_h
@@ -14,10 +14,13 @@
 =========================================================================*/
 #include "vtkImageEuclideanDistance.h"
 
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <math.h>
@@ -32,6 +35,7 @@ vtkImageEuclideanDistance::vtkImageEuclideanDistance()
   this->Initialize = 1;
   this->ConsiderAnisotropy = 1;
   this->Algorithm = VTK_EDT_SAITO;
+  this->ComputeNearestFeature = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -554,6 +558,204 @@ void vtkImageEuclideanDistanceExecuteSaitoCached(
   free(temp);
   free(sq);
 }
+//----------------------------------------------------------------------------
+// Execute the algorithm of Felzenszwalb and Huttenlocher.  Along each
+// row, the squared distance is the lower envelope of the parabolas
+// rooted at the values of the previous pass, and the envelope is found
+// in linear time.  The first pass is no different from the others.
+//
+// P. F. Felzenszwalb and D. P. Huttenlocher. Distance Transforms of
+// Sampled Functions. Cornell Computing and Information Science
+// TR2004-1963, 2004.
+//
+void vtkImageEuclideanDistanceExecuteFelzenszwalb(
+  vtkImageEuclideanDistance *self,
+  vtkImageData *outData, int outExt[6], double *outPtr,
+  vtkIdType *indexPtr)
+{
+  int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
+  vtkIdType outInc0, outInc1, outInc2;
+  double *outPtr0, *outPtr1, *outPtr2;
+  vtkIdType *indexPtr1;
+  int idx1, idx2, inSize0;
+  int q, k;
+  double maxDist, spacing, s, d;
+  
+  // Reorder axes
+  self->PermuteExtent(outExt, outMin0,outMax0,outMin1,outMax1,outMin2,outMax2);
+  self->PermuteIncrements(outData->GetIncrements(), outInc0, outInc1, outInc2);
+  
+  inSize0 = outMax0 - outMin0 + 1;  
+  maxDist = self->GetMaximumDistance();
+
+  if ( self->GetConsiderAnisotropy() )
+    {
+    spacing = outData->GetSpacing()[ self->GetIteration() ];
+    }
+  else
+    {
+    spacing = 1;
+    }
+  spacing*=spacing;
+  if (spacing == 0.0)
+    {
+    spacing = 1;
+    }
+
+  // the values of the row, and the envelope: the roots of its parabolas
+  // and the boundaries between them
+  double *f = new double[inSize0];
+  vtkIdType *fIndex = new vtkIdType[inSize0];
+  int *v = new int[inSize0];
+  double *z = new double[inSize0+1];
+
+  outPtr2 = outPtr;
+  for (idx2 = outMin2; idx2 <= outMax2; ++idx2)
+    {
+    outPtr1 = outPtr2;
+    for (idx1 = outMin1; idx1 <= outMax1; ++idx1)
+      {
+      // the index array has the layout of the single component output
+      indexPtr1 = indexPtr ? indexPtr + (outPtr1 - outPtr) : 0;
+
+      // Buffer current values 
+      outPtr0 = outPtr1;
+      for (q = 0; q < inSize0; ++q)
+        {
+        f[q] = *outPtr0;
+        outPtr0 += outInc0;
+        }
+      if (indexPtr1)
+        {
+        for (q = 0; q < inSize0; ++q)
+          {
+          fIndex[q] = indexPtr1[q*outInc0];
+          }
+        }
+
+      // Build the lower envelope of the parabolas of the values that
+      // are closer than maxDist
+      k = -1;
+      for (q = 0; q < inSize0; ++q)
+        {
+        if (f[q] >= maxDist)
+          {
+          continue;
+          }
+        s = -VTK_DOUBLE_MAX;
+        while (k >= 0)
+          {
+          s = ((f[q] + spacing*q*q) - (f[v[k]] + spacing*v[k]*v[k])) /
+            (2*spacing*(q - v[k]));
+          if (s > z[k])
+            {
+            break;
+            }
+          --k;
+          }
+        ++k;
+        v[k] = q;
+        z[k] = (k == 0) ? -VTK_DOUBLE_MAX : s;
+        }
+
+      // Evaluate the envelope along the row
+      if (k >= 0)
+        {
+        z[k+1] = VTK_DOUBLE_MAX;
+        k = 0;
+        outPtr0 = outPtr1;
+        for (q = 0; q < inSize0; ++q)
+          {
+          while (z[k+1] < q)
+            {
+            ++k;
+            }
+          d = q - v[k];
+          d = f[v[k]] + spacing*d*d;
+          if (d < f[q])
+            {
+            *outPtr0 = d;
+            if (indexPtr1)
+              {
+              indexPtr1[q*outInc0] = fIndex[v[k]];
+              }
+            }
+          outPtr0 += outInc0;
+          }
+        }
+
+      outPtr1 += outInc1;
+      }
+    outPtr2 += outInc2;
+    }
+
+  delete [] f;
+  delete [] fIndex;
+  delete [] v;
+  delete [] z;
+}
+
+//----------------------------------------------------------------------------
+// The data shared by the threads of one pass.
+struct vtkImageEuclideanDistanceThreadStruct
+{
+  vtkImageEuclideanDistance *Filter;
+  vtkImageData *OutData;
+  double *OutPtr;
+  vtkIdType *IndexPtr;
+  int Extent[6];
+};
+
+//----------------------------------------------------------------------------
+// Each thread computes the pass over a piece of the rows, which are
+// split so that no row is shared between threads.
+VTK_THREAD_RETURN_TYPE vtkImageEuclideanDistanceThreadedExecute( void *arg )
+{
+  int threadId = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->ThreadID;
+  int threadCount = 
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg)->NumberOfThreads;
+  vtkImageEuclideanDistanceThreadStruct *str = 
+    static_cast<vtkImageEuclideanDistanceThreadStruct *>
+    (static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+  vtkImageEuclideanDistance *self = str->Filter;
+
+  int splitExt[6];
+  int total = self->SplitExtent(splitExt, str->Extent, threadId, threadCount);
+  if (threadId >= total)
+    {
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  double *outPtr = 
+    static_cast<double *>(str->OutData->GetScalarPointerForExtent(splitExt));
+  vtkIdType *indexPtr = 0;
+  if (str->IndexPtr)
+    {
+    // the index array has the layout of the single component output
+    indexPtr = str->IndexPtr + (outPtr - str->OutPtr);
+    }
+
+  // Call the specific algorithms. 
+  switch( self->GetAlgorithm() ) 
+    {
+    case VTK_EDT_SAITO:
+      vtkImageEuclideanDistanceExecuteSaito( self, str->OutData, splitExt, 
+                                             outPtr );
+      break;
+    case VTK_EDT_SAITO_CACHED:
+      vtkImageEuclideanDistanceExecuteSaitoCached( self, str->OutData, 
+                                                   splitExt, outPtr );
+      break;
+    case VTK_EDT_FELZENSZWALB:
+      vtkImageEuclideanDistanceExecuteFelzenszwalb( self, str->OutData,
+                                                    splitExt, outPtr,
+                                                    indexPtr );
+      break;
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 //----------------------------------------------------------------------------
 void vtkImageEuclideanDistance::AllocateOutputScalars(vtkImageData *outData)
 {
@@ -561,6 +763,59 @@ void vtkImageEuclideanDistance::AllocateOutputScalars(vtkImageData *outData)
   outData->AllocateScalars();
 }
 
+//----------------------------------------------------------------------------
+// Return the nearest feature array of the output, creating it on the
+// first pass, or copying it from the input of the later passes.
+vtkIdType *vtkImageEuclideanDistance::GetNearestFeaturePointer(
+  vtkImageData *inData, vtkImageData *outData)
+{
+  vtkIdType numPts = outData->GetNumberOfPoints();
+  vtkIdTypeArray *index = vtkIdTypeArray::SafeDownCast(
+    outData->GetPointData()->GetArray("NearestFeature"));
+
+  if (this->GetIteration() > 0 && inData != outData)
+    {
+    vtkIdTypeArray *inIndex = vtkIdTypeArray::SafeDownCast(
+      inData->GetPointData()->GetArray("NearestFeature"));
+    if (inIndex && inIndex->GetNumberOfTuples() == numPts)
+      {
+      if (!index || index == inIndex)
+        {
+        index = vtkIdTypeArray::New();
+        index->SetName("NearestFeature");
+        outData->GetPointData()->AddArray(index);
+        index->Delete();
+        }
+      index->DeepCopy(inIndex);
+      return index->GetPointer(0);
+      }
+    }
+  else if (this->GetIteration() > 0 && index && 
+           index->GetNumberOfTuples() == numPts)
+    {
+    return index->GetPointer(0);
+    }
+
+  // Every voxel closer than MaximumDistance is its own feature
+  if (!index)
+    {
+    index = vtkIdTypeArray::New();
+    index->SetName("NearestFeature");
+    outData->GetPointData()->AddArray(index);
+    index->Delete();
+    }
+  index->SetNumberOfValues(numPts);
+  double *outPtr = static_cast<double *>(outData->GetScalarPointer());
+  vtkIdType *indexPtr = index->GetPointer(0);
+  double maxDist = this->GetMaximumDistance();
+  for (vtkIdType id = 0; id < numPts; id++)
+    {
+    indexPtr[id] = (outPtr[id] < maxDist) ? id : -1;
+    }
+
+  return indexPtr;
+}
+
 //----------------------------------------------------------------------------
 // This method is passed input and output Datas, and executes the
 // EuclideanDistance algorithm to fill the output from the input.
@@ -640,16 +895,36 @@ int vtkImageEuclideanDistance::IterativeRequestData(
         }
     }
   
+  // The nearest feature of each voxel, carried from pass to pass
+  vtkIdType *indexPtr = 0;
+  if (this->ComputeNearestFeature && 
+      this->GetAlgorithm() == VTK_EDT_FELZENSZWALB)
+    {
+    indexPtr = this->GetNearestFeaturePointer(inData, outData);
+    }
+  else
+    {
+    outData->GetPointData()->RemoveArray("NearestFeature");
+    }
+
   // Call the specific algorithms. 
   switch( this->GetAlgorithm() ) 
     {
     case VTK_EDT_SAITO:
-      vtkImageEuclideanDistanceExecuteSaito( this, outData, outExt, 
-                                             static_cast<double *>(outPtr) );
-      break;
     case VTK_EDT_SAITO_CACHED:
-      vtkImageEuclideanDistanceExecuteSaitoCached( this, outData, outExt, 
-                                                   static_cast<double *>(outPtr) );
+    case VTK_EDT_FELZENSZWALB:
+      {
+      vtkImageEuclideanDistanceThreadStruct str;
+      str.Filter = this;
+      str.OutData = outData;
+      str.OutPtr = static_cast<double *>(outPtr);
+      str.IndexPtr = indexPtr;
+      memcpy(str.Extent, outExt, 6*sizeof(int));
+      this->Threader->SetNumberOfThreads(this->NumberOfThreads);
+      this->Threader->SetSingleMethod(
+        vtkImageEuclideanDistanceThreadedExecute, &str);
+      this->Threader->SingleMethodExecute();
+      }
       break;
     default:
       vtkErrorMacro(<< "Execute: Unknown Algorithm");
@@ -668,16 +943,22 @@ int vtkImageEuclideanDistance::IterativeRequestData(
 // This method returns the number of peices resulting from a successful split.
 // This can be from 1 to "total".  
 // If 1 is returned, the extent cannot be split.
+// The threads of each pass call this method, so only piece 0, which the
+// multithreader runs in the calling thread, prints debug messages.
 int vtkImageEuclideanDistance::SplitExtent(int splitExt[6], int startExt[6], 
                              int num, int total)
 {
   int splitAxis;
   int min, max;
 
-  vtkDebugMacro("SplitExtent: ( " << startExt[0] << ", " << startExt[1] << ", "
-                << startExt[2] << ", " << startExt[3] << ", "
-                << startExt[4] << ", " << startExt[5] << "), " 
-                << num << " of " << total);
+  if (num == 0)
+    {
+    vtkDebugMacro("SplitExtent: ( " << startExt[0] << ", " 
+                  << startExt[1] << ", "
+                  << startExt[2] << ", " << startExt[3] << ", "
+                  << startExt[4] << ", " << startExt[5] << "), " 
+                  << num << " of " << total);
+    }
 
   // start with same extent
   memcpy(splitExt, startExt, 6 * sizeof(int));
@@ -690,7 +971,10 @@ int vtkImageEuclideanDistance::SplitExtent(int splitExt[6], int startExt[6],
     splitAxis--;
     if (splitAxis < 0)
       { // cannot split
-      vtkDebugMacro("  Cannot Split");
+      if (num == 0)
+        {
+        vtkDebugMacro("  Cannot Split");
+        }
       return 1;
       }
     min = startExt[splitAxis*2];
@@ -705,8 +989,6 @@ int vtkImageEuclideanDistance::SplitExtent(int splitExt[6], int startExt[6],
   
   if (num >= total)
     {
-    vtkDebugMacro("  SplitRequest (" << num 
-                  << ") larger than total: " << total);
     return total;
     }
   
@@ -721,9 +1003,13 @@ int vtkImageEuclideanDistance::SplitExtent(int splitExt[6], int startExt[6],
     splitExt[splitAxis*2+1] = (min-1) + (max - min + 1)*(num+1)/total;
     }
   
-  vtkDebugMacro("  Split Piece: ( " <<splitExt[0]<< ", " <<splitExt[1]<< ", "
-                << splitExt[2] << ", " << splitExt[3] << ", "
-                << splitExt[4] << ", " << splitExt[5] << ")");
+  if (num == 0)
+    {
+    vtkDebugMacro("  Split Piece: ( " <<splitExt[0]<< ", " 
+                  <<splitExt[1]<< ", "
+                  << splitExt[2] << ", " << splitExt[3] << ", "
+                  << splitExt[4] << ", " << splitExt[5] << ")");
+    }
 
   return total;
 }
@@ -746,10 +1032,17 @@ void vtkImageEuclideanDistance::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << "Saito\n";
     }
+  else if ( this->Algorithm == VTK_EDT_FELZENSZWALB )
+    {
+    os << "Felzenszwalb\n";
+    }
   else 
     {
     os << "Saito Cached\n";
     }
+
+  os << indent << "Compute Nearest Feature: " 
+     << (this->ComputeNearestFeature ? "On\n" : "Off\n");
 }
   
 
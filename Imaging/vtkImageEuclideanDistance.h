@@ -29,6 +29,15 @@
 // slow it very significantly. In that case, one should use 
 // ::SetAlgorithmToSaitoCached() instead for better performance. 
 //
+// ::SetAlgorithmToFelzenszwalb() selects the algorithm of Felzenszwalb
+// and Huttenlocher, which computes each pass in time linear in the
+// number of voxels whatever the distances, and can also record for
+// each voxel the point id of its nearest feature (see
+// ComputeNearestFeature). It is the algorithm of choice for large images.
+//
+// Each pass is computed by several threads, since the rows along the
+// axis of the pass are independent.
+//
 // References:
 //
 // T. Saito and J.I. Toriwaki. New algorithms for Euclidean distance 
@@ -38,6 +47,10 @@
 // O. Cuisenaire. Distance Transformation: fast algorithms and applications
 // to medical image processing. PhD Thesis, Universite catholique de Louvain,
 // October 1999. http://ltswww.epfl.ch/~cuisenai/papers/oc_thesis.pdf 
+//
+// P. F. Felzenszwalb and D. P. Huttenlocher. Distance Transforms of
+// Sampled Functions. Cornell Computing and Information Science
+// TR2004-1963, 2004.
  
 
 #ifndef __vtkImageEuclideanDistance_h
@@ -47,6 +60,7 @@
 
 #define VTK_EDT_SAITO_CACHED 0
 #define VTK_EDT_SAITO 1 
+#define VTK_EDT_FELZENSZWALB 2
 
 class VTK_IMAGING_EXPORT vtkImageEuclideanDistance : public vtkImageDecomposeFilter
 {
@@ -92,13 +106,26 @@ public:
   // Selects a Euclidean DT algorithm. 
   // 1. Saito
   // 2. Saito-cached 
-  // More algorithms will be added later on. 
+  // 3. Felzenszwalb (linear time)
   vtkSetMacro(Algorithm, int);
   vtkGetMacro(Algorithm, int);
   void SetAlgorithmToSaito () 
     { this->SetAlgorithm(VTK_EDT_SAITO); } 
   void SetAlgorithmToSaitoCached () 
     { this->SetAlgorithm(VTK_EDT_SAITO_CACHED); }   
+  void SetAlgorithmToFelzenszwalb () 
+    { this->SetAlgorithm(VTK_EDT_FELZENSZWALB); }   
+
+  // Description:
+  // When on, and the Felzenszwalb algorithm is used, the output point
+  // data also holds a vtkIdTypeArray named "NearestFeature" with, for
+  // each voxel, the point id of the voxel that its distance was
+  // measured to: the nearest zero voxel of the input when Initialize is
+  // on.  Voxels that are farther than MaximumDistance from any feature
+  // get -1.  Off by default.
+  vtkSetMacro(ComputeNearestFeature, int);
+  vtkGetMacro(ComputeNearestFeature, int);
+  vtkBooleanMacro(ComputeNearestFeature, int);
 
   virtual int IterativeRequestData(vtkInformation*,
                                    vtkInformationVector**,
@@ -112,9 +139,14 @@ protected:
   int Initialize;
   int ConsiderAnisotropy;
   int Algorithm;
+  int ComputeNearestFeature;
 
   // Replaces "EnlargeOutputUpdateExtent"
   virtual void AllocateOutputScalars(vtkImageData *outData);
+
+  // Get the "NearestFeature" array of the output for the current pass.
+  vtkIdType *GetNearestFeaturePointer(vtkImageData *inData,
+                                      vtkImageData *outData);
   
   virtual int IterativeRequestInformation(vtkInformation* in,
                                           vtkInformation* out);
@@ -23,6 +23,18 @@
 #include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+// Largest number of histogram bins for the histogram method, and
+// largest number of column histogram entries of all the threads together
+// (64 MB of counts), which is divided among the threads.
+#define VTK_MEDIAN3D_MAX_BINS 65536
+#define VTK_MEDIAN3D_MAX_HISTOGRAM_SIZE 16777216
+
+// Kernels with fewer elements than this are always sorted.
+#define VTK_MEDIAN3D_MIN_HISTOGRAM_ELEMENTS 10
+
 vtkStandardNewMacro(vtkImageMedian3D);
 
 //-----------------------------------------------------------------------------
@@ -30,6 +42,7 @@ vtkStandardNewMacro(vtkImageMedian3D);
 vtkImageMedian3D::vtkImageMedian3D()
 {
   this->NumberOfElements = 0;
+  this->Percentile = 0.5;
   this->SetKernelSize(1,1,1);
   this->HandleBoundaries = 1;
 }
@@ -45,6 +58,7 @@ void vtkImageMedian3D::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "NumberOfElements: " << this->NumberOfElements << endl;
+  os << indent << "Percentile: " << this->Percentile << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -213,6 +227,8 @@ void vtkImageMedian3DExecute(vtkImageMedian3D *self,
   int *inExt;
   unsigned long count = 0;
   unsigned long target;
+  double percentile = self->GetPercentile();
+  int numValues, rank;
 
   if (!inArray)
     {
@@ -292,6 +308,34 @@ void vtkImageMedian3DExecute(vtkImageMedian3D *self,
         {
         for (outIdxC = 0; outIdxC < numComp; outIdxC++)
           {
+          if (percentile != 0.5)
+            {
+            // Gather the neighborhood and select the requested rank
+            numValues = 0;
+            tmpPtr2 = inPtr0 + outIdxC;
+            for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
+              {
+              tmpPtr1 = tmpPtr2;
+              for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
+                {
+                tmpPtr0 = tmpPtr1;
+                for (hoodIdx0 = hoodMin0; hoodIdx0 <= hoodMax0; ++hoodIdx0)
+                  {
+                  Sort[numValues++] = double(*tmpPtr0);
+                  tmpPtr0 += inInc0;
+                  }
+                tmpPtr1 += inInc1;
+                }
+              tmpPtr2 += inInc2;
+              }
+            rank = static_cast<int>(percentile*numValues);
+            rank = (rank < numValues) ? rank : numValues - 1;
+            vtkstd::nth_element(Sort, Sort + rank, Sort + numValues);
+            *outPtr = static_cast<T>(Sort[rank]);
+            outPtr++;
+            continue;
+            }
+
           // Compute median of neighborhood
           // Note: For boundary, NumNeighborhood could be changed for
           // a faster sort.
@@ -365,6 +409,366 @@ void vtkImageMedian3DExecute(vtkImageMedian3D *self,
   delete [] Sort;
 }
 
+//-----------------------------------------------------------------------------
+// The histograms used to compute ranks in constant time.  There is one
+// histogram per column of the neighborhood (the pixels that share an x
+// index), and one for the neighborhood itself.  Each histogram has a
+// coarse level and a fine level; the coarse level of the neighborhood is
+// kept up to date as it slides along x, while each fine segment is only
+// brought up to date when the rank search needs it.
+class vtkImageMedian3DHistogram
+{
+public:
+  vtkImageMedian3DHistogram(int numColumns, int numBins)
+    {
+    // split the bins into about sqrt(numBins) coarse bins
+    this->Shift = 0;
+    while ((1 << (2*this->Shift)) < numBins)
+      {
+      ++this->Shift;
+      }
+    this->NumberOfCoarseBins = ((numBins - 1) >> this->Shift) + 1;
+    this->NumberOfFineBins = this->NumberOfCoarseBins << this->Shift;
+    this->ColumnCoarse.resize(numColumns*this->NumberOfCoarseBins);
+    this->ColumnFine.resize(numColumns*this->NumberOfFineBins);
+    this->Coarse.resize(this->NumberOfCoarseBins);
+    this->Fine.resize(this->NumberOfFineBins);
+    this->SegmentMin.resize(this->NumberOfCoarseBins);
+    this->SegmentMax.resize(this->NumberOfCoarseBins);
+    }
+
+  void AddToColumn(int column, int bin)
+    {
+    ++this->ColumnCoarse[column*this->NumberOfCoarseBins + 
+                         (bin >> this->Shift)];
+    ++this->ColumnFine[column*this->NumberOfFineBins + bin];
+    }
+
+  void RemoveFromColumn(int column, int bin)
+    {
+    --this->ColumnCoarse[column*this->NumberOfCoarseBins + 
+                         (bin >> this->Shift)];
+    --this->ColumnFine[column*this->NumberOfFineBins + bin];
+    }
+
+  // Empty the neighborhood histogram at the start of a row.
+  void StartRow()
+    {
+    vtkstd::fill(this->Coarse.begin(), this->Coarse.end(), 0);
+    vtkstd::fill(this->SegmentMin.begin(), this->SegmentMin.end(), 0);
+    vtkstd::fill(this->SegmentMax.begin(), this->SegmentMax.end(), -1);
+    }
+
+  // Add or remove a column to the coarse level of the neighborhood.
+  void AddColumn(int column)
+    {
+    int *colPtr = &this->ColumnCoarse[column*this->NumberOfCoarseBins];
+    for (int i = 0; i < this->NumberOfCoarseBins; ++i)
+      {
+      this->Coarse[i] += colPtr[i];
+      }
+    }
+  void RemoveColumn(int column)
+    {
+    int *colPtr = &this->ColumnCoarse[column*this->NumberOfCoarseBins];
+    for (int i = 0; i < this->NumberOfCoarseBins; ++i)
+      {
+      this->Coarse[i] -= colPtr[i];
+      }
+    }
+
+  // Return the bin that holds the value of the given rank, for the
+  // neighborhood made of columns colMin to colMax.  The neighborhood
+  // must only move towards larger columns between calls in one row.
+  int GetBinForRank(int rank, int colMin, int colMax)
+    {
+    int bin = 0;
+    int total = 0;
+    while (total + this->Coarse[bin] <= rank)
+      {
+      total += this->Coarse[bin++];
+      }
+
+    // bring the fine segment of this coarse bin up to date
+    int fineSize = 1 << this->Shift;
+    int *segPtr = &this->Fine[bin << this->Shift];
+    int *colPtr;
+    int i;
+    if (this->SegmentMax[bin] < colMin)
+      {
+      for (i = 0; i < fineSize; ++i)
+        {
+        segPtr[i] = 0;
+        }
+      this->SegmentMin[bin] = colMin;
+      this->SegmentMax[bin] = colMin - 1;
+      }
+    for (; this->SegmentMin[bin] < colMin; ++this->SegmentMin[bin])
+      {
+      colPtr = &this->ColumnFine[this->SegmentMin[bin]*this->NumberOfFineBins
+                                 + (bin << this->Shift)];
+      for (i = 0; i < fineSize; ++i)
+        {
+        segPtr[i] -= colPtr[i];
+        }
+      }
+    while (this->SegmentMax[bin] < colMax)
+      {
+      ++this->SegmentMax[bin];
+      colPtr = &this->ColumnFine[this->SegmentMax[bin]*this->NumberOfFineBins
+                                 + (bin << this->Shift)];
+      for (i = 0; i < fineSize; ++i)
+        {
+        segPtr[i] += colPtr[i];
+        }
+      }
+
+    i = 0;
+    while (total + segPtr[i] <= rank)
+      {
+      total += segPtr[i++];
+      }
+    return (bin << this->Shift) + i;
+    }
+
+protected:
+  int Shift;
+  int NumberOfCoarseBins;
+  int NumberOfFineBins;
+  vtkstd::vector<int> ColumnCoarse;
+  vtkstd::vector<int> ColumnFine;
+  vtkstd::vector<int> Coarse;
+  vtkstd::vector<int> Fine;
+  vtkstd::vector<int> SegmentMin;
+  vtkstd::vector<int> SegmentMax;
+};
+
+//-----------------------------------------------------------------------------
+// Add or remove one row (fixed y) of the neighborhood to the column
+// histograms.
+template <class T>
+void vtkImageMedian3DUpdateColumns(vtkImageMedian3DHistogram &histogram,
+                                   T *rowPtr, vtkIdType inInc0,
+                                   vtkIdType inInc2, int numColumns,
+                                   int numSlices, T minValue, int add)
+{
+  for (int idx2 = 0; idx2 < numSlices; ++idx2)
+    {
+    T *tmpPtr = rowPtr;
+    for (int column = 0; column < numColumns; ++column)
+      {
+      int bin = static_cast<int>(*tmpPtr - minValue);
+      if (add)
+        {
+        histogram.AddToColumn(column, bin);
+        }
+      else
+        {
+        histogram.RemoveFromColumn(column, bin);
+        }
+      tmpPtr += inInc0;
+      }
+    rowPtr += inInc2;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Compute the rank filter of one component with sliding histograms.
+// Returns 0 without doing anything if the range of the values is too
+// large for the histograms.
+template <class T>
+int vtkImageMedian3DHistogramExecute(vtkImageMedian3D *self,
+                                     vtkImageData *inData, T *inPtr, 
+                                     vtkImageData *outData, T *outPtr,
+                                     int outExt[6], int id, int outIdxC,
+                                     vtkDataArray *inArray)
+{
+  int *kernelMiddle = self->GetKernelMiddle();
+  int *kernelSize = self->GetKernelSize();
+  int *inExt = inData->GetExtent();
+  double percentile = self->GetPercentile();
+  vtkIdType inInc0, inInc1, inInc2;
+  vtkIdType outInc0, outInc1, outInc2;
+  int idx0, idx1, idx2, hoodMin[3], hoodMax[3], regionMin[3], regionMax[3];
+  int axis;
+
+  inData->GetIncrements(inInc0, inInc1, inInc2);
+  outData->GetIncrements(outInc0, outInc1, outInc2);
+
+  // The region of the input that is used by this piece of the output
+  for (axis = 0; axis < 3; ++axis)
+    {
+    regionMin[axis] = outExt[2*axis] - kernelMiddle[axis];
+    regionMax[axis] = outExt[2*axis+1] - kernelMiddle[axis] +
+      kernelSize[axis] - 1;
+    regionMin[axis] = (regionMin[axis] > inExt[2*axis]) ?
+      regionMin[axis] : inExt[2*axis];
+    regionMax[axis] = (regionMax[axis] < inExt[2*axis+1]) ?
+      regionMax[axis] : inExt[2*axis+1];
+    }
+  T *regionPtr = inPtr + outIdxC + 
+    (regionMin[0] - inExt[0])*inInc0 +
+    (regionMin[1] - inExt[2])*inInc1 +
+    (regionMin[2] - inExt[4])*inInc2;
+  int numColumns = regionMax[0] - regionMin[0] + 1;
+
+  // Find the range of the values in the region
+  T minValue = *regionPtr;
+  T maxValue = *regionPtr;
+  T *tmpPtr0, *tmpPtr1, *tmpPtr2 = regionPtr;
+  for (idx2 = regionMin[2]; idx2 <= regionMax[2]; ++idx2)
+    {
+    tmpPtr1 = tmpPtr2;
+    for (idx1 = regionMin[1]; idx1 <= regionMax[1]; ++idx1)
+      {
+      tmpPtr0 = tmpPtr1;
+      for (idx0 = regionMin[0]; idx0 <= regionMax[0]; ++idx0)
+        {
+        minValue = (*tmpPtr0 < minValue) ? *tmpPtr0 : minValue;
+        maxValue = (*tmpPtr0 > maxValue) ? *tmpPtr0 : maxValue;
+        tmpPtr0 += inInc0;
+        }
+      tmpPtr1 += inInc1;
+      }
+    tmpPtr2 += inInc2;
+    }
+  double numBins = static_cast<double>(maxValue) - 
+    static_cast<double>(minValue) + 1.0;
+  double maxSize = static_cast<double>(VTK_MEDIAN3D_MAX_HISTOGRAM_SIZE) /
+    self->GetNumberOfThreads();
+  if (numBins > VTK_MEDIAN3D_MAX_BINS || numBins*numColumns > maxSize)
+    {
+    return 0;
+    }
+
+  vtkImageMedian3DHistogram histogram(numColumns, 
+                                      static_cast<int>(numBins));
+  unsigned long count = 0;
+  unsigned long target = static_cast<unsigned long>(
+    (outExt[5] - outExt[4] + 1)*(outExt[3] - outExt[2] + 1)/50.0);
+  target++;
+
+  for (idx2 = outExt[4]; idx2 <= outExt[5]; ++idx2)
+    {
+    hoodMin[2] = idx2 - kernelMiddle[2];
+    hoodMax[2] = hoodMin[2] + kernelSize[2] - 1;
+    hoodMin[2] = (hoodMin[2] > inExt[4]) ? hoodMin[2] : inExt[4];
+    hoodMax[2] = (hoodMax[2] < inExt[5]) ? hoodMax[2] : inExt[5];
+    int numSlices = hoodMax[2] - hoodMin[2] + 1;
+    T *slicePtr = regionPtr + (hoodMin[2] - regionMin[2])*inInc2;
+
+    // the rows of the neighborhood currently in the column histograms,
+    // which are empty at the start of each slice
+    int columnMin1 = regionMin[1];
+    int columnMax1 = columnMin1 - 1;
+
+    for (idx1 = outExt[2]; !self->AbortExecute && idx1 <= outExt[3]; ++idx1)
+      {
+      if (!id) 
+        {
+        if (!(count%target))
+          {
+          self->UpdateProgress(count/(50.0*target));
+          }
+        count++;
+        }
+
+      hoodMin[1] = idx1 - kernelMiddle[1];
+      hoodMax[1] = hoodMin[1] + kernelSize[1] - 1;
+      hoodMin[1] = (hoodMin[1] > inExt[2]) ? hoodMin[1] : inExt[2];
+      hoodMax[1] = (hoodMax[1] < inExt[3]) ? hoodMax[1] : inExt[3];
+
+      // slide the column histograms down to this row
+      while (columnMin1 < hoodMin[1])
+        {
+        if (columnMin1 <= columnMax1)
+          {
+          vtkImageMedian3DUpdateColumns(
+            histogram, slicePtr + (columnMin1 - regionMin[1])*inInc1,
+            inInc0, inInc2, numColumns, numSlices, minValue, 0);
+          }
+        ++columnMin1;
+        }
+      columnMax1 = (columnMax1 > columnMin1 - 1) ? 
+        columnMax1 : columnMin1 - 1;
+      while (columnMax1 < hoodMax[1])
+        {
+        ++columnMax1;
+        vtkImageMedian3DUpdateColumns(
+          histogram, slicePtr + (columnMax1 - regionMin[1])*inInc1,
+          inInc0, inInc2, numColumns, numSlices, minValue, 1);
+        }
+
+      // slide the neighborhood along the row
+      int numRowValues = (hoodMax[1] - hoodMin[1] + 1)*numSlices;
+      int windowMin = 0;
+      int windowMax = -1;
+      histogram.StartRow();
+      T *outPtr0 = outPtr + outIdxC + (idx1 - outExt[2])*outInc1 +
+        (idx2 - outExt[4])*outInc2;
+      for (idx0 = outExt[0]; idx0 <= outExt[1]; ++idx0)
+        {
+        hoodMin[0] = idx0 - kernelMiddle[0];
+        hoodMax[0] = hoodMin[0] + kernelSize[0] - 1;
+        hoodMin[0] = (hoodMin[0] > inExt[0]) ? hoodMin[0] : inExt[0];
+        hoodMax[0] = (hoodMax[0] < inExt[1]) ? hoodMax[0] : inExt[1];
+        hoodMin[0] -= regionMin[0];
+        hoodMax[0] -= regionMin[0];
+        while (windowMax < hoodMax[0])
+          {
+          histogram.AddColumn(++windowMax);
+          }
+        while (windowMin < hoodMin[0])
+          {
+          histogram.RemoveColumn(windowMin++);
+          }
+
+        int numValues = (hoodMax[0] - hoodMin[0] + 1)*numRowValues;
+        int bin;
+        if (percentile != 0.5)
+          {
+          int rank = static_cast<int>(percentile*numValues);
+          rank = (rank < numValues) ? rank : numValues - 1;
+          bin = histogram.GetBinForRank(rank, hoodMin[0], hoodMax[0]);
+          }
+        else if (numValues % 2)
+          {
+          bin = histogram.GetBinForRank(numValues/2, hoodMin[0], hoodMax[0]);
+          }
+        else
+          {
+          // For an even count, the sorting median returns the median of
+          // all but the last value it visits, which is the lower middle
+          // value if the last value is above the upper middle one and
+          // the upper middle value otherwise.
+          bin = histogram.GetBinForRank(numValues/2, hoodMin[0], hoodMax[0]);
+          int lastBin = static_cast<int>(
+            slicePtr[hoodMax[0]*inInc0 + 
+                     (hoodMax[1] - regionMin[1])*inInc1 +
+                     (numSlices - 1)*inInc2] - minValue);
+          if (lastBin >= bin)
+            {
+            bin = histogram.GetBinForRank(numValues/2 - 1, 
+                                          hoodMin[0], hoodMax[0]);
+            }
+          }
+        *outPtr0 = static_cast<T>(minValue + bin);
+        outPtr0 += outInc0;
+        }
+      }
+
+    // empty the column histograms for the next slice
+    for (; columnMin1 <= columnMax1; ++columnMin1)
+      {
+      vtkImageMedian3DUpdateColumns(
+        histogram, slicePtr + (columnMin1 - regionMin[1])*inInc1,
+        inInc0, inInc2, numColumns, numSlices, minValue, 0);
+      }
+    }
+
+  return 1;
+}
+
 //-----------------------------------------------------------------------------
 // This method contains the first switch statement that calls the correct
 // templated function for the input and output region types.
@@ -396,6 +800,49 @@ void vtkImageMedian3D::ThreadedRequestData(
     return;
     }
   
+  // Use histograms for integer data when the kernel is large enough
+  int useHistogram = 0;
+  if (this->NumberOfElements >= VTK_MEDIAN3D_MIN_HISTOGRAM_ELEMENTS)
+    {
+    switch (inArray->GetDataType())
+      {
+      case VTK_CHAR:
+      case VTK_SIGNED_CHAR:
+      case VTK_UNSIGNED_CHAR:
+      case VTK_SHORT:
+      case VTK_UNSIGNED_SHORT:
+      case VTK_INT:
+      case VTK_UNSIGNED_INT:
+        useHistogram = 1;
+        break;
+      }
+    }
+
+  if (useHistogram)
+    {
+    int numComp = inArray->GetNumberOfComponents();
+    int comp;
+    for (comp = 0; comp < numComp; comp++)
+      {
+      switch (inArray->GetDataType())
+        {
+        vtkTemplateMacro(
+          useHistogram = vtkImageMedian3DHistogramExecute(
+            this, inData[0][0], static_cast<VTK_TT *>(inPtr),
+            outData[0], static_cast<VTK_TT *>(outPtr), outExt, id, comp,
+            inArray));
+        }
+      if (!useHistogram)
+        {
+        break;
+        }
+      }
+    if (useHistogram)
+      {
+      return;
+      }
+    }
+
   switch (inArray->GetDataType())
     {
     vtkTemplateMacro(
@@ -19,6 +19,20 @@
 // Neighborhoods can be no more than 3 dimensional.  Setting one
 // axis of the neighborhood kernelSize to 1 changes the filter
 // into a 2D median.  
+//
+// Other ranks than the median can be selected with SetPercentile(): a
+// percentile of 0 gives the minimum of the neighborhood (grayscale
+// erosion) and a percentile of 1 gives the maximum (dilation).
+//
+// For integer scalars with a moderate range of values, the rank is
+// found from sliding histograms of the neighborhood (Perreault and
+// Hebert, "Median Filtering in Constant Time"), so that the cost per
+// pixel does not grow with the size of the kernel in x and y.  Other
+// scalars, and small kernels, sort the neighborhood of each pixel.
+// The histograms of all the threads together hold at most 16M counts
+// (64 MB): each thread gets its share according to NumberOfThreads, and
+// a piece whose range of values times its width in x would need more
+// falls back to sorting.
 
 
 #ifndef __vtkImageMedian3D_h
@@ -43,11 +57,19 @@ public:
   // Return the number of elements in the median mask
   vtkGetMacro(NumberOfElements,int);
 
+  // Description:
+  // The rank of the value that replaces each pixel, as a fraction of
+  // the number of pixels in the neighborhood.  The default of 0.5 gives
+  // the median, 0 the minimum and 1 the maximum.
+  vtkSetClampMacro(Percentile,double,0.0,1.0);
+  vtkGetMacro(Percentile,double);
+
 protected:
   vtkImageMedian3D();
   ~vtkImageMedian3D();
 
   int NumberOfElements;
+  double Percentile;
 
   void ThreadedRequestData(vtkInformation *request,
                            vtkInformationVector **inputVector,
@@ -485,5 +485,26 @@ int TestGraph(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
   TestGraphDeletion(errors);
   cerr << "... done." << endl;
 
+  cerr << "Testing frozen graphs ..." << endl;
+  // dg shares the structure of t, and ug the structure of mug.
+  t->Freeze();
+  ug->Freeze();
+  if (!dg->IsFrozen() || !mug->IsFrozen())
+    {
+    cerr << "ERROR: Graphs sharing a structure should be frozen together." << endl;
+    ++errors;
+    }
+  TestGraphIterators(t, errors);
+  TestGraphIterators(dg, errors);
+  TestGraphIterators(ug, errors);
+  mug->AddEdge(8, 9);
+  if (mug->IsFrozen() || !ug->IsFrozen() || ug->GetNumberOfEdges() != 9 ||
+      mug->GetNumberOfEdges() != 10 || mug->GetDegree(8) != 1)
+    {
+    cerr << "ERROR: Modifying a frozen graph failed." << endl;
+    ++errors;
+    }
+  cerr << "... done." << endl;
+
   return errors;
 }
@@ -17,6 +17,7 @@
   Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
   the U.S. Government retains certain rights in this software.
 -------------------------------------------------------------------------*/
+#include "vtkBarnesHutLayoutStrategy.h"
 #include "vtkCircularLayoutStrategy.h"
 #include "vtkEdgeListIterator.h"
 #include "vtkFast2DLayoutStrategy.h"
@@ -24,6 +25,7 @@
 #include "vtkGraphLayout.h"
 #include "vtkMath.h"
 #include "vtkPassThroughLayoutStrategy.h"
+#include "vtkPoints.h"
 #include "vtkRandomGraphSource.h"
 #include "vtkRandomLayoutStrategy.h"
 #include "vtkSimple2DLayoutStrategy.h"
@@ -34,6 +36,34 @@
 #define VTK_CREATE(type, name) \
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
+// Lay out the output of source with strategy and copy the resulting points.
+static void LayoutPoints(vtkAlgorithm *source,
+                         vtkGraphLayoutStrategy *strategy, vtkPoints *points)
+{
+  VTK_CREATE(vtkGraphLayout, layout);
+  layout->SetInputConnection(source->GetOutputPort());
+  layout->SetLayoutStrategy(strategy);
+  layout->Update();
+  points->DeepCopy(layout->GetOutput()->GetPoints());
+}
+
+static double MaximumDifference(vtkPoints *a, vtkPoints *b)
+{
+  double maximum = 0.0;
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); i++)
+    {
+    double pa[3], pb[3];
+    a->GetPoint(i, pa);
+    b->GetPoint(i, pb);
+    for (int j = 0; j < 3; j++)
+      {
+      double d = fabs(pa[j] - pb[j]);
+      maximum = d > maximum ? d : maximum;
+      }
+    }
+  return maximum;
+}
+
 int TestGraphLayoutStrategy(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
   int errors = 0;
@@ -202,6 +232,78 @@ int TestGraphLayoutStrategy(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
       }
     }
   cerr << "...done." << endl;
-    
+
+  cerr << "Testing vtkBarnesHutLayoutStrategy..." << endl;
+  // Enough vertices for the repulsion to be split among four threads.
+  VTK_CREATE(vtkRandomGraphSource, bigSource);
+  bigSource->SetNumberOfVertices(4096);
+  bigSource->SetNumberOfEdges(8192);
+  VTK_CREATE(vtkPoints, exact);
+  VTK_CREATE(vtkPoints, points);
+
+  // With Theta 0 no cell is taken as a whole, so an iteration is the one of
+  // vtkSimple2DLayoutStrategy, up to the rounding of its float sums.
+  // Later iterations amplify the rounding, so only the first is compared.
+  VTK_CREATE(vtkSimple2DLayoutStrategy, simpleOnce);
+  simpleOnce->SetMaxNumberOfIterations(1);
+  simpleOnce->SetIterationsPerLayout(1);
+  LayoutPoints(bigSource, simpleOnce, points);
+  VTK_CREATE(vtkBarnesHutLayoutStrategy, barnesHut);
+  barnesHut->SetMaxNumberOfIterations(1);
+  barnesHut->SetIterationsPerLayout(1);
+  barnesHut->SetNumberOfThreads(4);
+  barnesHut->SetTheta(0.0);
+  LayoutPoints(bigSource, barnesHut, exact);
+  double difference = MaximumDifference(exact, points);
+  if (difference > 5.0e-6)
+    {
+    cerr << "ERROR: With Theta 0 a point is " << difference
+         << " away from vtkSimple2DLayoutStrategy" << endl;
+    errors++;
+    }
+
+  // The default Theta approximates the forces of the same iteration.
+  barnesHut->SetTheta(0.8);
+  LayoutPoints(bigSource, barnesHut, points);
+  difference = MaximumDifference(exact, points);
+  if (difference > 1.0e-3)
+    {
+    cerr << "ERROR: With Theta 0.8 a point is " << difference
+         << " away from the exact layout" << endl;
+    errors++;
+    }
+
+  // Every thread computes the forces on its vertices in the same order as
+  // a single thread would, so the layout does not depend on the number of
+  // threads.
+  barnesHut->SetMaxNumberOfIterations(20);
+  barnesHut->SetIterationsPerLayout(20);
+  for (int threeD = 0; threeD < 2; threeD++)
+    {
+    barnesHut->SetThreeDimensionalLayout(threeD);
+    barnesHut->SetNumberOfThreads(1);
+    LayoutPoints(bigSource, barnesHut, exact);
+    barnesHut->SetNumberOfThreads(4);
+    LayoutPoints(bigSource, barnesHut, points);
+    difference = MaximumDifference(exact, points);
+    if (difference != 0.0)
+      {
+      cerr << "ERROR: The " << (threeD ? "3D" : "2D") << " layout with four "
+           << "threads differs by " << difference << " from one thread"
+           << endl;
+      errors++;
+      }
+    for (vtkIdType i = 0; !threeD && i < points->GetNumberOfPoints(); i++)
+      {
+      if (points->GetPoint(i)[2] != 0.0)
+        {
+        cerr << "ERROR: Point " << i << " not on the xy plane" << endl;
+        errors++;
+        break;
+        }
+      }
+    }
+  cerr << "...done." << endl;
+
   return errors;
 }
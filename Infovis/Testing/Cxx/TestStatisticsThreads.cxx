@@ -0,0 +1,202 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStatisticsThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the threaded Learn option of the descriptive and
+// correlative statistics
+// .SECTION Description
+// Learns the statistics of a table large enough to be split among four
+// threads, with one and with four threads. The primary and derived
+// statistics must agree up to round-off. The descriptive statistics of a
+// variant copy of a column, which takes the serial variant path, must
+// agree with those of the numeric column.
+
+#include "vtkCorrelativeStatistics.h"
+#include "vtkDescriptiveStatistics.h"
+#include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkSmartPointer.h"
+#include "vtkTable.h"
+#include "vtkVariantArray.h"
+
+#include <math.h>
+
+//----------------------------------------------------------------------------
+static int CompareValues(double a, double b)
+{
+  double scale = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
+  return fabs(a - b) <= 1e-9*(scale > 1. ? scale : 1.);
+}
+
+//----------------------------------------------------------------------------
+// Compares row rowA of a with row rowB of b, column by column.
+static int CompareRows(vtkTable *a, vtkIdType rowA, vtkTable *b,
+                       vtkIdType rowB)
+{
+  if (a->GetNumberOfColumns() != b->GetNumberOfColumns())
+    {
+    return 0;
+    }
+  for (vtkIdType c = 0; c < a->GetNumberOfColumns(); c++)
+    {
+    vtkVariant valueA = a->GetValue(rowA, c);
+    vtkVariant valueB = b->GetValue(rowB, c);
+    if (valueA.IsString())
+      {
+      continue;
+      }
+    if (!CompareValues(valueA.ToDouble(), valueB.ToDouble()))
+      {
+      cerr << a->GetColumnName(c) << " is " << valueA.ToDouble()
+           << " and " << valueB.ToDouble() << ".\n";
+      return 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+static int CompareModels(vtkMultiBlockDataSet *a, vtkMultiBlockDataSet *b)
+{
+  if (a->GetNumberOfBlocks() != b->GetNumberOfBlocks())
+    {
+    return 0;
+    }
+  for (unsigned int i = 0; i < a->GetNumberOfBlocks(); i++)
+    {
+    vtkTable *tableA = vtkTable::SafeDownCast(a->GetBlock(i));
+    vtkTable *tableB = vtkTable::SafeDownCast(b->GetBlock(i));
+    if (!tableA || !tableB ||
+        tableA->GetNumberOfRows() != tableB->GetNumberOfRows())
+      {
+      return 0;
+      }
+    for (vtkIdType r = 0; r < tableA->GetNumberOfRows(); r++)
+      {
+      if (!CompareRows(tableA, r, tableB, r))
+        {
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+static vtkMultiBlockDataSet *GetModel(vtkStatisticsAlgorithm *algorithm)
+{
+  return vtkMultiBlockDataSet::SafeDownCast(
+    algorithm->GetOutputDataObject(vtkStatisticsAlgorithm::OUTPUT_MODEL));
+}
+
+//----------------------------------------------------------------------------
+int TestStatisticsThreads(int, char *[])
+{
+  // four times the number of rows below which fewer threads are used
+  const vtkIdType numRows = 4*65536 + 17;
+
+  vtkSmartPointer<vtkDoubleArray> x = vtkSmartPointer<vtkDoubleArray>::New();
+  x->SetName("x");
+  x->SetNumberOfTuples(numRows);
+  vtkSmartPointer<vtkIntArray> n = vtkSmartPointer<vtkIntArray>::New();
+  n->SetName("n");
+  n->SetNumberOfTuples(numRows);
+  vtkSmartPointer<vtkVariantArray> xv =
+    vtkSmartPointer<vtkVariantArray>::New();
+  xv->SetName("xv");
+  xv->SetNumberOfTuples(numRows);
+  unsigned int seed = 1234;
+  for (vtkIdType i = 0; i < numRows; i++)
+    {
+    seed = seed*1103515245 + 12345;
+    double value = 1000. + ((seed >> 8) % 100000)*0.01 + i*1e-4;
+    x->SetValue(i, value);
+    xv->SetValue(i, vtkVariant(value));
+    n->SetValue(i, static_cast<int>((seed >> 16) % 251) - 125);
+    }
+  vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+  table->AddColumn(x);
+  table->AddColumn(n);
+  table->AddColumn(xv);
+
+  int rval = 0;
+
+  // descriptive statistics
+  vtkSmartPointer<vtkDescriptiveStatistics> ds[2];
+  for (int i = 0; i < 2; i++)
+    {
+    ds[i] = vtkSmartPointer<vtkDescriptiveStatistics>::New();
+    ds[i]->SetInput(vtkStatisticsAlgorithm::INPUT_DATA, table);
+    ds[i]->AddColumn("x");
+    ds[i]->AddColumn("n");
+    ds[i]->AddColumn("xv");
+    ds[i]->SetLearnOption(true);
+    ds[i]->SetDeriveOption(true);
+    ds[i]->SetAssessOption(false);
+    ds[i]->SetTestOption(false);
+    ds[i]->SetNumberOfThreads(i == 0 ? 1 : 4);
+    ds[i]->Update();
+    }
+  if (!CompareModels(GetModel(ds[0]), GetModel(ds[1])))
+    {
+    cerr << "The descriptive statistics differ with four threads.\n";
+    rval = 1;
+    }
+
+  // the variant column takes the serial path; find the rows of x and xv
+  vtkTable *primary = vtkTable::SafeDownCast(GetModel(ds[1])->GetBlock(0));
+  vtkIdType rowX = -1;
+  vtkIdType rowXV = -1;
+  for (vtkIdType r = 0; primary && r < primary->GetNumberOfRows(); r++)
+    {
+    vtkStdString name = primary->GetValueByName(r, "Variable").ToString();
+    if (name == "x")
+      {
+      rowX = r;
+      }
+    else if (name == "xv")
+      {
+      rowXV = r;
+      }
+    }
+  if (rowX < 0 || rowXV < 0 || !CompareRows(primary, rowX, primary, rowXV))
+    {
+    cerr << "The threaded descriptive statistics differ from the serial "
+         << "variant path.\n";
+    rval = 1;
+    }
+
+  // correlative statistics
+  vtkSmartPointer<vtkCorrelativeStatistics> cs[2];
+  for (int i = 0; i < 2; i++)
+    {
+    cs[i] = vtkSmartPointer<vtkCorrelativeStatistics>::New();
+    cs[i]->SetInput(vtkStatisticsAlgorithm::INPUT_DATA, table);
+    cs[i]->AddColumnPair("x", "n");
+    cs[i]->AddColumnPair("n", "x");
+    cs[i]->SetLearnOption(true);
+    cs[i]->SetDeriveOption(true);
+    cs[i]->SetAssessOption(false);
+    cs[i]->SetTestOption(false);
+    cs[i]->SetNumberOfThreads(i == 0 ? 1 : 4);
+    cs[i]->Update();
+    }
+  if (!CompareModels(GetModel(cs[0]), GetModel(cs[1])))
+    {
+    cerr << "The correlative statistics differ with four threads.\n";
+    rval = 1;
+    }
+
+  return rval;
+}
@@ -0,0 +1,655 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBarnesHutLayoutStrategy.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkBarnesHutLayoutStrategy.h"
+
+#include "vtkCommand.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkEdgeListIterator.h"
+#include "vtkFloatArray.h"
+#include "vtkGraph.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/vector>
+
+vtkStandardNewMacro(vtkBarnesHutLayoutStrategy);
+
+// Cells holding this many vertices or less are not subdivided.
+static const vtkIdType vtkBarnesHutLeafSize = 8;
+
+// Cells are not subdivided below this depth, which bounds the tree when
+// many vertices are coincident.
+static const int vtkBarnesHutMaximumDepth = 32;
+
+// Below this many vertices per thread, starting threads does not pay off.
+static const vtkIdType vtkBarnesHutMinimumVerticesPerThread = 1024;
+
+// Same softening as vtkSimple2DLayoutStrategy, avoids divide by zero.
+static const double vtkBarnesHutEpsilon = 1e-5;
+
+// Cool-down function.
+static inline float CoolDown(float t, float r)
+{
+  return t-(t/r);
+}
+
+// ----------------------------------------------------------------------
+// A cell of the quadtree or octree. Leaves refer to the range
+// [Begin, End) of the vertex ordering, other cells to their
+// NumberOfChildren non-empty children, stored next to each other
+// from FirstChild on.
+struct vtkBarnesHutNode
+{
+  double MassCenter[3];
+  double Mass;
+  double Size;
+  vtkIdType FirstChild;
+  int NumberOfChildren;
+  vtkIdType Begin;
+  vtkIdType End;
+};
+
+class vtkBarnesHutLayoutStrategyInternals
+{
+public:
+  vtkstd::vector<vtkBarnesHutNode> Nodes;
+  vtkstd::vector<vtkIdType> Order;
+  vtkstd::vector<vtkIdType> Scratch;
+  vtkstd::vector<double> Force;
+  int Dimension;
+};
+
+struct vtkBarnesHutThreadStruct
+{
+  vtkBarnesHutLayoutStrategyInternals *Internals;
+  const float *Points;
+  vtkIdType NumberOfVertices;
+  double ThetaSquared;
+};
+
+// ----------------------------------------------------------------------
+static inline int vtkBarnesHutCellIndex(const float *x, const double center[3],
+                                        int dimension)
+{
+  int cell = 0;
+  for (int i = 0; i < dimension; ++i)
+    {
+    if (x[i] >= center[i])
+      {
+      cell |= 1 << i;
+      }
+    }
+  return cell;
+}
+
+// ----------------------------------------------------------------------
+// Subdivide the cell nodeId, whose vertices are already set, and compute
+// its mass and center of mass.
+static void vtkBarnesHutBuildNode(vtkBarnesHutLayoutStrategyInternals *internals,
+                                  const float *points, vtkIdType nodeId,
+                                  const double center[3], double size,
+                                  int depth)
+{
+  int dimension = internals->Dimension;
+  vtkIdType begin = internals->Nodes[nodeId].Begin;
+  vtkIdType end = internals->Nodes[nodeId].End;
+  vtkIdType *order = &internals->Order[0];
+  internals->Nodes[nodeId].Size = size;
+
+  if (end - begin <= vtkBarnesHutLeafSize || depth >= vtkBarnesHutMaximumDepth)
+    {
+    double massCenter[3] = {0, 0, 0};
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      const float *x = points + 3*order[i];
+      for (int j = 0; j < dimension; ++j)
+        {
+        massCenter[j] += x[j];
+        }
+      }
+    vtkBarnesHutNode &node = internals->Nodes[nodeId];
+    node.Mass = static_cast<double>(end - begin);
+    for (int j = 0; j < 3; ++j)
+      {
+      node.MassCenter[j] = massCenter[j] / node.Mass;
+      }
+    node.FirstChild = -1;
+    node.NumberOfChildren = 0;
+    return;
+    }
+
+  // Sort the vertices of the cell by child cell.
+  int numCells = 1 << dimension;
+  vtkIdType offsets[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    ++offsets[1 + vtkBarnesHutCellIndex(points + 3*order[i], center, dimension)];
+    }
+  int numChildren = 0;
+  for (int c = 0; c < numCells; ++c)
+    {
+    numChildren += offsets[c + 1] > 0;
+    offsets[c + 1] += offsets[c];
+    }
+  vtkIdType *scratch = &internals->Scratch[0];
+  vtkIdType fill[8];
+  for (int c = 0; c < numCells; ++c)
+    {
+    fill[c] = begin + offsets[c];
+    }
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    int c = vtkBarnesHutCellIndex(points + 3*order[i], center, dimension);
+    scratch[fill[c]++] = order[i];
+    }
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    order[i] = scratch[i];
+    }
+
+  // Children of a cell are stored next to each other.
+  vtkIdType firstChild = static_cast<vtkIdType>(internals->Nodes.size());
+  internals->Nodes.resize(firstChild + numChildren);
+  internals->Nodes[nodeId].FirstChild = firstChild;
+  internals->Nodes[nodeId].NumberOfChildren = numChildren;
+
+  double quarter = size / 4.0;
+  double mass = 0;
+  double massCenter[3] = {0, 0, 0};
+  vtkIdType child = firstChild;
+  for (int c = 0; c < numCells; ++c)
+    {
+    if (offsets[c + 1] == offsets[c])
+      {
+      continue;
+      }
+    internals->Nodes[child].Begin = begin + offsets[c];
+    internals->Nodes[child].End = begin + offsets[c + 1];
+    double childCenter[3] = {center[0], center[1], center[2]};
+    for (int j = 0; j < dimension; ++j)
+      {
+      childCenter[j] += (c & (1 << j)) ? quarter : -quarter;
+      }
+    vtkBarnesHutBuildNode(internals, points, child, childCenter,
+                          size / 2.0, depth + 1);
+
+    const vtkBarnesHutNode &childNode = internals->Nodes[child];
+    mass += childNode.Mass;
+    for (int j = 0; j < 3; ++j)
+      {
+      massCenter[j] += childNode.Mass * childNode.MassCenter[j];
+      }
+    ++child;
+    }
+
+  vtkBarnesHutNode &node = internals->Nodes[nodeId];
+  node.Mass = mass;
+  for (int j = 0; j < 3; ++j)
+    {
+    node.MassCenter[j] = massCenter[j] / mass;
+    }
+}
+
+// ----------------------------------------------------------------------
+// Each thread computes the repulsion on one contiguous range of vertices.
+// The tree is only read, and every thread writes the forces of its own
+// vertices, so no locking is needed.
+static VTK_THREAD_RETURN_TYPE vtkBarnesHutRepulsionThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkBarnesHutThreadStruct *str =
+    static_cast<vtkBarnesHutThreadStruct*>(info->UserData);
+  vtkBarnesHutLayoutStrategyInternals *internals = str->Internals;
+  int tid = info->ThreadID;
+  int nThreads = info->NumberOfThreads;
+
+  vtkIdType begin = str->NumberOfVertices * tid / nThreads;
+  vtkIdType end = str->NumberOfVertices * (tid + 1) / nThreads;
+
+  const float *points = str->Points;
+  const vtkBarnesHutNode *nodes = &internals->Nodes[0];
+  const vtkIdType *order = &internals->Order[0];
+  double *force = &internals->Force[0];
+  int dimension = internals->Dimension;
+  double thetaSquared = str->ThetaSquared;
+
+  // Every level of the tree pushes at most eight cells.
+  vtkIdType stack[8 * (vtkBarnesHutMaximumDepth + 1)];
+  double delta[3];
+  double disSquared;
+  for (vtkIdType v = begin; v < end; ++v)
+    {
+    const float *x = points + 3*v;
+    double f[3] = {0, 0, 0};
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+      {
+      const vtkBarnesHutNode &node = nodes[stack[--top]];
+      if (node.FirstChild < 0)
+        {
+        for (vtkIdType i = node.Begin; i < node.End; ++i)
+          {
+          vtkIdType u = order[i];
+          // Don't repulse against yourself :)
+          if (u == v)
+            {
+            continue;
+            }
+          const float *y = points + 3*u;
+          disSquared = vtkBarnesHutEpsilon;
+          for (int j = 0; j < dimension; ++j)
+            {
+            delta[j] = x[j] - y[j];
+            disSquared += delta[j]*delta[j];
+            }
+          for (int j = 0; j < dimension; ++j)
+            {
+            f[j] += delta[j] / disSquared;
+            }
+          }
+        continue;
+        }
+
+      disSquared = 0;
+      for (int j = 0; j < dimension; ++j)
+        {
+        delta[j] = x[j] - node.MassCenter[j];
+        disSquared += delta[j]*delta[j];
+        }
+      if (node.Size * node.Size < thetaSquared * disSquared)
+        {
+        // Far enough away: the whole cell acts as one heavy vertex.
+        disSquared += vtkBarnesHutEpsilon;
+        for (int j = 0; j < dimension; ++j)
+          {
+          f[j] += node.Mass * delta[j] / disSquared;
+          }
+        }
+      else
+        {
+        for (int c = 0; c < node.NumberOfChildren; ++c)
+          {
+          stack[top++] = node.FirstChild + c;
+          }
+        }
+      }
+    for (int j = 0; j < 3; ++j)
+      {
+      force[3*v + j] = f[j];
+      }
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+// ----------------------------------------------------------------------
+
+vtkBarnesHutLayoutStrategy::vtkBarnesHutLayoutStrategy()
+{
+  this->Internals = new vtkBarnesHutLayoutStrategyInternals;
+  this->Threader = vtkMultiThreader::New();
+
+  this->RandomSeed = 123;
+  this->IterationsPerLayout = 200;
+  this->InitialTemperature = 1;
+  this->CoolDownRate = 50.0;
+  this->LayoutComplete = 0;
+  this->EdgeWeightField = 0;
+  this->SetEdgeWeightField("weight");
+  this->RestDistance = 0;
+  this->Jitter = true;
+  this->MaxNumberOfIterations = 200;
+  this->Theta = 0.8;
+  this->ThreeDimensionalLayout = 0;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  this->EdgeArray = 0;
+}
+
+// ----------------------------------------------------------------------
+
+vtkBarnesHutLayoutStrategy::~vtkBarnesHutLayoutStrategy()
+{
+  this->SetEdgeWeightField(0);
+  this->Threader->Delete();
+  delete this->Internals;
+  if (this->EdgeArray)
+    {
+    delete [] this->EdgeArray;
+    this->EdgeArray = NULL;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+// Set the graph that will be laid out
+void vtkBarnesHutLayoutStrategy::Initialize()
+{
+  vtkMath::RandomSeed(this->RandomSeed);
+
+  // Set up some quick access variables
+  vtkPoints *pts = this->Graph->GetPoints();
+  vtkIdType numVertices = this->Graph->GetNumberOfVertices();
+  vtkIdType numEdges = this->Graph->GetNumberOfEdges();
+
+  // Make sure output point type is float
+  if (pts->GetData()->GetDataType() != VTK_FLOAT)
+    {
+    vtkErrorMacro("Layout strategy expects to have points of type float");
+    this->LayoutComplete = 1;
+    return;
+    }
+
+  // Get a quick pointer to the point data
+  vtkFloatArray *array = vtkFloatArray::SafeDownCast(pts->GetData());
+  float *rawPointData = array->GetPointer(0);
+
+  // Avoid divide by zero
+  float div = 1;
+  if (numVertices > 0)
+    {
+    div = static_cast<float>(numVertices);
+    }
+
+  // The optimal distance between vertices.
+  if (this->RestDistance == 0)
+    {
+    this->RestDistance = 1.0/div;
+    }
+
+  // Put the edge data into compact, fast access edge data structure
+  if (this->EdgeArray)
+    {
+    delete [] this->EdgeArray;
+    this->EdgeArray = NULL;
+    }
+  this->EdgeArray =  new vtkLayoutEdge[numEdges];
+
+  // If jitter then do it now at initialization
+  int dimension = this->ThreeDimensionalLayout ? 3 : 2;
+  if (this->Jitter)
+    {
+    for (vtkIdType i=0; i<numVertices*3; i+=3)
+      {
+      for (int j = 0; j < dimension; ++j)
+        {
+        rawPointData[i+j] += this->RestDistance*(vtkMath::Random() - .5);
+        }
+      }
+    }
+
+  // Get the weight array
+  vtkDataArray* weightArray = NULL;
+  double weight, maxWeight = 1;
+  if (this->WeightEdges && this->EdgeWeightField != NULL)
+    {
+    weightArray = vtkDataArray::SafeDownCast(this->Graph->GetEdgeData()->GetAbstractArray(this->EdgeWeightField));
+    if (weightArray != NULL)
+      {
+      for (vtkIdType w = 0; w < weightArray->GetNumberOfTuples(); w++)
+        {
+        weight = weightArray->GetTuple1(w);
+        if (weight > maxWeight)
+          {
+          maxWeight = weight;
+          }
+        }
+      }
+    }
+
+  // Load up the edge data structures
+  vtkSmartPointer<vtkEdgeListIterator> edges =
+    vtkSmartPointer<vtkEdgeListIterator>::New();
+  this->Graph->GetEdges(edges);
+  while (edges->HasNext())
+    {
+    vtkEdgeType e = edges->Next();
+    this->EdgeArray[e.Id].from = e.Source;
+    this->EdgeArray[e.Id].to = e.Target;
+    if (weightArray != NULL)
+      {
+      weight = weightArray->GetTuple1(e.Id);
+      this->EdgeArray[e.Id].weight = weight / maxWeight;
+      }
+    else
+      {
+      this->EdgeArray[e.Id].weight = 1.0;
+      }
+    }
+
+  // Set up the tree and force buffers
+  this->Internals->Dimension = dimension;
+  this->Internals->Order.resize(numVertices);
+  this->Internals->Scratch.resize(numVertices);
+  this->Internals->Force.resize(3*numVertices);
+
+  // Set some vars
+  this->TotalIterations = 0;
+  this->LayoutComplete = 0;
+  this->Temp = this->InitialTemperature;
+}
+
+// ----------------------------------------------------------------------
+
+void vtkBarnesHutLayoutStrategy::BuildTree(const float *points,
+                                           vtkIdType numVertices)
+{
+  vtkBarnesHutLayoutStrategyInternals *internals = this->Internals;
+  int dimension = internals->Dimension;
+
+  // The root is the bounding cube (or square) of the vertices.
+  double bounds[6] = {0, 0, 0, 0, 0, 0};
+  for (int j = 0; j < dimension; ++j)
+    {
+    bounds[2*j] = VTK_DOUBLE_MAX;
+    bounds[2*j+1] = -VTK_DOUBLE_MAX;
+    }
+  for (vtkIdType i = 0; i < numVertices; ++i)
+    {
+    const float *x = points + 3*i;
+    for (int j = 0; j < dimension; ++j)
+      {
+      if (x[j] < bounds[2*j])
+        {
+        bounds[2*j] = x[j];
+        }
+      if (x[j] > bounds[2*j+1])
+        {
+        bounds[2*j+1] = x[j];
+        }
+      }
+    }
+  double size = 0;
+  double center[3] = {0, 0, 0};
+  for (int j = 0; j < dimension; ++j)
+    {
+    center[j] = (bounds[2*j] + bounds[2*j+1]) / 2.0;
+    if (bounds[2*j+1] - bounds[2*j] > size)
+      {
+      size = bounds[2*j+1] - bounds[2*j];
+      }
+    }
+  if (size == 0)
+    {
+    size = 1;
+    }
+
+  for (vtkIdType i = 0; i < numVertices; ++i)
+    {
+    internals->Order[i] = i;
+    }
+  internals->Nodes.clear();
+  internals->Nodes.resize(1);
+  internals->Nodes[0].Begin = 0;
+  internals->Nodes[0].End = numVertices;
+  vtkBarnesHutBuildNode(internals, points, 0, center, size, 0);
+}
+
+// ----------------------------------------------------------------------
+
+// Barnes-Hut graph layout method
+void vtkBarnesHutLayoutStrategy::Layout()
+{
+  // Do I have a graph to layout
+  if (this->Graph == NULL)
+    {
+    vtkErrorMacro("Graph Layout called with Graph==NULL, call SetGraph(g) first");
+    this->LayoutComplete = 1;
+    return;
+    }
+
+  // Set up some variables
+  vtkPoints* pts = this->Graph->GetPoints();
+  vtkIdType numVertices = this->Graph->GetNumberOfVertices();
+  vtkIdType numEdges = this->Graph->GetNumberOfEdges();
+  if (numVertices == 0)
+    {
+    this->LayoutComplete = 1;
+    return;
+    }
+
+  // Get a quick pointer to the point data
+  vtkFloatArray *array = vtkFloatArray::SafeDownCast(pts->GetData());
+  float *rawPointData = array->GetPointer(0);
+  int dimension = this->Internals->Dimension;
+
+  vtkIdType nThreads = numVertices / vtkBarnesHutMinimumVerticesPerThread;
+  if (nThreads > this->NumberOfThreads)
+    {
+    nThreads = this->NumberOfThreads;
+    }
+  if (nThreads < 1)
+    {
+    nThreads = 1;
+    }
+
+  vtkBarnesHutThreadStruct str;
+  str.Internals = this->Internals;
+  str.Points = rawPointData;
+  str.NumberOfVertices = numVertices;
+  str.ThetaSquared = this->Theta * this->Theta;
+  this->Threader->SetNumberOfThreads(static_cast<int>(nThreads));
+  this->Threader->SetSingleMethod(vtkBarnesHutRepulsionThread, &str);
+
+  double delta[3] = {0, 0, 0};
+  double disSquared;
+  double attractValue;
+  double epsilon = 1e-5;
+  for(int i = 0; i < this->IterationsPerLayout; ++i)
+    {
+    // Calculate the repulsive forces
+    this->BuildTree(rawPointData, numVertices);
+    this->Threader->SingleMethodExecute();
+
+    // Calculate the attractive forces
+    double *force = &this->Internals->Force[0];
+    for (vtkIdType j=0; j<numEdges; ++j)
+      {
+      vtkIdType pointIndex1 = this->EdgeArray[j].to * 3;
+      vtkIdType pointIndex2 = this->EdgeArray[j].from * 3;
+
+      // No need to attract points to themselves
+      if (pointIndex1 == pointIndex2) continue;
+
+      disSquared = 0;
+      for (int k = 0; k < dimension; ++k)
+        {
+        delta[k] = rawPointData[pointIndex1+k] - rawPointData[pointIndex2+k];
+        disSquared += delta[k]*delta[k];
+        }
+
+      // Perform weight adjustment
+      attractValue = this->EdgeArray[j].weight*disSquared-this->RestDistance;
+
+      for (int k = 0; k < dimension; ++k)
+        {
+        force[pointIndex1+k] -= delta[k] * attractValue;
+        force[pointIndex2+k] += delta[k] * attractValue;
+        }
+      }
+
+    // Okay now set new positions based on replusion
+    // and attraction 'forces'
+    for(vtkIdType j=0; j<numVertices; ++j)
+      {
+      double *f = force + 3*j;
+
+      // Forces can get extreme so limit them
+      // Note: This is psuedo-normalization of the
+      //       force vector, just to save some cycles
+      double forceDiv = epsilon;
+      for (int k = 0; k < dimension; ++k)
+        {
+        forceDiv += fabs(f[k]);
+        }
+      double pNormalize = 1.0/forceDiv;
+      if (pNormalize > 1)
+        {
+        pNormalize = 1;
+        }
+      pNormalize *= this->Temp;
+
+      for (int k = 0; k < dimension; ++k)
+        {
+        rawPointData[3*j+k] += f[k] * pNormalize;
+        }
+      }
+
+    // The point coordinates have been modified
+    this->Graph->GetPoints()->Modified();
+
+    // Reduce temperature as layout approaches a better configuration.
+    this->Temp = CoolDown(this->Temp, this->CoolDownRate);
+
+    // Announce progress
+    double progress = (i+this->TotalIterations) /
+                      static_cast<double>(this->MaxNumberOfIterations);
+    this->InvokeEvent(vtkCommand::ProgressEvent, static_cast<void *>(&progress));
+
+   } // End loop this->IterationsPerLayout
+
+  // Check for completion of layout
+  this->TotalIterations += this->IterationsPerLayout;
+  if (this->TotalIterations >= this->MaxNumberOfIterations)
+    {
+    // I'm done
+    this->LayoutComplete = 1;
+    }
+
+  // Mark the points as modified
+  this->Graph->GetPoints()->Modified();
+}
+
+void vtkBarnesHutLayoutStrategy::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "RandomSeed: " << this->RandomSeed << endl;
+  os << indent << "InitialTemperature: " << this->InitialTemperature << endl;
+  os << indent << "MaxNumberOfIterations: " << this->MaxNumberOfIterations << endl;
+  os << indent << "IterationsPerLayout: " << this->IterationsPerLayout << endl;
+  os << indent << "CoolDownRate: " << this->CoolDownRate << endl;
+  os << indent << "Jitter: " << (this->Jitter ? "True" : "False") << endl;
+  os << indent << "RestDistance: " << this->RestDistance << endl;
+  os << indent << "Theta: " << this->Theta << endl;
+  os << indent << "ThreeDimensionalLayout: "
+     << (this->ThreeDimensionalLayout ? "On\n" : "Off\n");
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
+}
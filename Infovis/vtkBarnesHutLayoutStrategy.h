@@ -0,0 +1,190 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBarnesHutLayoutStrategy.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkBarnesHutLayoutStrategy - a force directed layout for large graphs
+//
+// .SECTION Description
+// This class uses the same forces as vtkSimple2DLayoutStrategy, but
+// approximates the repulsion between vertices with the Barnes-Hut method:
+// at every iteration the vertices are sorted into a quadtree (2D) or an
+// octree (3D), and groups of vertices that are far enough away from a
+// vertex are replaced by their center of mass. This brings the cost of an
+// iteration down from O(V^2) to O(V log V + E). The repulsive forces are
+// computed by NumberOfThreads threads, each handling a range of vertices.
+//
+// Theta controls the approximation: a tree cell of size s at distance d
+// from a vertex is used as a whole when s/d < Theta. Zero gives the exact
+// forces, larger values are faster and coarser.
+//
+// Like the other iterative layouts, the layout can be computed
+// incrementally by setting IterationsPerLayout below MaxNumberOfIterations,
+// so that an application can render the graph while the layout converges.
+//
+// .SECTION See Also
+// vtkSimple2DLayoutStrategy vtkFast2DLayoutStrategy
+// vtkForceDirectedLayoutStrategy
+
+#ifndef __vtkBarnesHutLayoutStrategy_h
+#define __vtkBarnesHutLayoutStrategy_h
+
+#include "vtkGraphLayoutStrategy.h"
+
+class vtkBarnesHutLayoutStrategyInternals;
+class vtkMultiThreader;
+
+class VTK_INFOVIS_EXPORT vtkBarnesHutLayoutStrategy : public vtkGraphLayoutStrategy
+{
+public:
+  static vtkBarnesHutLayoutStrategy *New();
+
+  vtkTypeMacro(vtkBarnesHutLayoutStrategy, vtkGraphLayoutStrategy);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Seed the random number generator used to jitter point positions.
+  // This has a significant effect on their final positions when
+  // the layout is complete.
+  vtkSetClampMacro(RandomSeed, int, 0, VTK_LARGE_INTEGER);
+  vtkGetMacro(RandomSeed, int);
+
+  // Description:
+  // Set/Get the maximum number of iterations to be used.
+  // The higher this number, the more iterations through the algorithm
+  // is possible, and thus, the more the graph gets modified.
+  // The default is '200'.
+  vtkSetClampMacro(MaxNumberOfIterations, int, 0, VTK_LARGE_INTEGER);
+  vtkGetMacro(MaxNumberOfIterations, int);
+
+  // Description:
+  // Set/Get the number of iterations per layout.
+  // The only use for this ivar is for the application
+  // to do visualizations of the layout before it's complete.
+  // The default is '200' to match the default 'MaxNumberOfIterations'
+  vtkSetClampMacro(IterationsPerLayout, int, 0, VTK_LARGE_INTEGER);
+  vtkGetMacro(IterationsPerLayout, int);
+
+  // Description:
+  // Set the initial temperature. The default is '1'.
+  vtkSetClampMacro(InitialTemperature, float, 0.0, VTK_FLOAT_MAX);
+  vtkGetMacro(InitialTemperature, float);
+
+  // Description:
+  // Set/Get the Cool-down rate.
+  // The higher this number is, the longer it will take to "cool-down",
+  // and thus, the more the graph will be modified. The default is '50'.
+  vtkSetClampMacro(CoolDownRate, double, 0.01, VTK_DOUBLE_MAX);
+  vtkGetMacro(CoolDownRate, double);
+
+  // Description:
+  // Set Random jitter of the nodes at initialization
+  // to on or off.
+  // Note: It's strongly recommendation to have jitter ON
+  // even if you have initial coordinates in your graph.
+  // Default is ON
+  vtkSetMacro(Jitter, bool);
+  vtkGetMacro(Jitter, bool);
+
+  // Description:
+  // Manually set the resting distance. Otherwise the
+  // distance is computed automatically.
+  vtkSetMacro(RestDistance, float);
+  vtkGetMacro(RestDistance, float);
+
+  // Description:
+  // Set/Get the opening angle of the Barnes-Hut approximation.
+  // A tree cell is used as a single body when its size divided by its
+  // distance to the vertex is below Theta. Zero computes the exact
+  // repulsion. The default is '0.8'.
+  vtkSetClampMacro(Theta, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(Theta, double);
+
+  // Description:
+  // Turn on/off layout of graph in three dimensions. If off, graph
+  // layout occurs in two dimensions and the z coordinates are left
+  // untouched. By default, three dimensional layout is off.
+  vtkSetMacro(ThreeDimensionalLayout, int);
+  vtkGetMacro(ThreeDimensionalLayout, int);
+  vtkBooleanMacro(ThreeDimensionalLayout, int);
+
+  // Description:
+  // Set/Get the number of threads used to compute the repulsive forces.
+  // The default is the global default number of threads of
+  // vtkMultiThreader.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // This strategy sets up some data structures
+  // for faster processing of each Layout() call
+  virtual void Initialize();
+
+  // Description:
+  // This is the layout method where the graph that was
+  // set in SetGraph() is laid out. The method can either
+  // entirely layout the graph or iteratively lay out the
+  // graph. If you have an iterative layout please implement
+  // the IsLayoutComplete() method.
+  virtual void Layout();
+
+  // Description:
+  // I'm an iterative layout so this method lets the caller
+  // know if I'm done laying out the graph
+  virtual int IsLayoutComplete() {return this->LayoutComplete;}
+
+protected:
+  vtkBarnesHutLayoutStrategy();
+  ~vtkBarnesHutLayoutStrategy();
+
+  int    MaxNumberOfIterations;  //Maximum number of iterations.
+  float  InitialTemperature;
+  float  CoolDownRate;  //Cool-down rate.  Note:  Higher # = Slower rate.
+  double Theta;
+  int    ThreeDimensionalLayout;
+  int    NumberOfThreads;
+
+  // Description:
+  // Sort the vertices into the quadtree or octree and compute the
+  // mass and center of mass of every cell.
+  void BuildTree(const float *points, vtkIdType numVertices);
+
+private:
+
+  //BTX
+  // An edge consists of two vertices joined together.
+  // This struct acts as a "pointer" to those two vertices.
+  typedef struct
+  {
+    vtkIdType from;
+    vtkIdType to;
+    float weight;
+  } vtkLayoutEdge;
+  //ETX
+
+  vtkLayoutEdge *EdgeArray;
+  vtkBarnesHutLayoutStrategyInternals *Internals;
+  vtkMultiThreader *Threader;
+
+  int RandomSeed;
+  int IterationsPerLayout;
+  int TotalIterations;
+  int LayoutComplete;
+  float Temp;
+  float RestDistance;
+  bool Jitter;
+
+  vtkBarnesHutLayoutStrategy(const vtkBarnesHutLayoutStrategy&);  // Not implemented.
+  void operator=(const vtkBarnesHutLayoutStrategy&);  // Not implemented.
+};
+
+#endif
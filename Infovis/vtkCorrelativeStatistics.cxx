@@ -30,6 +30,7 @@
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #ifdef VTK_USE_GNU_R
 #include <vtkRInterface.h>
@@ -45,6 +46,156 @@
 
 vtkStandardNewMacro(vtkCorrelativeStatistics);
 
+// Below this many rows per thread, starting threads does not pay off.
+static const vtkIdType vtkCorrelativeStatisticsMinimumRowsPerThread = 65536;
+
+// Number of values converted to double at a time by each thread.
+static const vtkIdType vtkCorrelativeStatisticsChunkSize = 4096;
+
+// ----------------------------------------------------------------------
+// The primary statistics of a range of rows.
+struct vtkCorrelativeStatisticsMoments
+{
+  double Cardinality;
+  double MeanX;
+  double MeanY;
+  double M2X;
+  double M2Y;
+  double MXY;
+};
+
+struct vtkCorrelativeStatisticsThreadStruct
+{
+  void* DataX;
+  int DataTypeX;
+  void* DataY;
+  int DataTypeY;
+  vtkIdType NumberOfRows;
+  vtkCorrelativeStatisticsMoments Moments[VTK_MAX_THREADS];
+};
+
+// ----------------------------------------------------------------------
+template <class T>
+void vtkCorrelativeStatisticsCopyToDouble( const T* values,
+                                           vtkIdType n,
+                                           double* out )
+{
+  for ( vtkIdType i = 0; i < n; ++ i )
+    {
+    out[i] = static_cast<double>( values[i] );
+    }
+}
+
+// ----------------------------------------------------------------------
+// Update m with the moments of m_c, as in vtkCorrelativeStatistics::Aggregate.
+static void vtkCorrelativeStatisticsMerge( vtkCorrelativeStatisticsMoments& m,
+                                           const vtkCorrelativeStatisticsMoments& m_c )
+{
+  double n = m.Cardinality;
+  double n_c = m_c.Cardinality;
+  double N = n + n_c;
+
+  double invN = 1. / N;
+
+  double deltaX = m_c.MeanX - m.MeanX;
+  double deltaX_sur_N = deltaX * invN;
+
+  double deltaY = m_c.MeanY - m.MeanY;
+  double deltaY_sur_N = deltaY * invN;
+
+  double prod_n = n * n_c;
+
+  m.M2X += m_c.M2X
+    + prod_n * deltaX * deltaX_sur_N;
+
+  m.M2Y += m_c.M2Y
+    + prod_n * deltaY * deltaY_sur_N;
+
+  m.MXY += m_c.MXY
+    + prod_n * deltaX * deltaY_sur_N;
+
+  m.MeanX += n_c * deltaX_sur_N;
+
+  m.MeanY += n_c * deltaY_sur_N;
+
+  m.Cardinality = N;
+}
+
+// ----------------------------------------------------------------------
+// Each thread computes the moments of one contiguous range of rows with the
+// same one-pass update as the serial Learn.
+static VTK_THREAD_RETURN_TYPE vtkCorrelativeStatisticsLearnThread( void* arg )
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+  vtkCorrelativeStatisticsThreadStruct* str =
+    static_cast<vtkCorrelativeStatisticsThreadStruct*>( info->UserData );
+  int tid = info->ThreadID;
+  int nThreads = info->NumberOfThreads;
+
+  vtkIdType begin = str->NumberOfRows * tid / nThreads;
+  vtkIdType end = str->NumberOfRows * ( tid + 1 ) / nThreads;
+
+  double bufferX[vtkCorrelativeStatisticsChunkSize];
+  double bufferY[vtkCorrelativeStatisticsChunkSize];
+  double meanX = 0.;
+  double meanY = 0.;
+  double mom2X = 0.;
+  double mom2Y = 0.;
+  double momXY = 0.;
+
+  double inv_n, x, y, delta, deltaXn;
+  vtkIdType r = 0;
+  for ( vtkIdType chunk = begin; chunk < end; chunk += vtkCorrelativeStatisticsChunkSize )
+    {
+    vtkIdType nChunk = end - chunk;
+    if ( nChunk > vtkCorrelativeStatisticsChunkSize )
+      {
+      nChunk = vtkCorrelativeStatisticsChunkSize;
+      }
+    switch ( str->DataTypeX )
+      {
+      vtkTemplateMacro(
+        vtkCorrelativeStatisticsCopyToDouble( static_cast<VTK_TT*>( str->DataX ) + chunk,
+                                              nChunk, bufferX ) );
+      }
+    switch ( str->DataTypeY )
+      {
+      vtkTemplateMacro(
+        vtkCorrelativeStatisticsCopyToDouble( static_cast<VTK_TT*>( str->DataY ) + chunk,
+                                              nChunk, bufferY ) );
+      }
+
+    for ( vtkIdType i = 0; i < nChunk; ++ i, ++ r )
+      {
+      inv_n = 1. / ( r + 1. );
+
+      x = bufferX[i];
+      delta = x - meanX;
+      meanX += delta * inv_n;
+      deltaXn = x - meanX;
+      mom2X += delta * deltaXn;
+
+      y = bufferY[i];
+      delta = y - meanY;
+      meanY += delta * inv_n;
+      mom2Y += delta * ( y - meanY );
+
+      momXY += delta * deltaXn;
+      }
+    }
+
+  vtkCorrelativeStatisticsMoments& m = str->Moments[tid];
+  m.Cardinality = static_cast<double>( end - begin );
+  m.MeanX = meanX;
+  m.MeanY = meanY;
+  m.M2X = mom2X;
+  m.M2Y = mom2Y;
+  m.MXY = momXY;
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 // ----------------------------------------------------------------------
 vtkCorrelativeStatistics::vtkCorrelativeStatistics()
 {
@@ -58,6 +209,8 @@ vtkCorrelativeStatistics::vtkCorrelativeStatistics()
   this->AssessParameters->SetValue( 2, "Variance X" );
   this->AssessParameters->SetValue( 3, "Variance Y" );
   this->AssessParameters->SetValue( 4, "Covariance" );
+
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
 }
 
 // ----------------------------------------------------------------------
@@ -69,6 +222,7 @@ vtkCorrelativeStatistics::~vtkCorrelativeStatistics()
 void vtkCorrelativeStatistics::PrintSelf( ostream &os, vtkIndent indent )
 {
   this->Superclass::PrintSelf( os, indent );
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
 }
 
 // ----------------------------------------------------------------------
@@ -304,23 +458,68 @@ void vtkCorrelativeStatistics::Learn( vtkTable* inData,
     double mom2Y = 0.;
     double momXY = 0.;
 
-    double inv_n, x, y, delta, deltaXn;
-    for ( vtkIdType r = 0; r < nRow; ++ r )
+    // Pairs of single component numeric columns are read directly from
+    // memory, one row range per thread; other columns go through variants.
+    vtkDataArray* dataX = vtkDataArray::SafeDownCast( inData->GetColumnByName( colX ) );
+    vtkDataArray* dataY = vtkDataArray::SafeDownCast( inData->GetColumnByName( colY ) );
+    if ( nRow > 0 && dataX && dataY
+         && dataX->GetNumberOfComponents() == 1 && dataX->GetDataType() != VTK_BIT
+         && dataY->GetNumberOfComponents() == 1 && dataY->GetDataType() != VTK_BIT )
       {
-      inv_n = 1. / ( r + 1. );
+      vtkIdType nThreads = nRow / vtkCorrelativeStatisticsMinimumRowsPerThread;
+      if ( nThreads > this->NumberOfThreads )
+        {
+        nThreads = this->NumberOfThreads;
+        }
+      if ( nThreads < 1 )
+        {
+        nThreads = 1;
+        }
 
-      x = inData->GetValueByName( r, colX ).ToDouble();
-      delta = x - meanX;
-      meanX += delta * inv_n;
-      deltaXn = x - meanX;
-      mom2X += delta * deltaXn;
+      vtkCorrelativeStatisticsThreadStruct str;
+      str.DataX = dataX->GetVoidPointer( 0 );
+      str.DataTypeX = dataX->GetDataType();
+      str.DataY = dataY->GetVoidPointer( 0 );
+      str.DataTypeY = dataY->GetDataType();
+      str.NumberOfRows = nRow;
+
+      vtkMultiThreader* threader = vtkMultiThreader::New();
+      threader->SetNumberOfThreads( static_cast<int>( nThreads ) );
+      threader->SetSingleMethod( vtkCorrelativeStatisticsLearnThread, &str );
+      threader->SingleMethodExecute();
+      threader->Delete();
+
+      // Merge the ranges in row order.
+      for ( int t = 1; t < nThreads; ++ t )
+        {
+        vtkCorrelativeStatisticsMerge( str.Moments[0], str.Moments[t] );
+        }
+      meanX = str.Moments[0].MeanX;
+      meanY = str.Moments[0].MeanY;
+      mom2X = str.Moments[0].M2X;
+      mom2Y = str.Moments[0].M2Y;
+      momXY = str.Moments[0].MXY;
+      }
+    else
+      {
+      double inv_n, x, y, delta, deltaXn;
+      for ( vtkIdType r = 0; r < nRow; ++ r )
+        {
+        inv_n = 1. / ( r + 1. );
 
-      y = inData->GetValueByName( r, colY ).ToDouble();
-      delta = y - meanY;
-      meanY += delta * inv_n;
-      mom2Y += delta * ( y - meanY );
+        x = inData->GetValueByName( r, colX ).ToDouble();
+        delta = x - meanX;
+        meanX += delta * inv_n;
+        deltaXn = x - meanX;
+        mom2X += delta * deltaXn;
 
-      momXY += delta * deltaXn;
+        y = inData->GetValueByName( r, colY ).ToDouble();
+        delta = y - meanY;
+        meanY += delta * inv_n;
+        mom2Y += delta * ( y - meanY );
+
+        momXY += delta * deltaXn;
+        }
       }
 
     vtkVariantArray* row = vtkVariantArray::New();
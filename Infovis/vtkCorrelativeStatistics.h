@@ -26,6 +26,9 @@ PURPOSE.  See the above copyright notice for more information.
 //   (cf. P. Pebay, Formulas for robust, one-pass parallel computation of covariances
 //   and Arbitrary-Order Statistical Moments, Sandia Report SAND2008-6212, Sep 2008,
 //   http://infoserve.sandia.gov/sand_doc/2008/086212.pdf for details)
+//   Pairs of numeric columns are split into row ranges that are processed by
+//   NumberOfThreads threads, whose aggregates are then merged with the
+//   formulas used by Aggregate().
 // * Derive: calculate unbiased variance and covariance estimators, estimator of
 //   standard deviations, linear regressions, and Pearson correlation coefficient.
 // * Assess: given an input data set, two means and a 2x2 covariance matrix,
@@ -59,6 +62,13 @@ public:
   virtual void Aggregate( vtkDataObjectCollection*,
                           vtkMultiBlockDataSet* );
 
+  // Description:
+  // Set/get the number of threads used by the Learn option on pairs of
+  // numeric columns. Small tables are processed by fewer threads.
+  // The default is the global default number of threads of vtkMultiThreader.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
 protected:
   vtkCorrelativeStatistics();
   ~vtkCorrelativeStatistics();
@@ -79,6 +89,8 @@ protected:
                      vtkMultiBlockDataSet*,
                      vtkTable* );
 
+  int NumberOfThreads;
+
 //BTX  
   // Description:
   // Provide the appropriate assessment functor.
@@ -29,6 +29,7 @@
 #include "vtkInformation.h"
 #include "vtkMath.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #ifdef VTK_USE_GNU_R
 #include <vtkRInterface.h>
@@ -44,6 +45,172 @@
 
 vtkStandardNewMacro(vtkDescriptiveStatistics);
 
+// Below this many rows per thread, starting threads does not pay off.
+static const vtkIdType vtkDescriptiveStatisticsMinimumRowsPerThread = 65536;
+
+// Number of values converted to double at a time by each thread.
+static const vtkIdType vtkDescriptiveStatisticsChunkSize = 4096;
+
+// ----------------------------------------------------------------------
+// The primary statistics of a range of rows.
+struct vtkDescriptiveStatisticsMoments
+{
+  double Cardinality;
+  double Minimum;
+  double Maximum;
+  double Mean;
+  double M2;
+  double M3;
+  double M4;
+};
+
+struct vtkDescriptiveStatisticsThreadStruct
+{
+  void* Data;
+  int DataType;
+  vtkIdType NumberOfRows;
+  vtkDescriptiveStatisticsMoments Moments[VTK_MAX_THREADS];
+};
+
+// ----------------------------------------------------------------------
+template <class T>
+void vtkDescriptiveStatisticsCopyToDouble( const T* values,
+                                           vtkIdType n,
+                                           double* out )
+{
+  for ( vtkIdType i = 0; i < n; ++ i )
+    {
+    out[i] = static_cast<double>( values[i] );
+    }
+}
+
+// ----------------------------------------------------------------------
+// Update m with the moments of m_c, as in vtkDescriptiveStatistics::Aggregate.
+static void vtkDescriptiveStatisticsMerge( vtkDescriptiveStatisticsMoments& m,
+                                           const vtkDescriptiveStatisticsMoments& m_c )
+{
+  double n = m.Cardinality;
+  double n_c = m_c.Cardinality;
+  double N = n + n_c;
+
+  if ( m_c.Minimum < m.Minimum )
+    {
+    m.Minimum = m_c.Minimum;
+    }
+
+  if ( m_c.Maximum > m.Maximum )
+    {
+    m.Maximum = m_c.Maximum;
+    }
+
+  double delta = m_c.Mean - m.Mean;
+  double delta_sur_N = delta / N;
+  double delta2_sur_N2 = delta_sur_N * delta_sur_N;
+
+  double n2 = n * n;
+  double n_c2 = n_c * n_c;
+  double prod_n = n * n_c;
+
+  m.M4 += m_c.M4
+    + prod_n * ( n2 - prod_n + n_c2 ) * delta * delta_sur_N * delta2_sur_N2
+    + 6. * ( n2 * m_c.M2 + n_c2 * m.M2 ) * delta2_sur_N2
+    + 4. * ( n * m_c.M3 - n_c * m.M3 ) * delta_sur_N;
+
+  m.M3 += m_c.M3
+    + prod_n * ( n - n_c ) * delta * delta2_sur_N2
+    + 3. * ( n * m_c.M2 - n_c * m.M2 ) * delta_sur_N;
+
+  m.M2 += m_c.M2
+    + prod_n * delta * delta_sur_N;
+
+  m.Mean += n_c * delta_sur_N;
+
+  m.Cardinality = N;
+}
+
+// ----------------------------------------------------------------------
+// Each thread computes the moments of one contiguous range of rows with the
+// same one-pass update as the serial Learn.
+static VTK_THREAD_RETURN_TYPE vtkDescriptiveStatisticsLearnThread( void* arg )
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+  vtkDescriptiveStatisticsThreadStruct* str =
+    static_cast<vtkDescriptiveStatisticsThreadStruct*>( info->UserData );
+  int tid = info->ThreadID;
+  int nThreads = info->NumberOfThreads;
+
+  vtkIdType begin = str->NumberOfRows * tid / nThreads;
+  vtkIdType end = str->NumberOfRows * ( tid + 1 ) / nThreads;
+
+  double buffer[vtkDescriptiveStatisticsChunkSize];
+  double minVal = 0.;
+  double maxVal = 0.;
+  double mean = 0.;
+  double mom2 = 0.;
+  double mom3 = 0.;
+  double mom4 = 0.;
+
+  double n, inv_n, val, delta, A, B;
+  vtkIdType r = 0;
+  for ( vtkIdType chunk = begin; chunk < end; chunk += vtkDescriptiveStatisticsChunkSize )
+    {
+    vtkIdType nChunk = end - chunk;
+    if ( nChunk > vtkDescriptiveStatisticsChunkSize )
+      {
+      nChunk = vtkDescriptiveStatisticsChunkSize;
+      }
+    switch ( str->DataType )
+      {
+      vtkTemplateMacro(
+        vtkDescriptiveStatisticsCopyToDouble( static_cast<VTK_TT*>( str->Data ) + chunk,
+                                              nChunk, buffer ) );
+      }
+    if ( chunk == begin )
+      {
+      minVal = buffer[0];
+      maxVal = minVal;
+      }
+
+    for ( vtkIdType i = 0; i < nChunk; ++ i, ++ r )
+      {
+      n = r + 1.;
+      inv_n = 1. / n;
+
+      val = buffer[i];
+      delta = val - mean;
+
+      A = delta * inv_n;
+      mean += A;
+      mom4 += A * ( A * A * delta * r * ( n * ( n - 3. ) + 3. ) + 6. * A * mom2 - 4. * mom3  );
+
+      B = val - mean;
+      mom3 += A * ( B * delta * ( n - 2. ) - 3. * mom2 );
+      mom2 += delta * B;
+
+      if ( val < minVal )
+        {
+        minVal = val;
+        }
+      else if ( val > maxVal )
+        {
+        maxVal = val;
+        }
+      }
+    }
+
+  vtkDescriptiveStatisticsMoments& m = str->Moments[tid];
+  m.Cardinality = static_cast<double>( end - begin );
+  m.Minimum = minVal;
+  m.Maximum = maxVal;
+  m.Mean = mean;
+  m.M2 = mom2;
+  m.M3 = mom3;
+  m.M4 = mom4;
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 // ----------------------------------------------------------------------
 vtkDescriptiveStatistics::vtkDescriptiveStatistics()
 {
@@ -58,6 +225,7 @@ vtkDescriptiveStatistics::vtkDescriptiveStatistics()
   this->G1Skewness = 0; // By default, use g1 estimator of the skewness (G1 otherwise)
   this->G2Kurtosis = 0; // By default, use g2 estimator of the kurtosis (G2 otherwise)
   this->SignedDeviations = 0; // By default, use unsigned deviation (1D Mahlanobis distance)
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
 }
 
 // ----------------------------------------------------------------------
@@ -73,6 +241,7 @@ void vtkDescriptiveStatistics::PrintSelf( ostream &os, vtkIndent indent )
   os << indent << "G1Skewness: " << this->G1Skewness << "\n";
   os << indent << "G2Kurtosis: " << this->G2Kurtosis << "\n";
   os << indent << "SignedDeviations: " << this->SignedDeviations << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
 }
 
 // ----------------------------------------------------------------------
@@ -312,37 +481,82 @@ void vtkDescriptiveStatistics::Learn( vtkTable* inData,
       continue;
       }
 
-    double minVal = inData->GetValueByName( 0, varName ).ToDouble();
-    double maxVal = minVal;
+    double minVal;
+    double maxVal;
     double mean = 0.;
     double mom2 = 0.;
     double mom3 = 0.;
     double mom4 = 0.;
 
-    double n, inv_n, val, delta, A, B;
-    for ( vtkIdType r = 0; r < nRow; ++ r )
+    // Single component numeric columns are read directly from memory, one
+    // row range per thread; other columns go through variants.
+    vtkDataArray* dataCol = vtkDataArray::SafeDownCast( inData->GetColumnByName( varName ) );
+    if ( nRow > 0 && dataCol && dataCol->GetNumberOfComponents() == 1
+         && dataCol->GetDataType() != VTK_BIT )
       {
-      n = r + 1.;
-      inv_n = 1. / n;
-
-      val = inData->GetValueByName( r, varName ).ToDouble();
-      delta = val - mean;
+      vtkIdType nThreads = nRow / vtkDescriptiveStatisticsMinimumRowsPerThread;
+      if ( nThreads > this->NumberOfThreads )
+        {
+        nThreads = this->NumberOfThreads;
+        }
+      if ( nThreads < 1 )
+        {
+        nThreads = 1;
+        }
 
-      A = delta * inv_n;
-      mean += A;
-      mom4 += A * ( A * A * delta * r * ( n * ( n - 3. ) + 3. ) + 6. * A * mom2 - 4. * mom3  );
+      vtkDescriptiveStatisticsThreadStruct str;
+      str.Data = dataCol->GetVoidPointer( 0 );
+      str.DataType = dataCol->GetDataType();
+      str.NumberOfRows = nRow;
 
-      B = val - mean;
-      mom3 += A * ( B * delta * ( n - 2. ) - 3. * mom2 );
-      mom2 += delta * B;
+      vtkMultiThreader* threader = vtkMultiThreader::New();
+      threader->SetNumberOfThreads( static_cast<int>( nThreads ) );
+      threader->SetSingleMethod( vtkDescriptiveStatisticsLearnThread, &str );
+      threader->SingleMethodExecute();
+      threader->Delete();
 
-      if ( val < minVal )
+      // Merge the ranges in row order.
+      for ( int t = 1; t < nThreads; ++ t )
         {
-        minVal = val;
+        vtkDescriptiveStatisticsMerge( str.Moments[0], str.Moments[t] );
         }
-      else if ( val > maxVal )
+      minVal = str.Moments[0].Minimum;
+      maxVal = str.Moments[0].Maximum;
+      mean = str.Moments[0].Mean;
+      mom2 = str.Moments[0].M2;
+      mom3 = str.Moments[0].M3;
+      mom4 = str.Moments[0].M4;
+      }
+    else
+      {
+      minVal = inData->GetValueByName( 0, varName ).ToDouble();
+      maxVal = minVal;
+
+      double n, inv_n, val, delta, A, B;
+      for ( vtkIdType r = 0; r < nRow; ++ r )
         {
-        maxVal = val;
+        n = r + 1.;
+        inv_n = 1. / n;
+
+        val = inData->GetValueByName( r, varName ).ToDouble();
+        delta = val - mean;
+
+        A = delta * inv_n;
+        mean += A;
+        mom4 += A * ( A * A * delta * r * ( n * ( n - 3. ) + 3. ) + 6. * A * mom2 - 4. * mom3  );
+
+        B = val - mean;
+        mom3 += A * ( B * delta * ( n - 2. ) - 3. * mom2 );
+        mom2 += delta * B;
+
+        if ( val < minVal )
+          {
+          minVal = val;
+          }
+        else if ( val > maxVal )
+          {
+          maxVal = val;
+          }
         }
       }
 
@@ -27,6 +27,9 @@ PURPOSE.  See the above copyright notice for more information.
 //   (cf. P. Pebay, Formulas for robust, one-pass parallel computation of covariances
 //   and Arbitrary-Order Statistical Moments, Sandia Report SAND2008-6212, Sep 2008,
 //   http://infoserve.sandia.gov/sand_doc/2008/086212.pdf for details)
+//   Numeric columns are split into row ranges that are processed by
+//   NumberOfThreads threads, whose aggregates are then merged with the
+//   formulas used by Aggregate().
 // * Derive: calculate unbiased variance estimator, standard deviation estimator,
 //   two skewness estimators, and two kurtosis excess estimators.
 // * Assess: given an input data set, a reference value and a non-negative deviation,
@@ -91,6 +94,13 @@ public:
   vtkGetMacro(SignedDeviations,int);
   vtkBooleanMacro(SignedDeviations,int);
 
+  // Description:
+  // Set/get the number of threads used by the Learn option on numeric
+  // columns. Small tables are processed by fewer threads.
+  // The default is the global default number of threads of vtkMultiThreader.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
   // Description:
   // A convenience method (in particular for UI wrapping) to set the name of the
   // column that contains the nominal value for the Assess option.
@@ -131,6 +141,7 @@ protected:
   int G1Skewness;
   int G2Kurtosis;
   int SignedDeviations;
+  int NumberOfThreads;
 
 //BTX  
   // Description:
@@ -29,6 +29,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkIntArray.h"
 #include "vtkObjectFactory.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkSortDataArray.h"
 #include "vtkStringArray.h"
 #include "vtkTable.h"
 #include "vtkVariantArray.h"
@@ -213,15 +214,31 @@ void vtkOrderStatistics::Learn( vtkTable* inData,
       {
       vtkDataArray* darr = vtkDataArray::SafeDownCast( arr );
 
-      vtksys_stl::map<double,vtkIdType> distr;
+      // Sort a copy of the column and count the repeats of each value
+      vtkDoubleArray* sorted = vtkDoubleArray::New();
+      sorted->SetNumberOfValues( nRow );
       for ( vtkIdType r = 0; r < nRow; ++ r )
         {
-        ++ distr[darr->GetTuple1( r )];
+        sorted->SetValue( r, darr->GetTuple1( r ) );
         }
+      vtkSortDataArray::Sort( sorted );
+
+      typedef vtksys_stl::vector<vtksys_stl::pair<double,vtkIdType> > vtkOrderStatisticsDistribution;
+      vtkOrderStatisticsDistribution distr;
+      for ( vtkIdType r = 0; r < nRow; ++ r )
+        {
+        double x = sorted->GetValue( r );
+        if ( distr.empty() || distr.back().first != x )
+          {
+          distr.push_back( vtksys_stl::pair<double,vtkIdType>( x, 0 ) );
+          }
+        ++ distr.back().second;
+        }
+      sorted->Delete();
 
       vtkIdType sum = 0;
       vtksys_stl::vector<double>::iterator qit = quantileThresholds.begin();
-      for ( vtksys_stl::map<double,vtkIdType>::iterator mit = distr.begin();
+      for ( vtkOrderStatisticsDistribution::iterator mit = distr.begin();
             mit != distr.end(); ++ mit  )
         {
         for ( sum += mit->second; qit != quantileThresholds.end() && sum >= *qit; ++ qit )
@@ -230,7 +247,7 @@ void vtkOrderStatistics::Learn( vtkTable* inData,
           if ( sum == *qit
                && this->QuantileDefinition == vtkOrderStatistics::InverseCDFAveragedSteps )
             {
-            vtksys_stl::map<double,vtkIdType>::iterator nit = mit;
+            vtkOrderStatisticsDistribution::iterator nit = mit;
             row->SetValue( i ++, ( (++ nit)->first + mit->first ) * .5 );
             }
           else
@@ -50,6 +50,7 @@
 #include "vtkSmartPointer.h"
 #include "vtkSocketController.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTimerLog.h"
 #include "vtkToolkits.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
@@ -67,6 +68,22 @@ vtkStandardNewMacro(vtkDistributedDataFilter)
 #define TEMP_INSIDE_BOX_FLAG      "___D3___WHERE"
 #define TEMP_NODE_ID_NAME         "___D3___GlobalNodeIds"
 
+// Timing data ---------------------------------------------
+
+#define TIMER(s) \
+  if (this->Timing) \
+    { \
+    vtkTimerLog::MarkStartEvent(s); \
+    }
+
+#define TIMERDONE(s) \
+  if (this->Timing) \
+    { \
+    vtkTimerLog::MarkEndEvent(s); \
+    }
+
+// Timing data ---------------------------------------------
+
 #include <vtkstd/set>
 #include <vtkstd/map>
 #include <vtkstd/algorithm>
@@ -618,8 +635,12 @@ int vtkDistributedDataFilter::RequestDataInternal(vtkDataSet* input,
   // Note k-d tree will only be re-built if input or parameters
   // have changed on any of the processing nodes.
 
+  TIMER("D3 partition data");
+
   int fail = this->PartitionDataAndAssignToProcesses(splitInput);
 
+  TIMERDONE("D3 partition data");
+
   if (fail)
     {
     if (splitInput != input)
@@ -649,9 +670,13 @@ int vtkDistributedDataFilter::RequestDataInternal(vtkDataSet* input,
   //
   // This call will delete splitInput if it's not this->GetInput().
 
+  TIMER("D3 redistribute data");
+
   vtkUnstructuredGrid *redistributedInput = this->RedistributeDataSet(splitInput,
                                                                       input);
 
+  TIMERDONE("D3 redistribute data");
+
   if (redistributedInput == NULL)
     {
     this->Kdtree->Delete();
@@ -688,7 +713,9 @@ int vtkDistributedDataFilter::RequestDataInternal(vtkDataSet* input,
     // redistributedInput will be deleted by AcquireGhostCells
 
     this->SetProgressText("Exchange ghost cells");
+    TIMER("D3 acquire ghost cells");
     expandedGrid = this->AcquireGhostCells(redistributedInput);
+    TIMERDONE("D3 acquire ghost cells");
     }
 
   // Stage (4) - Clip cells to the spatial region boundaries
@@ -696,7 +723,9 @@ int vtkDistributedDataFilter::RequestDataInternal(vtkDataSet* input,
   if (this->ClipCells)
     {
     this->SetProgressText("Clip boundary cells");
+    TIMER("D3 clip boundary cells");
     this->ClipGridCells(expandedGrid);
+    TIMERDONE("D3 clip boundary cells");
     this->UpdateProgress(this->NextProgressStep++ * this->ProgressIncrement);
     }
 
@@ -1319,7 +1348,9 @@ vtkDataSet *vtkDistributedDataFilter::TestFixTooFewInputFiles(vtkDataSet *input)
 //============================================================================
 // Communication routines - two versions:
 //   *Lean version use minimal memory
-//   *Fast versions use more memory, but are much faster
+//   *Fast versions use more memory, but are much faster.  The sub grid
+//    exchange posts all sends and receives without blocking, and packs
+//    and unpacks sub grids while other transfers are in progress.
 
 //-------------------------------------------------------------------------
 void vtkDistributedDataFilter::SetUpPairWiseExchange()
@@ -2414,7 +2445,41 @@ vtkUnstructuredGrid *
   int *sendSize = new int [nprocs];
   int *recvSize = new int [nprocs];
 
-  // create & pack all sub grids
+  // Each process sends every other process a size message followed,
+  // if the size is not zero, by the packed sub grid.  All communication
+  // is non-blocking so that extracting and packing the grid for the
+  // next process, and unpacking grids that have already arrived,
+  // overlaps with the transfers in flight.
+
+  vtkMPICommunicator::Request *sendSizeReq = 
+    new vtkMPICommunicator::Request [nprocs];
+  vtkMPICommunicator::Request *sendBufReq = 
+    new vtkMPICommunicator::Request [nprocs];
+  vtkMPICommunicator::Request *recvSizeReq = 
+    new vtkMPICommunicator::Request [nprocs];
+  vtkMPICommunicator::Request *recvBufReq = 
+    new vtkMPICommunicator::Request [nprocs];
+
+  // 0 - nothing expected, 1 - awaiting size, 2 - awaiting sub grid
+
+  int *recvState = new int [nprocs];
+
+  int numPending = 0;
+
+  for (proc=0; proc < nprocs; proc++)
+    {
+    recvSize[proc] = sendSize[proc] = 0;
+    grids[proc] = NULL;
+    sendBufs[proc] = recvBufs[proc] = NULL;
+    recvState[proc] = 0;
+
+    if (proc != iam)
+      {
+      mpiContr->NoBlockReceive(recvSize + proc, 1, proc, tag, recvSizeReq[proc]);
+      recvState[proc] = 1;
+      numPending++;
+      }
+    }
 
   vtkDataSet *tmpGrid = myGrid->NewInstance();
   tmpGrid->ShallowCopy(myGrid);
@@ -2429,126 +2494,124 @@ vtkUnstructuredGrid *
     mmd->Unpack(tmpGrid, DeleteYes);
     }
 
-  for (proc=0; proc < nprocs; proc++)
-    {
-    recvSize[proc] = sendSize[proc] = 0;
-    grids[proc] = NULL;
-    sendBufs[proc] = recvBufs[proc] = NULL;
+  double packTime = 0.0;
+  double unpackTime = 0.0;
+  double startTime = vtkTimerLog::GetUniversalTime();
+
+  // Visit the other processes in pairwise order, so that at any time
+  // each process is sending to a different destination, and build
+  // our own sub grid last.  Between steps, and once all sends are
+  // posted, service whatever receives have completed.
 
-    if (numLists[proc] > 0)
+  for (int step=0; (step < nprocs) || (numPending > 0); step++)
+    {
+    if (step < nprocs)
       {
-      vtkIdType numCells =
-        vtkDistributedDataFilter::GetIdListSize(cellIds[proc], numLists[proc]);
-  
-      if (numCells > 0)
+      double t0 = vtkTimerLog::GetUniversalTime();
+
+      proc = (iam + step + 1) % nprocs;
+
+      if (numLists[proc] > 0)
         {
-        grids[proc] =
-          vtkDistributedDataFilter::ExtractCells(cellIds[proc], numLists[proc],
-                                          deleteCellIds, tmpGrid, mmd);
+        vtkIdType numCells =
+          vtkDistributedDataFilter::GetIdListSize(cellIds[proc], numLists[proc]);
+  
+        if (numCells > 0)
+          {
+          grids[proc] =
+            vtkDistributedDataFilter::ExtractCells(cellIds[proc], numLists[proc],
+                                            deleteCellIds, tmpGrid, mmd);
 
-        if (proc != iam)
+          if (proc != iam)
+            {
+            sendBufs[proc] = this->MarshallDataSet(grids[proc], sendSize[proc]);
+            grids[proc]->Delete();
+            grids[proc] = NULL;
+            }
+          }
+        else if (deleteCellIds)
           {
-          sendBufs[proc] = this->MarshallDataSet(grids[proc], sendSize[proc]);
-          grids[proc]->Delete();
-          grids[proc] = NULL;
+          vtkDistributedDataFilter::FreeIdLists(cellIds[proc], numLists[proc]);
           }
         }
-      else if (deleteCellIds)
+
+      if (proc != iam)
         {
-        vtkDistributedDataFilter::FreeIdLists(cellIds[proc], numLists[proc]);
+        mpiContr->NoBlockSend(sendSize + proc, 1, proc, tag, sendSizeReq[proc]);
+        if (sendSize[proc] > 0)
+          {
+          mpiContr->NoBlockSend(sendBufs[proc], sendSize[proc], proc, tag,
+                                sendBufReq[proc]);
+          }
         }
-      }
-    }
-
-  tmpGrid->Delete();
-
-  // Exchange sizes of grids to send and receive
-
-  vtkMPICommunicator::Request *reqBuf = new vtkMPICommunicator::Request [nprocs];
-    
-  for (proc=0; proc<nprocs; proc++)
-    { 
-    if (proc == iam)
-      {
-      continue;
-      }
-    mpiContr->NoBlockReceive(recvSize + proc, 1, proc, tag, reqBuf[proc]);
-    }
 
-  mpiContr->Barrier();
-
-  for (proc=0; proc<nprocs; proc++)
-    { 
-    if (proc == iam)
-      {
-      continue;
+      packTime += vtkTimerLog::GetUniversalTime() - t0;
       }
-    mpiContr->Send(sendSize + proc, 1, proc, tag);
-    }
 
-  for (proc=0; proc<nprocs; proc++)
-    { 
-    if (proc == iam)
+    for (proc=0; proc < nprocs; proc++)
       {
-      continue;
-      }
-    reqBuf[proc].Wait();
-    }
-
-  // Allocate buffers and post receives
+      if ((recvState[proc] == 1) && (recvSizeReq[proc].Test() == 1))
+        {
+        if (recvSize[proc] > 0)
+          {
+          recvBufs[proc] = new char [recvSize[proc]];
+          mpiContr->NoBlockReceive(recvBufs[proc], recvSize[proc], proc, tag,
+                                   recvBufReq[proc]);
+          recvState[proc] = 2;
+          }
+        else
+          {
+          recvState[proc] = 0;
+          numPending--;
+          }
+        }
+      else if ((recvState[proc] == 2) && (recvBufReq[proc].Test() == 1))
+        {
+        double t0 = vtkTimerLog::GetUniversalTime();
 
-  int numReceives = 0;
+        grids[proc] = this->UnMarshallDataSet(recvBufs[proc], recvSize[proc]);
+        delete [] recvBufs[proc];
+        recvBufs[proc] = NULL;
+        recvState[proc] = 0;
+        numPending--;
 
-  for (proc=0; proc < nprocs; proc++)
-    {
-    if (recvSize[proc] > 0)
-      {
-      recvBufs[proc] = new char [recvSize[proc]];
-      mpiContr->NoBlockReceive(recvBufs[proc], recvSize[proc], proc, tag, reqBuf[proc]);
-      numReceives++;
+        unpackTime += vtkTimerLog::GetUniversalTime() - t0;
+        }
       }
     }
 
-  mpiContr->Barrier();
+  tmpGrid->Delete();
 
-  // Send all sub grids, then delete them
+  // Sub grids we sent may still be in transit
 
   for (proc=0; proc < nprocs; proc++)
     {
-    if (sendSize[proc] > 0)
+    if (proc == iam)
       {
-      mpiContr->Send(sendBufs[proc], sendSize[proc], proc, tag);
+      continue;
       }
-    }
-
-  for (proc=0; proc < nprocs; proc++)
-    {
+    sendSizeReq[proc].Wait();
     if (sendSize[proc] > 0)
       {
+      sendBufReq[proc].Wait();
       delete [] sendBufs[proc];
       }
     }
 
-  delete [] sendSize;
-  delete [] sendBufs;
-
-  // Await incoming sub grids, unpack them
-
-  while (numReceives > 0)
+  if (this->Timing)
     {
-    for (proc=0; proc < nprocs; proc++)
-      {
-      if (recvBufs[proc] && (reqBuf[proc].Test() == 1))
-        {
-        grids[proc] = this->UnMarshallDataSet(recvBufs[proc], recvSize[proc]);
-        delete [] recvBufs[proc];
-        recvBufs[proc] = NULL;
-        numReceives--;
-        }
-      }
+    vtkTimerLog::FormatAndMarkEvent(
+      "D3 exchange (tag %d): pack %g s, unpack %g s, total %g s",
+      tag, packTime, unpackTime, vtkTimerLog::GetUniversalTime() - startTime);
     }
 
-  delete [] reqBuf;
+  delete [] sendSizeReq;
+  delete [] sendBufReq;
+  delete [] recvSizeReq;
+  delete [] recvBufReq;
+  delete [] recvState;
+  delete [] sendSize;
+  delete [] sendBufs;
   delete [] recvBufs;
   delete [] recvSize;
 
@@ -2587,10 +2650,12 @@ vtkUnstructuredGrid *
     int useGlobalNodeIds = (ds[0]->GetPointData()->GetGlobalIds() != NULL);
 
     // this call will merge the grids and then delete them
+    TIMER("D3 merge sub grids");
     mergedGrid = 
       vtkDistributedDataFilter::MergeGrids(ds, numReceivedGrids, DeleteYes,
                                            useGlobalNodeIds, tolerance, 
                                            filterOutDuplicateCells);
+    TIMERDONE("D3 merge sub grids");
 
     }
   else if (numReceivedGrids == 1)
@@ -209,7 +209,9 @@ public:
 
 
   // Description:
-  //  Turn on collection of timing data
+  //  Turn on collection of timing data.  The time spent in each stage
+  //  of the redistribution, and the packing and unpacking time of each
+  //  sub grid exchange, are recorded as vtkTimerLog events.
 
   vtkBooleanMacro(Timing, int);
   vtkSetMacro(Timing, int);
@@ -320,6 +320,8 @@ int vtkPOpenFOAMReader::RequestData(vtkInformation *request,
   int ret = 1;
   if (this->Superclass::Readers->GetNumberOfItems() > 0)
     {
+    this->Superclass::UpdateFieldCache();
+
     int nSteps = 0;
     double *requestedTimeValues = NULL;
     if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS()))
@@ -375,6 +377,8 @@ int vtkPOpenFOAMReader::RequestData(vtkInformation *request,
 
     // known issue: output for process without sub-reader will not have CasePath
     output->GetFieldData()->AddArray(this->Superclass::CasePath);
+
+    this->Superclass::StartFieldPrefetch();
     }
   else
     {
@@ -0,0 +1,245 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellCenterDepthSort.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the threaded sort and the ReuseAngle of vtkCellCenterDepthSort
+// .SECTION Description
+// Sorts the cells of a jittered structured grid with one and with four
+// threads and checks that both orders follow the cell depths and agree up
+// to cells of equal depth.  With a ReuseAngle, a small camera motion must
+// keep the last order, while turning the camera around or flipping the
+// sort direction must sort the cells again.  No rendering is involved.
+
+#include "vtkCamera.h"
+#include "vtkCellCenterDepthSort.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+
+#include <vtkstd/vector>
+
+#include <math.h>
+
+typedef vtkstd::vector<vtkIdType> vtkCellOrder;
+
+//----------------------------------------------------------------------------
+static void GetOrder(vtkVisibilitySort *sort, vtkCellOrder &order)
+{
+  order.clear();
+  sort->InitTraversal();
+  vtkIdTypeArray *cells;
+  while ((cells = sort->GetNextCells()) != NULL)
+    {
+    for (vtkIdType i = 0; i < cells->GetNumberOfTuples(); i++)
+      {
+      order.push_back(cells->GetValue(i));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Depths of the cell centers along the sort direction of the camera.
+static void GetDepths(vtkStructuredGrid *grid, vtkCamera *camera,
+                      int direction, vtkstd::vector<double> &depths)
+{
+  double position[3], focalPoint[3], vector[3];
+  camera->GetPosition(position);
+  camera->GetFocalPoint(focalPoint);
+  for (int j = 0; j < 3; j++)
+    {
+    vector[j] = position[j] - focalPoint[j];
+    if (direction == vtkVisibilitySort::FRONT_TO_BACK)
+      {
+      vector[j] = -vector[j];
+      }
+    }
+
+  vtkIdList *ptIds = vtkIdList::New();
+  depths.resize(grid->GetNumberOfCells());
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); i++)
+    {
+    grid->GetCellPoints(i, ptIds);
+    double center[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType k = 0; k < ptIds->GetNumberOfIds(); k++)
+      {
+      double *x = grid->GetPoint(ptIds->GetId(k));
+      center[0] += x[0]; center[1] += x[1]; center[2] += x[2];
+      }
+    depths[i] = vtkMath::Dot(center, vector) / ptIds->GetNumberOfIds();
+    }
+  ptIds->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Checks that order holds every cell once in the order of the depths.
+static int CheckOrder(const vtkCellOrder &order,
+                      const vtkstd::vector<double> &depths, double tol)
+{
+  if (order.size() != depths.size())
+    {
+    cerr << "Got " << order.size() << " of " << depths.size() << " cells.\n";
+    return 0;
+    }
+  vtkstd::vector<char> seen(order.size(), 0);
+  for (size_t i = 0; i < order.size(); i++)
+    {
+    if (order[i] < 0 || order[i] >= static_cast<vtkIdType>(order.size()) ||
+        seen[order[i]])
+      {
+      cerr << "Cell " << order[i] << " is invalid or returned twice.\n";
+      return 0;
+      }
+    seen[order[i]] = 1;
+    if (i > 0 && depths[order[i]] < depths[order[i-1]] - tol)
+      {
+      cerr << "Cell " << order[i] << " is out of order.\n";
+      return 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Compares two orders up to cells of equal depth.
+static int SameOrder(const vtkCellOrder &a, const vtkCellOrder &b,
+                     const vtkstd::vector<double> &depths, double tol)
+{
+  if (a.size() != b.size())
+    {
+    return 0;
+    }
+  for (size_t i = 0; i < a.size(); i++)
+    {
+    if (a[i] != b[i] && fabs(depths[a[i]] - depths[b[i]]) > tol)
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+static vtkSmartPointer<vtkCellCenterDepthSort> NewSort(
+  vtkStructuredGrid *grid, vtkCamera *camera, int numThreads,
+  double reuseAngle)
+{
+  vtkSmartPointer<vtkCellCenterDepthSort> sort =
+    vtkSmartPointer<vtkCellCenterDepthSort>::New();
+  sort->SetInput(grid);
+  sort->SetCamera(camera);
+  sort->SetNumberOfThreads(numThreads);
+  sort->SetReuseAngle(reuseAngle);
+  // several partitions, to exercise the incremental sort of one thread
+  sort->SetMaxCellsReturned(1000);
+  return sort;
+}
+
+//----------------------------------------------------------------------------
+int TestCellCenterDepthSort(int, char *[])
+{
+  // a grid large enough to be split among four threads, jittered so that
+  // few cells have the same depth
+  const int dim = 40;
+  vtkMath::RandomSeed(4321);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int k = 0; k < dim; k++)
+    {
+    for (int j = 0; j < dim; j++)
+      {
+      for (int i = 0; i < dim; i++)
+        {
+        points->InsertNextPoint(i + vtkMath::Random(-0.3, 0.3),
+                                j + vtkMath::Random(-0.3, 0.3),
+                                k + vtkMath::Random(-0.3, 0.3));
+        }
+      }
+    }
+  vtkSmartPointer<vtkStructuredGrid> grid =
+    vtkSmartPointer<vtkStructuredGrid>::New();
+  grid->SetDimensions(dim, dim, dim);
+  grid->SetPoints(points);
+
+  vtkSmartPointer<vtkCamera> camera = vtkSmartPointer<vtkCamera>::New();
+  camera->SetFocalPoint(20.0, 20.0, 20.0);
+  camera->SetPosition(110.0, 65.0, 140.0);
+  camera->SetViewUp(0.0, 1.0, 0.0);
+
+  // tolerance on the depth of cells that may come in either order
+  const double tol = 1e-3;
+  int rval = 0;
+  vtkstd::vector<double> depths;
+  GetDepths(grid, camera, vtkVisibilitySort::BACK_TO_FRONT, depths);
+
+  // one and four threads
+  vtkCellOrder serial, threaded;
+  GetOrder(NewSort(grid, camera, 1, 0.0), serial);
+  GetOrder(NewSort(grid, camera, 4, 0.0), threaded);
+  if (!CheckOrder(serial, depths, tol) || !CheckOrder(threaded, depths, tol))
+    {
+    cerr << "The cells are not sorted back to front.\n";
+    rval = 1;
+    }
+  else if (!SameOrder(serial, threaded, depths, tol))
+    {
+    cerr << "The order of four threads differs from one thread.\n";
+    rval = 1;
+    }
+
+  for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+    {
+    camera->SetPosition(110.0, 65.0, 140.0);
+    vtkSmartPointer<vtkCellCenterDepthSort> sort =
+      NewSort(grid, camera, numThreads, 5.0);
+    vtkCellOrder first, order, fresh;
+    GetOrder(sort, first);
+
+    // a small motion keeps the order of the last sort
+    camera->Azimuth(2.0);
+    GetOrder(sort, order);
+    GetDepths(grid, camera, vtkVisibilitySort::BACK_TO_FRONT, depths);
+    GetOrder(NewSort(grid, camera, numThreads, 0.0), fresh);
+    if (order != first || SameOrder(order, fresh, depths, tol))
+      {
+      cerr << "The order was not reused for a small motion with "
+           << numThreads << " threads.\n";
+      rval = 1;
+      }
+
+    // looking from the other side sorts again
+    camera->Azimuth(178.0);
+    GetOrder(sort, order);
+    GetDepths(grid, camera, vtkVisibilitySort::BACK_TO_FRONT, depths);
+    if (!CheckOrder(order, depths, tol))
+      {
+      cerr << "The cells were not sorted again for the opposite view with "
+           << numThreads << " threads.\n";
+      rval = 1;
+      }
+
+    // so does flipping the direction
+    sort->SetDirectionToFrontToBack();
+    GetOrder(sort, order);
+    GetDepths(grid, camera, vtkVisibilitySort::FRONT_TO_BACK, depths);
+    if (!CheckOrder(order, depths, tol))
+      {
+      cerr << "The cells were not sorted again front to back with "
+           << numThreads << " threads.\n";
+      rval = 1;
+      }
+    }
+
+  return rval;
+}
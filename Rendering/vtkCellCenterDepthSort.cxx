@@ -29,8 +29,9 @@
 #include "vtkCamera.h"
 #include "vtkMatrix4x4.h"
 #include "vtkFloatArray.h"
-#include "vtkCell.h"
+#include "vtkGenericCell.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
 #include "vtkSortDataArray.h"
 
 #include <vtkstd/stack>
@@ -49,6 +50,90 @@ public:
 
 //-----------------------------------------------------------------------------
 
+// Cells are only split among threads when every thread gets at least this
+// many of them.
+#define VTK_CELL_CENTER_DEPTH_SORT_MIN_CELLS_PER_THREAD 8192
+
+struct vtkCellCenterDepthSortThreadData
+{
+  vtkDataSet *Input;
+  vtkIdType NumberOfCells;
+  int MaxCellSize;
+  float *Centers;
+  float *Depths;        // NULL when computing the centers
+  const float *Vector;
+};
+
+// Compute the centers or the depths of a range of cells.
+static VTK_THREAD_RETURN_TYPE vtkCellCenterDepthSortThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkCellCenterDepthSortThreadData *data =
+    static_cast<vtkCellCenterDepthSortThreadData *>(info->UserData);
+  vtkIdType begin = data->NumberOfCells*info->ThreadID/info->NumberOfThreads;
+  vtkIdType end
+    = data->NumberOfCells*(info->ThreadID + 1)/info->NumberOfThreads;
+  float *center = data->Centers + 3*begin;
+
+  if (data->Depths)
+    {
+    float *depth = data->Depths + begin;
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      *(depth++) = vtkMath::Dot(center, data->Vector);
+      center += 3;
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  vtkGenericCell *cell = vtkGenericCell::New();
+  double dcenter[3];
+  double *weights = new double[data->MaxCellSize];  //Dummy array.
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    data->Input->GetCell(i, cell);
+    double pcenter[3];
+    int subId;
+    subId = cell->GetParametricCenter(pcenter);
+    cell->EvaluateLocation(subId, pcenter, dcenter, weights);
+    center[0] = dcenter[0]; center[1] = dcenter[1]; center[2] = dcenter[2];
+    center += 3;
+    }
+  delete[] weights;
+  cell->Delete();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+static void vtkCellCenterDepthSortExecute(vtkCellCenterDepthSortThreadData *data,
+                                          int numThreads)
+{
+  vtkIdType maxThreads
+    = data->NumberOfCells/VTK_CELL_CENTER_DEPTH_SORT_MIN_CELLS_PER_THREAD;
+  if (numThreads > maxThreads)
+    {
+    numThreads = static_cast<int>(maxThreads);
+    }
+  if (numThreads <= 1)
+    {
+    vtkMultiThreader::ThreadInfo info;
+    info.ThreadID = 0;
+    info.NumberOfThreads = 1;
+    info.UserData = data;
+    vtkCellCenterDepthSortThread(&info);
+    return;
+    }
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numThreads);
+  threader->SetSingleMethod(vtkCellCenterDepthSortThread, data);
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
+
+//-----------------------------------------------------------------------------
+
 vtkStandardNewMacro(vtkCellCenterDepthSort);
 
 vtkCellCenterDepthSort::vtkCellCenterDepthSort()
@@ -66,6 +151,13 @@ vtkCellCenterDepthSort::vtkCellCenterDepthSort()
   this->CellPartitionDepths->SetNumberOfComponents(1);
 
   this->ToSort = new vtkCellCenterDepthSortStack;
+
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  this->ReuseAngle = 0.0;
+  this->SortedProjectionVector[0] = 0.0;
+  this->SortedProjectionVector[1] = 0.0;
+  this->SortedProjectionVector[2] = 0.0;
+  this->FullySorted = 0;
 }
 
 vtkCellCenterDepthSort::~vtkCellCenterDepthSort()
@@ -82,6 +174,9 @@ vtkCellCenterDepthSort::~vtkCellCenterDepthSort()
 void vtkCellCenterDepthSort::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
+  os << indent << "ReuseAngle: " << this->ReuseAngle << endl;
 }
 
 float *vtkCellCenterDepthSort::ComputeProjectionVector()
@@ -130,23 +225,24 @@ void vtkCellCenterDepthSort::ComputeCellCenters()
 {
   vtkIdType numcells = this->Input->GetNumberOfCells();
   this->CellCenters->SetNumberOfTuples(numcells);
-
-  float *center = this->CellCenters->GetPointer(0);
-  double dcenter[3];
-  double *weights = new double[this->Input->GetMaxCellSize()];  //Dummy array.
-
-  for (vtkIdType i = 0; i < numcells; i++)
+  if (numcells == 0)
     {
-    vtkCell *cell = this->Input->GetCell(i);
-    double pcenter[3];
-    int subId;
-    subId = cell->GetParametricCenter(pcenter);
-    cell->EvaluateLocation(subId, pcenter, dcenter, weights);
-    center[0] = dcenter[0]; center[1] = dcenter[1]; center[2] = dcenter[2];
-    center += 3;
+    return;
     }
 
-  delete[] weights;
+  // GetCell() is only thread safe once it was called from a single thread.
+  vtkGenericCell *cell = vtkGenericCell::New();
+  this->Input->GetCell(0, cell);
+  cell->Delete();
+
+  vtkCellCenterDepthSortThreadData data;
+  data.Input = this->Input;
+  data.NumberOfCells = numcells;
+  data.MaxCellSize = this->Input->GetMaxCellSize();
+  data.Centers = this->CellCenters->GetPointer(0);
+  data.Depths = NULL;
+  data.Vector = NULL;
+  vtkCellCenterDepthSortExecute(&data, this->NumberOfThreads);
 }
 
 void vtkCellCenterDepthSort::ComputeDepths()
@@ -154,13 +250,18 @@ void vtkCellCenterDepthSort::ComputeDepths()
   float *vector = this->ComputeProjectionVector();
   vtkIdType numcells = this->Input->GetNumberOfCells();
 
-  float *center = this->CellCenters->GetPointer(0);
-  float *depth = this->CellDepths->GetPointer(0);
-  for (vtkIdType i = 0; i < numcells; i++)
-    {
-    *(depth++) = vtkMath::Dot(center, vector);
-    center += 3;
-    }
+  vtkCellCenterDepthSortThreadData data;
+  data.Input = this->Input;
+  data.NumberOfCells = numcells;
+  data.MaxCellSize = 0;
+  data.Centers = this->CellCenters->GetPointer(0);
+  data.Depths = this->CellDepths->GetPointer(0);
+  data.Vector = vector;
+  vtkCellCenterDepthSortExecute(&data, this->NumberOfThreads);
+
+  this->SortedProjectionVector[0] = vector[0];
+  this->SortedProjectionVector[1] = vector[1];
+  this->SortedProjectionVector[2] = vector[2];
 }
 
 void vtkCellCenterDepthSort::InitTraversal()
@@ -169,6 +270,9 @@ void vtkCellCenterDepthSort::InitTraversal()
 
   vtkIdType numcells = this->Input->GetNumberOfCells();
 
+  while (!this->ToSort->Stack.empty()) this->ToSort->Stack.pop();
+  this->ToSort->Stack.push(vtkIdPair(0, numcells));
+
   if (   (this->LastSortTime < this->Input->GetMTime())
       || (this->LastSortTime < this->MTime) )
     {
@@ -178,6 +282,21 @@ void vtkCellCenterDepthSort::InitTraversal()
     this->ComputeCellCenters();
     this->CellDepths->SetNumberOfTuples(numcells);
     this->SortedCells->SetNumberOfTuples(numcells);
+    this->FullySorted = 0;
+    }
+  else if (this->FullySorted && (this->ReuseAngle > 0.0))
+    {
+    // Keep the last order if the view direction barely changed.
+    float *vector = this->ComputeProjectionVector();
+    double norms = (  vtkMath::Norm(vector)
+                    * vtkMath::Norm(this->SortedProjectionVector) );
+    if (   (norms > 0.0)
+        && (  vtkMath::Dot(vector, this->SortedProjectionVector)
+            >= norms*cos(vtkMath::RadiansFromDegrees(this->ReuseAngle)) ) )
+      {
+      vtkDebugMacro("Reusing the last order.");
+      return;
+      }
     }
 
   vtkDebugMacro("Filling SortedCells to initial values.");
@@ -190,8 +309,14 @@ void vtkCellCenterDepthSort::InitTraversal()
   vtkDebugMacro("Calculating depths.");
   this->ComputeDepths();
 
-  while (!this->ToSort->Stack.empty()) this->ToSort->Stack.pop();
-  this->ToSort->Stack.push(vtkIdPair(0, numcells));
+  // With several threads, sort everything now with the parallel sort of
+  // vtkSortDataArray.
+  this->FullySorted = 0;
+  if (this->NumberOfThreads > 1)
+    {
+    vtkSortDataArray::Sort(this->CellDepths, this->SortedCells);
+    this->FullySorted = 1;
+    }
 
   this->LastSortTime.Modified();
 }
@@ -201,6 +326,7 @@ vtkIdTypeArray *vtkCellCenterDepthSort::GetNextCells()
   if (this->ToSort->Stack.empty())
     {
     // Already sorted and returned everything.
+    this->FullySorted = 1;
     return NULL;
     }
 
@@ -209,6 +335,26 @@ vtkIdTypeArray *vtkCellCenterDepthSort::GetNextCells()
   vtkIdPair partition;
 
   partition = this->ToSort->Stack.top();  this->ToSort->Stack.pop();
+  if (this->FullySorted)
+    {
+    // The cells are already in order.  Return the next range.
+    if (partition.second - partition.first > this->MaxCellsReturned)
+      {
+      this->ToSort->Stack.push(
+        vtkIdPair(partition.first + this->MaxCellsReturned, partition.second));
+      partition.second = partition.first + this->MaxCellsReturned;
+      }
+    if (partition.second <= partition.first)
+      {
+      return this->GetNextCells();
+      }
+    this->SortedCellPartition->SetArray(cellIds + partition.first,
+                                        partition.second - partition.first, 1);
+    this->SortedCellPartition->SetNumberOfTuples(
+                                        partition.second - partition.first);
+    return this->SortedCellPartition;
+    }
+
   while (partition.second - partition.first > this->MaxCellsReturned)
     {
     vtkIdType left = partition.first;
@@ -32,6 +32,15 @@
 // camera transformed into object space.  It then performs an ordinary sort
 // on the result.
 //
+// The cell centers and depths are computed by NumberOfThreads threads.
+// With more than one thread, InitTraversal() sorts all the cells at once
+// with vtkSortDataArray, and GetNextCells() just hands out consecutive
+// ranges; with one thread the cells are sorted incrementally as they are
+// requested.  Setting ReuseAngle keeps the order of the previous sort
+// while the view direction stays within that angle of the direction it was
+// computed for, which skips the depth computation and the sort for small
+// camera motions.
+//
 
 #ifndef __vtkCellCenterDepthSort_h
 #define __vtkCellCenterDepthSort_h
@@ -52,6 +61,24 @@ public:
   virtual void InitTraversal();
   virtual vtkIdTypeArray *GetNextCells();
 
+  // Description:
+  // Set/Get the number of threads used to compute the cell centers and
+  // depths.  The default is the global default number of threads of
+  // vtkMultiThreader, so on a multi-core machine all the cells are sorted
+  // in InitTraversal() before the first ones are handed out.  Set it to 1
+  // to sort them incrementally, which hands out the first cells sooner.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Set/Get the largest angle, in degrees, between the current view
+  // direction and the one of the last sort for which the last order is
+  // reused.  The order is only approximate anyway, and small camera motions
+  // rarely change it much.  The default is 0, which sorts the cells on
+  // every traversal.
+  vtkSetClampMacro(ReuseAngle, double, 0.0, 90.0);
+  vtkGetMacro(ReuseAngle, double);
+
 protected:
   vtkCellCenterDepthSort();
   virtual ~vtkCellCenterDepthSort();
@@ -63,6 +90,15 @@ protected:
   vtkFloatArray *CellDepths;
   vtkFloatArray *CellPartitionDepths;
 
+  int NumberOfThreads;
+  double ReuseAngle;
+
+  // Description:
+  // The view direction of the last sort, and whether SortedCells holds
+  // all the cells in order.
+  float SortedProjectionVector[3];
+  int FullySorted;
+
   virtual float *ComputeProjectionVector();
   virtual void ComputeCellCenters();
   virtual void ComputeDepths();
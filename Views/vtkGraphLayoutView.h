@@ -163,6 +163,7 @@ public:
   //  - "Circular"      Places vertices uniformly on a circle.
   //  - "Cone"          Cone tree layout.
   //  - "Span Tree"     Span Tree Layout.
+  //  - "Barnes Hut"    A force directed layout for large graphs, 2D or 3D.
   // Default is "Simple 2D".
   void SetLayoutStrategy(const char* name);
   void SetLayoutStrategyToRandom()
@@ -189,6 +190,8 @@ public:
     { this->SetLayoutStrategy("Cone"); }
   void SetLayoutStrategyToSpanTree()
     { this->SetLayoutStrategy("Span Tree"); }
+  void SetLayoutStrategyToBarnesHut()
+    { this->SetLayoutStrategy("Barnes Hut"); }
   const char* GetLayoutStrategyName();
 
   // Description:
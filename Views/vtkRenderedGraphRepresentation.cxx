@@ -28,6 +28,7 @@
 #include "vtkApplyIcons.h"
 #include "vtkArcParallelEdgeStrategy.h"
 #include "vtkAssignCoordinatesLayoutStrategy.h"
+#include "vtkBarnesHutLayoutStrategy.h"
 #include "vtkCellData.h"
 #include "vtkCircularLayoutStrategy.h"
 #include "vtkClustering2DLayoutStrategy.h"
@@ -729,6 +730,10 @@ void vtkRenderedGraphRepresentation::SetLayoutStrategy(vtkGraphLayoutStrategy* s
     {
     this->SetLayoutStrategyName("Span Tree");
     }
+  else if (vtkBarnesHutLayoutStrategy::SafeDownCast(s))
+    {
+    this->SetLayoutStrategyName("Barnes Hut");
+    }
   else
     {
     this->SetLayoutStrategyName("Unknown");
@@ -792,6 +797,10 @@ void vtkRenderedGraphRepresentation::SetLayoutStrategy(const char* name)
     {
     strategy = vtkSmartPointer<vtkSpanTreeLayoutStrategy>::New();
     }
+  else if (str == "barneshut")
+    {
+    strategy = vtkSmartPointer<vtkBarnesHutLayoutStrategy>::New();
+    }
   else if (str != "passthrough")
     {
     vtkErrorMacro("Unknown layout strategy: \"" << name << "\"");
@@ -242,6 +242,8 @@ public:
     { this->SetLayoutStrategy("Cone"); }
   void SetLayoutStrategyToSpanTree()
     { this->SetLayoutStrategy("Span Tree"); }
+  void SetLayoutStrategyToBarnesHut()
+    { this->SetLayoutStrategy("Barnes Hut"); }
 
   // Description:
   // Set the layout strategy to use coordinates from arrays.
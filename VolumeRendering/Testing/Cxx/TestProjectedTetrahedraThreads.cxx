@@ -0,0 +1,148 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestProjectedTetrahedraThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the threaded vtkOpenGLProjectedTetrahedraMapper
+// .SECTION Description
+// Renders a tetrahedral mesh of more than a hundred thousand cells with
+// vtkProjectedTetrahedraMapper with one and with four threads, and checks
+// that the images are identical and not empty.  With four threads the
+// cells are sorted all at once and come in batches that are projected by
+// four threads and drawn with one glDrawElements call per thread; the
+// last batch is smaller and uses fewer threads.  With one thread the cells
+// are sorted incrementally and drawn one batch of 1000 cells at a time.
+// The points of the mesh are jittered so that no two cells have the same
+// depth, and both sorts give the same order.
+
+#include "vtkBrownianPoints.h"
+#include "vtkColorTransferFunction.h"
+#include "vtkCamera.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkPiecewiseFunction.h"
+#include "vtkProjectedTetrahedraMapper.h"
+#include "vtkRenderer.h"
+#include "vtkRenderWindow.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkVolume.h"
+#include "vtkVolumeProperty.h"
+#include "vtkWarpVector.h"
+#include "vtkWindowToImageFilter.h"
+
+#include "vtkSmartPointer.h"
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New();
+
+#include <string.h>
+
+//----------------------------------------------------------------------------
+static vtkSmartPointer<vtkImageData> RenderImage(vtkRenderWindow *renwin)
+{
+  renwin->Render();
+  VTK_CREATE(vtkWindowToImageFilter, grab);
+  grab->SetInput(renwin);
+  grab->Update();
+  VTK_CREATE(vtkImageData, image);
+  image->DeepCopy(grab->GetOutput());
+  return image;
+}
+
+//----------------------------------------------------------------------------
+int TestProjectedTetrahedraThreads(int, char *[])
+{
+  VTK_CREATE(vtkRTAnalyticSource, input);
+  input->SetWholeExtent(-15, 15, -15, 15, -15, 15);
+  input->SetCenter(0.0, 0.0, 0.0);
+
+  VTK_CREATE(vtkDataSetTriangleFilter, tetra);
+  tetra->SetInputConnection(input->GetOutputPort());
+
+  vtkMath::RandomSeed(4321);
+  VTK_CREATE(vtkBrownianPoints, brownian);
+  brownian->SetInputConnection(tetra->GetOutputPort());
+  brownian->SetMinimumSpeed(0.0);
+  brownian->SetMaximumSpeed(1.0);
+  VTK_CREATE(vtkWarpVector, jitter);
+  jitter->SetInputConnection(brownian->GetOutputPort());
+  jitter->SetScaleFactor(0.3);
+  jitter->Update();
+
+  // several full batches of four threads, and a partial one
+  vtkIdType numCells = jitter->GetOutput()->GetNumberOfCells();
+  if (numCells < 6*4*4096)
+    {
+    cerr << "The mesh has only " << numCells << " cells.\n";
+    return 1;
+    }
+
+  VTK_CREATE(vtkProjectedTetrahedraMapper, mapper);
+  mapper->SetInputConnection(jitter->GetOutputPort());
+
+  VTK_CREATE(vtkColorTransferFunction, color);
+  color->AddRGBPoint(37.0, 0.0, 0.0, 1.0);
+  color->AddRGBPoint(277.0, 1.0, 0.5, 0.0);
+  VTK_CREATE(vtkPiecewiseFunction, opacity);
+  opacity->AddPoint(37.0, 0.05);
+  opacity->AddPoint(277.0, 0.3);
+
+  VTK_CREATE(vtkVolume, volume);
+  volume->SetMapper(mapper);
+  volume->GetProperty()->SetColor(color);
+  volume->GetProperty()->SetScalarOpacity(opacity);
+
+  VTK_CREATE(vtkRenderer, renderer);
+  renderer->AddVolume(volume);
+  renderer->SetBackground(1, 1, 1);
+  renderer->ResetCamera();
+  renderer->GetActiveCamera()->Azimuth(30.0);
+  renderer->GetActiveCamera()->Elevation(20.0);
+
+  VTK_CREATE(vtkRenderWindow, renwin);
+  renwin->SetSize(300, 300);
+  renwin->AddRenderer(renderer);
+
+  mapper->SetNumberOfThreads(1);
+  vtkSmartPointer<vtkImageData> serial = RenderImage(renwin);
+  mapper->SetNumberOfThreads(4);
+  vtkSmartPointer<vtkImageData> threaded = RenderImage(renwin);
+
+  int *dims = serial->GetDimensions();
+  int numComp = serial->GetNumberOfScalarComponents();
+  int size = dims[0]*dims[1]*numComp;
+  unsigned char *pixels =
+    static_cast<unsigned char *>(serial->GetScalarPointer());
+  int numDrawn = 0;
+  for (int j = 0; j < size; j++)
+    {
+    numDrawn += (pixels[j] != 255);
+    }
+  if (numDrawn == 0)
+    {
+    cerr << "Nothing was rendered with one thread.\n";
+    return 1;
+    }
+
+  int *dimsThreaded = threaded->GetDimensions();
+  if (dimsThreaded[0] != dims[0] || dimsThreaded[1] != dims[1] ||
+      threaded->GetNumberOfScalarComponents() != numComp ||
+      memcmp(pixels, threaded->GetScalarPointer(), size) != 0)
+    {
+    cerr << "The image rendered with four threads differs from the one "
+         << "rendered with one thread.\n";
+    return 1;
+    }
+
+  return 0;
+}
@@ -0,0 +1,145 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestUnstructuredGridRayCastThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the threaded vtkUnstructuredGridVolumeRayCastMapper
+// .SECTION Description
+// Renders a thresholded, hence concave, tetrahedral mesh with one and with
+// four threads, which take image tiles dynamically and build the Bunyk
+// intersection lists by bands of rows.  Checks that the images are
+// identical and not empty, and that one ray was cast per pixel of the
+// image in use.
+
+#include "vtkCamera.h"
+#include "vtkColorTransferFunction.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkImageData.h"
+#include "vtkPiecewiseFunction.h"
+#include "vtkRenderer.h"
+#include "vtkRenderWindow.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkThreshold.h"
+#include "vtkUnstructuredGridVolumeRayCastMapper.h"
+#include "vtkVolume.h"
+#include "vtkVolumeProperty.h"
+#include "vtkWindowToImageFilter.h"
+
+#include "vtkSmartPointer.h"
+#define VTK_CREATE(type, name) \
+  vtkSmartPointer<type> name = vtkSmartPointer<type>::New();
+
+#include <string.h>
+
+int TestUnstructuredGridRayCastThreads(int, char *[])
+{
+  VTK_CREATE(vtkRTAnalyticSource, input);
+  input->SetWholeExtent(-10, 10, -10, 10, -10, 10);
+  input->SetCenter(0.0, 0.0, 0.0);
+  input->SetMaximum(255.0);
+  input->SetXFreq(60.0);
+  input->SetYFreq(30.0);
+  input->SetZFreq(40.0);
+  input->SetXMag(10.0);
+  input->SetYMag(18.0);
+  input->SetZMag(5.0);
+  input->SetStandardDeviation(0.5);
+  input->SetSubsampleRate(1);
+
+  VTK_CREATE(vtkThreshold, threshold);
+  threshold->SetInputConnection(input->GetOutputPort());
+  threshold->ThresholdByLower(130.0);
+
+  VTK_CREATE(vtkDataSetTriangleFilter, tetra);
+  tetra->SetInputConnection(threshold->GetOutputPort());
+
+  VTK_CREATE(vtkUnstructuredGridVolumeRayCastMapper, raycast);
+  raycast->SetInputConnection(tetra->GetOutputPort());
+  // the same sampling for both renders
+  raycast->AutoAdjustSampleDistancesOff();
+  raycast->SetImageSampleDistance(1.0);
+
+  VTK_CREATE(vtkVolume, volume);
+  volume->SetMapper(raycast);
+
+  VTK_CREATE(vtkColorTransferFunction, color);
+  color->AddRGBPoint(0.0, 0.0, 0.0, 1.0);
+  color->AddRGBPoint(130.0, 1.0, 0.5, 0.0);
+  VTK_CREATE(vtkPiecewiseFunction, opacity);
+  opacity->AddPoint(0.0, 0.1);
+  opacity->AddPoint(130.0, 0.4);
+  volume->GetProperty()->SetColor(color);
+  volume->GetProperty()->SetScalarOpacity(opacity);
+
+  VTK_CREATE(vtkRenderer, renderer);
+  renderer->AddVolume(volume);
+  renderer->SetBackground(1, 1, 1);
+
+  renderer->ResetCamera();
+  vtkCamera *camera = renderer->GetActiveCamera();
+  camera->Azimuth(40.0);
+  camera->Elevation(40.0);
+
+  VTK_CREATE(vtkRenderWindow, renwin);
+  renwin->SetSize(300, 300);
+  renwin->AddRenderer(renderer);
+
+  vtkSmartPointer<vtkImageData> images[2];
+  for (int i = 0; i < 2; i++)
+    {
+    raycast->SetNumberOfThreads(i == 0 ? 1 : 4);
+    renwin->Render();
+    VTK_CREATE(vtkWindowToImageFilter, grab);
+    grab->SetInput(renwin);
+    grab->Update();
+    images[i] = vtkSmartPointer<vtkImageData>::New();
+    images[i]->DeepCopy(grab->GetOutput());
+
+    int *size = raycast->GetImageInUseSize();
+    if (raycast->GetNumberOfRaysCast() !=
+        static_cast<vtkIdType>(size[0])*size[1])
+      {
+      cerr << "Cast " << raycast->GetNumberOfRaysCast() << " rays for "
+           << size[0] << "x" << size[1] << " pixels with "
+           << raycast->GetNumberOfThreads() << " threads.\n";
+      return 1;
+      }
+    }
+
+  int *dims = images[0]->GetDimensions();
+  int numComp = images[0]->GetNumberOfScalarComponents();
+  int size = dims[0]*dims[1]*numComp;
+  unsigned char *pixels =
+    static_cast<unsigned char *>(images[0]->GetScalarPointer());
+  int numDrawn = 0;
+  for (int j = 0; j < size; j++)
+    {
+    numDrawn += (pixels[j] != 255);
+    }
+  if (numDrawn == 0)
+    {
+    cerr << "Nothing was rendered with one thread.\n";
+    return 1;
+    }
+
+  int *dims4 = images[1]->GetDimensions();
+  if (dims4[0] != dims[0] || dims4[1] != dims[1] ||
+      images[1]->GetNumberOfScalarComponents() != numComp ||
+      memcmp(pixels, images[1]->GetScalarPointer(), size) != 0)
+    {
+    cerr << "The image rendered with four threads differs from the one "
+         << "rendered with one thread.\n";
+    return 1;
+    }
+
+  return 0;
+}
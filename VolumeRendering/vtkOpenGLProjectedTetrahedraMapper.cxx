@@ -26,11 +26,13 @@
 
 #include "vtkCamera.h"
 #include "vtkCellArray.h"
+#include "vtkCellCenterDepthSort.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
 #include "vtkIdTypeArray.h"
 #include "vtkMath.h"
 #include "vtkMatrix4x4.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkRenderer.h"
@@ -46,6 +48,7 @@
 
 #include <math.h>
 #include <vtkstd/algorithm>
+#include <vtkstd/vector>
 
 //-----------------------------------------------------------------------------
 
@@ -55,6 +58,10 @@ static int tet_edges[6][2] = { {0,1}, {1,2}, {2,0},
 
 const int SqrtTableSize = 2048;
 
+// Batches of cells are only split among threads when every thread gets at
+// least this many cells.
+#define VTK_PROJECTED_TETRAHEDRA_MIN_CELLS_PER_THREAD 4096
+
 //-----------------------------------------------------------------------------
 
 vtkStandardNewMacro(vtkOpenGLProjectedTetrahedraMapper);
@@ -345,6 +352,357 @@ inline float vtkOpenGLProjectedTetrahedraMapper::GetCorrectedDepth(
     }
 }
 
+//-----------------------------------------------------------------------------
+
+// The cells returned by one call to vtkVisibilitySort::GetNextCells() and the
+// vertices, colors, texture coordinates and triangles they project to.  Each
+// cell has its own slots in the buffers, so the threads can fill them
+// independently; the triangles of the cells of each thread are drawn in
+// order once all of them are done.
+struct vtkOpenGLProjectedTetrahedraMapper::ProjectionBatch
+{
+  vtkOpenGLProjectedTetrahedraMapper *Self;
+  const float *TransformedPoints;
+  const vtkIdType *Cells;
+  const unsigned char *CellColors;
+  const float *InverseProjection;
+  int UseLinearDepthCorrection;
+  float LinearDepthCorrection;
+
+  const vtkIdType *CellIds;
+  vtkIdType NumberOfCells;
+
+  vtkstd::vector<float> PointsBuffer;
+  vtkstd::vector<unsigned char> ColorsBuffer;
+  vtkstd::vector<float> TexCoordsBuffer;
+  vtkstd::vector<GLuint> IndicesBuffer;
+  float *Points;                // 5 vertices per cell
+  unsigned char *Colors;        // 5 colors per cell
+  float *TexCoords;             // 5 texture coordinates per cell
+  GLuint *Indices;              // up to 4 triangles per cell
+  vtkIdType NumberOfIndices[VTK_MAX_THREADS];
+
+  void Allocate(vtkIdType numCells)
+    {
+    if (static_cast<vtkIdType>(this->IndicesBuffer.size()) < 12*numCells)
+      {
+      this->PointsBuffer.resize(15*numCells);
+      this->ColorsBuffer.resize(15*numCells);
+      this->TexCoordsBuffer.resize(10*numCells);
+      this->IndicesBuffer.resize(12*numCells);
+      }
+    this->Points = &this->PointsBuffer[0];
+    this->Colors = &this->ColorsBuffer[0];
+    this->TexCoords = &this->TexCoordsBuffer[0];
+    this->Indices = &this->IndicesBuffer[0];
+    }
+};
+
+VTK_THREAD_RETURN_TYPE
+vtkOpenGLProjectedTetrahedraMapper::ProjectTetrahedraThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  ProjectionBatch *batch = static_cast<ProjectionBatch *>(info->UserData);
+  vtkOpenGLProjectedTetrahedraMapper *self = batch->Self;
+  const float *points = batch->TransformedPoints;
+  const vtkIdType *cells = batch->Cells;
+
+  vtkIdType begin = batch->NumberOfCells*info->ThreadID/info->NumberOfThreads;
+  vtkIdType end
+    = batch->NumberOfCells*(info->ThreadID + 1)/info->NumberOfThreads;
+  GLuint *indices = batch->Indices + 12*begin;
+
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    vtkIdType cell = batch->CellIds[i];
+    float *tet_points = batch->Points + 15*i;
+    unsigned char *tet_colors = batch->Colors + 15*i;
+    float *tet_texcoords = batch->TexCoords + 10*i;
+    GLuint base = static_cast<GLuint>(5*i);
+    int j;
+
+    // Get the data for the tetrahedra.
+    for (j = 0; j < 4; j++)
+      {
+      // Assuming we only have tetrahedra, each entry in cells has 5
+      // components.
+      const float *p = points + 3*cells[5*cell + j + 1];
+      tet_points[j*3 + 0] = p[0];
+      tet_points[j*3 + 1] = p[1];
+      tet_points[j*3 + 2] = p[2];
+
+      const unsigned char *c;
+      if (self->UsingCellColors)
+        {
+        c = batch->CellColors + 4*cell;
+        }
+      else
+        {
+        c = batch->CellColors + 4*cells[5*cell + j + 1];
+        }
+      tet_colors[j*3 + 0] = c[0];
+      tet_colors[j*3 + 1] = c[1];
+      tet_colors[j*3 + 2] = c[2];
+
+      tet_texcoords[j*2 + 0] = (float)c[3]/255;
+      tet_texcoords[j*2 + 1] = 0;
+      }
+
+    // Do not render this cell if it is outside of the cutting planes.  For
+    // most planes, cut if all points are outside.  For the near plane, cut if
+    // any points are outside because things can go very wrong if one of the
+    // points is behind the view.
+    if (   (   (tet_points[0*3+0] >  1.0f) && (tet_points[1*3+0] >  1.0f)
+            && (tet_points[2*3+0] >  1.0f) && (tet_points[3*3+0] >  1.0f) )
+        || (   (tet_points[0*3+0] < -1.0f) && (tet_points[1*3+0] < -1.0f)
+            && (tet_points[2*3+0] < -1.0f) && (tet_points[3*3+0] < -1.0f) )
+        || (   (tet_points[0*3+1] >  1.0f) && (tet_points[1*3+1] >  1.0f)
+            && (tet_points[2*3+1] >  1.0f) && (tet_points[3*3+1] >  1.0f) )
+        || (   (tet_points[0*3+1] < -1.0f) && (tet_points[1*3+1] < -1.0f)
+            && (tet_points[2*3+1] < -1.0f) && (tet_points[3*3+1] < -1.0f) )
+        || (   (tet_points[0*3+2] >  1.0f) && (tet_points[1*3+2] >  1.0f)
+            && (tet_points[2*3+2] >  1.0f) && (tet_points[3*3+2] >  1.0f) )
+        || (   (tet_points[0*3+2] < -1.0f) || (tet_points[1*3+2] < -1.0f)
+            || (tet_points[2*3+2] < -1.0f) || (tet_points[3*3+2] < -1.0f) ) )
+      {
+      continue;
+      }
+
+    // The classic PT algorithm uses face normals to determine the
+    // projection class and then do calculations individually.  However,
+    // Wylie 2002 shows how to use the intersection of two segments to
+    // calculate the depth of the thick part for any case.  Here, we use
+    // face normals to determine which segments to use.  One segment
+    // should be between two faces that are either both front facing or
+    // back facing.  Obviously, we only need to test three faces to find
+    // two such faces.  We test the three faces connected to point 0.
+    vtkIdType segment1[2];
+    vtkIdType segment2[2];
+
+    float v1[2], v2[2], v3[3];
+    v1[0] = tet_points[1*3 + 0] - tet_points[0*3 + 0];
+    v1[1] = tet_points[1*3 + 1] - tet_points[0*3 + 1];
+    v2[0] = tet_points[2*3 + 0] - tet_points[0*3 + 0];
+    v2[1] = tet_points[2*3 + 1] - tet_points[0*3 + 1];
+    v3[0] = tet_points[3*3 + 0] - tet_points[0*3 + 0];
+    v3[1] = tet_points[3*3 + 1] - tet_points[0*3 + 1];
+
+    float face_dir1 = v3[0]*v2[1] - v3[1]*v2[0];
+    float face_dir2 = v1[0]*v3[1] - v1[1]*v3[0];
+    float face_dir3 = v2[0]*v1[1] - v2[1]*v1[0];
+
+    if (   (face_dir1 * face_dir2 >= 0)
+        && (   (face_dir1 != 0)       // Handle a special case where 2 faces
+            || (face_dir2 != 0) ) )   // are perpendicular to the view plane.
+      {
+      segment1[0] = 0;  segment1[1] = 3;
+      segment2[0] = 1;  segment2[1] = 2;
+      }
+    else if (face_dir1 * face_dir3 >= 0)
+      {
+      segment1[0] = 0;  segment1[1] = 2;
+      segment2[0] = 1;  segment2[1] = 3;
+      }
+    else      // Unless the tet is degenerate, face_dir2*face_dir3 >= 0
+      {
+      segment1[0] = 0;  segment1[1] = 1;
+      segment2[0] = 2;  segment2[1] = 3;
+      }
+
+#define VEC3SUB(Z,X,Y)          \
+  (Z)[0] = (X)[0] - (Y)[0];     \
+  (Z)[1] = (X)[1] - (Y)[1];     \
+  (Z)[2] = (X)[2] - (Y)[2];
+#define P1 (tet_points + 3*segment1[0])
+#define P2 (tet_points + 3*segment1[1])
+#define P3 (tet_points + 3*segment2[0])
+#define P4 (tet_points + 3*segment2[1])
+#define C1 (tet_colors + 3*segment1[0])
+#define C2 (tet_colors + 3*segment1[1])
+#define C3 (tet_colors + 3*segment2[0])
+#define C4 (tet_colors + 3*segment2[1])
+#define T1 (tet_texcoords + 2*segment1[0])
+#define T2 (tet_texcoords + 2*segment1[1])
+#define T3 (tet_texcoords + 2*segment2[0])
+#define T4 (tet_texcoords + 2*segment2[1])
+    // Find the intersection of the projection of the two segments in the
+    // XY plane.  This algorithm is based on that given in Graphics Gems
+    // III, pg. 199-202.
+    float A[3], B[3], C[3];
+    // We can define the two lines parametrically as:
+    //        P1 + alpha(A)
+    //        P3 + beta(B)
+    // where A = P2 - P1
+    // and   B = P4 - P3.
+    // alpha and beta are in the range [0,1] within the line segment.
+    VEC3SUB(A, P2, P1);
+    VEC3SUB(B, P4, P3);
+    // The lines intersect when the values of the two parameteric equations
+    // are equal.  Setting them equal and moving everything to one side:
+    //        0 = C + beta(B) - alpha(A)
+    // where C = P3 - P1.
+    VEC3SUB(C, P3, P1);
+    // When we project the lines to the xy plane (which we do by throwing
+    // away the z value), we have two equations and two unkowns.  The
+    // following are the solutions for alpha and beta.
+    float denominator = (A[0]*B[1]-A[1]*B[0]);
+    if (denominator == 0) continue;   // Must be degenerate tetrahedra.
+    float alpha = (B[1]*C[0]-B[0]*C[1])/denominator;
+    float beta = (A[1]*C[0]-A[0]*C[1])/denominator;
+
+    if ((alpha >= 0) && (alpha <= 1))
+      {
+      // The two segments intersect.  This corresponds to class 2 in
+      // Shirley and Tuchman (or one of the degenerate cases).
+
+      // Make new point at intersection.
+      tet_points[3*4 + 0] = P1[0] + alpha*A[0];
+      tet_points[3*4 + 1] = P1[1] + alpha*A[1];
+      tet_points[3*4 + 2] = P1[2] + alpha*A[2];
+
+      // Find depth at intersection.
+      float depth = self->GetCorrectedDepth(tet_points[3*4 + 0],
+                                            tet_points[3*4 + 1],
+                                            tet_points[3*4 + 2],
+                                            P3[2] + beta*B[2],
+                                            batch->InverseProjection,
+                                            batch->UseLinearDepthCorrection,
+                                            batch->LinearDepthCorrection);
+
+      // Find color at intersection.
+      tet_colors[3*4 + 0] =
+        (unsigned char)(0.5f*(  C1[0] + alpha*(C2[0]-C1[0])
+                              + C3[0] +  beta*(C4[0]-C3[0]) ));
+      tet_colors[3*4 + 1] =
+        (unsigned char)(0.5f*(  C1[1] + alpha*(C2[1]-C1[1])
+                              + C3[1] +  beta*(C4[1]-C3[1]) ));
+      tet_colors[3*4 + 2] =
+        (unsigned char)(0.5f*(  C1[2] + alpha*(C2[2]-C1[2])
+                              + C3[2] +  beta*(C4[2]-C3[2]) ));
+
+//         tet_colors[3*0 + 0] = 255;
+//         tet_colors[3*0 + 1] = 0;
+//         tet_colors[3*0 + 2] = 0;
+//         tet_colors[3*1 + 0] = 255;
+//         tet_colors[3*1 + 1] = 0;
+//         tet_colors[3*1 + 2] = 0;
+//         tet_colors[3*2 + 0] = 255;
+//         tet_colors[3*2 + 1] = 0;
+//         tet_colors[3*2 + 2] = 0;
+//         tet_colors[3*3 + 0] = 255;
+//         tet_colors[3*3 + 1] = 0;
+//         tet_colors[3*3 + 2] = 0;
+//         tet_colors[3*4 + 0] = 255;
+//         tet_colors[3*4 + 1] = 0;
+//         tet_colors[3*4 + 2] = 0;
+
+      // Find the opacity at intersection.
+      tet_texcoords[2*4 + 0] = 0.5f*(  T1[0] + alpha*(T2[0]-T1[0])
+                                     + T3[0] + alpha*(T4[0]-T3[0]));
+
+      // Record the depth at the intersection.
+      tet_texcoords[2*4 + 1] = depth/self->MaxCellSize;
+
+      // Establish the order in which the points should be rendered.
+      GLuint fan[6];
+      fan[0] = 4;
+      fan[1] = segment1[0];
+      fan[2] = segment2[0];
+      fan[3] = segment1[1];
+      fan[4] = segment2[1];
+      fan[5] = segment1[0];
+
+      // Split the fan into triangles.
+      for (j = 1; j < 5; j++)
+        {
+        *(indices++) = base + fan[0];
+        *(indices++) = base + fan[j];
+        *(indices++) = base + fan[j+1];
+        }
+      }
+    else
+      {
+      // The two segments do not intersect.  This corresponds to class 1
+      // in Shirley and Tuchman.
+      if (alpha <= 0)
+        {
+        // Flip segment1 so that alpha is >= 1.  P1 and P2 are also
+        // flipped as are C1-C2 and T1-T2.  Note that this will
+        // invalidate A.  B and beta are unaffected.
+        vtkstd::swap(segment1[0], segment1[1]);
+        alpha = 1 - alpha;
+        }
+      // From here on, we can assume P2 is the "thick" point.
+
+      // Find the depth under the thick point.  Use the alpha and beta
+      // from intersection to determine location of face under thick
+      // point.
+      float edgez = P3[2] + beta*B[2];
+      float pointz = P1[2];
+      float facez = (edgez + (alpha-1)*pointz)/alpha;
+      float depth = self->GetCorrectedDepth(P2[0], P2[1], P2[2], facez,
+                                            batch->InverseProjection,
+                                            batch->UseLinearDepthCorrection,
+                                            batch->LinearDepthCorrection);
+
+      // Fix color at thick point.  Average color with color of opposite
+      // face.
+      for (j = 0; j < 3; j++)
+        {
+        float edgec = C3[j] + beta*(C4[j]-C3[j]);
+        float pointc = C1[j];
+        float facec = (edgec + (alpha-1)*pointc)/alpha;
+        C2[j] = (unsigned char)(0.5f*(facec + C2[j]));
+        }
+
+//         tet_colors[3*segment1[0] + 0] = 0;
+//         tet_colors[3*segment1[0] + 1] = 255;
+//         tet_colors[3*segment1[0] + 2] = 0;
+//         tet_colors[3*segment1[1] + 0] = 0;
+//         tet_colors[3*segment1[1] + 1] = 255;
+//         tet_colors[3*segment1[1] + 2] = 0;
+//         tet_colors[3*segment2[0] + 0] = 0;
+//         tet_colors[3*segment2[0] + 1] = 255;
+//         tet_colors[3*segment2[0] + 2] = 0;
+//         tet_colors[3*segment2[1] + 0] = 0;
+//         tet_colors[3*segment2[1] + 1] = 255;
+//         tet_colors[3*segment2[1] + 2] = 0;
+
+      // Fix opacity at thick point.  Average opacity with opacity of
+      // opposite face.
+      float edgea = T3[0] + beta*(T4[0]-T3[0]);
+      float pointa = T1[0];
+      float facea = (edgea + (alpha-1)*pointa)/alpha;
+      T2[0] = 0.5f*(facea + T2[0]);
+
+      // Record thickness at thick point.
+      T2[1] = depth/self->MaxCellSize;
+
+      // Establish the order in which the points should be rendered.
+      GLuint fan[5];
+      fan[0] = segment1[1];
+      fan[1] = segment1[0];
+      fan[2] = segment2[0];
+      fan[3] = segment2[1];
+      fan[4] = segment1[0];
+
+      // Split the fan into triangles.
+      for (j = 1; j < 4; j++)
+        {
+        *(indices++) = base + fan[0];
+        *(indices++) = base + fan[j];
+        *(indices++) = base + fan[j+1];
+        }
+      }
+    }
+
+  batch->NumberOfIndices[info->ThreadID]
+    = static_cast<vtkIdType>(indices - (batch->Indices + 12*begin));
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 //-----------------------------------------------------------------------------
 void vtkOpenGLProjectedTetrahedraMapper::ProjectTetrahedra(vtkRenderer *renderer,
                                                      vtkVolume *volume)
@@ -355,7 +713,16 @@ void vtkOpenGLProjectedTetrahedraMapper::ProjectTetrahedra(vtkRenderer *renderer
   this->VisibilitySort->SetDirectionToBackToFront();
   this->VisibilitySort->SetModelTransform(volume->GetMatrix());
   this->VisibilitySort->SetCamera(renderer->GetActiveCamera());
-  this->VisibilitySort->SetMaxCellsReturned(1000);
+  this->VisibilitySort->SetMaxCellsReturned(
+    this->NumberOfThreads > 1
+    ? VTK_PROJECTED_TETRAHEDRA_MIN_CELLS_PER_THREAD*this->NumberOfThreads
+    : 1000);
+  vtkCellCenterDepthSort *depthSort
+    = vtkCellCenterDepthSort::SafeDownCast(this->VisibilitySort);
+  if (depthSort)
+    {
+    depthSort->SetNumberOfThreads(this->NumberOfThreads);
+    }
 
   this->VisibilitySort->InitTraversal();
 
@@ -433,17 +800,10 @@ void vtkOpenGLProjectedTetrahedraMapper::ProjectTetrahedra(vtkRenderer *renderer
   
   glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
-  // Establish vertex arrays.
-  float tet_points[5*3];
-  glVertexPointer(3, GL_FLOAT, 0, tet_points);
+  // Establish vertex arrays.  They point into the batch buffers, which are
+  // set for each batch of cells.
   glEnableClientState(GL_VERTEX_ARRAY);
-
-  unsigned char tet_colors[5*3];
-  glColorPointer(3, GL_UNSIGNED_BYTE, 0, tet_colors);
   glEnableClientState(GL_COLOR_ARRAY);
-
-  float tet_texcoords[5*2];
-  glTexCoordPointer(2, GL_FLOAT, 0, tet_texcoords);
   glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 
   // Since we had to transform the points on the CPU, replace the OpenGL
@@ -453,11 +813,19 @@ void vtkOpenGLProjectedTetrahedraMapper::ProjectTetrahedra(vtkRenderer *renderer
   glMatrixMode(GL_MODELVIEW);
   glLoadIdentity();
 
-  unsigned char *colors = this->Colors->GetPointer(0);
-  vtkIdType *cells = input->GetCells()->GetPointer();
+  ProjectionBatch batch;
+  batch.Self = this;
+  batch.TransformedPoints = points;
+  batch.Cells = input->GetCells()->GetPointer();
+  batch.CellColors = this->Colors->GetPointer(0);
+  batch.InverseProjection = inverse_projection_mat;
+  batch.UseLinearDepthCorrection = use_linear_depth_correction;
+  batch.LinearDepthCorrection = linear_depth_correction;
   vtkIdType totalnumcells = input->GetNumberOfCells();
   vtkIdType numcellsrendered = 0;
 
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+
   // Let's do it!
   for (vtkIdTypeArray *sorted_cell_ids = this->VisibilitySort->GetNextCells();
        sorted_cell_ids != NULL;
@@ -468,279 +836,47 @@ void vtkOpenGLProjectedTetrahedraMapper::ProjectTetrahedra(vtkRenderer *renderer
       {
       break;
       }
-    vtkIdType *cell_ids = sorted_cell_ids->GetPointer(0);
-    vtkIdType num_cell_ids = sorted_cell_ids->GetNumberOfTuples();
-    for (vtkIdType i = 0; i < num_cell_ids; i++)
+    batch.CellIds = sorted_cell_ids->GetPointer(0);
+    batch.NumberOfCells = sorted_cell_ids->GetNumberOfTuples();
+    batch.Allocate(batch.NumberOfCells);
+
+    // Use as many threads as there are full ranges of cells.
+    int numThreads = static_cast<int>(
+      batch.NumberOfCells/VTK_PROJECTED_TETRAHEDRA_MIN_CELLS_PER_THREAD);
+    numThreads = vtkstd::max(1, vtkstd::min(numThreads, this->NumberOfThreads));
+    if (numThreads == 1)
       {
-      vtkIdType cell = cell_ids[i];
-      int j;
-
-      // Get the data for the tetrahedra.
-      for (j = 0; j < 4; j++)
-        {
-        // Assuming we only have tetrahedra, each entry in cells has 5
-        // components.
-        const float *p = points + 3*cells[5*cell + j + 1];
-        tet_points[j*3 + 0] = p[0];
-        tet_points[j*3 + 1] = p[1];
-        tet_points[j*3 + 2] = p[2];
-
-        const unsigned char *c;
-        if (this->UsingCellColors)
-          {
-          c = colors + 4*cell;
-          }
-        else
-          {
-          c = colors + 4*cells[5*cell + j + 1];
-          }
-        tet_colors[j*3 + 0] = c[0];
-        tet_colors[j*3 + 1] = c[1];
-        tet_colors[j*3 + 2] = c[2];
-
-        tet_texcoords[j*2 + 0] = (float)c[3]/255;
-        tet_texcoords[j*2 + 1] = 0;
-        }
-
-      // Do not render this cell if it is outside of the cutting planes.  For
-      // most planes, cut if all points are outside.  For the near plane, cut if
-      // any points are outside because things can go very wrong if one of the
-      // points is behind the view.
-      if (   (   (tet_points[0*3+0] >  1.0f) && (tet_points[1*3+0] >  1.0f)
-              && (tet_points[2*3+0] >  1.0f) && (tet_points[3*3+0] >  1.0f) )
-          || (   (tet_points[0*3+0] < -1.0f) && (tet_points[1*3+0] < -1.0f)
-              && (tet_points[2*3+0] < -1.0f) && (tet_points[3*3+0] < -1.0f) )
-          || (   (tet_points[0*3+1] >  1.0f) && (tet_points[1*3+1] >  1.0f)
-              && (tet_points[2*3+1] >  1.0f) && (tet_points[3*3+1] >  1.0f) )
-          || (   (tet_points[0*3+1] < -1.0f) && (tet_points[1*3+1] < -1.0f)
-              && (tet_points[2*3+1] < -1.0f) && (tet_points[3*3+1] < -1.0f) )
-          || (   (tet_points[0*3+2] >  1.0f) && (tet_points[1*3+2] >  1.0f)
-              && (tet_points[2*3+2] >  1.0f) && (tet_points[3*3+2] >  1.0f) )
-          || (   (tet_points[0*3+2] < -1.0f) || (tet_points[1*3+2] < -1.0f)
-              || (tet_points[2*3+2] < -1.0f) || (tet_points[3*3+2] < -1.0f) ) )
-        {
-        continue;
-        }
-
-      // The classic PT algorithm uses face normals to determine the
-      // projection class and then do calculations individually.  However,
-      // Wylie 2002 shows how to use the intersection of two segments to
-      // calculate the depth of the thick part for any case.  Here, we use
-      // face normals to determine which segments to use.  One segment
-      // should be between two faces that are either both front facing or
-      // back facing.  Obviously, we only need to test three faces to find
-      // two such faces.  We test the three faces connected to point 0.
-      vtkIdType segment1[2];
-      vtkIdType segment2[2];
-
-      float v1[2], v2[2], v3[3];
-      v1[0] = tet_points[1*3 + 0] - tet_points[0*3 + 0];
-      v1[1] = tet_points[1*3 + 1] - tet_points[0*3 + 1];
-      v2[0] = tet_points[2*3 + 0] - tet_points[0*3 + 0];
-      v2[1] = tet_points[2*3 + 1] - tet_points[0*3 + 1];
-      v3[0] = tet_points[3*3 + 0] - tet_points[0*3 + 0];
-      v3[1] = tet_points[3*3 + 1] - tet_points[0*3 + 1];
-
-      float face_dir1 = v3[0]*v2[1] - v3[1]*v2[0];
-      float face_dir2 = v1[0]*v3[1] - v1[1]*v3[0];
-      float face_dir3 = v2[0]*v1[1] - v2[1]*v1[0];
-
-      if (   (face_dir1 * face_dir2 >= 0)
-          && (   (face_dir1 != 0)       // Handle a special case where 2 faces
-              || (face_dir2 != 0) ) )   // are perpendicular to the view plane.
-        {
-        segment1[0] = 0;  segment1[1] = 3;
-        segment2[0] = 1;  segment2[1] = 2;
-        }
-      else if (face_dir1 * face_dir3 >= 0)
-        {
-        segment1[0] = 0;  segment1[1] = 2;
-        segment2[0] = 1;  segment2[1] = 3;
-        }
-      else      // Unless the tet is degenerate, face_dir2*face_dir3 >= 0
-        {
-        segment1[0] = 0;  segment1[1] = 1;
-        segment2[0] = 2;  segment2[1] = 3;
-        }
-
-#define VEC3SUB(Z,X,Y)          \
-  (Z)[0] = (X)[0] - (Y)[0];     \
-  (Z)[1] = (X)[1] - (Y)[1];     \
-  (Z)[2] = (X)[2] - (Y)[2];
-#define P1 (tet_points + 3*segment1[0])
-#define P2 (tet_points + 3*segment1[1])
-#define P3 (tet_points + 3*segment2[0])
-#define P4 (tet_points + 3*segment2[1])
-#define C1 (tet_colors + 3*segment1[0])
-#define C2 (tet_colors + 3*segment1[1])
-#define C3 (tet_colors + 3*segment2[0])
-#define C4 (tet_colors + 3*segment2[1])
-#define T1 (tet_texcoords + 2*segment1[0])
-#define T2 (tet_texcoords + 2*segment1[1])
-#define T3 (tet_texcoords + 2*segment2[0])
-#define T4 (tet_texcoords + 2*segment2[1])
-      // Find the intersection of the projection of the two segments in the
-      // XY plane.  This algorithm is based on that given in Graphics Gems
-      // III, pg. 199-202.
-      float A[3], B[3], C[3];
-      // We can define the two lines parametrically as:
-      //        P1 + alpha(A)
-      //        P3 + beta(B)
-      // where A = P2 - P1
-      // and   B = P4 - P3.
-      // alpha and beta are in the range [0,1] within the line segment.
-      VEC3SUB(A, P2, P1);
-      VEC3SUB(B, P4, P3);
-      // The lines intersect when the values of the two parameteric equations
-      // are equal.  Setting them equal and moving everything to one side:
-      //        0 = C + beta(B) - alpha(A)
-      // where C = P3 - P1.
-      VEC3SUB(C, P3, P1);
-      // When we project the lines to the xy plane (which we do by throwing
-      // away the z value), we have two equations and two unkowns.  The
-      // following are the solutions for alpha and beta.
-      float denominator = (A[0]*B[1]-A[1]*B[0]);
-      if (denominator == 0) continue;   // Must be degenerate tetrahedra.
-      float alpha = (B[1]*C[0]-B[0]*C[1])/denominator;
-      float beta = (A[1]*C[0]-A[0]*C[1])/denominator;
-
-      if ((alpha >= 0) && (alpha <= 1))
-        {
-        // The two segments intersect.  This corresponds to class 2 in
-        // Shirley and Tuchman (or one of the degenerate cases).
-
-        // Make new point at intersection.
-        tet_points[3*4 + 0] = P1[0] + alpha*A[0];
-        tet_points[3*4 + 1] = P1[1] + alpha*A[1];
-        tet_points[3*4 + 2] = P1[2] + alpha*A[2];
-
-        // Find depth at intersection.
-        float depth = GetCorrectedDepth(tet_points[3*4 + 0],
-                                        tet_points[3*4 + 1],
-                                        tet_points[3*4 + 2],
-                                        P3[2] + beta*B[2],
-                                        inverse_projection_mat,
-                                        use_linear_depth_correction,
-                                        linear_depth_correction);
-
-        // Find color at intersection.
-        tet_colors[3*4 + 0] =
-          (unsigned char)(0.5f*(  C1[0] + alpha*(C2[0]-C1[0])
-                                + C3[0] +  beta*(C4[0]-C3[0]) ));
-        tet_colors[3*4 + 1] =
-          (unsigned char)(0.5f*(  C1[1] + alpha*(C2[1]-C1[1])
-                                + C3[1] +  beta*(C4[1]-C3[1]) ));
-        tet_colors[3*4 + 2] =
-          (unsigned char)(0.5f*(  C1[2] + alpha*(C2[2]-C1[2])
-                                + C3[2] +  beta*(C4[2]-C3[2]) ));
-
-//         tet_colors[3*0 + 0] = 255;
-//         tet_colors[3*0 + 1] = 0;
-//         tet_colors[3*0 + 2] = 0;
-//         tet_colors[3*1 + 0] = 255;
-//         tet_colors[3*1 + 1] = 0;
-//         tet_colors[3*1 + 2] = 0;
-//         tet_colors[3*2 + 0] = 255;
-//         tet_colors[3*2 + 1] = 0;
-//         tet_colors[3*2 + 2] = 0;
-//         tet_colors[3*3 + 0] = 255;
-//         tet_colors[3*3 + 1] = 0;
-//         tet_colors[3*3 + 2] = 0;
-//         tet_colors[3*4 + 0] = 255;
-//         tet_colors[3*4 + 1] = 0;
-//         tet_colors[3*4 + 2] = 0;
-
-        // Find the opacity at intersection.
-        tet_texcoords[2*4 + 0] = 0.5f*(  T1[0] + alpha*(T2[0]-T1[0])
-                                       + T3[0] + alpha*(T4[0]-T3[0]));
-
-        // Record the depth at the intersection.
-        tet_texcoords[2*4 + 1] = depth/this->MaxCellSize;
-
-        // Establish the order in which the points should be rendered.
-        unsigned char gl_indices[6];
-        gl_indices[0] = 4;
-        gl_indices[1] = segment1[0];
-        gl_indices[2] = segment2[0];
-        gl_indices[3] = segment1[1];
-        gl_indices[4] = segment2[1];
-        gl_indices[5] = segment1[0];
+      vtkMultiThreader::ThreadInfo info;
+      info.ThreadID = 0;
+      info.NumberOfThreads = 1;
+      info.UserData = &batch;
+      vtkOpenGLProjectedTetrahedraMapper::ProjectTetrahedraThread(&info);
+      }
+    else
+      {
+      threader->SetNumberOfThreads(numThreads);
+      threader->SetSingleMethod(
+        vtkOpenGLProjectedTetrahedraMapper::ProjectTetrahedraThread, &batch);
+      threader->SingleMethodExecute();
+      }
 
-        // Render
-        glDrawElements(GL_TRIANGLE_FAN, 6, GL_UNSIGNED_BYTE, gl_indices);
-        }
-      else
+    // Render
+    glVertexPointer(3, GL_FLOAT, 0, batch.Points);
+    glColorPointer(3, GL_UNSIGNED_BYTE, 0, batch.Colors);
+    glTexCoordPointer(2, GL_FLOAT, 0, batch.TexCoords);
+    for (int t = 0; t < numThreads; t++)
+      {
+      vtkIdType first = 12*(batch.NumberOfCells*t/numThreads);
+      if (batch.NumberOfIndices[t] > 0)
         {
-        // The two segments do not intersect.  This corresponds to class 1
-        // in Shirley and Tuchman.
-        if (alpha <= 0)
-          {
-          // Flip segment1 so that alpha is >= 1.  P1 and P2 are also
-          // flipped as are C1-C2 and T1-T2.  Note that this will
-          // invalidate A.  B and beta are unaffected.
-          vtkstd::swap(segment1[0], segment1[1]);
-          alpha = 1 - alpha;
-          }
-        // From here on, we can assume P2 is the "thick" point.
-
-        // Find the depth under the thick point.  Use the alpha and beta
-        // from intersection to determine location of face under thick
-        // point.
-        float edgez = P3[2] + beta*B[2];
-        float pointz = P1[2];
-        float facez = (edgez + (alpha-1)*pointz)/alpha;
-        float depth = GetCorrectedDepth(P2[0], P2[1], P2[2], facez,
-                                        inverse_projection_mat,
-                                        use_linear_depth_correction,
-                                        linear_depth_correction);
-
-        // Fix color at thick point.  Average color with color of opposite
-        // face.
-        for (j = 0; j < 3; j++)
-          {
-          float edgec = C3[j] + beta*(C4[j]-C3[j]);
-          float pointc = C1[j];
-          float facec = (edgec + (alpha-1)*pointc)/alpha;
-          C2[j] = (unsigned char)(0.5f*(facec + C2[j]));
-          }
-
-//         tet_colors[3*segment1[0] + 0] = 0;
-//         tet_colors[3*segment1[0] + 1] = 255;
-//         tet_colors[3*segment1[0] + 2] = 0;
-//         tet_colors[3*segment1[1] + 0] = 0;
-//         tet_colors[3*segment1[1] + 1] = 255;
-//         tet_colors[3*segment1[1] + 2] = 0;
-//         tet_colors[3*segment2[0] + 0] = 0;
-//         tet_colors[3*segment2[0] + 1] = 255;
-//         tet_colors[3*segment2[0] + 2] = 0;
-//         tet_colors[3*segment2[1] + 0] = 0;
-//         tet_colors[3*segment2[1] + 1] = 255;
-//         tet_colors[3*segment2[1] + 2] = 0;
-
-        // Fix opacity at thick point.  Average opacity with opacity of
-        // opposite face.
-        float edgea = T3[0] + beta*(T4[0]-T3[0]);
-        float pointa = T1[0];
-        float facea = (edgea + (alpha-1)*pointa)/alpha;
-        T2[0] = 0.5f*(facea + T2[0]);
-
-        // Record thickness at thick point.
-        T2[1] = depth/this->MaxCellSize;
-
-        // Establish the order in which the points should be rendered.
-        unsigned char gl_indices[5];
-        gl_indices[0] = segment1[1];
-        gl_indices[1] = segment1[0];
-        gl_indices[2] = segment2[0];
-        gl_indices[3] = segment2[1];
-        gl_indices[4] = segment1[0];
-
-        // Render
-        glDrawElements(GL_TRIANGLE_FAN, 5, GL_UNSIGNED_BYTE, gl_indices);
+        glDrawElements(GL_TRIANGLES,
+                       static_cast<GLsizei>(batch.NumberOfIndices[t]),
+                       GL_UNSIGNED_INT, batch.Indices + first);
         }
       }
-    numcellsrendered += num_cell_ids;
+    numcellsrendered += batch.NumberOfCells;
     }
+  threader->Delete();
 
   // Restore OpenGL state.
   glMatrixMode(GL_PROJECTION);
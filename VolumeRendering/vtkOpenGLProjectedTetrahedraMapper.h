@@ -76,6 +76,15 @@ protected:
 
   virtual void ProjectTetrahedra(vtkRenderer *renderer, vtkVolume *volume);
 
+  //BTX
+  struct ProjectionBatch;
+  //ETX
+
+  // Description:
+  // Project and classify one range of the cells of a ProjectionBatch, which
+  // is passed as the user data of the thread.
+  static VTK_THREAD_RETURN_TYPE ProjectTetrahedraThread(void *arg);
+
   float GetCorrectedDepth(float x, float y, float z1, float z2,
                           const float inverse_projection_mat[16],
                           int use_linear_depth_correction,
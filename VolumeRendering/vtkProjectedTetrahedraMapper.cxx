@@ -32,6 +32,7 @@
 #include "vtkFloatArray.h"
 #include "vtkGarbageCollector.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPiecewiseFunction.h"
 #include "vtkPointData.h"
@@ -69,6 +70,7 @@ vtkProjectedTetrahedraMapper *vtkProjectedTetrahedraMapper::New()
 vtkProjectedTetrahedraMapper::vtkProjectedTetrahedraMapper()
 {
   this->VisibilitySort = vtkCellCenterDepthSort::New();
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
 }
 
 vtkProjectedTetrahedraMapper::~vtkProjectedTetrahedraMapper()
@@ -80,7 +82,7 @@ void vtkProjectedTetrahedraMapper::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "VisibilitySort: " << this->VisibilitySort << endl;
-
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
 }
 
 //-----------------------------------------------------------------------------
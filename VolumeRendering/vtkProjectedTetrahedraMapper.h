@@ -30,6 +30,11 @@
 // Polygonal Approximation to Direct Scalar Volume Rendering" in Computer
 // Graphics, December 1990.
 //
+// The depth sort and the projection of the tetrahedra are split among
+// NumberOfThreads threads.  The default vtkCellCenterDepthSort can also
+// reuse the order of the last frame for small camera motions; see its
+// ReuseAngle.
+//
 // .SECTION Bugs
 // This mapper relies highly on the implementation of the OpenGL pipeline.
 // A typical hardware driver has lots of options and some settings can
@@ -58,6 +63,15 @@ public:
   virtual void SetVisibilitySort(vtkVisibilitySort *sort);
   vtkGetObjectMacro(VisibilitySort, vtkVisibilitySort);
 
+  // Description:
+  // Set/Get the number of threads used to sort and project the tetrahedra.
+  // The default is the global default number of threads of
+  // vtkMultiThreader.  The OpenGL mapper passes it on to a
+  // vtkCellCenterDepthSort, which sorts all the cells up front with more
+  // than one thread.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
   static void MapScalarsToColors(vtkDataArray *colors,
                                  vtkVolumeProperty *property,
                                  vtkDataArray *scalars);
@@ -72,6 +86,8 @@ protected:
 
   vtkVisibilitySort *VisibilitySort;
 
+  int NumberOfThreads;
+
   // Description:
   // The visibility sort will probably make a reference loop by holding a
   // reference to the input.
@@ -32,6 +32,9 @@
 #include "vtkColorTransferFunction.h"
 #include "vtkVolumeProperty.h"
 #include "vtkUnstructuredGridVolumeRayCastIterator.h"
+#include "vtkMultiThreader.h"
+
+#include <vtkstd/vector>
 
 vtkStandardNewMacro(vtkUnstructuredGridBunykRayCastFunction);
 
@@ -39,6 +42,89 @@ vtkStandardNewMacro(vtkUnstructuredGridBunykRayCastFunction);
 
 #define VTK_BUNYKRCF_MAX_COMPONENTS 4
 
+// The image rows are split into this many bands per thread when computing
+// the pixel intersections, so that the bands crossing the dense parts of
+// the boundary are shared among the threads.
+#define VTK_BUNYKRCF_BANDS_PER_THREAD 4
+
+//-----------------------------------------------------------------------------
+// The intersection storage of a thread: big blocks that are reused from one
+// render to the next.
+class vtkUnstructuredGridBunykRayCastFunctionArena
+{
+public:
+  typedef vtkUnstructuredGridBunykRayCastFunction::Intersection Intersection;
+
+  vtkUnstructuredGridBunykRayCastFunctionArena()
+    {
+    this->CurrentBlock = 0;
+    this->CurrentCount = 0;
+    }
+  ~vtkUnstructuredGridBunykRayCastFunctionArena()
+    {
+    for (size_t i = 0; i < this->Blocks.size(); i++)
+      {
+      delete [] this->Blocks[i];
+      }
+    }
+
+  // Return an unused element, or NULL when all the blocks are full.
+  Intersection *New()
+    {
+    if (this->CurrentBlock < this->Blocks.size() &&
+        this->CurrentCount == VTK_BUNYKRCF_ARRAY_SIZE)
+      {
+      this->CurrentBlock++;
+      this->CurrentCount = 0;
+      }
+    if (this->CurrentBlock == this->Blocks.size())
+      {
+      if (this->Blocks.size() == VTK_BUNYKRCF_MAX_ARRAYS)
+        {
+        return NULL;
+        }
+      this->Blocks.push_back(new Intersection[VTK_BUNYKRCF_ARRAY_SIZE]);
+      }
+    return this->Blocks[this->CurrentBlock] + (this->CurrentCount++);
+    }
+
+  // Mark every element as unused. This does NOT release memory.
+  void Reset()
+    {
+    this->CurrentBlock = 0;
+    this->CurrentCount = 0;
+    }
+
+protected:
+  vtkstd::vector<Intersection *> Blocks;
+  size_t CurrentBlock;
+  int CurrentCount;
+};
+
+// A front facing boundary triangle in front of the view and its
+// bounding box on the image, clamped to the image.
+struct vtkUnstructuredGridBunykRayCastFunctionBoundaryTriangle
+{
+  vtkUnstructuredGridBunykRayCastFunction::Triangle *TriPtr;
+  int MinX, MaxX, MinY, MaxY;
+};
+
+class vtkUnstructuredGridBunykRayCastFunctionInternals
+{
+public:
+  vtkUnstructuredGridBunykRayCastFunctionArena Arenas[VTK_MAX_THREADS];
+  vtkstd::vector<vtkUnstructuredGridBunykRayCastFunctionBoundaryTriangle>
+    BoundaryTriangles;
+  int OutOfSpace;
+};
+
+// Passed to the threads by ComputePixelIntersections().
+struct vtkUnstructuredGridBunykRayCastFunctionThreadData
+{
+  vtkUnstructuredGridBunykRayCastFunction *Self;
+  int NumberOfBands;
+};
+
 template <class T>
 vtkIdType TemplateCastRay(
   const T *scalars, 
@@ -227,11 +313,8 @@ vtkUnstructuredGridBunykRayCastFunction::vtkUnstructuredGridBunykRayCastFunction
   this->ImageSize[1]      = 0;
   this->ViewToWorldMatrix = vtkMatrix4x4::New();
   
-  for (int i = 0; i < VTK_BUNYKRCF_MAX_ARRAYS; i++ )
-    {
-    this->IntersectionBuffer[i] = NULL;
-    this->IntersectionBufferCount[i] = 0;
-    }
+  this->Internals = new vtkUnstructuredGridBunykRayCastFunctionInternals;
+  this->Internals->OutOfSpace = 0;
   
   this->SavedTriangleListInput       = NULL;
 }
@@ -247,11 +330,7 @@ vtkUnstructuredGridBunykRayCastFunction::~vtkUnstructuredGridBunykRayCastFunctio
   
   delete [] this->TetraTriangles;
 
-  int i;
-  for (i = 0; i < 20; i++ )
-    {
-    delete [] this->IntersectionBuffer[i];
-    }
+  delete this->Internals;
   
   while ( this->TriangleList )
     {
@@ -266,7 +345,7 @@ vtkUnstructuredGridBunykRayCastFunction::~vtkUnstructuredGridBunykRayCastFunctio
 
 // Clear the intersection image. This does NOT release memory - 
 // it just sets the link pointers to NULL. The memory is
-// contained in the IntersectionBuffer arrays.
+// contained in the arenas of the threads.
 void vtkUnstructuredGridBunykRayCastFunction::ClearImage()
 {
   int i;
@@ -278,50 +357,29 @@ void vtkUnstructuredGridBunykRayCastFunction::ClearImage()
       }
     }
   
-  for ( i = 0; i < VTK_BUNYKRCF_MAX_ARRAYS; i++ )
+  for ( i = 0; i < VTK_MAX_THREADS; i++ )
     {
-    this->IntersectionBufferCount[i] = 0;
+    this->Internals->Arenas[i].Reset();
     }
 }
 
 // Since we are managing the memory ourself for these intersections,
 // we need a new method. In this method we return an unused 
-// intersection element from our storage arrays. If we don't
-// have one, we create a new storage array (unless we have run
+// intersection element from the storage arrays of the thread. If it
+// doesn't have one, we create a new storage array (unless we have run
 // out of memory). The memory can never shrink, and will only be
 // deleted when the class is destructed. 
-void *vtkUnstructuredGridBunykRayCastFunction::NewIntersection()
+void *vtkUnstructuredGridBunykRayCastFunction::NewIntersection(int threadId)
 {
-  // Look for the first buffer that has enough space, or the
-  // first one that has not yet been allocated
-  int i;
-  for ( i = 0; i < VTK_BUNYKRCF_MAX_ARRAYS; i++ )
-    {
-    if ( !this->IntersectionBuffer[i] ||
-         this->IntersectionBufferCount[i] < VTK_BUNYKRCF_ARRAY_SIZE ) 
-      {
-      break;
-      }
-    }
-  
-  // We have run out of space - return NULL
-  if ( i == VTK_BUNYKRCF_MAX_ARRAYS )
-    {
-    vtkErrorMacro("Out of space for intersections!");
-    return NULL;
-    }
+  void *intersect = this->Internals->Arenas[threadId].New();
   
-  // We need another array - allocate it and set its count to 0 indicating
-  // that we have not used any elements yet
-  if ( !this->IntersectionBuffer[i] )
+  // We have run out of space - return NULL. The error is reported once
+  // all the threads are done.
+  if ( !intersect )
     {
-    this->IntersectionBuffer[i] = new Intersection[VTK_BUNYKRCF_ARRAY_SIZE];
-    this->IntersectionBufferCount[i] = 0;
+    this->Internals->OutOfSpace = 1;
     }
-  
-  // Return the first unused element
-  return (this->IntersectionBuffer[i] + (this->IntersectionBufferCount[i]++));
-  
+  return intersect;
 }
 
 // The Intialize method is called from the ray caster at the start of 
@@ -757,6 +815,12 @@ void  vtkUnstructuredGridBunykRayCastFunction::ComputeViewDependentInfo()
 
 void vtkUnstructuredGridBunykRayCastFunction::ComputePixelIntersections()
 {
+  // Find the triangles to project first: the front facing test needs the
+  // input cells, which may not be accessed by several threads at once.
+  vtkstd::vector<vtkUnstructuredGridBunykRayCastFunctionBoundaryTriangle>
+    &triangles = this->Internals->BoundaryTriangles;
+  triangles.clear();
+  
   Triangle *triPtr = this->TriangleList;
   while ( triPtr )
     {
@@ -800,58 +864,139 @@ void vtkUnstructuredGridBunykRayCastFunction::ComputePixelIntersections()
              minY < this->ImageSize[1] - 1 &&
              maxX >= 0 && maxY >= 0 && minZ > 0.0 )
           {
-          minX = (minX<0)?(0):(minX);
-          maxX = (maxX>(this->ImageSize[0]-1))?(this->ImageSize[0]-1):(maxX);
+          vtkUnstructuredGridBunykRayCastFunctionBoundaryTriangle triangle;
+          triangle.TriPtr = triPtr;
+          triangle.MinX = (minX<0)?(0):(minX);
+          triangle.MaxX =
+            (maxX>(this->ImageSize[0]-1))?(this->ImageSize[0]-1):(maxX);
+          triangle.MinY = (minY<0)?(0):(minY);
+          triangle.MaxY =
+            (maxY>(this->ImageSize[1]-1))?(this->ImageSize[1]-1):(maxY);
+          triangles.push_back(triangle);
+          }
+        }
+      }
+    triPtr = triPtr->Next;
+    }
+  
+  // Then scan convert them. Each band of rows has its own lists, so the
+  // bands can be filled by different threads, in the same order as a
+  // single thread would.
+  int numThreads = this->Mapper->GetNumberOfThreads();
+  numThreads = (numThreads>VTK_MAX_THREADS)?(VTK_MAX_THREADS):(numThreads);
+  numThreads = (numThreads<1)?(1):(numThreads);
+  
+  this->Internals->OutOfSpace = 0;
+  if ( numThreads == 1 || this->ImageSize[1] < 2*numThreads )
+    {
+    this->ComputePixelIntersections(0, 0, this->ImageSize[1]-1);
+    }
+  else
+    {
+    int numBands = VTK_BUNYKRCF_BANDS_PER_THREAD*numThreads;
+    numBands = (numBands>this->ImageSize[1])?(this->ImageSize[1]):(numBands);
+    
+    vtkUnstructuredGridBunykRayCastFunctionThreadData data;
+    data.Self = this;
+    data.NumberOfBands = numBands;
+    
+    vtkMultiThreader *threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(numThreads);
+    threader->SetSingleMethod(
+      vtkUnstructuredGridBunykRayCastFunction::ComputePixelIntersectionsThread,
+      &data);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    }
+  
+  if ( this->Internals->OutOfSpace )
+    {
+    vtkErrorMacro("Out of space for intersections!");
+    }
+}
 
-          minY = (minY<0)?(0):(minY);
-          maxY = (maxY>(this->ImageSize[1]-1))?(this->ImageSize[1]-1):(maxY);
-        
-          int x, y;
-          double ax, ay, az;
-          ax = this->Points[3*triPtr->PointIndex[0]];
-          ay = this->Points[3*triPtr->PointIndex[0]+1];
-          az = this->Points[3*triPtr->PointIndex[0]+2];
-          
-          for ( y = minY; y <= maxY; y++ )
+VTK_THREAD_RETURN_TYPE
+vtkUnstructuredGridBunykRayCastFunction::ComputePixelIntersectionsThread(
+  void *arg )
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkUnstructuredGridBunykRayCastFunctionThreadData *data =
+    static_cast<vtkUnstructuredGridBunykRayCastFunctionThreadData *>(
+      info->UserData);
+  vtkUnstructuredGridBunykRayCastFunction *self = data->Self;
+  
+  int height = self->ImageSize[1];
+  for ( int band = info->ThreadID; band < data->NumberOfBands;
+        band += info->NumberOfThreads )
+    {
+    self->ComputePixelIntersections(
+      info->ThreadID,
+      height*band/data->NumberOfBands,
+      height*(band+1)/data->NumberOfBands-1);
+    }
+  
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+void vtkUnstructuredGridBunykRayCastFunction::ComputePixelIntersections(
+  int threadId, int bandMinY, int bandMaxY )
+{
+  vtkstd::vector<vtkUnstructuredGridBunykRayCastFunctionBoundaryTriangle>
+    &triangles = this->Internals->BoundaryTriangles;
+  
+  size_t numTriangles = triangles.size();
+  for ( size_t t = 0; t < numTriangles; t++ )
+    {
+    Triangle *triPtr = triangles[t].TriPtr;
+    int minX = triangles[t].MinX;
+    int maxX = triangles[t].MaxX;
+    int minY = (triangles[t].MinY<bandMinY)?(bandMinY):(triangles[t].MinY);
+    int maxY = (triangles[t].MaxY>bandMaxY)?(bandMaxY):(triangles[t].MaxY);
+    
+    int x, y;
+    double ax, ay, az;
+    ax = this->Points[3*triPtr->PointIndex[0]];
+    ay = this->Points[3*triPtr->PointIndex[0]+1];
+    az = this->Points[3*triPtr->PointIndex[0]+2];
+    
+    for ( y = minY; y <= maxY; y++ )
+      {
+      double qy = (double)y - ay;
+      for ( x = minX; x <= maxX; x++ )
+        {
+        double qx = (double)x - ax;
+        if ( this->InTriangle( qx, qy, triPtr ) )
+          {
+          Intersection *intersect =
+            (Intersection *)this->NewIntersection(threadId);
+          if ( intersect )
             {
-            double qy = (double)y - ay;
-            for ( x = minX; x <= maxX; x++ )
+            intersect->TriPtr = triPtr;
+            intersect->Z      = az;
+            intersect->Next   = NULL;
+          
+            if ( !this->Image[y*this->ImageSize[0] + x] ||
+                 intersect->Z < this->Image[y*this->ImageSize[0] + x]->Z )
               {
-              double qx = (double)x - ax;
-              if ( this->InTriangle( qx, qy, triPtr ) )
+              intersect->Next = this->Image[y*this->ImageSize[0] + x];
+              this->Image[y*this->ImageSize[0] + x] = intersect;
+              }
+            else
+              {
+              Intersection *test = this->Image[y*this->ImageSize[0] + x];
+              while ( test->Next && intersect->Z > test->Next->Z )
                 {
-                Intersection *intersect = (Intersection *)this->NewIntersection();
-                if ( intersect )
-                  {
-                  intersect->TriPtr = triPtr;
-                  intersect->Z      = az;
-                  intersect->Next   = NULL;
-                
-                  if ( !this->Image[y*this->ImageSize[0] + x] ||
-                       intersect->Z < this->Image[y*this->ImageSize[0] + x]->Z )
-                    {
-                    intersect->Next = this->Image[y*this->ImageSize[0] + x];
-                    this->Image[y*this->ImageSize[0] + x] = intersect;
-                    }
-                  else
-                    {
-                    Intersection *test = this->Image[y*this->ImageSize[0] + x];
-                    while ( test->Next && intersect->Z > test->Next->Z )
-                      {
-                      test = test->Next;
-                      }
-                    Intersection *tmpNext = test->Next;
-                    test->Next = intersect;
-                    intersect->Next = tmpNext;
-                    }
-                  }
+                test = test->Next;
                 }
+              Intersection *tmpNext = test->Next;
+              test->Next = intersect;
+              intersect->Next = tmpNext;
               }
             }
           }
         }
       }
-    triPtr = triPtr->Next;
     }
 }
 
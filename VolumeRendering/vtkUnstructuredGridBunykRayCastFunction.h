@@ -43,13 +43,20 @@
 //      boundary if it belongs to only one tetra). For each triangle,
 //      find all pixels in the image that intersect the triangle, and
 //      add this to the sorted (by depth) intersection list at each 
-//      pixel.
+//      pixel. This is done by the number of threads of the mapper, each
+//      thread handling bands of image rows and allocating the
+//      intersections from its own memory pool.
 //
 //   5) For each ray cast, traverse the intersection list. At each
 //      intersection, accumulate opacity and color contribution
 //      per tetra along the ray until you reach an exiting triangle
 //      (on the boundary). 
 //
+// The intersection memory is limited to VTK_BUNYKRCF_MAX_ARRAYS arrays of
+// VTK_BUNYKRCF_ARRAY_SIZE intersections per thread, not per render, so the
+// worst-case memory use grows with the number of threads of the mapper.
+// Lower the NumberOfThreads of the mapper to bound it for large data.
+//
 
 // .SECTION See Also
 // vtkUnstructuredGridVolumeRayCastMapper
@@ -69,10 +76,11 @@ class vtkUnstructuredGrid;
 class vtkIdList;
 class vtkDoubleArray;
 class vtkDataArray;
+class vtkUnstructuredGridBunykRayCastFunctionInternals;
 
 // We manage the memory for the list of intersections ourself - this is the
-// storage used. We keep 10,000 elements in each array, and we can have up to 
-// 1,000 arrays.
+// storage used. We keep 10,000 elements in each array, and each thread can
+// have up to 10,000 arrays.
 #define VTK_BUNYKRCF_MAX_ARRAYS 10000
 #define VTK_BUNYKRCF_ARRAY_SIZE 10000
 
@@ -218,16 +226,16 @@ protected:
   // render.
   void ClearImage();
   
-  // This is the memory buffer used to build the intersection
-  // lists. We do our own memory management here because allocating
+  // This holds the memory buffers used to build the intersection
+  // lists, one set of buffers per thread, and the boundary triangles
+  // to project. We do our own memory management here because allocating
   // a bunch of small elements during rendering is too slow.
-  Intersection *IntersectionBuffer[VTK_BUNYKRCF_MAX_ARRAYS];
-  int           IntersectionBufferCount[VTK_BUNYKRCF_MAX_ARRAYS];
+  vtkUnstructuredGridBunykRayCastFunctionInternals *Internals;
   
   // This method replaces new for creating a new element - it
-  // returns one from the big block already allocated (it 
-  // allocates another big block if necessary)
-  void         *NewIntersection();  
+  // returns one from the big block already allocated to the thread
+  // (it allocates another big block if necessary)
+  void         *NewIntersection(int threadId);  
 
   // This method is used during the initialization process to
   // check the validity of the objects - missing information
@@ -252,6 +260,16 @@ protected:
   // compute the intersections for each pixel with the boundary
   // triangles.
   void          ComputePixelIntersections();
+
+  // Compute the intersections of the boundary triangles with the
+  // pixels of rows bandMinY to bandMaxY (included), using the memory of
+  // thread threadId.
+  void          ComputePixelIntersections(int threadId, int bandMinY,
+                                            int bandMaxY);
+
+  // Thread function calling ComputePixelIntersections() for every
+  // NumberOfThreads-th band of rows.
+  static VTK_THREAD_RETURN_TYPE ComputePixelIntersectionsThread(void *arg);
   
 //ETX
   
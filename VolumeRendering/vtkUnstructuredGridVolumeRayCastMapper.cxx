@@ -15,6 +15,7 @@
 #include "vtkUnstructuredGridVolumeRayCastMapper.h"
 
 #include "vtkCamera.h"
+#include "vtkCriticalSection.h"
 #include "vtkEncodedGradientEstimator.h"
 #include "vtkEncodedGradientShader.h"
 #include "vtkFiniteDifferenceGradientEstimator.h"
@@ -42,6 +43,9 @@
 
 VTK_THREAD_RETURN_TYPE UnstructuredGridVolumeRayCastMapper_CastRays( void *arg );
 
+// Width and height of the tiles, in pixels of the image in use.
+#define VTK_UGVRCM_TILE_SIZE 16
+
 
 vtkStandardNewMacro(vtkUnstructuredGridVolumeRayCastMapper);
 
@@ -64,6 +68,13 @@ vtkUnstructuredGridVolumeRayCastMapper::vtkUnstructuredGridVolumeRayCastMapper()
   this->Threader               = vtkMultiThreader::New();
   this->NumberOfThreads        = this->Threader->GetNumberOfThreads();
 
+  this->TileLock               = new vtkSimpleCriticalSection;
+  this->NumberOfTiles          = 0;
+  this->NumberOfTilesPerRow    = 0;
+  this->NextTile               = 0;
+  this->NumberOfRaysCast       = 0;
+  this->RaysPerSecond          = 0.0;
+
   this->Image                  = NULL;
 
   this->RenderTimeTable        = NULL;
@@ -91,6 +102,7 @@ vtkUnstructuredGridVolumeRayCastMapper::vtkUnstructuredGridVolumeRayCastMapper()
 vtkUnstructuredGridVolumeRayCastMapper::~vtkUnstructuredGridVolumeRayCastMapper()
 {
   this->Threader->Delete();
+  delete this->TileLock;
   
   if ( this->Image )
     {
@@ -439,12 +451,24 @@ void vtkUnstructuredGridVolumeRayCastMapper::Render( vtkRenderer *ren, vtkVolume
       }
     }
 
+  // Split the image into tiles.
+  this->NumberOfTilesPerRow =
+    (this->ImageInUseSize[0] + VTK_UGVRCM_TILE_SIZE - 1)/VTK_UGVRCM_TILE_SIZE;
+  this->NumberOfTiles = this->NumberOfTilesPerRow *
+    ((this->ImageInUseSize[1] + VTK_UGVRCM_TILE_SIZE - 1)/VTK_UGVRCM_TILE_SIZE);
+  this->NextTile = 0;
+  this->NumberOfRaysCast = 0;
+
   // Set the number of threads to use for ray casting,
   // then set the execution method and do it.
+  double startTime = vtkTimerLog::GetUniversalTime();
   this->Threader->SetNumberOfThreads( this->NumberOfThreads );
   this->Threader->SetSingleMethod( UnstructuredGridVolumeRayCastMapper_CastRays,
                                    (void *)this);
   this->Threader->SingleMethodExecute();
+  double castTime = vtkTimerLog::GetUniversalTime() - startTime;
+  this->RaysPerSecond =
+    (castTime > 0.0)?(this->NumberOfRaysCast/castTime):(0.0);
  
   // We don't need these anymore
   this->CurrentVolume   = NULL;
@@ -543,7 +567,8 @@ inline void vtkUGVRCMLookupCopy(const T *src, T *dest, vtkIdType *lookup,
     }
 }
 
-void vtkUnstructuredGridVolumeRayCastMapper::CastRays( int threadID, int threadCount )
+void vtkUnstructuredGridVolumeRayCastMapper::CastRays( int threadID,
+                                                      int vtkNotUsed(threadCount) )
 {
   int i, j;
   unsigned char *ucptr;
@@ -557,16 +582,26 @@ void vtkUnstructuredGridVolumeRayCastMapper::CastRays( int threadID, int threadC
   vtkDataArray *nearIntersections = this->NearIntersectionsBuffer[threadID];
   vtkDataArray *farIntersections = this->FarIntersectionsBuffer[threadID];
 
-  for ( j = 0; j < this->ImageInUseSize[1]; j++ )
+  vtkIdType numRaysCast = 0;
+
+  for (;;)
     {
-    if ( j%threadCount != threadID )
+    // Take the next tile.
+    this->TileLock->Lock();
+    int tile = this->NextTile;
+    if ( tile < this->NumberOfTiles )
       {
-      continue;
+      this->NextTile++;
+      }
+    this->TileLock->Unlock();
+    if ( tile >= this->NumberOfTiles )
+      {
+      break;
       }
 
     if ( !threadID )
       {
-      this->UpdateProgress((double)j/this->ImageInUseSize[1]);
+      this->UpdateProgress((double)tile/this->NumberOfTiles);
       if ( renWin->CheckAbortStatus() )
         {
         break;
@@ -576,95 +611,110 @@ void vtkUnstructuredGridVolumeRayCastMapper::CastRays( int threadID, int threadC
       {
       break;
       }
-    
-    ucptr = this->Image + 4*j*this->ImageMemorySize[0];
 
-    for ( i = 0; i < this->ImageInUseSize[0]; i++ )
+    int minI = (tile%this->NumberOfTilesPerRow)*VTK_UGVRCM_TILE_SIZE;
+    int minJ = (tile/this->NumberOfTilesPerRow)*VTK_UGVRCM_TILE_SIZE;
+    int maxI = minI + VTK_UGVRCM_TILE_SIZE;
+    int maxJ = minJ + VTK_UGVRCM_TILE_SIZE;
+    maxI = (maxI>this->ImageInUseSize[0])?(this->ImageInUseSize[0]):(maxI);
+    maxJ = (maxJ>this->ImageInUseSize[1])?(this->ImageInUseSize[1]):(maxJ);
+    numRaysCast += (maxI - minI)*(maxJ - minJ);
+
+    for ( j = minJ; j < maxJ; j++ )
       {
-      int x = i + this->ImageOrigin[0];
-      int y = j + this->ImageOrigin[1];
-      
-      double bounds[2] = {0.0,1.0};
-      float color[4] = {0.0f, 0.0f, 0.0f, 0.0f};
-      
-      if ( this->ZBuffer )
+      ucptr = this->Image + 4*(j*this->ImageMemorySize[0] + minI);
+
+      for ( i = minI; i < maxI; i++ )
         {
-        bounds[1] = this->GetZBufferValue( x, y );
-        }
+        int x = i + this->ImageOrigin[0];
+        int y = j + this->ImageOrigin[1];
+        
+        double bounds[2] = {0.0,1.0};
+        float color[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        
+        if ( this->ZBuffer )
+          {
+          bounds[1] = this->GetZBufferValue( x, y );
+          }
 
-      iterator->SetBounds(bounds);
-      iterator->Initialize(x, y);
+        iterator->SetBounds(bounds);
+        iterator->Initialize(x, y);
 
-      vtkIdType numIntersections;
-      do
-        {
-        if (this->CellScalars)
+        vtkIdType numIntersections;
+        do
           {
-          numIntersections = iterator->GetNextIntersections(intersectedCells,
-                                                            intersectionLengths,
-                                                            NULL,
-                                                            NULL, NULL);
-          nearIntersections
-            ->SetNumberOfComponents(this->Scalars->GetNumberOfComponents());
-          nearIntersections->SetNumberOfTuples(numIntersections);
-          switch (this->Scalars->GetDataType())
+          if (this->CellScalars)
             {
-            vtkTemplateMacro(vtkUGVRCMLookupCopy
-                             ((const VTK_TT*)this->Scalars->GetVoidPointer(0),
-                              (VTK_TT*)nearIntersections->GetVoidPointer(0),
-                              intersectedCells->GetPointer(0),
-                              this->Scalars->GetNumberOfComponents(),
-                              numIntersections));
+            numIntersections = iterator->GetNextIntersections(intersectedCells,
+                                                              intersectionLengths,
+                                                              NULL,
+                                                              NULL, NULL);
+            nearIntersections
+              ->SetNumberOfComponents(this->Scalars->GetNumberOfComponents());
+            nearIntersections->SetNumberOfTuples(numIntersections);
+            switch (this->Scalars->GetDataType())
+              {
+              vtkTemplateMacro(vtkUGVRCMLookupCopy
+                               ((const VTK_TT*)this->Scalars->GetVoidPointer(0),
+                                (VTK_TT*)nearIntersections->GetVoidPointer(0),
+                                intersectedCells->GetPointer(0),
+                                this->Scalars->GetNumberOfComponents(),
+                                numIntersections));
+              }
             }
+          else
+            {
+            numIntersections = iterator->GetNextIntersections(NULL,
+                                                              intersectionLengths,
+                                                              this->Scalars,
+                                                              nearIntersections,
+                                                              farIntersections);
+            }
+          if (numIntersections < 1) break;
+          this->RealRayIntegrator->Integrate(intersectionLengths,
+                                             nearIntersections,
+                                             farIntersections,
+                                             color);
+          } while (color[3] < 0.99);
+
+        if ( color[3] > 0.0 )
+          {
+          int val;
+          val = static_cast<int>(color[0]*255.0);
+          val = (val > 255)?(255):(val);
+          val = (val <   0)?(  0):(val);
+          ucptr[0] = static_cast<unsigned char>(val);
+          
+          val = static_cast<int>(color[1]*255.0);
+          val = (val > 255)?(255):(val);
+          val = (val <   0)?(  0):(val);
+          ucptr[1] = static_cast<unsigned char>(val);
+          
+          val = static_cast<int>(color[2]*255.0);
+          val = (val > 255)?(255):(val);
+          val = (val <   0)?(  0):(val);
+          ucptr[2] = static_cast<unsigned char>(val);
+          
+          val = static_cast<int>(color[3]*255.0);
+          val = (val > 255)?(255):(val);
+          val = (val <   0)?(  0):(val);
+          ucptr[3] = static_cast<unsigned char>(val);
           }
         else
           {
-          numIntersections = iterator->GetNextIntersections(NULL,
-                                                            intersectionLengths,
-                                                            this->Scalars,
-                                                            nearIntersections,
-                                                            farIntersections);
+          ucptr[0] = 0;
+          ucptr[1] = 0;
+          ucptr[2] = 0;
+          ucptr[3] = 0;
           }
-        if (numIntersections < 1) break;
-        this->RealRayIntegrator->Integrate(intersectionLengths,
-                                           nearIntersections,
-                                           farIntersections,
-                                           color);
-        } while (color[3] < 0.99);
-
-      if ( color[3] > 0.0 )
-        {
-        int val;
-        val = static_cast<int>(color[0]*255.0);
-        val = (val > 255)?(255):(val);
-        val = (val <   0)?(  0):(val);
-        ucptr[0] = static_cast<unsigned char>(val);
-        
-        val = static_cast<int>(color[1]*255.0);
-        val = (val > 255)?(255):(val);
-        val = (val <   0)?(  0):(val);
-        ucptr[1] = static_cast<unsigned char>(val);
-        
-        val = static_cast<int>(color[2]*255.0);
-        val = (val > 255)?(255):(val);
-        val = (val <   0)?(  0):(val);
-        ucptr[2] = static_cast<unsigned char>(val);
-        
-        val = static_cast<int>(color[3]*255.0);
-        val = (val > 255)?(255):(val);
-        val = (val <   0)?(  0):(val);
-        ucptr[3] = static_cast<unsigned char>(val);
+        ucptr+=4;
         }
-      else
-        {
-        ucptr[0] = 0;
-        ucptr[1] = 0;
-        ucptr[2] = 0;
-        ucptr[3] = 0;
-        }
-      ucptr+=4;
       }
     }
+
+  this->TileLock->Lock();
+  this->NumberOfRaysCast += numRaysCast;
+  this->TileLock->Unlock();
 }
 
 double vtkUnstructuredGridVolumeRayCastMapper::
@@ -746,6 +796,8 @@ void vtkUnstructuredGridVolumeRayCastMapper::PrintSelf(ostream& os, vtkIndent in
     << (this->IntermixIntersectingGeometry ? "On\n" : "Off\n");
   
   os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
+  os << indent << "Number Of Rays Cast: " << this->NumberOfRaysCast << "\n";
+  os << indent << "Rays Per Second: " << this->RaysPerSecond << "\n";
   
   if (this->RayCastFunction)
     {
@@ -16,6 +16,9 @@
 // .NAME vtkUnstructuredGridVolumeRayCastMapper - A software mapper for unstructured volumes
 // .SECTION Description
 // This is a software ray caster for rendering volumes in vtkUnstructuredGrid. 
+// The image is split into square tiles that the threads take one at a time
+// from a shared queue, so that a thread done with cheap tiles (few cells
+// along the rays) goes on with the remaining ones.
 
 // .SECTION see also
 // vtkVolumeMapper
@@ -30,6 +33,7 @@ class vtkIdList;
 class vtkMultiThreader;
 class vtkRayCastImageDisplayHelper;
 class vtkRenderer;
+class vtkSimpleCriticalSection;
 class vtkTimerLog;
 class vtkUnstructuredGridVolumeRayCastFunction;
 class vtkUnstructuredGridVolumeRayCastIterator;
@@ -77,6 +81,12 @@ public:
   vtkSetMacro( NumberOfThreads, int );
   vtkGetMacro( NumberOfThreads, int );
 
+  // Description:
+  // Statistics of the last render: the number of rays cast, and the
+  // number of rays cast per second of ray casting (all threads together).
+  vtkGetMacro( NumberOfRaysCast, vtkIdType );
+  vtkGetMacro( RaysPerSecond, double );
+
   // Description:
   // If IntermixIntersectingGeometry is turned on, the zbuffer will be
   // captured and used to limit the traversal of the rays.
@@ -128,6 +138,16 @@ protected:
   vtkMultiThreader  *Threader;
   int               NumberOfThreads;
 
+  // The tiles of the image in use. The threads take them in order,
+  // NextTile being the first one not taken yet.
+  vtkSimpleCriticalSection *TileLock;
+  int               NumberOfTiles;
+  int               NumberOfTilesPerRow;
+  int               NextTile;
+
+  vtkIdType         NumberOfRaysCast;
+  double            RaysPerSecond;
+
   vtkRayCastImageDisplayHelper *ImageDisplayHelper;
   
   // This is how big the image would be if it covered the entire viewport
@@ -34,6 +34,7 @@
 #include "vtkUnstructuredGridHomogeneousRayIntegrator.h"
 #include "vtkDoubleArray.h"
 #include "vtkDataArray.h"
+#include "vtkMultiThreader.h"
 
 #include "vtkPolyData.h"
 #include "vtkCellArray.h"
@@ -44,6 +45,7 @@
 #include <string.h> // memset()
 #include <vtkstd/vector>
 #include <vtkstd/list>
+#include <vtkstd/algorithm> // min(), max()
 
 // do not remove the following line:
 //#define BACK_TO_FRONT
@@ -2036,6 +2038,7 @@ public:
       this->FaceIds[2]=faceIds[2];
       this->Count=0;
       this->Rendered = 0;
+      this->FirstVertex = -1;
       this->ExternalSide = externalSide;
     }
   
@@ -2065,6 +2068,11 @@ public:
   int GetRendered() { return this->Rendered; }
   void SetRendered(int value) { this->Rendered=value; }
   
+  // The vertex of the face that comes first in the sweep. The face is
+  // rasterized when this vertex is swept.
+  vtkIdType GetFirstVertex() { return this->FirstVertex; }
+  void SetFirstVertex(vtkIdType vertex) { this->FirstVertex=vertex; }
+  
   double GetScalar(int index)
     {
       assert("pre: valid_index" && index>=0 && index<=1);
@@ -2083,6 +2091,7 @@ protected:
   vtkIdType FaceIds[3];
   int Count;
   int Rendered;
+  vtkIdType FirstVertex;
   int ExternalSide;
 
   double Scalar[2]; // 0: value for positive orientation,
@@ -2361,6 +2370,137 @@ public:
     }
 };
 
+//-----------------------------------------------------------------------------
+// The vertices in the order of the sweep, as popped from the event list.
+// For each of them, Reach is the screen bounding box (xmin,xmax,ymin,ymax)
+// of its incident faces: a tile that does not intersect it can skip the
+// vertex. It is shared by the threads.
+class vtkSweepEvents
+{
+public:
+  vtkstd::vector<vtkIdType> Vertices;
+  vtkstd::vector<double> Keys;
+  vtkstd::vector<int> Reach;
+};
+
+//-----------------------------------------------------------------------------
+// State of a thread sweeping a tile of the image: the bounds of the tile,
+// the scan-conversion helpers and the pixel lists of the tile with their
+// own memory pool. Coordinates are those of the whole image in use; pixel
+// lists are indexed relative to the tile.
+class vtkSweepContext
+{
+public:
+  vtkSweepContext()
+    {
+      this->XMin=0;
+      this->XMax=-1;
+      this->YMin=0;
+      this->YMax=-1;
+      this->Width=0;
+      this->Span=new vtkSpan;
+      this->SimpleEdge=new vtkSimpleScreenEdge;
+      this->DoubleEdge=new vtkDoubleScreenEdge;
+      this->PixelListFrame=0;
+      this->MemoryManager=new vtkPixelListEntryMemory;
+      this->IntersectionLengths=vtkDoubleArray::New();
+      this->IntersectionLengths->SetNumberOfValues(1);
+      this->NearIntersections=vtkDoubleArray::New();
+      this->NearIntersections->SetNumberOfValues(1);
+      this->FarIntersections=vtkDoubleArray::New();
+      this->FarIntersections->SetNumberOfValues(1);
+    }
+  
+  ~vtkSweepContext()
+    {
+      delete this->Span;
+      delete this->SimpleEdge;
+      delete this->DoubleEdge;
+      if(this->PixelListFrame!=0)
+        {
+        delete this->PixelListFrame;
+        }
+      delete this->MemoryManager;
+      this->IntersectionLengths->Delete();
+      this->NearIntersections->Delete();
+      this->FarIntersections->Delete();
+    }
+  
+  // Set the tile to sweep, bounds included, and create an empty pixel list
+  // for each of its pixels.
+  void SetTile(int xMin,
+               int xMax,
+               int yMin,
+               int yMax)
+    {
+      this->XMin=xMin;
+      this->XMax=xMax;
+      this->YMin=yMin;
+      this->YMax=yMax;
+      this->Width=xMax-xMin+1;
+      vtkIdType size=static_cast<vtkIdType>(this->Width)*(yMax-yMin+1);
+      if(this->PixelListFrame!=0)
+        {
+        if(this->PixelListFrame->GetSize()<size)
+          {
+          delete this->PixelListFrame;
+          this->PixelListFrame=0;
+          }
+        }
+      if(this->PixelListFrame==0)
+        {
+        this->PixelListFrame=new vtkPixelListFrame(size);
+        }
+    }
+  
+  // Index of the pixel list of the pixel (x,y) of the image.
+  vtkIdType GetPixelIndex(int x,
+                          int y)
+    {
+      return static_cast<vtkIdType>(y-this->YMin)*this->Width+x-this->XMin;
+    }
+  
+  // Does the screen box (xmin,xmax,ymin,ymax) intersect the tile?
+  int Intersects(const int box[4])
+    {
+      return box[0]<=this->XMax && box[1]>=this->XMin &&
+        box[2]<=this->YMax && box[3]>=this->YMin;
+    }
+  
+  // Tile bounds.
+  int XMin;
+  int XMax;
+  int YMin;
+  int YMax;
+  int Width;
+  
+  // Used by the main loop
+  int MaxPixelListSizeReached;
+  int XBounds[2];
+  int YBounds[2];
+  
+  // if use CellScalars, we need to keep track of the
+  // values on each side of the face and figure out
+  // if the face is used by two cells (twosided) or one cell.
+  double FaceScalars[2];
+  int FaceSide;
+  
+  vtkSpan *Span;
+  vtkSimpleScreenEdge *SimpleEdge;
+  vtkDoubleScreenEdge *DoubleEdge;
+  vtkPixelListFrame *PixelListFrame;
+  vtkPixelListEntryMemory *MemoryManager;
+  
+  // Used during compositing
+  vtkDoubleArray *IntersectionLengths;
+  vtkDoubleArray *NearIntersections;
+  vtkDoubleArray *FarIntersections;
+  
+private:
+  vtkSweepContext(const vtkSweepContext &other); // not implemented
+  vtkSweepContext &operator=(const vtkSweepContext &other); // not implemented
+};
+
 };
 
 using namespace vtkUnstructuredGridVolumeZSweepMapperNamespace;
@@ -2408,7 +2548,15 @@ vtkUnstructuredGridVolumeZSweepMapper::vtkUnstructuredGridVolumeZSweepMapper()
 
   this->ImageDisplayHelper     = vtkRayCastImageDisplayHelper::New();
   
-  this->PixelListFrame=0;
+  this->NumberOfThreads=vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  int i=0;
+  while(i<VTK_MAX_THREADS)
+    {
+    this->Contexts[i]=0;
+    ++i;
+    }
+  this->Events=new vtkSweepEvents;
+  this->SweepAborted=0;
   
   this->Cell=vtkGenericCell::New();
 
@@ -2420,35 +2568,23 @@ vtkUnstructuredGridVolumeZSweepMapper::vtkUnstructuredGridVolumeZSweepMapper()
   this->PerspectiveTransform = vtkTransform::New();
   this->PerspectiveMatrix = vtkMatrix4x4::New();
   
-  this->SimpleEdge=new vtkSimpleScreenEdge;
-  this->DoubleEdge=new vtkDoubleScreenEdge;
-  
-  this->Span=new vtkSpan;
-  
   this->RayIntegrator = NULL;
   this->RealRayIntegrator = NULL;
-  
-  this->IntersectionLengths=vtkDoubleArray::New();
-  this->IntersectionLengths->SetNumberOfValues(1);
-  this->NearIntersections=vtkDoubleArray::New();
-  this->NearIntersections->SetNumberOfValues(1);
-  this->FarIntersections=vtkDoubleArray::New();
-  this->FarIntersections->SetNumberOfValues(1);
-  
-  this->MemoryManager=0;
 }
 
 //-----------------------------------------------------------------------------
 vtkUnstructuredGridVolumeZSweepMapper::~vtkUnstructuredGridVolumeZSweepMapper()
 {
-  if(this->MemoryManager!=0)
+  int i=0;
+  while(i<VTK_MAX_THREADS)
     {
-    delete this->MemoryManager;
-    }
-  if(this->PixelListFrame!=0)
-    {
-    delete this->PixelListFrame;
+    if(this->Contexts[i]!=0)
+      {
+      delete this->Contexts[i];
+      }
+    ++i;
     }
+  delete this->Events;
   this->Cell->Delete();
   this->EventList->Delete();
   
@@ -2467,10 +2603,6 @@ vtkUnstructuredGridVolumeZSweepMapper::~vtkUnstructuredGridVolumeZSweepMapper()
   this->PerspectiveTransform->Delete();
   this->PerspectiveMatrix->Delete();
 
-  delete this->SimpleEdge;
-  delete this->DoubleEdge;
-  delete this->Span;
-  
   if ( this->Image )
     {
     delete [] this->Image;
@@ -2489,10 +2621,6 @@ vtkUnstructuredGridVolumeZSweepMapper::~vtkUnstructuredGridVolumeZSweepMapper()
     {
     this->RealRayIntegrator->UnRegister(this);
     }
-  
-  this->IntersectionLengths->Delete();
-  this->NearIntersections->Delete();
-  this->FarIntersections->Delete();
 }
 
 //-----------------------------------------------------------------------------
@@ -2589,6 +2717,7 @@ void vtkUnstructuredGridVolumeZSweepMapper::PrintSelf(ostream& os,
      << this->AutoAdjustSampleDistances << "\n";
   os << indent << "Intermix Intersecting Geometry: "
     << (this->IntermixIntersectingGeometry ? "On\n" : "Off\n");
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 
   // The PrintSelf test just search for words in the PrintSelf function
   // We add here the internal variable we don't want to display:
@@ -2864,14 +2993,11 @@ void vtkUnstructuredGridVolumeZSweepMapper::Render(vtkRenderer *ren,
   this->ProjectAndSortVertices(ren,vol);
   vtkDebugMacro(<<"ProjectAndSortVertices: done");
   
-  // 3. Create an empty "pixel list" (two way linked list) for each pixel of
-  //    the screen.
-  vtkDebugMacro(<<"CreateAndCleanPixelList: start");
-  this->CreateAndCleanPixelList();
-  vtkDebugMacro(<<"CreateAndCleanPixelList: done");
-  
-  // 4. Main loop
+  // 3. Main loop
   // (section 2 paragraph 11)
+  // The image is split into tiles that are swept independently by
+  // NumberOfThreads threads. Each tile has an empty "pixel list" (two way
+  // linked list) for each of its pixels.
   vtkDebugMacro(<<"MainLoop: start");
   this->MainLoop(ren->GetRenderWindow());
   vtkDebugMacro(<<"MainLoop: done");
@@ -3207,27 +3333,209 @@ void vtkUnstructuredGridVolumeZSweepMapper::ProjectAndSortVertices(
 }
 
 //-----------------------------------------------------------------------------
-void vtkUnstructuredGridVolumeZSweepMapper::CreateAndCleanPixelList()
+// Split the image into tiles for the threads.
+// Tiles are horizontal bands of the image in use. When there are several
+// threads, there are a few tiles per thread, handed out in turn, so that
+// each thread gets parts of both the dense and the sparse regions of the
+// image.
+#define VTK_ZSWEEP_TILES_PER_THREAD 4
+
+// Passed to the threads by MainLoop().
+struct vtkUnstructuredGridVolumeZSweepMapperThreadData
+{
+  vtkUnstructuredGridVolumeZSweepMapper *Self;
+  vtkRenderWindow *RenderWindow;
+  int NumberOfTiles;
+};
+
+//-----------------------------------------------------------------------------
+void vtkUnstructuredGridVolumeZSweepMapper::PrepareSweep()
 {
-  // paper: a "pixel list" is a double linked list. We put that in a queue.
-  vtkIdType size=this->ImageInUseSize[0]*this->ImageInUseSize[1];
-  if(this->PixelListFrame!=0)
+  vtkIdType numberOfEvents=this->EventList->GetNumberOfItems();
+  
+  this->Events->Vertices.resize(numberOfEvents);
+  this->Events->Keys.resize(numberOfEvents);
+  this->Events->Reach.resize(4*numberOfEvents);
+  
+  this->UseSet->SetNotRendered();
+  
+  vtkstd::list<vtkFace *>::iterator it;
+  vtkstd::list<vtkFace *>::iterator itEnd;
+  
+  vtkIdType k=0;
+  while(k<numberOfEvents)
     {
-    if(this->PixelListFrame->GetSize()<size)
+    double key;
+    vtkIdType vertex=this->EventList->Pop(0,key);
+    this->Events->Vertices[k]=vertex;
+    this->Events->Keys[k]=key;
+    
+    vtkVertexEntry *entry=&(this->Vertices->Vector[vertex]);
+    int *reach=&(this->Events->Reach[4*k]);
+    reach[0]=entry->GetScreenX();
+    reach[1]=reach[0];
+    reach[2]=entry->GetScreenY();
+    reach[3]=reach[2];
+    
+    if(this->UseSet->Vector[vertex]!=0)
       {
-      delete this->PixelListFrame;
-      this->PixelListFrame=0;
+      it=this->UseSet->Vector[vertex]->begin();
+      itEnd=this->UseSet->Vector[vertex]->end();
+      while(it!=itEnd)
+        {
+        vtkFace *face=(*it);
+        // The face is rasterized by the first of its vertices in the sweep.
+        if(!face->GetRendered())
+          {
+          face->SetFirstVertex(vertex);
+          face->SetRendered(1);
+          }
+        vtkIdType *vids=face->GetFaceIds();
+        vtkIdType i=0;
+        while(i<3)
+          {
+          vtkVertexEntry *v=&(this->Vertices->Vector[vids[i]]);
+          if(v->GetScreenX()<reach[0])
+            {
+            reach[0]=v->GetScreenX();
+            }
+          if(v->GetScreenX()>reach[1])
+            {
+            reach[1]=v->GetScreenX();
+            }
+          if(v->GetScreenY()<reach[2])
+            {
+            reach[2]=v->GetScreenY();
+            }
+          if(v->GetScreenY()>reach[3])
+            {
+            reach[3]=v->GetScreenY();
+            }
+          ++i;
+          }
+        ++it;
+        }
       }
+    ++k;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkUnstructuredGridVolumeZSweepMapper::MainLoop(vtkRenderWindow *renWin)
+{
+  if(this->EventList->GetNumberOfItems()==0)
+    {
+    return; // we are done.
     }
   
-  if(this->PixelListFrame==0)
+  this->PrepareSweep();
+  
+  if(this->ImageInUseSize[0]<=0 || this->ImageInUseSize[1]<=0)
     {
-    this->PixelListFrame=new vtkPixelListFrame(size);
+    return;
     }
+  
+  int numberOfThreads=this->NumberOfThreads;
+  int numberOfTiles=1;
+  if(numberOfThreads>1)
+    {
+    numberOfTiles=VTK_ZSWEEP_TILES_PER_THREAD*numberOfThreads;
+    if(numberOfTiles>this->ImageInUseSize[1])
+      {
+      numberOfTiles=this->ImageInUseSize[1];
+      }
+    if(numberOfThreads>numberOfTiles)
+      {
+      numberOfThreads=numberOfTiles;
+      }
+    }
+  
+  int i=0;
+  while(i<numberOfThreads)
+    {
+    if(this->Contexts[i]==0)
+      {
+      this->Contexts[i]=new vtkSweepContext;
+      }
+    ++i;
+    }
+  
+  this->SweepAborted=0;
+  
+  vtkUnstructuredGridVolumeZSweepMapperThreadData data;
+  data.Self=this;
+  data.RenderWindow=renWin;
+  data.NumberOfTiles=numberOfTiles;
+  
+  if(numberOfThreads==1)
+    {
+    vtkMultiThreader::ThreadInfo info;
+    info.ThreadID=0;
+    info.NumberOfThreads=1;
+    info.UserData=&data;
+    vtkUnstructuredGridVolumeZSweepMapper::SweepTilesThread(&info);
+    }
+  else
+    {
+    vtkMultiThreader *threader=vtkMultiThreader::New();
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(
+      vtkUnstructuredGridVolumeZSweepMapper::SweepTilesThread,&data);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    }
+  
+  assert("post: empty_list" && this->EventList->GetNumberOfItems()==0);
 }
 
 //-----------------------------------------------------------------------------
-void vtkUnstructuredGridVolumeZSweepMapper::MainLoop(vtkRenderWindow *renWin)
+VTK_THREAD_RETURN_TYPE
+vtkUnstructuredGridVolumeZSweepMapper::SweepTilesThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info=
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkUnstructuredGridVolumeZSweepMapperThreadData *data=
+    static_cast<vtkUnstructuredGridVolumeZSweepMapperThreadData *>(
+      info->UserData);
+  vtkUnstructuredGridVolumeZSweepMapper *self=data->Self;
+  vtkSweepContext *context=self->Contexts[info->ThreadID];
+  
+  // Only the first thread, which runs in the calling thread, reports the
+  // progress and checks for abort.
+  vtkRenderWindow *renWin=0;
+  if(info->ThreadID==0)
+    {
+    renWin=data->RenderWindow;
+    }
+  
+  int width=self->ImageInUseSize[0];
+  int height=self->ImageInUseSize[1];
+  int numberOfTiles=data->NumberOfTiles;
+  int numberOfOwnTiles=
+    (numberOfTiles-info->ThreadID+info->NumberOfThreads-1)/
+    info->NumberOfThreads;
+  
+  int tile=info->ThreadID;
+  int count=0;
+  while(tile<numberOfTiles && !self->SweepAborted)
+    {
+    context->SetTile(0,width-1,height*tile/numberOfTiles,
+                     height*(tile+1)/numberOfTiles-1);
+    self->SweepTile(context,renWin,
+                    static_cast<double>(count)/numberOfOwnTiles,
+                    static_cast<double>(count+1)/numberOfOwnTiles);
+    tile+=info->NumberOfThreads;
+    ++count;
+    }
+  
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+void vtkUnstructuredGridVolumeZSweepMapper::SweepTile(vtkSweepContext *context,
+                                                      vtkRenderWindow *renWin,
+                                                      double progressStart,
+                                                      double progressEnd)
 {
   double previousZTarget=0.0;
   double zTarget;
@@ -3236,14 +3544,12 @@ void vtkUnstructuredGridVolumeZSweepMapper::MainLoop(vtkRenderWindow *renWin)
 // used to know if the next vertex is on the same plane
   double currentZ; // than the previous one. If so, the z-target has to be
   // updated (without calling the compositing function)
-  if(this->EventList->GetNumberOfItems()==0)
-    {
-    return; // we are done.
-    }
+  
+  vtkIdType sum=static_cast<vtkIdType>(this->Events->Vertices.size());
   
   // initialize the "previous z-target" to the z-coordinate of the first
   // vertex.
-  vertex=this->EventList->Peek(0,previousZTarget);
+  previousZTarget=this->Events->Keys[0];
   
 #ifdef BACK_TO_FRONT
   previousZTarget=-previousZTarget; // because the EventList store -z
@@ -3260,40 +3566,47 @@ void vtkUnstructuredGridVolumeZSweepMapper::MainLoop(vtkRenderWindow *renWin)
   vtkstd::list<vtkFace *>::iterator itEnd;
   
 //  this->MaxRecordedPixelListSize=0;
-  this->MaxPixelListSizeReached=0;
-  this->XBounds[0]=this->ImageInUseSize[0];
-  this->XBounds[1]=0;
-  this->YBounds[0]=this->ImageInUseSize[1];
-  this->YBounds[1]=0;
+  context->MaxPixelListSizeReached=0;
+  context->XBounds[0]=context->XMax+1;
+  context->XBounds[1]=context->XMin;
+  context->YBounds[0]=context->YMax+1;
+  context->YBounds[1]=context->YMin;
   
   vtkIdType progressCount=0;
-  vtkIdType sum=this->EventList->GetNumberOfItems();
-  
-  if(this->MemoryManager==0)
-    {
-    this->MemoryManager=new vtkPixelListEntryMemory;
-    }
-  
-  this->UseSet->SetNotRendered();
   
   int aborded=0;
   // for each vertex of the "event list"
-  while(this->EventList->GetNumberOfItems()>0)
+  while(progressCount<sum)
     {
-    this->UpdateProgress(static_cast<double>(progressCount)/sum);
-    
-    aborded=renWin->CheckAbortStatus();
+    if(renWin!=0)
+      {
+      this->UpdateProgress(progressStart+(progressEnd-progressStart)*
+                           static_cast<double>(progressCount)/sum);
+      
+      aborded=renWin->CheckAbortStatus();
+      if(aborded)
+        {
+        this->SweepAborted=1;
+        }
+      }
+    else
+      {
+      aborded=this->SweepAborted;
+      }
     if(aborded)
       {
       break;
       }
-    ++progressCount;
     //  the z coordinate of the current vertex defines the "sweep plane".
-    vertex=this->EventList->Pop(0,currentZ);
+    vertex=this->Events->Vertices[progressCount];
+    currentZ=this->Events->Keys[progressCount];
+    const int *reach=&(this->Events->Reach[4*progressCount]);
+    ++progressCount;
 
-    if(this->UseSet->Vector[vertex]!=0)
+    if(this->UseSet->Vector[vertex]!=0 && context->Intersects(reach))
       { // otherwise the vertex is not useful, basically this is the
-      // end we reached the last ztarget
+      // end we reached the last ztarget, or none of its faces covers the
+      // tile
       
 #ifdef BACK_TO_FRONT
     currentZ=-currentZ; // because the EventList store -z
@@ -3339,7 +3652,7 @@ void vtkUnstructuredGridVolumeZSweepMapper::MainLoop(vtkRenderWindow *renWin)
       if(currentZ>zTarget)
 #endif
       {
-      this->CompositeFunction(zTarget);
+      this->CompositeFunction(context,zTarget);
       
       // Update the zTarget
       previousZTarget=zTarget;
@@ -3371,9 +3684,9 @@ void vtkUnstructuredGridVolumeZSweepMapper::MainLoop(vtkRenderWindow *renWin)
       }
     else
       {
-      if(this->MaxPixelListSizeReached)
+      if(context->MaxPixelListSizeReached)
         {
-        this->CompositeFunction(currentZ);
+        this->CompositeFunction(context,currentZ);
         // We do not update the zTarget in this case.
         }
       }
@@ -3388,81 +3701,60 @@ void vtkUnstructuredGridVolumeZSweepMapper::MainLoop(vtkRenderWindow *renWin)
     while(it!=itEnd)
       {
       vtkFace *face=(*it);
-      if(!face->GetRendered())
+      if(face->GetFirstVertex()==vertex)
         {
         vtkIdType *vids=face->GetFaceIds();
-        if(this->CellScalars)
+        // Skip the faces that do not cover the tile.
+        vtkVertexEntry *v0=&(this->Vertices->Vector[vids[0]]);
+        vtkVertexEntry *v1=&(this->Vertices->Vector[vids[1]]);
+        vtkVertexEntry *v2=&(this->Vertices->Vector[vids[2]]);
+        int box[4];
+        box[0]=vtkstd::min(v0->GetScreenX(),
+                           vtkstd::min(v1->GetScreenX(),v2->GetScreenX()));
+        box[1]=vtkstd::max(v0->GetScreenX(),
+                           vtkstd::max(v1->GetScreenX(),v2->GetScreenX()));
+        box[2]=vtkstd::min(v0->GetScreenY(),
+                           vtkstd::min(v1->GetScreenY(),v2->GetScreenY()));
+        box[3]=vtkstd::max(v0->GetScreenY(),
+                           vtkstd::max(v1->GetScreenY(),v2->GetScreenY()));
+        if(context->Intersects(box))
           {
-          this->FaceScalars[0]=face->GetScalar(0);
-          this->FaceScalars[1]=face->GetScalar(1);
-          }
-        this->RasterizeFace(vids, face->GetExternalSide());
-        face->SetRendered(1);
-        }
-#if 0 // face search
-      // for each point of the face, get the closest z
-      vtkIdType *vids=face->GetFaceIds();
-      vtkIdType minVertex=vids[0];
-      double farestZ=this->Vertices->Vector[vids[0]].GetZview();
-      
-      vtkIdType i=1;
-      while(i<3)
-        {
-        double z=this->Vertices->Vector[vids[i]].GetZview();
-#ifdef BACK_TO_FRONT
-        if(z>farestZ)
-#else
-          if(z<farestZ)
-#endif
-          {
-          farestZ=z;
-          minVertex=vids[i];
+          if(this->CellScalars)
+            {
+            context->FaceScalars[0]=face->GetScalar(0);
+            context->FaceScalars[1]=face->GetScalar(1);
+            }
+          this->RasterizeFace(context,vids,face->GetExternalSide());
           }
-        ++i;
-        }
-      if(minVertex==vertex)
-        {
-//        if(face->GetRendered())
-//          {
-//          cout<<"FACE ALREADY RENDERED!!!!"<<endl;
-//          }
-        this->RasterizeFace(vids);
-//        face->SetRendered(1);
         }
-#endif // face search      
       ++it;
       }
       } // if useset of vertex is not null
-    } // while(eventList->GetNumberOfItems()>0)
+    } // for each vertex of the sweep
 
   if(!aborded)
     {
     // Here a final compositing
     vtkDebugMacro(<<"Flush Compositing");
-//   this->SavePixelListFrame();
+//   this->SavePixelListFrame(context);
 #ifdef BACK_TO_FRONT
-    this->CompositeFunction(-2);
+    this->CompositeFunction(context,-2);
 #else
-    this->CompositeFunction(2);
+    this->CompositeFunction(context,2);
 #endif
     }
-  else
-    {
-    this->EventList->Reset();
-    }
-  this->PixelListFrame->Clean(this->MemoryManager);
+  context->PixelListFrame->Clean(context->MemoryManager);
 //  vtkDebugMacro(<<"MaxRecordedPixelListSize="<<this->MaxRecordedPixelListSize);
-  
-  assert("post: empty_list" && this->EventList->GetNumberOfItems()==0);
 }
 
 //-----------------------------------------------------------------------------
-void vtkUnstructuredGridVolumeZSweepMapper::SavePixelListFrame()
+void vtkUnstructuredGridVolumeZSweepMapper::SavePixelListFrame(
+  vtkSweepContext *context)
 {
   vtkPolyData *dataset=vtkPolyData::New();
   
-  vtkIdType height=this->ImageInUseSize[1];
-  vtkIdType width=this->ImageInUseSize[0];
+  vtkIdType height=context->YMax+1;
+  vtkIdType width=context->XMax+1;
   vtkPixelListEntry *current;
   vtkIdType i;
   
@@ -3476,14 +3768,14 @@ void vtkUnstructuredGridVolumeZSweepMapper::SavePixelListFrame()
 //  height=151;
 //  width=151;
   
-  vtkIdType y=0; //150;
+  vtkIdType y=context->YMin; //150;
   while(y<height)
     {
-    vtkIdType x=0; //150;
+    vtkIdType x=context->XMin; //150;
     while(x<width)
       {     
-      i=y*this->ImageInUseSize[0]+x;
-      current=this->PixelListFrame->GetFirst(i);
+      i=context->GetPixelIndex(x,y);
+      current=context->PixelListFrame->GetFirst(i);
       while(current!=0)
         {
         double *values=current->GetValues();
@@ -3522,8 +3814,10 @@ void vtkUnstructuredGridVolumeZSweepMapper::SavePixelListFrame()
 //-----------------------------------------------------------------------------
 // Description:
 // Perform a scan conversion of a triangle, interpolating z and the scalar.
-void vtkUnstructuredGridVolumeZSweepMapper::RasterizeFace(vtkIdType faceIds[3],
-                                                          int externalSide)
+void vtkUnstructuredGridVolumeZSweepMapper::RasterizeFace(
+  vtkSweepContext *context,
+  vtkIdType faceIds[3],
+  int externalSide)
 {
   // The triangle is splitted by an horizontal line passing through the
   // second vertex v1 (y-order)
@@ -3554,11 +3848,11 @@ void vtkUnstructuredGridVolumeZSweepMapper::RasterizeFace(vtkIdType faceIds[3],
     int zcross= vec0[0]*vec1[1] - vec0[1]*vec1[0];
     if(zcross<0)
       {
-      this->FaceSide=1;
+      context->FaceSide=1;
       }
     else
       {
-      this->FaceSide=0;
+      context->FaceSide=0;
       }
 
     // When determining the exit face, be conservative.  If the triangle is too
@@ -3585,13 +3879,14 @@ void vtkUnstructuredGridVolumeZSweepMapper::RasterizeFace(vtkIdType faceIds[3],
       }
     }
   
-  this->RasterizeTriangle(v0,v1,v2,exitFace);
+  this->RasterizeTriangle(context,v0,v1,v2,exitFace);
 }
 
 //-----------------------------------------------------------------------------
 // Description:
 // Perform a scan conversion of a triangle, interpolating z and the scalar.
 void  vtkUnstructuredGridVolumeZSweepMapper::RasterizeTriangle(
+                                                    vtkSweepContext *context,
                                                             vtkVertexEntry *ve0,
                                                             vtkVertexEntry *ve1,
                                                             vtkVertexEntry *ve2,
@@ -3637,108 +3932,108 @@ void  vtkUnstructuredGridVolumeZSweepMapper::RasterizeTriangle(
       }
     }
   
-  if(v0->GetScreenY()<this->YBounds[0])
+  if(v0->GetScreenY()<context->YBounds[0])
     {
-    if(v0->GetScreenY()>=0)
+    if(v0->GetScreenY()>=context->YMin)
       {
-      this->YBounds[0]=v0->GetScreenY();
+      context->YBounds[0]=v0->GetScreenY();
       }
     else
       {
-      this->YBounds[0]=0;
+      context->YBounds[0]=context->YMin;
       }
     }
-  if(v2->GetScreenY()>this->YBounds[1])
+  if(v2->GetScreenY()>context->YBounds[1])
     {
-    if(v2->GetScreenY()<this->ImageInUseSize[1])
+    if(v2->GetScreenY()<=context->YMax)
       {
-      this->YBounds[1]=v2->GetScreenY();
+      context->YBounds[1]=v2->GetScreenY();
       }
     else
       {
-      this->YBounds[1]=this->ImageInUseSize[1]-1;
+      context->YBounds[1]=context->YMax;
       }
     }
   
   int x=v0->GetScreenX();
   
-  if(x<this->XBounds[0])
+  if(x<context->XBounds[0])
     {
-    if(x>=0)
+    if(x>=context->XMin)
       {
-      this->XBounds[0]=x;
+      context->XBounds[0]=x;
       }
     else
       {
-      this->XBounds[0]=0;
+      context->XBounds[0]=context->XMin;
       }
     }
   else
     {
-    if(x>this->XBounds[1])
+    if(x>context->XBounds[1])
       {
-      if(x<this->ImageInUseSize[0])
+      if(x<=context->XMax)
         {
-        this->XBounds[1]=x;
+        context->XBounds[1]=x;
         }
       else
         {
-        this->XBounds[1]=this->ImageInUseSize[0]-1;
+        context->XBounds[1]=context->XMax;
         }
       }
     }
   x=v1->GetScreenX();
   
-  if(x<this->XBounds[0])
+  if(x<context->XBounds[0])
     {
-    if(x>=0)
+    if(x>=context->XMin)
       {
-      this->XBounds[0]=x;
+      context->XBounds[0]=x;
       }
     else
       {
-      this->XBounds[0]=0;
+      context->XBounds[0]=context->XMin;
       }
     }
   else
     {
-    if(x>this->XBounds[1])
+    if(x>context->XBounds[1])
       {
-       if(x<this->ImageInUseSize[0])
+       if(x<=context->XMax)
         {
-        this->XBounds[1]=x;
+        context->XBounds[1]=x;
         }
       else
         {
-        this->XBounds[1]=this->ImageInUseSize[0]-1;
+        context->XBounds[1]=context->XMax;
         }
       }
     }
   
   x=v2->GetScreenX();
   
-  if(x<this->XBounds[0])
+  if(x<context->XBounds[0])
     {
-    if(x>=0)
+    if(x>=context->XMin)
       {
-      this->XBounds[0]=x;
+      context->XBounds[0]=x;
       }
     else
       {
-      this->XBounds[0]=0;
+      context->XBounds[0]=context->XMin;
       }
     }
   else
     {
-    if(x>this->XBounds[1])
+    if(x>context->XBounds[1])
       {
-      if(x<this->ImageInUseSize[0])
+      if(x<=context->XMax)
         {
-        this->XBounds[1]=x;
+        context->XBounds[1]=x;
         }
       else
         {
-        this->XBounds[1]=this->ImageInUseSize[0]-1;
+        context->XBounds[1]=context->XMax;
         }
       }
     }
@@ -3762,53 +4057,53 @@ void  vtkUnstructuredGridVolumeZSweepMapper::RasterizeTriangle(
       {
       x=v0->GetScreenX();
       int y=v0->GetScreenY();
-      if(x>=0 && x<this->ImageInUseSize[0] && y>=0 &&
-         y<this->ImageInUseSize[1])
+      if(x>=context->XMin && x<=context->XMax && y>=context->YMin &&
+         y<=context->YMax)
         {
-        vtkIdType i=y*this->ImageInUseSize[0]+x;
+        vtkIdType i=context->GetPixelIndex(x,y);
         // Write the pixel
-        vtkPixelListEntry *p0=this->MemoryManager->AllocateEntry();
+        vtkPixelListEntry *p0=context->MemoryManager->AllocateEntry();
         p0->Init(v0->GetValues(),v0->GetZview(), externalFace);
         if(this->CellScalars)
           {
-          p0->GetValues()[VTK_VALUES_SCALAR_INDEX]=this->FaceScalars[this->FaceSide];
+          p0->GetValues()[VTK_VALUES_SCALAR_INDEX]=context->FaceScalars[context->FaceSide];
           }
-        this->PixelListFrame->AddAndSort(i,p0);
+        context->PixelListFrame->AddAndSort(i,p0);
         
-        vtkPixelListEntry *p1=this->MemoryManager->AllocateEntry();
+        vtkPixelListEntry *p1=context->MemoryManager->AllocateEntry();
         p1->Init(v1->GetValues(),v1->GetZview(), externalFace);
         if(this->CellScalars)
           {
-          p1->GetValues()[VTK_VALUES_SCALAR_INDEX]=this->FaceScalars[this->FaceSide];
+          p1->GetValues()[VTK_VALUES_SCALAR_INDEX]=context->FaceScalars[context->FaceSide];
           }
-        this->PixelListFrame->AddAndSort(i,p1);
+        context->PixelListFrame->AddAndSort(i,p1);
         
-        vtkPixelListEntry *p2=this->MemoryManager->AllocateEntry();
+        vtkPixelListEntry *p2=context->MemoryManager->AllocateEntry();
         p2->Init(v2->GetValues(),v2->GetZview(), externalFace);
         if(this->CellScalars)
           {
-          p2->GetValues()[VTK_VALUES_SCALAR_INDEX]=this->FaceScalars[this->FaceSide];
+          p2->GetValues()[VTK_VALUES_SCALAR_INDEX]=context->FaceScalars[context->FaceSide];
           }
-        this->PixelListFrame->AddAndSort(i,p2);
+        context->PixelListFrame->AddAndSort(i,p2);
         
         
-//        if(this->PixelListFrame->GetListSize(i)>this->MaxRecordedPixelListSize)
+//        if(context->PixelListFrame->GetListSize(i)>this->MaxRecordedPixelListSize)
 //          {
-//          this->MaxRecordedPixelListSize=this->PixelListFrame->GetListSize(i);
+//          this->MaxRecordedPixelListSize=context->PixelListFrame->GetListSize(i);
 //          }
         
-        if(!this->MaxPixelListSizeReached)
+        if(!context->MaxPixelListSizeReached)
           {
-          this->MaxPixelListSizeReached=this->PixelListFrame->GetListSize(i)>
+          context->MaxPixelListSizeReached=context->PixelListFrame->GetListSize(i)>
             this->MaxPixelListSize;
           } 
         }
       }
     else // line
       {
-      this->RasterizeLine(v0,v1,externalFace);
-      this->RasterizeLine(v1,v2,externalFace);
-      this->RasterizeLine(v0,v2,externalFace);
+      this->RasterizeLine(context,v0,v1,externalFace);
+      this->RasterizeLine(context,v1,v2,externalFace);
+      this->RasterizeLine(context,v0,v2,externalFace);
       }
     return;
     }
@@ -3816,18 +4111,18 @@ void  vtkUnstructuredGridVolumeZSweepMapper::RasterizeTriangle(
     {
     if(det>0) //v0v1 on right
       {
-       this->DoubleEdge->Init(v0,v1,v2,dx10,dy10,1); // true=on right
-       rightEdge=this->DoubleEdge;
-       this->SimpleEdge->Init(v0,v2,dx20,dy20,0);
-       leftEdge=this->SimpleEdge;
+       context->DoubleEdge->Init(v0,v1,v2,dx10,dy10,1); // true=on right
+       rightEdge=context->DoubleEdge;
+       context->SimpleEdge->Init(v0,v2,dx20,dy20,0);
+       leftEdge=context->SimpleEdge;
        }
      else
        {
        // v0v1 on left
-       this->DoubleEdge->Init(v0,v1,v2,dx10,dy10,0); // true=on right
-       leftEdge=this->DoubleEdge;
-       this->SimpleEdge->Init(v0,v2,dx20,dy20,1);
-       rightEdge=this->SimpleEdge;
+       context->DoubleEdge->Init(v0,v1,v2,dx10,dy10,0); // true=on right
+       leftEdge=context->DoubleEdge;
+       context->SimpleEdge->Init(v0,v2,dx20,dy20,1);
+       rightEdge=context->SimpleEdge;
        }
     }
   
@@ -3837,19 +4132,19 @@ void  vtkUnstructuredGridVolumeZSweepMapper::RasterizeTriangle(
   
   int skipped=0;
   
-  if(y1>=0) // clipping
+  if(y1>=context->YMin) // clipping
     {
     
-    if(y1>=this->ImageInUseSize[1]) // clipping
+    if(y1>context->YMax) // clipping
       {
-      y1=this->ImageInUseSize[1]-1;
+      y1=context->YMax;
       }
     
     while(y<=y1)
       {
-      if(y>=0 && y<this->ImageInUseSize[1]) // clipping
+      if(y>=context->YMin && y<=context->YMax) // clipping
         {
-        this->RasterizeSpan(y,leftEdge,rightEdge,externalFace);
+        this->RasterizeSpan(context,y,leftEdge,rightEdge,externalFace);
         }
       ++y;
       if(y<=y1)
@@ -3867,21 +4162,21 @@ void  vtkUnstructuredGridVolumeZSweepMapper::RasterizeTriangle(
     skipped=1;
     }
   
-  if(y<this->ImageInUseSize[1]) // clipping
+  if(y<=context->YMax) // clipping
     {
     leftEdge->OnBottom(skipped,y);
     rightEdge->OnBottom(skipped,y);
     
-    if(y2>=this->ImageInUseSize[1]) // clipping
+    if(y2>context->YMax) // clipping
       {
-      y2=this->ImageInUseSize[1]-1;
+      y2=context->YMax;
       }
     
     while(y<=y2)
       {
-      if(y>=0) // clipping, needed in case of no top
+      if(y>=context->YMin) // clipping, needed in case of no top
         {
-        this->RasterizeSpan(y,leftEdge,rightEdge,externalFace);
+        this->RasterizeSpan(context,y,leftEdge,rightEdge,externalFace);
         }
       ++y;
       leftEdge->NextLine(y);
@@ -3891,7 +4186,9 @@ void  vtkUnstructuredGridVolumeZSweepMapper::RasterizeTriangle(
 }
 
 //-----------------------------------------------------------------------------
-void vtkUnstructuredGridVolumeZSweepMapper::RasterizeSpan(int y,
+void vtkUnstructuredGridVolumeZSweepMapper::RasterizeSpan(
+                                                      vtkSweepContext *context,
+                                                          int y,
                                                           vtkScreenEdge *left,
                                                           vtkScreenEdge *right,
                                                           bool exitFace)
@@ -3899,9 +4196,9 @@ void vtkUnstructuredGridVolumeZSweepMapper::RasterizeSpan(int y,
   assert("pre: left_exists" && left!=0);
   assert("pre: right_exists" && right!=0);
   
-  vtkIdType i=y*this->ImageInUseSize[0];
+  vtkIdType i=context->GetPixelIndex(0,y);
   
-  this->Span->Init(left->GetX(),
+  context->Span->Init(left->GetX(),
                    left->GetInvW(),
                    left->GetPValues(),
                    left->GetZview(),
@@ -3910,35 +4207,35 @@ void vtkUnstructuredGridVolumeZSweepMapper::RasterizeSpan(int y,
                    right->GetPValues(),
                    right->GetZview());
   
-  while(!this->Span->IsAtEnd())
+  while(!context->Span->IsAtEnd())
     {
-    int x=this->Span->GetX();
-    if(x>=0 && x<this->ImageInUseSize[0]) // clipping
+    int x=context->Span->GetX();
+    if(x>=context->XMin && x<=context->XMax) // clipping
       {
       vtkIdType j=i+x;
       // Write the pixel
-      vtkPixelListEntry *p=this->MemoryManager->AllocateEntry();
-      p->Init(this->Span->GetValues(),this->Span->GetZview(), exitFace);
+      vtkPixelListEntry *p=context->MemoryManager->AllocateEntry();
+      p->Init(context->Span->GetValues(),context->Span->GetZview(), exitFace);
       
       if(this->CellScalars)
         {
-        p->GetValues()[VTK_VALUES_SCALAR_INDEX]=this->FaceScalars[this->FaceSide];
+        p->GetValues()[VTK_VALUES_SCALAR_INDEX]=context->FaceScalars[context->FaceSide];
         }
-      this->PixelListFrame->AddAndSort(j,p);
+      context->PixelListFrame->AddAndSort(j,p);
       
       
-//      if(this->PixelListFrame->GetListSize(j)>this->MaxRecordedPixelListSize)
+//      if(context->PixelListFrame->GetListSize(j)>this->MaxRecordedPixelListSize)
 //        {
-//        this->MaxRecordedPixelListSize=this->PixelListFrame->GetListSize(j);
+//        this->MaxRecordedPixelListSize=context->PixelListFrame->GetListSize(j);
 //        }
       
-      if(!this->MaxPixelListSizeReached)
+      if(!context->MaxPixelListSizeReached)
         {
-        this->MaxPixelListSizeReached=this->PixelListFrame->GetListSize(j)>
+        context->MaxPixelListSizeReached=context->PixelListFrame->GetListSize(j)>
           this->MaxPixelListSize;
         }
       }
-    this->Span->NextPixel();
+    context->Span->NextPixel();
     }
 }
 
@@ -3950,7 +4247,9 @@ enum
 };
 
 //-----------------------------------------------------------------------------
-void vtkUnstructuredGridVolumeZSweepMapper::RasterizeLine(vtkVertexEntry *v0,
+void vtkUnstructuredGridVolumeZSweepMapper::RasterizeLine(
+                                                      vtkSweepContext *context,
+                                                          vtkVertexEntry *v0,
                                                           vtkVertexEntry *v1,
                                                           bool exitFace)
 {
@@ -4036,33 +4335,33 @@ void vtkUnstructuredGridVolumeZSweepMapper::RasterizeLine(vtkVertexEntry *v0,
         {
         // render both points and return
         // write pixel
-        if(x>=0 && x<this->ImageInUseSize[0] && y>=0 &&
-           y<this->ImageInUseSize[1]) // clipping
+        if(x>=context->XMin && x<=context->XMax && y>=context->YMin &&
+           y<=context->YMax) // clipping
           {
-          vtkIdType j=y*this->ImageInUseSize[0]+x; // mult==bad!!
+          vtkIdType j=context->GetPixelIndex(x,y); // mult==bad!!
           // Write the pixel
-          vtkPixelListEntry *p0=this->MemoryManager->AllocateEntry();
+          vtkPixelListEntry *p0=context->MemoryManager->AllocateEntry();
           p0->Init(v0->GetValues(),v0->GetZview(), exitFace);
           
           if(this->CellScalars)
             {
-            p0->GetValues()[VTK_VALUES_SCALAR_INDEX]=this->FaceScalars[this->FaceSide];
+            p0->GetValues()[VTK_VALUES_SCALAR_INDEX]=context->FaceScalars[context->FaceSide];
             }
-          this->PixelListFrame->AddAndSort(j,p0);
+          context->PixelListFrame->AddAndSort(j,p0);
           
           // Write the pixel
-          vtkPixelListEntry *p1=this->MemoryManager->AllocateEntry();
+          vtkPixelListEntry *p1=context->MemoryManager->AllocateEntry();
           p1->Init(v1->GetValues(),v1->GetZview(), exitFace);
           
           if(this->CellScalars)
             {
-            p1->GetValues()[VTK_VALUES_SCALAR_INDEX]=this->FaceScalars[this->FaceSide];
+            p1->GetValues()[VTK_VALUES_SCALAR_INDEX]=context->FaceScalars[context->FaceSide];
             }
-          this->PixelListFrame->AddAndSort(j,p1);
+          context->PixelListFrame->AddAndSort(j,p1);
           
-          if(!this->MaxPixelListSizeReached)
+          if(!context->MaxPixelListSizeReached)
             {
-            this->MaxPixelListSizeReached=this->PixelListFrame->GetListSize(j)>
+            context->MaxPixelListSizeReached=context->PixelListFrame->GetListSize(j)>
               this->MaxPixelListSize;
             }
           }
@@ -4110,23 +4409,23 @@ void vtkUnstructuredGridVolumeZSweepMapper::RasterizeLine(vtkVertexEntry *v0,
   while(!done)
     {
     // write pixel
-    if(x>=0 && x<this->ImageInUseSize[0] && y>=0 &&
-       y<this->ImageInUseSize[1]) // clipping
+    if(x>=context->XMin && x<=context->XMax && y>=context->YMin &&
+       y<=context->YMax) // clipping
       {
-      vtkIdType j=y*this->ImageInUseSize[0]+x; // mult==bad!!
+      vtkIdType j=context->GetPixelIndex(x,y); // mult==bad!!
       // Write the pixel
-      vtkPixelListEntry *p0=this->MemoryManager->AllocateEntry();
+      vtkPixelListEntry *p0=context->MemoryManager->AllocateEntry();
       p0->Init(values,zView,exitFace);
       
       if(this->CellScalars)
         {
-        p0->GetValues()[VTK_VALUES_SCALAR_INDEX]=this->FaceScalars[this->FaceSide];
+        p0->GetValues()[VTK_VALUES_SCALAR_INDEX]=context->FaceScalars[context->FaceSide];
         }
-      this->PixelListFrame->AddAndSort(j,p0);
+      context->PixelListFrame->AddAndSort(j,p0);
    
-      if(!this->MaxPixelListSizeReached)
+      if(!context->MaxPixelListSizeReached)
         {
-        this->MaxPixelListSizeReached=this->PixelListFrame->GetListSize(j)>
+        context->MaxPixelListSizeReached=context->PixelListFrame->GetListSize(j)>
           this->MaxPixelListSize;
         }
       }
@@ -4210,12 +4509,14 @@ void vtkUnstructuredGridVolumeZSweepMapper::RasterizeLine(vtkVertexEntry *v0,
 }
 
 //-----------------------------------------------------------------------------
-void vtkUnstructuredGridVolumeZSweepMapper::CompositeFunction(double zTarget)
+void vtkUnstructuredGridVolumeZSweepMapper::CompositeFunction(
+  vtkSweepContext *context,
+  double zTarget)
 {
-  int y=this->YBounds[0];
-  vtkIdType i=y*this->ImageInUseSize[0]+this->XBounds[0];
+  int y=context->YBounds[0];
+  vtkIdType i=context->GetPixelIndex(context->XBounds[0],y);
   
-  vtkIdType index=(y*this->ImageMemorySize[0]+this->XBounds[0])<< 2; // *4
+  vtkIdType index=(y*this->ImageMemorySize[0]+context->XBounds[0])<< 2; // *4
   vtkIdType indexStep=this->ImageMemorySize[0]<<2; // *4
   
   vtkPixelListEntry *current;
@@ -4225,14 +4526,14 @@ void vtkUnstructuredGridVolumeZSweepMapper::CompositeFunction(double zTarget)
   int newXBounds[2];
   int newYBounds[2];
   
-  newXBounds[0]=this->ImageInUseSize[0];
-  newXBounds[1]=0;
-  newYBounds[0]=this->ImageInUseSize[1];
-  newYBounds[1]=0;
+  newXBounds[0]=context->XMax+1;
+  newXBounds[1]=context->XMin;
+  newYBounds[0]=context->YMax+1;
+  newYBounds[1]=context->YMin;
 
-  int xMin=this->XBounds[0];
-  int xMax=this->XBounds[1];
-  int yMax=this->YBounds[1];
+  int xMin=context->XBounds[0];
+  int xMax=context->XBounds[1];
+  int yMax=context->YBounds[1];
   
   vtkPixelList *pixel;
   int x;
@@ -4251,7 +4552,7 @@ void vtkUnstructuredGridVolumeZSweepMapper::CompositeFunction(double zTarget)
     index2=index;
     while(x<=xMax)
       {
-      pixel=this->PixelListFrame->GetList(j);
+      pixel=context->PixelListFrame->GetList(j);
       // we need at least two entries per pixel to perform compositing
       if(pixel->GetSize()>=2)
         {
@@ -4302,28 +4603,28 @@ void vtkUnstructuredGridVolumeZSweepMapper::CompositeFunction(double zTarget)
 //              if(length>=0.4)
                 {
                 color=this->RealRGBAImage+index2;
-                this->IntersectionLengths->SetValue(0,length);
+                context->IntersectionLengths->SetValue(0,length);
                 
                 if(this->CellScalars)
                   {
                   // same value for near and far intersection
-                  this->NearIntersections->SetValue(0,current->GetValues()[VTK_VALUES_SCALAR_INDEX]);
-                  this->FarIntersections->SetValue(0,current->GetValues()[VTK_VALUES_SCALAR_INDEX]);
+                  context->NearIntersections->SetValue(0,current->GetValues()[VTK_VALUES_SCALAR_INDEX]);
+                  context->FarIntersections->SetValue(0,current->GetValues()[VTK_VALUES_SCALAR_INDEX]);
                   }
                 else
                   {
-                  this->NearIntersections->SetValue(0,current->GetValues()[VTK_VALUES_SCALAR_INDEX]);
-                  this->FarIntersections->SetValue(0,next->GetValues()[VTK_VALUES_SCALAR_INDEX]);
+                  context->NearIntersections->SetValue(0,current->GetValues()[VTK_VALUES_SCALAR_INDEX]);
+                  context->FarIntersections->SetValue(0,next->GetValues()[VTK_VALUES_SCALAR_INDEX]);
                   }
 #ifdef BACK_TO_FRONT
-                this->RealRayIntegrator->Integrate(this->IntersectionLengths,
-                                                   this->FarIntersections,
-                                                   this->NearIntersections,
+                this->RealRayIntegrator->Integrate(context->IntersectionLengths,
+                                                   context->FarIntersections,
+                                                   context->NearIntersections,
                                                    color);
 #else
-                this->RealRayIntegrator->Integrate(this->IntersectionLengths,
-                                                   this->NearIntersections,
-                                                   this->FarIntersections,
+                this->RealRayIntegrator->Integrate(context->IntersectionLengths,
+                                                   context->NearIntersections,
+                                                   context->FarIntersections,
                                                    color);
 #endif
                 } // length!=0
@@ -4331,7 +4632,7 @@ void vtkUnstructuredGridVolumeZSweepMapper::CompositeFunction(double zTarget)
             } // doIntegration
           
           // Next entry
-          pixel->RemoveFirst(this->MemoryManager); // remove current
+          pixel->RemoveFirst(context->MemoryManager); // remove current
           done=pixel->GetSize()<2; // empty queue?
           if(!done)
             {
@@ -4377,19 +4678,19 @@ void vtkUnstructuredGridVolumeZSweepMapper::CompositeFunction(double zTarget)
       ++x;
       }
     // next ordinate
-    i=i+this->ImageInUseSize[0];
+    i=i+context->Width;
     index+=indexStep;
     ++y;
     }
   
   // Update the bounding box. Useful for the delayed compositing
 
-  this->XBounds[0]=newXBounds[0];
-  this->XBounds[1]=newXBounds[1];
-  this->YBounds[0]=newYBounds[0];
-  this->YBounds[1]=newYBounds[1];
+  context->XBounds[0]=newXBounds[0];
+  context->XBounds[1]=newXBounds[1];
+  context->YBounds[0]=newYBounds[0];
+  context->YBounds[1]=newYBounds[1];
 
-  this->MaxPixelListSizeReached=0;
+  context->MaxPixelListSizeReached=0;
 }
  
 //-----------------------------------------------------------------------------
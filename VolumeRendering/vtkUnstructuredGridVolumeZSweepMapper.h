@@ -17,6 +17,11 @@
 // .SECTION Description
 // This is a volume mapper for unstructured grid implemented with the ZSweep
 // algorithm. This is a software projective method.
+//
+// The image is split into horizontal tiles that are swept independently by
+// NumberOfThreads threads. Each thread keeps its own pixel lists and memory
+// pool for the fragments of its tiles, and composites them into its part of
+// the image.
 
 // .SECTION see also
 // vtkVolumetMapper
@@ -61,6 +66,8 @@ namespace vtkUnstructuredGridVolumeZSweepMapperNamespace
   class vtkDoubleScreenEdge;
   class vtkVertexEntry;
   class vtkPixelListEntryMemory;
+  class vtkSweepContext;
+  class vtkSweepEvents;
 };
 //ETX
 
@@ -128,6 +135,13 @@ public:
   virtual void SetRayIntegrator(vtkUnstructuredGridVolumeRayIntegrator *ri);
   vtkGetObjectMacro(RayIntegrator, vtkUnstructuredGridVolumeRayIntegrator);
   
+  // Description:
+  // Set/Get the number of threads sweeping the tiles of the image.
+  // The default is the global default number of threads of
+  // vtkMultiThreader.
+  vtkSetClampMacro( NumberOfThreads, int, 1, VTK_MAX_THREADS );
+  vtkGetMacro( NumberOfThreads, int );
+  
 //BTX
   // Description:
   // WARNING: INTERNAL METHOD - NOT INTENDED FOR GENERAL USE
@@ -163,34 +177,59 @@ protected:
                               vtkVolume *vol);
   
   // Description:
-  // Create an empty "pixel list" for each pixel of the screen.
-  void CreateAndCleanPixelList();
+  // Move the "event list" into Events and find, for each face, the vertex
+  // of the sweep that rasterizes it.
+  // \post empty_list: this->EventList->GetNumberOfItems()==0
+  void PrepareSweep();
   
   // Description:
-  // MainLoop of the Zsweep algorithm.
+  // MainLoop of the Zsweep algorithm. Split the image into tiles and sweep
+  // them with NumberOfThreads threads.
   // \post empty_list: this->EventList->GetNumberOfItems()==0
   void MainLoop(vtkRenderWindow *renWin);
   
+//BTX
+  // Description:
+  // Sweep the events over the tile of `context'. Only the thread given a
+  // render window reports the progress, from progressStart to progressEnd,
+  // and checks for abort.
+  void SweepTile(
+    vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkSweepContext *context,
+    vtkRenderWindow *renWin,
+    double progressStart,
+    double progressEnd);
+  
+  // Description:
+  // Thread function sweeping every NumberOfThreads-th tile.
+  static VTK_THREAD_RETURN_TYPE SweepTilesThread(void *arg);
+  
   // Description:
   // Do delayed compositing from back to front, stopping at zTarget for each
   // pixel inside the bounding box.
-  void CompositeFunction(double zTarget);
+  void CompositeFunction(
+    vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkSweepContext *context,
+    double zTarget);
+//ETX
   
   // Description:
   // Convert and clamp a float color component into a unsigned char.
   unsigned char ColorComponentRealToByte(float color);
   
+//BTX
   // Description:
   // Perform scan conversion of a triangle face.
-  void RasterizeFace(vtkIdType faceIds[3], int externalSide);
+  void RasterizeFace(
+    vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkSweepContext *context,
+    vtkIdType faceIds[3],
+    int externalSide);
 
-//BTX
   // Description:
   // Perform scan conversion of a triangle defined by its vertices.
   // \pre ve0_exists: ve0!=0
   // \pre ve1_exists: ve1!=0
   // \pre ve2_exists: ve2!=0
   void RasterizeTriangle(
+       vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkSweepContext *context,
             vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkVertexEntry *ve0,
             vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkVertexEntry *ve1,
             vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkVertexEntry *ve2,
@@ -201,7 +240,9 @@ protected:
   // y.
   // \pre left_exists: left!=0
   // \pre right_exists: right!=0
-  void RasterizeSpan(int y,
+  void RasterizeSpan(
+           vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkSweepContext *context,
+           int y,
            vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkScreenEdge *left,
            vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkScreenEdge *right,
            bool exitFace);
@@ -212,6 +253,7 @@ protected:
   // \pre v1_exists: v1!=0
   // \pre y_ordered v0->GetScreenY()<=v1->GetScreenY()
   void RasterizeLine(
+       vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkSweepContext *context,
              vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkVertexEntry *v0,
              vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkVertexEntry *v1,
              bool exitFace);
@@ -242,9 +284,12 @@ protected:
   // large enough.
   void AllocateVertices(vtkIdType size);
   
+//BTX
   // Description:
-  // For debugging purpose, save the pixel list frame as a dataset.
-  void SavePixelListFrame();
+  // For debugging purpose, save the pixel list frame of a tile as a dataset.
+  void SavePixelListFrame(
+    vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkSweepContext *context);
+//ETX
   
   int MaxPixelListSize;
   
@@ -295,16 +340,9 @@ protected:
   vtkDataArray *Scalars;
   int CellScalars;
   
-  // if use CellScalars, we need to keep track of the
-  // values on each side of the face and figure out
-  // if the face is used by two cells (twosided) or one cell.
-  double FaceScalars[2];
-  int FaceSide;
+  int NumberOfThreads;
 
 //BTX
-  vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkSpan *Span;
-  vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkPixelListFrame *PixelListFrame;
-  
   // Used by BuildUseSets().
   vtkGenericCell *Cell;
   
@@ -316,29 +354,18 @@ protected:
   vtkTransform *PerspectiveTransform;
   vtkMatrix4x4 *PerspectiveMatrix;
   
-  // Used by the main loop
-  int MaxPixelListSizeReached;
-  int XBounds[2];
-  int YBounds[2];
-  
-  vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkSimpleScreenEdge *SimpleEdge;
-  vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkDoubleScreenEdge *DoubleEdge;
+  // Used by the main loop: the sorted events and the state of each thread.
+  vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkSweepEvents *Events;
+  vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkSweepContext *Contexts[VTK_MAX_THREADS];
+  int SweepAborted;
   
   vtkUnstructuredGridVolumeRayIntegrator *RayIntegrator;
   vtkUnstructuredGridVolumeRayIntegrator *RealRayIntegrator;
   
   vtkTimeStamp SavedTriangleListMTime;
   
-  // Used during compositing
-  vtkDoubleArray *IntersectionLengths;
-  vtkDoubleArray *NearIntersections;
-  vtkDoubleArray *FarIntersections;
-  
   // Benchmark
   vtkIdType MaxRecordedPixelListSize;
-
-  
-  vtkUnstructuredGridVolumeZSweepMapperNamespace::vtkPixelListEntryMemory *MemoryManager;
 //ETX
 private:
   vtkUnstructuredGridVolumeZSweepMapper(const vtkUnstructuredGridVolumeZSweepMapper&);  // Not implemented.